@@ -1,20 +1,17 @@
 struct Input
 {
-    // Per vertex
-    [[vk::location(0)]] float2 position : POSITION0;
-    [[vk::location(1)]] float4 color : COLOR;
-    // Per instance
-    [[vk::location(2)]] float2 topLeftPos;
-    [[vk::location(3)]] float2 topLeftRadius;
+    // Per instance, xy is the position of the corner and zw is its radius
+    [[vk::location(0)]] float4 topLeft;
+    [[vk::location(1)]] float4 topLeftColor;
 
-    [[vk::location(4)]] float2 bottomLeftPos;
-    [[vk::location(5)]] float2 bottomLeftRadius;
+    [[vk::location(2)]] float4 bottomLeft;
+    [[vk::location(3)]] float4 bottomLeftColor;
 
-    [[vk::location(6)]] float2 topRightPos;
-    [[vk::location(7)]] float2 topRightRadius;
+    [[vk::location(4)]] float4 topRight;
+    [[vk::location(5)]] float4 topRightColor;
 
-    [[vk::location(8)]] float2 bottomRightPos;
-    [[vk::location(9)]] float2 bottomRightRadius;
+    [[vk::location(6)]] float4 bottomRight;
+    [[vk::location(7)]] float4 bottomRightColor;
 };
 
 struct Output
@@ -49,26 +46,31 @@ float Radius(float2 xy)
     return xy.y;
 };
 
-Output main(Input input)
+// The quad is drawn as a strip of 4 vertices in the order of top left, bottom left, top right and bottom right
+Output main(Input input, uint vertexId : SV_VertexID)
 {
     Output output;
 
-    float4 position = pushConsts.model * float4(input.position.x, input.position.y, 0.0, 1.0);
+    float2 corners[4] = {input.topLeft.xy, input.bottomLeft.xy, input.topRight.xy, input.bottomRight.xy};
+    float4 colors[4] = {input.topLeftColor, input.bottomLeftColor, input.topRightColor, input.bottomRightColor};
+    float2 cornerPos = corners[vertexId];
+
+    float4 position = pushConsts.model * float4(cornerPos.x, cornerPos.y, 0.0, 1.0);
 
     output.position = position;
-    output.screenPos = input.position.xy;
-    output.color = input.color;
+    output.screenPos = cornerPos;
+    output.color = colors[vertexId];
 
     // This is probably why they have separated radius into x and y component
-    output.topLeftInnerPos = input.topLeftPos + float2(input.topLeftRadius.x, input.topLeftRadius.y);
-    output.bottomLeftInnerPos = input.bottomLeftPos + float2(input.bottomLeftRadius.x, -input.bottomLeftRadius.y);
-    output.topRightInnerPos = input.topRightPos + float2(-input.topRightRadius.x, input.topRightRadius.y);
-    output.bottomRightInnerPos = input.bottomRightPos + float2(-input.bottomRightRadius.x, -input.bottomRightRadius.y);
+    output.topLeftInnerPos = input.topLeft.xy + float2(input.topLeft.z, input.topLeft.w);
+    output.bottomLeftInnerPos = input.bottomLeft.xy + float2(input.bottomLeft.z, -input.bottomLeft.w);
+    output.topRightInnerPos = input.topRight.xy + float2(-input.topRight.z, input.topRight.w);
+    output.bottomRightInnerPos = input.bottomRight.xy + float2(-input.bottomRight.z, -input.bottomRight.w);
 
-    output.topLeftRadius = Radius(input.topLeftRadius);
-    output.bottomLeftRadius = Radius(input.bottomLeftRadius);
-    output.topRightRadius = Radius(input.topRightRadius);
-    output.bottomRightRadius = Radius(input.bottomRightRadius);
+    output.topLeftRadius = Radius(input.topLeft.zw);
+    output.bottomLeftRadius = Radius(input.bottomLeft.zw);
+    output.topRightRadius = Radius(input.topRight.zw);
+    output.bottomRightRadius = Radius(input.bottomRight.zw);
 
     return output;
-}
\ No newline at end of file
+}
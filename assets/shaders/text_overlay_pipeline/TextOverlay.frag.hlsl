@@ -14,10 +14,14 @@ struct Output
 
 float4 main(Input input) : SV_TARGET
 {
-    float strength = textureFont.Sample(samplerFont, input.uv).r;
-    if (strength < 0.5)
+    // Signed distance of the glyph, The edge is at 0.5
+    float distance = textureFont.Sample(samplerFont, input.uv).r;
+    // One pixel wide edge at every font size
+    float edgeWidth = max(fwidth(distance) * 0.5, 1e-4);
+    float alpha = smoothstep(0.5 - edgeWidth, 0.5 + edgeWidth, distance);
+    if (alpha <= 0.0)
     {
         discard;
     }
-    return float4(input.color * strength, 1.0);
+    return float4(input.color, alpha);
 }
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include "BenchmarkUtils.hpp"
+
+#include "AssetGLTF_Animation.hpp"
+#include "AssetGLTF_Mesh.hpp"
+#include "JobSystem.hpp"
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Instances per frame that AnimationBatch can pose, For linear and cubic spline clips with one layer and with a second
+// layer blended over it. The rig is a root with a few chains of joints, About the size of a game character. Skinning
+// is measured separately since only the instances that are drawn on the cpu need it.
+
+using namespace MFA;
+using namespace MFA::Asset::GLTF;
+
+namespace
+{
+    static constexpr int ChainCount = 4;
+    static constexpr int ChainLength = 16;
+    static constexpr int KeyCount = 30;
+    static constexpr float ClipDuration = 1.0f;
+    static constexpr float DeltaTime = 1.0f / 60.0f;
+    static constexpr int FrameCount = 10;
+
+    //-------------------------------------------------------------------------------------------------
+
+    Animation::Sampler::InputAndOutput Key(float const time, glm::vec4 const & value, glm::vec4 const & tangent)
+    {
+        Animation::Sampler::InputAndOutput key{.input = time};
+        for (int i = 0; i < 4; ++i)
+        {
+            key.output[i] = value[i];
+            key.inTangent[i] = tangent[i];
+            key.outTangent[i] = tangent[i];
+        }
+        return key;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Rotation and translation track for every node
+    Animation CreateClip(char const * name, Animation::Interpolation const interpolation, float const phase)
+    {
+        Animation animation{.name = name, .startTime = 0.0f, .endTime = ClipDuration};
+        int const nodeCount = 1 + ChainCount * ChainLength;
+        for (int node = 0; node < nodeCount; ++node)
+        {
+            Animation::Sampler rotation{.interpolation = interpolation};
+            Animation::Sampler translation{.interpolation = interpolation};
+            for (int key = 0; key < KeyCount; ++key)
+            {
+                float const time = ClipDuration * static_cast<float>(key) / static_cast<float>(KeyCount - 1);
+                float const angle = 0.3f * std::sin(6.28f * time + phase + static_cast<float>(node));
+                auto const quaternion = glm::angleAxis(angle, glm::vec3{0.0f, 0.0f, 1.0f});
+                rotation.inputAndOutput.emplace_back(Key(
+                    time,
+                    glm::vec4{quaternion.x, quaternion.y, quaternion.z, quaternion.w},
+                    glm::vec4{0.0f, 0.0f, 0.1f, 0.0f}
+                ));
+                translation.inputAndOutput.emplace_back(Key(
+                    time,
+                    glm::vec4{0.0f, 1.0f + 0.1f * std::cos(6.28f * time + phase), 0.0f, 0.0f},
+                    glm::vec4{0.0f, 0.1f, 0.0f, 0.0f}
+                ));
+            }
+            auto const samplerIndex = static_cast<uint32_t>(animation.samplers.size());
+            animation.samplers.emplace_back(std::move(rotation));
+            animation.samplers.emplace_back(std::move(translation));
+            animation.channels.emplace_back(Animation::Channel{
+                .path = Animation::Path::Rotation,
+                .nodeIndex = static_cast<uint32_t>(node),
+                .samplerIndex = samplerIndex
+            });
+            animation.channels.emplace_back(Animation::Channel{
+                .path = Animation::Path::Translation,
+                .nodeIndex = static_cast<uint32_t>(node),
+                .samplerIndex = samplerIndex + 1
+            });
+        }
+        return animation;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<MeshData> CreateRig()
+    {
+        auto meshData = std::make_shared<MeshData>();
+        meshData->nodes.emplace_back(meshData->transformStore);
+        auto & skin = meshData->skins.emplace_back();
+        for (int chain = 0; chain < ChainCount; ++chain)
+        {
+            int parent = 0;
+            for (int link = 0; link < ChainLength; ++link)
+            {
+                int const node = static_cast<int>(meshData->nodes.size());
+                meshData->nodes.emplace_back(meshData->transformStore).parent = parent;
+                meshData->nodes[parent].children.emplace_back(node);
+                skin.joints.emplace_back(node);
+                skin.inverseBindMatrices.emplace_back(1.0f);
+                parent = node;
+            }
+        }
+        meshData->animations.emplace_back(CreateClip("Linear", Animation::Interpolation::Linear, 0.0f));
+        meshData->animations.emplace_back(CreateClip("Cubic", Animation::Interpolation::CubicSpline, 0.0f));
+        meshData->animations.emplace_back(CreateClip("Overlay", Animation::Interpolation::Linear, 1.5f));
+        return meshData;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::vector<Vertex> CreateVertices(uint32_t const vertexCount, int const jointCount)
+    {
+        std::vector<Vertex> vertices(vertexCount);
+        for (uint32_t i = 0; i < vertexCount; ++i)
+        {
+            auto & vertex = vertices[i];
+            vertex.position = glm::vec3{static_cast<float>(i % 17), static_cast<float>(i % 5), 1.0f};
+            vertex.normal = glm::vec3{0.0f, 1.0f, 0.0f};
+            vertex.hasSkin = 1;
+            for (int influence = 0; influence < 4; ++influence)
+            {
+                vertex.jointIndices[influence] = static_cast<int>((i + influence * 7) % jointCount);
+                vertex.jointWeights[influence] = 0.25f;
+            }
+        }
+        return vertices;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Milliseconds per frame
+    double MeasureUpdate(
+        std::shared_ptr<MeshData> const & meshData,
+        uint32_t const instanceCount,
+        int const clipIndex,
+        bool const hasOverlay,
+        int const repeatCount
+    )
+    {
+        AnimationBatch batch{meshData};
+        int const overlayIndex = batch.FindClip("Overlay");
+        for (uint32_t i = 0; i < instanceCount; ++i)
+        {
+            auto const instance = batch.AddInstance();
+            // Different start times, So the cursors of the instances are not all on the same key
+            float const time = ClipDuration * static_cast<float>(i % 97) / 97.0f;
+            batch.SetLayer(instance, 0, AnimationBatch::Layer{.clipIndex = clipIndex, .time = time});
+            if (hasOverlay == true)
+            {
+                batch.SetLayer(instance, 1, AnimationBatch::Layer{.clipIndex = overlayIndex, .time = time, .weight = 0.3f});
+            }
+        }
+        double const ms = Benchmark::MeasureMs(repeatCount, [&batch]()->void
+        {
+            for (int frame = 0; frame < FrameCount; ++frame)
+            {
+                batch.Update(DeltaTime);
+            }
+        });
+        Benchmark::Consume(batch.GetJointPalette(0, 0)[0]);
+        return ms / FrameCount;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main(int argc, char ** argv)
+{
+    bool const isQuick = Benchmark::IsQuick(argc, argv);
+    int const repeatCount = isQuick ? 1 : 3;
+    std::vector<uint32_t> const instanceCounts = isQuick
+        ? std::vector<uint32_t>{64}
+        : std::vector<uint32_t>{500, 2000, 8000};
+    uint32_t const vertexCount = isQuick ? 4096 : 100000;
+
+    auto jobSystem = JobSystem::Instantiate();
+
+    auto const meshData = CreateRig();
+    int const linearIndex = 0;
+    int const cubicIndex = 1;
+
+    std::printf(
+        "%d compute threads, %zu nodes, %zu joints, %d keys per track, ms per frame (us per instance)\n",
+        JobSystem::AvailableThreadCount(),
+        meshData->nodes.size(),
+        meshData->skins[0].joints.size(),
+        KeyCount
+    );
+    std::printf("%10s %20s %20s %20s %20s\n", "instances", "linear", "cubic", "linear + layer", "cubic + layer");
+    for (auto const instanceCount : instanceCounts)
+    {
+        std::printf("%10u", instanceCount);
+        for (int const clipIndex : {linearIndex, cubicIndex})
+        {
+            double const ms = MeasureUpdate(meshData, instanceCount, clipIndex, false, repeatCount);
+            std::printf(" %10.3f (%6.2f us)", ms, ms * 1000.0 / instanceCount);
+        }
+        for (int const clipIndex : {linearIndex, cubicIndex})
+        {
+            double const ms = MeasureUpdate(meshData, instanceCount, clipIndex, true, repeatCount);
+            std::printf(" %10.3f (%6.2f us)", ms, ms * 1000.0 / instanceCount);
+        }
+        std::printf("\n");
+    }
+
+    AnimationBatch batch{meshData};
+    auto const instance = batch.AddInstance();
+    batch.SetLayer(instance, 0, AnimationBatch::Layer{.clipIndex = linearIndex});
+    batch.Update(0.25f);
+    auto const vertices = CreateVertices(vertexCount, static_cast<int>(batch.GetJointCount()));
+    std::vector<glm::vec3> positions(vertexCount);
+    std::vector<glm::vec3> normals(vertexCount);
+    double const skinMs = Benchmark::MeasureMs(repeatCount, [&]()->void
+    {
+        batch.SkinVertices(instance, 0, vertices.data(), vertexCount, positions.data(), normals.data());
+    });
+    Benchmark::Consume(positions.back());
+    std::printf(
+        "\nSkinning %u vertices with 4 influences: %.3f ms, %.2f million vertices/s\n",
+        vertexCount,
+        skinMs,
+        static_cast<double>(vertexCount) / (skinMs / 1000.0) / 1e6
+    );
+
+    jobSystem.reset();
+    JobSystem::Destroy();
+
+    return 0;
+}
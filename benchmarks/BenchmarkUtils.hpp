@@ -0,0 +1,55 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace MFA::Benchmark
+{
+    // Smaller sizes and fewer repeats, Used by ctest so the benchmarks keep running without taking long
+    inline bool IsQuick(int const argc, char ** argv)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            if (std::strcmp(argv[i], "--quick") == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Best of repeatCount runs in milliseconds, The best run has the least noise from the rest of the machine
+    template<typename Function>
+    double MeasureMs(int const repeatCount, Function const & function)
+    {
+        double bestMs = std::numeric_limits<double>::max();
+        for (int i = 0; i < std::max(repeatCount, 1); ++i)
+        {
+            auto const begin = std::chrono::steady_clock::now();
+            function();
+            auto const end = std::chrono::steady_clock::now();
+            bestMs = std::min(bestMs, std::chrono::duration<double, std::milli>(end - begin).count());
+        }
+        return bestMs;
+    }
+
+    // Keeps the compiler from removing work whose result is never read, The value has to be in memory since the
+    // escape may read it through its address
+    template<typename T>
+    void Consume(T const & value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        // Msvc has no inline asm on x64, A volatile read needs the value in memory as well
+        static_cast<void>(*reinterpret_cast<char const volatile *>(&value));
+        _ReadWriteBarrier();
+#endif
+    }
+}
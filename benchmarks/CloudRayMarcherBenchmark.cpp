@@ -0,0 +1,140 @@
+#include "BenchmarkUtils.hpp"
+
+#include "CloudRayMarcher.hpp"
+#include "JobSystem.hpp"
+#include "NoiseGenerator.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Steps per ray and render time of the cpu cloud ray marcher with and without empty space skipping, For a few
+// coverages since less coverage leaves more space to skip. Both images have to match, Skipping only moves rays over
+// samples that are 0. The memory table compares the sparse occupancy that the marcher skips with against the dense
+// bound that it is built from, Which the marcher keeps to rebuild the occupancy when the coverage changes.
+
+using namespace MFA;
+
+namespace
+{
+    static constexpr float Coverages[] {0.2f, 0.4f, 0.6f};
+    // Rounding of the step distances can move a pixel by a level
+    static constexpr int MaxPixelDifference = 1;
+
+    //-------------------------------------------------------------------------------------------------
+
+    double PerRay(uint64_t const value, CloudRayMarcher::Stats const & stats)
+    {
+        return static_cast<double>(value) / static_cast<double>(std::max<uint64_t>(stats.hitCount, 1));
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    int MaxDifference(CloudRayMarcher::Image const & lhs, CloudRayMarcher::Image const & rhs)
+    {
+        int maxDifference = 0;
+        for (size_t i = 0; i < lhs.pixels.size(); ++i)
+        {
+            maxDifference = std::max(maxDifference, std::abs(static_cast<int>(lhs.pixels[i]) - static_cast<int>(rhs.pixels[i])));
+        }
+        return maxDifference;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main(int argc, char ** argv)
+{
+    bool const isQuick = Benchmark::IsQuick(argc, argv);
+    int const repeatCount = isQuick ? 1 : 3;
+    uint32_t const shapeResolution = isQuick ? 32 : 128;
+    uint32_t const detailResolution = isQuick ? 16 : 32;
+    uint32_t const width = isQuick ? 96 : 400;
+    uint32_t const height = isQuick ? 72 : 400;
+
+    auto jobSystem = JobSystem::Instantiate();
+
+    CloudRayMarcher const marcher{
+        NoiseGenerator::CloudShapeVolume(shapeResolution, 0),
+        NoiseGenerator::CloudDetailVolume(detailResolution, 0)
+    };
+    auto const view = CloudRayMarcher::LookAtView(glm::vec3{20.0f, 20.0f, 20.0f}, glm::vec3{}, width, height);
+
+    std::printf("%d compute threads, %ux%u pixels, Shape volume %u^3, Steps are per ray that hits the sphere\n",
+        JobSystem::AvailableThreadCount(), width, height, shapeResolution);
+    std::printf(
+        "%8s %12s %12s %14s %12s %12s %10s\n",
+        "coverage", "steps", "skip steps", "skipped steps", "ms", "skip ms", "max diff"
+    );
+
+    bool isEachMatching = true;
+    for (auto const coverage : Coverages)
+    {
+        CloudRayMarcher::Params params{.coverage = coverage};
+
+        params.skipEmptySpace = false;
+        CloudRayMarcher::Stats stats{};
+        CloudRayMarcher::Image image{};
+        double const ms = Benchmark::MeasureMs(repeatCount, [&]()->void
+        {
+            image = marcher.Render(view, params, &stats);
+        });
+
+        params.skipEmptySpace = true;
+        // The occupancy is built on the first render with a coverage, Which is not part of the timing
+        Benchmark::Consume(marcher.GetOccupancy(coverage).get());
+        CloudRayMarcher::Stats skipStats{};
+        CloudRayMarcher::Image skipImage{};
+        double const skipMs = Benchmark::MeasureMs(repeatCount, [&]()->void
+        {
+            skipImage = marcher.Render(view, params, &skipStats);
+        });
+
+        int const difference = MaxDifference(image, skipImage);
+        isEachMatching &= difference <= MaxPixelDifference;
+        std::printf(
+            "%8.2f %12.1f %12.1f %14.1f %12.2f %12.2f %10d\n",
+            coverage,
+            PerRay(stats.stepCount, stats),
+            PerRay(skipStats.stepCount, skipStats),
+            PerRay(skipStats.skippedStepCount, skipStats),
+            ms,
+            skipMs,
+            difference
+        );
+    }
+
+    size_t const shapeBytes = static_cast<size_t>(shapeResolution) * shapeResolution * shapeResolution * 4;
+    std::printf("\nShape volume: %zu KB\n", shapeBytes / 1024);
+    std::printf(
+        "%8s %12s %12s %12s %12s %12s %10s\n",
+        "coverage", "dense KB", "sparse KB", "bricks KB", "grid KB", "levels KB", "bricks"
+    );
+    for (auto const coverage : Coverages)
+    {
+        auto const report = marcher.GetOccupancy(coverage)->GetMemoryReport();
+        std::printf(
+            "%8.2f %12.1f %12.1f %12.1f %12.1f %12.1f %5u/%-5u\n",
+            coverage,
+            static_cast<double>(report.denseBytes) / 1024.0,
+            static_cast<double>(report.totalBytes) / 1024.0,
+            static_cast<double>(report.brickBytes) / 1024.0,
+            static_cast<double>(report.gridBytes) / 1024.0,
+            static_cast<double>(report.hierarchyBytes) / 1024.0,
+            report.occupiedBrickCount,
+            report.brickCount
+        );
+    }
+
+    jobSystem.reset();
+    JobSystem::Destroy();
+
+    if (isEachMatching == false)
+    {
+        std::printf("Skipping empty space changed the image\n");
+        return 1;
+    }
+    return 0;
+}
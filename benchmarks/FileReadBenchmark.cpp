@@ -0,0 +1,148 @@
+#include "BenchmarkUtils.hpp"
+
+#include "BedrockFile.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+// Read throughput of File::Read and File::Map from 1 MB to 2 GB. The old Read, Which copied the file through an
+// istreambuf_iterator into a vector and then into the blob, Is kept here as the reference.
+// Every variant sums one byte per page so a mapping is really faulted in, The files stay in the page cache between
+// runs, So the numbers are warm reads.
+
+using namespace MFA;
+
+namespace
+{
+    static constexpr size_t MB = 1024 * 1024;
+    static constexpr size_t PageSize = 4096;
+    // The old Read holds the vector and the blob at once and the vector grows by doubling, So larger files need
+    // several times their size in memory
+    static constexpr size_t MaxLegacySize = 512 * MB;
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool WriteFile(std::string const & path, size_t const size)
+    {
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        std::vector<uint8_t> chunk(16 * MB);
+        std::mt19937 random{size};
+        for (auto & value : chunk)
+        {
+            value = static_cast<uint8_t>(random());
+        }
+        for (size_t written = 0; written < size; written += chunk.size())
+        {
+            auto const chunkSize = std::min(chunk.size(), size - written);
+            file.write(reinterpret_cast<char const *>(chunk.data()), static_cast<std::streamsize>(chunkSize));
+        }
+        return file.good();
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    uint64_t TouchPages(uint8_t const * data, size_t const size)
+    {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < size; i += PageSize)
+        {
+            sum += data[i];
+        }
+        return sum;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<Blob> LegacyRead(std::string const & path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        return Memory::Alloc(data.data(), data.size());
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    double Throughput(size_t const size, double const ms)
+    {
+        return static_cast<double>(size) / static_cast<double>(MB) / (ms / 1000.0);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main(int argc, char ** argv)
+{
+    bool const isQuick = Benchmark::IsQuick(argc, argv);
+    int const repeatCount = isQuick ? 1 : 3;
+
+    std::vector<size_t> const sizes = isQuick
+        ? std::vector<size_t>{1 * MB, 16 * MB}
+        : std::vector<size_t>{1 * MB, 16 * MB, 128 * MB, 512 * MB, 2048 * MB};
+
+    auto const directory = std::filesystem::temp_directory_path();
+
+    std::printf("Warm page cache, MB/s\n");
+    std::printf("%10s %14s %14s %14s %14s\n", "size MB", "old Read", "Read", "Map", "Map populate");
+
+    for (auto const size : sizes)
+    {
+        auto const path = (directory / ("mfa_file_read_benchmark_" + std::to_string(size / MB) + ".bin")).string();
+        if (WriteFile(path, size) == false)
+        {
+            std::printf("Failed to write %s\n", path.c_str());
+            return 1;
+        }
+
+        double legacyMs = -1.0;
+        if (size <= MaxLegacySize)
+        {
+            legacyMs = Benchmark::MeasureMs(repeatCount, [&path]()->void
+            {
+                auto const blob = LegacyRead(path);
+                Benchmark::Consume(TouchPages(blob->Ptr(), blob->Len()));
+            });
+        }
+        double const readMs = Benchmark::MeasureMs(repeatCount, [&path]()->void
+        {
+            auto const blob = File::Read(path);
+            Benchmark::Consume(TouchPages(blob->Ptr(), blob->Len()));
+        });
+        double const mapMs = Benchmark::MeasureMs(repeatCount, [&path]()->void
+        {
+            auto const blob = File::Map(path);
+            Benchmark::Consume(TouchPages(blob->Ptr(), blob->Len()));
+        });
+        double const populateMs = Benchmark::MeasureMs(repeatCount, [&path]()->void
+        {
+            auto const blob = File::Map(path, File::MapParams{.populate = true});
+            Benchmark::Consume(TouchPages(blob->Ptr(), blob->Len()));
+        });
+
+        if (legacyMs >= 0.0)
+        {
+            std::printf("%10zu %14.0f", size / MB, Throughput(size, legacyMs));
+        }
+        else
+        {
+            std::printf("%10zu %14s", size / MB, "-");
+        }
+        std::printf(
+            " %14.0f %14.0f %14.0f\n",
+            Throughput(size, readMs),
+            Throughput(size, mapMs),
+            Throughput(size, populateMs)
+        );
+
+        std::error_code error{};
+        std::filesystem::remove(path, error);
+    }
+
+    return 0;
+}
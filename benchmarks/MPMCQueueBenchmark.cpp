@@ -0,0 +1,155 @@
+#include "BenchmarkUtils.hpp"
+
+#include "MPMCQueue.hpp"
+#include "ThreadSafeQueue.hpp"
+#include "ThreadUtils.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <thread>
+#include <vector>
+
+// Producer scaling of the task queues: N producers push std::function tasks while a fixed set of consumers pops
+// and runs them, Which is the shape of the shared queue of ThreadPool.
+// MPMCQueue is compared against the spin locked ThreadSafeQueue that the pool used to share between all threads.
+
+using namespace MFA;
+
+namespace
+{
+    using Task = std::function<void()>;
+
+    static constexpr int ConsumerCount = 2;
+    static constexpr size_t QueueCapacity = 1024;
+
+    //-------------------------------------------------------------------------------------------------
+
+    struct LockedQueue
+    {
+        ThreadSafeQueue<Task> queue{};
+
+        void Push(Task && task)
+        {
+            queue.Push(std::move(task));
+        }
+
+        bool TryToPop(Task & outTask)
+        {
+            bool isEmpty = true;
+            return queue.TryToPop(outTask, isEmpty) == true && isEmpty == false;
+        }
+    };
+
+    //-------------------------------------------------------------------------------------------------
+
+    struct LockFreeQueue
+    {
+        MPMCQueue<Task> queue{QueueCapacity};
+
+        void Push(Task && task)
+        {
+            queue.Push(std::move(task));
+        }
+
+        bool TryToPop(Task & outTask)
+        {
+            return queue.TryToPop(outTask);
+        }
+    };
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Every producer pushes its share of itemCount tasks, Consumers run them until all of them are done.
+    template<typename Queue>
+    void RunProducers(int const producerCount, int const itemCount)
+    {
+        Queue queue{};
+        std::atomic<int> executedCount{0};
+        std::atomic<uint64_t> checksum{0};
+        int const itemsPerProducer = itemCount / producerCount;
+        int const totalCount = itemsPerProducer * producerCount;
+
+        std::vector<std::thread> threads{};
+        threads.reserve(producerCount + ConsumerCount);
+        for (int i = 0; i < ConsumerCount; ++i)
+        {
+            threads.emplace_back([&queue, &executedCount, totalCount]()->void
+            {
+                Task task{};
+                while (executedCount.load(std::memory_order_relaxed) < totalCount)
+                {
+                    if (queue.TryToPop(task) == true)
+                    {
+                        task();
+                        executedCount.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (int i = 0; i < producerCount; ++i)
+        {
+            threads.emplace_back([&queue, &checksum, itemsPerProducer, i]()->void
+            {
+                for (int j = 0; j < itemsPerProducer; ++j)
+                {
+                    uint64_t const value = static_cast<uint64_t>(i) * itemsPerProducer + j;
+                    queue.Push([&checksum, value]()->void
+                    {
+                        checksum.fetch_add(value, std::memory_order_relaxed);
+                    });
+                }
+            });
+        }
+        for (auto & thread : threads)
+        {
+            thread.join();
+        }
+        Benchmark::Consume(checksum.load());
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main(int argc, char ** argv)
+{
+    bool const isQuick = Benchmark::IsQuick(argc, argv);
+    int const repeatCount = isQuick ? 1 : 5;
+    int const itemCount = isQuick ? 1 << 14 : 1 << 20;
+
+    std::printf(
+        "%d tasks, %d consumers, %d hardware threads\n",
+        itemCount,
+        ConsumerCount,
+        ThreadUtils::HardwareThreadCount()
+    );
+    std::printf("%10s %18s %18s %10s\n", "producers", "ThreadSafeQueue ms", "MPMCQueue ms", "speedup");
+
+    for (int producerCount = 1; producerCount <= 32; producerCount *= 2)
+    {
+        double const lockedMs = Benchmark::MeasureMs(repeatCount, [producerCount, itemCount]()->void
+        {
+            RunProducers<LockedQueue>(producerCount, itemCount);
+        });
+        double const lockFreeMs = Benchmark::MeasureMs(repeatCount, [producerCount, itemCount]()->void
+        {
+            RunProducers<LockFreeQueue>(producerCount, itemCount);
+        });
+
+        std::printf(
+            "%10d %18.2f %18.2f %9.2fx   (%.0f tasks/s)\n",
+            producerCount,
+            lockedMs,
+            lockFreeMs,
+            lockedMs / lockFreeMs,
+            static_cast<double>(itemCount) / (lockFreeMs / 1000.0)
+        );
+    }
+
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include "BenchmarkUtils.hpp"
+
+#include "AssetGLTF_Mesh.hpp"
+#include "JobSystem.hpp"
+#include "ShapeGenerator.hpp"
+
+#include <glm/gtx/norm.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+// Mesh::Optimize on ShapeGenerator::Sphere meshes of increasing resolution. Spheres have duplicate vertices along
+// the seam and on the poles and degenerate triangles around the poles, So every part of the weld has work to do.
+// The pairwise scan that Optimize used to do is kept here as the reference, It only runs on the small sizes.
+
+using namespace MFA;
+using namespace MFA::Asset::GLTF;
+
+namespace
+{
+    // Two spheres as separate primitives, Like a model with two materials
+    static constexpr int PrimitiveCount = 2;
+
+    // Vertex count after which the quadratic reference takes too long to measure
+    static constexpr uint32_t MaxPairwiseVertexCount = 20000;
+
+    struct SphereData
+    {
+        std::vector<Vertex> vertices{};
+        std::vector<Index> indices{};
+    };
+
+    //-------------------------------------------------------------------------------------------------
+
+    SphereData CreateSphere(int const resolution)
+    {
+        auto const [positions, indices, normals] = ShapeGenerator::Sphere(1.0f, resolution, resolution / 2);
+        SphereData sphere{};
+        sphere.vertices.resize(positions.size());
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            sphere.vertices[i].position = positions[i];
+            sphere.vertices[i].normal = normals[i];
+        }
+        sphere.indices = indices;
+        return sphere;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<Mesh> CreateMesh(SphereData const & sphere)
+    {
+        auto const vertexCount = static_cast<uint32_t>(sphere.vertices.size());
+        auto const indexCount = static_cast<uint32_t>(sphere.indices.size());
+        auto mesh = std::make_shared<Mesh>(
+            vertexCount * PrimitiveCount,
+            indexCount * PrimitiveCount,
+            Memory::AllocSize(sizeof(Vertex) * vertexCount * PrimitiveCount),
+            Memory::AllocSize(sizeof(Index) * indexCount * PrimitiveCount)
+        );
+        auto const subMeshIndex = mesh->InsertSubMesh();
+        // Indices are global in the vertex buffer, Like the importer stores them
+        std::vector<Index> indices(indexCount);
+        for (int i = 0; i < PrimitiveCount; ++i)
+        {
+            for (uint32_t j = 0; j < indexCount; ++j)
+            {
+                indices[j] = sphere.indices[j] + vertexCount * i;
+            }
+            mesh->InsertPrimitive(
+                subMeshIndex,
+                Primitive{.uniqueId = static_cast<uint32_t>(i)},
+                vertexCount,
+                sphere.vertices.data(),
+                indexCount,
+                indices.data()
+            );
+        }
+        return mesh;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Same steps as the old Mesh::Optimize on a single primitive: Every vertex is compared with every unique vertex,
+    // The index buffer is rescanned per vertex and every triangle is compared with every kept triangle.
+    size_t PairwiseWeld(SphereData sphere)
+    {
+        auto & vertices = sphere.vertices;
+        auto & indices = sphere.indices;
+
+        std::vector<Vertex> uniqueVertices{};
+        for (size_t i = 0; i < vertices.size(); ++i)
+        {
+            size_t newIdx = uniqueVertices.size();
+            for (size_t j = 0; j < uniqueVertices.size(); ++j)
+            {
+                if (glm::length2(uniqueVertices[j].position - vertices[i].position) < glm::epsilon<float>())
+                {
+                    newIdx = j;
+                    break;
+                }
+            }
+            if (newIdx == uniqueVertices.size())
+            {
+                uniqueVertices.emplace_back(vertices[i]);
+            }
+            for (auto & index : indices)
+            {
+                if (index == i)
+                {
+                    index = static_cast<Index>(newIdx);
+                }
+            }
+        }
+
+        std::vector<Index> uniqueIndices{};
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            bool isDuplicate = false;
+            for (size_t j = 0; j + 2 < uniqueIndices.size() && isDuplicate == false; j += 3)
+            {
+                auto const contains = [&uniqueIndices, j](Index const index)->bool
+                {
+                    return uniqueIndices[j] == index || uniqueIndices[j + 1] == index || uniqueIndices[j + 2] == index;
+                };
+                isDuplicate = contains(indices[i]) && contains(indices[i + 1]) && contains(indices[i + 2]);
+            }
+            if (isDuplicate == false)
+            {
+                uniqueIndices.insert(uniqueIndices.end(), indices.begin() + i, indices.begin() + i + 3);
+            }
+        }
+
+        Benchmark::Consume(uniqueIndices.data());
+        return uniqueVertices.size();
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main(int argc, char ** argv)
+{
+    bool const isQuick = Benchmark::IsQuick(argc, argv);
+    int const repeatCount = isQuick ? 1 : 3;
+
+    auto jobSystem = JobSystem::Instantiate();
+
+    std::printf("%d sphere primitives per mesh, %d compute threads\n", PrimitiveCount, JobSystem::AvailableThreadCount());
+    std::printf(
+        "%10s %10s %10s %14s %12s %16s\n",
+        "resolution", "vertices", "welded", "pairwise ms", "weld ms", "vertices/s"
+    );
+
+    std::vector<int> const resolutions = isQuick
+        ? std::vector<int>{16, 64}
+        : std::vector<int>{16, 32, 64, 128, 256, 512, 1024, 2048};
+
+    for (auto const resolution : resolutions)
+    {
+        auto const sphere = CreateSphere(resolution);
+        auto const vertexCount = static_cast<uint32_t>(sphere.vertices.size()) * PrimitiveCount;
+
+        double pairwiseMs = -1.0;
+        if (vertexCount <= MaxPairwiseVertexCount)
+        {
+            pairwiseMs = Benchmark::MeasureMs(repeatCount, [&sphere]()->void
+            {
+                for (int i = 0; i < PrimitiveCount; ++i)
+                {
+                    Benchmark::Consume(PairwiseWeld(sphere));
+                }
+            });
+        }
+
+        // The mesh is rebuilt for every run, Only Optimize is measured
+        uint32_t weldedVertexCount = 0;
+        double weldMs = std::numeric_limits<double>::max();
+        for (int i = 0; i < repeatCount; ++i)
+        {
+            auto mesh = CreateMesh(sphere);
+            weldMs = std::min(weldMs, Benchmark::MeasureMs(1, [&mesh]()->void
+            {
+                mesh->Optimize();
+            }));
+            weldedVertexCount = mesh->GetVertexCount();
+        }
+
+        if (pairwiseMs >= 0.0)
+        {
+            std::printf("%10d %10u %10u %14.2f", resolution, vertexCount, weldedVertexCount, pairwiseMs);
+        }
+        else
+        {
+            std::printf("%10d %10u %10u %14s", resolution, vertexCount, weldedVertexCount, "-");
+        }
+        std::printf(" %12.2f %16.0f\n", weldMs, static_cast<double>(vertexCount) / (weldMs / 1000.0));
+    }
+
+    jobSystem.reset();
+    JobSystem::Destroy();
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include "BenchmarkUtils.hpp"
+
+#include "JobSystem.hpp"
+#include "NoiseGenerator.hpp"
+
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+// Voxels per second of every volume that NoiseGenerator bakes. The reference calls the single point Perlin function
+// once per voxel and octave, Which is what baking without the row kernels would cost.
+
+using namespace MFA;
+
+namespace
+{
+    static constexpr int Frequency = 4;
+    static constexpr int Octaves = 3;
+
+    struct Volume
+    {
+        char const * name;
+        std::function<std::shared_ptr<AS::Texture>(uint32_t resolution)> bake;
+    };
+
+    //-------------------------------------------------------------------------------------------------
+
+    void PointwisePerlin(uint32_t const resolution)
+    {
+        JobSystem::ParallelFor(static_cast<int>(resolution), 1, [&](int const begin, int const end)->void
+        {
+            float localSum = 0.0f;
+            for (int z = begin; z < end; ++z)
+            {
+                for (uint32_t y = 0; y < resolution; ++y)
+                {
+                    for (uint32_t x = 0; x < resolution; ++x)
+                    {
+                        glm::vec3 const position = glm::vec3{x, y, z} / static_cast<float>(resolution);
+                        float amplitude = 1.0f;
+                        for (int octave = 0; octave < Octaves; ++octave)
+                        {
+                            int const period = Frequency << octave;
+                            localSum += amplitude * NoiseGenerator::Perlin(position * static_cast<float>(period), period, 0);
+                            amplitude *= 0.5f;
+                        }
+                    }
+                }
+            }
+            Benchmark::Consume(localSum);
+        });
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    double VoxelsPerSecond(uint32_t const resolution, double const ms)
+    {
+        return static_cast<double>(resolution) * resolution * resolution / (ms / 1000.0);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main(int argc, char ** argv)
+{
+    bool const isQuick = Benchmark::IsQuick(argc, argv);
+    int const repeatCount = isQuick ? 1 : 3;
+
+    auto jobSystem = JobSystem::Instantiate();
+
+    NoiseGenerator::VolumeParams params{.frequency = Frequency, .octaves = Octaves};
+    std::vector<Volume> const volumes {
+        {"Perlin", [&params](uint32_t const resolution)
+        {
+            params.resolution = resolution;
+            return NoiseGenerator::PerlinVolume(params);
+        }},
+        {"Worley F1", [&params](uint32_t const resolution)
+        {
+            params.resolution = resolution;
+            return NoiseGenerator::WorleyVolume(params, NoiseGenerator::WorleyFeature::F1);
+        }},
+        {"PerlinWorley", [&params](uint32_t const resolution)
+        {
+            params.resolution = resolution;
+            return NoiseGenerator::PerlinWorleyVolume(params);
+        }},
+        {"CloudShape", [](uint32_t const resolution)
+        {
+            return NoiseGenerator::CloudShapeVolume(resolution);
+        }},
+        {"CloudDetail", [](uint32_t const resolution)
+        {
+            return NoiseGenerator::CloudDetailVolume(resolution);
+        }},
+    };
+
+    std::vector<uint32_t> const resolutions = isQuick
+        ? std::vector<uint32_t>{16}
+        : std::vector<uint32_t>{32, 64, 128};
+
+    std::printf("%d compute threads, %d octaves, Million voxels/s\n", JobSystem::AvailableThreadCount(), Octaves);
+    std::printf("%10s %16s", "resolution", "pointwise Perlin");
+    for (auto const & volume : volumes)
+    {
+        std::printf(" %13s", volume.name);
+    }
+    std::printf("\n");
+
+    for (auto const resolution : resolutions)
+    {
+        double const pointwiseMs = Benchmark::MeasureMs(repeatCount, [resolution]()->void
+        {
+            PointwisePerlin(resolution);
+        });
+        std::printf("%10u %16.2f", resolution, VoxelsPerSecond(resolution, pointwiseMs) / 1e6);
+
+        for (auto const & volume : volumes)
+        {
+            double const ms = Benchmark::MeasureMs(repeatCount, [&volume, resolution]()->void
+            {
+                Benchmark::Consume(volume.bake(resolution).get());
+            });
+            std::printf(" %13.2f", VoxelsPerSecond(resolution, ms) / 1e6);
+        }
+        std::printf("\n");
+    }
+
+    jobSystem.reset();
+    JobSystem::Destroy();
+
+    return 0;
+}
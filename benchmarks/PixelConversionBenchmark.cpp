@@ -0,0 +1,173 @@
+#include "BenchmarkUtils.hpp"
+
+#include "AssetTexture_PixelConversion.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+
+// Every pixel conversion on every instruction set that the cpu supports, Against the per component loop that
+// LoadUncompressed used to run. Single threaded, The importer splits the rows across the job system on top of this.
+// Every vector path is compared with the scalar one and the benchmark fails if they differ.
+
+using namespace MFA;
+namespace PC = Asset::PixelConversion;
+
+namespace
+{
+    struct Conversion
+    {
+        char const * name;
+        size_t inputComponents;
+        // Bytes per output pixel
+        size_t outputBytes;
+        std::function<void(uint8_t const * input, uint8_t * output, size_t pixelCount)> convert;
+    };
+
+    //-------------------------------------------------------------------------------------------------
+
+    // The loop that LoadUncompressed ran before the conversions existed, Missing components become 255
+    void LegacyExpand(uint8_t const * input, uint8_t * output, size_t const pixelCount, size_t const inputComponents)
+    {
+        for (size_t pixel = 0; pixel < pixelCount; ++pixel)
+        {
+            for (size_t component = 0; component < 4; ++component)
+            {
+                output[pixel * 4 + component] = component < inputComponents
+                    ? input[pixel * inputComponents + component]
+                    : 255u;
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    double MegaPixelsPerSecond(size_t const pixelCount, double const ms)
+    {
+        return static_cast<double>(pixelCount) / 1e6 / (ms / 1000.0);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main(int argc, char ** argv)
+{
+    bool const isQuick = Benchmark::IsQuick(argc, argv);
+    int const repeatCount = isQuick ? 1 : 5;
+
+    std::vector<Conversion> const conversions {
+        {"RGBToRGBA", 3, 4, [](uint8_t const * input, uint8_t * output, size_t const count)
+        {
+            PC::RGBToRGBA(input, output, count);
+        }},
+        {"RToRGBA", 1, 4, [](uint8_t const * input, uint8_t * output, size_t const count)
+        {
+            PC::RToRGBA(input, output, count);
+        }},
+        {"GreyAlphaToRGBA", 2, 4, [](uint8_t const * input, uint8_t * output, size_t const count)
+        {
+            PC::GreyAlphaToRGBA(input, output, count);
+        }},
+        {"SRGBToLinear", 4, 8, [](uint8_t const * input, uint8_t * output, size_t const count)
+        {
+            PC::SRGBToLinear(input, reinterpret_cast<uint16_t *>(output), count);
+        }},
+        {"Expand8To16", 4, 8, [](uint8_t const * input, uint8_t * output, size_t const count)
+        {
+            PC::Expand8To16(input, reinterpret_cast<uint16_t *>(output), count * 4);
+        }},
+        {"PremultiplyAlpha", 4, 4, [](uint8_t const * input, uint8_t * output, size_t const count)
+        {
+            PC::PremultiplyAlpha(input, output, count);
+        }},
+        {"Swizzle", 4, 4, [](uint8_t const * input, uint8_t * output, size_t const count)
+        {
+            PC::Swizzle(input, output, count, {2, 1, 0, 3});
+        }},
+    };
+
+    PC::Isa const isas[] {PC::Isa::Scalar, PC::Isa::SSSE3, PC::Isa::AVX2, PC::Isa::NEON};
+    auto const bestIsa = PC::GetIsa();
+
+    std::vector<size_t> const sizes = isQuick
+        ? std::vector<size_t>{256}
+        : std::vector<size_t>{512, 1024, 2048, 4096};
+
+    std::printf("Megapixels/s, The old loop only exists for the conversions that pad with 255\n");
+    std::printf("%6s %18s %10s", "size", "conversion", "old loop");
+    for (auto const isa : isas)
+    {
+        std::printf(" %10s", PC::GetIsaName(isa));
+    }
+    std::printf("\n");
+
+    std::mt19937 random{1234};
+    bool isEachMatching = true;
+    for (auto const size : sizes)
+    {
+        size_t const pixelCount = size * size;
+        std::vector<uint8_t> input(pixelCount * 4);
+        for (auto & value : input)
+        {
+            value = static_cast<uint8_t>(random());
+        }
+
+        for (auto const & conversion : conversions)
+        {
+            std::vector<uint8_t> expected(pixelCount * conversion.outputBytes);
+            std::vector<uint8_t> output(pixelCount * conversion.outputBytes);
+
+            std::printf("%6zu %18s", size, conversion.name);
+            if (conversion.outputBytes == 4 && conversion.inputComponents < 4)
+            {
+                double const legacyMs = Benchmark::MeasureMs(repeatCount, [&]()->void
+                {
+                    LegacyExpand(input.data(), output.data(), pixelCount, conversion.inputComponents);
+                    Benchmark::Consume(output.data());
+                });
+                std::printf(" %10.0f", MegaPixelsPerSecond(pixelCount, legacyMs));
+            }
+            else
+            {
+                std::printf(" %10s", "-");
+            }
+
+            for (auto const isa : isas)
+            {
+                PC::SetIsa(isa);
+                if (PC::GetIsa() != isa)
+                {
+                    std::printf(" %10s", "-");
+                    continue;
+                }
+                double const ms = Benchmark::MeasureMs(repeatCount, [&]()->void
+                {
+                    conversion.convert(input.data(), output.data(), pixelCount);
+                    Benchmark::Consume(output.data());
+                });
+                std::printf(" %10.0f", MegaPixelsPerSecond(pixelCount, ms));
+
+                if (isa == PC::Isa::Scalar)
+                {
+                    expected = output;
+                }
+                else if (std::memcmp(expected.data(), output.data(), output.size()) != 0)
+                {
+                    isEachMatching = false;
+                }
+            }
+            std::printf("\n");
+        }
+    }
+    PC::SetIsa(bestIsa);
+
+    if (isEachMatching == false)
+    {
+        std::printf("A vectorized conversion does not match the scalar one\n");
+        return 1;
+    }
+    return 0;
+}
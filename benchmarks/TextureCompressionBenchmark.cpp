@@ -0,0 +1,124 @@
+#include "BenchmarkUtils.hpp"
+
+#include "AssetTexture.hpp"
+#include "AssetTexture_BlockCompression.hpp"
+#include "ImportTexture.hpp"
+#include "JobSystem.hpp"
+
+#include "stb_image_write.h"
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Block compression throughput of every encoder and the cost of a full texture import, Decoding the png, Building
+// the mip chain and compressing it, Against reading the baked cache back.
+
+using namespace MFA;
+using Format = Asset::Texture::Format;
+
+namespace
+{
+    std::vector<uint8_t> CreateImage(uint32_t const size)
+    {
+        std::vector<uint8_t> pixels(static_cast<size_t>(size) * size * 4);
+        for (uint32_t y = 0; y < size; ++y)
+        {
+            for (uint32_t x = 0; x < size; ++x)
+            {
+                float const u = static_cast<float>(x) / static_cast<float>(size);
+                float const v = static_cast<float>(y) / static_cast<float>(size);
+                auto * pixel = &pixels[(static_cast<size_t>(y) * size + x) * 4];
+                pixel[0] = static_cast<uint8_t>(255.0f * (0.5f + 0.5f * std::sin(u * 40.0f + v * 7.0f)));
+                pixel[1] = static_cast<uint8_t>(255.0f * v);
+                pixel[2] = static_cast<uint8_t>(((x / 16) + (y / 16)) % 2 == 0 ? 40 : 200);
+                pixel[3] = static_cast<uint8_t>(255.0f * u);
+            }
+        }
+        return pixels;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    double MegaPixelsPerSecond(uint32_t const size, double const ms)
+    {
+        return static_cast<double>(size) * size / 1e6 / (ms / 1000.0);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main(int argc, char ** argv)
+{
+    bool const isQuick = Benchmark::IsQuick(argc, argv);
+    int const repeatCount = isQuick ? 1 : 3;
+
+    auto jobSystem = JobSystem::Instantiate();
+
+    std::vector<uint32_t> const sizes = isQuick
+        ? std::vector<uint32_t>{256}
+        : std::vector<uint32_t>{256, 1024, 2048, 4096};
+
+    Format const formats[] {
+        Format::BC1_UNorm_Linear_RGB,
+        Format::BC4_UNorm_Linear_R,
+        Format::BC5_UNorm_Linear_RG,
+        Format::BC7_UNorm_Linear_RGBA
+    };
+
+    std::printf("%d compute threads, Encoders in megapixels/s, Imports are BC7 with mips in ms\n", JobSystem::AvailableThreadCount());
+    std::printf(
+        "%6s %10s %10s %10s %10s %12s %12s\n",
+        "size", "BC1", "BC4", "BC5", "BC7", "import ms", "cached ms"
+    );
+
+    auto const directory = std::filesystem::temp_directory_path();
+
+    for (auto const size : sizes)
+    {
+        auto const image = CreateImage(size);
+
+        std::printf("%6u", size);
+        for (auto const format : formats)
+        {
+            double const ms = Benchmark::MeasureMs(repeatCount, [&image, format, size]()->void
+            {
+                Benchmark::Consume(Asset::BlockCompression::Encode(format, image.data(), size, size)->Ptr());
+            });
+            std::printf(" %10.1f", MegaPixelsPerSecond(size, ms));
+        }
+
+        auto const path = (directory / ("mfa_texture_compression_benchmark_" + std::to_string(size) + ".png")).string();
+        if (stbi_write_png(path.c_str(), static_cast<int>(size), static_cast<int>(size), 4, image.data(), static_cast<int>(size * 4)) == 0)
+        {
+            std::printf("\nFailed to write %s\n", path.c_str());
+            return 1;
+        }
+
+        Importer::ImageImportParams params{.sRGB = true, .compression = Importer::ImageCompression::BC7, .useCache = false};
+        double const importMs = Benchmark::MeasureMs(repeatCount, [&path, &params]()->void
+        {
+            Benchmark::Consume(Importer::CompressedImage(path, params).get());
+        });
+
+        params.useCache = true;
+        Benchmark::Consume(Importer::CompressedImage(path, params).get());
+        double const cachedMs = Benchmark::MeasureMs(repeatCount, [&path, &params]()->void
+        {
+            Benchmark::Consume(Importer::CompressedImage(path, params).get());
+        });
+        std::printf(" %12.2f %12.2f\n", importMs, cachedMs);
+
+        std::error_code error{};
+        std::filesystem::remove(path, error);
+        std::filesystem::remove(path + ".bc7.cache", error);
+    }
+
+    jobSystem.reset();
+    JobSystem::Destroy();
+
+    return 0;
+}
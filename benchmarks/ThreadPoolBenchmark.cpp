@@ -0,0 +1,229 @@
+#include "BenchmarkUtils.hpp"
+
+#include "ThreadPool.hpp"
+#include "ThreadUtils.hpp"
+
+#include "stb_image.h"
+#include "stb_image_write.h"
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Uneven asset import workload: Every model decodes a few textures and then hands out one job per primitive from the
+// worker that loaded it. Model sizes vary a lot, So a static split leaves threads idle behind the big ones.
+// Work stealing dispatch of ThreadPool is compared against pinning every task to the next worker round-robin, Which
+// is how the pool used to hand out tasks.
+
+using namespace MFA;
+
+namespace
+{
+    struct Model
+    {
+        int textureCount = 0;
+        int meshCount = 0;
+    };
+
+    struct Workload
+    {
+        std::vector<uint8_t> png{};
+        std::vector<Model> models{};
+        int meshGridSize = 0;
+    };
+
+    //-------------------------------------------------------------------------------------------------
+
+    void AppendBytes(void * context, void * data, int size)
+    {
+        auto * bytes = static_cast<std::vector<uint8_t> *>(context);
+        bytes->insert(bytes->end(), static_cast<uint8_t *>(data), static_cast<uint8_t *>(data) + size);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    Workload CreateWorkload(int const modelCount, int const textureSize, int const meshGridSize)
+    {
+        Workload workload{};
+        workload.meshGridSize = meshGridSize;
+
+        // Noise compresses badly, So decoding it costs about as much as a real albedo map
+        std::mt19937 random{1234};
+        std::vector<uint8_t> pixels(static_cast<size_t>(textureSize) * textureSize * 4);
+        for (size_t i = 0; i < pixels.size(); ++i)
+        {
+            pixels[i] = static_cast<uint8_t>((i / 4 % textureSize) ^ (random() & 31));
+        }
+        stbi_write_png_to_func(AppendBytes, &workload.png, textureSize, textureSize, 4, pixels.data(), textureSize * 4);
+
+        // Most models are small and a few are large, Like the props and the set pieces of a scene
+        std::uniform_real_distribution<float> distribution{0.0f, 1.0f};
+        for (int i = 0; i < modelCount; ++i)
+        {
+            bool const isLarge = distribution(random) < 0.1f;
+            workload.models.emplace_back(Model{
+                .textureCount = isLarge ? 4 : static_cast<int>(distribution(random) * 2.0f),
+                .meshCount = isLarge ? 96 : 2 + static_cast<int>(distribution(random) * 6.0f)
+            });
+        }
+        return workload;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void DecodeTexture(std::vector<uint8_t> const & png)
+    {
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        auto * pixels = stbi_load_from_memory(png.data(), static_cast<int>(png.size()), &width, &height, &channels, 4);
+        Benchmark::Consume(pixels[0]);
+        stbi_image_free(pixels);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Smooth normals of a height field, Stands in for the per primitive work of the mesh importer
+    void ProcessMesh(int const gridSize)
+    {
+        std::vector<glm::vec3> positions(static_cast<size_t>(gridSize) * gridSize);
+        std::vector<glm::vec3> normals(positions.size(), glm::vec3{0.0f});
+        for (int y = 0; y < gridSize; ++y)
+        {
+            for (int x = 0; x < gridSize; ++x)
+            {
+                positions[y * gridSize + x] = glm::vec3{x, std::sin(x * 0.1f) * std::cos(y * 0.1f), y};
+            }
+        }
+        for (int y = 0; y + 1 < gridSize; ++y)
+        {
+            for (int x = 0; x + 1 < gridSize; ++x)
+            {
+                int const i0 = y * gridSize + x;
+                int const i1 = i0 + 1;
+                int const i2 = i0 + gridSize;
+                auto const normal = glm::cross(positions[i1] - positions[i0], positions[i2] - positions[i0]);
+                normals[i0] += normal;
+                normals[i1] += normal;
+                normals[i2] += normal;
+            }
+        }
+        for (auto & normal : normals)
+        {
+            normal = glm::normalize(normal);
+        }
+        Benchmark::Consume(normals[0]);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    template<typename AssignFunction>
+    void RunWorkload(Workload const & workload, AssignFunction const & assign)
+    {
+        std::atomic<int> pendingTasks{static_cast<int>(workload.models.size())};
+        for (auto const & model : workload.models)
+        {
+            assign([&workload, &model, &pendingTasks, &assign]()->void
+            {
+                for (int i = 0; i < model.textureCount; ++i)
+                {
+                    DecodeTexture(workload.png);
+                }
+                // Primitives are handed out from the worker, Like the importer does once the buffers are loaded
+                pendingTasks.fetch_add(model.meshCount, std::memory_order_relaxed);
+                for (int i = 0; i < model.meshCount; ++i)
+                {
+                    assign([&workload, &pendingTasks]()->void
+                    {
+                        ProcessMesh(workload.meshGridSize);
+                        pendingTasks.fetch_sub(1, std::memory_order_release);
+                    });
+                }
+                pendingTasks.fetch_sub(1, std::memory_order_release);
+            });
+        }
+        while (pendingTasks.load(std::memory_order_acquire) > 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main(int argc, char ** argv)
+{
+    bool const isQuick = Benchmark::IsQuick(argc, argv);
+    int const repeatCount = isQuick ? 1 : 5;
+
+    auto const workload = CreateWorkload(isQuick ? 32 : 256, isQuick ? 128 : 512, isQuick ? 32 : 64);
+
+    int serialTextures = 0;
+    int serialMeshes = 0;
+    for (auto const & model : workload.models)
+    {
+        serialTextures += model.textureCount;
+        serialMeshes += model.meshCount;
+    }
+    auto const taskCount = static_cast<double>(workload.models.size() + serialMeshes);
+
+    double const serialMs = Benchmark::MeasureMs(repeatCount, [&workload]()->void
+    {
+        RunWorkload(workload, [](ThreadPool::Task const & task)->void
+        {
+            task();
+        });
+    });
+
+    std::printf(
+        "%zu models, %d texture decodes, %d mesh jobs, Serial %.2f ms\n",
+        workload.models.size(),
+        serialTextures,
+        serialMeshes,
+        serialMs
+    );
+    std::printf("%8s %16s %16s %10s %10s\n", "threads", "round-robin ms", "stealing ms", "speedup", "steals");
+
+    int const maxThreadCount = std::max(ThreadUtils::HardwareThreadCount(), 2);
+    for (int threadCount = 2; threadCount <= maxThreadCount; threadCount *= 2)
+    {
+        ThreadPool pool{ThreadPool::Params{.threadCount = threadCount, .pinEachThread = false}};
+
+        std::atomic<int> nextThread{0};
+        double const roundRobinMs = Benchmark::MeasureMs(repeatCount, [&]()->void
+        {
+            RunWorkload(workload, [&pool, &nextThread](ThreadPool::Task const & task)->void
+            {
+                pool.AssignTask(nextThread.fetch_add(1, std::memory_order_relaxed), task);
+            });
+        });
+
+        auto const stealsBefore = pool.GetStats().steals;
+        double const stealingMs = Benchmark::MeasureMs(repeatCount, [&]()->void
+        {
+            RunWorkload(workload, [&pool](ThreadPool::Task const & task)->void
+            {
+                pool.AssignTask(task);
+            });
+        });
+        auto const steals = (pool.GetStats().steals - stealsBefore) / static_cast<uint64_t>(repeatCount);
+
+        std::printf(
+            "%8d %16.2f %16.2f %9.2fx %10llu   (%.0f tasks/s)\n",
+            threadCount,
+            roundRobinMs,
+            stealingMs,
+            roundRobinMs / stealingMs,
+            static_cast<unsigned long long>(steals),
+            taskCount / (stealingMs / 1000.0)
+        );
+    }
+
+    return 0;
+}
@@ -0,0 +1,239 @@
+#include "BenchmarkUtils.hpp"
+
+#include "BedrockMath.hpp"
+#include "BedrockRotation.hpp"
+#include "JobSystem.hpp"
+#include "Transform.hpp"
+#include "TransformStore.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+// Cost of a frame that rotates some nodes of a random forest and then reads every world matrix. Transform is a handle
+// over a TransformStore, So the first read runs one batched update over the whole store. The reference is the pointer
+// linked transform that the store replaced, Every node keeps its own matrices and a set of children, A change marks
+// the whole subtree dirty and a read walks up the parents.
+
+using namespace MFA;
+
+namespace
+{
+    static constexpr uint32_t Seed = 1234;
+    // Chance of a node to be a new root instead of the child of an earlier node
+    static constexpr float RootChance = 0.01f;
+
+    //-------------------------------------------------------------------------------------------------
+
+    class LinkedTransform
+    {
+    public:
+
+        void SetEulerAngles(glm::vec3 const & eulerAngles)
+        {
+            if (mLocalRotation.SetEulerAngles(eulerAngles) == true)
+            {
+                mIsLocalTransformDirty = true;
+                SetGlobalTransformDirty();
+            }
+        }
+
+        void SetParent(LinkedTransform * parent)
+        {
+            mParent = parent;
+            mParent->mChildren.emplace(this);
+            SetGlobalTransformDirty();
+        }
+
+        glm::mat4 const & GlobalTransform()
+        {
+            if (mGlobalTransformDirty == true)
+            {
+                if (mIsLocalTransformDirty == true)
+                {
+                    mLocalTransform = mLocalExtraTransform *
+                        Math::Translate(mLocalPosition) *
+                        mLocalRotation.GetMatrix() *
+                        Math::Scale(mLocalScale);
+                    mIsLocalTransformDirty = false;
+                }
+                mGlobalTransform = mParent != nullptr
+                    ? mParent->GlobalTransform() * mLocalTransform
+                    : mLocalTransform;
+                mGlobalTransformDirty = false;
+            }
+            return mGlobalTransform;
+        }
+
+    private:
+
+        void SetGlobalTransformDirty()
+        {
+            mGlobalTransformDirty = true;
+            for (auto * child : mChildren)
+            {
+                child->SetGlobalTransformDirty();
+            }
+        }
+
+        glm::vec3 mLocalPosition{0.0f, 1.0f, 0.0f};
+        Rotation mLocalRotation{};
+        glm::vec3 mLocalScale{1.0f};
+        glm::mat4 mLocalExtraTransform{1.0f};
+        glm::mat4 mLocalTransform{1.0f};
+        bool mIsLocalTransformDirty = true;
+        glm::mat4 mGlobalTransform{1.0f};
+        bool mGlobalTransformDirty = true;
+        LinkedTransform * mParent = nullptr;
+        std::set<LinkedTransform *> mChildren{};
+    };
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Parent of every node, -1 for roots. Parents always come before their children like in a loaded scene.
+    std::vector<int> CreateForest(uint32_t const nodeCount)
+    {
+        std::mt19937 random{Seed};
+        std::uniform_real_distribution<float> chance{0.0f, 1.0f};
+        std::vector<int> parents(nodeCount, -1);
+        for (uint32_t node = 1; node < nodeCount; ++node)
+        {
+            if (chance(random) >= RootChance)
+            {
+                parents[node] = std::uniform_int_distribution<int>{0, static_cast<int>(node) - 1}(random);
+            }
+        }
+        return parents;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Every nth node, So the changed nodes are spread over the forest
+    std::vector<uint32_t> ChangedNodes(uint32_t const nodeCount, float const changedRatio)
+    {
+        auto const stride = static_cast<uint32_t>(1.0f / changedRatio);
+        std::vector<uint32_t> nodes{};
+        for (uint32_t node = 0; node < nodeCount; node += stride)
+        {
+            nodes.emplace_back(node);
+        }
+        return nodes;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    double MeasureLinked(
+        std::vector<int> const & parents,
+        std::vector<uint32_t> const & changedNodes,
+        int const repeatCount
+    )
+    {
+        std::vector<LinkedTransform> transforms(parents.size());
+        for (size_t node = 0; node < parents.size(); ++node)
+        {
+            if (parents[node] >= 0)
+            {
+                transforms[node].SetParent(&transforms[parents[node]]);
+            }
+        }
+
+        float angle = 0.0f;
+        return Benchmark::MeasureMs(repeatCount, [&]()->void
+        {
+            angle += 1.0f;
+            for (auto const node : changedNodes)
+            {
+                transforms[node].SetEulerAngles(glm::vec3{angle, 0.0f, 0.0f});
+            }
+            float sum = 0.0f;
+            for (auto & transform : transforms)
+            {
+                sum += transform.GlobalTransform()[3][1];
+            }
+            Benchmark::Consume(sum);
+        });
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    double MeasureStore(
+        std::vector<int> const & parents,
+        std::vector<uint32_t> const & changedNodes,
+        int const repeatCount
+    )
+    {
+        auto const store = std::make_shared<TransformStore>();
+        std::vector<Transform> transforms{};
+        transforms.reserve(parents.size());
+        for (size_t node = 0; node < parents.size(); ++node)
+        {
+            auto & transform = transforms.emplace_back(store);
+            transform.SetLocalPosition(glm::vec3{0.0f, 1.0f, 0.0f});
+            if (parents[node] >= 0)
+            {
+                transform.SetParent(&transforms[parents[node]]);
+            }
+        }
+        // Sorting the store by depth is part of loading, Not of a frame
+        store->Update();
+
+        float angle = 0.0f;
+        return Benchmark::MeasureMs(repeatCount, [&]()->void
+        {
+            angle += 1.0f;
+            for (auto const node : changedNodes)
+            {
+                transforms[node].SetEulerAngles(glm::vec3{angle, 0.0f, 0.0f});
+            }
+            float sum = 0.0f;
+            for (auto & transform : transforms)
+            {
+                sum += transform.GlobalTransform()[3][1];
+            }
+            Benchmark::Consume(sum);
+        });
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main(int argc, char ** argv)
+{
+    bool const isQuick = Benchmark::IsQuick(argc, argv);
+    int const repeatCount = isQuick ? 1 : 3;
+    std::vector<uint32_t> const nodeCounts = isQuick
+        ? std::vector<uint32_t>{10000}
+        : std::vector<uint32_t>{10000, 100000, 1000000};
+    float const changedRatios[] {1.0f, 0.01f};
+
+    auto jobSystem = JobSystem::Instantiate();
+
+    std::printf("%d compute threads, ms per frame\n", JobSystem::AvailableThreadCount());
+    std::printf("%10s %10s %12s %12s %10s\n", "nodes", "changed", "linked", "store", "speedup");
+    for (auto const nodeCount : nodeCounts)
+    {
+        auto const parents = CreateForest(nodeCount);
+        for (auto const changedRatio : changedRatios)
+        {
+            auto const changedNodes = ChangedNodes(nodeCount, changedRatio);
+            double const linkedMs = MeasureLinked(parents, changedNodes, repeatCount);
+            double const storeMs = MeasureStore(parents, changedNodes, repeatCount);
+            std::printf(
+                "%10u %9.0f%% %12.3f %12.3f %9.2fx\n",
+                nodeCount,
+                changedRatio * 100.0f,
+                linkedMs,
+                storeMs,
+                linkedMs / storeMs
+            );
+        }
+    }
+
+    jobSystem.reset();
+    JobSystem::Destroy();
+
+    return 0;
+}
@@ -0,0 +1,631 @@
+#include "BenchmarkUtils.hpp"
+#include "DisplayListCache.hpp"
+
+#include <litehtml.h>
+#include <gumbo.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Cost of a frame that changes the text of some counters of a HUD like page, Against the number of changed nodes.
+// The full rebuild is what WebViewContainer did for every change, A new document that styles, lays out and draws the
+// whole page. The in place update is what it does now, update_node and render_dirty for the changed nodes, A draw of
+// only the boxes that were laid out into the display list cache and the replay of the cache into the display list.
+// The tree draw is what a draw of the whole tree costs on top of the relayout, It is also the reference that every in
+// place frame has to match.
+// WebViewContainer needs a vulkan device, So the container here takes the same steps with the same display list, cache
+// and primitive sizes but measures text by its length and skips the upload.
+
+using namespace MFA;
+
+namespace
+{
+    static constexpr uint32_t Seed = 1234;
+    static constexpr int ClientWidth = 1920;
+    static constexpr int ClientHeight = 1080;
+
+    using PrimitiveType = DisplayList::PrimitiveType;
+
+    // Same layouts as the instances of the pipelines and the vertex of the text overlay pipeline
+    struct Corner
+    {
+        glm::vec2 position{};
+        glm::vec2 radius{};
+        glm::vec4 color{};
+    };
+
+    struct FillInstance
+    {
+        Corner corners[4]{};
+    };
+
+    struct BorderInstance
+    {
+        Corner corners[4]{};
+        glm::vec4 widths{};
+    };
+
+    struct ImageInstance
+    {
+        glm::vec2 values[12]{};
+    };
+
+    struct TextVertex
+    {
+        glm::vec2 position{};
+        glm::vec2 uv{};
+        glm::vec3 color{};
+    };
+
+    //-------------------------------------------------------------------------------------------------
+
+    DisplayList::Bounds BoxBounds(litehtml::position const & box)
+    {
+        return DisplayList::Bounds{
+            .min = glm::vec2{static_cast<float>(box.x), static_cast<float>(box.y)},
+            .max = glm::vec2{static_cast<float>(box.x + box.width), static_cast<float>(box.y + box.height)}
+        };
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    glm::vec4 ConvertColor(litehtml::web_color const & webColor)
+    {
+        return glm::vec4{webColor.red, webColor.green, webColor.blue, webColor.alpha} / 255.0f;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    FillInstance CreateFill(litehtml::position const & box, glm::vec4 const & color)
+    {
+        auto const x = static_cast<float>(box.x);
+        auto const y = static_cast<float>(box.y);
+        auto const width = static_cast<float>(box.width);
+        auto const height = static_cast<float>(box.height);
+        return FillInstance{.corners = {
+            Corner{.position = {x, y}, .color = color},
+            Corner{.position = {x, y + height}, .color = color},
+            Corner{.position = {x + width, y}, .color = color},
+            Corner{.position = {x + width, y + height}, .color = color},
+        }};
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    class HeadlessContainer : public litehtml::document_container
+    {
+    public:
+
+        // Same steps as WebViewContainer::Redraw without the emit
+        void Draw(litehtml::document & document)
+        {
+            mCache.Begin();
+            mTextures.clear();
+            document.draw(0, 0, 0, &mClip);
+            mCache.End();
+        }
+
+        // Same steps as WebViewContainer::RedrawDirty without the emit, Returns false when it drew the whole tree
+        bool DrawDirty(litehtml::document & document)
+        {
+            mCache.BeginUpdate();
+            bool const isDrawn = document.draw_dirty(0, &mClip);
+            bool const isUpdated = mCache.EndUpdate();
+            if (isDrawn == false || isUpdated == false)
+            {
+                Draw(document);
+                return false;
+            }
+            return true;
+        }
+
+        // Same as WebViewContainer::EmitDisplayList, There is no state that needs its own resources
+        void Emit()
+        {
+            mDisplayList.Begin();
+            mCache.Replay(mDisplayList, [](PrimitiveType, void const * resource)->void const *
+            {
+                return resource;
+            });
+            mDisplayList.End();
+        }
+
+        [[nodiscard]]
+        DisplayList const & GetDisplayList() const noexcept
+        {
+            return mDisplayList;
+        }
+
+        litehtml::uint_ptr create_font(
+            const char *,
+            int const size,
+            int,
+            litehtml::font_style,
+            unsigned int,
+            litehtml::font_metrics * fm
+        ) override
+        {
+            fm->font_size = size;
+            fm->height = size;
+            fm->ascent = size * 4 / 5;
+            fm->descent = size / 5;
+            fm->x_height = size / 2;
+            return static_cast<litehtml::uint_ptr>(size);
+        }
+
+        void delete_font(litehtml::uint_ptr) override {}
+
+        int text_width(const char * text, litehtml::uint_ptr const hFont) override
+        {
+            return static_cast<int>(std::strlen(text)) * static_cast<int>(hFont) / 2;
+        }
+
+        // A quad per character, Like the glyph run that WebViewContainer offsets to the position of the text
+        void draw_text(
+            litehtml::uint_ptr,
+            const char * text,
+            litehtml::uint_ptr const hFont,
+            litehtml::web_color const color,
+            const litehtml::position & pos
+        ) override
+        {
+            auto const length = static_cast<uint32_t>(std::strlen(text));
+            if (length == 0)
+            {
+                return;
+            }
+            auto const advance = static_cast<float>(hFont) / 2.0f;
+            auto const height = static_cast<float>(hFont);
+            glm::vec2 const offset{static_cast<float>(pos.x), static_cast<float>(pos.y)};
+            glm::vec3 const textColor{ConvertColor(color)};
+
+            static constexpr glm::vec2 QuadCorners[6]{{0, 0}, {0, 1}, {1, 0}, {1, 0}, {0, 1}, {1, 1}};
+            mTextVertices.resize(length * 6);
+            for (uint32_t i = 0; i < length; ++i)
+            {
+                for (uint32_t j = 0; j < 6; ++j)
+                {
+                    auto & vertex = mTextVertices[i * 6 + j];
+                    vertex.position = offset + glm::vec2{(static_cast<float>(i) + QuadCorners[j].x) * advance,
+                        QuadCorners[j].y * height};
+                    vertex.uv = QuadCorners[j];
+                    vertex.color = textColor;
+                }
+            }
+
+            DisplayList::Bounds const bounds{
+                .min = offset,
+                .max = offset + glm::vec2{static_cast<float>(length) * advance, height}
+            };
+            mCache.AddVertices(
+                PrimitiveType::Text,
+                reinterpret_cast<void const *>(hFont),
+                mTextVertices.data(),
+                length * 6,
+                bounds
+            );
+        }
+
+        int pt_to_px(int const pt) const override { return pt; }
+
+        int get_default_font_size() const override { return 16; }
+
+        const char * get_default_font_name() const override { return "sans-serif"; }
+
+        void draw_list_marker(litehtml::uint_ptr, const litehtml::list_marker &) override {}
+
+        void load_image(const char *, const char *, bool) override {}
+
+        void get_image_size(const char *, const char *, litehtml::size &) override {}
+
+        void draw_image(
+            litehtml::uint_ptr,
+            const litehtml::background_layer & layer,
+            const std::string & url,
+            const std::string &
+        ) override
+        {
+            // The address of the entry stands in for the texture
+            auto const & texture = *mTextures.try_emplace(url, 0).first;
+            mCache.AddInstance(PrimitiveType::Image, &texture, ImageInstance{}, BoxBounds(layer.border_box));
+        }
+
+        void draw_solid_fill(
+            litehtml::uint_ptr,
+            const litehtml::background_layer & layer,
+            const litehtml::web_color & color
+        ) override
+        {
+            mCache.AddInstance(
+                PrimitiveType::SolidFill,
+                nullptr,
+                CreateFill(layer.border_box, ConvertColor(color)),
+                BoxBounds(layer.border_box)
+            );
+        }
+
+        void draw_linear_gradient(
+            litehtml::uint_ptr,
+            const litehtml::background_layer &,
+            const litehtml::background_layer::linear_gradient &
+        ) override {}
+
+        void draw_radial_gradient(
+            litehtml::uint_ptr,
+            const litehtml::background_layer &,
+            const litehtml::background_layer::radial_gradient &
+        ) override {}
+
+        void draw_conic_gradient(
+            litehtml::uint_ptr,
+            const litehtml::background_layer &,
+            const litehtml::background_layer::conic_gradient &
+        ) override {}
+
+        void draw_borders(
+            litehtml::uint_ptr,
+            const litehtml::borders & borders,
+            const litehtml::position & draw_pos,
+            bool
+        ) override
+        {
+            auto const fill = CreateFill(draw_pos, ConvertColor(borders.top.color));
+            BorderInstance const instance{
+                .corners = {fill.corners[0], fill.corners[1], fill.corners[2], fill.corners[3]},
+                .widths = glm::vec4{borders.left.width, borders.top.width, borders.right.width, borders.bottom.width}
+            };
+            mCache.AddInstance(PrimitiveType::Border, nullptr, instance, BoxBounds(draw_pos));
+        }
+
+        void set_caption(const char *) override {}
+
+        void set_base_url(const char *) override {}
+
+        void link(const std::shared_ptr<litehtml::document> &, const litehtml::element::ptr &) override {}
+
+        void on_anchor_click(const char *, const litehtml::element::ptr &) override {}
+
+        void on_mouse_event(const litehtml::element::ptr &, litehtml::mouse_event) override {}
+
+        void set_cursor(const char *) override {}
+
+        void transform_text(litehtml::string &, litehtml::text_transform) override {}
+
+        void import_css(litehtml::string &, const litehtml::string &, litehtml::string &) override {}
+
+        void set_clip(const litehtml::position &, const litehtml::border_radiuses &) override {}
+
+        void del_clip() override {}
+
+        void get_client_rect(litehtml::position & client) const override
+        {
+            client = mClip;
+        }
+
+        litehtml::element::ptr create_element(
+            const char *,
+            const litehtml::string_map &,
+            const std::shared_ptr<litehtml::document> &
+        ) override
+        {
+            return nullptr;
+        }
+
+        void get_media_features(litehtml::media_features & media) const override
+        {
+            media.type = litehtml::media_type_screen;
+            media.width = ClientWidth;
+            media.height = ClientHeight;
+            media.device_width = ClientWidth;
+            media.device_height = ClientHeight;
+            media.color = 8;
+            media.resolution = 96;
+        }
+
+        void get_language(litehtml::string &, litehtml::string &) const override {}
+
+        void begin_draw_item(litehtml::uint_ptr, litehtml::uint_ptr const key) override
+        {
+            mCache.BeginItem(key);
+        }
+
+        void end_draw_item(litehtml::uint_ptr) override
+        {
+            mCache.EndItem();
+        }
+
+    private:
+
+        litehtml::position mClip{0, 0, ClientWidth, ClientHeight};
+        DisplayListCache mCache{};
+        DisplayList mDisplayList{};
+        std::unordered_map<std::string, int> mTextures{};
+        std::vector<TextVertex> mTextVertices{};
+    };
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool IsSame(DisplayList const & lhs, DisplayList const & rhs)
+    {
+        for (size_t i = 0; i < DisplayList::PrimitiveTypeCount; ++i)
+        {
+            if (lhs.GetArena(static_cast<PrimitiveType>(i)) != rhs.GetArena(static_cast<PrimitiveType>(i)))
+            {
+                return false;
+            }
+        }
+        auto const & lhsBatches = lhs.GetBatches();
+        auto const & rhsBatches = rhs.GetBatches();
+        if (lhsBatches.size() != rhsBatches.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < lhsBatches.size(); ++i)
+        {
+            auto const lhsDraws = lhs.GetDraws(lhsBatches[i]);
+            auto const rhsDraws = rhs.GetDraws(rhsBatches[i]);
+            if (lhsBatches[i].type != rhsBatches[i].type || lhsBatches[i].resource != rhsBatches[i].resource ||
+                lhsDraws.size() != rhsDraws.size())
+            {
+                return false;
+            }
+            for (size_t j = 0; j < lhsDraws.size(); ++j)
+            {
+                if (lhsDraws[j].firstElement != rhsDraws[j].firstElement ||
+                    lhsDraws[j].elementCount != rhsDraws[j].elementCount)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    struct Page
+    {
+        char const * name;
+        char const * style;
+    };
+
+    // Fixed size counters can be laid out on their own, The size of auto sized ones depends on their text
+    Page const Pages[]
+    {
+        Page{
+            .name = "fixed size",
+            .style = ".row{display:flex;flex-direction:row;align-items:center;padding:4px}"
+                ".label{width:200px;color:white}"
+                ".value{width:100px;height:20px;min-width:0;min-height:0;color:yellow;border:1px solid red;overflow:hidden}"
+        },
+        Page{
+            .name = "auto size",
+            .style = ".row{display:flex;flex-direction:row;align-items:center;padding:4px}"
+                ".label{color:white}"
+                ".value{color:yellow;border:1px solid red}"
+        },
+    };
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::string CreateHtml(Page const & page, int const rowCount)
+    {
+        std::string html = std::string("<html><head><style>") + page.style + "</style></head><body>";
+        for (int row = 0; row < rowCount; ++row)
+        {
+            auto const index = std::to_string(row);
+            html += "<div class='row'><div class='label'>Counter " + index + "</div>";
+            html += "<div class='value' id='v" + index + "'>0</div></div>";
+        }
+        html += "</body></html>";
+        return html;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    GumboNode * FindById(GumboNode * node, char const * id)
+    {
+        if (node->type != GUMBO_NODE_ELEMENT)
+        {
+            return nullptr;
+        }
+        auto const * attribute = gumbo_get_attribute(&node->v.element.attributes, "id");
+        if (attribute != nullptr && std::strcmp(attribute->value, id) == 0)
+        {
+            return node;
+        }
+        auto const & children = node->v.element.children;
+        for (unsigned int i = 0; i < children.length; ++i)
+        {
+            if (auto * result = FindById(static_cast<GumboNode *>(children.data[i]), id); result != nullptr)
+            {
+                return result;
+            }
+        }
+        return nullptr;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Same as WebViewContainer::SetText
+    void SetText(GumboNode * node, char const * text)
+    {
+        auto const & children = node->v.element.children;
+        for (unsigned int i = 0; i < children.length; ++i)
+        {
+            auto * child = static_cast<GumboNode *>(children.data[i]);
+            if (child->type == GUMBO_NODE_TEXT)
+            {
+                std::free(const_cast<char *>(child->v.text.text));
+                child->v.text.text = strdup(text);
+                return;
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    struct FrameCost
+    {
+        double fullMs = 0.0;
+        double relayoutMs = 0.0;
+        double drawMs = 0.0;
+        double emitMs = 0.0;
+        double treeDrawMs = 0.0;
+        // Frames whose draw was limited to the laid out boxes
+        int partialCount = 0;
+    };
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Average over frameCount frames that each change mutatedCount random counters
+    FrameCost MeasureFrames(
+        Page const & page,
+        int const rowCount,
+        int const mutatedCount,
+        int const frameCount
+    )
+    {
+        auto * output = litehtml::document::parse_html(CreateHtml(page, rowCount));
+        std::vector<GumboNode *> values{};
+        for (int row = 0; row < rowCount; ++row)
+        {
+            values.emplace_back(FindById(output->root, ("v" + std::to_string(row)).c_str()));
+        }
+
+        HeadlessContainer container{};
+        auto document = std::make_shared<litehtml::document>(&container);
+        document->update_output(output);
+        document->render(ClientWidth);
+        container.Draw(*document);
+        container.Emit();
+
+        // The rebuilt documents draw into their own cache, So the one of the in place document stays intact
+        HeadlessContainer rebuiltContainer{};
+
+        std::mt19937 random{Seed};
+        std::vector<GumboNode *> dirtyNodes{};
+        FrameCost cost{};
+        for (int frame = 0; frame < frameCount; ++frame)
+        {
+            dirtyNodes.clear();
+            for (int i = 0; i < mutatedCount; ++i)
+            {
+                auto * node = values[random() % values.size()];
+                SetText(node, std::to_string(random() % 1000).c_str());
+                dirtyNodes.emplace_back(node);
+            }
+
+            cost.fullMs += Benchmark::MeasureMs(1, [&]()->void
+            {
+                auto const rebuilt = std::make_shared<litehtml::document>(&rebuiltContainer);
+                rebuilt->update_output(output);
+                rebuilt->render(ClientWidth);
+                rebuiltContainer.Draw(*rebuilt);
+                rebuiltContainer.Emit();
+            });
+            cost.relayoutMs += Benchmark::MeasureMs(1, [&]()->void
+            {
+                for (auto * node : dirtyNodes)
+                {
+                    if (document->update_node(node) == false)
+                    {
+                        std::abort();
+                    }
+                }
+                document->render_dirty(ClientWidth);
+            });
+            bool isPartial = false;
+            cost.drawMs += Benchmark::MeasureMs(1, [&]()->void
+            {
+                isPartial = container.DrawDirty(*document);
+            });
+            cost.emitMs += Benchmark::MeasureMs(1, [&]()->void
+            {
+                container.Emit();
+            });
+            cost.partialCount += isPartial ? 1 : 0;
+
+            // The draw of the whole tree has to give the same display list as the in place frame
+            auto const inPlaceList = container.GetDisplayList();
+            cost.treeDrawMs += Benchmark::MeasureMs(1, [&]()->void
+            {
+                container.Draw(*document);
+            });
+            container.Emit();
+            if (IsSame(inPlaceList, container.GetDisplayList()) == false)
+            {
+                std::fprintf(stderr, "Frame %d of %s differs from a draw of the whole tree\n", frame, page.name);
+                std::abort();
+            }
+        }
+        Benchmark::Consume(container.GetDisplayList().GetStats());
+
+        document.reset();
+        litehtml::document::destroy_output(output);
+
+        cost.fullMs /= frameCount;
+        cost.relayoutMs /= frameCount;
+        cost.drawMs /= frameCount;
+        cost.emitMs /= frameCount;
+        cost.treeDrawMs /= frameCount;
+        return cost;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main(int argc, char ** argv)
+{
+    bool const isQuick = Benchmark::IsQuick(argc, argv);
+    std::vector<int> const rowCounts = isQuick ? std::vector<int>{50} : std::vector<int>{100, 1000};
+    std::vector<int> const mutatedCounts = isQuick ? std::vector<int>{1, 16} : std::vector<int>{1, 4, 16, 64, 256};
+    int const frameCount = isQuick ? 2 : 20;
+
+    std::printf(
+        "ms per frame, In place is the relayout, the draw of the laid out boxes and the emit of the display list\n"
+    );
+    std::printf(
+        "%6s %12s %8s %10s %10s %10s %10s %10s %10s %9s %8s\n",
+        "rows", "page", "mutated", "full", "relayout", "draw", "emit", "in place", "tree draw", "speedup", "partial"
+    );
+    for (auto const rowCount : rowCounts)
+    {
+        for (auto const & page : Pages)
+        {
+            for (auto const mutatedCount : mutatedCounts)
+            {
+                if (mutatedCount > rowCount)
+                {
+                    continue;
+                }
+                auto const cost = MeasureFrames(page, rowCount, mutatedCount, frameCount);
+                double const inPlaceMs = cost.relayoutMs + cost.drawMs + cost.emitMs;
+                std::printf(
+                    "%6d %12s %8d %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f %8.2fx %4d/%-3d\n",
+                    rowCount,
+                    page.name,
+                    mutatedCount,
+                    cost.fullMs,
+                    cost.relayoutMs,
+                    cost.drawMs,
+                    cost.emitMs,
+                    inPlaceMs,
+                    cost.treeDrawMs,
+                    cost.fullMs / inPlaceMs,
+                    cost.partialCount,
+                    frameCount
+                );
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,716 @@
+#include "AssetGLTF_Animation.hpp"
+
+#include "BedrockAssert.hpp"
+#include "BedrockLog.hpp"
+#include "JobSystem.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MFA_ANIMATION_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace MFA::Asset::GLTF
+{
+
+    //-------------------------------------------------------------------------------------------------
+
+    namespace
+    {
+        // Instances per job, Each one is a few microseconds of work for a typical rig
+        constexpr int InstanceGrainSize = 16;
+        constexpr int VertexGrainSize = 4096;
+
+        glm::quat ToQuaternion(glm::vec4 const & value)
+        {
+            return glm::quat{value.w, value.x, value.y, value.z};
+        }
+
+        // Normalized lerp along the shorter arc, For blending whole poses where the weight changes slowly over time
+        glm::quat BlendRotation(glm::quat const & from, glm::quat to, float const weight)
+        {
+            if (glm::dot(from, to) < 0.0f)
+            {
+                to = -to;
+            }
+            return glm::normalize(glm::quat{
+                from.w + (to.w - from.w) * weight,
+                from.x + (to.x - from.x) * weight,
+                from.y + (to.y - from.y) * weight,
+                from.z + (to.z - from.z) * weight
+            });
+        }
+
+        // Translation * Rotation * Scale, Without the general matrix products
+        glm::mat4 ComposeTransform(glm::vec3 const & translation, glm::quat const & rotation, glm::vec3 const & scale)
+        {
+            glm::mat4 result = glm::mat4_cast(rotation);
+            result[0] *= scale.x;
+            result[1] *= scale.y;
+            result[2] *= scale.z;
+            result[3] = glm::vec4{translation, 1.0f};
+            return result;
+        }
+
+        glm::mat4 Multiply(glm::mat4 const & lhs, glm::mat4 const & rhs)
+        {
+#ifdef MFA_ANIMATION_SSE2
+            __m128 const column0 = _mm_loadu_ps(&lhs[0][0]);
+            __m128 const column1 = _mm_loadu_ps(&lhs[1][0]);
+            __m128 const column2 = _mm_loadu_ps(&lhs[2][0]);
+            __m128 const column3 = _mm_loadu_ps(&lhs[3][0]);
+            glm::mat4 result;
+            for (int column = 0; column < 4; ++column)
+            {
+                __m128 sum = _mm_mul_ps(column0, _mm_set1_ps(rhs[column][0]));
+                sum = _mm_add_ps(sum, _mm_mul_ps(column1, _mm_set1_ps(rhs[column][1])));
+                sum = _mm_add_ps(sum, _mm_mul_ps(column2, _mm_set1_ps(rhs[column][2])));
+                sum = _mm_add_ps(sum, _mm_mul_ps(column3, _mm_set1_ps(rhs[column][3])));
+                _mm_storeu_ps(&result[column][0], sum);
+            }
+            return result;
+#else
+            return lhs * rhs;
+#endif
+        }
+
+        void SkinRange(
+            glm::mat4 const * palette,
+            uint32_t const jointCount,
+            Vertex const * vertices,
+            uint32_t const begin,
+            uint32_t const end,
+            glm::vec3 * outPositions,
+            glm::vec3 * outNormals
+        )
+        {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                auto const & vertex = vertices[i];
+                if (vertex.hasSkin == 0)
+                {
+                    outPositions[i] = vertex.position;
+                    if (outNormals != nullptr)
+                    {
+                        outNormals[i] = vertex.normal;
+                    }
+                    continue;
+                }
+
+#ifdef MFA_ANIMATION_SSE2
+                // Columns of the weighted sum of the four joint matrices
+                __m128 columns[4] {_mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps()};
+                for (int influence = 0; influence < 4; ++influence)
+                {
+                    float const weight = vertex.jointWeights[influence];
+                    auto const jointIndex = static_cast<uint32_t>(vertex.jointIndices[influence]);
+                    if (weight == 0.0f || jointIndex >= jointCount)
+                    {
+                        continue;
+                    }
+                    auto const & joint = palette[jointIndex];
+                    __m128 const weights = _mm_set1_ps(weight);
+                    for (int column = 0; column < 4; ++column)
+                    {
+                        columns[column] = _mm_add_ps(columns[column], _mm_mul_ps(_mm_loadu_ps(&joint[column][0]), weights));
+                    }
+                }
+
+                __m128 position = _mm_add_ps(
+                    _mm_add_ps(
+                        _mm_mul_ps(columns[0], _mm_set1_ps(vertex.position.x)),
+                        _mm_mul_ps(columns[1], _mm_set1_ps(vertex.position.y))
+                    ),
+                    _mm_add_ps(_mm_mul_ps(columns[2], _mm_set1_ps(vertex.position.z)), columns[3])
+                );
+                alignas(16) float result[4];
+                _mm_store_ps(result, position);
+                outPositions[i] = glm::vec3{result[0], result[1], result[2]};
+
+                if (outNormals != nullptr)
+                {
+                    __m128 const normal = _mm_add_ps(
+                        _mm_add_ps(
+                            _mm_mul_ps(columns[0], _mm_set1_ps(vertex.normal.x)),
+                            _mm_mul_ps(columns[1], _mm_set1_ps(vertex.normal.y))
+                        ),
+                        _mm_mul_ps(columns[2], _mm_set1_ps(vertex.normal.z))
+                    );
+                    _mm_store_ps(result, normal);
+                    outNormals[i] = glm::vec3{result[0], result[1], result[2]};
+                }
+#else
+                glm::mat4 skin {0.0f};
+                for (int influence = 0; influence < 4; ++influence)
+                {
+                    float const weight = vertex.jointWeights[influence];
+                    auto const jointIndex = static_cast<uint32_t>(vertex.jointIndices[influence]);
+                    if (weight != 0.0f && jointIndex < jointCount)
+                    {
+                        skin += palette[jointIndex] * weight;
+                    }
+                }
+                outPositions[i] = glm::vec3{skin * glm::vec4{vertex.position, 1.0f}};
+                if (outNormals != nullptr)
+                {
+                    outNormals[i] = glm::vec3{skin * glm::vec4{vertex.normal, 0.0f}};
+                }
+#endif
+
+                if (outNormals != nullptr)
+                {
+                    float const length2 = glm::dot(outNormals[i], outNormals[i]);
+                    if (length2 > 0.0f)
+                    {
+                        outNormals[i] /= std::sqrt(length2);
+                    }
+                }
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    AnimationClip::AnimationClip(Animation const & animation, uint32_t const nodeCount)
+        : mName(animation.name)
+        , mStartTime(std::max(animation.startTime, 0.0f))
+        , mDuration(std::max(animation.endTime - animation.startTime, 0.0f))
+    {
+        mTracks.reserve(animation.channels.size());
+        for (auto const & channel : animation.channels)
+        {
+            if (channel.path == Animation::Path::Invalid)
+            {
+                continue;
+            }
+            if (channel.nodeIndex >= nodeCount || channel.samplerIndex >= animation.samplers.size())
+            {
+                MFA_LOG_WARN(
+                    "Animation %s has a channel with node %u and sampler %u that do not exist, It is ignored",
+                    mName.c_str(),
+                    channel.nodeIndex,
+                    channel.samplerIndex
+                );
+                continue;
+            }
+            auto const & sampler = animation.samplers[channel.samplerIndex];
+            if (sampler.inputAndOutput.empty() == true)
+            {
+                continue;
+            }
+
+            Track track {
+                .path = channel.path,
+                .interpolation = sampler.interpolation,
+                .nodeIndex = channel.nodeIndex,
+                .firstKey = static_cast<uint32_t>(mTimes.size()),
+                .keyCount = static_cast<uint32_t>(sampler.inputAndOutput.size()),
+                .firstTangent = static_cast<uint32_t>(mTangents.size()),
+            };
+            if (track.interpolation == Animation::Interpolation::Invalid)
+            {
+                track.interpolation = Animation::Interpolation::Linear;
+            }
+            mTracks.emplace_back(track);
+
+            for (auto const & key : sampler.inputAndOutput)
+            {
+                mTimes.emplace_back(key.input);
+                mValues.emplace_back(key.output[0], key.output[1], key.output[2], key.output[3]);
+                if (track.interpolation == Animation::Interpolation::CubicSpline)
+                {
+                    mTangents.emplace_back(key.inTangent[0], key.inTangent[1], key.inTangent[2], key.inTangent[3]);
+                    mTangents.emplace_back(key.outTangent[0], key.outTangent[1], key.outTangent[2], key.outTangent[3]);
+                }
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    glm::vec4 AnimationClip::Sample(uint32_t const trackIndex, float const time, uint32_t & cursor) const
+    {
+        MFA_ASSERT(trackIndex < mTracks.size());
+        auto const & track = mTracks[trackIndex];
+        float const * times = mTimes.data() + track.firstKey;
+        glm::vec4 const * values = mValues.data() + track.firstKey;
+        uint32_t const lastKey = track.keyCount - 1;
+
+        if (lastKey == 0 || time <= times[0])
+        {
+            cursor = 0;
+            return values[0];
+        }
+        if (time >= times[lastKey])
+        {
+            cursor = lastKey - 1;
+            return values[lastKey];
+        }
+
+        if (cursor >= lastKey || time < times[cursor])
+        {
+            cursor = 0;
+        }
+        while (time >= times[cursor + 1])
+        {
+            ++cursor;
+        }
+
+        if (track.interpolation == Animation::Interpolation::Step)
+        {
+            return values[cursor];
+        }
+
+        float const keyDuration = times[cursor + 1] - times[cursor];
+        float const weight = (time - times[cursor]) / keyDuration;
+        if (track.interpolation == Animation::Interpolation::CubicSpline)
+        {
+            // Out tangent of this key and in tangent of the next one, Both scaled from per second to the key duration
+            glm::vec4 const * tangents = mTangents.data() + track.firstTangent;
+            float const weight2 = weight * weight;
+            float const weight3 = weight2 * weight;
+            glm::vec4 const value =
+                (2.0f * weight3 - 3.0f * weight2 + 1.0f) * values[cursor] +
+                (weight3 - 2.0f * weight2 + weight) * keyDuration * tangents[cursor * 2 + 1] +
+                (-2.0f * weight3 + 3.0f * weight2) * values[cursor + 1] +
+                (weight3 - weight2) * keyDuration * tangents[(cursor + 1) * 2];
+            return track.path == Animation::Path::Rotation ? glm::normalize(value) : value;
+        }
+        if (track.path == Animation::Path::Rotation)
+        {
+            auto const rotation = glm::slerp(ToQuaternion(values[cursor]), ToQuaternion(values[cursor + 1]), weight);
+            return glm::vec4{rotation.x, rotation.y, rotation.z, rotation.w};
+        }
+        return glm::mix(values[cursor], values[cursor + 1], weight);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::string const & AnimationClip::GetName() const noexcept
+    {
+        return mName;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    float AnimationClip::GetStartTime() const noexcept
+    {
+        return mStartTime;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    float AnimationClip::GetDuration() const noexcept
+    {
+        return mDuration;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::vector<AnimationClip::Track> const & AnimationClip::GetTracks() const noexcept
+    {
+        return mTracks;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    AnimationBatch::AnimationBatch(std::shared_ptr<MeshData> meshData)
+        : mMeshData(std::move(meshData))
+    {
+        MFA_ASSERT(mMeshData != nullptr);
+        auto const & nodes = mMeshData->nodes;
+        mNodeCount = static_cast<uint32_t>(nodes.size());
+
+        mParents.resize(mNodeCount);
+        mRestPose.translations.resize(mNodeCount);
+        mRestPose.rotations.resize(mNodeCount);
+        mRestPose.scales.resize(mNodeCount);
+        mExtraTransforms.resize(mNodeCount);
+        mHasExtraTransform.resize(mNodeCount);
+        for (uint32_t i = 0; i < mNodeCount; ++i)
+        {
+            auto const & transform = nodes[i].transform;
+            mParents[i] = -1;
+            mRestPose.translations[i] = transform.GetLocalPosition();
+            mRestPose.rotations[i] = transform.GetLocalRotation().GetQuaternion();
+            mRestPose.scales[i] = transform.GetLocalScale();
+            mExtraTransforms[i] = transform.GetLocalExtraTransform();
+            mHasExtraTransform[i] = mExtraTransforms[i] != glm::identity<glm::mat4>();
+        }
+
+        // Breadth first from the roots, So every parent is done before its children. The parents come from the
+        // children lists, Children that do not exist or that were already reached are skipped, And nodes that no root
+        // reaches become roots themselves.
+        std::vector<bool> isReached(mNodeCount, false);
+        mNodeOrder.reserve(mNodeCount);
+        for (uint32_t i = 0; i < mNodeCount; ++i)
+        {
+            if (nodes[i].parent < 0)
+            {
+                mNodeOrder.emplace_back(i);
+                isReached[i] = true;
+            }
+        }
+        uint32_t nextRoot = 0;
+        for (size_t i = 0; mNodeOrder.size() < mNodeCount; ++i)
+        {
+            if (i == mNodeOrder.size())
+            {
+                while (isReached[nextRoot] == true)
+                {
+                    ++nextRoot;
+                }
+                MFA_LOG_WARN("Node %u is not reachable from any root, It is animated as a root", nextRoot);
+                mNodeOrder.emplace_back(nextRoot);
+                isReached[nextRoot] = true;
+            }
+            uint32_t const node = mNodeOrder[i];
+            for (int const child : nodes[node].children)
+            {
+                if (child < 0 || static_cast<uint32_t>(child) >= mNodeCount || isReached[child] == true)
+                {
+                    MFA_LOG_WARN("Node %u has an invalid child %d, It is ignored", node, child);
+                    continue;
+                }
+                mParents[child] = static_cast<int>(node);
+                mNodeOrder.emplace_back(static_cast<uint32_t>(child));
+                isReached[child] = true;
+            }
+        }
+
+        // Joints that do not exist keep an identity matrix, Missing inverse bind matrices are identities like GLTF says
+        mSkinOffsets.reserve(mMeshData->skins.size());
+        for (size_t skinIndex = 0; skinIndex < mMeshData->skins.size(); ++skinIndex)
+        {
+            auto const & skin = mMeshData->skins[skinIndex];
+            if (skin.inverseBindMatrices.empty() == false && skin.inverseBindMatrices.size() != skin.joints.size())
+            {
+                MFA_LOG_WARN(
+                    "Skin %zu has %zu joints and %zu inverse bind matrices",
+                    skinIndex,
+                    skin.joints.size(),
+                    skin.inverseBindMatrices.size()
+                );
+            }
+            mSkinOffsets.emplace_back(mJointCount);
+            mJointCount += static_cast<uint32_t>(skin.joints.size());
+            for (size_t joint = 0; joint < skin.joints.size(); ++joint)
+            {
+                int node = skin.joints[joint];
+                if (node < 0 || static_cast<uint32_t>(node) >= mNodeCount)
+                {
+                    MFA_LOG_WARN("Joint %zu of skin %zu points to node %d that does not exist", joint, skinIndex, node);
+                    node = -1;
+                }
+                mJointNodes.emplace_back(node);
+                mInverseBindMatrices.emplace_back(
+                    joint < skin.inverseBindMatrices.size() ? skin.inverseBindMatrices[joint] : glm::identity<glm::mat4>()
+                );
+            }
+        }
+
+        mClips.reserve(mMeshData->animations.size());
+        for (auto const & animation : mMeshData->animations)
+        {
+            auto const & clip = mClips.emplace_back(animation, mNodeCount);
+            mMaxTrackCount = std::max(mMaxTrackCount, static_cast<uint32_t>(clip.GetTracks().size()));
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    AnimationBatch::~AnimationBatch() = default;
+
+    //-------------------------------------------------------------------------------------------------
+
+    uint32_t AnimationBatch::AddInstance()
+    {
+        uint32_t const instance = mInstanceCount++;
+
+        mLayers.resize(static_cast<size_t>(mInstanceCount) * MaxLayerCount);
+        mCursors.resize(static_cast<size_t>(mInstanceCount) * MaxLayerCount * mMaxTrackCount);
+
+        mPoses.translations.insert(mPoses.translations.end(), mRestPose.translations.begin(), mRestPose.translations.end());
+        mPoses.rotations.insert(mPoses.rotations.end(), mRestPose.rotations.begin(), mRestPose.rotations.end());
+        mPoses.scales.insert(mPoses.scales.end(), mRestPose.scales.begin(), mRestPose.scales.end());
+        mNodeTransforms.resize(static_cast<size_t>(mInstanceCount) * mNodeCount);
+        mPalettes.resize(static_cast<size_t>(mInstanceCount) * mJointCount);
+
+        Pose scratch{};
+        UpdateInstance(instance, scratch);
+        return instance;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void AnimationBatch::SetLayer(uint32_t const instance, uint32_t const layerIndex, Layer const & layer)
+    {
+        MFA_ASSERT(instance < mInstanceCount);
+        MFA_ASSERT(layerIndex < MaxLayerCount);
+        MFA_ASSERT(layer.clipIndex < static_cast<int>(mClips.size()));
+        auto & current = mLayers[static_cast<size_t>(instance) * MaxLayerCount + layerIndex];
+        if (current.clipIndex != layer.clipIndex)
+        {
+            ResetCursors(instance, layerIndex);
+        }
+        current = layer;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    AnimationBatch::Layer const & AnimationBatch::GetLayer(uint32_t const instance, uint32_t const layerIndex) const
+    {
+        MFA_ASSERT(instance < mInstanceCount);
+        MFA_ASSERT(layerIndex < MaxLayerCount);
+        return mLayers[static_cast<size_t>(instance) * MaxLayerCount + layerIndex];
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void AnimationBatch::Update(float const deltaTime)
+    {
+        JobSystem::ParallelFor(
+            static_cast<int>(mInstanceCount),
+            InstanceGrainSize,
+            [this, deltaTime](int const begin, int const end)->void
+            {
+                Pose blendPose{};
+                for (int instance = begin; instance < end; ++instance)
+                {
+                    for (uint32_t layerIndex = 0; layerIndex < MaxLayerCount; ++layerIndex)
+                    {
+                        auto & layer = mLayers[static_cast<size_t>(instance) * MaxLayerCount + layerIndex];
+                        if (layer.clipIndex < 0)
+                        {
+                            continue;
+                        }
+                        float const duration = mClips[layer.clipIndex].GetDuration();
+                        layer.time += deltaTime * layer.speed;
+                        if (layer.loop == true && duration > 0.0f)
+                        {
+                            layer.time = std::fmod(layer.time, duration);
+                            if (layer.time < 0.0f)
+                            {
+                                layer.time += duration;
+                            }
+                        }
+                        else
+                        {
+                            layer.time = std::clamp(layer.time, 0.0f, duration);
+                        }
+                    }
+                    UpdateInstance(static_cast<uint32_t>(instance), blendPose);
+                }
+            }
+        );
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    glm::mat4 const * AnimationBatch::GetNodeTransforms(uint32_t const instance) const
+    {
+        MFA_ASSERT(instance < mInstanceCount);
+        return mNodeTransforms.data() + static_cast<size_t>(instance) * mNodeCount;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    glm::mat4 const * AnimationBatch::GetJointPalette(uint32_t const instance, uint32_t const skinIndex) const
+    {
+        MFA_ASSERT(instance < mInstanceCount);
+        MFA_ASSERT(skinIndex < mSkinOffsets.size());
+        return mPalettes.data() + static_cast<size_t>(instance) * mJointCount + mSkinOffsets[skinIndex];
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void AnimationBatch::SkinVertices(
+        uint32_t const instance,
+        uint32_t const skinIndex,
+        Vertex const * vertices,
+        uint32_t const vertexCount,
+        glm::vec3 * outPositions,
+        glm::vec3 * outNormals
+    ) const
+    {
+        SkinVertices(
+            GetJointPalette(instance, skinIndex),
+            static_cast<uint32_t>(mMeshData->skins[skinIndex].joints.size()),
+            vertices,
+            vertexCount,
+            outPositions,
+            outNormals
+        );
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void AnimationBatch::SkinVertices(
+        glm::mat4 const * palette,
+        uint32_t const jointCount,
+        Vertex const * vertices,
+        uint32_t const vertexCount,
+        glm::vec3 * outPositions,
+        glm::vec3 * outNormals
+    )
+    {
+        MFA_ASSERT(vertices != nullptr || vertexCount == 0);
+        MFA_ASSERT(outPositions != nullptr || vertexCount == 0);
+        JobSystem::ParallelFor(
+            static_cast<int>(vertexCount),
+            VertexGrainSize,
+            [&](int const begin, int const end)->void
+            {
+                SkinRange(
+                    palette,
+                    jointCount,
+                    vertices,
+                    static_cast<uint32_t>(begin),
+                    static_cast<uint32_t>(end),
+                    outPositions,
+                    outNormals
+                );
+            }
+        );
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    int AnimationBatch::FindClip(std::string const & name) const
+    {
+        for (size_t i = 0; i < mClips.size(); ++i)
+        {
+            if (mClips[i].GetName() == name)
+            {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::vector<AnimationClip> const & AnimationBatch::GetClips() const noexcept
+    {
+        return mClips;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    uint32_t AnimationBatch::GetInstanceCount() const noexcept
+    {
+        return mInstanceCount;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    uint32_t AnimationBatch::GetJointCount() const noexcept
+    {
+        return mJointCount;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void AnimationBatch::ResetCursors(uint32_t const instance, uint32_t const layerIndex)
+    {
+        auto const begin = mCursors.begin() +
+            static_cast<ptrdiff_t>((static_cast<size_t>(instance) * MaxLayerCount + layerIndex) * mMaxTrackCount);
+        std::fill(begin, begin + mMaxTrackCount, 0u);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void AnimationBatch::SampleLayer(uint32_t const instance, uint32_t const layerIndex, Pose & pose, size_t const poseOffset)
+    {
+        auto const & layer = mLayers[static_cast<size_t>(instance) * MaxLayerCount + layerIndex];
+        auto const & clip = mClips[layer.clipIndex];
+        auto const & tracks = clip.GetTracks();
+        uint32_t * cursors = mCursors.data() + (static_cast<size_t>(instance) * MaxLayerCount + layerIndex) * mMaxTrackCount;
+        float const time = clip.GetStartTime() + layer.time;
+
+        for (uint32_t trackIndex = 0; trackIndex < tracks.size(); ++trackIndex)
+        {
+            auto const & track = tracks[trackIndex];
+            MFA_ASSERT(track.nodeIndex < mNodeCount);
+            auto const value = clip.Sample(trackIndex, time, cursors[trackIndex]);
+            size_t const node = poseOffset + track.nodeIndex;
+            switch (track.path)
+            {
+            case Animation::Path::Translation:
+                pose.translations[node] = glm::vec3{value};
+                break;
+            case Animation::Path::Rotation:
+                pose.rotations[node] = ToQuaternion(value);
+                break;
+            case Animation::Path::Scale:
+                pose.scales[node] = glm::vec3{value};
+                break;
+            case Animation::Path::Invalid:
+                break;
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void AnimationBatch::UpdateInstance(uint32_t const instance, Pose & blendPose)
+    {
+        size_t const poseOffset = static_cast<size_t>(instance) * mNodeCount;
+        auto const * layers = mLayers.data() + static_cast<size_t>(instance) * MaxLayerCount;
+
+        std::copy(mRestPose.translations.begin(), mRestPose.translations.end(), mPoses.translations.begin() + poseOffset);
+        std::copy(mRestPose.rotations.begin(), mRestPose.rotations.end(), mPoses.rotations.begin() + poseOffset);
+        std::copy(mRestPose.scales.begin(), mRestPose.scales.end(), mPoses.scales.begin() + poseOffset);
+        if (layers[0].clipIndex >= 0)
+        {
+            SampleLayer(instance, 0, mPoses, poseOffset);
+        }
+
+        for (uint32_t layerIndex = 1; layerIndex < MaxLayerCount; ++layerIndex)
+        {
+            auto const & layer = layers[layerIndex];
+            float const weight = std::clamp(layer.weight, 0.0f, 1.0f);
+            if (layer.clipIndex < 0 || weight <= 0.0f)
+            {
+                continue;
+            }
+            blendPose.translations = mRestPose.translations;
+            blendPose.rotations = mRestPose.rotations;
+            blendPose.scales = mRestPose.scales;
+            SampleLayer(instance, layerIndex, blendPose, 0);
+            for (uint32_t node = 0; node < mNodeCount; ++node)
+            {
+                size_t const index = poseOffset + node;
+                mPoses.translations[index] = glm::mix(mPoses.translations[index], blendPose.translations[node], weight);
+                mPoses.rotations[index] = BlendRotation(mPoses.rotations[index], blendPose.rotations[node], weight);
+                mPoses.scales[index] = glm::mix(mPoses.scales[index], blendPose.scales[node], weight);
+            }
+        }
+
+        auto * transforms = mNodeTransforms.data() + poseOffset;
+        for (uint32_t const node : mNodeOrder)
+        {
+            size_t const index = poseOffset + node;
+            glm::mat4 local = ComposeTransform(mPoses.translations[index], mPoses.rotations[index], mPoses.scales[index]);
+            if (mHasExtraTransform[node] == true)
+            {
+                local = Multiply(mExtraTransforms[node], local);
+            }
+            transforms[node] = mParents[node] >= 0 ? Multiply(transforms[mParents[node]], local) : local;
+        }
+
+        auto * palette = mPalettes.data() + static_cast<size_t>(instance) * mJointCount;
+        for (uint32_t joint = 0; joint < mJointCount; ++joint)
+        {
+            int const node = mJointNodes[joint];
+            palette[joint] = node >= 0
+                ? Multiply(transforms[node], mInverseBindMatrices[joint])
+                : glm::identity<glm::mat4>();
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
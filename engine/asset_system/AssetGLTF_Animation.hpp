@@ -0,0 +1,193 @@
+#pragma once
+
+#include "AssetGLTF_Mesh.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace MFA::Asset::GLTF
+{
+
+    // Keyframes of an Animation, One track per channel. Key times and key values of all tracks are kept in two flat
+    // arrays, So a search over the times of a track never touches the values.
+    class AnimationClip final
+    {
+    public:
+
+        struct Track
+        {
+            Animation::Path path = Animation::Path::Invalid;
+            Animation::Interpolation interpolation = Animation::Interpolation::Linear;
+            uint32_t nodeIndex = 0;
+            uint32_t firstKey = 0;
+            uint32_t keyCount = 0;
+            // In and out tangent of every key, Only for cubic spline tracks
+            uint32_t firstTangent = 0;
+        };
+
+        // Channels whose node is not below nodeCount or whose sampler does not exist are dropped with a warning,
+        // So every track can be applied without checks
+        explicit AnimationClip(Animation const & animation, uint32_t nodeCount);
+
+        // Value of the track at time (Clamped to its keys). Cursor is the key that the last call for this track ended
+        // on, It moves forward from there and only goes back to the first key when the time does.
+        // Rotations are quaternions in x, y, z, w order like GLTF stores them. Cubic spline tracks follow the Hermite
+        // spline of the GLTF spec, Rotations are normalized after it.
+        [[nodiscard]]
+        glm::vec4 Sample(uint32_t trackIndex, float time, uint32_t & cursor) const;
+
+        [[nodiscard]]
+        std::string const & GetName() const noexcept;
+
+        [[nodiscard]]
+        float GetStartTime() const noexcept;
+
+        [[nodiscard]]
+        float GetDuration() const noexcept;
+
+        [[nodiscard]]
+        std::vector<Track> const & GetTracks() const noexcept;
+
+    private:
+
+        std::string mName{};
+        float mStartTime = 0.0f;
+        float mDuration = 0.0f;
+
+        std::vector<Track> mTracks{};
+        std::vector<float> mTimes{};
+        std::vector<glm::vec4> mValues{};
+        std::vector<glm::vec4> mTangents{};
+    };
+
+    // Plays the clips of a mesh on many instances at once. Every instance has its own layers and keyframe cursors.
+    // Update advances the layers, Samples and blends them into local poses, Then computes the node transforms and the
+    // joint palette of every skin. Instances are processed in parallel over the JobSystem.
+    class AnimationBatch final
+    {
+    public:
+
+        static constexpr uint32_t MaxLayerCount = 2;
+
+        struct Layer
+        {
+            // -1 keeps the rest pose
+            int clipIndex = -1;
+            // Seconds from the start of the clip
+            float time = 0.0f;
+            float speed = 1.0f;
+            // Layers above the first one are blended over the layers below them by this weight
+            float weight = 1.0f;
+            bool loop = true;
+        };
+
+        explicit AnimationBatch(std::shared_ptr<MeshData> meshData);
+
+        ~AnimationBatch();
+
+        AnimationBatch(AnimationBatch const &) noexcept = delete;
+        AnimationBatch(AnimationBatch &&) noexcept = delete;
+        AnimationBatch & operator= (AnimationBatch const & rhs) noexcept = delete;
+        AnimationBatch & operator= (AnimationBatch && rhs) noexcept = delete;
+
+        // Returns the instance index, New instances start in the rest pose
+        uint32_t AddInstance();
+
+        void SetLayer(uint32_t instance, uint32_t layerIndex, Layer const & layer);
+
+        [[nodiscard]]
+        Layer const & GetLayer(uint32_t instance, uint32_t layerIndex) const;
+
+        void Update(float deltaTime);
+
+        // Model space transform of every node, In the order of MeshData::nodes
+        [[nodiscard]]
+        glm::mat4 const * GetNodeTransforms(uint32_t instance) const;
+
+        // Model space joint matrices of the skin, In the order of Skin::joints
+        [[nodiscard]]
+        glm::mat4 const * GetJointPalette(uint32_t instance, uint32_t skinIndex) const;
+
+        // Linear blend skinning on the cpu with the palette of the skin. Vertices without a skin are copied.
+        // Influences of joints outside of the palette are ignored. Normals are optional.
+        void SkinVertices(
+            uint32_t instance,
+            uint32_t skinIndex,
+            Vertex const * vertices,
+            uint32_t vertexCount,
+            glm::vec3 * outPositions,
+            glm::vec3 * outNormals = nullptr
+        ) const;
+
+        static void SkinVertices(
+            glm::mat4 const * palette,
+            uint32_t jointCount,
+            Vertex const * vertices,
+            uint32_t vertexCount,
+            glm::vec3 * outPositions,
+            glm::vec3 * outNormals = nullptr
+        );
+
+        // -1 when there is no clip with this name
+        [[nodiscard]]
+        int FindClip(std::string const & name) const;
+
+        [[nodiscard]]
+        std::vector<AnimationClip> const & GetClips() const noexcept;
+
+        [[nodiscard]]
+        uint32_t GetInstanceCount() const noexcept;
+
+        [[nodiscard]]
+        uint32_t GetJointCount() const noexcept;
+
+    private:
+
+        struct Pose
+        {
+            std::vector<glm::vec3> translations{};
+            std::vector<glm::quat> rotations{};
+            std::vector<glm::vec3> scales{};
+        };
+
+        void ResetCursors(uint32_t instance, uint32_t layerIndex);
+
+        void SampleLayer(uint32_t instance, uint32_t layerIndex, Pose & pose, size_t poseOffset);
+
+        void UpdateInstance(uint32_t instance, Pose & blendPose);
+
+        std::shared_ptr<MeshData> mMeshData{};
+        std::vector<AnimationClip> mClips{};
+
+        uint32_t mNodeCount = 0;
+        // Parents come before their children
+        std::vector<uint32_t> mNodeOrder{};
+        std::vector<int> mParents{};
+        Pose mRestPose{};
+        // Only for the nodes that had a matrix in the file, Animations do not touch it
+        std::vector<glm::mat4> mExtraTransforms{};
+        std::vector<bool> mHasExtraTransform{};
+
+        // First palette entry of every skin
+        std::vector<uint32_t> mSkinOffsets{};
+        // Node and inverse bind matrix of every palette entry, -1 for joints that point to a node that does not exist
+        std::vector<int> mJointNodes{};
+        std::vector<glm::mat4> mInverseBindMatrices{};
+        uint32_t mJointCount = 0;
+        uint32_t mMaxTrackCount = 0;
+
+        uint32_t mInstanceCount = 0;
+        // Everything below has one block per instance
+        std::vector<Layer> mLayers{};
+        std::vector<uint32_t> mCursors{};
+        Pose mPoses{};
+        std::vector<glm::mat4> mNodeTransforms{};
+        std::vector<glm::mat4> mPalettes{};
+    };
+
+}
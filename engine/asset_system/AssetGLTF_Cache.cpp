@@ -0,0 +1,719 @@
+#include "AssetGLTF_Cache.hpp"
+
+#include "AssetGLTF_PackedVertex.hpp"
+#include "BedrockAssert.hpp"
+#include "BedrockFile.hpp"
+#include "BedrockLog.hpp"
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+
+namespace MFA::Asset::GLTF::Cache
+{
+
+    //-------------------------------------------------------------------------------------------------
+
+    namespace
+    {
+        constexpr uint32_t Magic = 0x4341464D;              // "MFAC"
+        constexpr uint64_t SectionAlignment = 16;
+
+        enum class SectionType : uint32_t
+        {
+            Vertices,
+            Indices,
+            SubMeshes,
+            Primitives,
+            Nodes,
+            Skins,
+            Animations,
+            Samplers,
+            Keyframes,
+            Channels,
+            Integers,                                       // Node children and skin joints
+            Matrices,
+            Characters,                                     // Every string of the file back to back
+            TextureUris,
+            PackedLayouts,
+            PackedElements,
+            PackedData,
+            Count
+        };
+
+        constexpr size_t SectionCount = static_cast<size_t>(SectionType::Count);
+
+        struct Section
+        {
+            uint64_t offset = 0;
+            uint64_t size = 0;
+        };
+
+        struct Header
+        {
+            uint32_t magic = Magic;
+            uint32_t version = Version;
+            uint64_t sourceHash = 0;
+            // A build with different struct layouts cannot use the records as they are
+            uint32_t vertexSize = sizeof(Vertex);
+            uint32_t primitiveSize = sizeof(Primitive);
+            uint32_t vertexCount = 0;
+            uint32_t indexCount = 0;
+            Section sections[SectionCount]{};
+        };
+
+        // Offset and count inside one of the pools
+        struct Range
+        {
+            uint32_t offset = 0;
+            uint32_t count = 0;
+        };
+
+        struct SubMeshRecord
+        {
+            Range primitives{};
+        };
+
+        struct NodeRecord
+        {
+            Range name{};
+            Range children{};
+            int32_t subMeshIndex = -1;
+            int32_t skin = -1;
+            float translation[3]{};
+            float rotation[4]{};                            // x, y, z, w
+            float scale[3]{};
+            float extraTransform[16]{};
+        };
+
+        struct SkinRecord
+        {
+            Range joints{};
+            Range inverseBindMatrices{};
+            int32_t skeletonRootNode = -1;
+        };
+
+        struct AnimationRecord
+        {
+            Range name{};
+            Range samplers{};
+            Range channels{};
+            float startTime = 0.0f;
+            float endTime = 0.0f;
+            float animationDuration = 0.0f;
+        };
+
+        struct SamplerRecord
+        {
+            Animation::Interpolation interpolation{};
+            Range keyframes{};
+        };
+
+        struct PackedLayoutRecord
+        {
+            Range elements{};
+            uint32_t stride = 0;
+            uint32_t vertexCount = 0;
+            float positionOffset[3]{};
+            float positionScale[3]{};
+            uint64_t dataOffset = 0;                        // Inside the packed data section
+            uint64_t dataSize = 0;
+        };
+
+        static_assert(std::is_trivially_copyable_v<Vertex>);
+        static_assert(std::is_trivially_copyable_v<Primitive>);
+        static_assert(std::is_trivially_copyable_v<Animation::Sampler::InputAndOutput>);
+        static_assert(std::is_trivially_copyable_v<Animation::Channel>);
+        static_assert(std::is_trivially_copyable_v<PackedVertexLayout::Element>);
+
+        uint64_t Align(uint64_t const value)
+        {
+            return (value + SectionAlignment - 1) & ~(SectionAlignment - 1);
+        }
+
+        bool IsInside(Range const & range, size_t const count)
+        {
+            return range.offset <= count && range.count <= count - range.offset;
+        }
+
+        bool IsIndex(int64_t const index, size_t const count)
+        {
+            return index >= 0 && static_cast<uint64_t>(index) < count;
+        }
+
+        // -1 means none
+        bool IsOptionalIndex(int64_t const index, size_t const count)
+        {
+            return index == -1 || IsIndex(index, count);
+        }
+
+        // Texture indices of a primitive point into the texture uris of the same file, -1 when the image was not
+        // found. An index is only read when its flag is set, Unused ones keep whatever default they had.
+        bool HasValidTextures(Primitive const & primitive, size_t const textureCount)
+        {
+            auto const isValid = [textureCount](bool const hasTexture, int const index)->bool
+            {
+                return hasTexture == false || IsOptionalIndex(index, textureCount);
+            };
+            return isValid(primitive.hasBaseColorTexture, primitive.baseColorTextureIndex) &&
+                isValid(primitive.hasMetallicRoughnessTexture, primitive.metallicRoughnessTextureIndex) &&
+                isValid(primitive.hasRoughnessTexture, primitive.roughnessTextureIndex) &&
+                isValid(primitive.hasNormalTexture, primitive.normalTextureIndex) &&
+                isValid(primitive.hasEmissiveTexture, primitive.emissiveTextureIndex) &&
+                isValid(primitive.hasOcclusionTexture, primitive.occlusionTextureIndex);
+        }
+
+        // Points into the file, Offsets are aligned so the records can be used in place
+        template<typename T>
+        struct View
+        {
+            T const * data = nullptr;
+            size_t count = 0;
+
+            T const & operator[](size_t const index) const
+            {
+                return data[index];
+            }
+        };
+
+        template<typename T>
+        bool GetSection(BaseBlob const & file, Header const & header, SectionType const type, View<T> & outView)
+        {
+            auto const & section = header.sections[static_cast<size_t>(type)];
+            if (section.size % sizeof(T) != 0 ||
+                section.offset % alignof(T) != 0 ||
+                section.offset > file.Len() ||
+                section.size > file.Len() - section.offset)
+            {
+                return false;
+            }
+            outView.data = reinterpret_cast<T const *>(file.Ptr() + section.offset);
+            outView.count = static_cast<size_t>(section.size / sizeof(T));
+            return true;
+        }
+
+        std::string GetString(View<char> const & characters, Range const & range)
+        {
+            return std::string(characters.data + range.offset, range.count);
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool Write(
+        std::string const & path,
+        uint64_t const sourceHash,
+        Mesh const & mesh,
+        std::vector<std::string> const & textureUris
+    )
+    {
+        auto const & data = *mesh.GetMeshData();
+
+        std::vector<char> characters{};
+        auto const addString = [&characters](std::string const & value)->Range
+        {
+            Range const range{.offset = static_cast<uint32_t>(characters.size()), .count = static_cast<uint32_t>(value.size())};
+            characters.insert(characters.end(), value.begin(), value.end());
+            return range;
+        };
+
+        std::vector<int32_t> integers{};
+        auto const addIntegers = [&integers](std::vector<int> const & values)->Range
+        {
+            Range const range{.offset = static_cast<uint32_t>(integers.size()), .count = static_cast<uint32_t>(values.size())};
+            integers.insert(integers.end(), values.begin(), values.end());
+            return range;
+        };
+
+        std::vector<SubMeshRecord> subMeshes{};
+        std::vector<Primitive> primitives{};
+        for (auto const & subMesh : data.subMeshes)
+        {
+            subMeshes.emplace_back(SubMeshRecord{.primitives = Range{
+                .offset = static_cast<uint32_t>(primitives.size()),
+                .count = static_cast<uint32_t>(subMesh.primitives.size())
+            }});
+            primitives.insert(primitives.end(), subMesh.primitives.begin(), subMesh.primitives.end());
+        }
+
+        std::vector<NodeRecord> nodes{};
+        nodes.reserve(data.nodes.size());
+        for (auto const & node : data.nodes)
+        {
+            auto & record = nodes.emplace_back();
+            record.name = addString(node.name);
+            record.children = addIntegers(node.children);
+            record.subMeshIndex = node.subMeshIndex;
+            record.skin = node.skin;
+
+            auto const & position = node.transform.GetLocalPosition();
+            auto const & rotation = node.transform.GetLocalRotation().GetQuaternion();
+            auto const & scale = node.transform.GetLocalScale();
+            Memory::Copy<3>(record.translation, &position[0]);
+            record.rotation[0] = rotation.x;
+            record.rotation[1] = rotation.y;
+            record.rotation[2] = rotation.z;
+            record.rotation[3] = rotation.w;
+            Memory::Copy<3>(record.scale, &scale[0]);
+            Memory::Copy<16>(record.extraTransform, &node.transform.GetLocalExtraTransform()[0][0]);
+        }
+
+        std::vector<glm::mat4> matrices{};
+        std::vector<SkinRecord> skins{};
+        for (auto const & skin : data.skins)
+        {
+            skins.emplace_back(SkinRecord{
+                .joints = addIntegers(skin.joints),
+                .inverseBindMatrices = Range{
+                    .offset = static_cast<uint32_t>(matrices.size()),
+                    .count = static_cast<uint32_t>(skin.inverseBindMatrices.size())
+                },
+                .skeletonRootNode = skin.skeletonRootNode
+            });
+            matrices.insert(matrices.end(), skin.inverseBindMatrices.begin(), skin.inverseBindMatrices.end());
+        }
+
+        std::vector<AnimationRecord> animations{};
+        std::vector<SamplerRecord> samplers{};
+        std::vector<Animation::Sampler::InputAndOutput> keyframes{};
+        std::vector<Animation::Channel> channels{};
+        for (auto const & animation : data.animations)
+        {
+            auto & record = animations.emplace_back();
+            record.name = addString(animation.name);
+            record.samplers = Range{.offset = static_cast<uint32_t>(samplers.size()), .count = static_cast<uint32_t>(animation.samplers.size())};
+            record.channels = Range{.offset = static_cast<uint32_t>(channels.size()), .count = static_cast<uint32_t>(animation.channels.size())};
+            record.startTime = animation.startTime;
+            record.endTime = animation.endTime;
+            record.animationDuration = animation.animationDuration;
+
+            for (auto const & sampler : animation.samplers)
+            {
+                samplers.emplace_back(SamplerRecord{
+                    .interpolation = sampler.interpolation,
+                    .keyframes = Range{
+                        .offset = static_cast<uint32_t>(keyframes.size()),
+                        .count = static_cast<uint32_t>(sampler.inputAndOutput.size())
+                    }
+                });
+                keyframes.insert(keyframes.end(), sampler.inputAndOutput.begin(), sampler.inputAndOutput.end());
+            }
+            channels.insert(channels.end(), animation.channels.begin(), animation.channels.end());
+        }
+
+        std::vector<Range> uris{};
+        uris.reserve(textureUris.size());
+        for (auto const & uri : textureUris)
+        {
+            uris.emplace_back(addString(uri));
+        }
+
+        std::vector<PackedLayoutRecord> packedLayouts{};
+        std::vector<PackedVertexLayout::Element> packedElements{};
+        uint64_t packedDataSize = 0;
+        for (auto const & packed : mesh.GetPackedVertices())
+        {
+            auto & record = packedLayouts.emplace_back();
+            record.elements = Range{
+                .offset = static_cast<uint32_t>(packedElements.size()),
+                .count = static_cast<uint32_t>(packed.layout.elements.size())
+            };
+            record.stride = packed.layout.stride;
+            record.vertexCount = packed.vertexCount;
+            Memory::Copy<3>(record.positionOffset, &packed.layout.positionOffset[0]);
+            Memory::Copy<3>(record.positionScale, &packed.layout.positionScale[0]);
+            record.dataOffset = packedDataSize;
+            record.dataSize = packed.data->Len();
+            packedElements.insert(packedElements.end(), packed.layout.elements.begin(), packed.layout.elements.end());
+            packedDataSize += packed.data->Len();
+        }
+
+        // Large buffers are written straight from the mesh instead of being gathered first
+        struct Chunk
+        {
+            void const * data = nullptr;
+            size_t size = 0;
+        };
+        std::array<std::vector<Chunk>, SectionCount> sections{};
+        auto const addSection = [&sections](SectionType const type, void const * ptr, size_t const size)->void
+        {
+            if (size > 0)
+            {
+                sections[static_cast<size_t>(type)].emplace_back(Chunk{.data = ptr, .size = size});
+            }
+        };
+        addSection(SectionType::Vertices, mesh.GetVertexData()->Ptr(), mesh.GetVertexData()->Len());
+        addSection(SectionType::Indices, mesh.GetIndexData()->Ptr(), mesh.GetIndexData()->Len());
+        addSection(SectionType::SubMeshes, subMeshes.data(), subMeshes.size() * sizeof(SubMeshRecord));
+        addSection(SectionType::Primitives, primitives.data(), primitives.size() * sizeof(Primitive));
+        addSection(SectionType::Nodes, nodes.data(), nodes.size() * sizeof(NodeRecord));
+        addSection(SectionType::Skins, skins.data(), skins.size() * sizeof(SkinRecord));
+        addSection(SectionType::Animations, animations.data(), animations.size() * sizeof(AnimationRecord));
+        addSection(SectionType::Samplers, samplers.data(), samplers.size() * sizeof(SamplerRecord));
+        addSection(SectionType::Keyframes, keyframes.data(), keyframes.size() * sizeof(Animation::Sampler::InputAndOutput));
+        addSection(SectionType::Channels, channels.data(), channels.size() * sizeof(Animation::Channel));
+        addSection(SectionType::Integers, integers.data(), integers.size() * sizeof(int32_t));
+        addSection(SectionType::Matrices, matrices.data(), matrices.size() * sizeof(glm::mat4));
+        addSection(SectionType::Characters, characters.data(), characters.size());
+        addSection(SectionType::TextureUris, uris.data(), uris.size() * sizeof(Range));
+        addSection(SectionType::PackedLayouts, packedLayouts.data(), packedLayouts.size() * sizeof(PackedLayoutRecord));
+        addSection(SectionType::PackedElements, packedElements.data(), packedElements.size() * sizeof(PackedVertexLayout::Element));
+        for (auto const & packed : mesh.GetPackedVertices())
+        {
+            addSection(SectionType::PackedData, packed.data->Ptr(), packed.data->Len());
+        }
+
+        Header header{};
+        header.sourceHash = sourceHash;
+        header.vertexCount = mesh.GetVertexCount();
+        header.indexCount = mesh.GetIndexCount();
+        uint64_t offset = Align(sizeof(Header));
+        for (size_t i = 0; i < SectionCount; ++i)
+        {
+            uint64_t size = 0;
+            for (auto const & chunk : sections[i])
+            {
+                size += chunk.size;
+            }
+            header.sections[i] = Section{.offset = offset, .size = size};
+            offset = Align(offset + size);
+        }
+
+        auto const temporaryPath = path + ".tmp";
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (file.good() == false)
+            {
+                MFA_LOG_WARN("Failed to open %s for writing", temporaryPath.c_str());
+                return false;
+            }
+
+            char const padding[SectionAlignment]{};
+            file.write(reinterpret_cast<char const *>(&header), sizeof(Header));
+            uint64_t position = sizeof(Header);
+            for (size_t i = 0; i < SectionCount; ++i)
+            {
+                file.write(padding, static_cast<std::streamsize>(header.sections[i].offset - position));
+                for (auto const & chunk : sections[i])
+                {
+                    file.write(static_cast<char const *>(chunk.data), static_cast<std::streamsize>(chunk.size));
+                }
+                position = header.sections[i].offset + header.sections[i].size;
+            }
+
+            if (file.good() == false)
+            {
+                MFA_LOG_WARN("Failed to write %s", temporaryPath.c_str());
+                file.close();
+                std::error_code errorCode{};
+                std::filesystem::remove(temporaryPath, errorCode);
+                return false;
+            }
+        }
+
+        std::error_code errorCode{};
+        std::filesystem::rename(temporaryPath, path, errorCode);
+        if (errorCode)
+        {
+            MFA_LOG_WARN("Failed to replace %s: %s", path.c_str(), errorCode.message().c_str());
+            std::filesystem::remove(temporaryPath, errorCode);
+            return false;
+        }
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool Read(std::string const & path, uint64_t const sourceHash, Content & outContent)
+    {
+        std::error_code errorCode{};
+        if (std::filesystem::exists(path, errorCode) == false)
+        {
+            return false;
+        }
+
+        auto const file = File::Map(path);
+        if (file == nullptr || file->Len() < sizeof(Header))
+        {
+            return false;
+        }
+
+        Header header{};
+        std::memcpy(&header, file->Ptr(), sizeof(Header));
+        if (header.magic != Magic ||
+            header.version != Version ||
+            header.sourceHash != sourceHash ||
+            header.vertexSize != sizeof(Vertex) ||
+            header.primitiveSize != sizeof(Primitive))
+        {
+            return false;
+        }
+
+        View<Vertex> vertices{};
+        View<Index> indices{};
+        View<SubMeshRecord> subMeshes{};
+        View<Primitive> primitives{};
+        View<NodeRecord> nodes{};
+        View<SkinRecord> skins{};
+        View<AnimationRecord> animations{};
+        View<SamplerRecord> samplers{};
+        View<Animation::Sampler::InputAndOutput> keyframes{};
+        View<Animation::Channel> channels{};
+        View<int32_t> integers{};
+        View<glm::mat4> matrices{};
+        View<char> characters{};
+        View<Range> uris{};
+        View<PackedLayoutRecord> packedLayouts{};
+        View<PackedVertexLayout::Element> packedElements{};
+        View<uint8_t> packedData{};
+
+        bool const hasValidSections =
+            GetSection(*file, header, SectionType::Vertices, vertices) &&
+            GetSection(*file, header, SectionType::Indices, indices) &&
+            GetSection(*file, header, SectionType::SubMeshes, subMeshes) &&
+            GetSection(*file, header, SectionType::Primitives, primitives) &&
+            GetSection(*file, header, SectionType::Nodes, nodes) &&
+            GetSection(*file, header, SectionType::Skins, skins) &&
+            GetSection(*file, header, SectionType::Animations, animations) &&
+            GetSection(*file, header, SectionType::Samplers, samplers) &&
+            GetSection(*file, header, SectionType::Keyframes, keyframes) &&
+            GetSection(*file, header, SectionType::Channels, channels) &&
+            GetSection(*file, header, SectionType::Integers, integers) &&
+            GetSection(*file, header, SectionType::Matrices, matrices) &&
+            GetSection(*file, header, SectionType::Characters, characters) &&
+            GetSection(*file, header, SectionType::TextureUris, uris) &&
+            GetSection(*file, header, SectionType::PackedLayouts, packedLayouts) &&
+            GetSection(*file, header, SectionType::PackedElements, packedElements) &&
+            GetSection(*file, header, SectionType::PackedData, packedData);
+        if (hasValidSections == false ||
+            vertices.count != header.vertexCount ||
+            indices.count != header.indexCount ||
+            vertices.count == 0 ||
+            indices.count == 0 ||
+            nodes.count == 0)
+        {
+            MFA_LOG_WARN("Ignoring corrupted cache %s", path.c_str());
+            return false;
+        }
+
+        auto mesh = std::make_shared<Mesh>(
+            header.vertexCount,
+            header.indexCount,
+            Memory::AllocSize(sizeof(Vertex) * vertices.count),
+            Memory::AllocSize(sizeof(Index) * indices.count)
+        );
+
+        // Primitives are inserted in the order they were baked, So their offsets come out the same
+        uint32_t nextVertex = 0;
+        uint32_t nextIndex = 0;
+        std::vector<uint32_t> primitiveVertexCounts{};
+        for (size_t subMeshIdx = 0; subMeshIdx < subMeshes.count; ++subMeshIdx)
+        {
+            auto const & subMesh = subMeshes[subMeshIdx];
+            if (IsInside(subMesh.primitives, primitives.count) == false)
+            {
+                return false;
+            }
+            auto const subMeshIndex = mesh->InsertSubMesh();
+            for (uint32_t i = 0; i < subMesh.primitives.count; ++i)
+            {
+                auto const & primitive = primitives[subMesh.primitives.offset + i];
+                if (primitive.verticesStartingIndex != nextVertex ||
+                    primitive.indicesStartingIndex != nextIndex ||
+                    primitive.vertexCount > vertices.count - nextVertex ||
+                    primitive.indicesCount > indices.count - nextIndex ||
+                    HasValidTextures(primitive, uris.count) == false)
+                {
+                    return false;
+                }
+                mesh->InsertPrimitive(
+                    subMeshIndex,
+                    primitive,
+                    primitive.vertexCount,
+                    vertices.data + nextVertex,
+                    primitive.indicesCount,
+                    indices.data + nextIndex
+                );
+                nextVertex += primitive.vertexCount;
+                nextIndex += primitive.indicesCount;
+                primitiveVertexCounts.emplace_back(primitive.vertexCount);
+            }
+        }
+        if (nextVertex != vertices.count || nextIndex != indices.count)
+        {
+            return false;
+        }
+
+        for (size_t nodeIdx = 0; nodeIdx < nodes.count; ++nodeIdx)
+        {
+            auto const & record = nodes[nodeIdx];
+            if (IsInside(record.name, characters.count) == false ||
+                IsInside(record.children, integers.count) == false ||
+                IsOptionalIndex(record.subMeshIndex, subMeshes.count) == false ||
+                IsOptionalIndex(record.skin, skins.count) == false)
+            {
+                return false;
+            }
+            auto & node = mesh->InsertNode();
+            node.name = GetString(characters, record.name);
+            node.subMeshIndex = record.subMeshIndex;
+            node.skin = record.skin;
+            for (uint32_t i = 0; i < record.children.count; ++i)
+            {
+                auto const child = integers[record.children.offset + i];
+                if (IsIndex(child, nodes.count) == false)
+                {
+                    return false;
+                }
+                node.children.emplace_back(child);
+            }
+            node.transform.SetLocalPosition(glm::vec3{record.translation[0], record.translation[1], record.translation[2]});
+            node.transform.SetLocalQuaternion(glm::quat{record.rotation[3], record.rotation[0], record.rotation[1], record.rotation[2]});
+            node.transform.SetLocalScale(glm::vec3{record.scale[0], record.scale[1], record.scale[2]});
+            glm::mat4 extraTransform{};
+            Memory::Copy<16>(&extraTransform[0][0], record.extraTransform);
+            node.transform.SetLocalExtraTransform(extraTransform);
+        }
+
+        for (size_t skinIdx = 0; skinIdx < skins.count; ++skinIdx)
+        {
+            auto const & record = skins[skinIdx];
+            // Joints and their inverse bind matrices are read side by side
+            if (IsInside(record.joints, integers.count) == false ||
+                IsInside(record.inverseBindMatrices, matrices.count) == false ||
+                record.inverseBindMatrices.count < record.joints.count ||
+                IsOptionalIndex(record.skeletonRootNode, nodes.count) == false)
+            {
+                return false;
+            }
+            auto & skin = mesh->InsertSkin();
+            skin.joints.assign(
+                integers.data + record.joints.offset,
+                integers.data + record.joints.offset + record.joints.count
+            );
+            for (auto const joint : skin.joints)
+            {
+                if (IsIndex(joint, nodes.count) == false)
+                {
+                    return false;
+                }
+            }
+            skin.inverseBindMatrices.assign(
+                matrices.data + record.inverseBindMatrices.offset,
+                matrices.data + record.inverseBindMatrices.offset + record.inverseBindMatrices.count
+            );
+            skin.skeletonRootNode = record.skeletonRootNode;
+        }
+
+        for (size_t animationIdx = 0; animationIdx < animations.count; ++animationIdx)
+        {
+            auto const & record = animations[animationIdx];
+            if (IsInside(record.name, characters.count) == false ||
+                IsInside(record.samplers, samplers.count) == false ||
+                IsInside(record.channels, channels.count) == false)
+            {
+                return false;
+            }
+            Animation animation{};
+            animation.name = GetString(characters, record.name);
+            animation.startTime = record.startTime;
+            animation.endTime = record.endTime;
+            animation.animationDuration = record.animationDuration;
+            for (uint32_t i = 0; i < record.samplers.count; ++i)
+            {
+                auto const & samplerRecord = samplers[record.samplers.offset + i];
+                if (IsInside(samplerRecord.keyframes, keyframes.count) == false)
+                {
+                    return false;
+                }
+                auto & sampler = animation.samplers.emplace_back();
+                sampler.interpolation = samplerRecord.interpolation;
+                sampler.inputAndOutput.assign(
+                    keyframes.data + samplerRecord.keyframes.offset,
+                    keyframes.data + samplerRecord.keyframes.offset + samplerRecord.keyframes.count
+                );
+            }
+            animation.channels.assign(
+                channels.data + record.channels.offset,
+                channels.data + record.channels.offset + record.channels.count
+            );
+            // Sampler indices are relative to the samplers of the animation
+            for (auto const & channel : animation.channels)
+            {
+                if (IsIndex(channel.nodeIndex, nodes.count) == false ||
+                    IsIndex(channel.samplerIndex, animation.samplers.size()) == false)
+                {
+                    return false;
+                }
+            }
+            mesh->InsertAnimation(animation);
+        }
+
+        // One stream per primitive like Mesh::PackVertices writes them, A mesh without primitives has a single one
+        if (primitiveVertexCounts.empty() == true)
+        {
+            primitiveVertexCounts.emplace_back(vertices.count);
+        }
+        if (packedLayouts.count != 0 && packedLayouts.count != primitiveVertexCounts.size())
+        {
+            return false;
+        }
+        std::vector<PackedVertices> packedVertices{};
+        packedVertices.reserve(packedLayouts.count);
+        for (size_t layoutIdx = 0; layoutIdx < packedLayouts.count; ++layoutIdx)
+        {
+            auto const & record = packedLayouts[layoutIdx];
+            if (record.vertexCount != primitiveVertexCounts[layoutIdx] ||
+                IsInside(record.elements, packedElements.count) == false ||
+                record.dataOffset > packedData.count ||
+                record.dataSize > packedData.count - record.dataOffset ||
+                record.dataSize != static_cast<uint64_t>(record.stride) * record.vertexCount)
+            {
+                return false;
+            }
+            auto & packed = packedVertices.emplace_back();
+            packed.layout.elements.assign(
+                packedElements.data + record.elements.offset,
+                packedElements.data + record.elements.offset + record.elements.count
+            );
+            for (auto const & element : packed.layout.elements)
+            {
+                if (element.attribute >= VertexAttribute::Count ||
+                    element.format > VertexFormat::UNorm8x4 ||
+                    element.offset + VertexFormatSize(element.format) > record.stride)
+                {
+                    return false;
+                }
+            }
+            packed.layout.stride = record.stride;
+            packed.layout.positionOffset = glm::vec3{record.positionOffset[0], record.positionOffset[1], record.positionOffset[2]};
+            packed.layout.positionScale = glm::vec3{record.positionScale[0], record.positionScale[1], record.positionScale[2]};
+            packed.vertexCount = record.vertexCount;
+            packed.data = Memory::AllocSize(static_cast<size_t>(record.dataSize));
+            std::memcpy(packed.data->Ptr(), packedData.data + record.dataOffset, static_cast<size_t>(record.dataSize));
+        }
+
+        std::vector<std::string> textureUris{};
+        textureUris.reserve(uris.count);
+        for (size_t i = 0; i < uris.count; ++i)
+        {
+            if (IsInside(uris[i], characters.count) == false)
+            {
+                return false;
+            }
+            textureUris.emplace_back(GetString(characters, uris[i]));
+        }
+
+        mesh->FinalizeData();
+        mesh->SetPackedVertices(std::move(packedVertices));
+
+        outContent.mesh = std::move(mesh);
+        outContent.textureUris = std::move(textureUris);
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "AssetGLTF_Mesh.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Baked binary copy of an imported gltf model. Every section is a flat array of trivially copyable records at an
+// aligned offset, So reading is a bounds check and a few large copies out of the mapped file instead of parsing.
+namespace MFA::Asset::GLTF::Cache
+{
+    // Bump whenever the file layout, The cached structs or the import pipeline changes
+    static constexpr uint32_t Version = 5;
+
+    struct Content
+    {
+        std::shared_ptr<Mesh> mesh{};
+        std::vector<std::string> textureUris{};         // Relative to the directory of the source file
+    };
+
+    // Writes to a temporary file first and then replaces the old cache, So readers never see a half written file
+    bool Write(
+        std::string const & path,
+        uint64_t sourceHash,
+        Mesh const & mesh,
+        std::vector<std::string> const & textureUris
+    );
+
+    // Returns false if there is no cache, If it is corrupted or if it was baked from another source or version
+    bool Read(std::string const & path, uint64_t sourceHash, Content & outContent);
+}
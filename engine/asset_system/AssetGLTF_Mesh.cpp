@@ -2,6 +2,12 @@
 
 #include "BedrockAssert.hpp"
 #include "BedrockMath.hpp"
+#include "JobSystem.hpp"
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace MFA::Asset::GLTF
 {
@@ -10,6 +16,12 @@ namespace MFA::Asset::GLTF
 
     Node::Node() = default;
 
+    //-------------------------------------------------------------------------------------------------
+
+    Node::Node(std::shared_ptr<TransformStore> transformStore)
+        : transform(std::move(transformStore))
+    {}
+
     //-------------------------------------------------------------------------------------------------
 
 	bool Node::hasSubMesh() const noexcept
@@ -24,6 +36,79 @@ namespace MFA::Asset::GLTF
         return parent >= 0;
 	}
 
+    //-------------------------------------------------------------------------------------------------
+
+    MeshData::MeshData() = default;
+
+    //-------------------------------------------------------------------------------------------------
+
+    MeshData::~MeshData() = default;
+
+    //-------------------------------------------------------------------------------------------------
+
+    MeshData::MeshData(MeshData const & other)
+        : subMeshes(other.subMeshes)
+        , skins(other.skins)
+        , animations(other.animations)
+        , rootNodes(other.rootNodes)
+        , hasPositionMinMax(other.hasPositionMinMax)
+    {
+        std::copy(std::begin(other.positionMin), std::end(other.positionMin), std::begin(positionMin));
+        std::copy(std::begin(other.positionMax), std::end(other.positionMax), std::begin(positionMax));
+
+        // The copied lists still point into the primitives of other
+        for (size_t i = 0; i < subMeshes.size(); ++i)
+        {
+            auto * primitives = subMeshes[i].primitives.data();
+            auto const * otherPrimitives = other.subMeshes[i].primitives.data();
+            for (auto * list : {&subMeshes[i].opaquePrimitives, &subMeshes[i].blendPrimitives, &subMeshes[i].maskPrimitives})
+            {
+                for (auto *& primitive : *list)
+                {
+                    primitive = primitives + (primitive - otherPrimitives);
+                }
+            }
+        }
+
+        nodes.reserve(other.nodes.size());
+        for (auto const & otherNode : other.nodes)
+        {
+            auto & node = nodes.emplace_back(transformStore);
+            node.name = otherNode.name;
+            node.subMeshIndex = otherNode.subMeshIndex;
+            node.children = otherNode.children;
+            node.parent = otherNode.parent;
+            node.skin = otherNode.skin;
+            node.transform = otherNode.transform;
+        }
+        for (auto & node : nodes)
+        {
+            if (node.parent >= 0 && node.parent < static_cast<int>(nodes.size()))
+            {
+                node.transform.SetParent(&nodes[node.parent].transform);
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    MeshData::MeshData(MeshData && other) noexcept = default;
+
+    //-------------------------------------------------------------------------------------------------
+
+    MeshData & MeshData::operator=(MeshData const & rhs)
+    {
+        if (this != &rhs)
+        {
+            *this = MeshData{rhs};
+        }
+        return *this;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    MeshData & MeshData::operator=(MeshData && rhs) noexcept = default;
+
     //-------------------------------------------------------------------------------------------------
 
 	Mesh::Mesh(
@@ -98,6 +183,7 @@ namespace MFA::Asset::GLTF
                 for (auto const child : currentNode.children)
                 {
                     mData->nodes[child].parent = i;
+                    mData->nodes[child].transform.SetParent(&mData->nodes[i].transform);
                 }
             }
         }
@@ -126,9 +212,9 @@ namespace MFA::Asset::GLTF
         uint32_t subMeshIndex,
         Primitive primitive,
         uint32_t vertexCount,
-        Vertex* vertices,
+        Vertex const * vertices,
         uint32_t indicesCount,
-        Index* indices
+        Index const * indices
 	)
 	{
         MFA_ASSERT(vertexCount > 0);
@@ -150,6 +236,8 @@ namespace MFA::Asset::GLTF
 
         ::memcpy(mVertexData->Ptr() + mNextVertexOffset, vertices, verticesSize);
         ::memcpy(mIndexData->Ptr() + mNextIndexOffset, indices, indicesSize);
+        // The packed streams do not have this primitive
+        mPackedVertices.clear();
 
         MFA_ASSERT(subMeshIndex < mData->subMeshes.size());
         auto& subMesh = mData->subMeshes[subMeshIndex];
@@ -197,7 +285,7 @@ namespace MFA::Asset::GLTF
 
     Node & Mesh::InsertNode() const
     {
-        mData->nodes.emplace_back();
+        mData->nodes.emplace_back(mData->transformStore);
         return mData->nodes.back();
     }
 
@@ -266,6 +354,8 @@ namespace MFA::Asset::GLTF
     void Mesh::CenterMesh()
     {
         auto * vertices = mVertexData->As<Vertex>();
+        // The packed positions are relative to the old bounds
+        mPackedVertices.clear();
         
         glm::vec3 minimum{};
 		glm::vec3 maximum{};
@@ -322,103 +412,503 @@ namespace MFA::Asset::GLTF
         mIsCentered = true;
     }
 
-	//-------------------------------------------------------------------------------------------------
+    //-------------------------------------------------------------------------------------------------
 
-    void Mesh::Optimize()
+    namespace
     {
-        auto * vertices = mVertexData->As<Vertex>();
-        auto * indices = mIndexData->As<Index>();
+        // Same threshold that the pairwise comparison used to have
+        constexpr float WeldDistanceSquared = std::numeric_limits<float>::epsilon();
 
-        std::vector<Vertex> vertices2 {};
+        // Cells are a few times larger than the weld distance, So most vertices only have to look into their own cell
+        constexpr float CellSizeScale = 4.0f;
 
-        for (int i = 0; i < mVertexCount; ++i)
+        constexpr Index InvalidIndex = std::numeric_limits<Index>::max();
+
+        struct CellKey
         {
-            bool isDuplicate = false;
-            int nIdx = i;
+            int64_t x = 0;
+            int64_t y = 0;
+            int64_t z = 0;
+
+            bool operator == (CellKey const &) const = default;
+        };
 
-            for (int j = 0; j < vertices2.size(); ++j)
+        struct CellKeyHash
+        {
+            // Primes from Teschner et al. "Optimized Spatial Hashing for Collision Detection of Deformable Objects"
+            size_t operator()(CellKey const & key) const noexcept
             {
-                if (glm::length2(vertices2[j].position - vertices[i].position) < glm::epsilon<float>())
-                {
-                    isDuplicate = true;
-                    nIdx = j;
-                    break;
-                }
+                auto const hash = static_cast<uint64_t>(key.x) * 73856093ull ^
+                    static_cast<uint64_t>(key.y) * 19349663ull ^
+                    static_cast<uint64_t>(key.z) * 83492791ull;
+                return static_cast<size_t>(hash ^ (hash >> 29));
             }
+        };
 
-            if (isDuplicate == false)
+        struct TriangleKey
+        {
+            Index a = 0;
+            Index b = 0;
+            Index c = 0;
+
+            bool operator == (TriangleKey const &) const = default;
+        };
+
+        struct TriangleKeyHash
+        {
+            size_t operator()(TriangleKey const & key) const noexcept
             {
-                nIdx = vertices2.size();
-                vertices2.emplace_back(vertices[i]);
+                uint64_t hash = key.a;
+                hash = hash * 0x9E3779B97F4A7C15ull + key.b;
+                hash = hash * 0x9E3779B97F4A7C15ull + key.c;
+                return static_cast<size_t>(hash ^ (hash >> 32));
             }
+        };
 
-            for (int k = 0; k < mIndexCount; ++k)
+        struct PrimitiveRange
+        {
+            uint32_t vertexStart = 0;
+            uint32_t vertexCount = 0;
+            uint32_t indexStart = 0;
+            uint32_t indexCount = 0;
+            Primitive * primitive = nullptr;
+        };
+
+        // A mesh without primitives is treated as a single range
+        std::vector<PrimitiveRange> CollectPrimitiveRanges(
+            MeshData & data,
+            uint32_t const vertexCount,
+            uint32_t const indexCount
+        )
+        {
+            std::vector<PrimitiveRange> ranges{};
+            for (auto & subMesh : data.subMeshes)
             {
-                if (indices[k] == i)
+                for (auto & primitive : subMesh.primitives)
                 {
-                    indices[k] = nIdx;
+                    ranges.emplace_back(PrimitiveRange{
+                        .vertexStart = primitive.verticesStartingIndex,
+                        .vertexCount = primitive.vertexCount,
+                        .indexStart = primitive.indicesStartingIndex,
+                        .indexCount = primitive.indicesCount,
+                        .primitive = &primitive
+                    });
                 }
             }
-
+            if (ranges.empty() == true)
+            {
+                ranges.emplace_back(PrimitiveRange{.vertexCount = vertexCount, .indexCount = indexCount});
+            }
+            return ranges;
         }
 
-        mVertexData = Memory::Alloc(vertices2.data(), vertices2.size());
-        mVertexCount = vertices2.size();
+        // Checked at runtime, Gltf files can have any topology and index buffers that we did not write ourselves
+        bool IsTriangleList(PrimitiveRange const & range, Index const * indices)
+        {
+            if (range.primitive != nullptr && range.primitive->topology != PrimitiveTopology::TriangleList)
+            {
+                return false;
+            }
+            if (range.indexCount % 3 != 0)
+            {
+                return false;
+            }
+            for (uint32_t k = 0; k < range.indexCount; ++k)
+            {
+                auto const index = indices[range.indexStart + k];
+                if (index < range.vertexStart || index - range.vertexStart >= range.vertexCount)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
 
-        std::vector<Index> indices2{};
+        struct WeldResult
+        {
+            std::vector<Index> uniqueVertices{};        // Local index of the vertex that each unique vertex comes from
+            std::vector<Index> indices{};               // Local indices into uniqueVertices
+        };
 
-        for (int i = 0; i < mIndexCount / 3; ++i)
+        // Keeps every vertex and index of the range, Indices that are out of the range are clamped so the result
+        // stays inside the primitive after it is moved
+        WeldResult KeepAsIs(PrimitiveRange const & range, Index const * indices)
         {
+            WeldResult result{};
+            result.uniqueVertices.resize(range.vertexCount);
+            for (uint32_t v = 0; v < range.vertexCount; ++v)
+            {
+                result.uniqueVertices[v] = v;
+            }
+            result.indices.resize(range.indexCount);
+            for (uint32_t k = 0; k < range.indexCount; ++k)
+            {
+                auto const index = indices[range.indexStart + k];
+                bool const isInside = index >= range.vertexStart && index - range.vertexStart < range.vertexCount;
+                result.indices[k] = isInside ? index - range.vertexStart : 0;
+            }
+            return result;
+        }
 
-            auto const idV1x0 = indices[i * 3];
-            auto const idV1x1 = indices[i * 3 + 1];
-            auto const idV1x2 = indices[i * 3 + 2];
+        // Vertices get welded to the earliest unique vertex within the distance and keep its attributes.
+        // Triangles that reference the same three vertices in any order are only kept once, Triangles that collapse
+        // after welding are dropped.
+        WeldResult Weld(
+            Vertex const * vertices,
+            uint32_t const vertexCount,
+            Index const * indices,
+            uint32_t const indexCount,
+            uint32_t const vertexStart
+        )
+        {
+            WeldResult result{};
 
-            bool isDuplicate = false;
-            for (int j = 0; j < indices2.size() / 3; ++j)
+            float const weldDistance = std::sqrt(WeldDistanceSquared);
+            float const cellSize = weldDistance * CellSizeScale;
+            auto const toCell = [cellSize](float const value)->int64_t
             {
-                auto const idV2x0 = indices2[j * 3];
-                auto const idV2x1 = indices2[j * 3 + 1];
-                auto const idV2x2 = indices2[j * 3 + 2];
-
-                MFA_ASSERT(idV2x0 != idV2x1);
-                MFA_ASSERT(idV2x0 != idV2x2);
-                MFA_ASSERT(idV2x1 != idV2x2);
+                return static_cast<int64_t>(std::floor(value / cellSize));
+            };
+
+            // Unique vertices of a cell are chained through nextInCell, starting from cellHeads
+            std::unordered_map<CellKey, Index, CellKeyHash> cellHeads{};
+            cellHeads.reserve(vertexCount);
+            std::vector<Index> nextInCell{};
+            nextInCell.reserve(vertexCount);
+            result.uniqueVertices.reserve(vertexCount);
+            std::vector<Index> remap(vertexCount);
+
+            for (uint32_t i = 0; i < vertexCount; ++i)
+            {
+                auto const & position = vertices[i].position;
+                glm::vec3 const low = position - weldDistance;
+                glm::vec3 const high = position + weldDistance;
 
-                if (idV1x0 == idV2x0 || 
-                    idV1x0 == idV2x1 ||
-                    idV1x0 == idV2x2)
+                Index match = InvalidIndex;
+                for (int64_t x = toCell(low.x); x <= toCell(high.x); ++x)
                 {
-                    if (idV1x1 == idV2x0 || 
-                        idV1x1 == idV2x1 ||
-                        idV1x1 == idV2x2)
+                    for (int64_t y = toCell(low.y); y <= toCell(high.y); ++y)
                     {
-                        if (idV1x2 == idV2x0 || 
-                            idV1x2 == idV2x1 ||
-                            idV1x2 == idV2x2)
+                        for (int64_t z = toCell(low.z); z <= toCell(high.z); ++z)
                         {
-                            isDuplicate = true;    
-                            break;
+                            auto const findResult = cellHeads.find(CellKey{x, y, z});
+                            if (findResult == cellHeads.end())
+                            {
+                                continue;
+                            }
+                            for (Index unique = findResult->second; unique != InvalidIndex; unique = nextInCell[unique])
+                            {
+                                if (unique < match &&
+                                    glm::length2(vertices[result.uniqueVertices[unique]].position - position) < WeldDistanceSquared)
+                                {
+                                    match = unique;
+                                }
+                            }
                         }
                     }
                 }
+
+                if (match == InvalidIndex)
+                {
+                    match = static_cast<Index>(result.uniqueVertices.size());
+                    result.uniqueVertices.emplace_back(i);
+                    auto [head, inserted] = cellHeads.try_emplace(
+                        CellKey{toCell(position.x), toCell(position.y), toCell(position.z)},
+                        match
+                    );
+                    nextInCell.emplace_back(inserted == true ? InvalidIndex : head->second);
+                    head->second = match;
+                }
+                remap[i] = match;
             }
-            if (isDuplicate == false)
+
+            std::vector<Index> remappedIndices(indexCount);
+            JobSystem::ParallelFor(static_cast<int>(indexCount), 4096, [&](int const begin, int const end)->void
             {
-                indices2.emplace_back(idV1x0);
-                indices2.emplace_back(idV1x1);
-                indices2.emplace_back(idV1x2);
+                for (int i = begin; i < end; ++i)
+                {
+                    MFA_ASSERT(indices[i] >= vertexStart && indices[i] - vertexStart < vertexCount);
+                    remappedIndices[i] = remap[indices[i] - vertexStart];
+                }
+            });
+
+            std::unordered_set<TriangleKey, TriangleKeyHash> triangles{};
+            triangles.reserve(indexCount / 3);
+            result.indices.reserve(indexCount);
+            for (uint32_t i = 0; i + 2 < indexCount; i += 3)
+            {
+                Index const v0 = remappedIndices[i];
+                Index const v1 = remappedIndices[i + 1];
+                Index const v2 = remappedIndices[i + 2];
+                if (v0 == v1 || v0 == v2 || v1 == v2)
+                {
+                    continue;
+                }
+
+                TriangleKey key{
+                    .a = std::min({v0, v1, v2}),
+                    .b = 0,
+                    .c = std::max({v0, v1, v2})
+                };
+                key.b = v0 + v1 + v2 - key.a - key.c;
+                if (triangles.emplace(key).second == true)
+                {
+                    result.indices.emplace_back(v0);
+                    result.indices.emplace_back(v1);
+                    result.indices.emplace_back(v2);
+                }
+            }
+
+            return result;
+        }
+    }
+
+	//-------------------------------------------------------------------------------------------------
+
+    void Mesh::Optimize()
+    {
+        // Primitives are welded separately, Vertices of different materials must not be merged
+        auto const ranges = CollectPrimitiveRanges(*mData, mVertexCount, mIndexCount);
+
+        auto const * vertices = mVertexData->As<Vertex>();
+        auto const * indices = mIndexData->As<Index>();
+
+        std::vector<WeldResult> results(ranges.size());
+        JobSystem::ParallelFor(static_cast<int>(ranges.size()), 1, [&](int const begin, int const end)->void
+        {
+            for (int i = begin; i < end; ++i)
+            {
+                auto const & range = ranges[i];
+                if (IsTriangleList(range, indices) == false)
+                {
+                    results[i] = KeepAsIs(range, indices);
+                    continue;
+                }
+                results[i] = Weld(
+                    vertices + range.vertexStart,
+                    range.vertexCount,
+                    indices + range.indexStart,
+                    range.indexCount,
+                    range.vertexStart
+                );
+            }
+        });
+
+        uint32_t newVertexCount = 0;
+        uint32_t newIndexCount = 0;
+        std::vector<uint32_t> newVertexStarts(ranges.size());
+        std::vector<uint32_t> newIndexStarts(ranges.size());
+        for (size_t i = 0; i < ranges.size(); ++i)
+        {
+            newVertexStarts[i] = newVertexCount;
+            newIndexStarts[i] = newIndexCount;
+            newVertexCount += static_cast<uint32_t>(results[i].uniqueVertices.size());
+            newIndexCount += static_cast<uint32_t>(results[i].indices.size());
+        }
+
+        std::shared_ptr<Blob> newVertexData = Memory::AllocSize(sizeof(Vertex) * newVertexCount);
+        std::shared_ptr<Blob> newIndexData = Memory::AllocSize(sizeof(Index) * newIndexCount);
+        auto * newVertices = newVertexData->As<Vertex>();
+        auto * newIndices = newIndexData->As<Index>();
+
+        JobSystem::ParallelFor(static_cast<int>(ranges.size()), 1, [&](int const begin, int const end)->void
+        {
+            for (int i = begin; i < end; ++i)
+            {
+                auto const & range = ranges[i];
+                auto const & result = results[i];
+                for (size_t v = 0; v < result.uniqueVertices.size(); ++v)
+                {
+                    newVertices[newVertexStarts[i] + v] = vertices[range.vertexStart + result.uniqueVertices[v]];
+                }
+                for (size_t k = 0; k < result.indices.size(); ++k)
+                {
+                    newIndices[newIndexStarts[i] + k] = newVertexStarts[i] + result.indices[k];
+                }
+            }
+        });
+
+        for (size_t i = 0; i < ranges.size(); ++i)
+        {
+            auto * primitive = ranges[i].primitive;
+            if (primitive == nullptr)
+            {
+                continue;
             }
+            primitive->vertexCount = static_cast<uint32_t>(results[i].uniqueVertices.size());
+            primitive->indicesCount = static_cast<uint32_t>(results[i].indices.size());
+            primitive->verticesStartingIndex = newVertexStarts[i];
+            primitive->indicesStartingIndex = newIndexStarts[i];
+            primitive->verticesOffset = sizeof(Vertex) * static_cast<uint64_t>(newVertexStarts[i]);
+            primitive->indicesOffset = sizeof(Index) * static_cast<uint64_t>(newIndexStarts[i]);
         }
 
-        mIndexData = Memory::Alloc(indices2.data(), indices2.size());
-        mIndexCount = indices2.size();
+        mVertexData = std::move(newVertexData);
+        mVertexCount = newVertexCount;
+        mPackedVertices.clear();
+        mIndexData = std::move(newIndexData);
+        mIndexCount = newIndexCount;
+
+        mVerticesStartingIndex = mVertexCount;
+        mIndicesStartingIndex = mIndexCount;
+        mNextVertexOffset = mVertexData->Len();
+        mNextIndexOffset = mIndexData->Len();
 
         mIsOptimized = true;
     }
 
     //-------------------------------------------------------------------------------------------------
 
+    Mesh::RenderingStats Mesh::OptimizeForRendering(float const overdrawThreshold)
+    {
+        auto const ranges = CollectPrimitiveRanges(*mData, mVertexCount, mIndexCount);
+
+        auto * vertices = mVertexData->As<Vertex>();
+        auto * indices = mIndexData->As<Index>();
+        // The vertices get reordered, So the packed streams would not match the indices anymore
+        mPackedVertices.clear();
+
+        std::vector<RenderingStats> results(ranges.size());
+        JobSystem::ParallelFor(static_cast<int>(ranges.size()), 1, [&](int const begin, int const end)->void
+        {
+            for (int i = begin; i < end; ++i)
+            {
+                auto const & range = ranges[i];
+                auto & result = results[i];
+                if (IsTriangleList(range, indices) == false)
+                {
+                    result.skippedPrimitiveCount = 1;
+                    continue;
+                }
+
+                auto * rangeVertices = vertices + range.vertexStart;
+                auto * rangeIndices = indices + range.indexStart;
+
+                // The optimizer works with indices that are relative to the primitive
+                for (uint32_t k = 0; k < range.indexCount; ++k)
+                {
+                    rangeIndices[k] -= range.vertexStart;
+                }
+
+                result.before = MeshOptimizer::AnalyzeVertexCache(rangeIndices, range.indexCount, range.vertexCount);
+
+                MeshOptimizer::OptimizeVertexCache(rangeIndices, range.indexCount, range.vertexCount);
+                MeshOptimizer::OptimizeOverdraw(
+                    rangeIndices,
+                    range.indexCount,
+                    &rangeVertices->position,
+                    sizeof(Vertex),
+                    range.vertexCount,
+                    overdrawThreshold
+                );
+                MeshOptimizer::OptimizeVertexFetch(
+                    rangeVertices,
+                    sizeof(Vertex),
+                    rangeIndices,
+                    range.indexCount,
+                    range.vertexCount
+                );
+
+                result.after = MeshOptimizer::AnalyzeVertexCache(rangeIndices, range.indexCount, range.vertexCount);
+
+                for (uint32_t k = 0; k < range.indexCount; ++k)
+                {
+                    rangeIndices[k] += range.vertexStart;
+                }
+            }
+        });
+
+        RenderingStats stats{};
+        for (auto const & result : results)
+        {
+            stats.before += result.before;
+            stats.after += result.after;
+            stats.skippedPrimitiveCount += result.skippedPrimitiveCount;
+        }
+        if (stats.skippedPrimitiveCount > 0)
+        {
+            MFA_LOG_WARN(
+                "Skipped %u primitive(s) that are not valid triangle lists while optimizing for rendering",
+                stats.skippedPrimitiveCount
+            );
+        }
+        return stats;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    MeshOptimizer::VertexCacheStats Mesh::AnalyzeVertexCache() const
+    {
+        auto const ranges = CollectPrimitiveRanges(*mData, mVertexCount, mIndexCount);
+        auto const * indices = mIndexData->As<Index>();
+
+        MeshOptimizer::VertexCacheStats stats{};
+        std::vector<Index> rangeIndices{};
+        for (auto const & range : ranges)
+        {
+            rangeIndices.assign(indices + range.indexStart, indices + range.indexStart + range.indexCount);
+            for (auto & index : rangeIndices)
+            {
+                index -= range.vertexStart;
+            }
+            stats += MeshOptimizer::AnalyzeVertexCache(rangeIndices.data(), rangeIndices.size(), range.vertexCount);
+        }
+        return stats;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    VertexMemoryReport Mesh::PackVertices(PackingParams const & params)
+    {
+        auto const ranges = CollectPrimitiveRanges(*mData, mVertexCount, mIndexCount);
+        auto const * vertices = mVertexData->As<Vertex>();
+
+        std::vector<PackedVertices> packedVertices(ranges.size());
+        JobSystem::ParallelFor(static_cast<int>(ranges.size()), 1, [&](int const begin, int const end)->void
+        {
+            for (int i = begin; i < end; ++i)
+            {
+                auto const & range = ranges[i];
+                // A mesh without primitives only has positions that we know of
+                packedVertices[i] = GLTF::PackVertices(
+                    range.primitive != nullptr ? *range.primitive : Primitive{},
+                    vertices + range.vertexStart,
+                    range.vertexCount,
+                    params
+                );
+            }
+        });
+
+        VertexMemoryReport report{};
+        for (auto const & packed : packedVertices)
+        {
+            report += VertexMemoryReport{
+                .vertexCount = packed.vertexCount,
+                .unpackedBytes = packed.vertexCount * sizeof(Vertex),
+                .packedBytes = packed.data->Len()
+            };
+        }
+
+        mPackedVertices = std::move(packedVertices);
+        return report;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::vector<PackedVertices> const & Mesh::GetPackedVertices() const
+    {
+        return mPackedVertices;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void Mesh::SetPackedVertices(std::vector<PackedVertices> packedVertices)
+    {
+        mPackedVertices = std::move(packedVertices);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
     bool Mesh::IsCentered() const noexcept
     {
 	    return mIsCentered;
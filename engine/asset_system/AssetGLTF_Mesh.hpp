@@ -1,6 +1,8 @@
 #pragma once
 
+#include "AssetGLTF_PackedVertex.hpp"
 #include "BedrockMemory.hpp"
+#include "MeshOptimizer.hpp"
 #include "Transform.hpp"
 
 #include <cstdint>
@@ -23,6 +25,18 @@ namespace MFA::Asset::GLTF
 		Invalid = 255
 	};
 
+	// Same values as the gltf primitive mode
+	enum class PrimitiveTopology : uint8_t
+	{
+		Points = 0,
+		Lines = 1,
+		LineLoop = 2,
+		LineStrip = 3,
+		TriangleList = 4,
+		TriangleStrip = 5,
+		TriangleFan = 6
+	};
+
 	using Index = uint32_t;
 
 	struct Vertex
@@ -81,6 +95,8 @@ namespace MFA::Asset::GLTF
 		AlphaMode alphaMode = AlphaMode::Opaque;
 		float alphaCutoff = 0.0f;
 		bool doubleSided = false;                   // TODO How are we supposed to render double sided objects ?
+		// Only triangle lists are welded and optimized for rendering, Other topologies are kept as they are
+		PrimitiveTopology topology = PrimitiveTopology::TriangleList;
 
 		bool hasPositionMinMax = false;
 
@@ -128,6 +144,8 @@ namespace MFA::Asset::GLTF
 
 		explicit Node();
 
+		explicit Node(std::shared_ptr<TransformStore> transformStore);
+
 		std::string name{};
         
         int subMeshIndex = -1;
@@ -167,7 +185,7 @@ namespace MFA::Asset::GLTF
         enum class Interpolation
         {
             Invalid,
-            Linear,                         // We only support linear for now
+            Linear,
             Step,
             CubicSpline
         };
@@ -180,6 +198,9 @@ namespace MFA::Asset::GLTF
             {
                 float input = -1;                           // Input time (Probably in seconds)
                 float output[4]{ 0.0f, 0.0f, 0.0f, 0.0f };  // Output can be from 3 to 4 
+                // Only for cubic spline samplers, In units per second like GLTF stores them
+                float inTangent[4]{ 0.0f, 0.0f, 0.0f, 0.0f };
+                float outTangent[4]{ 0.0f, 0.0f, 0.0f, 0.0f };
             };
             Interpolation interpolation{};
             std::vector<InputAndOutput> inputAndOutput{};
@@ -201,11 +222,24 @@ namespace MFA::Asset::GLTF
 
 	struct MeshData
 	{
+        explicit MeshData();
+
+        ~MeshData();
+
+        // The copy gets a store of its own with new nodes that are linked like the original ones, And primitive
+        // lists that point into its own sub meshes. So changing the copy never changes the original.
+        MeshData(MeshData const & other);
+        MeshData(MeshData && other) noexcept;
+        MeshData & operator= (MeshData const & rhs);
+        MeshData & operator= (MeshData && rhs) noexcept;
+
         std::vector<SubMesh> subMeshes{};
         std::vector<Node> nodes{};
         std::vector<Skin> skins{};
         std::vector<Animation> animations{};
         std::vector<uint32_t> rootNodes{};         // Nodes that have no parent
+        // Shared by the transforms of all nodes, So the hierarchy is updated in one pass
+        std::shared_ptr<TransformStore> transformStore = std::make_shared<TransformStore>();
 
         // We could do this with a T-Pose for more accurate result
         bool hasPositionMinMax = false;
@@ -253,9 +287,9 @@ namespace MFA::Asset::GLTF
 			uint32_t subMeshIndex,
 			Primitive primitive,
 			uint32_t vertexCount,
-			Vertex* vertices,
+			Vertex const * vertices,
 			uint32_t indicesCount,
-			Index * indices
+			Index const * indices
 		);
 
 		[[nodiscard]]
@@ -287,9 +321,38 @@ namespace MFA::Asset::GLTF
 		// Moves the mesh to the origin
 		void CenterMesh();
 
-		// Removes duplicate vertices
+		// Welds the vertices of each primitive that share a position and removes duplicate and degenerate triangles.
+		// Primitives are processed in parallel over the JobSystem. Primitives that are not valid triangle lists are
+		// kept as they are.
 		void Optimize();
 
+		struct RenderingStats
+		{
+			MeshOptimizer::VertexCacheStats before{};
+			MeshOptimizer::VertexCacheStats after{};
+			uint32_t skippedPrimitiveCount = 0;
+		};
+
+		// Reorders the triangles of each primitive for the post transform cache and overdraw, Then reorders the
+		// vertices in the order that the triangles fetch them. Returns the cache statistics before and after.
+		// Primitives that are not valid triangle lists are skipped and counted.
+		RenderingStats OptimizeForRendering(float overdrawThreshold = 1.05f);
+
+		[[nodiscard]]
+		MeshOptimizer::VertexCacheStats AnalyzeVertexCache() const;
+
+		// Packs the vertices of each primitive into a layout that only keeps the attributes that it uses.
+		// The packed streams are meant for gpu upload, The vertex buffer stays untouched for cpu side code.
+		// Anything that changes the vertices afterwards drops the streams, So this runs after the last optimization.
+		VertexMemoryReport PackVertices(PackingParams const & params = {});
+
+		// One entry per primitive in the order of subMeshes and their primitives, Empty if the mesh was not packed
+		[[nodiscard]]
+		std::vector<PackedVertices> const & GetPackedVertices() const;
+
+		// For streams that were packed before, A baked cache for example
+		void SetPackedVertices(std::vector<PackedVertices> packedVertices);
+
 		[[nodiscard]]
 		bool IsCentered() const noexcept;
 
@@ -311,6 +374,8 @@ namespace MFA::Asset::GLTF
 		uint32_t mIndexCount{};
 		std::shared_ptr<Blob> mIndexData{};
 
+		std::vector<PackedVertices> mPackedVertices{};
+
 		bool mIsCentered = false;
 		bool mIsOptimized = false;
 	};
@@ -0,0 +1,431 @@
+#include "AssetGLTF_PackedVertex.hpp"
+
+#include "AssetGLTF_Mesh.hpp"
+#include "BedrockAssert.hpp"
+
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace MFA::Asset::GLTF
+{
+
+    //-------------------------------------------------------------------------------------------------
+
+    namespace
+    {
+        constexpr float UNorm16Max = 65535.0f;
+
+        template<typename T>
+        void Write(uint8_t * destination, T const & value)
+        {
+            std::memcpy(destination, &value, sizeof(T));
+        }
+
+        template<typename T>
+        T Read(uint8_t const * source)
+        {
+            T value{};
+            std::memcpy(&value, source, sizeof(T));
+            return value;
+        }
+
+        void WriteUV(uint8_t * destination, glm::vec2 const & uv)
+        {
+            Write(destination, glm::packHalf2x16(uv));
+        }
+
+        glm::vec2 ReadUV(uint8_t const * source)
+        {
+            return glm::unpackHalf2x16(Read<uint32_t>(source));
+        }
+
+        // Rounds every weight to 8 bit and gives the rounding error to the largest one, So the weights still sum to 1
+        uint32_t PackWeights(float const * weights)
+        {
+            int quantized[4]{};
+            int sum = 0;
+            int largest = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                quantized[i] = static_cast<int>(std::round(std::clamp(weights[i], 0.0f, 1.0f) * 255.0f));
+                sum += quantized[i];
+                if (weights[i] > weights[largest])
+                {
+                    largest = i;
+                }
+            }
+            if (sum > 0)
+            {
+                quantized[largest] = std::clamp(quantized[largest] + 255 - sum, 0, 255);
+            }
+            return static_cast<uint32_t>(quantized[0]) |
+                static_cast<uint32_t>(quantized[1]) << 8 |
+                static_cast<uint32_t>(quantized[2]) << 16 |
+                static_cast<uint32_t>(quantized[3]) << 24;
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    uint32_t VertexFormatSize(VertexFormat const format)
+    {
+        switch (format)
+        {
+        case VertexFormat::Float32x3:
+            return 12;
+        case VertexFormat::UNorm16x4:
+        case VertexFormat::UInt16x4:
+            return 8;
+        case VertexFormat::Octahedral16x2:
+        case VertexFormat::Half16x2:
+        case VertexFormat::UInt8x4:
+        case VertexFormat::UNorm8x4:
+            return 4;
+        }
+        MFA_ASSERT(false);
+        return 0;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    PackedVertexLayout::Element const * PackedVertexLayout::Find(VertexAttribute const attribute) const
+    {
+        for (auto const & element : elements)
+        {
+            if (element.attribute == attribute)
+            {
+                return &element;
+            }
+        }
+        return nullptr;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    float VertexMemoryReport::CompressionRatio() const
+    {
+        return packedBytes > 0 ? static_cast<float>(unpackedBytes) / static_cast<float>(packedBytes) : 0.0f;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    VertexMemoryReport & VertexMemoryReport::operator += (VertexMemoryReport const & other)
+    {
+        vertexCount += other.vertexCount;
+        unpackedBytes += other.unpackedBytes;
+        packedBytes += other.packedBytes;
+        return *this;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    PackedVertexLayout ChooseVertexLayout(
+        Primitive const & primitive,
+        Vertex const * vertices,
+        uint32_t const vertexCount,
+        PackingParams const & params
+    )
+    {
+        PackedVertexLayout layout{};
+
+        auto const addElement = [&layout](VertexAttribute const attribute, VertexFormat const format)->void
+        {
+            layout.elements.emplace_back(PackedVertexLayout::Element{
+                .attribute = attribute,
+                .format = format,
+                .offset = layout.stride
+            });
+            layout.stride += VertexFormatSize(format);
+        };
+
+        if (params.quantizePositions == true && vertexCount > 0)
+        {
+            glm::vec3 minimum = vertices[0].position;
+            glm::vec3 maximum = vertices[0].position;
+            for (uint32_t i = 1; i < vertexCount; ++i)
+            {
+                minimum = glm::min(minimum, vertices[i].position);
+                maximum = glm::max(maximum, vertices[i].position);
+            }
+            layout.positionOffset = minimum;
+            layout.positionScale = (maximum - minimum) / UNorm16Max;
+            addElement(VertexAttribute::Position, VertexFormat::UNorm16x4);
+        }
+        else
+        {
+            addElement(VertexAttribute::Position, VertexFormat::Float32x3);
+        }
+
+        if (primitive.hasNormalBuffer == true)
+        {
+            addElement(VertexAttribute::Normal, VertexFormat::Octahedral16x2);
+        }
+        if (primitive.hasTangentBuffer == true)
+        {
+            addElement(VertexAttribute::Tangent, VertexFormat::Octahedral16x2);
+        }
+        if (primitive.hasBaseColorTexture == true)
+        {
+            addElement(VertexAttribute::BaseColorUV, VertexFormat::Half16x2);
+        }
+        if (primitive.hasNormalTexture == true)
+        {
+            addElement(VertexAttribute::NormalMapUV, VertexFormat::Half16x2);
+        }
+        // A combined metallic roughness texture samples both channels with its own uvs, Separate textures can
+        // have different uv sets, So each one keeps its own stream
+        if (primitive.hasMetallicRoughnessTexture == true || primitive.hasMetallicTexture == true)
+        {
+            addElement(VertexAttribute::MetallicUV, VertexFormat::Half16x2);
+        }
+        if (primitive.hasMetallicRoughnessTexture == true || primitive.hasRoughnessTexture == true)
+        {
+            addElement(VertexAttribute::RoughnessUV, VertexFormat::Half16x2);
+        }
+        if (primitive.hasEmissiveTexture == true)
+        {
+            addElement(VertexAttribute::EmissionUV, VertexFormat::Half16x2);
+        }
+        if (primitive.hasOcclusionTexture == true)
+        {
+            addElement(VertexAttribute::OcclusionUV, VertexFormat::Half16x2);
+        }
+
+        if (primitive.hasSkin == true)
+        {
+            int maxJoint = 0;
+            for (uint32_t i = 0; i < vertexCount; ++i)
+            {
+                for (auto const joint : vertices[i].jointIndices)
+                {
+                    MFA_ASSERT(joint >= 0 && joint <= std::numeric_limits<uint16_t>::max());
+                    maxJoint = std::max(maxJoint, joint);
+                }
+            }
+            addElement(
+                VertexAttribute::Joints,
+                maxJoint <= std::numeric_limits<uint8_t>::max() ? VertexFormat::UInt8x4 : VertexFormat::UInt16x4
+            );
+            addElement(VertexAttribute::Weights, VertexFormat::UNorm8x4);
+        }
+
+        return layout;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    PackedVertices PackVertices(
+        Primitive const & primitive,
+        Vertex const * vertices,
+        uint32_t const vertexCount,
+        PackingParams const & params
+    )
+    {
+        PackedVertices result{};
+        result.layout = ChooseVertexLayout(primitive, vertices, vertexCount, params);
+        result.vertexCount = vertexCount;
+        result.data = Memory::AllocSize(static_cast<size_t>(result.layout.stride) * vertexCount);
+
+        auto const & layout = result.layout;
+        auto * packed = result.data->Ptr();
+        for (uint32_t i = 0; i < vertexCount; ++i, packed += layout.stride)
+        {
+            auto const & vertex = vertices[i];
+            for (auto const & element : layout.elements)
+            {
+                auto * destination = packed + element.offset;
+                switch (element.attribute)
+                {
+                case VertexAttribute::Position:
+                    if (element.format == VertexFormat::UNorm16x4)
+                    {
+                        auto const & scale = layout.positionScale;
+                        glm::vec3 const normalized{
+                            scale.x > 0.0f ? (vertex.position.x - layout.positionOffset.x) / (scale.x * UNorm16Max) : 0.0f,
+                            scale.y > 0.0f ? (vertex.position.y - layout.positionOffset.y) / (scale.y * UNorm16Max) : 0.0f,
+                            scale.z > 0.0f ? (vertex.position.z - layout.positionOffset.z) / (scale.z * UNorm16Max) : 0.0f
+                        };
+                        Write(destination, glm::packUnorm4x16(glm::vec4{normalized, 0.0f}));
+                    }
+                    else
+                    {
+                        Write(destination, vertex.position);
+                    }
+                    break;
+                case VertexAttribute::Normal:
+                    Write(destination, EncodeOctahedral(vertex.normal));
+                    break;
+                case VertexAttribute::Tangent:
+                    Write(destination, EncodeOctahedral(vertex.tangent));
+                    break;
+                case VertexAttribute::BaseColorUV:
+                    WriteUV(destination, vertex.baseColorUV);
+                    break;
+                case VertexAttribute::NormalMapUV:
+                    WriteUV(destination, vertex.normalMapUV);
+                    break;
+                case VertexAttribute::MetallicUV:
+                    WriteUV(destination, vertex.metallicUV);
+                    break;
+                case VertexAttribute::RoughnessUV:
+                    WriteUV(destination, vertex.roughnessUV);
+                    break;
+                case VertexAttribute::EmissionUV:
+                    WriteUV(destination, vertex.emissionUV);
+                    break;
+                case VertexAttribute::OcclusionUV:
+                    WriteUV(destination, vertex.occlusionUV);
+                    break;
+                case VertexAttribute::Joints:
+                    if (element.format == VertexFormat::UInt8x4)
+                    {
+                        uint8_t const joints[4]{
+                            static_cast<uint8_t>(vertex.jointIndices[0]),
+                            static_cast<uint8_t>(vertex.jointIndices[1]),
+                            static_cast<uint8_t>(vertex.jointIndices[2]),
+                            static_cast<uint8_t>(vertex.jointIndices[3])
+                        };
+                        Write(destination, joints);
+                    }
+                    else
+                    {
+                        uint16_t const joints[4]{
+                            static_cast<uint16_t>(vertex.jointIndices[0]),
+                            static_cast<uint16_t>(vertex.jointIndices[1]),
+                            static_cast<uint16_t>(vertex.jointIndices[2]),
+                            static_cast<uint16_t>(vertex.jointIndices[3])
+                        };
+                        Write(destination, joints);
+                    }
+                    break;
+                case VertexAttribute::Weights:
+                    Write(destination, PackWeights(vertex.jointWeights));
+                    break;
+                default:
+                    MFA_ASSERT(false);
+                    break;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    Vertex UnpackVertex(PackedVertexLayout const & layout, uint8_t const * packedVertex)
+    {
+        Vertex vertex{};
+        for (auto const & element : layout.elements)
+        {
+            auto const * source = packedVertex + element.offset;
+            switch (element.attribute)
+            {
+            case VertexAttribute::Position:
+                vertex.position = UnpackPosition(layout, packedVertex);
+                break;
+            case VertexAttribute::Normal:
+                vertex.normal = DecodeOctahedral(Read<uint32_t>(source));
+                break;
+            case VertexAttribute::Tangent:
+                vertex.tangent = DecodeOctahedral(Read<uint32_t>(source));
+                break;
+            case VertexAttribute::BaseColorUV:
+                vertex.baseColorUV = ReadUV(source);
+                break;
+            case VertexAttribute::NormalMapUV:
+                vertex.normalMapUV = ReadUV(source);
+                break;
+            case VertexAttribute::MetallicUV:
+                vertex.metallicUV = ReadUV(source);
+                break;
+            case VertexAttribute::RoughnessUV:
+                vertex.roughnessUV = ReadUV(source);
+                break;
+            case VertexAttribute::EmissionUV:
+                vertex.emissionUV = ReadUV(source);
+                break;
+            case VertexAttribute::OcclusionUV:
+                vertex.occlusionUV = ReadUV(source);
+                break;
+            case VertexAttribute::Joints:
+                vertex.hasSkin = 1;
+                for (int i = 0; i < 4; ++i)
+                {
+                    vertex.jointIndices[i] = element.format == VertexFormat::UInt8x4
+                        ? static_cast<int>(source[i])
+                        : static_cast<int>(Read<uint16_t>(source + i * sizeof(uint16_t)));
+                }
+                break;
+            case VertexAttribute::Weights:
+            {
+                auto const weights = glm::unpackUnorm4x8(Read<uint32_t>(source));
+                for (int i = 0; i < 4; ++i)
+                {
+                    vertex.jointWeights[i] = weights[i];
+                }
+                break;
+            }
+            default:
+                MFA_ASSERT(false);
+                break;
+            }
+        }
+        return vertex;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    glm::vec3 UnpackPosition(PackedVertexLayout const & layout, uint8_t const * packedVertex)
+    {
+        auto const * element = layout.Find(VertexAttribute::Position);
+        MFA_ASSERT(element != nullptr);
+        auto const * source = packedVertex + element->offset;
+        if (element->format == VertexFormat::UNorm16x4)
+        {
+            auto const normalized = glm::vec3{glm::unpackUnorm4x16(Read<uint64_t>(source))};
+            return layout.positionOffset + normalized * UNorm16Max * layout.positionScale;
+        }
+        return Read<glm::vec3>(source);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Cigolle et al. "A Survey of Efficient Representations for Independent Unit Vectors"
+    uint32_t EncodeOctahedral(glm::vec3 const & direction)
+    {
+        float const length = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+        if (length <= 0.0f)
+        {
+            return glm::packSnorm2x16(glm::vec2{0.0f, 0.0f});
+        }
+        glm::vec3 const n = direction / length;
+        glm::vec2 encoded{n.x, n.y};
+        if (n.z < 0.0f)
+        {
+            encoded = glm::vec2{
+                (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+                (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f)
+            };
+        }
+        return glm::packSnorm2x16(encoded);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    glm::vec3 DecodeOctahedral(uint32_t const encoded)
+    {
+        auto const e = glm::unpackSnorm2x16(encoded);
+        glm::vec3 n{e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y)};
+        float const t = std::max(-n.z, 0.0f);
+        n.x += n.x >= 0.0f ? -t : t;
+        n.y += n.y >= 0.0f ? -t : t;
+        return glm::normalize(n);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "BedrockMemory.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Compact vertex streams that only contain what a primitive uses. The layout is chosen per primitive:
+// Quantized positions, Octahedral normals and tangents, Half float uvs, 8 or 16 bit joints and unorm weights.
+namespace MFA::Asset::GLTF
+{
+
+    struct Vertex;
+    struct Primitive;
+
+    enum class VertexAttribute : uint8_t
+    {
+        Position,
+        Normal,
+        Tangent,
+        BaseColorUV,
+        NormalMapUV,
+        MetallicUV,
+        RoughnessUV,
+        EmissionUV,
+        OcclusionUV,
+        Joints,
+        Weights,
+        Count
+    };
+
+    enum class VertexFormat : uint8_t
+    {
+        Float32x3,
+        UNorm16x4,                          // Positions relative to the primitive bounds, W is padding
+        Octahedral16x2,                     // Unit vectors as two snorm16
+        Half16x2,
+        UInt8x4,
+        UInt16x4,
+        UNorm8x4                            // Has to stay the last one, The cache rejects any format after it
+    };
+
+    [[nodiscard]]
+    uint32_t VertexFormatSize(VertexFormat format);
+
+    struct PackedVertexLayout
+    {
+        struct Element
+        {
+            VertexAttribute attribute = VertexAttribute::Count;
+            VertexFormat format = VertexFormat::Float32x3;
+            uint32_t offset = 0;
+        };
+
+        std::vector<Element> elements{};
+        uint32_t stride = 0;
+
+        // Quantized positions decode as positionOffset + value * positionScale
+        glm::vec3 positionOffset{};
+        glm::vec3 positionScale{1.0f};
+
+        [[nodiscard]]
+        Element const * Find(VertexAttribute attribute) const;
+    };
+
+    struct PackedVertices
+    {
+        PackedVertexLayout layout{};
+        uint32_t vertexCount = 0;
+        std::shared_ptr<Blob> data{};
+    };
+
+    struct PackingParams
+    {
+        // Costs up to half a step of 1/65535 of the primitive size
+        bool quantizePositions = true;
+    };
+
+    struct VertexMemoryReport
+    {
+        size_t vertexCount = 0;
+        size_t unpackedBytes = 0;
+        size_t packedBytes = 0;
+
+        [[nodiscard]]
+        float CompressionRatio() const;
+
+        VertexMemoryReport & operator += (VertexMemoryReport const & other);
+    };
+
+    [[nodiscard]]
+    PackedVertexLayout ChooseVertexLayout(
+        Primitive const & primitive,
+        Vertex const * vertices,
+        uint32_t vertexCount,
+        PackingParams const & params = {}
+    );
+
+    [[nodiscard]]
+    PackedVertices PackVertices(
+        Primitive const & primitive,
+        Vertex const * vertices,
+        uint32_t vertexCount,
+        PackingParams const & params = {}
+    );
+
+    // Attributes that are not in the layout stay zero
+    [[nodiscard]]
+    Vertex UnpackVertex(PackedVertexLayout const & layout, uint8_t const * packedVertex);
+
+    [[nodiscard]]
+    glm::vec3 UnpackPosition(PackedVertexLayout const & layout, uint8_t const * packedVertex);
+
+    [[nodiscard]]
+    uint32_t EncodeOctahedral(glm::vec3 const & direction);
+
+    [[nodiscard]]
+    glm::vec3 DecodeOctahedral(uint32_t encoded);
+
+}
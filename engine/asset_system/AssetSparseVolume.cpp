@@ -0,0 +1,492 @@
+#include "AssetSparseVolume.hpp"
+
+#include "BedrockAssert.hpp"
+#include "JobSystem.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace MFA::Asset
+{
+
+    //-------------------------------------------------------------------------------------------------
+
+    namespace
+    {
+        constexpr uint32_t BrickShift = 3;
+        constexpr uint32_t BrickMask = SparseVolume::BrickSize - 1;
+        static_assert(1u << BrickShift == SparseVolume::BrickSize);
+
+        glm::uvec3 BrickGridDimensions(SparseVolume::Dimensions const & dimensions)
+        {
+            return glm::uvec3{
+                (dimensions.width + BrickMask) >> BrickShift,
+                (dimensions.height + BrickMask) >> BrickShift,
+                (dimensions.depth + BrickMask) >> BrickShift
+            };
+        }
+
+        // Entry and exit distances of the ray in the box, Entry is larger than exit when it misses
+        void IntersectBox(
+            glm::vec3 const & origin,
+            glm::vec3 const & direction,
+            glm::vec3 const & boxMin,
+            glm::vec3 const & boxMax,
+            float & outEntry,
+            float & outExit
+        )
+        {
+            outEntry = -std::numeric_limits<float>::max();
+            outExit = std::numeric_limits<float>::max();
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (direction[axis] == 0.0f)
+                {
+                    if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis])
+                    {
+                        outEntry = 1.0f;
+                        outExit = 0.0f;
+                        return;
+                    }
+                    continue;
+                }
+                float const inverse = 1.0f / direction[axis];
+                float near = (boxMin[axis] - origin[axis]) * inverse;
+                float far = (boxMax[axis] - origin[axis]) * inverse;
+                if (near > far)
+                {
+                    std::swap(near, far);
+                }
+                outEntry = std::max(outEntry, near);
+                outExit = std::min(outExit, far);
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<SparseVolume> SparseVolume::BuildFromDense(
+        uint8_t const * voxels,
+        Dimensions const & dimensions,
+        uint32_t const componentCount,
+        uint32_t const component,
+        uint8_t const emptyThreshold
+    )
+    {
+        MFA_ASSERT(voxels != nullptr);
+        MFA_ASSERT(component < componentCount);
+
+        auto volume = std::make_shared<SparseVolume>(dimensions);
+        auto const & gridDimensions = volume->mBrickGridDimensions;
+        size_t const brickCount = volume->mBrickGrid.size();
+
+        // Visits the voxels of a brick in brick order, Voxels past the end of the volume are 0
+        auto const forEachVoxel = [&](glm::uvec3 const & brick, auto const & callback)->void
+        {
+            glm::uvec3 const begin = brick * BrickSize;
+            for (uint32_t z = 0; z < BrickSize; ++z)
+            {
+                for (uint32_t y = 0; y < BrickSize; ++y)
+                {
+                    for (uint32_t x = 0; x < BrickSize; ++x)
+                    {
+                        glm::uvec3 const voxel = begin + glm::uvec3{x, y, z};
+                        uint8_t value = 0;
+                        if (voxel.x < dimensions.width && voxel.y < dimensions.height && voxel.z < dimensions.depth)
+                        {
+                            auto const index = (static_cast<size_t>(voxel.z) * dimensions.height + voxel.y) * dimensions.width + voxel.x;
+                            value = voxels[index * componentCount + component];
+                        }
+                        callback((z * BrickSize + y) * BrickSize + x, value);
+                    }
+                }
+            }
+        };
+
+        // Ranges of every brick first, So the stored bricks can be packed in grid order
+        std::vector<Range> brickRanges(brickCount);
+        JobSystem::ParallelFor(static_cast<int>(gridDimensions.z), 1, [&](int const begin, int const end)->void
+        {
+            for (auto z = static_cast<uint32_t>(begin); z < static_cast<uint32_t>(end); ++z)
+            {
+                for (uint32_t y = 0; y < gridDimensions.y; ++y)
+                {
+                    for (uint32_t x = 0; x < gridDimensions.x; ++x)
+                    {
+                        glm::uvec3 const brick{x, y, z};
+                        Range range{.min = UINT8_MAX, .max = 0};
+                        forEachVoxel(brick, [&range](uint32_t, uint8_t const value)->void
+                        {
+                            range.min = std::min(range.min, value);
+                            range.max = std::max(range.max, value);
+                        });
+                        brickRanges[volume->BrickGridIndex(brick)] = range;
+                    }
+                }
+            }
+        });
+
+        uint32_t occupiedCount = 0;
+        for (size_t i = 0; i < brickCount; ++i)
+        {
+            if (brickRanges[i].max > emptyThreshold)
+            {
+                volume->mBrickGrid[i] = occupiedCount++;
+            }
+        }
+
+        volume->mBricks.resize(static_cast<size_t>(occupiedCount) * BrickVoxelCount);
+        JobSystem::ParallelFor(static_cast<int>(gridDimensions.z), 1, [&](int const begin, int const end)->void
+        {
+            for (auto z = static_cast<uint32_t>(begin); z < static_cast<uint32_t>(end); ++z)
+            {
+                for (uint32_t y = 0; y < gridDimensions.y; ++y)
+                {
+                    for (uint32_t x = 0; x < gridDimensions.x; ++x)
+                    {
+                        glm::uvec3 const brick{x, y, z};
+                        auto const brickIndex = volume->mBrickGrid[volume->BrickGridIndex(brick)];
+                        if (brickIndex == EmptyBrick)
+                        {
+                            continue;
+                        }
+                        auto * brickVoxels = volume->mBricks.data() + static_cast<size_t>(brickIndex) * BrickVoxelCount;
+                        forEachVoxel(brick, [brickVoxels](uint32_t const index, uint8_t const value)->void
+                        {
+                            brickVoxels[index] = value;
+                        });
+                    }
+                }
+            }
+        });
+
+        // Trilinear samples inside a brick also read the voxels around it, So the ranges include a one voxel border.
+        // That way Sample returns 0 everywhere in the space that SkipEmptySpace skips.
+        JobSystem::ParallelFor(static_cast<int>(gridDimensions.z), 1, [&](int const begin, int const end)->void
+        {
+            for (auto z = static_cast<uint32_t>(begin); z < static_cast<uint32_t>(end); ++z)
+            {
+                for (uint32_t y = 0; y < gridDimensions.y; ++y)
+                {
+                    for (uint32_t x = 0; x < gridDimensions.x; ++x)
+                    {
+                        glm::ivec3 const first = glm::ivec3{x, y, z} * static_cast<int>(BrickSize) - 1;
+                        glm::ivec3 const last = first + static_cast<int>(BrickSize) + 1;
+                        Range range{.min = UINT8_MAX, .max = 0};
+                        for (int voxelZ = first.z; voxelZ <= last.z; ++voxelZ)
+                        {
+                            for (int voxelY = first.y; voxelY <= last.y; ++voxelY)
+                            {
+                                for (int voxelX = first.x; voxelX <= last.x; ++voxelX)
+                                {
+                                    auto const value = volume->GetVoxel(voxelX, voxelY, voxelZ);
+                                    range.min = std::min(range.min, value);
+                                    range.max = std::max(range.max, value);
+                                }
+                            }
+                        }
+                        brickRanges[volume->BrickGridIndex(glm::uvec3{x, y, z})] = range;
+                    }
+                }
+            }
+        });
+
+        volume->mLevels.emplace_back(Level{.dimensions = gridDimensions, .ranges = std::move(brickRanges)});
+        volume->BuildHierarchy();
+        return volume;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<SparseVolume> SparseVolume::BuildFromTexture(
+        Texture const & texture,
+        uint32_t const component,
+        uint8_t const emptyThreshold
+    )
+    {
+        MFA_ASSERT(Texture::IsBlockCompressed(texture.GetFormat()) == false);
+        auto const & info = Texture::FormatInfo(texture.GetFormat());
+        MFA_ASSERT(info.bits_total == info.component_count * 8);
+        auto const & buffer = texture.GetMipmapBuffer(0);
+        MFA_ASSERT(buffer != nullptr);
+        return BuildFromDense(
+            buffer->As<uint8_t>(),
+            texture.GetMipmapDimension(0),
+            info.component_count,
+            component,
+            emptyThreshold
+        );
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    SparseVolume::SparseVolume(Dimensions const & dimensions)
+        : mDimensions(dimensions)
+        , mBrickGridDimensions(BrickGridDimensions(dimensions))
+    {
+        MFA_ASSERT(dimensions.width > 0 && dimensions.height > 0 && dimensions.depth > 0);
+        mBrickGrid.resize(
+            static_cast<size_t>(mBrickGridDimensions.x) * mBrickGridDimensions.y * mBrickGridDimensions.z,
+            EmptyBrick
+        );
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    SparseVolume::~SparseVolume() = default;
+
+    //-------------------------------------------------------------------------------------------------
+
+    uint8_t SparseVolume::GetVoxel(int const x, int const y, int const z) const
+    {
+        if (x < 0 || y < 0 || z < 0 ||
+            static_cast<uint32_t>(x) >= mDimensions.width ||
+            static_cast<uint32_t>(y) >= mDimensions.height ||
+            static_cast<uint32_t>(z) >= mDimensions.depth)
+        {
+            return 0;
+        }
+        glm::uvec3 const voxel{x, y, z};
+        auto const brickIndex = mBrickGrid[BrickGridIndex(voxel >> BrickShift)];
+        if (brickIndex == EmptyBrick)
+        {
+            return 0;
+        }
+        glm::uvec3 const local = voxel & BrickMask;
+        return mBricks[static_cast<size_t>(brickIndex) * BrickVoxelCount + (local.z * BrickSize + local.y) * BrickSize + local.x];
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    float SparseVolume::Sample(glm::vec3 const & position) const
+    {
+        glm::vec3 const coordinate = position - 0.5f;
+        glm::vec3 const floor = glm::floor(coordinate);
+        glm::vec3 const fraction = coordinate - floor;
+        glm::ivec3 const voxel{floor};
+
+        float corners[8];
+        // Most lookups have all eight voxels in the same brick, So the grid is read once for them
+        glm::ivec3 const local = voxel & static_cast<int>(BrickMask);
+        if (glm::all(glm::greaterThanEqual(voxel, glm::ivec3{0})) &&
+            static_cast<uint32_t>(voxel.x) + 1 < mDimensions.width &&
+            static_cast<uint32_t>(voxel.y) + 1 < mDimensions.height &&
+            static_cast<uint32_t>(voxel.z) + 1 < mDimensions.depth &&
+            glm::all(glm::lessThan(local, glm::ivec3{static_cast<int>(BrickMask)})))
+        {
+            auto const brickIndex = mBrickGrid[BrickGridIndex(glm::uvec3{voxel} >> BrickShift)];
+            if (brickIndex == EmptyBrick)
+            {
+                return 0.0f;
+            }
+            auto const * brick = mBricks.data() + static_cast<size_t>(brickIndex) * BrickVoxelCount;
+            for (int corner = 0; corner < 8; ++corner)
+            {
+                auto const x = local.x + (corner & 1);
+                auto const y = local.y + ((corner >> 1) & 1);
+                auto const z = local.z + (corner >> 2);
+                corners[corner] = brick[(z * BrickSize + y) * BrickSize + x];
+            }
+        }
+        else
+        {
+            for (int corner = 0; corner < 8; ++corner)
+            {
+                corners[corner] = GetVoxel(voxel.x + (corner & 1), voxel.y + ((corner >> 1) & 1), voxel.z + (corner >> 2));
+            }
+        }
+
+        float const near = glm::mix(
+            glm::mix(corners[0], corners[1], fraction.x),
+            glm::mix(corners[2], corners[3], fraction.x),
+            fraction.y
+        );
+        float const far = glm::mix(
+            glm::mix(corners[4], corners[5], fraction.x),
+            glm::mix(corners[6], corners[7], fraction.x),
+            fraction.y
+        );
+        return glm::mix(near, far, fraction.z) * (1.0f / 255.0f);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    float SparseVolume::SkipEmptySpace(
+        glm::vec3 const & origin,
+        glm::vec3 const & direction,
+        float const startDistance,
+        float const endDistance,
+        uint8_t const minDensity
+    ) const
+    {
+        // Samples up to half a voxel outside of the volume still read its border voxels
+        glm::vec3 const volumeMax{mDimensions.width, mDimensions.height, mDimensions.depth};
+        float entry, exit;
+        IntersectBox(origin, direction, glm::vec3{-0.5f}, volumeMax + 0.5f, entry, exit);
+        float distance = std::max(startDistance, entry);
+        float const end = std::min(endDistance, exit);
+
+        auto const topLevel = static_cast<int>(mLevels.size()) - 1;
+        while (distance < end)
+        {
+            glm::vec3 const position = origin + direction * distance;
+
+            // The coarsest empty cell that contains the position is the largest step that is safe to take
+            int emptyLevel = -1;
+            glm::uvec3 emptyCell{};
+            for (int level = topLevel; level >= 0; --level)
+            {
+                auto const & levelData = mLevels[level];
+                float const cellSize = static_cast<float>(BrickSize << level);
+                glm::uvec3 const cell = glm::min(
+                    glm::uvec3{glm::max(position / cellSize, glm::vec3{0.0f})},
+                    levelData.dimensions - 1u
+                );
+                auto const & range = levelData.ranges[
+                    (static_cast<size_t>(cell.z) * levelData.dimensions.y + cell.y) * levelData.dimensions.x + cell.x
+                ];
+                if (range.max <= minDensity)
+                {
+                    emptyLevel = level;
+                    emptyCell = cell;
+                    break;
+                }
+            }
+            if (emptyLevel < 0)
+            {
+                return distance;
+            }
+
+            float const cellSize = static_cast<float>(BrickSize << emptyLevel);
+            glm::vec3 cellMin = glm::vec3{emptyCell} * cellSize;
+            glm::vec3 cellMax = cellMin + cellSize;
+            // Cells at the border also own the half voxel outside of the volume
+            auto const & levelDimensions = mLevels[emptyLevel].dimensions;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (emptyCell[axis] == 0)
+                {
+                    cellMin[axis] = -1.0f;
+                }
+                if (emptyCell[axis] + 1 == levelDimensions[axis])
+                {
+                    cellMax[axis] = std::max(cellMax[axis], volumeMax[axis] + 1.0f);
+                }
+            }
+            float cellEntry, cellExit;
+            IntersectBox(origin, direction, cellMin, cellMax, cellEntry, cellExit);
+            // Nudged past the boundary so the next lookup lands in the neighbour cell
+            distance = std::max(cellExit, distance) + cellSize * 1e-4f;
+        }
+        return endDistance;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    SparseVolume::Dimensions const & SparseVolume::GetDimensions() const noexcept
+    {
+        return mDimensions;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    uint8_t SparseVolume::GetLevelCount() const noexcept
+    {
+        return static_cast<uint8_t>(mLevels.size());
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    glm::uvec3 SparseVolume::GetLevelDimensions(uint8_t const level) const
+    {
+        MFA_ASSERT(level < mLevels.size());
+        return mLevels[level].dimensions;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    SparseVolume::Range SparseVolume::GetRange(uint8_t const level, glm::uvec3 const & cell) const
+    {
+        MFA_ASSERT(level < mLevels.size());
+        auto const & levelData = mLevels[level];
+        MFA_ASSERT(glm::all(glm::lessThan(cell, levelData.dimensions)));
+        return levelData.ranges[(static_cast<size_t>(cell.z) * levelData.dimensions.y + cell.y) * levelData.dimensions.x + cell.x];
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    uint32_t SparseVolume::GetBrickIndex(glm::uvec3 const & brick) const
+    {
+        MFA_ASSERT(glm::all(glm::lessThan(brick, mBrickGridDimensions)));
+        return mBrickGrid[BrickGridIndex(brick)];
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    SparseVolume::MemoryReport SparseVolume::GetMemoryReport() const
+    {
+        MemoryReport report{};
+        report.denseBytes = static_cast<size_t>(mDimensions.width) * mDimensions.height * mDimensions.depth;
+        report.brickBytes = mBricks.size();
+        report.gridBytes = mBrickGrid.size() * sizeof(uint32_t);
+        for (auto const & level : mLevels)
+        {
+            report.hierarchyBytes += level.ranges.size() * sizeof(Range);
+        }
+        report.totalBytes = report.brickBytes + report.gridBytes + report.hierarchyBytes;
+        report.brickCount = static_cast<uint32_t>(mBrickGrid.size());
+        report.occupiedBrickCount = static_cast<uint32_t>(mBricks.size() / BrickVoxelCount);
+        return report;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    size_t SparseVolume::BrickGridIndex(glm::uvec3 const & brick) const
+    {
+        return (static_cast<size_t>(brick.z) * mBrickGridDimensions.y + brick.y) * mBrickGridDimensions.x + brick.x;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void SparseVolume::BuildHierarchy()
+    {
+        MFA_ASSERT(mLevels.size() == 1);
+        while (glm::any(glm::greaterThan(mLevels.back().dimensions, glm::uvec3{1})))
+        {
+            auto const & previous = mLevels.back();
+            Level level{};
+            level.dimensions = (previous.dimensions + 1u) / 2u;
+            level.ranges.resize(static_cast<size_t>(level.dimensions.x) * level.dimensions.y * level.dimensions.z);
+            for (uint32_t z = 0; z < level.dimensions.z; ++z)
+            {
+                for (uint32_t y = 0; y < level.dimensions.y; ++y)
+                {
+                    for (uint32_t x = 0; x < level.dimensions.x; ++x)
+                    {
+                        Range range{.min = UINT8_MAX, .max = 0};
+                        for (uint32_t child = 0; child < 8; ++child)
+                        {
+                            glm::uvec3 const childCell = glm::uvec3{x, y, z} * 2u +
+                                glm::uvec3{child & 1, (child >> 1) & 1, child >> 2};
+                            if (glm::any(glm::greaterThanEqual(childCell, previous.dimensions)))
+                            {
+                                continue;
+                            }
+                            auto const & childRange = previous.ranges[
+                                (static_cast<size_t>(childCell.z) * previous.dimensions.y + childCell.y) * previous.dimensions.x + childCell.x
+                            ];
+                            range.min = std::min(range.min, childRange.min);
+                            range.max = std::max(range.max, childRange.max);
+                        }
+                        level.ranges[(static_cast<size_t>(z) * level.dimensions.y + y) * level.dimensions.x + x] = range;
+                    }
+                }
+            }
+            mLevels.emplace_back(std::move(level));
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
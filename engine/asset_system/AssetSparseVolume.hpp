@@ -0,0 +1,138 @@
+#pragma once
+
+#include "AssetTexture.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace MFA::Asset
+{
+
+    // Single channel 8 bit density volume that only stores the bricks with something in them. A top level grid maps every
+    // brick to its data (Or marks it as empty) and a min/max hierarchy over the bricks lets ray marchers skip large
+    // empty regions with a few lookups. Voxels of empty bricks read as 0.
+    // The volume is immutable once it is built, So it can be read from any thread.
+    class SparseVolume final
+    {
+    public:
+
+        // Voxels along each axis of a brick
+        static constexpr uint32_t BrickSize = 8;
+        static constexpr uint32_t BrickVoxelCount = BrickSize * BrickSize * BrickSize;
+        static constexpr uint32_t EmptyBrick = UINT32_MAX;
+
+        using Dimensions = Texture::Dimensions;
+
+        struct Range
+        {
+            uint8_t min = 0;
+            uint8_t max = 0;
+        };
+
+        struct MemoryReport
+        {
+            // What the same volume takes as a dense grid
+            size_t denseBytes = 0;
+            size_t brickBytes = 0;
+            size_t gridBytes = 0;
+            size_t hierarchyBytes = 0;
+            size_t totalBytes = 0;
+            uint32_t brickCount = 0;
+            uint32_t occupiedBrickCount = 0;
+        };
+
+        // Reads one component of a dense grid with componentCount interleaved components per voxel, X changes fastest.
+        // Bricks whose voxels are all at or below emptyThreshold are not stored.
+        [[nodiscard]]
+        static std::shared_ptr<SparseVolume> BuildFromDense(
+            uint8_t const * voxels,
+            Dimensions const & dimensions,
+            uint32_t componentCount = 1,
+            uint32_t component = 0,
+            uint8_t emptyThreshold = 0
+        );
+
+        // Mip 0 of an uncompressed 8 bit volume texture
+        [[nodiscard]]
+        static std::shared_ptr<SparseVolume> BuildFromTexture(
+            Texture const & texture,
+            uint32_t component = 0,
+            uint8_t emptyThreshold = 0
+        );
+
+        explicit SparseVolume(Dimensions const & dimensions);
+
+        ~SparseVolume();
+
+        SparseVolume(SparseVolume const &) noexcept = delete;
+        SparseVolume(SparseVolume &&) noexcept = delete;
+        SparseVolume & operator= (SparseVolume const & rhs) noexcept = delete;
+        SparseVolume & operator= (SparseVolume && rhs) noexcept = delete;
+
+        // 0 outside of the volume
+        [[nodiscard]]
+        uint8_t GetVoxel(int x, int y, int z) const;
+
+        // Trilinear filtering in [0, 1], Position is in voxels and voxel centers are at i + 0.5
+        [[nodiscard]]
+        float Sample(glm::vec3 const & position) const;
+
+        // Distance along the ray (In voxels, Direction does not have to be normalized) where the first brick with a
+        // density above minDensity starts, Searching from startDistance. Returns endDistance when there is none.
+        [[nodiscard]]
+        float SkipEmptySpace(
+            glm::vec3 const & origin,
+            glm::vec3 const & direction,
+            float startDistance,
+            float endDistance,
+            uint8_t minDensity = 0
+        ) const;
+
+        [[nodiscard]]
+        Dimensions const & GetDimensions() const noexcept;
+
+        // Level 0 has one cell per brick, Every level above halves it until a single cell covers the whole volume
+        [[nodiscard]]
+        uint8_t GetLevelCount() const noexcept;
+
+        [[nodiscard]]
+        glm::uvec3 GetLevelDimensions(uint8_t level) const;
+
+        // Covers every voxel that a trilinear sample inside the cell can read
+        [[nodiscard]]
+        Range GetRange(uint8_t level, glm::uvec3 const & cell) const;
+
+        // EmptyBrick for the bricks that are not stored
+        [[nodiscard]]
+        uint32_t GetBrickIndex(glm::uvec3 const & brick) const;
+
+        [[nodiscard]]
+        MemoryReport GetMemoryReport() const;
+
+    private:
+
+        struct Level
+        {
+            glm::uvec3 dimensions{};
+            std::vector<Range> ranges{};
+        };
+
+        [[nodiscard]]
+        size_t BrickGridIndex(glm::uvec3 const & brick) const;
+
+        void BuildHierarchy();
+
+        Dimensions const mDimensions;
+        glm::uvec3 const mBrickGridDimensions;
+
+        // Brick index per grid cell
+        std::vector<uint32_t> mBrickGrid{};
+        // BrickVoxelCount voxels per stored brick, X changes fastest inside a brick
+        std::vector<uint8_t> mBricks{};
+        std::vector<Level> mLevels{};
+    };
+
+}
@@ -2,6 +2,9 @@
 
 #include "BedrockAssert.hpp"
 
+#include <algorithm>
+#include <iterator>
+
 namespace MFA::Asset
 {
 
@@ -41,10 +44,48 @@ namespace MFA::Asset
 
 	//-------------------------------------------------------------------------------------------------
 
+	// Every format has at most one row
+	static constexpr bool IsFormatTableUnique()
+	{
+		for (size_t i = 0; i < std::size(Texture::FormatTable); ++i)
+		{
+			for (size_t j = i + 1; j < std::size(Texture::FormatTable); ++j)
+			{
+				if (Texture::FormatTable[i].texture_format == Texture::FormatTable[j].texture_format)
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+	static_assert(IsFormatTableUnique());
+	// Format values are written into the texture caches, New formats go to the end of the enum
+	static_assert(static_cast<int>(Texture::Format::ASTC_4x4_UNORM_BLOCK) == 17);
+	static_assert(Texture::FormatInfo(Texture::Format::BC1_UNorm_sRGB_RGBA).compression == 1);
+	static_assert(Texture::FormatInfo(Texture::Format::ASTC_4x4_UNORM_BLOCK).texture_format == Texture::Format::INVALID);
+
+	//-------------------------------------------------------------------------------------------------
+
+	bool Texture::IsBlockCompressed(Format const format)
+	{
+		return FormatInfo(format).compression != 0;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
 	size_t Texture::MipSizeBytes(Format format, uint16_t slices, Dimensions const& mipLevelDimension)
 	{
 		auto const& d = mipLevelDimension;
-		size_t const p = FormatTable[static_cast<unsigned>(format)].bits_total / 8;
+		auto const& info = FormatInfo(format);
+		if (info.compression != 0)
+		{
+			size_t const blockBytes = 16 * info.bits_total / 8;
+			size_t const blocksX = (d.width + 3) / 4;
+			size_t const blocksY = (d.height + 3) / 4;
+			return blockBytes * slices * blocksX * blocksY * d.depth;
+		}
+		size_t const p = info.bits_total / 8;
 		return p * slices * d.width * d.height * d.depth;
 	}
 
@@ -60,16 +101,32 @@ namespace MFA::Asset
 		if (mipLevel < mipCount)
 		{
 			uint32_t const pow = mipLevel;
-			uint32_t const add = (1 << pow) - 1;
-			ret.width = (originalImageDims.width + add) >> pow;
-			ret.height = (originalImageDims.height + add) >> pow;
-			ret.depth = static_cast<uint16_t>((originalImageDims.depth + add) >> pow);
+			ret.width = std::max<uint32_t>(originalImageDims.width >> pow, 1);
+			ret.height = std::max<uint32_t>(originalImageDims.height >> pow, 1);
+			ret.depth = static_cast<uint16_t>(std::max<uint32_t>(originalImageDims.depth >> pow, 1));
 		}
 		return ret;
 	}
 
 	//-------------------------------------------------------------------------------------------------
 
+	uint8_t Texture::MaxMipCount(Dimensions const & originalImageDims)
+	{
+		auto largest = std::max<uint32_t>(
+			std::max<uint32_t>(originalImageDims.width, originalImageDims.height),
+			originalImageDims.depth
+		);
+		uint8_t count = 1;
+		while (largest > 1)
+		{
+			largest >>= 1;
+			++count;
+		}
+		return count;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
     void Texture::SetMipmapDimension(uint8_t const mipLevel, Dimensions const &dimension)
     {
         MFA_ASSERT(mipLevel < mMipCount);
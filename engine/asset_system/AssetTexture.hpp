@@ -66,6 +66,12 @@ namespace MFA::Asset
             ASTC_12x12_UNORM_BLOCK,
             ASTC_12x12_SRGB_BLOCK,
 
+            // Appended after ASTC so the values that are already stored in caches keep their meaning
+            BC1_UNorm_Linear_RGB,
+            BC1_UNorm_Linear_RGBA,
+            BC1_UNorm_sRGB_RGB,
+            BC1_UNorm_sRGB_RGBA,
+
             Count
         };
         
@@ -89,12 +95,12 @@ namespace MFA::Asset
         struct InternalFormatTableType
         {
             Format texture_format;
-            uint8_t compression;                            // 0: uncompressed, 1: basis?, ...
+            uint8_t compression;                            // 0: uncompressed, Otherwise the number of the BC format
             uint8_t component_count;                        // 1..4
             uint8_t component_format;                       // 0: UNorm, 1: SNorm, 2: UInt, 3: SInt, 4: UFloat, 5: SFloat
             uint8_t color_space;                            // 0: Linear, 1: sRGB
             uint8_t bits_r, bits_g, bits_b, bits_a;         // each 0..32
-            uint8_t bits_total;                             // 1..128
+            uint8_t bits_total;                             // 1..128, Bits per pixel for block compressed formats
         };
     public:
         static constexpr InternalFormatTableType FormatTable[] = {
@@ -105,6 +111,7 @@ namespace MFA::Asset
             {Format::UNCOMPRESSED_UNORM_R8G8B8A8_LINEAR      , 0, 4, 0, 0, 8, 8, 8, 8, 32},
             {Format::UNCOMPRESSED_UNORM_R8_SRGB              , 0, 1, 0, 1, 8, 0, 0, 0,  8},
             {Format::UNCOMPRESSED_UNORM_R8G8B8A8_SRGB        , 0, 4, 0, 1, 8, 8, 8, 8, 32},
+            {Format::UNCOMPRESSED_UNORM_R16G16B16A16_LINEAR  , 0, 4, 0, 0, 16, 16, 16, 16, 64},
 
             {Format::BC7_UNorm_Linear_RGB                    , 7, 3, 0, 0, 8, 8, 8, 0,  8},
             {Format::BC7_UNorm_Linear_RGBA                   , 7, 4, 0, 0, 8, 8, 8, 8,  8},
@@ -115,12 +122,32 @@ namespace MFA::Asset
             {Format::BC6H_SFloat_Linear_RGB                  , 6, 3, 5, 0, 16, 16, 16, 0, 8},
 
             {Format::BC5_UNorm_Linear_RG                     , 5, 2, 0, 0, 8, 8, 0, 0, 8},
-            {Format::BC5_SNorm_Linear_RG                     , 5, 2, 0, 1, 8, 8, 0, 0, 8},
+            {Format::BC5_SNorm_Linear_RG                     , 5, 2, 1, 0, 8, 8, 0, 0, 8},
+
+            {Format::BC4_UNorm_Linear_R                      , 4, 1, 0, 0, 8, 0, 0, 0, 4},
+            {Format::BC4_SNorm_Linear_R                      , 4, 1, 1, 0, 8, 0, 0, 0, 4},
 
-            {Format::BC4_UNorm_Linear_R                      , 5, 2, 0, 0, 8, 8, 0, 0, 16},
-            {Format::BC4_SNorm_Linear_R                      , 5, 2, 0, 1, 8, 8, 0, 0, 16},
+            {Format::BC1_UNorm_Linear_RGB                    , 1, 3, 0, 0, 5, 6, 5, 0, 4},
+            {Format::BC1_UNorm_Linear_RGBA                   , 1, 4, 0, 0, 5, 5, 5, 1, 4},
+            {Format::BC1_UNorm_sRGB_RGB                      , 1, 3, 0, 1, 5, 6, 5, 0, 4},
+            {Format::BC1_UNorm_sRGB_RGBA                     , 1, 4, 0, 1, 5, 5, 5, 1, 4},
 
         };
+
+        // The table has no rows for the ASTC formats, So it cannot be indexed by the value of the format.
+        // Formats without a row get the INVALID row.
+        [[nodiscard]]
+        static constexpr InternalFormatTableType const & FormatInfo(Format const format)
+        {
+            for (auto const & row : FormatTable)
+            {
+                if (row.texture_format == format)
+                {
+                    return row;
+                }
+            }
+            return FormatTable[0];
+        }
         
     public:
 
@@ -146,9 +173,10 @@ namespace MFA::Asset
         Texture& operator= (Texture const& rhs) noexcept = delete;
         Texture& operator= (Texture&& rhs) noexcept = delete;
 
-        /*
-         * This function result is only correct for uncompressed data
-         */
+        [[nodiscard]]
+        static bool IsBlockCompressed(Format format);
+
+        // Block compressed formats round the dimensions up to whole 4x4 blocks
         [[nodiscard]]
         static size_t MipSizeBytes(
             Format format,
@@ -157,10 +185,7 @@ namespace MFA::Asset
         );
 
         // TODO Consider moving this function to util_image
-        /*
-         * This function result is only correct for uncompressed data
-         */
-         // NOTE: 0 is the *smallest* mipmap level, and "mip_count - 1" is the *largest*.
+         // NOTE: 0 is the *largest* mipmap level, Each level halves the previous one and rounds down like vulkan does.
         [[nodiscard]]
         static Dimensions MipDimensions(
             uint8_t mipLevel,
@@ -168,6 +193,10 @@ namespace MFA::Asset
             Dimensions originalImageDims
         );
 
+        // Number of levels down to 1x1
+        [[nodiscard]]
+        static uint8_t MaxMipCount(Dimensions const & originalImageDims);
+
         void SetMipmapDimension(
             uint8_t mipLevel,
             Dimensions const& dimension
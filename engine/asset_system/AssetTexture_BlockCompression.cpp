@@ -0,0 +1,768 @@
+#include "AssetTexture_BlockCompression.hpp"
+
+#include "BedrockAssert.hpp"
+#include "JobSystem.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MFA_BLOCK_COMPRESSION_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace MFA::Asset::BlockCompression
+{
+
+    //-------------------------------------------------------------------------------------------------
+
+    namespace
+    {
+        using Format = Texture::Format;
+
+        // Each channel of the 16 pixels is stored back to back, So four pixels fit in one register
+        struct Block
+        {
+            alignas(16) float channels[4][BlockPixelCount]{};
+
+            [[nodiscard]]
+            glm::vec4 Pixel(uint32_t const index) const
+            {
+                return glm::vec4{channels[0][index], channels[1][index], channels[2][index], channels[3][index]};
+            }
+        };
+
+        Block LoadBlock(uint8_t const * rgba)
+        {
+            Block block{};
+            for (uint32_t i = 0; i < BlockPixelCount; ++i)
+            {
+                for (uint32_t channel = 0; channel < 4; ++channel)
+                {
+                    block.channels[channel][i] = static_cast<float>(rgba[i * 4 + channel]);
+                }
+            }
+            return block;
+        }
+
+        //-------------------------------------------------------------------------------------------------
+
+        // Picks the closest palette entry for every pixel and writes the squared error of each pixel
+        void FindIndices(
+            Block const & block,
+            glm::vec4 const * palette,
+            uint32_t const paletteCount,
+            uint8_t * outIndices,
+            float * outErrors
+        )
+        {
+#ifdef MFA_BLOCK_COMPRESSION_SSE2
+            for (uint32_t group = 0; group < BlockPixelCount; group += 4)
+            {
+                __m128 const r = _mm_load_ps(&block.channels[0][group]);
+                __m128 const g = _mm_load_ps(&block.channels[1][group]);
+                __m128 const b = _mm_load_ps(&block.channels[2][group]);
+                __m128 const a = _mm_load_ps(&block.channels[3][group]);
+
+                __m128 bestError = _mm_set1_ps(FLT_MAX);
+                __m128i bestIndex = _mm_setzero_si128();
+                for (uint32_t entry = 0; entry < paletteCount; ++entry)
+                {
+                    auto const & color = palette[entry];
+                    __m128 const dr = _mm_sub_ps(r, _mm_set1_ps(color.r));
+                    __m128 const dg = _mm_sub_ps(g, _mm_set1_ps(color.g));
+                    __m128 const db = _mm_sub_ps(b, _mm_set1_ps(color.b));
+                    __m128 const da = _mm_sub_ps(a, _mm_set1_ps(color.a));
+                    __m128 const error = _mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)),
+                        _mm_add_ps(_mm_mul_ps(db, db), _mm_mul_ps(da, da))
+                    );
+
+                    __m128i const closer = _mm_castps_si128(_mm_cmplt_ps(error, bestError));
+                    bestError = _mm_min_ps(error, bestError);
+                    bestIndex = _mm_or_si128(
+                        _mm_and_si128(closer, _mm_set1_epi32(static_cast<int>(entry))),
+                        _mm_andnot_si128(closer, bestIndex)
+                    );
+                }
+
+                alignas(16) int32_t indices[4];
+                _mm_store_si128(reinterpret_cast<__m128i *>(indices), bestIndex);
+                _mm_storeu_ps(outErrors + group, bestError);
+                for (uint32_t i = 0; i < 4; ++i)
+                {
+                    outIndices[group + i] = static_cast<uint8_t>(indices[i]);
+                }
+            }
+#else
+            for (uint32_t i = 0; i < BlockPixelCount; ++i)
+            {
+                auto const pixel = block.Pixel(i);
+                float bestError = FLT_MAX;
+                uint8_t bestIndex = 0;
+                for (uint32_t entry = 0; entry < paletteCount; ++entry)
+                {
+                    auto const delta = pixel - palette[entry];
+                    float const error = glm::dot(delta, delta);
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        bestIndex = static_cast<uint8_t>(entry);
+                    }
+                }
+                outIndices[i] = bestIndex;
+                outErrors[i] = bestError;
+            }
+#endif
+        }
+
+        float SumErrors(float const * errors, bool const * mask)
+        {
+            float sum = 0.0f;
+            for (uint32_t i = 0; i < BlockPixelCount; ++i)
+            {
+                if (mask[i] == true)
+                {
+                    sum += errors[i];
+                }
+            }
+            return sum;
+        }
+
+        //-------------------------------------------------------------------------------------------------
+
+        // Endpoints are the extreme projections of the pixels on the principal axis of their colors
+        void FitEndpoints(Block const & block, bool const * mask, glm::vec4 & outStart, glm::vec4 & outEnd)
+        {
+            glm::vec4 mean{};
+            glm::vec4 minimum{FLT_MAX};
+            glm::vec4 maximum{-FLT_MAX};
+            float count = 0.0f;
+            for (uint32_t i = 0; i < BlockPixelCount; ++i)
+            {
+                if (mask[i] == true)
+                {
+                    auto const pixel = block.Pixel(i);
+                    mean += pixel;
+                    minimum = glm::min(minimum, pixel);
+                    maximum = glm::max(maximum, pixel);
+                    count += 1.0f;
+                }
+            }
+            MFA_ASSERT(count > 0.0f);
+            mean /= count;
+
+            auto axis = maximum - minimum;
+            if (glm::dot(axis, axis) < 1e-6f)
+            {
+                outStart = mean;
+                outEnd = mean;
+                return;
+            }
+
+            glm::mat4 covariance{0.0f};
+            for (uint32_t i = 0; i < BlockPixelCount; ++i)
+            {
+                if (mask[i] == true)
+                {
+                    auto const delta = block.Pixel(i) - mean;
+                    covariance += glm::outerProduct(delta, delta);
+                }
+            }
+
+            // Power iteration, Starting from the bounding box diagonal converges in a few steps
+            axis = glm::normalize(axis);
+            for (int iteration = 0; iteration < 8; ++iteration)
+            {
+                auto const next = covariance * axis;
+                float const length = glm::length(next);
+                if (length < 1e-6f)
+                {
+                    break;
+                }
+                axis = next / length;
+            }
+
+            float minimumT = FLT_MAX;
+            float maximumT = -FLT_MAX;
+            for (uint32_t i = 0; i < BlockPixelCount; ++i)
+            {
+                if (mask[i] == true)
+                {
+                    float const t = glm::dot(block.Pixel(i) - mean, axis);
+                    minimumT = std::min(minimumT, t);
+                    maximumT = std::max(maximumT, t);
+                }
+            }
+            outStart = glm::clamp(mean + axis * minimumT, 0.0f, 255.0f);
+            outEnd = glm::clamp(mean + axis * maximumT, 0.0f, 255.0f);
+        }
+
+        // Least squares endpoints for fixed indices, Every pixel is start + (end - start) * weights[index]
+        bool SolveEndpoints(
+            Block const & block,
+            bool const * mask,
+            uint8_t const * indices,
+            float const * weights,
+            glm::vec4 & outStart,
+            glm::vec4 & outEnd
+        )
+        {
+            float aa = 0.0f;
+            float ab = 0.0f;
+            float bb = 0.0f;
+            glm::vec4 ax{};
+            glm::vec4 bx{};
+            for (uint32_t i = 0; i < BlockPixelCount; ++i)
+            {
+                if (mask[i] == true)
+                {
+                    float const t = weights[indices[i]];
+                    float const s = 1.0f - t;
+                    auto const pixel = block.Pixel(i);
+                    aa += s * s;
+                    ab += s * t;
+                    bb += t * t;
+                    ax += s * pixel;
+                    bx += t * pixel;
+                }
+            }
+            float const determinant = aa * bb - ab * ab;
+            if (std::abs(determinant) < 1e-6f)
+            {
+                return false;
+            }
+            outStart = glm::clamp((bb * ax - ab * bx) / determinant, 0.0f, 255.0f);
+            outEnd = glm::clamp((aa * bx - ab * ax) / determinant, 0.0f, 255.0f);
+            return true;
+        }
+
+        //-------------------------------------------------------------------------------------------------
+
+        uint16_t To565(glm::vec4 const & color)
+        {
+            auto const r = static_cast<uint16_t>(std::lround(color.r * 31.0f / 255.0f));
+            auto const g = static_cast<uint16_t>(std::lround(color.g * 63.0f / 255.0f));
+            auto const b = static_cast<uint16_t>(std::lround(color.b * 31.0f / 255.0f));
+            return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+        }
+
+        glm::vec4 From565(uint16_t const value)
+        {
+            uint32_t const r = (value >> 11) & 31;
+            uint32_t const g = (value >> 5) & 63;
+            uint32_t const b = value & 31;
+            return glm::vec4{
+                static_cast<float>((r << 3) | (r >> 2)),
+                static_cast<float>((g << 2) | (g >> 4)),
+                static_cast<float>((b << 3) | (b >> 2)),
+                0.0f
+            };
+        }
+
+        struct BC1Candidate
+        {
+            uint16_t color0 = 0;
+            uint16_t color1 = 0;
+            uint8_t indices[BlockPixelCount]{};
+            float error = FLT_MAX;
+        };
+
+        // Color0 > color1 selects four colors, Otherwise three colors and black or transparent
+        BC1Candidate EvaluateBC1(
+            Block const & block,
+            bool const * opaque,
+            bool const punchThroughAlpha,
+            uint16_t const color0,
+            uint16_t const color1
+        )
+        {
+            BC1Candidate candidate{.color0 = color0, .color1 = color1};
+
+            glm::vec4 palette[4]{};
+            palette[0] = From565(color0);
+            palette[1] = From565(color1);
+            uint32_t paletteCount = 4;
+            if (color0 > color1)
+            {
+                palette[2] = (2.0f * palette[0] + palette[1]) / 3.0f;
+                palette[3] = (palette[0] + 2.0f * palette[1]) / 3.0f;
+            }
+            else
+            {
+                palette[2] = (palette[0] + palette[1]) * 0.5f;
+                // Black is transparent in the rgba formats, So opaque pixels cannot use it there
+                paletteCount = punchThroughAlpha ? 3 : 4;
+            }
+
+            float errors[BlockPixelCount]{};
+            FindIndices(block, palette, paletteCount, candidate.indices, errors);
+            for (uint32_t i = 0; i < BlockPixelCount; ++i)
+            {
+                if (opaque[i] == false)
+                {
+                    candidate.indices[i] = 3;
+                }
+            }
+            candidate.error = SumErrors(errors, opaque);
+            return candidate;
+        }
+
+        //-------------------------------------------------------------------------------------------------
+
+        struct BC4Candidate
+        {
+            uint8_t value0 = 0;
+            uint8_t value1 = 0;
+            uint8_t indices[BlockPixelCount]{};
+            float error = FLT_MAX;
+        };
+
+        // Value0 > value1 selects eight interpolated values, Otherwise six values and the two extremes
+        BC4Candidate EvaluateBC4(Block const & block, uint8_t const value0, uint8_t const value1)
+        {
+            BC4Candidate candidate{.value0 = value0, .value1 = value1};
+
+            float const v0 = value0;
+            float const v1 = value1;
+            glm::vec4 palette[8]{};
+            palette[0].r = v0;
+            palette[1].r = v1;
+            if (value0 > value1)
+            {
+                for (int i = 2; i < 8; ++i)
+                {
+                    palette[i].r = (static_cast<float>(8 - i) * v0 + static_cast<float>(i - 1) * v1) / 7.0f;
+                }
+            }
+            else
+            {
+                for (int i = 2; i < 6; ++i)
+                {
+                    palette[i].r = (static_cast<float>(6 - i) * v0 + static_cast<float>(i - 1) * v1) / 5.0f;
+                }
+                palette[6].r = 0.0f;
+                palette[7].r = 255.0f;
+            }
+
+            bool constexpr all[BlockPixelCount]{
+                true, true, true, true, true, true, true, true,
+                true, true, true, true, true, true, true, true
+            };
+            float errors[BlockPixelCount]{};
+            FindIndices(block, palette, 8, candidate.indices, errors);
+            candidate.error = SumErrors(errors, all);
+            return candidate;
+        }
+
+        //-------------------------------------------------------------------------------------------------
+
+        constexpr uint32_t BC7Weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+        // 7 bits per channel plus a bit that is shared by the four channels
+        struct BC7Endpoint
+        {
+            uint8_t channels[4]{};
+            uint8_t pBit = 0;
+
+            [[nodiscard]]
+            uint32_t Value(uint32_t const channel) const
+            {
+                return (static_cast<uint32_t>(channels[channel]) << 1) | pBit;
+            }
+        };
+
+        BC7Endpoint QuantizeBC7(glm::vec4 const & color)
+        {
+            BC7Endpoint best{};
+            float bestError = FLT_MAX;
+            for (uint8_t pBit = 0; pBit < 2; ++pBit)
+            {
+                BC7Endpoint endpoint{.pBit = pBit};
+                float error = 0.0f;
+                for (int channel = 0; channel < 4; ++channel)
+                {
+                    auto const quantized = std::clamp<long>(std::lround((color[channel] - pBit) * 0.5f), 0, 127);
+                    endpoint.channels[channel] = static_cast<uint8_t>(quantized);
+                    float const delta = static_cast<float>(endpoint.Value(channel)) - color[channel];
+                    error += delta * delta;
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    best = endpoint;
+                }
+            }
+            return best;
+        }
+
+        struct BC7Candidate
+        {
+            BC7Endpoint endpoints[2]{};
+            uint8_t indices[BlockPixelCount]{};
+            float error = FLT_MAX;
+        };
+
+        BC7Candidate EvaluateBC7(Block const & block, BC7Endpoint const & start, BC7Endpoint const & end)
+        {
+            BC7Candidate candidate{.endpoints = {start, end}};
+
+            glm::vec4 palette[16]{};
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                for (uint32_t channel = 0; channel < 4; ++channel)
+                {
+                    uint32_t const value = ((64 - BC7Weights[i]) * start.Value(channel) + BC7Weights[i] * end.Value(channel) + 32) >> 6;
+                    palette[i][channel] = static_cast<float>(value);
+                }
+            }
+
+            float errors[BlockPixelCount]{};
+            FindIndices(block, palette, 16, candidate.indices, errors);
+            candidate.error = 0.0f;
+            for (float const error : errors)
+            {
+                candidate.error += error;
+            }
+            return candidate;
+        }
+
+        // Fields are packed from the least significant bit of the block
+        struct BitWriter
+        {
+            uint64_t words[2]{};
+            uint32_t position = 0;
+
+            void Write(uint32_t const value, uint32_t const bitCount)
+            {
+                for (uint32_t bit = 0; bit < bitCount; ++bit, ++position)
+                {
+                    words[position / 64] |= static_cast<uint64_t>((value >> bit) & 1) << (position % 64);
+                }
+            }
+        };
+
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool IsSupported(Texture::Format const format)
+    {
+        switch (format)
+        {
+        case Format::BC1_UNorm_Linear_RGB:
+        case Format::BC1_UNorm_Linear_RGBA:
+        case Format::BC1_UNorm_sRGB_RGB:
+        case Format::BC1_UNorm_sRGB_RGBA:
+        case Format::BC4_UNorm_Linear_R:
+        case Format::BC5_UNorm_Linear_RG:
+        case Format::BC7_UNorm_Linear_RGB:
+        case Format::BC7_UNorm_Linear_RGBA:
+        case Format::BC7_UNorm_sRGB_RGB:
+        case Format::BC7_UNorm_sRGB_RGBA:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    size_t BlockSize(Texture::Format const format)
+    {
+        MFA_ASSERT(Texture::IsBlockCompressed(format));
+        return BlockPixelCount * Texture::FormatInfo(format).bits_total / 8;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<Blob> Encode(
+        Texture::Format const format,
+        uint8_t const * rgba,
+        uint32_t const width,
+        uint32_t const height
+    )
+    {
+        MFA_ASSERT(IsSupported(format));
+        MFA_ASSERT(rgba != nullptr);
+        MFA_ASSERT(width > 0 && height > 0);
+
+        uint32_t const blocksX = (width + BlockDimension - 1) / BlockDimension;
+        uint32_t const blocksY = (height + BlockDimension - 1) / BlockDimension;
+        size_t const blockSize = BlockSize(format);
+
+        std::shared_ptr<Blob> blob = Memory::AllocSize(static_cast<size_t>(blocksX) * blocksY * blockSize);
+        auto * output = blob->As<uint8_t>();
+
+        // Alpha of the rgb formats is never sampled, So the endpoints should not spend any precision on it
+        bool const ignoreAlpha = format == Format::BC7_UNorm_Linear_RGB || format == Format::BC7_UNorm_sRGB_RGB;
+
+        JobSystem::ParallelFor(static_cast<int>(blocksY), 1, [&](int const begin, int const end)->void
+        {
+            uint8_t pixels[BlockPixelCount * 4]{};
+            for (int blockY = begin; blockY < end; ++blockY)
+            {
+                for (uint32_t blockX = 0; blockX < blocksX; ++blockX)
+                {
+                    for (uint32_t y = 0; y < BlockDimension; ++y)
+                    {
+                        uint32_t const sourceY = std::min(static_cast<uint32_t>(blockY) * BlockDimension + y, height - 1);
+                        for (uint32_t x = 0; x < BlockDimension; ++x)
+                        {
+                            uint32_t const sourceX = std::min(blockX * BlockDimension + x, width - 1);
+                            auto * pixel = pixels + (y * BlockDimension + x) * 4;
+                            std::memcpy(pixel, rgba + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+                            if (ignoreAlpha)
+                            {
+                                pixel[3] = 255;
+                            }
+                        }
+                    }
+
+                    auto * block = output + (static_cast<size_t>(blockY) * blocksX + blockX) * blockSize;
+                    switch (format)
+                    {
+                    case Format::BC1_UNorm_Linear_RGB:
+                    case Format::BC1_UNorm_sRGB_RGB:
+                        EncodeBC1Block(pixels, false, block);
+                        break;
+                    case Format::BC1_UNorm_Linear_RGBA:
+                    case Format::BC1_UNorm_sRGB_RGBA:
+                        EncodeBC1Block(pixels, true, block);
+                        break;
+                    case Format::BC4_UNorm_Linear_R:
+                        EncodeBC4Block(pixels, 0, block);
+                        break;
+                    case Format::BC5_UNorm_Linear_RG:
+                        EncodeBC5Block(pixels, block);
+                        break;
+                    default:
+                        EncodeBC7Block(pixels, block);
+                        break;
+                    }
+                }
+            }
+        });
+
+        return blob;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void EncodeBC1Block(uint8_t const * rgba, bool const punchThroughAlpha, uint8_t * outBlock)
+    {
+        auto block = LoadBlock(rgba);
+
+        bool opaque[BlockPixelCount]{};
+        bool anyOpaque = false;
+        bool anyTransparent = false;
+        for (uint32_t i = 0; i < BlockPixelCount; ++i)
+        {
+            opaque[i] = punchThroughAlpha == false || rgba[i * 4 + 3] >= 128;
+            anyOpaque |= opaque[i];
+            anyTransparent |= opaque[i] == false;
+            // Alpha is not part of the colors
+            block.channels[3][i] = 0.0f;
+        }
+
+        BC1Candidate best{};
+        if (anyOpaque == false)
+        {
+            std::memset(best.indices, 3, sizeof(best.indices));
+        }
+        else
+        {
+            glm::vec4 start{};
+            glm::vec4 end{};
+            FitEndpoints(block, opaque, start, end);
+            auto const quantizedStart = To565(start);
+            auto const quantizedEnd = To565(end);
+            auto const high = std::max(quantizedStart, quantizedEnd);
+            auto const low = std::min(quantizedStart, quantizedEnd);
+
+            if (anyTransparent == false && high != low)
+            {
+                best = EvaluateBC1(block, opaque, punchThroughAlpha, high, low);
+
+                // Endpoints that fit the chosen indices usually beat the extremes of the principal axis
+                constexpr float weights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+                if (SolveEndpoints(block, opaque, best.indices, weights, start, end) == true)
+                {
+                    auto const refinedHigh = std::max(To565(start), To565(end));
+                    auto const refinedLow = std::min(To565(start), To565(end));
+                    if (refinedHigh != refinedLow)
+                    {
+                        auto const refined = EvaluateBC1(block, opaque, punchThroughAlpha, refinedHigh, refinedLow);
+                        if (refined.error < best.error)
+                        {
+                            best = refined;
+                        }
+                    }
+                }
+            }
+
+            auto const threeColors = EvaluateBC1(block, opaque, punchThroughAlpha, low, high);
+            if (threeColors.error < best.error)
+            {
+                best = threeColors;
+            }
+        }
+
+        uint32_t indices = 0;
+        for (uint32_t i = 0; i < BlockPixelCount; ++i)
+        {
+            indices |= static_cast<uint32_t>(best.indices[i]) << (i * 2);
+        }
+        outBlock[0] = static_cast<uint8_t>(best.color0 & 0xFF);
+        outBlock[1] = static_cast<uint8_t>(best.color0 >> 8);
+        outBlock[2] = static_cast<uint8_t>(best.color1 & 0xFF);
+        outBlock[3] = static_cast<uint8_t>(best.color1 >> 8);
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            outBlock[4 + i] = static_cast<uint8_t>(indices >> (i * 8));
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void EncodeBC4Block(uint8_t const * rgba, uint32_t const channel, uint8_t * outBlock)
+    {
+        MFA_ASSERT(channel < 4);
+
+        Block block{};
+        uint8_t minimum = 255;
+        uint8_t maximum = 0;
+        // Six value mode has 0 and 255 for free, So its endpoints only have to cover the rest
+        uint8_t innerMinimum = 255;
+        uint8_t innerMaximum = 0;
+        for (uint32_t i = 0; i < BlockPixelCount; ++i)
+        {
+            auto const value = rgba[i * 4 + channel];
+            block.channels[0][i] = static_cast<float>(value);
+            minimum = std::min(minimum, value);
+            maximum = std::max(maximum, value);
+            if (value != 0 && value != 255)
+            {
+                innerMinimum = std::min(innerMinimum, value);
+                innerMaximum = std::max(innerMaximum, value);
+            }
+        }
+
+        BC4Candidate best{};
+        if (minimum == maximum)
+        {
+            best.value0 = minimum;
+            best.value1 = maximum;
+        }
+        else
+        {
+            best = EvaluateBC4(block, maximum, minimum);
+            if (innerMinimum > innerMaximum)
+            {
+                innerMinimum = innerMaximum = 0;
+            }
+            if (minimum == 0 || maximum == 255)
+            {
+                auto const sixValues = EvaluateBC4(block, innerMinimum, innerMaximum);
+                if (sixValues.error < best.error)
+                {
+                    best = sixValues;
+                }
+            }
+        }
+
+        uint64_t indices = 0;
+        for (uint32_t i = 0; i < BlockPixelCount; ++i)
+        {
+            indices |= static_cast<uint64_t>(best.indices[i]) << (i * 3);
+        }
+        outBlock[0] = best.value0;
+        outBlock[1] = best.value1;
+        for (uint32_t i = 0; i < 6; ++i)
+        {
+            outBlock[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void EncodeBC5Block(uint8_t const * rgba, uint8_t * outBlock)
+    {
+        EncodeBC4Block(rgba, 0, outBlock);
+        EncodeBC4Block(rgba, 1, outBlock + 8);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void EncodeBC7Block(uint8_t const * rgba, uint8_t * outBlock)
+    {
+        auto const block = LoadBlock(rgba);
+
+        bool constexpr all[BlockPixelCount]{
+            true, true, true, true, true, true, true, true,
+            true, true, true, true, true, true, true, true
+        };
+
+        glm::vec4 start{};
+        glm::vec4 end{};
+        FitEndpoints(block, all, start, end);
+        auto best = EvaluateBC7(block, QuantizeBC7(start), QuantizeBC7(end));
+
+        float weights[16]{};
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            weights[i] = static_cast<float>(BC7Weights[i]) / 64.0f;
+        }
+        for (int iteration = 0; iteration < 2; ++iteration)
+        {
+            if (SolveEndpoints(block, all, best.indices, weights, start, end) == false)
+            {
+                break;
+            }
+            auto const refined = EvaluateBC7(block, QuantizeBC7(start), QuantizeBC7(end));
+            if (refined.error >= best.error)
+            {
+                break;
+            }
+            best = refined;
+        }
+
+        // The first index is stored without its top bit, The weights are symmetric so swapping the endpoints is lossless
+        if (best.indices[0] >= 8)
+        {
+            std::swap(best.endpoints[0], best.endpoints[1]);
+            for (auto & index : best.indices)
+            {
+                index = static_cast<uint8_t>(15 - index);
+            }
+        }
+
+        BitWriter writer{};
+        writer.Write(1 << 6, 7);
+        for (uint32_t channel = 0; channel < 4; ++channel)
+        {
+            writer.Write(best.endpoints[0].channels[channel], 7);
+            writer.Write(best.endpoints[1].channels[channel], 7);
+        }
+        writer.Write(best.endpoints[0].pBit, 1);
+        writer.Write(best.endpoints[1].pBit, 1);
+        writer.Write(best.indices[0], 3);
+        for (uint32_t i = 1; i < BlockPixelCount; ++i)
+        {
+            writer.Write(best.indices[i], 4);
+        }
+        MFA_ASSERT(writer.position == 128);
+
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            outBlock[i] = static_cast<uint8_t>(writer.words[i / 8] >> ((i % 8) * 8));
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
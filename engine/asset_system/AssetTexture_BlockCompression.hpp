@@ -0,0 +1,45 @@
+#pragma once
+
+#include "AssetTexture.hpp"
+
+#include <cstdint>
+#include <memory>
+
+// Cpu encoders for the block compressed texture formats. A block is 4x4 pixels and takes 8 bytes (BC1, BC4) or
+// 16 bytes (BC5, BC7), So a rgba8 texture shrinks 8 or 4 times.
+namespace MFA::Asset::BlockCompression
+{
+
+    static constexpr uint32_t BlockDimension = 4;
+    static constexpr uint32_t BlockPixelCount = BlockDimension * BlockDimension;
+
+    // BC1, BC4 UNorm, BC5 UNorm and BC7
+    [[nodiscard]]
+    bool IsSupported(Texture::Format format);
+
+    [[nodiscard]]
+    size_t BlockSize(Texture::Format format);
+
+    // Input is always rgba8. BC4 reads the red channel and BC5 the red and green ones.
+    // Blocks that cross the edge of the image repeat the last row and column. Rows of blocks are encoded in parallel.
+    [[nodiscard]]
+    std::shared_ptr<Blob> Encode(
+        Texture::Format format,
+        uint8_t const * rgba,
+        uint32_t width,
+        uint32_t height
+    );
+
+    // Every block function reads 16 rgba8 pixels, Row by row
+
+    // Pixels with alpha below 128 become transparent when punchThroughAlpha is set
+    void EncodeBC1Block(uint8_t const * rgba, bool punchThroughAlpha, uint8_t * outBlock);
+
+    void EncodeBC4Block(uint8_t const * rgba, uint32_t channel, uint8_t * outBlock);
+
+    void EncodeBC5Block(uint8_t const * rgba, uint8_t * outBlock);
+
+    // Always uses mode 6, One subset with 7 bit rgba endpoints and 4 bit indices
+    void EncodeBC7Block(uint8_t const * rgba, uint8_t * outBlock);
+
+}
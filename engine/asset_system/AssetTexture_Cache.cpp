@@ -0,0 +1,207 @@
+#include "AssetTexture_Cache.hpp"
+
+#include "BedrockAssert.hpp"
+#include "BedrockFile.hpp"
+#include "BedrockLog.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace MFA::Asset::TextureCache
+{
+
+    //-------------------------------------------------------------------------------------------------
+
+    namespace
+    {
+        constexpr uint32_t Magic = 0x5441464D;              // "MFAT"
+        constexpr uint64_t DataAlignment = 16;
+        constexpr uint32_t MaxMipCount = 16;
+
+        struct MipRecord
+        {
+            uint32_t width = 0;
+            uint32_t height = 0;
+            uint32_t depth = 0;
+            uint32_t padding = 0;
+            uint64_t offset = 0;
+            uint64_t size = 0;
+        };
+
+        struct Header
+        {
+            uint32_t magic = Magic;
+            uint32_t version = Version;
+            uint64_t sourceHash = 0;
+            uint32_t format = 0;
+            uint32_t slices = 0;
+            uint32_t depth = 0;
+            uint32_t mipCount = 0;
+            MipRecord mips[MaxMipCount]{};
+        };
+
+        uint64_t Align(uint64_t const value)
+        {
+            return (value + DataAlignment - 1) & ~(DataAlignment - 1);
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool Write(std::string const & path, uint64_t const sourceHash, Texture const & texture)
+    {
+        auto const mipCount = texture.GetMipCount();
+        if (mipCount > MaxMipCount)
+        {
+            return false;
+        }
+
+        Header header{};
+        header.sourceHash = sourceHash;
+        header.format = static_cast<uint32_t>(texture.GetFormat());
+        header.slices = texture.GetSlices();
+        header.depth = texture.GetDepth();
+        header.mipCount = mipCount;
+        uint64_t offset = Align(sizeof(Header));
+        for (uint8_t level = 0; level < mipCount; ++level)
+        {
+            auto const & buffer = texture.GetMipmapBuffer(level);
+            if (buffer == nullptr)
+            {
+                return false;
+            }
+            auto const & dimension = texture.GetMipmapDimension(level);
+            header.mips[level] = MipRecord{
+                .width = dimension.width,
+                .height = dimension.height,
+                .depth = dimension.depth,
+                .offset = offset,
+                .size = buffer->Len()
+            };
+            offset = Align(offset + buffer->Len());
+        }
+
+        auto const temporaryPath = path + ".tmp";
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (file.good() == false)
+            {
+                MFA_LOG_WARN("Failed to open %s for writing", temporaryPath.c_str());
+                return false;
+            }
+
+            char const padding[DataAlignment]{};
+            file.write(reinterpret_cast<char const *>(&header), sizeof(Header));
+            uint64_t position = sizeof(Header);
+            for (uint8_t level = 0; level < mipCount; ++level)
+            {
+                auto const & mip = header.mips[level];
+                file.write(padding, static_cast<std::streamsize>(mip.offset - position));
+                file.write(texture.GetMipmapBuffer(level)->As<char const>(), static_cast<std::streamsize>(mip.size));
+                position = mip.offset + mip.size;
+            }
+
+            if (file.good() == false)
+            {
+                MFA_LOG_WARN("Failed to write %s", temporaryPath.c_str());
+                file.close();
+                std::error_code errorCode{};
+                std::filesystem::remove(temporaryPath, errorCode);
+                return false;
+            }
+        }
+
+        std::error_code errorCode{};
+        std::filesystem::rename(temporaryPath, path, errorCode);
+        if (errorCode)
+        {
+            MFA_LOG_WARN("Failed to replace %s: %s", path.c_str(), errorCode.message().c_str());
+            std::filesystem::remove(temporaryPath, errorCode);
+            return false;
+        }
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool Read(
+        std::string const & path,
+        uint64_t const sourceHash,
+        std::string const & address,
+        std::shared_ptr<Texture> & outTexture
+    )
+    {
+        std::error_code errorCode{};
+        if (std::filesystem::exists(path, errorCode) == false)
+        {
+            return false;
+        }
+
+        auto const file = File::Map(path);
+        if (file == nullptr || file->Len() < sizeof(Header))
+        {
+            return false;
+        }
+
+        Header header{};
+        std::memcpy(&header, file->Ptr(), sizeof(Header));
+        if (header.magic != Magic ||
+            header.version != Version ||
+            header.sourceHash != sourceHash ||
+            header.format >= static_cast<uint32_t>(Texture::Format::Count) ||
+            Texture::FormatInfo(static_cast<Texture::Format>(header.format)).texture_format == Texture::Format::INVALID ||
+            header.slices == 0 || header.slices > UINT16_MAX ||
+            header.depth == 0 || header.depth > UINT16_MAX ||
+            header.mipCount == 0 || header.mipCount > MaxMipCount)
+        {
+            return false;
+        }
+
+        auto const format = static_cast<Texture::Format>(header.format);
+        for (uint32_t level = 0; level < header.mipCount; ++level)
+        {
+            auto const & mip = header.mips[level];
+            auto const expectedSize = Texture::MipSizeBytes(
+                format,
+                static_cast<uint16_t>(header.slices),
+                Texture::Dimensions{.width = mip.width, .height = mip.height, .depth = static_cast<uint16_t>(mip.depth)}
+            );
+            if (mip.width == 0 || mip.height == 0 ||
+                mip.depth == 0 || mip.depth > UINT16_MAX ||
+                mip.size != expectedSize ||
+                mip.offset > file->Len() ||
+                mip.size > file->Len() - mip.offset)
+            {
+                return false;
+            }
+        }
+
+        auto texture = std::make_shared<Texture>(
+            address,
+            format,
+            static_cast<uint16_t>(header.slices),
+            static_cast<uint16_t>(header.depth),
+            static_cast<uint8_t>(header.mipCount)
+        );
+        size_t dataOffset = 0;
+        for (uint8_t level = 0; level < header.mipCount; ++level)
+        {
+            auto const & mip = header.mips[level];
+            texture->SetMipmapDimension(level, Texture::Dimensions{
+                .width = mip.width,
+                .height = mip.height,
+                .depth = static_cast<uint16_t>(mip.depth)
+            });
+            texture->SetMipmapOffset(level, dataOffset);
+            texture->SetMipmapData(level, Memory::Alloc(file->Ptr() + mip.offset, mip.size));
+            dataOffset += mip.size;
+        }
+        outTexture = texture;
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
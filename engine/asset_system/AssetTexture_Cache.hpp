@@ -0,0 +1,26 @@
+#pragma once
+
+#include "AssetTexture.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Baked copy of a processed texture. The mip levels are stored exactly as the gpu consumes them,
+// So loading is a bounds check and one copy per level instead of decoding, Filtering and compressing again.
+namespace MFA::Asset::TextureCache
+{
+    // Bump whenever the file layout, The mip filter or the block encoders change
+    static constexpr uint32_t Version = 2;
+
+    // Writes to a temporary file first and then replaces the old cache, So readers never see a half written file
+    bool Write(std::string const & path, uint64_t sourceHash, Texture const & texture);
+
+    // Returns false if there is no cache, If it is corrupted or if it was baked from another source or version
+    bool Read(
+        std::string const & path,
+        uint64_t sourceHash,
+        std::string const & address,
+        std::shared_ptr<Texture> & outTexture
+    );
+}
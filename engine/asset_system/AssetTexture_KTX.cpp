@@ -0,0 +1,586 @@
+#include "AssetTexture_KTX.hpp"
+
+#include "BedrockAssert.hpp"
+#include "BedrockFile.hpp"
+#include "BedrockLog.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+
+namespace MFA::Asset::KTX
+{
+
+    //-------------------------------------------------------------------------------------------------
+
+    namespace
+    {
+        using Format = Texture::Format;
+
+        constexpr uint8_t Identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+        struct Header
+        {
+            uint8_t identifier[12]{};
+            uint32_t vkFormat = 0;
+            uint32_t typeSize = 0;
+            uint32_t pixelWidth = 0;
+            uint32_t pixelHeight = 0;
+            uint32_t pixelDepth = 0;
+            uint32_t layerCount = 0;
+            uint32_t faceCount = 0;
+            uint32_t levelCount = 0;
+            uint32_t supercompressionScheme = 0;
+            uint32_t dfdByteOffset = 0;
+            uint32_t dfdByteLength = 0;
+            uint32_t kvdByteOffset = 0;
+            uint32_t kvdByteLength = 0;
+            uint64_t sgdByteOffset = 0;
+            uint64_t sgdByteLength = 0;
+        };
+        static_assert(sizeof(Header) == 80);
+
+        struct LevelIndex
+        {
+            uint64_t byteOffset = 0;
+            uint64_t byteLength = 0;
+            uint64_t uncompressedByteLength = 0;
+        };
+        static_assert(sizeof(LevelIndex) == 24);
+
+        struct VkFormatPair
+        {
+            Format format;
+            uint32_t vkFormat;
+        };
+
+        // Values of the VkFormat enum, The asset system does not depend on the vulkan headers
+        constexpr VkFormatPair VkFormats[] = {
+            {Format::UNCOMPRESSED_UNORM_R8_LINEAR, 9},
+            {Format::UNCOMPRESSED_UNORM_R8_SRGB, 15},
+            {Format::UNCOMPRESSED_UNORM_R8G8_LINEAR, 16},
+            {Format::UNCOMPRESSED_UNORM_R8G8B8A8_LINEAR, 37},
+            {Format::UNCOMPRESSED_UNORM_R8G8B8A8_SRGB, 43},
+            {Format::UNCOMPRESSED_UNORM_R16G16B16A16_LINEAR, 91},
+            {Format::BC1_UNorm_Linear_RGB, 131},
+            {Format::BC1_UNorm_sRGB_RGB, 132},
+            {Format::BC1_UNorm_Linear_RGBA, 133},
+            {Format::BC1_UNorm_sRGB_RGBA, 134},
+            {Format::BC4_UNorm_Linear_R, 139},
+            {Format::BC4_SNorm_Linear_R, 140},
+            {Format::BC5_UNorm_Linear_RG, 141},
+            {Format::BC5_SNorm_Linear_RG, 142},
+            {Format::BC6H_UFloat_Linear_RGB, 143},
+            {Format::BC6H_SFloat_Linear_RGB, 144},
+            {Format::BC7_UNorm_Linear_RGBA, 145},
+            {Format::BC7_UNorm_Linear_RGB, 145},
+            {Format::BC7_UNorm_sRGB_RGBA, 146},
+            {Format::BC7_UNorm_sRGB_RGB, 146},
+        };
+
+        // Khronos data format specification
+        namespace DFD
+        {
+            constexpr uint32_t Version = 2;
+            constexpr uint8_t ModelRGBSDA = 1;
+            constexpr uint8_t ModelBC1A = 128;
+            constexpr uint8_t ModelBC4 = 131;
+            constexpr uint8_t ModelBC5 = 132;
+            constexpr uint8_t ModelBC6H = 133;
+            constexpr uint8_t ModelBC7 = 134;
+            constexpr uint8_t PrimariesBT709 = 1;
+            constexpr uint8_t TransferLinear = 1;
+            constexpr uint8_t TransferSRGB = 2;
+            constexpr uint8_t ChannelAlpha = 15;
+            constexpr uint8_t ChannelBC1AlphaPresent = 1;
+            constexpr uint8_t QualifierLinear = 0x10;
+            constexpr uint8_t QualifierSigned = 0x40;
+            constexpr uint8_t QualifierFloat = 0x80;
+        }
+
+        struct Sample
+        {
+            uint16_t bitOffset = 0;
+            uint8_t bitCount = 0;
+            uint8_t channel = 0;
+            uint8_t qualifiers = 0;
+            uint32_t lower = 0;
+            uint32_t upper = 0;
+        };
+
+        uint32_t FloatBits(float const value)
+        {
+            uint32_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        // Bytes of one pixel or of one 4x4 block
+        uint32_t GetBlockSize(Format const format)
+        {
+            auto const & info = Texture::FormatInfo(format);
+            return info.compression != 0 ? 16 * info.bits_total / 8 : info.bits_total / 8;
+        }
+
+        // A single basic descriptor block
+        std::vector<uint32_t> BuildDataFormatDescriptor(Format const format)
+        {
+            auto const & info = Texture::FormatInfo(format);
+            bool const isSigned = info.component_format == 1 || info.component_format == 3 || info.component_format == 5;
+            bool const isFloat = info.component_format == 4 || info.component_format == 5;
+            bool const isSRGB = info.color_space == 1;
+
+            uint8_t qualifiers = 0;
+            qualifiers |= isSigned ? DFD::QualifierSigned : 0;
+            qualifiers |= isFloat ? DFD::QualifierFloat : 0;
+            uint32_t const blockLower = isFloat ? FloatBits(isSigned ? -1.0f : 0.0f) : (isSigned ? 0x80000000u : 0u);
+            uint32_t const blockUpper = isFloat ? FloatBits(1.0f) : (isSigned ? 0x7FFFFFFFu : 0xFFFFFFFFu);
+
+            uint8_t model = DFD::ModelRGBSDA;
+            uint32_t blockDimension = 1;
+            std::vector<Sample> samples{};
+            switch (info.compression)
+            {
+            case 0:
+            {
+                uint8_t const bits[4] = {info.bits_r, info.bits_g, info.bits_b, info.bits_a};
+                uint16_t bitOffset = 0;
+                for (uint8_t channel = 0; channel < info.component_count; ++channel)
+                {
+                    samples.emplace_back(Sample{
+                        .bitOffset = bitOffset,
+                        .bitCount = bits[channel],
+                        .channel = channel == 3 ? DFD::ChannelAlpha : channel,
+                        // Alpha is never sRGB encoded
+                        .qualifiers = static_cast<uint8_t>(qualifiers | (channel == 3 && isSRGB ? DFD::QualifierLinear : 0)),
+                        .lower = 0,
+                        .upper = (1u << bits[channel]) - 1
+                    });
+                    bitOffset += bits[channel];
+                }
+                break;
+            }
+            case 1:
+                model = DFD::ModelBC1A;
+                samples.emplace_back(Sample{
+                    .bitCount = 64,
+                    .channel = info.component_count == 4 ? DFD::ChannelBC1AlphaPresent : uint8_t{0},
+                    .qualifiers = qualifiers,
+                    .lower = blockLower,
+                    .upper = blockUpper
+                });
+                break;
+            case 4:
+                model = DFD::ModelBC4;
+                samples.emplace_back(Sample{.bitCount = 64, .qualifiers = qualifiers, .lower = blockLower, .upper = blockUpper});
+                break;
+            case 5:
+                model = DFD::ModelBC5;
+                samples.emplace_back(Sample{.bitCount = 64, .qualifiers = qualifiers, .lower = blockLower, .upper = blockUpper});
+                samples.emplace_back(Sample{
+                    .bitOffset = 64,
+                    .bitCount = 64,
+                    .channel = 1,
+                    .qualifiers = qualifiers,
+                    .lower = blockLower,
+                    .upper = blockUpper
+                });
+                break;
+            case 6:
+                model = DFD::ModelBC6H;
+                samples.emplace_back(Sample{.bitCount = 128, .qualifiers = qualifiers, .lower = blockLower, .upper = blockUpper});
+                break;
+            case 7:
+                model = DFD::ModelBC7;
+                samples.emplace_back(Sample{.bitCount = 128, .lower = blockLower, .upper = blockUpper});
+                break;
+            default:
+                MFA_ASSERT(false);
+                break;
+            }
+            if (info.compression != 0)
+            {
+                blockDimension = 4;
+            }
+
+            auto const blockSize = static_cast<uint32_t>(24 + 16 * samples.size());
+            std::vector<uint32_t> words{};
+            words.emplace_back(4 + blockSize);
+            words.emplace_back(0);                                      // Khronos vendor, Basic descriptor type
+            words.emplace_back(DFD::Version | (blockSize << 16));
+            words.emplace_back(
+                model |
+                (DFD::PrimariesBT709 << 8) |
+                ((isSRGB ? DFD::TransferSRGB : DFD::TransferLinear) << 16)
+            );
+            words.emplace_back((blockDimension - 1) | ((blockDimension - 1) << 8));
+            words.emplace_back(GetBlockSize(format));                  // Bytes of plane 0, The others are unused
+            words.emplace_back(0);
+            for (auto const & sample : samples)
+            {
+                words.emplace_back(
+                    sample.bitOffset |
+                    (static_cast<uint32_t>(sample.bitCount - 1) << 16) |
+                    (static_cast<uint32_t>(sample.channel | sample.qualifiers) << 24)
+                );
+                words.emplace_back(0);                                  // Sample position
+                words.emplace_back(sample.lower);
+                words.emplace_back(sample.upper);
+            }
+            return words;
+        }
+
+        std::vector<uint8_t> BuildKeyValueData()
+        {
+            std::vector<uint8_t> data{};
+            auto const addEntry = [&data](std::string const & key, std::string const & value)->void
+            {
+                auto const length = static_cast<uint32_t>(key.size() + 1 + value.size() + 1);
+                auto const * lengthBytes = reinterpret_cast<uint8_t const *>(&length);
+                data.insert(data.end(), lengthBytes, lengthBytes + sizeof(length));
+                data.insert(data.end(), key.begin(), key.end());
+                data.emplace_back(0);
+                data.insert(data.end(), value.begin(), value.end());
+                data.emplace_back(0);
+                data.resize((data.size() + 3) & ~size_t{3}, 0);
+            };
+            addEntry("KTXwriter", "MFA");
+            return data;
+        }
+
+        uint64_t Align(uint64_t const value, uint64_t const alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    uint32_t ToVkFormat(Texture::Format const format)
+    {
+        for (auto const & pair : VkFormats)
+        {
+            if (pair.format == format)
+            {
+                return pair.vkFormat;
+            }
+        }
+        return 0;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    Texture::Format FromVkFormat(uint32_t const vkFormat)
+    {
+        for (auto const & pair : VkFormats)
+        {
+            if (pair.vkFormat == vkFormat)
+            {
+                return pair.format;
+            }
+        }
+        return Format::INVALID;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool Write(std::string const & path, Texture const & texture)
+    {
+        auto const format = texture.GetFormat();
+        auto const vkFormat = ToVkFormat(format);
+        if (vkFormat == 0)
+        {
+            MFA_LOG_WARN("Format %d cannot be written to ktx", static_cast<int>(format));
+            return false;
+        }
+
+        auto const & info = Texture::FormatInfo(format);
+        auto const mipCount = texture.GetMipCount();
+        auto const & baseDimension = texture.GetMipmapDimension(0);
+
+        Header header{};
+        std::memcpy(header.identifier, Identifier, sizeof(Identifier));
+        header.vkFormat = vkFormat;
+        header.typeSize = info.compression != 0 ? 1 : std::max<uint32_t>(info.bits_r / 8, 1);
+        header.pixelWidth = baseDimension.width;
+        header.pixelHeight = baseDimension.height;
+        header.pixelDepth = texture.GetDepth() > 1 ? texture.GetDepth() : 0;
+        header.layerCount = texture.GetSlices() > 1 ? texture.GetSlices() : 0;
+        header.faceCount = 1;
+        header.levelCount = mipCount;
+
+        auto const descriptor = BuildDataFormatDescriptor(format);
+        auto const keyValueData = BuildKeyValueData();
+        uint64_t offset = sizeof(Header) + sizeof(LevelIndex) * mipCount;
+        header.dfdByteOffset = static_cast<uint32_t>(Align(offset, 4));
+        header.dfdByteLength = static_cast<uint32_t>(descriptor.size() * sizeof(uint32_t));
+        offset = header.dfdByteOffset + header.dfdByteLength;
+        header.kvdByteOffset = static_cast<uint32_t>(Align(offset, 4));
+        header.kvdByteLength = static_cast<uint32_t>(keyValueData.size());
+        offset = header.kvdByteOffset + header.kvdByteLength;
+
+        // Smallest level first, So streaming the file from the start shows something as early as possible
+        uint64_t const levelAlignment = std::lcm<uint64_t>(GetBlockSize(format), 4);
+        std::vector<LevelIndex> levels(mipCount);
+        for (int level = mipCount - 1; level >= 0; --level)
+        {
+            auto const & buffer = texture.GetMipmapBuffer(static_cast<uint8_t>(level));
+            if (buffer == nullptr)
+            {
+                MFA_LOG_WARN("Mip level %d of %s is not resident", level, texture.GetAddress().c_str());
+                return false;
+            }
+            offset = Align(offset, levelAlignment);
+            levels[level] = LevelIndex{
+                .byteOffset = offset,
+                .byteLength = buffer->Len(),
+                .uncompressedByteLength = buffer->Len()
+            };
+            offset += buffer->Len();
+        }
+
+        auto const temporaryPath = path + ".tmp";
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (file.good() == false)
+            {
+                MFA_LOG_WARN("Failed to open %s for writing", temporaryPath.c_str());
+                return false;
+            }
+
+            uint64_t position = 0;
+            auto const write = [&file, &position](uint64_t const at, void const * data, size_t const size)->void
+            {
+                char const padding[16]{};
+                MFA_ASSERT(at >= position && at - position <= sizeof(padding));
+                file.write(padding, static_cast<std::streamsize>(at - position));
+                file.write(static_cast<char const *>(data), static_cast<std::streamsize>(size));
+                position = at + size;
+            };
+            write(0, &header, sizeof(Header));
+            write(sizeof(Header), levels.data(), levels.size() * sizeof(LevelIndex));
+            write(header.dfdByteOffset, descriptor.data(), header.dfdByteLength);
+            write(header.kvdByteOffset, keyValueData.data(), keyValueData.size());
+            for (int level = mipCount - 1; level >= 0; --level)
+            {
+                auto const & buffer = texture.GetMipmapBuffer(static_cast<uint8_t>(level));
+                write(levels[level].byteOffset, buffer->Ptr(), buffer->Len());
+            }
+
+            if (file.good() == false)
+            {
+                MFA_LOG_WARN("Failed to write %s", temporaryPath.c_str());
+                file.close();
+                std::error_code errorCode{};
+                std::filesystem::remove(temporaryPath, errorCode);
+                return false;
+            }
+        }
+
+        std::error_code errorCode{};
+        std::filesystem::rename(temporaryPath, path, errorCode);
+        if (errorCode)
+        {
+            MFA_LOG_WARN("Failed to replace %s: %s", path.c_str(), errorCode.message().c_str());
+            std::filesystem::remove(temporaryPath, errorCode);
+            return false;
+        }
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<Reader> Reader::Open(std::string const & path)
+    {
+        // Levels are read in any order, So the os should not read ahead
+        auto file = File::Map(path, File::MapParams{.sequential = false});
+        if (file == nullptr)
+        {
+            return nullptr;
+        }
+
+        Header header{};
+        if (file->Len() < sizeof(Header))
+        {
+            MFA_LOG_WARN("%s is too small to be a ktx file", path.c_str());
+            return nullptr;
+        }
+        std::memcpy(&header, file->Ptr(), sizeof(Header));
+        if (std::memcmp(header.identifier, Identifier, sizeof(Identifier)) != 0)
+        {
+            MFA_LOG_WARN("%s is not a ktx2 file", path.c_str());
+            return nullptr;
+        }
+        if (header.supercompressionScheme != 0)
+        {
+            MFA_LOG_WARN("%s is supercompressed, That is not supported yet", path.c_str());
+            return nullptr;
+        }
+        if (header.faceCount != 1)
+        {
+            MFA_LOG_WARN("%s is a cube map, That is not supported yet", path.c_str());
+            return nullptr;
+        }
+
+        auto const format = FromVkFormat(header.vkFormat);
+        if (format == Format::INVALID)
+        {
+            MFA_LOG_WARN("%s uses vkFormat %u which has no texture format", path.c_str(), header.vkFormat);
+            return nullptr;
+        }
+
+        Texture::Dimensions const baseDimension{
+            .width = header.pixelWidth,
+            .height = std::max<uint32_t>(header.pixelHeight, 1),
+            .depth = static_cast<uint16_t>(std::max<uint32_t>(header.pixelDepth, 1))
+        };
+        uint32_t const slices = std::max<uint32_t>(header.layerCount, 1);
+        uint32_t const levelCount = std::max<uint32_t>(header.levelCount, 1);
+        if (baseDimension.width == 0 ||
+            header.pixelDepth > UINT16_MAX ||
+            slices > UINT16_MAX ||
+            levelCount > Texture::MaxMipCount(baseDimension) ||
+            sizeof(Header) + sizeof(LevelIndex) * levelCount > file->Len())
+        {
+            MFA_LOG_WARN("%s has an invalid header", path.c_str());
+            return nullptr;
+        }
+
+        std::vector<Level> levels(levelCount);
+        for (uint32_t level = 0; level < levelCount; ++level)
+        {
+            LevelIndex index{};
+            std::memcpy(&index, file->Ptr() + sizeof(Header) + sizeof(LevelIndex) * level, sizeof(LevelIndex));
+
+            auto const dimension = Texture::MipDimensions(
+                static_cast<uint8_t>(level),
+                static_cast<uint8_t>(levelCount),
+                baseDimension
+            );
+            auto const expectedSize = Texture::MipSizeBytes(format, static_cast<uint16_t>(slices), dimension);
+            if (index.byteLength != expectedSize ||
+                index.byteOffset > file->Len() ||
+                index.byteLength > file->Len() - index.byteOffset)
+            {
+                MFA_LOG_WARN("Mip level %u of %s is out of the file or has an unexpected size", level, path.c_str());
+                return nullptr;
+            }
+            levels[level] = Level{.dimension = dimension, .fileOffset = index.byteOffset, .size = index.byteLength};
+        }
+
+        return std::shared_ptr<Reader>(new Reader(
+            path,
+            std::move(file),
+            format,
+            static_cast<uint16_t>(slices),
+            baseDimension.depth,
+            std::move(levels)
+        ));
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    Reader::Reader(
+        std::string path,
+        std::shared_ptr<BaseBlob const> file,
+        Texture::Format const format,
+        uint16_t const slices,
+        uint16_t const depth,
+        std::vector<Level> levels
+    )
+        : mPath(std::move(path))
+        , mFile(std::move(file))
+        , mFormat(format)
+        , mSlices(slices)
+        , mDepth(depth)
+        , mLevels(std::move(levels))
+    {}
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::string const & Reader::GetPath() const noexcept
+    {
+        return mPath;
+    }
+
+    Texture::Format Reader::GetFormat() const noexcept
+    {
+        return mFormat;
+    }
+
+    uint16_t Reader::GetSlices() const noexcept
+    {
+        return mSlices;
+    }
+
+    uint16_t Reader::GetDepth() const noexcept
+    {
+        return mDepth;
+    }
+
+    uint8_t Reader::GetMipCount() const noexcept
+    {
+        return static_cast<uint8_t>(mLevels.size());
+    }
+
+    Texture::Dimensions const & Reader::GetMipmapDimension(uint8_t const mipLevel) const noexcept
+    {
+        MFA_ASSERT(mipLevel < mLevels.size());
+        return mLevels[mipLevel].dimension;
+    }
+
+    size_t Reader::GetMipmapSize(uint8_t const mipLevel) const noexcept
+    {
+        MFA_ASSERT(mipLevel < mLevels.size());
+        return mLevels[mipLevel].size;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<Blob> Reader::ReadMipmap(uint8_t const mipLevel) const
+    {
+        MFA_ASSERT(mipLevel < mLevels.size());
+        auto const & level = mLevels[mipLevel];
+        return Memory::Alloc(mFile->Ptr() + level.fileOffset, level.size);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<Texture> Reader::CreateTexture(uint8_t const largestMipLevel) const
+    {
+        auto const mipCount = GetMipCount();
+        auto texture = std::make_shared<Texture>(mPath, mFormat, mSlices, mDepth, mipCount);
+
+        size_t offset = 0;
+        for (uint8_t level = 0; level < mipCount; ++level)
+        {
+            texture->SetMipmapDimension(level, mLevels[level].dimension);
+            texture->SetMipmapOffset(level, offset);
+            texture->SetMipmapSize(level, mLevels[level].size);
+            offset += mLevels[level].size;
+        }
+
+        // The smallest level is always loaded, So the texture can be shown right away
+        auto const firstLevel = std::min<uint8_t>(largestMipLevel, static_cast<uint8_t>(mipCount - 1));
+        for (uint8_t level = firstLevel; level < mipCount; ++level)
+        {
+            texture->SetMipmapData(level, ReadMipmap(level));
+        }
+        return texture;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void Reader::LoadMipmap(Texture & texture, uint8_t const mipLevel) const
+    {
+        MFA_ASSERT(texture.GetFormat() == mFormat);
+        MFA_ASSERT(texture.GetMipCount() == GetMipCount());
+        MFA_ASSERT(texture.GetMipmapSize(mipLevel) == mLevels[mipLevel].size);
+        texture.SetMipmapData(mipLevel, ReadMipmap(mipLevel));
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
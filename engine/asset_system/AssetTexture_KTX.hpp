@@ -0,0 +1,101 @@
+#pragma once
+
+#include "AssetTexture.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Khronos texture container, Version 2. Levels are stored from the smallest to the largest and are copied straight out
+// of the mapped file, So a texture can start with its small mipmaps and stream in the large ones later.
+// Supercompression and cube maps are not supported.
+namespace MFA::Asset::KTX
+{
+
+    // Returns 0 (VK_FORMAT_UNDEFINED) for formats that are not in Texture::FormatTable
+    [[nodiscard]]
+    uint32_t ToVkFormat(Texture::Format format);
+
+    // Vulkan has no rgb only BC7, So BC7 files are read as rgba
+    [[nodiscard]]
+    Texture::Format FromVkFormat(uint32_t vkFormat);
+
+    // Every mip level of the texture has to be resident
+    bool Write(std::string const & path, Texture const & texture);
+
+    class Reader
+    {
+    public:
+
+        // Returns nullptr if the file cannot be mapped, Is not a valid ktx2 file or uses a feature that is not supported
+        [[nodiscard]]
+        static std::shared_ptr<Reader> Open(std::string const & path);
+
+        Reader(Reader const &) = delete;
+        Reader(Reader &&) = delete;
+        Reader & operator = (Reader const &) = delete;
+        Reader & operator = (Reader &&) = delete;
+
+        [[nodiscard]]
+        std::string const & GetPath() const noexcept;
+
+        [[nodiscard]]
+        Texture::Format GetFormat() const noexcept;
+
+        // Array layers, At least 1
+        [[nodiscard]]
+        uint16_t GetSlices() const noexcept;
+
+        [[nodiscard]]
+        uint16_t GetDepth() const noexcept;
+
+        [[nodiscard]]
+        uint8_t GetMipCount() const noexcept;
+
+        [[nodiscard]]
+        Texture::Dimensions const & GetMipmapDimension(uint8_t mipLevel) const noexcept;
+
+        [[nodiscard]]
+        size_t GetMipmapSize(uint8_t mipLevel) const noexcept;
+
+        // Copies one level out of the mapped file, Only the pages of that level are touched
+        [[nodiscard]]
+        std::shared_ptr<Blob> ReadMipmap(uint8_t mipLevel) const;
+
+        // Every level gets its dimension, Offset and size. Only the levels from largestMipLevel down to the smallest
+        // one get their data, The others can be streamed in with LoadMipmap.
+        [[nodiscard]]
+        std::shared_ptr<Texture> CreateTexture(uint8_t largestMipLevel = 0) const;
+
+        // The texture has to be created by this reader
+        void LoadMipmap(Texture & texture, uint8_t mipLevel) const;
+
+    private:
+
+        struct Level
+        {
+            Texture::Dimensions dimension{};
+            uint64_t fileOffset = 0;
+            uint64_t size = 0;
+        };
+
+        explicit Reader(
+            std::string path,
+            std::shared_ptr<BaseBlob const> file,
+            Texture::Format format,
+            uint16_t slices,
+            uint16_t depth,
+            std::vector<Level> levels
+        );
+
+        std::string const mPath;
+        std::shared_ptr<BaseBlob const> const mFile;
+        Texture::Format const mFormat;
+        uint16_t const mSlices;
+        uint16_t const mDepth;
+        std::vector<Level> const mLevels;
+
+    };
+
+}
@@ -0,0 +1,756 @@
+#include "AssetTexture_PixelConversion.hpp"
+
+#include "BedrockAssert.hpp"
+
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MFA_PIXEL_CONVERSION_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// Msvc emits any intrinsic without a target switch
+#define MFA_TARGET_SSSE3
+#define MFA_TARGET_AVX2
+#else
+#define MFA_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define MFA_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define MFA_PIXEL_CONVERSION_NEON
+#include <arm_neon.h>
+#endif
+
+namespace MFA::Asset::PixelConversion
+{
+
+    //-------------------------------------------------------------------------------------------------
+
+    namespace
+    {
+
+        Isa DetectIsa()
+        {
+#if defined(MFA_PIXEL_CONVERSION_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+            int info[4]{};
+            __cpuid(info, 0);
+            int const maxLeaf = info[0];
+            __cpuid(info, 1);
+            bool const ssse3 = (info[2] & (1 << 9)) != 0;
+            // The os has to save the ymm registers too
+            bool const osSupportsAVX = (info[2] & (1 << 27)) != 0 &&
+                (info[2] & (1 << 28)) != 0 &&
+                (_xgetbv(0) & 6) == 6;
+            bool avx2 = false;
+            if (maxLeaf >= 7 && osSupportsAVX == true)
+            {
+                __cpuidex(info, 7, 0);
+                avx2 = (info[1] & (1 << 5)) != 0;
+            }
+#else
+            __builtin_cpu_init();
+            bool const ssse3 = __builtin_cpu_supports("ssse3") != 0;
+            bool const avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+            if (avx2 == true)
+            {
+                return Isa::AVX2;
+            }
+            if (ssse3 == true)
+            {
+                return Isa::SSSE3;
+            }
+            return Isa::Scalar;
+#elif defined(MFA_PIXEL_CONVERSION_NEON)
+            return Isa::NEON;
+#else
+            return Isa::Scalar;
+#endif
+        }
+
+        Isa SupportedIsa()
+        {
+            static Isa const isa = DetectIsa();
+            return isa;
+        }
+
+        std::atomic<Isa> & ActiveIsa()
+        {
+            static std::atomic<Isa> isa{SupportedIsa()};
+            return isa;
+        }
+
+        // Exact rounding of value / 255 for value <= 255 * 255
+        uint8_t DivideBy255(uint32_t const value)
+        {
+            uint32_t const rounded = value + 128;
+            return static_cast<uint8_t>((rounded + (rounded >> 8)) >> 8);
+        }
+
+        struct SRGBTable
+        {
+            uint16_t values[256]{};
+
+            SRGBTable()
+            {
+                for (int i = 0; i < 256; ++i)
+                {
+                    double const value = static_cast<double>(i) / 255.0;
+                    double const linear = value <= 0.04045
+                        ? value / 12.92
+                        : std::pow((value + 0.055) / 1.055, 2.4);
+                    values[i] = static_cast<uint16_t>(std::lround(linear * 65535.0));
+                }
+            }
+        };
+
+        //-------------------------------------------------------------------------------------------------
+        // Every kernel converts as many pixels as it can and returns the count, The scalar loop finishes the rest
+        //-------------------------------------------------------------------------------------------------
+
+#if defined(MFA_PIXEL_CONVERSION_X86)
+
+        MFA_TARGET_SSSE3
+        size_t RGBToRGBA_SSSE3(uint8_t const * rgb, uint8_t * outRGBA, size_t const pixelCount)
+        {
+            __m128i const mask = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+            __m128i const alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+            size_t i = 0;
+            // Each load reads 16 bytes and uses 12 of them, So it stops early instead of reading past the input
+            for (; i + 6 <= pixelCount; i += 4)
+            {
+                __m128i const pixels = _mm_loadu_si128(reinterpret_cast<__m128i const *>(rgb + i * 3));
+                _mm_storeu_si128(
+                    reinterpret_cast<__m128i *>(outRGBA + i * 4),
+                    _mm_or_si128(_mm_shuffle_epi8(pixels, mask), alpha)
+                );
+            }
+            return i;
+        }
+
+        MFA_TARGET_AVX2
+        size_t RGBToRGBA_AVX2(uint8_t const * rgb, uint8_t * outRGBA, size_t const pixelCount)
+        {
+            __m256i const mask = _mm256_setr_epi8(
+                0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1
+            );
+            __m256i const alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+            size_t i = 0;
+            // Each lane gets 4 pixels, The second load ends 4 bytes after the 8th pixel
+            for (; i + 10 <= pixelCount; i += 8)
+            {
+                auto const * input = rgb + i * 3;
+                __m256i const pixels = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const *>(input))),
+                    _mm_loadu_si128(reinterpret_cast<__m128i const *>(input + 12)),
+                    1
+                );
+                _mm256_storeu_si256(
+                    reinterpret_cast<__m256i *>(outRGBA + i * 4),
+                    _mm256_or_si256(_mm256_shuffle_epi8(pixels, mask), alpha)
+                );
+            }
+            return i;
+        }
+
+        MFA_TARGET_SSSE3
+        size_t RToRGBA_SSSE3(uint8_t const * r, uint8_t * outRGBA, size_t const pixelCount)
+        {
+            __m128i const alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+            __m128i const masks[4] {
+                _mm_setr_epi8(0, 0, 0, -1, 1, 1, 1, -1, 2, 2, 2, -1, 3, 3, 3, -1),
+                _mm_setr_epi8(4, 4, 4, -1, 5, 5, 5, -1, 6, 6, 6, -1, 7, 7, 7, -1),
+                _mm_setr_epi8(8, 8, 8, -1, 9, 9, 9, -1, 10, 10, 10, -1, 11, 11, 11, -1),
+                _mm_setr_epi8(12, 12, 12, -1, 13, 13, 13, -1, 14, 14, 14, -1, 15, 15, 15, -1),
+            };
+            size_t i = 0;
+            for (; i + 16 <= pixelCount; i += 16)
+            {
+                __m128i const grey = _mm_loadu_si128(reinterpret_cast<__m128i const *>(r + i));
+                auto * output = reinterpret_cast<__m128i *>(outRGBA + i * 4);
+                for (int part = 0; part < 4; ++part)
+                {
+                    _mm_storeu_si128(output + part, _mm_or_si128(_mm_shuffle_epi8(grey, masks[part]), alpha));
+                }
+            }
+            return i;
+        }
+
+        MFA_TARGET_AVX2
+        size_t RToRGBA_AVX2(uint8_t const * r, uint8_t * outRGBA, size_t const pixelCount)
+        {
+            __m256i const alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+            __m256i const masks[2] {
+                _mm256_setr_epi8(
+                    0, 0, 0, -1, 1, 1, 1, -1, 2, 2, 2, -1, 3, 3, 3, -1,
+                    4, 4, 4, -1, 5, 5, 5, -1, 6, 6, 6, -1, 7, 7, 7, -1
+                ),
+                _mm256_setr_epi8(
+                    8, 8, 8, -1, 9, 9, 9, -1, 10, 10, 10, -1, 11, 11, 11, -1,
+                    12, 12, 12, -1, 13, 13, 13, -1, 14, 14, 14, -1, 15, 15, 15, -1
+                ),
+            };
+            size_t i = 0;
+            for (; i + 16 <= pixelCount; i += 16)
+            {
+                // Shuffles cannot cross lanes, So both lanes get all 16 input bytes
+                __m256i const grey = _mm256_broadcastsi128_si256(
+                    _mm_loadu_si128(reinterpret_cast<__m128i const *>(r + i))
+                );
+                auto * output = reinterpret_cast<__m256i *>(outRGBA + i * 4);
+                _mm256_storeu_si256(output, _mm256_or_si256(_mm256_shuffle_epi8(grey, masks[0]), alpha));
+                _mm256_storeu_si256(output + 1, _mm256_or_si256(_mm256_shuffle_epi8(grey, masks[1]), alpha));
+            }
+            return i;
+        }
+
+        MFA_TARGET_SSSE3
+        size_t GreyAlphaToRGBA_SSSE3(uint8_t const * greyAlpha, uint8_t * outRGBA, size_t const pixelCount)
+        {
+            __m128i const lowMask = _mm_setr_epi8(0, 0, 0, 1, 2, 2, 2, 3, 4, 4, 4, 5, 6, 6, 6, 7);
+            __m128i const highMask = _mm_setr_epi8(8, 8, 8, 9, 10, 10, 10, 11, 12, 12, 12, 13, 14, 14, 14, 15);
+            size_t i = 0;
+            for (; i + 8 <= pixelCount; i += 8)
+            {
+                __m128i const pixels = _mm_loadu_si128(reinterpret_cast<__m128i const *>(greyAlpha + i * 2));
+                auto * output = reinterpret_cast<__m128i *>(outRGBA + i * 4);
+                _mm_storeu_si128(output, _mm_shuffle_epi8(pixels, lowMask));
+                _mm_storeu_si128(output + 1, _mm_shuffle_epi8(pixels, highMask));
+            }
+            return i;
+        }
+
+        MFA_TARGET_AVX2
+        size_t GreyAlphaToRGBA_AVX2(uint8_t const * greyAlpha, uint8_t * outRGBA, size_t const pixelCount)
+        {
+            __m256i const mask = _mm256_setr_epi8(
+                0, 0, 0, 1, 2, 2, 2, 3, 4, 4, 4, 5, 6, 6, 6, 7,
+                8, 8, 8, 9, 10, 10, 10, 11, 12, 12, 12, 13, 14, 14, 14, 15
+            );
+            size_t i = 0;
+            for (; i + 8 <= pixelCount; i += 8)
+            {
+                __m256i const pixels = _mm256_broadcastsi128_si256(
+                    _mm_loadu_si128(reinterpret_cast<__m128i const *>(greyAlpha + i * 2))
+                );
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(outRGBA + i * 4), _mm256_shuffle_epi8(pixels, mask));
+            }
+            return i;
+        }
+
+        // Sse2 is enough, Every cpu with ssse3 has it
+        MFA_TARGET_SSSE3
+        size_t Expand8To16_SSSE3(uint8_t const * input, uint16_t * output, size_t const componentCount)
+        {
+            size_t i = 0;
+            for (; i + 16 <= componentCount; i += 16)
+            {
+                __m128i const values = _mm_loadu_si128(reinterpret_cast<__m128i const *>(input + i));
+                // Interleaving a byte with itself is value * 257
+                auto * destination = reinterpret_cast<__m128i *>(output + i);
+                _mm_storeu_si128(destination, _mm_unpacklo_epi8(values, values));
+                _mm_storeu_si128(destination + 1, _mm_unpackhi_epi8(values, values));
+            }
+            return i;
+        }
+
+        MFA_TARGET_AVX2
+        size_t Expand8To16_AVX2(uint8_t const * input, uint16_t * output, size_t const componentCount)
+        {
+            size_t i = 0;
+            for (; i + 32 <= componentCount; i += 32)
+            {
+                // Unpack works per lane, So the quarters are reordered to 0 2 1 3 first
+                __m256i const values = _mm256_permute4x64_epi64(
+                    _mm256_loadu_si256(reinterpret_cast<__m256i const *>(input + i)),
+                    0xD8
+                );
+                auto * destination = reinterpret_cast<__m256i *>(output + i);
+                _mm256_storeu_si256(destination, _mm256_unpacklo_epi8(values, values));
+                _mm256_storeu_si256(destination + 1, _mm256_unpackhi_epi8(values, values));
+            }
+            return i;
+        }
+
+        // Colors are widened to 16 bits, Each one is multiplied by the alpha of its pixel and divided by 255
+        MFA_TARGET_SSSE3
+        __m128i MultiplyByAlpha_SSSE3(__m128i const colors)
+        {
+            __m128i const alphaBroadcast = _mm_setr_epi8(6, -1, 6, -1, 6, -1, 6, -1, 14, -1, 14, -1, 14, -1, 14, -1);
+            __m128i const alpha = _mm_shuffle_epi8(colors, alphaBroadcast);
+            __m128i const product = _mm_add_epi16(_mm_mullo_epi16(colors, alpha), _mm_set1_epi16(128));
+            return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+        }
+
+        MFA_TARGET_SSSE3
+        __m128i Premultiply_SSSE3(__m128i const pixels)
+        {
+            __m128i const zero = _mm_setzero_si128();
+            __m128i const alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+            __m128i const low = MultiplyByAlpha_SSSE3(_mm_unpacklo_epi8(pixels, zero));
+            __m128i const high = MultiplyByAlpha_SSSE3(_mm_unpackhi_epi8(pixels, zero));
+            __m128i const result = _mm_packus_epi16(low, high);
+            return _mm_or_si128(_mm_andnot_si128(alphaMask, result), _mm_and_si128(alphaMask, pixels));
+        }
+
+        MFA_TARGET_SSSE3
+        size_t PremultiplyAlpha_SSSE3(uint8_t const * rgba, uint8_t * outRGBA, size_t const pixelCount)
+        {
+            size_t i = 0;
+            for (; i + 4 <= pixelCount; i += 4)
+            {
+                __m128i const pixels = _mm_loadu_si128(reinterpret_cast<__m128i const *>(rgba + i * 4));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(outRGBA + i * 4), Premultiply_SSSE3(pixels));
+            }
+            return i;
+        }
+
+        MFA_TARGET_AVX2
+        __m256i MultiplyByAlpha_AVX2(__m256i const colors)
+        {
+            __m256i const alphaBroadcast = _mm256_setr_epi8(
+                6, -1, 6, -1, 6, -1, 6, -1, 14, -1, 14, -1, 14, -1, 14, -1,
+                6, -1, 6, -1, 6, -1, 6, -1, 14, -1, 14, -1, 14, -1, 14, -1
+            );
+            __m256i const alpha = _mm256_shuffle_epi8(colors, alphaBroadcast);
+            __m256i const product = _mm256_add_epi16(_mm256_mullo_epi16(colors, alpha), _mm256_set1_epi16(128));
+            return _mm256_srli_epi16(_mm256_add_epi16(product, _mm256_srli_epi16(product, 8)), 8);
+        }
+
+        MFA_TARGET_AVX2
+        size_t PremultiplyAlpha_AVX2(uint8_t const * rgba, uint8_t * outRGBA, size_t const pixelCount)
+        {
+            __m256i const zero = _mm256_setzero_si256();
+            __m256i const alphaMask = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+            size_t i = 0;
+            for (; i + 8 <= pixelCount; i += 8)
+            {
+                __m256i const pixels = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(rgba + i * 4));
+                // Unpack and pack both work per lane, So the pixel order survives
+                __m256i const low = MultiplyByAlpha_AVX2(_mm256_unpacklo_epi8(pixels, zero));
+                __m256i const high = MultiplyByAlpha_AVX2(_mm256_unpackhi_epi8(pixels, zero));
+                __m256i const result = _mm256_packus_epi16(low, high);
+                _mm256_storeu_si256(
+                    reinterpret_cast<__m256i *>(outRGBA + i * 4),
+                    _mm256_or_si256(_mm256_andnot_si256(alphaMask, result), _mm256_and_si256(alphaMask, pixels))
+                );
+            }
+            return i;
+        }
+
+        MFA_TARGET_SSSE3
+        size_t Swizzle_SSSE3(
+            uint8_t const * rgba,
+            uint8_t * outRGBA,
+            size_t const pixelCount,
+            std::array<uint8_t, 4> const & order
+        )
+        {
+            alignas(16) int8_t maskBytes[16]{};
+            for (int i = 0; i < 16; ++i)
+            {
+                maskBytes[i] = static_cast<int8_t>((i & ~3) + order[i & 3]);
+            }
+            __m128i const mask = _mm_load_si128(reinterpret_cast<__m128i const *>(maskBytes));
+            size_t i = 0;
+            for (; i + 4 <= pixelCount; i += 4)
+            {
+                __m128i const pixels = _mm_loadu_si128(reinterpret_cast<__m128i const *>(rgba + i * 4));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(outRGBA + i * 4), _mm_shuffle_epi8(pixels, mask));
+            }
+            return i;
+        }
+
+        MFA_TARGET_AVX2
+        size_t Swizzle_AVX2(
+            uint8_t const * rgba,
+            uint8_t * outRGBA,
+            size_t const pixelCount,
+            std::array<uint8_t, 4> const & order
+        )
+        {
+            alignas(32) int8_t maskBytes[32]{};
+            for (int i = 0; i < 32; ++i)
+            {
+                maskBytes[i] = static_cast<int8_t>(((i & 15) & ~3) + order[i & 3]);
+            }
+            __m256i const mask = _mm256_load_si256(reinterpret_cast<__m256i const *>(maskBytes));
+            size_t i = 0;
+            for (; i + 8 <= pixelCount; i += 8)
+            {
+                __m256i const pixels = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(rgba + i * 4));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(outRGBA + i * 4), _mm256_shuffle_epi8(pixels, mask));
+            }
+            return i;
+        }
+
+#endif
+
+        //-------------------------------------------------------------------------------------------------
+
+#if defined(MFA_PIXEL_CONVERSION_NEON)
+
+        size_t RGBToRGBA_NEON(uint8_t const * rgb, uint8_t * outRGBA, size_t const pixelCount)
+        {
+            size_t i = 0;
+            for (; i + 16 <= pixelCount; i += 16)
+            {
+                uint8x16x3_t const pixels = vld3q_u8(rgb + i * 3);
+                uint8x16x4_t const result {pixels.val[0], pixels.val[1], pixels.val[2], vdupq_n_u8(255)};
+                vst4q_u8(outRGBA + i * 4, result);
+            }
+            return i;
+        }
+
+        size_t RToRGBA_NEON(uint8_t const * r, uint8_t * outRGBA, size_t const pixelCount)
+        {
+            size_t i = 0;
+            for (; i + 16 <= pixelCount; i += 16)
+            {
+                uint8x16_t const grey = vld1q_u8(r + i);
+                uint8x16x4_t const result {grey, grey, grey, vdupq_n_u8(255)};
+                vst4q_u8(outRGBA + i * 4, result);
+            }
+            return i;
+        }
+
+        size_t GreyAlphaToRGBA_NEON(uint8_t const * greyAlpha, uint8_t * outRGBA, size_t const pixelCount)
+        {
+            size_t i = 0;
+            for (; i + 16 <= pixelCount; i += 16)
+            {
+                uint8x16x2_t const pixels = vld2q_u8(greyAlpha + i * 2);
+                uint8x16x4_t const result {pixels.val[0], pixels.val[0], pixels.val[0], pixels.val[1]};
+                vst4q_u8(outRGBA + i * 4, result);
+            }
+            return i;
+        }
+
+        size_t Expand8To16_NEON(uint8_t const * input, uint16_t * output, size_t const componentCount)
+        {
+            size_t i = 0;
+            for (; i + 16 <= componentCount; i += 16)
+            {
+                uint8x16_t const values = vld1q_u8(input + i);
+                // Interleaving a byte with itself is value * 257
+                uint8x16x2_t const result {values, values};
+                vst2q_u8(reinterpret_cast<uint8_t *>(output + i), result);
+            }
+            return i;
+        }
+
+        uint8x16_t Premultiply_NEON(uint8x16_t const color, uint8x16_t const alpha)
+        {
+            uint16x8_t const low = vmull_u8(vget_low_u8(color), vget_low_u8(alpha));
+            uint16x8_t const high = vmull_high_u8(color, alpha);
+            // (product + ((product + 128) >> 8) + 128) >> 8 is the exact rounding of product / 255
+            return vcombine_u8(
+                vraddhn_u16(low, vrshrq_n_u16(low, 8)),
+                vraddhn_u16(high, vrshrq_n_u16(high, 8))
+            );
+        }
+
+        size_t PremultiplyAlpha_NEON(uint8_t const * rgba, uint8_t * outRGBA, size_t const pixelCount)
+        {
+            size_t i = 0;
+            for (; i + 16 <= pixelCount; i += 16)
+            {
+                uint8x16x4_t pixels = vld4q_u8(rgba + i * 4);
+                pixels.val[0] = Premultiply_NEON(pixels.val[0], pixels.val[3]);
+                pixels.val[1] = Premultiply_NEON(pixels.val[1], pixels.val[3]);
+                pixels.val[2] = Premultiply_NEON(pixels.val[2], pixels.val[3]);
+                vst4q_u8(outRGBA + i * 4, pixels);
+            }
+            return i;
+        }
+
+        size_t Swizzle_NEON(
+            uint8_t const * rgba,
+            uint8_t * outRGBA,
+            size_t const pixelCount,
+            std::array<uint8_t, 4> const & order
+        )
+        {
+            uint8_t maskBytes[16]{};
+            for (int i = 0; i < 16; ++i)
+            {
+                maskBytes[i] = static_cast<uint8_t>((i & ~3) + order[i & 3]);
+            }
+            uint8x16_t const mask = vld1q_u8(maskBytes);
+            size_t i = 0;
+            for (; i + 4 <= pixelCount; i += 4)
+            {
+                vst1q_u8(outRGBA + i * 4, vqtbl1q_u8(vld1q_u8(rgba + i * 4), mask));
+            }
+            return i;
+        }
+
+#endif
+
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    Isa GetIsa()
+    {
+        return ActiveIsa().load(std::memory_order_relaxed);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void SetIsa(Isa const isa)
+    {
+        auto const supportedIsa = SupportedIsa();
+        auto selectedIsa = Isa::Scalar;
+        if (isa == supportedIsa || isa == Isa::Scalar)
+        {
+            selectedIsa = isa;
+        }
+        else if (supportedIsa == Isa::AVX2 && isa == Isa::SSSE3)
+        {
+            selectedIsa = Isa::SSSE3;
+        }
+        else
+        {
+            selectedIsa = supportedIsa;
+        }
+        ActiveIsa().store(selectedIsa, std::memory_order_relaxed);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    char const * GetIsaName(Isa const isa)
+    {
+        switch (isa)
+        {
+        case Isa::Scalar:
+            return "Scalar";
+        case Isa::SSSE3:
+            return "SSSE3";
+        case Isa::AVX2:
+            return "AVX2";
+        case Isa::NEON:
+            return "NEON";
+        }
+        return "Unknown";
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void RGBToRGBA(uint8_t const * rgb, uint8_t * outRGBA, size_t const pixelCount)
+    {
+        size_t i = 0;
+        switch (GetIsa())
+        {
+#if defined(MFA_PIXEL_CONVERSION_X86)
+        case Isa::AVX2:
+            i = RGBToRGBA_AVX2(rgb, outRGBA, pixelCount);
+            break;
+        case Isa::SSSE3:
+            i = RGBToRGBA_SSSE3(rgb, outRGBA, pixelCount);
+            break;
+#elif defined(MFA_PIXEL_CONVERSION_NEON)
+        case Isa::NEON:
+            i = RGBToRGBA_NEON(rgb, outRGBA, pixelCount);
+            break;
+#endif
+        default:
+            break;
+        }
+
+        for (; i < pixelCount; ++i)
+        {
+            outRGBA[i * 4 + 0] = rgb[i * 3 + 0];
+            outRGBA[i * 4 + 1] = rgb[i * 3 + 1];
+            outRGBA[i * 4 + 2] = rgb[i * 3 + 2];
+            outRGBA[i * 4 + 3] = 255;
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void RToRGBA(uint8_t const * r, uint8_t * outRGBA, size_t const pixelCount)
+    {
+        size_t i = 0;
+        switch (GetIsa())
+        {
+#if defined(MFA_PIXEL_CONVERSION_X86)
+        case Isa::AVX2:
+            i = RToRGBA_AVX2(r, outRGBA, pixelCount);
+            break;
+        case Isa::SSSE3:
+            i = RToRGBA_SSSE3(r, outRGBA, pixelCount);
+            break;
+#elif defined(MFA_PIXEL_CONVERSION_NEON)
+        case Isa::NEON:
+            i = RToRGBA_NEON(r, outRGBA, pixelCount);
+            break;
+#endif
+        default:
+            break;
+        }
+
+        for (; i < pixelCount; ++i)
+        {
+            outRGBA[i * 4 + 0] = r[i];
+            outRGBA[i * 4 + 1] = r[i];
+            outRGBA[i * 4 + 2] = r[i];
+            outRGBA[i * 4 + 3] = 255;
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void GreyAlphaToRGBA(uint8_t const * greyAlpha, uint8_t * outRGBA, size_t const pixelCount)
+    {
+        size_t i = 0;
+        switch (GetIsa())
+        {
+#if defined(MFA_PIXEL_CONVERSION_X86)
+        case Isa::AVX2:
+            i = GreyAlphaToRGBA_AVX2(greyAlpha, outRGBA, pixelCount);
+            break;
+        case Isa::SSSE3:
+            i = GreyAlphaToRGBA_SSSE3(greyAlpha, outRGBA, pixelCount);
+            break;
+#elif defined(MFA_PIXEL_CONVERSION_NEON)
+        case Isa::NEON:
+            i = GreyAlphaToRGBA_NEON(greyAlpha, outRGBA, pixelCount);
+            break;
+#endif
+        default:
+            break;
+        }
+
+        for (; i < pixelCount; ++i)
+        {
+            outRGBA[i * 4 + 0] = greyAlpha[i * 2];
+            outRGBA[i * 4 + 1] = greyAlpha[i * 2];
+            outRGBA[i * 4 + 2] = greyAlpha[i * 2];
+            outRGBA[i * 4 + 3] = greyAlpha[i * 2 + 1];
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // A 256 entry table beats any vectorized approximation of the curve, So every instruction set shares it
+    void SRGBToLinear(uint8_t const * sRGBA, uint16_t * outRGBA, size_t const pixelCount)
+    {
+        static SRGBTable const table{};
+        for (size_t i = 0; i < pixelCount; ++i)
+        {
+            outRGBA[i * 4 + 0] = table.values[sRGBA[i * 4 + 0]];
+            outRGBA[i * 4 + 1] = table.values[sRGBA[i * 4 + 1]];
+            outRGBA[i * 4 + 2] = table.values[sRGBA[i * 4 + 2]];
+            outRGBA[i * 4 + 3] = static_cast<uint16_t>(sRGBA[i * 4 + 3] * 257);
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void Expand8To16(uint8_t const * input, uint16_t * output, size_t const componentCount)
+    {
+        size_t i = 0;
+        switch (GetIsa())
+        {
+#if defined(MFA_PIXEL_CONVERSION_X86)
+        case Isa::AVX2:
+            i = Expand8To16_AVX2(input, output, componentCount);
+            break;
+        case Isa::SSSE3:
+            i = Expand8To16_SSSE3(input, output, componentCount);
+            break;
+#elif defined(MFA_PIXEL_CONVERSION_NEON)
+        case Isa::NEON:
+            i = Expand8To16_NEON(input, output, componentCount);
+            break;
+#endif
+        default:
+            break;
+        }
+
+        for (; i < componentCount; ++i)
+        {
+            output[i] = static_cast<uint16_t>(input[i] * 257);
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void PremultiplyAlpha(uint8_t const * rgba, uint8_t * outRGBA, size_t const pixelCount)
+    {
+        size_t i = 0;
+        switch (GetIsa())
+        {
+#if defined(MFA_PIXEL_CONVERSION_X86)
+        case Isa::AVX2:
+            i = PremultiplyAlpha_AVX2(rgba, outRGBA, pixelCount);
+            break;
+        case Isa::SSSE3:
+            i = PremultiplyAlpha_SSSE3(rgba, outRGBA, pixelCount);
+            break;
+#elif defined(MFA_PIXEL_CONVERSION_NEON)
+        case Isa::NEON:
+            i = PremultiplyAlpha_NEON(rgba, outRGBA, pixelCount);
+            break;
+#endif
+        default:
+            break;
+        }
+
+        for (; i < pixelCount; ++i)
+        {
+            uint32_t const alpha = rgba[i * 4 + 3];
+            outRGBA[i * 4 + 0] = DivideBy255(rgba[i * 4 + 0] * alpha);
+            outRGBA[i * 4 + 1] = DivideBy255(rgba[i * 4 + 1] * alpha);
+            outRGBA[i * 4 + 2] = DivideBy255(rgba[i * 4 + 2] * alpha);
+            outRGBA[i * 4 + 3] = static_cast<uint8_t>(alpha);
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void Swizzle(
+        uint8_t const * rgba,
+        uint8_t * outRGBA,
+        size_t const pixelCount,
+        std::array<uint8_t, 4> const & order
+    )
+    {
+        MFA_ASSERT(order[0] < 4 && order[1] < 4 && order[2] < 4 && order[3] < 4);
+        size_t i = 0;
+        switch (GetIsa())
+        {
+#if defined(MFA_PIXEL_CONVERSION_X86)
+        case Isa::AVX2:
+            i = Swizzle_AVX2(rgba, outRGBA, pixelCount, order);
+            break;
+        case Isa::SSSE3:
+            i = Swizzle_SSSE3(rgba, outRGBA, pixelCount, order);
+            break;
+#elif defined(MFA_PIXEL_CONVERSION_NEON)
+        case Isa::NEON:
+            i = Swizzle_NEON(rgba, outRGBA, pixelCount, order);
+            break;
+#endif
+        default:
+            break;
+        }
+
+        for (; i < pixelCount; ++i)
+        {
+            // Read the whole pixel first so the conversion can happen in place
+            uint8_t const pixel[4] {rgba[i * 4 + 0], rgba[i * 4 + 1], rgba[i * 4 + 2], rgba[i * 4 + 3]};
+            outRGBA[i * 4 + 0] = pixel[order[0]];
+            outRGBA[i * 4 + 1] = pixel[order[1]];
+            outRGBA[i * 4 + 2] = pixel[order[2]];
+            outRGBA[i * 4 + 3] = pixel[order[3]];
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
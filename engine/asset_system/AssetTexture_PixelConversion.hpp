@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Conversions between the 8 bit pixel layouts that the image decoders produce and the ones that textures use.
+// Every function has a scalar path and vectorized ones for SSSE3, AVX2 (Both picked at runtime) and NEON (aarch64).
+// The functions are single threaded, Large images can be split into rows and converted in parallel.
+namespace MFA::Asset::PixelConversion
+{
+
+    enum class Isa : uint8_t
+    {
+        Scalar,
+        SSSE3,
+        AVX2,
+        NEON
+    };
+
+    // Best instruction set that the cpu supports, Unless SetIsa overrode it
+    [[nodiscard]]
+    Isa GetIsa();
+
+    // For benchmarks and comparisons, An instruction set that the cpu does not support falls back to the best one that it does
+    void SetIsa(Isa isa);
+
+    [[nodiscard]]
+    char const * GetIsaName(Isa isa);
+
+    // Alpha becomes 255
+    void RGBToRGBA(uint8_t const * rgb, uint8_t * outRGBA, size_t pixelCount);
+
+    // Grey is copied to every color channel and alpha becomes 255
+    void RToRGBA(uint8_t const * r, uint8_t * outRGBA, size_t pixelCount);
+
+    // Grey is copied to every color channel
+    void GreyAlphaToRGBA(uint8_t const * greyAlpha, uint8_t * outRGBA, size_t pixelCount);
+
+    // Color channels are decoded with the exact srgb curve, Alpha is linear already. 16 bits keep the dark values apart.
+    void SRGBToLinear(uint8_t const * sRGBA, uint16_t * outRGBA, size_t pixelCount);
+
+    // Works on single components, 255 becomes 65535
+    void Expand8To16(uint8_t const * input, uint16_t * output, size_t componentCount);
+
+    // Input and output can be the same buffer. Colors are treated as linear values.
+    void PremultiplyAlpha(uint8_t const * rgba, uint8_t * outRGBA, size_t pixelCount);
+
+    // outRGBA[channel] = rgba[order[channel]], Input and output can be the same buffer
+    void Swizzle(uint8_t const * rgba, uint8_t * outRGBA, size_t pixelCount, std::array<uint8_t, 4> const & order);
+
+}
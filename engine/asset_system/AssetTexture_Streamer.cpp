@@ -0,0 +1,402 @@
+#include "AssetTexture_Streamer.hpp"
+
+#include "AssetTexture_KTX.hpp"
+#include "BedrockAssert.hpp"
+#include "BedrockLog.hpp"
+#include "JobSystem.hpp"
+
+#include <algorithm>
+
+namespace MFA::Asset
+{
+
+    //-------------------------------------------------------------------------------------------------
+
+    namespace
+    {
+        // Min heap, The least recently used level is on top
+        template <typename Candidate>
+        bool IsUsedMoreRecently(Candidate const & lhs, Candidate const & rhs)
+        {
+            return lhs.lastUsedFrame > rhs.lastUsedFrame;
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    TextureStreamer::TextureStreamer(Params const & params)
+        : mParams(params)
+        , mCompletionQueue(std::make_shared<CompletionQueue>())
+    {
+        MFA_ASSERT(mParams.maxPendingLoads > 0);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Loads that are in flight only reference the completion queue, So there is nothing to wait for
+    TextureStreamer::~TextureStreamer() = default;
+
+    //-------------------------------------------------------------------------------------------------
+
+    TextureStreamer::Handle TextureStreamer::Register(std::shared_ptr<Texture> texture, MipLoader loader)
+    {
+        MFA_ASSERT(texture != nullptr);
+        MFA_ASSERT(loader != nullptr);
+        auto const mipCount = texture->GetMipCount();
+        if (mipCount == 0)
+        {
+            MFA_LOG_WARN("Texture %s has no mip level to stream", texture->GetAddress().c_str());
+            return InvalidHandle;
+        }
+
+        Entry entry{};
+        entry.residentLevel = mipCount;
+        for (int level = mipCount - 1; level >= 0; --level)
+        {
+            if (texture->GetMipmapBuffer(static_cast<uint8_t>(level)) == nullptr)
+            {
+                break;
+            }
+            entry.residentLevel = static_cast<uint8_t>(level);
+        }
+        for (uint8_t level = 0; level < entry.residentLevel; ++level)
+        {
+            texture->ClearMipmapBuffer(level);
+        }
+        for (uint8_t level = entry.residentLevel; level < mipCount; ++level)
+        {
+            mStats.residentBytes += texture->GetMipmapSize(level);
+        }
+
+        entry.requestedLevel = mipCount - 1;
+        entry.lastUsedFrames.resize(mipCount, 0);
+        entry.texture = std::move(texture);
+        entry.loader = std::move(loader);
+
+        auto const handle = mNextHandle++;
+        MFA_ASSERT(mNextHandle != InvalidHandle);
+        mEntries.emplace(handle, std::move(entry));
+        return handle;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    TextureStreamer::Handle TextureStreamer::Register(std::shared_ptr<KTX::Reader> const & reader)
+    {
+        MFA_ASSERT(reader != nullptr);
+        auto texture = reader->CreateTexture(reader->GetMipCount() - 1);
+        return Register(std::move(texture), [reader](uint8_t const mipLevel)->std::shared_ptr<Blob>
+        {
+            return reader->ReadMipmap(mipLevel);
+        });
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TextureStreamer::Unregister(Handle const handle)
+    {
+        auto const findResult = mEntries.find(handle);
+        if (findResult == mEntries.end())
+        {
+            return;
+        }
+        auto const & entry = findResult->second;
+        for (uint8_t level = entry.residentLevel; level < entry.texture->GetMipCount(); ++level)
+        {
+            mStats.residentBytes -= entry.texture->GetMipmapSize(level);
+        }
+        mEntries.erase(findResult);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TextureStreamer::RequestMipLevel(Handle const handle, uint8_t const mipLevel)
+    {
+        auto const findResult = mEntries.find(handle);
+        MFA_ASSERT(findResult != mEntries.end());
+        if (findResult == mEntries.end())
+        {
+            return;
+        }
+        auto & entry = findResult->second;
+        auto const mipCount = entry.texture->GetMipCount();
+        auto const level = std::min<uint8_t>(mipLevel, mipCount - 1);
+        if (entry.lastRequestFrame != mFrame || level < entry.requestedLevel)
+        {
+            entry.requestedLevel = level;
+        }
+        entry.lastRequestFrame = mFrame;
+        for (uint8_t i = level; i < mipCount; ++i)
+        {
+            entry.lastUsedFrames[i] = mFrame;
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TextureStreamer::Update()
+    {
+        ApplyCompletions();
+        BuildEvictionCandidates();
+        // The budget might have shrunk
+        MakeRoom(0);
+
+        struct LoadCandidate
+        {
+            Handle handle;
+            uint8_t mipLevel;
+            uint8_t missingLevels;
+            size_t size;
+        };
+        std::vector<LoadCandidate> loadCandidates{};
+        for (auto const & [handle, entry] : mEntries)
+        {
+            if (entry.loadPending == true || entry.loadFailed == true)
+            {
+                continue;
+            }
+            // The smallest level is always needed, Even by textures that are not requested
+            auto const wantedLevel = entry.lastRequestFrame == mFrame
+                ? entry.requestedLevel
+                : static_cast<uint8_t>(entry.texture->GetMipCount() - 1);
+            if (wantedLevel >= entry.residentLevel)
+            {
+                continue;
+            }
+            auto const mipLevel = static_cast<uint8_t>(entry.residentLevel - 1);
+            loadCandidates.emplace_back(LoadCandidate{
+                .handle = handle,
+                .mipLevel = mipLevel,
+                .missingLevels = static_cast<uint8_t>(entry.residentLevel - wantedLevel),
+                .size = entry.texture->GetMipmapSize(mipLevel)
+            });
+        }
+
+        // The blurriest textures first, Then the cheap loads
+        std::sort(loadCandidates.begin(), loadCandidates.end(), [](LoadCandidate const & lhs, LoadCandidate const & rhs)
+        {
+            if (lhs.missingLevels != rhs.missingLevels)
+            {
+                return lhs.missingLevels > rhs.missingLevels;
+            }
+            return lhs.size < rhs.size;
+        });
+
+        for (auto const & candidate : loadCandidates)
+        {
+            if (mStats.pendingLoads >= mParams.maxPendingLoads)
+            {
+                break;
+            }
+            if (MakeRoom(candidate.size) == false)
+            {
+                continue;
+            }
+            StartLoad(candidate.handle, mEntries.at(candidate.handle), candidate.mipLevel);
+        }
+
+        ++mFrame;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TextureStreamer::Flush()
+    {
+        auto const queue = mCompletionQueue;
+        int const pendingLoads = mStats.pendingLoads;
+        JobSystem::WaitUntil([&queue, pendingLoads]()->bool
+        {
+            std::lock_guard lock(queue->mutex);
+            return static_cast<int>(queue->completions.size()) >= pendingLoads;
+        });
+        ApplyCompletions();
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TextureStreamer::SetBudget(size_t const budgetBytes)
+    {
+        mParams.budgetBytes = budgetBytes;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<Texture> const & TextureStreamer::GetTexture(Handle const handle) const
+    {
+        static std::shared_ptr<Texture> const invalidTexture{};
+        auto const findResult = mEntries.find(handle);
+        MFA_ASSERT(findResult != mEntries.end());
+        return findResult != mEntries.end() ? findResult->second.texture : invalidTexture;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    uint8_t TextureStreamer::GetResidentMipLevel(Handle const handle) const
+    {
+        auto const findResult = mEntries.find(handle);
+        MFA_ASSERT(findResult != mEntries.end());
+        return findResult != mEntries.end() ? findResult->second.residentLevel : 0;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    TextureStreamer::Stats TextureStreamer::GetStats() const
+    {
+        auto stats = mStats;
+        stats.budgetBytes = mParams.budgetBytes;
+        return stats;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TextureStreamer::ApplyCompletions()
+    {
+        std::vector<Completion> completions{};
+        {
+            std::lock_guard lock(mCompletionQueue->mutex);
+            completions.swap(mCompletionQueue->completions);
+        }
+
+        for (auto & completion : completions)
+        {
+            --mStats.pendingLoads;
+            mStats.pendingBytes -= completion.reservedBytes;
+
+            auto const findResult = mEntries.find(completion.handle);
+            if (findResult == mEntries.end())
+            {
+                // Unregistered while loading
+                continue;
+            }
+            auto & entry = findResult->second;
+            entry.loadPending = false;
+
+            auto const mipLevel = completion.mipLevel;
+            MFA_ASSERT(mipLevel + 1 == entry.residentLevel);
+            if (completion.data == nullptr || completion.data->Len() != completion.reservedBytes)
+            {
+                MFA_LOG_WARN(
+                    "Failed to stream mip level %d of %s",
+                    static_cast<int>(mipLevel),
+                    entry.texture->GetAddress().c_str()
+                );
+                // No retries, Otherwise a broken file would be read every frame
+                entry.loadFailed = true;
+                ++mStats.failedLoads;
+                continue;
+            }
+
+            entry.texture->SetMipmapData(mipLevel, completion.data);
+            entry.residentLevel = mipLevel;
+            mStats.residentBytes += completion.reservedBytes;
+            ++mStats.loads;
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Only the largest resident level of each texture can be evicted, So the chain stays contiguous
+    void TextureStreamer::BuildEvictionCandidates()
+    {
+        mEvictionCandidates.clear();
+        for (auto const & [handle, entry] : mEntries)
+        {
+            if (entry.residentLevel + 1 < entry.texture->GetMipCount())
+            {
+                mEvictionCandidates.emplace_back(EvictionCandidate{
+                    .lastUsedFrame = entry.lastUsedFrames[entry.residentLevel],
+                    .handle = handle
+                });
+            }
+        }
+        std::make_heap(mEvictionCandidates.begin(), mEvictionCandidates.end(), IsUsedMoreRecently<EvictionCandidate>);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool TextureStreamer::MakeRoom(size_t const extraBytes)
+    {
+        while (UsedBytes() + extraBytes > mParams.budgetBytes)
+        {
+            if (mEvictionCandidates.empty() == true)
+            {
+                return false;
+            }
+            auto const candidate = mEvictionCandidates.front();
+            // Levels that are needed this frame are never evicted, Neither are the ones after it
+            if (candidate.lastUsedFrame >= mFrame)
+            {
+                return false;
+            }
+            std::pop_heap(mEvictionCandidates.begin(), mEvictionCandidates.end(), IsUsedMoreRecently<EvictionCandidate>);
+            mEvictionCandidates.pop_back();
+
+            auto const findResult = mEntries.find(candidate.handle);
+            if (findResult == mEntries.end())
+            {
+                continue;
+            }
+            auto & entry = findResult->second;
+            // The load in flight expects the current chain
+            if (entry.loadPending == true)
+            {
+                continue;
+            }
+
+            auto const mipLevel = entry.residentLevel;
+            auto const size = entry.texture->GetMipmapSize(mipLevel);
+            entry.texture->ClearMipmapBuffer(mipLevel);
+            entry.residentLevel = mipLevel + 1;
+            mStats.residentBytes -= size;
+            mStats.evictedBytes += size;
+            ++mStats.evictions;
+
+            if (entry.residentLevel + 1 < entry.texture->GetMipCount())
+            {
+                mEvictionCandidates.emplace_back(EvictionCandidate{
+                    .lastUsedFrame = entry.lastUsedFrames[entry.residentLevel],
+                    .handle = candidate.handle
+                });
+                std::push_heap(mEvictionCandidates.begin(), mEvictionCandidates.end(), IsUsedMoreRecently<EvictionCandidate>);
+            }
+        }
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TextureStreamer::StartLoad(Handle const handle, Entry & entry, uint8_t const mipLevel)
+    {
+        auto const size = entry.texture->GetMipmapSize(mipLevel);
+        entry.loadPending = true;
+        ++mStats.pendingLoads;
+        mStats.pendingBytes += size;
+
+        auto task = [queue = mCompletionQueue, loader = entry.loader, handle, mipLevel, size]()->void
+        {
+            auto data = loader(mipLevel);
+            std::lock_guard lock(queue->mutex);
+            queue->completions.emplace_back(Completion{
+                .handle = handle,
+                .mipLevel = mipLevel,
+                .reservedBytes = size,
+                .data = std::move(data)
+            });
+        };
+
+        if (JobSystem::HasInstance() == false || JobSystem::AssignIOTask(task).valid() == false)
+        {
+            task();
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    size_t TextureStreamer::UsedBytes() const
+    {
+        return mStats.residentBytes + mStats.pendingBytes;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
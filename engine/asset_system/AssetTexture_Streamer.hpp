@@ -0,0 +1,158 @@
+#pragma once
+
+#include "AssetTexture.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace MFA::Asset::KTX
+{
+    class Reader;
+}
+
+namespace MFA::Asset
+{
+
+    // Keeps the cpu copy of the mip levels within a memory budget. Every texture keeps a contiguous chain of levels,
+    // From the smallest one up to its resident level. Requested levels are loaded on the io threads one level at a time
+    // (Smallest first, So the texture gets sharper progressively) and the least recently requested levels are evicted
+    // when the budget is exceeded. The smallest level is never evicted so there is always something to sample.
+    // Nothing here touches the gpu, The renderer is expected to read GetResidentMipLevel.
+    // Every function has to be called from the same thread (Usually the main thread).
+    class TextureStreamer
+    {
+    public:
+
+        using Handle = uint32_t;
+        static constexpr Handle InvalidHandle = 0;
+
+        // Runs on an io thread, Returns nullptr if the level could not be loaded
+        using MipLoader = std::function<std::shared_ptr<Blob>(uint8_t mipLevel)>;
+
+        struct Params
+        {
+            size_t budgetBytes = 256ull * 1024 * 1024;
+            // Loads that can be in flight at the same time
+            int maxPendingLoads = 8;
+        };
+
+        struct Stats
+        {
+            size_t budgetBytes = 0;
+            size_t residentBytes = 0;
+            // Reserved for the loads that are in flight
+            size_t pendingBytes = 0;
+            int pendingLoads = 0;
+            uint64_t loads = 0;
+            uint64_t failedLoads = 0;
+            uint64_t evictions = 0;
+            uint64_t evictedBytes = 0;
+        };
+
+        explicit TextureStreamer(Params const & params);
+
+        ~TextureStreamer();
+
+        TextureStreamer(TextureStreamer const &) = delete;
+        TextureStreamer(TextureStreamer &&) = delete;
+        TextureStreamer & operator = (TextureStreamer const &) = delete;
+        TextureStreamer & operator = (TextureStreamer &&) = delete;
+
+        // Dimension and size of every level has to be set. Resident levels that are not part of the contiguous chain
+        // that ends at the smallest level are released.
+        [[nodiscard]]
+        Handle Register(std::shared_ptr<Texture> texture, MipLoader loader);
+
+        // Only the smallest level is loaded right away, The rest is streamed from the mapped file
+        [[nodiscard]]
+        Handle Register(std::shared_ptr<KTX::Reader> const & reader);
+
+        // Resident levels stay in the texture but they no longer count toward the budget.
+        // A load that is in flight is dropped when it completes.
+        void Unregister(Handle handle);
+
+        // Largest level (Lowest number) that is needed this frame, Multiple requests in one frame keep the largest one.
+        // Levels that are not requested for a while become the first candidates for eviction.
+        void RequestMipLevel(Handle handle, uint8_t mipLevel);
+
+        // Applies the finished loads, Evicts and starts new loads. Call once per frame after the requests.
+        void Update();
+
+        // Waits for the loads that are in flight (The calling thread helps the job system meanwhile) and applies them
+        void Flush();
+
+        void SetBudget(size_t budgetBytes);
+
+        [[nodiscard]]
+        std::shared_ptr<Texture> const & GetTexture(Handle handle) const;
+
+        // Largest level whose data is resident along with every smaller level, Mip count if nothing is resident yet
+        [[nodiscard]]
+        uint8_t GetResidentMipLevel(Handle handle) const;
+
+        [[nodiscard]]
+        Stats GetStats() const;
+
+    private:
+
+        struct Entry
+        {
+            std::shared_ptr<Texture> texture{};
+            MipLoader loader{};
+            uint8_t residentLevel = 0;
+            uint8_t requestedLevel = 0;
+            uint64_t lastRequestFrame = 0;
+            bool loadPending = false;
+            bool loadFailed = false;
+            // Last frame that needed each level, Drives the lru order
+            std::vector<uint64_t> lastUsedFrames{};
+        };
+
+        struct Completion
+        {
+            Handle handle = InvalidHandle;
+            uint8_t mipLevel = 0;
+            size_t reservedBytes = 0;
+            std::shared_ptr<Blob> data{};
+        };
+
+        // Shared with the io jobs, So the streamer can be destroyed while loads are in flight
+        struct CompletionQueue
+        {
+            std::mutex mutex{};
+            std::vector<Completion> completions{};
+        };
+
+        struct EvictionCandidate
+        {
+            uint64_t lastUsedFrame = 0;
+            Handle handle = InvalidHandle;
+        };
+
+        void ApplyCompletions();
+
+        void BuildEvictionCandidates();
+
+        // Evicts until the resident and pending bytes plus the extra bytes fit the budget, Returns false if it cannot
+        bool MakeRoom(size_t extraBytes);
+
+        void StartLoad(Handle handle, Entry & entry, uint8_t mipLevel);
+
+        [[nodiscard]]
+        size_t UsedBytes() const;
+
+        Params mParams;
+        Stats mStats{};
+        uint64_t mFrame = 1;
+        Handle mNextHandle = InvalidHandle + 1;
+        std::unordered_map<Handle, Entry> mEntries{};
+        std::vector<EvictionCandidate> mEvictionCandidates{};
+        std::shared_ptr<CompletionQueue> mCompletionQueue{};
+
+    };
+
+}
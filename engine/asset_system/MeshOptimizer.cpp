@@ -0,0 +1,486 @@
+#include "MeshOptimizer.hpp"
+
+#include "BedrockAssert.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace MFA::MeshOptimizer
+{
+
+    //-------------------------------------------------------------------------------------------------
+
+    namespace
+    {
+        constexpr Index InvalidIndex = std::numeric_limits<Index>::max();
+
+        // Fifo cache that remembers when each vertex got transformed. A vertex is in the cache as long as less than
+        // cacheSize other vertices got transformed after it.
+        class FifoCache
+        {
+        public:
+
+            explicit FifoCache(size_t const vertexCount, int const cacheSize)
+                : mCacheSize(static_cast<uint32_t>(cacheSize))
+                , mTimestamps(vertexCount, 0)
+                , mTime(static_cast<uint32_t>(cacheSize) + 1)
+            {}
+
+            // Returns true on a cache miss
+            bool Access(Index const vertex)
+            {
+                if (mTime - mTimestamps[vertex] > mCacheSize)
+                {
+                    mTimestamps[vertex] = mTime++;
+                    return true;
+                }
+                return false;
+            }
+
+            int AccessTriangle(Index const * triangle)
+            {
+                return static_cast<int>(Access(triangle[0])) +
+                    static_cast<int>(Access(triangle[1])) +
+                    static_cast<int>(Access(triangle[2]));
+            }
+
+            void Flush()
+            {
+                mTime += mCacheSize + 1;
+            }
+
+        private:
+
+            uint32_t const mCacheSize;
+            std::vector<uint32_t> mTimestamps;
+            uint32_t mTime;
+
+        };
+
+        // Forsyth's tuning values
+        constexpr int ForsythCacheSize = 32;
+        constexpr float CacheDecayPower = 1.5f;
+        constexpr float LastTriangleScore = 0.75f;
+        constexpr float ValenceBoostScale = 2.0f;
+        constexpr float ValenceBoostPower = 0.5f;
+
+        float ForsythVertexScore(int const cachePosition, uint32_t const remainingTriangles)
+        {
+            if (remainingTriangles == 0)
+            {
+                return -1.0f;
+            }
+
+            float score = 0.0f;
+            if (cachePosition >= 0)
+            {
+                if (cachePosition < 3)
+                {
+                    // The last triangle is always in the cache, Using it again does not help the next triangle
+                    score = LastTriangleScore;
+                }
+                else
+                {
+                    constexpr float scaler = 1.0f / static_cast<float>(ForsythCacheSize - 3);
+                    score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scaler, CacheDecayPower);
+                }
+            }
+
+            // Vertices with few triangles left get a boost, So we do not leave lonely triangles behind
+            score += ValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -ValenceBoostPower);
+            return score;
+        }
+
+        glm::vec3 ReadPosition(uint8_t const * positions, size_t const stride, Index const vertex)
+        {
+            glm::vec3 position{};
+            std::memcpy(&position, positions + stride * vertex, sizeof(glm::vec3));
+            return position;
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    float VertexCacheStats::ACMR() const
+    {
+        return triangleCount > 0
+            ? static_cast<float>(transformedVertexCount) / static_cast<float>(triangleCount)
+            : 0.0f;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    float VertexCacheStats::ATVR() const
+    {
+        return vertexCount > 0
+            ? static_cast<float>(transformedVertexCount) / static_cast<float>(vertexCount)
+            : 0.0f;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    VertexCacheStats & VertexCacheStats::operator += (VertexCacheStats const & other)
+    {
+        triangleCount += other.triangleCount;
+        vertexCount += other.vertexCount;
+        transformedVertexCount += other.transformedVertexCount;
+        return *this;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    VertexCacheStats AnalyzeVertexCache(
+        Index const * indices,
+        size_t const indexCount,
+        size_t const vertexCount,
+        int const cacheSize
+    )
+    {
+        MFA_ASSERT(indexCount % 3 == 0);
+
+        VertexCacheStats stats{};
+        stats.triangleCount = indexCount / 3;
+
+        FifoCache cache{vertexCount, cacheSize};
+        std::vector<bool> isReferenced(vertexCount, false);
+        for (size_t i = 0; i < indexCount; ++i)
+        {
+            auto const vertex = indices[i];
+            MFA_ASSERT(vertex < vertexCount);
+            if (cache.Access(vertex) == true)
+            {
+                ++stats.transformedVertexCount;
+            }
+            if (isReferenced[vertex] == false)
+            {
+                isReferenced[vertex] = true;
+                ++stats.vertexCount;
+            }
+        }
+
+        return stats;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void OptimizeVertexCache(Index * indices, size_t const indexCount, size_t const vertexCount)
+    {
+        MFA_ASSERT(indexCount % 3 == 0);
+        size_t const triangleCount = indexCount / 3;
+        if (triangleCount < 2)
+        {
+            return;
+        }
+
+        // Triangles of each vertex that are not emitted yet, Stored as adjacency[offsets[v], offsets[v] + remaining[v])
+        std::vector<uint32_t> remaining(vertexCount, 0);
+        for (size_t i = 0; i < indexCount; ++i)
+        {
+            MFA_ASSERT(indices[i] < vertexCount);
+            ++remaining[indices[i]];
+        }
+        std::vector<uint32_t> offsets(vertexCount + 1, 0);
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            offsets[v + 1] = offsets[v] + remaining[v];
+        }
+        std::vector<uint32_t> adjacency(indexCount);
+        {
+            std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < indexCount; ++i)
+            {
+                adjacency[cursors[indices[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        std::vector<int> cachePositions(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            vertexScores[v] = ForsythVertexScore(-1, remaining[v]);
+        }
+
+        std::vector<float> triangleScores(triangleCount);
+        std::vector<bool> isEmitted(triangleCount, false);
+        int64_t bestTriangle = 0;
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            auto const * triangle = indices + t * 3;
+            triangleScores[t] = vertexScores[triangle[0]] + vertexScores[triangle[1]] + vertexScores[triangle[2]];
+            if (triangleScores[t] > triangleScores[bestTriangle])
+            {
+                bestTriangle = static_cast<int64_t>(t);
+            }
+        }
+
+        std::vector<Index> output{};
+        output.reserve(indexCount);
+
+        std::array<Index, ForsythCacheSize + 3> cache{};
+        std::array<Index, ForsythCacheSize + 3> newCache{};
+        int cacheCount = 0;
+        size_t inputCursor = 0;
+
+        while (bestTriangle >= 0)
+        {
+            auto const * triangle = indices + bestTriangle * 3;
+            isEmitted[bestTriangle] = true;
+            output.insert(output.end(), triangle, triangle + 3);
+
+            for (int i = 0; i < 3; ++i)
+            {
+                auto const vertex = triangle[i];
+                auto * begin = adjacency.data() + offsets[vertex];
+                auto * end = begin + remaining[vertex];
+                auto * position = std::find(begin, end, static_cast<uint32_t>(bestTriangle));
+                MFA_ASSERT(position != end);
+                std::swap(*position, *(end - 1));
+                --remaining[vertex];
+            }
+
+            // Vertices of the emitted triangle move to the front, Everything else shifts back
+            int newCacheCount = 0;
+            for (int i = 0; i < 3; ++i)
+            {
+                if (std::find(newCache.begin(), newCache.begin() + newCacheCount, triangle[i]) == newCache.begin() + newCacheCount)
+                {
+                    newCache[newCacheCount++] = triangle[i];
+                }
+            }
+            for (int i = 0; i < cacheCount; ++i)
+            {
+                auto const vertex = cache[i];
+                if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+                {
+                    newCache[newCacheCount++] = vertex;
+                }
+            }
+
+            // Includes the vertices that just fell out of the cache
+            for (int i = 0; i < newCacheCount; ++i)
+            {
+                auto const vertex = newCache[i];
+                cachePositions[vertex] = i < ForsythCacheSize ? i : -1;
+                float const newScore = ForsythVertexScore(cachePositions[vertex], remaining[vertex]);
+                float const delta = newScore - vertexScores[vertex];
+                vertexScores[vertex] = newScore;
+                for (auto a = offsets[vertex]; a < offsets[vertex] + remaining[vertex]; ++a)
+                {
+                    triangleScores[adjacency[a]] += delta;
+                }
+            }
+
+            std::swap(cache, newCache);
+            cacheCount = std::min(newCacheCount, ForsythCacheSize);
+
+            bestTriangle = -1;
+            float bestScore = -std::numeric_limits<float>::max();
+            for (int i = 0; i < cacheCount; ++i)
+            {
+                auto const vertex = cache[i];
+                for (auto a = offsets[vertex]; a < offsets[vertex] + remaining[vertex]; ++a)
+                {
+                    auto const candidate = adjacency[a];
+                    if (triangleScores[candidate] > bestScore)
+                    {
+                        bestScore = triangleScores[candidate];
+                        bestTriangle = candidate;
+                    }
+                }
+            }
+
+            // Dead end, We continue from the next triangle that is left in the input order
+            if (bestTriangle < 0)
+            {
+                while (inputCursor < triangleCount && isEmitted[inputCursor] == true)
+                {
+                    ++inputCursor;
+                }
+                if (inputCursor < triangleCount)
+                {
+                    bestTriangle = static_cast<int64_t>(inputCursor);
+                }
+            }
+        }
+
+        MFA_ASSERT(output.size() == indexCount);
+        std::memcpy(indices, output.data(), indexCount * sizeof(Index));
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void OptimizeOverdraw(
+        Index * indices,
+        size_t const indexCount,
+        void const * positions,
+        size_t const positionStride,
+        size_t const vertexCount,
+        float const threshold
+    )
+    {
+        MFA_ASSERT(indexCount % 3 == 0);
+        size_t const triangleCount = indexCount / 3;
+        if (triangleCount < 2)
+        {
+            return;
+        }
+
+        // Hard boundaries: Triangles that miss the cache with all of their vertices start a new strip
+        std::vector<size_t> hardClusters{};
+        {
+            FifoCache cache{vertexCount, DefaultCacheSize};
+            for (size_t t = 0; t < triangleCount; ++t)
+            {
+                if (cache.AccessTriangle(indices + t * 3) == 3 || t == 0)
+                {
+                    hardClusters.emplace_back(t);
+                }
+            }
+        }
+        hardClusters.emplace_back(triangleCount);
+
+        // Soft boundaries: We split a hard cluster wherever the ACMR so far is within the threshold of the whole cluster
+        std::vector<size_t> clusters{};
+        {
+            FifoCache cache{vertexCount, DefaultCacheSize};
+            for (size_t c = 0; c + 1 < hardClusters.size(); ++c)
+            {
+                size_t const begin = hardClusters[c];
+                size_t const end = hardClusters[c + 1];
+
+                cache.Flush();
+                size_t clusterMisses = 0;
+                for (size_t t = begin; t < end; ++t)
+                {
+                    clusterMisses += cache.AccessTriangle(indices + t * 3);
+                }
+                float const clusterACMR = static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+                cache.Flush();
+                clusters.emplace_back(begin);
+                size_t start = begin;
+                size_t misses = 0;
+                for (size_t t = begin; t < end; ++t)
+                {
+                    misses += cache.AccessTriangle(indices + t * 3);
+                    float const acmr = static_cast<float>(misses) / static_cast<float>(t + 1 - start);
+                    if (t + 1 < end && acmr <= clusterACMR * threshold)
+                    {
+                        clusters.emplace_back(t + 1);
+                        start = t + 1;
+                        misses = 0;
+                        cache.Flush();
+                    }
+                }
+            }
+        }
+        clusters.emplace_back(triangleCount);
+        size_t const clusterCount = clusters.size() - 1;
+
+        auto const * positionBytes = static_cast<uint8_t const *>(positions);
+
+        glm::vec3 meshCentroid{};
+        float meshArea = 0.0f;
+        std::vector<glm::vec3> clusterCentroids(clusterCount);
+        std::vector<glm::vec3> clusterNormals(clusterCount);
+        for (size_t c = 0; c < clusterCount; ++c)
+        {
+            glm::vec3 centroid{};
+            glm::vec3 normal{};
+            float area = 0.0f;
+            for (size_t t = clusters[c]; t < clusters[c + 1]; ++t)
+            {
+                auto const * triangle = indices + t * 3;
+                MFA_ASSERT(triangle[0] < vertexCount && triangle[1] < vertexCount && triangle[2] < vertexCount);
+                auto const p0 = ReadPosition(positionBytes, positionStride, triangle[0]);
+                auto const p1 = ReadPosition(positionBytes, positionStride, triangle[1]);
+                auto const p2 = ReadPosition(positionBytes, positionStride, triangle[2]);
+                auto const areaNormal = glm::cross(p1 - p0, p2 - p0);
+                float const triangleArea = glm::length(areaNormal);
+                centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+                normal += areaNormal;
+                area += triangleArea;
+            }
+            meshCentroid += centroid;
+            meshArea += area;
+            clusterCentroids[c] = area > 0.0f ? centroid / area : centroid;
+            float const normalLength = glm::length(normal);
+            clusterNormals[c] = normalLength > 0.0f ? normal / normalLength : normal;
+        }
+        if (meshArea > 0.0f)
+        {
+            meshCentroid /= meshArea;
+        }
+
+        // Clusters that face outwards are likely to occlude the others, So they go first
+        std::vector<float> sortKeys(clusterCount);
+        for (size_t c = 0; c < clusterCount; ++c)
+        {
+            sortKeys[c] = glm::dot(clusterCentroids[c] - meshCentroid, clusterNormals[c]);
+        }
+        std::vector<size_t> order(clusterCount);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&sortKeys](size_t const a, size_t const b)->bool
+        {
+            return sortKeys[a] > sortKeys[b];
+        });
+
+        std::vector<Index> output{};
+        output.reserve(indexCount);
+        for (auto const c : order)
+        {
+            output.insert(output.end(), indices + clusters[c] * 3, indices + clusters[c + 1] * 3);
+        }
+        std::memcpy(indices, output.data(), indexCount * sizeof(Index));
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    size_t OptimizeVertexFetch(
+        void * vertices,
+        size_t const vertexSize,
+        Index * indices,
+        size_t const indexCount,
+        size_t const vertexCount
+    )
+    {
+        std::vector<Index> remap(vertexCount, InvalidIndex);
+        Index nextVertex = 0;
+        for (size_t i = 0; i < indexCount; ++i)
+        {
+            auto & newIndex = remap[indices[i]];
+            if (newIndex == InvalidIndex)
+            {
+                newIndex = nextVertex++;
+            }
+            indices[i] = newIndex;
+        }
+        auto const referencedCount = static_cast<size_t>(nextVertex);
+        for (auto & newIndex : remap)
+        {
+            if (newIndex == InvalidIndex)
+            {
+                newIndex = nextVertex++;
+            }
+        }
+
+        auto * bytes = static_cast<uint8_t *>(vertices);
+        std::vector<uint8_t> source(bytes, bytes + vertexSize * vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            std::memcpy(bytes + vertexSize * remap[v], source.data() + vertexSize * v, vertexSize);
+        }
+
+        return referencedCount;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Triangle and vertex reordering for the gpu. Every function works on a single range of vertices, So the indices
+// have to be relative to the first vertex of the range.
+namespace MFA::MeshOptimizer
+{
+    using Index = uint32_t;
+
+    // Fifo cache size that we simulate for the statistics, Close to what desktop gpus effectively have
+    static constexpr int DefaultCacheSize = 16;
+
+    struct VertexCacheStats
+    {
+        size_t triangleCount = 0;
+        size_t vertexCount = 0;                 // Referenced vertices
+        size_t transformedVertexCount = 0;      // Cache misses
+
+        // Average cache miss ratio, Transformed vertices per triangle. 0.5 is ideal and 3 is the worst.
+        [[nodiscard]]
+        float ACMR() const;
+
+        // Average transform to vertex ratio, Transformed vertices per referenced vertex. 1 is ideal.
+        [[nodiscard]]
+        float ATVR() const;
+
+        VertexCacheStats & operator += (VertexCacheStats const & other);
+    };
+
+    [[nodiscard]]
+    VertexCacheStats AnalyzeVertexCache(
+        Index const * indices,
+        size_t indexCount,
+        size_t vertexCount,
+        int cacheSize = DefaultCacheSize
+    );
+
+    // Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+    void OptimizeVertexCache(Index * indices, size_t indexCount, size_t vertexCount);
+
+    // Sander et al. "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw". Splits the cache optimized
+    // order into clusters and draws the clusters that face away from the center first, So they occlude the rest.
+    // Threshold is how much worse than the original the ACMR of a cluster may get (1.05 allows 5%).
+    void OptimizeOverdraw(
+        Index * indices,
+        size_t indexCount,
+        void const * positions,                 // glm::vec3 per vertex
+        size_t positionStride,
+        size_t vertexCount,
+        float threshold = 1.05f
+    );
+
+    // Reorders the vertices in the order that the indices reference them and rewrites the indices.
+    // Unreferenced vertices move to the end. Returns the number of referenced vertices.
+    size_t OptimizeVertexFetch(
+        void * vertices,
+        size_t vertexSize,
+        Index * indices,
+        size_t indexCount,
+        size_t vertexCount
+    );
+}
@@ -64,6 +64,7 @@ type const & Get##variable() const                              \
 protected:                                                      \
 
 
+// Prefer JobSystem::ParallelFor for new code, This one is only valid inside an OpenMP parallel region.
 #define MFA_PARALLEL_BLOCK(size)                                                                        \
 auto const threadNumber = omp_get_thread_num();                                                         \
 auto const threadCount = omp_get_num_threads();                                                         \
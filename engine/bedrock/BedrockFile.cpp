@@ -2,41 +2,148 @@
 
 #include <filesystem>
 #include <fstream>
-#include <vector>
 
 #include "BedrockAssert.hpp"
 #include "BedrockLog.hpp"
+#include "BedrockPlatforms.hpp"
 
+#if defined(__PLATFORM_WIN__)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace MFA::File
 {
+
+    //-------------------------------------------------------------------------------------------------
+
     std::shared_ptr<Blob> Read(std::string const & path)
     {
         if (MFA_VERIFY(std::filesystem::exists(path)))
-		{
-            std::ifstream file(path, std::ios::binary);
-			std::string line{};
-			
-            /*std::string data {};
-            while (std::getline(file, line))
-			{
-                data += line;
-			}*/
-            std::shared_ptr<Blob> blob = nullptr;
-            if (file.good())
+        {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (file.good() == false)
             {
-                std::vector<uint8_t> data((
-                    std::istreambuf_iterator<char>(file)),
-                    (std::istreambuf_iterator<char>())
-                );
-
-                blob = Memory::Alloc(data.data(), data.size());
+                return nullptr;
             }
 
-            file.close();
+            auto const size = static_cast<size_t>(file.tellg());
+            file.seekg(0, std::ios::beg);
+
+            std::shared_ptr<Blob> blob = Memory::AllocSize(size);
+            if (file.read(reinterpret_cast<char *>(blob->Ptr()), static_cast<std::streamsize>(size)).good() == false)
+            {
+                MFA_LOG_WARN("Failed to read file %s", path.c_str());
+                return nullptr;
+            }
 
             return blob;
         }
         return nullptr;
     }
-}
\ No newline at end of file
+
+    //-------------------------------------------------------------------------------------------------
+
+    MappedBlob::MappedBlob(uint8_t * ptr, size_t const len)
+    {
+        _ptr = ptr;
+        _len = len;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    MappedBlob::~MappedBlob()
+    {
+        if (_ptr == nullptr)
+        {
+            return;
+        }
+#if defined(__PLATFORM_WIN__)
+        UnmapViewOfFile(_ptr);
+#else
+        munmap(_ptr, _len);
+#endif
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<BaseBlob const> Map(std::string const & path, MapParams const & params)
+    {
+        if (MFA_VERIFY(std::filesystem::exists(path)) == false)
+        {
+            return nullptr;
+        }
+
+        uint8_t * ptr = nullptr;
+        size_t len = 0;
+
+#if defined(__PLATFORM_WIN__)
+        // The view keeps the mapping alive, So both handles can be closed right after mapping
+        HANDLE const file = CreateFileA(
+            path.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | (params.sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS),
+            nullptr
+        );
+        if (file != INVALID_HANDLE_VALUE)
+        {
+            LARGE_INTEGER size{};
+            if (GetFileSizeEx(file, &size) != 0 && size.QuadPart > 0)
+            {
+                HANDLE const mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mapping != nullptr)
+                {
+                    ptr = static_cast<uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                    len = ptr != nullptr ? static_cast<size_t>(size.QuadPart) : 0;
+                    CloseHandle(mapping);
+                }
+            }
+            CloseHandle(file);
+        }
+#else
+        int const file = open(path.c_str(), O_RDONLY);
+        if (file >= 0)
+        {
+            struct stat status{};
+            if (fstat(file, &status) == 0 && status.st_size > 0)
+            {
+                int flags = MAP_PRIVATE;
+#if defined(__PLATFORM_LINUX__)
+                if (params.populate)
+                {
+                    flags |= MAP_POPULATE;
+                }
+#endif
+                void * mapping = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, flags, file, 0);
+                if (mapping != MAP_FAILED)
+                {
+                    ptr = static_cast<uint8_t *>(mapping);
+                    len = static_cast<size_t>(status.st_size);
+                    madvise(mapping, len, params.sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+                }
+            }
+            // The mapping does not need the descriptor
+            close(file);
+        }
+#endif
+
+        if (ptr == nullptr)
+        {
+            return Read(path);
+        }
+        return std::make_shared<MappedBlob>(ptr, len);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
@@ -6,5 +6,34 @@
 
 namespace MFA::File
 {
+    // Copies the whole file into a new blob with a single read
     std::shared_ptr<Blob> Read(std::string const & path);
-}
\ No newline at end of file
+
+    struct MapParams
+    {
+        // Lets the os read ahead aggressively, Good for files that are consumed from start to end
+        bool sequential = true;
+        // Faults in every page during the map call instead of on first access (Linux only)
+        bool populate = false;
+    };
+
+    // Read only view of a mapped file, The file stays mapped as long as the blob is alive
+    class MappedBlob : public BaseBlob
+    {
+    public:
+
+        // Takes the ownership of the mapping
+        explicit MappedBlob(uint8_t * ptr, size_t len);
+        ~MappedBlob();
+
+        MappedBlob(MappedBlob const &) = delete;
+        MappedBlob(MappedBlob &&) = delete;
+        MappedBlob & operator = (MappedBlob const &) = delete;
+        MappedBlob & operator = (MappedBlob &&) = delete;
+
+    };
+
+    // Maps the file into memory without copying it, Writing to the data is not allowed.
+    // Falls back to Read if the file cannot be mapped (Empty files for example).
+    std::shared_ptr<BaseBlob const> Map(std::string const & path, MapParams const & params = {});
+}
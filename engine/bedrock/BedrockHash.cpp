@@ -0,0 +1,118 @@
+#include "BedrockHash.hpp"
+
+#include <cstring>
+
+namespace MFA::Hash
+{
+
+    //-------------------------------------------------------------------------------------------------
+
+    namespace
+    {
+        constexpr uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+        constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+        constexpr uint64_t Prime3 = 0x165667B19E3779F9ull;
+        constexpr uint64_t Prime4 = 0x85EBCA77C2B2AE63ull;
+        constexpr uint64_t Prime5 = 0x27D4EB2F165667C5ull;
+
+        uint64_t RotateLeft(uint64_t const value, int const bits)
+        {
+            return (value << bits) | (value >> (64 - bits));
+        }
+
+        uint64_t Read64(uint8_t const * ptr)
+        {
+            uint64_t value;
+            std::memcpy(&value, ptr, sizeof(value));
+            return value;
+        }
+
+        uint32_t Read32(uint8_t const * ptr)
+        {
+            uint32_t value;
+            std::memcpy(&value, ptr, sizeof(value));
+            return value;
+        }
+
+        uint64_t Round(uint64_t accumulator, uint64_t const input)
+        {
+            accumulator += input * Prime2;
+            accumulator = RotateLeft(accumulator, 31);
+            return accumulator * Prime1;
+        }
+
+        uint64_t MergeRound(uint64_t accumulator, uint64_t const value)
+        {
+            accumulator ^= Round(0, value);
+            return accumulator * Prime1 + Prime4;
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    uint64_t Hash64(void const * data, size_t const length, uint64_t const seed)
+    {
+        auto const * ptr = static_cast<uint8_t const *>(data);
+        auto const * const end = ptr + length;
+
+        uint64_t hash;
+        if (length >= 32)
+        {
+            uint64_t v1 = seed + Prime1 + Prime2;
+            uint64_t v2 = seed + Prime2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - Prime1;
+
+            auto const * const limit = end - 32;
+            do
+            {
+                v1 = Round(v1, Read64(ptr));
+                v2 = Round(v2, Read64(ptr + 8));
+                v3 = Round(v3, Read64(ptr + 16));
+                v4 = Round(v4, Read64(ptr + 24));
+                ptr += 32;
+            } while (ptr <= limit);
+
+            hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+            hash = MergeRound(hash, v1);
+            hash = MergeRound(hash, v2);
+            hash = MergeRound(hash, v3);
+            hash = MergeRound(hash, v4);
+        }
+        else
+        {
+            hash = seed + Prime5;
+        }
+
+        hash += static_cast<uint64_t>(length);
+
+        while (ptr + 8 <= end)
+        {
+            hash ^= Round(0, Read64(ptr));
+            hash = RotateLeft(hash, 27) * Prime1 + Prime4;
+            ptr += 8;
+        }
+        if (ptr + 4 <= end)
+        {
+            hash ^= static_cast<uint64_t>(Read32(ptr)) * Prime1;
+            hash = RotateLeft(hash, 23) * Prime2 + Prime3;
+            ptr += 4;
+        }
+        while (ptr < end)
+        {
+            hash ^= static_cast<uint64_t>(*ptr) * Prime5;
+            hash = RotateLeft(hash, 11) * Prime1;
+            ++ptr;
+        }
+
+        hash ^= hash >> 33;
+        hash *= Prime2;
+        hash ^= hash >> 29;
+        hash *= Prime3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
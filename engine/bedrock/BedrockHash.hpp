@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace MFA::Hash
+{
+    // XXH64 by Yann Collet, Fast enough to hash whole asset files on load
+    [[nodiscard]]
+    uint64_t Hash64(void const * data, size_t length, uint64_t seed = 0);
+
+    // Order dependent, Combine(a, b) != Combine(b, a)
+    [[nodiscard]]
+    inline uint64_t Combine(uint64_t const hash, uint64_t const value)
+    {
+        return hash ^ (value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2));
+    }
+}
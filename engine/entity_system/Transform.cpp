@@ -1,85 +1,205 @@
 #include "Transform.hpp"
 
+#include "BedrockAssert.hpp"
+#include "BedrockLog.hpp"
 #include "BedrockMath.hpp"
 #include "imgui.h"
 
+#include <algorithm>
+
 namespace MFA
 {
     
 	//-------------------------------------------------------------------------------------------------
 
-    Transform::Transform() = default;
-	
+	Transform::Transform()
+		: Transform(TransformStore::Default())
+	{}
+
 	//-------------------------------------------------------------------------------------------------
 
-	bool Transform::SetEulerAngles(glm::vec3 const & eulerAngles)
+	Transform::Transform(std::shared_ptr<TransformStore> store)
+		: mStore(std::move(store))
+	{
+		MFA_ASSERT(mStore != nullptr);
+		mId = mStore->Create(this);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	Transform::~Transform()
 	{
-		mIsLocalTransformDirty |= mLocalRotation.SetEulerAngles(eulerAngles);
-		if (mIsLocalTransformDirty == true)
+		if (mStore != nullptr)
 		{
-			SetGlobalTransformDirty();
-			return true;
+			// Children become roots in the store
+			ReplaceInParent(this, nullptr);
+			mStore->Destroy(mId);
 		}
-		return false;
 	}
 
 	//-------------------------------------------------------------------------------------------------
 
-	bool Transform::SetLocalQuaternion(glm::quat const & quaternion)
+	Transform::Transform(Transform const & other)
+		: name(other.name)
+		, tag(other.tag)
+		, mStore(other.mStore)
 	{
-		mIsLocalTransformDirty |= mLocalRotation.SetQuaternion(quaternion);
-		if (mIsLocalTransformDirty == true)
+		mId = mStore->Create(this);
+		CopyLocalValues(other);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	Transform::Transform(Transform && other) noexcept
+		: name(std::move(other.name))
+		, tag(std::move(other.tag))
+		, mStore(std::move(other.mStore))
+		, mId(other.mId)
+		, mChildren(std::move(other.mChildren))
+	{
+		other.mId = TransformStore::InvalidId;
+		if (mStore != nullptr)
 		{
-			SetGlobalTransformDirty();
-			return true;
+			mStore->SetHandle(mId, this);
+			ReplaceInParent(&other, this);
 		}
-		return false;
 	}
 
 	//-------------------------------------------------------------------------------------------------
 
-	glm::mat4 const& Transform::LocalTransform()
+	Transform & Transform::operator=(Transform const & rhs)
 	{
-		if (mIsLocalTransformDirty == true)
+		if (this != &rhs)
 		{
-			mLocalTransform = mLocalExtraTransform * 
-				Math::Translate(mLocalPosition) * 
-				mLocalRotation.GetMatrix() *
-				Math::Scale(mLocalScale);
-
-			mIsLocalTransformDirty = false;
+			name = rhs.name;
+			tag = rhs.tag;
+			CopyLocalValues(rhs);
 		}
-		return mLocalTransform;
+		return *this;
 	}
 
 	//-------------------------------------------------------------------------------------------------
 
-	glm::mat4 const& Transform::GlobalTransform()
+	Transform & Transform::operator=(Transform && rhs) noexcept
 	{
-		if (mGlobalTransformDirty == true)
+		if (this != &rhs)
 		{
-			auto const & localTransform = LocalTransform();
-			mGlobalTransform = glm::identity<glm::mat4>();
-			if (mParent != nullptr)
+			if (mStore != nullptr)
+			{
+				ReplaceInParent(this, nullptr);
+				mStore->Destroy(mId);
+			}
+			name = std::move(rhs.name);
+			tag = std::move(rhs.tag);
+			mStore = std::move(rhs.mStore);
+			mId = rhs.mId;
+			mChildren = std::move(rhs.mChildren);
+			rhs.mId = TransformStore::InvalidId;
+			if (mStore != nullptr)
 			{
-				mGlobalTransform *= mParent->GlobalTransform();
+				mStore->SetHandle(mId, this);
+				ReplaceInParent(&rhs, this);
 			}
-			mGlobalTransform *= localTransform;
-			mGlobalTransformDirty = false;
+			mCacheGeneration = UINT64_MAX;
 		}
-		return mGlobalTransform;
+		return *this;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	bool Transform::SetLocalPosition(glm::vec3 const & position)
+	{
+		return mStore->SetLocalPosition(mId, position);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	glm::vec3 const & Transform::GetLocalPosition() const
+	{
+		return mStore->GetLocalPosition(mId);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	bool Transform::SetLocalRotation(Rotation const & rotation)
+	{
+		return mStore->SetLocalRotation(mId, rotation);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	Rotation const & Transform::GetLocalRotation() const
+	{
+		return mStore->GetLocalRotation(mId);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	bool Transform::SetEulerAngles(glm::vec3 const & eulerAngles)
+	{
+		return mStore->SetEulerAngles(mId, eulerAngles);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	bool Transform::SetLocalQuaternion(glm::quat const & quaternion)
+	{
+		return mStore->SetLocalQuaternion(mId, quaternion);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	bool Transform::SetLocalScale(glm::vec3 const & scale)
+	{
+		return mStore->SetLocalScale(mId, scale);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	glm::vec3 const & Transform::GetLocalScale() const
+	{
+		return mStore->GetLocalScale(mId);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	bool Transform::SetLocalExtraTransform(glm::mat4 const & transform)
+	{
+		return mStore->SetLocalExtraTransform(mId, transform);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	glm::mat4 const & Transform::GetLocalExtraTransform() const
+	{
+		return mStore->GetLocalExtraTransform(mId);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	glm::mat4 const& Transform::LocalTransform()
+	{
+		return mStore->GetLocalTransform(mId);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	glm::mat4 const& Transform::GlobalTransform()
+	{
+		return mStore->GetWorldTransform(mId);
 	}
 
 	//-------------------------------------------------------------------------------------------------
 
 	Transform * Transform::Parent() const
 	{
-		return mParent;
+		auto const parent = mStore->GetParent(mId);
+		return parent != TransformStore::InvalidId ? mStore->GetHandle(parent) : nullptr;
 	}
 
 	//-------------------------------------------------------------------------------------------------
 
-	std::set<Transform*> const& Transform::Children()
+	std::vector<Transform*> const & Transform::Children() const noexcept
 	{
 		return mChildren;
 	}
@@ -88,19 +208,27 @@ namespace MFA
 
 	void Transform::SetParent(Transform* parent)
 	{
-		if (mParent == parent)
+		if (parent != nullptr && parent->mStore != mStore)
 		{
+			MFA_LOG_ERROR("Transform %s cannot be parented to a transform of another store", name.c_str());
 			return;
 		}
-		if (mParent != nullptr)
+		auto * oldParent = Parent();
+		if (mStore->SetParent(mId, parent != nullptr ? parent->mId : TransformStore::InvalidId) == false)
 		{
-			mParent->RemoveChild(this);
+			MFA_LOG_ERROR("Transform %s cannot be parented to one of its own descendants", name.c_str());
+			return;
 		}
-		mParent = parent;
-		mGlobalTransformDirty = true;
-		if (mParent != nullptr)
+		if (oldParent != parent)
 		{
-			mParent->AddChild(this);
+			if (oldParent != nullptr)
+			{
+				std::erase(oldParent->mChildren, this);
+			}
+			if (parent != nullptr)
+			{
+				parent->mChildren.emplace_back(this);
+			}
 		}
 	}
 
@@ -108,20 +236,17 @@ namespace MFA
 
 	void Transform::AddChild(Transform* child)
 	{
-		if (mChildren.contains(child) == false)
-		{
-			mChildren.emplace(child);
-			child->SetParent(this);
-		}
+		MFA_ASSERT(child != nullptr);
+		child->SetParent(this);
 	}
 
 	//-------------------------------------------------------------------------------------------------
 
 	void Transform::RemoveChild(Transform* child)
 	{
-		if (mChildren.contains(child) == true)
+		MFA_ASSERT(child != nullptr);
+		if (child->Parent() == this)
 		{
-			mChildren.erase(child);
 			child->SetParent(nullptr);
 		}
 	}
@@ -130,6 +255,7 @@ namespace MFA
 
 	glm::vec3 const & Transform::Forward()
 	{
+		UpdateCache();
 		if (mForwardDirty == true)
 		{
 			mForward = glm::normalize(GlobalTransform() * Math::ForwardVec4W0);
@@ -142,6 +268,7 @@ namespace MFA
 
 	glm::vec3 const & Transform::Right()
 	{
+		UpdateCache();
 		if (mRightDirty == true)
 		{
 			mRight = glm::normalize(GlobalTransform() * Math::RightVec4W0);
@@ -154,6 +281,7 @@ namespace MFA
 
 	glm::vec3 const & Transform::Up()
 	{
+		UpdateCache();
 		if (mUpDirty == true)
 		{
 			mUp = glm::normalize(GlobalTransform() * Math::UpVec4W0);
@@ -166,6 +294,7 @@ namespace MFA
 
 	glm::vec3 const & Transform::GlobalPosition()
 	{
+		UpdateCache();
 		if (mGlobalPositionDirty == true)
 		{
 			mGlobalPosition = GlobalTransform() * glm::vec4{0.0, 0.0, 0.0, 1.0f};
@@ -178,6 +307,7 @@ namespace MFA
 
 	Rotation const &Transform::GlobalRotation()
     {
+		UpdateCache();
         if (mGlobalRotationDirty == true)
         {
             mGlobalRotation.SetQuaternion(glm::quatLookAt(Forward(), Math::UpVec3));
@@ -190,55 +320,90 @@ namespace MFA
 
 	void Transform::DebugUI()
 	{
-		bool isDirty = false;
-
-		if(ImGui::InputFloat3("Position",reinterpret_cast<float *>(&mLocalPosition)))
+		// The store owns the values, So the widgets edit copies that go through the setters
+		glm::vec3 position = GetLocalPosition();
+		if(ImGui::InputFloat3("Position",reinterpret_cast<float *>(&position)))
 		{
-			isDirty = true;
+			SetLocalPosition(position);
 		}
 
 		{
-			glm::vec3 eulerAngles = mLocalRotation.GetEulerAngles();
+			glm::vec3 eulerAngles = GetLocalRotation().GetEulerAngles();
 			if(ImGui::InputFloat3("Euler angles",reinterpret_cast<float *>(&eulerAngles)))
 			{
-				mLocalRotation.SetEulerAngles(eulerAngles);
-				isDirty = true;
+				SetEulerAngles(eulerAngles);
 			}
 		}
 
-		if (ImGui::InputFloat3("Scale", reinterpret_cast<float *>(&mLocalScale)))
+		glm::vec3 scale = GetLocalScale();
+		if (ImGui::InputFloat3("Scale", reinterpret_cast<float *>(&scale)))
 		{
-			isDirty = true;
+			SetLocalScale(scale);
 		}
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	std::shared_ptr<TransformStore> const & Transform::GetStore() const noexcept
+	{
+		return mStore;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+
+	TransformStore::Id Transform::GetId() const noexcept
+	{
+		return mId;
+	}
+
+	//-------------------------------------------------------------------------------------------------
 
-		if (isDirty == true)
+	void Transform::UpdateCache()
+	{
+		mStore->Update();
+		auto const generation = mStore->GetGeneration();
+		if (mCacheGeneration != generation)
 		{
-			SetLocalTransformDirty();
+			mCacheGeneration = generation;
+			mGlobalPositionDirty = true;
+			mGlobalRotationDirty = true;
+			mForwardDirty = true;
+			mUpDirty = true;
+			mRightDirty = true;
 		}
 	}
 
 	//-------------------------------------------------------------------------------------------------
 
-	void Transform::SetLocalTransformDirty()
+	void Transform::CopyLocalValues(Transform const & other)
 	{
-		mIsLocalTransformDirty = true;
-		SetGlobalTransformDirty();
+		SetLocalPosition(other.GetLocalPosition());
+		SetLocalRotation(other.GetLocalRotation());
+		SetLocalScale(other.GetLocalScale());
+		SetLocalExtraTransform(other.GetLocalExtraTransform());
 	}
 
 	//-------------------------------------------------------------------------------------------------
 
-	void Transform::SetGlobalTransformDirty()
+	void Transform::ReplaceInParent(Transform const * current, Transform * replacement)
 	{
-		mGlobalTransformDirty = true;
-		mGlobalPositionDirty = true;
-		mGlobalRotationDirty = true;
-		mForwardDirty = true;
-		mUpDirty = true;
-		mRightDirty = true;
-
-		for(auto * child : mChildren)
+		auto * parent = Parent();
+		if (parent == nullptr)
+		{
+			return;
+		}
+		auto const iterator = std::find(parent->mChildren.begin(), parent->mChildren.end(), current);
+		if (iterator == parent->mChildren.end())
+		{
+			return;
+		}
+		if (replacement != nullptr)
+		{
+			*iterator = replacement;
+		}
+		else
 		{
-			child->SetGlobalTransformDirty();
+			parent->mChildren.erase(iterator);
 		}
 	}
 
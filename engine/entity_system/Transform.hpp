@@ -2,12 +2,16 @@
 
 #include "BedrockRotation.hpp"
 #include "BedrockCommon.hpp"
+#include "TransformStore.hpp"
 
+#include <memory>
 #include <string>
-#include <set>
+#include <vector>
 
 namespace MFA
 {
+    // Handle over a node of a TransformStore. Transforms that are parented to each other have to share a store,
+    // Transforms that are created without one share TransformStore::Default.
     class Transform
     {
 
@@ -15,10 +19,43 @@ namespace MFA
 
         explicit Transform();
 
+        explicit Transform(std::shared_ptr<TransformStore> store);
+
+        ~Transform();
+
+        // Creates a new root node in the same store with the same local values, The copy has no parent and no
+        // children, So moving the original or its hierarchy never moves the copy
+        Transform(Transform const & other);
+        Transform(Transform && other) noexcept;
+        // Copies the local values, The parent and children of this transform stay as they are
+        Transform & operator= (Transform const & rhs);
+        Transform & operator= (Transform && rhs) noexcept;
+
+        bool SetLocalPosition(glm::vec3 const & position);
+
+        [[nodiscard]]
+        glm::vec3 const & GetLocalPosition() const;
+
+        bool SetLocalRotation(Rotation const & rotation);
+
+        [[nodiscard]]
+        Rotation const & GetLocalRotation() const;
+
         bool SetEulerAngles(glm::vec3 const & eulerAngles);
 
         bool SetLocalQuaternion(glm::quat const & quaternion);
 
+        bool SetLocalScale(glm::vec3 const & scale);
+
+        [[nodiscard]]
+        glm::vec3 const & GetLocalScale() const;
+
+        bool SetLocalExtraTransform(glm::mat4 const & transform);
+
+        [[nodiscard]]
+        glm::mat4 const & GetLocalExtraTransform() const;
+
+        // Matrices are owned by the store, Creating a transform in the same store can move them
         [[nodiscard]]
         glm::mat4 const& LocalTransform();
 
@@ -28,7 +65,8 @@ namespace MFA
         [[nodiscard]]
         Transform * Parent() const;
 
-        std::set<Transform *> const & Children();
+        [[nodiscard]]
+        std::vector<Transform *> const & Children() const noexcept;
 
         void SetParent(Transform * parent);
 
@@ -53,34 +91,32 @@ namespace MFA
 
         void DebugUI();
 
+        [[nodiscard]]
+        std::shared_ptr<TransformStore> const & GetStore() const noexcept;
+
+        [[nodiscard]]
+        TransformStore::Id GetId() const noexcept;
+
         std::string name;
         std::string tag;
 
     private:
 
-        void SetLocalTransformDirty();
+        // Updates the store and drops the cached values when it changed since they were computed
+        void UpdateCache();
+
+        void CopyLocalValues(Transform const & other);
 
-        void SetGlobalTransformDirty();
+        // Replaces current in the children of the parent of this node, Nullptr removes it
+        void ReplaceInParent(Transform const * current, Transform * replacement);
 
-        // Local position
-        MFA_VARIABLE3(LocalPosition, glm::vec3, glm::vec3(0.0f, 0.0f, 0.0f), SetLocalTransformDirty, m)
-        // Local rotation
-    	MFA_VARIABLE3(LocalRotation, Rotation, Rotation(glm::identity<glm::quat>()), SetLocalTransformDirty, m)
-        // Local scale
-    	MFA_VARIABLE3(LocalScale, glm::vec3, glm::vec3(1.0f, 1.0f, 1.0f), SetLocalTransformDirty, m)
-        // Local extra transform
-    	MFA_VARIABLE3(LocalExtraTransform, glm::mat4, glm::identity<glm::mat4>(), SetLocalTransformDirty, m)
-        
-        bool mIsLocalTransformDirty = true;
-        bool mGlobalTransformDirty = true;
+        std::shared_ptr<TransformStore> mStore{};
+        TransformStore::Id mId = TransformStore::InvalidId;
 
-        // Note: Do not use this variable directly use the function instead
-        glm::mat4 mLocalTransform{};
-        // Note: Do not use this variable directly use the function instead
-        glm::mat4 mGlobalTransform{};
+        // Kept by SetParent, The store only knows the parent of a node
+        std::vector<Transform *> mChildren{};
 
-        std::set<Transform *> mChildren{};
-        Transform * mParent = nullptr;
+        uint64_t mCacheGeneration = UINT64_MAX;
 
         glm::vec3 mGlobalPosition{};
         bool mGlobalPositionDirty = true;
@@ -98,4 +134,4 @@ namespace MFA
         bool mUpDirty = true;
 
     };
-}
\ No newline at end of file
+}
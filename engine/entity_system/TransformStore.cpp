@@ -0,0 +1,548 @@
+#include "TransformStore.hpp"
+
+#include "BedrockAssert.hpp"
+#include "JobSystem.hpp"
+
+#include <glm/ext/matrix_transform.hpp>
+
+#include <algorithm>
+#include <atomic>
+
+namespace MFA
+{
+
+    //-------------------------------------------------------------------------------------------------
+
+    namespace
+    {
+        // 64 slots per word, So a job never shares a word of the bitsets with another job of the same level
+        constexpr int WordGrainSize = 16;
+
+        bool TestBit(std::vector<uint64_t> const & bits, uint32_t const index)
+        {
+            return ((bits[index >> 6] >> (index & 63)) & 1) != 0;
+        }
+
+        void SetBit(std::vector<uint64_t> & bits, uint32_t const index)
+        {
+            bits[index >> 6] |= uint64_t{1} << (index & 63);
+        }
+
+        size_t WordCount(size_t const bitCount)
+        {
+            return (bitCount + 63) >> 6;
+        }
+
+        template <typename T>
+        void Permute(std::vector<T> & values, std::vector<uint32_t> const & order)
+        {
+            std::vector<T> result{};
+            result.reserve(order.size());
+            for (uint32_t const slot : order)
+            {
+                result.emplace_back(std::move(values[slot]));
+            }
+            values = std::move(result);
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    TransformStore::TransformStore() = default;
+
+    //-------------------------------------------------------------------------------------------------
+
+    TransformStore::~TransformStore() = default;
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<TransformStore> const & TransformStore::Default()
+    {
+        static auto const store = std::make_shared<TransformStore>();
+        return store;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    TransformStore::Id TransformStore::Create(Transform * handle)
+    {
+        Id id;
+        if (mFreeIds.empty() == false)
+        {
+            id = mFreeIds.back();
+            mFreeIds.pop_back();
+        }
+        else
+        {
+            id = static_cast<Id>(mSlotOfId.size());
+            mSlotOfId.emplace_back(InvalidSlot);
+        }
+
+        auto const slot = static_cast<uint32_t>(mIdOfSlot.size());
+        mSlotOfId[id] = slot;
+        mIdOfSlot.emplace_back(id);
+        mParentSlots.emplace_back(InvalidSlot);
+        mHandles.emplace_back(handle);
+        mPositions.emplace_back(0.0f);
+        mRotations.emplace_back();
+        mScales.emplace_back(1.0f);
+        mExtraTransforms.emplace_back(glm::identity<glm::mat4>());
+        mHasExtraTransform.emplace_back(0);
+        mLocalMatrices.emplace_back(glm::identity<glm::mat4>());
+        mWorldMatrices.emplace_back(glm::identity<glm::mat4>());
+        mLocalDirty.resize(WordCount(mIdOfSlot.size()));
+        mWorldChanged.resize(mLocalDirty.size());
+
+        ++mNodeCount;
+        // A new root after the deepest level breaks the grouping by depth
+        mIsOrderDirty = true;
+        MarkDirty(slot);
+        return id;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TransformStore::Destroy(Id const id)
+    {
+        auto const slot = SlotOf(id);
+        // The slot stays until the next sort, So children can still tell that their parent is gone
+        mIdOfSlot[slot] = InvalidId;
+        mHandles[slot] = nullptr;
+        mSlotOfId[id] = InvalidSlot;
+        mFreeIds.emplace_back(id);
+        --mNodeCount;
+        mIsOrderDirty = true;
+        mIsDirty = true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool TransformStore::IsValid(Id const id) const
+    {
+        return id < mSlotOfId.size() && mSlotOfId[id] != InvalidSlot;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TransformStore::SetHandle(Id const id, Transform * handle)
+    {
+        mHandles[SlotOf(id)] = handle;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    Transform * TransformStore::GetHandle(Id const id) const
+    {
+        return mHandles[SlotOf(id)];
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool TransformStore::SetParent(Id const id, Id const parent)
+    {
+        auto const slot = SlotOf(id);
+        auto const parentSlot = parent != InvalidId ? SlotOf(parent) : InvalidSlot;
+        if (mParentSlots[slot] == parentSlot)
+        {
+            return true;
+        }
+
+        // Walking up from the new parent must not reach the node
+        for (auto ancestor = parentSlot; ancestor != InvalidSlot; ancestor = mParentSlots[ancestor])
+        {
+            if (ancestor == slot)
+            {
+                return false;
+            }
+            if (mIdOfSlot[ancestor] == InvalidId)
+            {
+                break;
+            }
+        }
+
+        mParentSlots[slot] = parentSlot;
+        // Children that are already below their parent at the next depth keep the order valid
+        if (parentSlot != InvalidSlot && mIsOrderDirty == false)
+        {
+            auto const level = std::upper_bound(mLevels.begin(), mLevels.end(), parentSlot) - mLevels.begin();
+            bool const isNextLevel = static_cast<size_t>(level) + 1 < mLevels.size() &&
+                slot >= mLevels[level] && slot < mLevels[level + 1];
+            mIsOrderDirty = isNextLevel == false;
+        }
+        else
+        {
+            mIsOrderDirty = true;
+        }
+        MarkDirty(slot);
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    TransformStore::Id TransformStore::GetParent(Id const id) const
+    {
+        auto const parentSlot = mParentSlots[SlotOf(id)];
+        return parentSlot != InvalidSlot ? mIdOfSlot[parentSlot] : InvalidId;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool TransformStore::SetLocalPosition(Id const id, glm::vec3 const & position)
+    {
+        auto const slot = SlotOf(id);
+        if (mPositions[slot] == position)
+        {
+            return false;
+        }
+        mPositions[slot] = position;
+        MarkDirty(slot);
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    glm::vec3 const & TransformStore::GetLocalPosition(Id const id) const
+    {
+        return mPositions[SlotOf(id)];
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool TransformStore::SetLocalRotation(Id const id, Rotation const & rotation)
+    {
+        auto const slot = SlotOf(id);
+        if (mRotations[slot] == rotation)
+        {
+            return false;
+        }
+        mRotations[slot] = rotation;
+        MarkDirty(slot);
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool TransformStore::SetLocalQuaternion(Id const id, glm::quat const & quaternion)
+    {
+        auto const slot = SlotOf(id);
+        if (mRotations[slot].SetQuaternion(quaternion) == false)
+        {
+            return false;
+        }
+        MarkDirty(slot);
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool TransformStore::SetEulerAngles(Id const id, glm::vec3 const & eulerAngles)
+    {
+        auto const slot = SlotOf(id);
+        if (mRotations[slot].SetEulerAngles(eulerAngles) == false)
+        {
+            return false;
+        }
+        MarkDirty(slot);
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    Rotation const & TransformStore::GetLocalRotation(Id const id) const
+    {
+        return mRotations[SlotOf(id)];
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool TransformStore::SetLocalScale(Id const id, glm::vec3 const & scale)
+    {
+        auto const slot = SlotOf(id);
+        if (mScales[slot] == scale)
+        {
+            return false;
+        }
+        mScales[slot] = scale;
+        MarkDirty(slot);
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    glm::vec3 const & TransformStore::GetLocalScale(Id const id) const
+    {
+        return mScales[SlotOf(id)];
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool TransformStore::SetLocalExtraTransform(Id const id, glm::mat4 const & transform)
+    {
+        auto const slot = SlotOf(id);
+        if (mExtraTransforms[slot] == transform)
+        {
+            return false;
+        }
+        mExtraTransforms[slot] = transform;
+        mHasExtraTransform[slot] = transform != glm::identity<glm::mat4>() ? 1 : 0;
+        MarkDirty(slot);
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    glm::mat4 const & TransformStore::GetLocalExtraTransform(Id const id) const
+    {
+        return mExtraTransforms[SlotOf(id)];
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    glm::mat4 const & TransformStore::GetLocalTransform(Id const id)
+    {
+        Update();
+        return mLocalMatrices[SlotOf(id)];
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    glm::mat4 const & TransformStore::GetWorldTransform(Id const id)
+    {
+        Update();
+        return mWorldMatrices[SlotOf(id)];
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TransformStore::Update()
+    {
+        if (mIsOrderDirty == true)
+        {
+            Sort();
+        }
+        if (mIsDirty == false)
+        {
+            return;
+        }
+
+        std::fill(mWorldChanged.begin(), mWorldChanged.end(), 0);
+        for (size_t level = 0; level + 1 < mLevels.size(); ++level)
+        {
+            UpdateLevel(mLevels[level], mLevels[level + 1]);
+        }
+        std::fill(mLocalDirty.begin(), mLocalDirty.end(), 0);
+
+        mIsDirty = false;
+        ++mGeneration;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool TransformStore::IsDirty() const noexcept
+    {
+        return mIsDirty || mIsOrderDirty;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    uint64_t TransformStore::GetGeneration() const noexcept
+    {
+        return mGeneration;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    uint32_t TransformStore::GetNodeCount() const noexcept
+    {
+        return mNodeCount;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    uint32_t TransformStore::SlotOf(Id const id) const
+    {
+        MFA_ASSERT(IsValid(id));
+        return mSlotOfId[id];
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TransformStore::MarkDirty(uint32_t const slot)
+    {
+        SetBit(mLocalDirty, slot);
+        mIsDirty = true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TransformStore::Sort()
+    {
+        auto const slotCount = static_cast<uint32_t>(mIdOfSlot.size());
+
+        // Depth of every live slot, Children of destroyed nodes become roots
+        std::vector<uint32_t> depths(slotCount, InvalidSlot);
+        std::vector<uint32_t> chain{};
+        uint32_t maxDepth = 0;
+        for (uint32_t slot = 0; slot < slotCount; ++slot)
+        {
+            if (mIdOfSlot[slot] == InvalidId || depths[slot] != InvalidSlot)
+            {
+                continue;
+            }
+            // Walks up until a root or a node whose depth is known
+            chain.clear();
+            uint32_t current = slot;
+            while (depths[current] == InvalidSlot)
+            {
+                chain.emplace_back(current);
+                auto & parent = mParentSlots[current];
+                if (parent != InvalidSlot && mIdOfSlot[parent] == InvalidId)
+                {
+                    parent = InvalidSlot;
+                    MarkDirty(current);
+                }
+                if (parent == InvalidSlot)
+                {
+                    break;
+                }
+                current = parent;
+            }
+            uint32_t depth = depths[current] != InvalidSlot ? depths[current] + 1 : 0;
+            for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+            {
+                depths[*it] = depth;
+                ++depth;
+            }
+            maxDepth = std::max(maxDepth, depth - 1);
+        }
+
+        // Counting sort keeps the relative order inside a level, So unchanged hierarchies stay where they are
+        mLevels.assign(maxDepth + 2, 0);
+        for (uint32_t slot = 0; slot < slotCount; ++slot)
+        {
+            if (depths[slot] != InvalidSlot)
+            {
+                ++mLevels[depths[slot] + 1];
+            }
+        }
+        for (size_t level = 1; level < mLevels.size(); ++level)
+        {
+            mLevels[level] += mLevels[level - 1];
+        }
+
+        std::vector<uint32_t> order(mNodeCount);
+        std::vector<uint32_t> newSlots(slotCount, InvalidSlot);
+        {
+            std::vector<uint32_t> next(mLevels.begin(), mLevels.end() - 1);
+            for (uint32_t slot = 0; slot < slotCount; ++slot)
+            {
+                if (depths[slot] != InvalidSlot)
+                {
+                    auto const newSlot = next[depths[slot]]++;
+                    order[newSlot] = slot;
+                    newSlots[slot] = newSlot;
+                }
+            }
+        }
+
+        std::vector<uint64_t> localDirty(WordCount(mNodeCount), 0);
+        for (uint32_t newSlot = 0; newSlot < mNodeCount; ++newSlot)
+        {
+            if (TestBit(mLocalDirty, order[newSlot]) == true)
+            {
+                SetBit(localDirty, newSlot);
+            }
+        }
+        mLocalDirty = std::move(localDirty);
+        mWorldChanged.assign(mLocalDirty.size(), 0);
+
+        Permute(mIdOfSlot, order);
+        Permute(mParentSlots, order);
+        Permute(mHandles, order);
+        Permute(mPositions, order);
+        Permute(mRotations, order);
+        Permute(mScales, order);
+        Permute(mExtraTransforms, order);
+        Permute(mHasExtraTransform, order);
+        Permute(mLocalMatrices, order);
+        Permute(mWorldMatrices, order);
+
+        for (uint32_t slot = 0; slot < mNodeCount; ++slot)
+        {
+            auto & parent = mParentSlots[slot];
+            if (parent != InvalidSlot)
+            {
+                parent = newSlots[parent];
+            }
+            mSlotOfId[mIdOfSlot[slot]] = slot;
+        }
+
+        mIsOrderDirty = false;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TransformStore::UpdateLevel(uint32_t const begin, uint32_t const end)
+    {
+        if (begin == end)
+        {
+            return;
+        }
+        auto const firstWord = begin >> 6;
+        auto const lastWord = (end - 1) >> 6;
+
+        JobSystem::ParallelFor(
+            static_cast<int>(lastWord - firstWord + 1),
+            WordGrainSize,
+            [this, begin, end, firstWord](int const jobBegin, int const jobEnd)->void
+            {
+                for (auto word = firstWord + jobBegin; word < firstWord + jobEnd; ++word)
+                {
+                    auto const localDirty = mLocalDirty[word];
+                    uint64_t changed = 0;
+                    auto const slotBegin = std::max(begin, word << 6);
+                    auto const slotEnd = std::min(end, (word << 6) + 64);
+                    for (auto slot = slotBegin; slot < slotEnd; ++slot)
+                    {
+                        uint64_t const bit = uint64_t{1} << (slot & 63);
+                        auto const parent = mParentSlots[slot];
+                        // Parents are in earlier levels, Their words can still be written by this level's first job
+                        bool const parentChanged = parent != InvalidSlot && ((
+                            std::atomic_ref<uint64_t>{mWorldChanged[parent >> 6]}.load(std::memory_order_relaxed)
+                            >> (parent & 63)) & 1) != 0;
+                        if ((localDirty & bit) == 0 && parentChanged == false)
+                        {
+                            continue;
+                        }
+
+                        if ((localDirty & bit) != 0)
+                        {
+                            // Translation * Rotation * Scale without the general matrix products
+                            glm::mat4 local = mRotations[slot].GetMatrix();
+                            local[0] *= mScales[slot].x;
+                            local[1] *= mScales[slot].y;
+                            local[2] *= mScales[slot].z;
+                            local[3] = glm::vec4{mPositions[slot], 1.0f};
+                            if (mHasExtraTransform[slot] != 0)
+                            {
+                                local = mExtraTransforms[slot] * local;
+                            }
+                            mLocalMatrices[slot] = local;
+                        }
+                        mWorldMatrices[slot] = parent != InvalidSlot
+                            ? mWorldMatrices[parent] * mLocalMatrices[slot]
+                            : mLocalMatrices[slot];
+                        changed |= bit;
+                    }
+                    if (changed != 0)
+                    {
+                        std::atomic_ref<uint64_t>{mWorldChanged[word]}.fetch_or(changed, std::memory_order_relaxed);
+                    }
+                }
+            }
+        );
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "BedrockRotation.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace MFA
+{
+    class Transform;
+
+    // Flat storage for a hierarchy of transforms. Local values, Local matrices and world matrices live in parallel
+    // arrays that are sorted by depth, So every parent comes before its children. Setters only mark a bit, Update then
+    // recomputes the dirty nodes and their descendants in one linear pass per depth level over the JobSystem.
+    // Ids stay valid while the arrays are reordered. A store is not thread safe, Each owner keeps its own.
+    class TransformStore
+    {
+    public:
+
+        using Id = uint32_t;
+        static constexpr Id InvalidId = UINT32_MAX;
+
+        explicit TransformStore();
+
+        ~TransformStore();
+
+        TransformStore(TransformStore const &) noexcept = delete;
+        TransformStore(TransformStore &&) noexcept = delete;
+        TransformStore & operator= (TransformStore const & rhs) noexcept = delete;
+        TransformStore & operator= (TransformStore && rhs) noexcept = delete;
+
+        // Store of the transforms that are created without one, So they are updated in one pass as well. It is not
+        // thread safe either, Transforms that are created off the main thread need a store of their own.
+        [[nodiscard]]
+        static std::shared_ptr<TransformStore> const & Default();
+
+        // New root node with an identity transform, Handle is returned by GetHandle
+        [[nodiscard]]
+        Id Create(Transform * handle = nullptr);
+
+        // Children of the node become roots
+        void Destroy(Id id);
+
+        [[nodiscard]]
+        bool IsValid(Id id) const;
+
+        void SetHandle(Id id, Transform * handle);
+
+        [[nodiscard]]
+        Transform * GetHandle(Id id) const;
+
+        // InvalidId detaches the node. Returns false when parent is the node itself or one of its descendants.
+        bool SetParent(Id id, Id parent);
+
+        // InvalidId for roots
+        [[nodiscard]]
+        Id GetParent(Id id) const;
+
+        bool SetLocalPosition(Id id, glm::vec3 const & position);
+
+        [[nodiscard]]
+        glm::vec3 const & GetLocalPosition(Id id) const;
+
+        bool SetLocalRotation(Id id, Rotation const & rotation);
+
+        bool SetLocalQuaternion(Id id, glm::quat const & quaternion);
+
+        bool SetEulerAngles(Id id, glm::vec3 const & eulerAngles);
+
+        [[nodiscard]]
+        Rotation const & GetLocalRotation(Id id) const;
+
+        bool SetLocalScale(Id id, glm::vec3 const & scale);
+
+        [[nodiscard]]
+        glm::vec3 const & GetLocalScale(Id id) const;
+
+        // Applied after translation, Rotation and scale. Gltf nodes store their matrix here.
+        bool SetLocalExtraTransform(Id id, glm::mat4 const & transform);
+
+        [[nodiscard]]
+        glm::mat4 const & GetLocalExtraTransform(Id id) const;
+
+        // Both matrix getters run Update first when something changed
+        [[nodiscard]]
+        glm::mat4 const & GetLocalTransform(Id id);
+
+        [[nodiscard]]
+        glm::mat4 const & GetWorldTransform(Id id);
+
+        // Brings every world matrix up to date
+        void Update();
+
+        // True when a change is waiting for Update
+        [[nodiscard]]
+        bool IsDirty() const noexcept;
+
+        // Goes up by one for every Update that changed a matrix, So handles know when their cached values are stale
+        [[nodiscard]]
+        uint64_t GetGeneration() const noexcept;
+
+        [[nodiscard]]
+        uint32_t GetNodeCount() const noexcept;
+
+    private:
+
+        static constexpr uint32_t InvalidSlot = UINT32_MAX;
+
+        [[nodiscard]]
+        uint32_t SlotOf(Id id) const;
+
+        void MarkDirty(uint32_t slot);
+
+        // Drops destroyed nodes, Orphans their children and sorts the rest by depth
+        void Sort();
+
+        void UpdateLevel(uint32_t begin, uint32_t end);
+
+        // Per id
+        std::vector<uint32_t> mSlotOfId{};
+        std::vector<Id> mFreeIds{};
+
+        // Per slot
+        std::vector<Id> mIdOfSlot{};
+        std::vector<uint32_t> mParentSlots{};
+        std::vector<Transform *> mHandles{};
+        std::vector<glm::vec3> mPositions{};
+        std::vector<Rotation> mRotations{};
+        std::vector<glm::vec3> mScales{};
+        std::vector<glm::mat4> mExtraTransforms{};
+        std::vector<uint8_t> mHasExtraTransform{};
+        std::vector<glm::mat4> mLocalMatrices{};
+        std::vector<glm::mat4> mWorldMatrices{};
+
+        // One bit per slot
+        std::vector<uint64_t> mLocalDirty{};
+        // Slots whose world matrix changed in the current Update, Children read the bit of their parent
+        std::vector<uint64_t> mWorldChanged{};
+
+        // First slot of every depth, Plus the slot count at the end
+        std::vector<uint32_t> mLevels{};
+
+        uint32_t mNodeCount = 0;
+        bool mIsDirty = false;
+        bool mIsOrderDirty = false;
+        uint64_t mGeneration = 0;
+    };
+
+}
@@ -1,15 +1,23 @@
 #include "ImportGLTF.hpp"
 
+#include "AssetGLTF_Cache.hpp"
+#include "AssetGLTF_PackedVertex.hpp"
 #include "AssetTexture.hpp"
 #include "ImportTexture.hpp"
 #include "BedrockAssert.hpp"
+#include "BedrockDeffer.hpp"
+#include "BedrockFile.hpp"
+#include "BedrockHash.hpp"
 #include "BedrockMath.hpp"
+#include "JobSystem.hpp"
 
 #include "json.hpp"
 #include "stb_image.h"
 #include "stb_image_write.h"
 #include "tiny_gltf_loader.h"
 
+#include <unordered_set>
+
 namespace MFA::Importer
 {
 
@@ -18,6 +26,8 @@ namespace MFA::Importer
         std::string const gltfName{};
         uint8_t const index = 0;
         std::string const relativePath{};
+        // Base color and emissive textures are sRGB, Every other texture holds linear data
+        bool const isColor = false;
     };
 
     //-------------------------------------------------------------------------------------------------
@@ -30,6 +40,21 @@ namespace MFA::Importer
     {
         std::string directoryPath = std::filesystem::path(path).parent_path().string();
 
+        // Textures are found by the uri of their image, So the color flag is per uri as well
+        std::unordered_set<std::string> colorUris{};
+        auto const addColorUri = [&gltfModel, &colorUris](int const textureIndex)->void
+        {
+            if (textureIndex >= 0 && textureIndex < static_cast<int>(gltfModel.textures.size()))
+            {
+                colorUris.emplace(gltfModel.images[gltfModel.textures[textureIndex].source].uri);
+            }
+        };
+        for (auto const& material : gltfModel.materials)
+        {
+            addColorUri(material.pbrMetallicRoughness.baseColorTexture.index);
+            addColorUri(material.emissiveTexture.index);
+        }
+
         // Extracting textures
         if (false == gltfModel.textures.empty())
         {
@@ -42,7 +67,8 @@ namespace MFA::Importer
                 TextureRef textureRef{
                     .gltfName = image.uri,
                     .index = static_cast<uint8_t>(outTextureRefs.size()),
-                    .relativePath = imagePath
+                    .relativePath = imagePath,
+                    .isColor = colorUris.contains(image.uri)
                 };
                 outTextureRefs.emplace_back(textureRef);
             }
@@ -400,7 +426,9 @@ namespace MFA::Importer
                         outputData,
                         outputCount
                     );
-                    MFA_ASSERT(outputCount == sampler.inputAndOutput.size());
+                    // Cubic spline samplers store an in tangent, The value and an out tangent for every key
+                    size_t const elementsPerKey = sampler.interpolation == Interpolation::CubicSpline ? 3 : 1;
+                    MFA_REQUIRE(outputCount == sampler.inputAndOutput.size() * elementsPerKey);
 
                     struct Output3
                     {
@@ -417,18 +445,38 @@ namespace MFA::Importer
                     case TINYGLTF_TYPE_VEC3:
                     {
                         auto const * output = static_cast<Output3 const *>(outputData);
-                        for (size_t index = 0; index < outputCount; index++)
+                        for (size_t index = 0; index < sampler.inputAndOutput.size(); index++)
                         {
-                            Memory::Copy<3>(sampler.inputAndOutput[index].output, output[index].value);
+                            auto & key = sampler.inputAndOutput[index];
+                            if (elementsPerKey == 3)
+                            {
+                                Memory::Copy<3>(key.inTangent, output[index * 3].value);
+                                Memory::Copy<3>(key.output, output[index * 3 + 1].value);
+                                Memory::Copy<3>(key.outTangent, output[index * 3 + 2].value);
+                            }
+                            else
+                            {
+                                Memory::Copy<3>(key.output, output[index].value);
+                            }
                         }
                         break;
                     }
                     case TINYGLTF_TYPE_VEC4:
                     {
                         auto const * output = static_cast<Output4 const *>(outputData);
-                        for (size_t index = 0; index < outputCount; index++)
+                        for (size_t index = 0; index < sampler.inputAndOutput.size(); index++)
                         {
-                            Memory::Copy<4>(sampler.inputAndOutput[index].output, output[index].value);
+                            auto & key = sampler.inputAndOutput[index];
+                            if (elementsPerKey == 3)
+                            {
+                                Memory::Copy<4>(key.inTangent, output[index * 3].value);
+                                Memory::Copy<4>(key.output, output[index * 3 + 1].value);
+                                Memory::Copy<4>(key.outTangent, output[index * 3 + 2].value);
+                            }
+                            else
+                            {
+                                Memory::Copy<4>(key.output, output[index].value);
+                            }
                         }
                         break;
                     }
@@ -458,663 +506,836 @@ namespace MFA::Importer
 
     //-------------------------------------------------------------------------------------------------
 
-    static std::shared_ptr<Mesh> GLTF_extractSubMeshes(
+    struct ExtractedPrimitive
+    {
+        Primitive primitive{};
+        std::vector<Vertex> vertices{};
+        std::vector<Index> indices{};
+    };
+
+    //-------------------------------------------------------------------------------------------------
+
+    static std::string GLTF_generateUvKeyword(int32_t const uvIndex)
+    {
+        return "TEXCOORD_" + std::to_string(uvIndex);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Every primitive only writes to its own tinygltf primitive and output, So primitives can be extracted in parallel
+    static void GLTF_extractPrimitive(
         tinygltf::Model& gltfModel,
-        std::vector<TextureRef> const& textureRefs
+        tinygltf::Primitive& gltfPrimitive,
+        std::vector<TextureRef> const& textureRefs,
+        uint32_t const uniqueId,
+        uint32_t const indicesVertexStartingIndex,
+        ExtractedPrimitive& outPrimitive
     )
     {
-        auto const generateUvKeyword = [](int32_t const uvIndex) -> std::string
-        {
-            return "TEXCOORD_" + std::to_string(uvIndex);
-        };
-        // Step1: Iterate over all meshes and gather required information for asset buffer
-        uint32_t totalIndicesCount = 0;
-        uint32_t totalVerticesCount = 0;
-        uint32_t indicesVertexStartingIndex = 0;
-        for (auto& mesh : gltfModel.meshes)
-        {
-            if (false == mesh.primitives.empty())
+        auto& primitiveIndices = outPrimitive.indices;
+        auto& primitiveVertices = outPrimitive.vertices;
+
+        int16_t baseColorTextureIndex = -1;
+        int32_t baseColorUvIndex = -1;
+        int16_t metallicRoughnessTextureIndex = -1;
+        int32_t metallicRoughnessUvIndex = -1;
+        int16_t normalTextureIndex = -1;
+        int32_t normalUvIndex = -1;
+        int16_t emissiveTextureIndex = -1;
+        int32_t emissiveUvIndex = -1;
+        int16_t occlusionTextureIndex = -1;
+        int32_t occlusionUV_Index = -1;
+        float baseColorFactor[4]{1.0f, 1.0f, 1.0f, 1.0f};
+        float metallicFactor = 0;
+        float roughnessFactor = 0;
+        float emissiveFactor[3]{};
+        bool doubleSided = false;
+        float alphaCutoff = 0.0f;
+
+        using AlphaMode = AS::GLTF::AlphaMode;
+        AlphaMode alphaMode = AlphaMode::Opaque;
+
+        if (gltfPrimitive.material >= 0)
+        {// Material
+            auto const& material = gltfModel.materials[gltfPrimitive.material];
+
+            // Base color texture
+            extractTextureAndUV_Index(
+                gltfModel,
+                material.pbrMetallicRoughness.baseColorTexture,
+                textureRefs,
+                baseColorTextureIndex,
+                baseColorUvIndex
+            );
+
+            // Metallic-roughness texture
+            extractTextureAndUV_Index(
+                gltfModel,
+                material.pbrMetallicRoughness.metallicRoughnessTexture,
+                textureRefs,
+                metallicRoughnessTextureIndex,
+                metallicRoughnessUvIndex
+            );
+
+            // Normal texture
+            extractTextureAndUV_Index(
+                gltfModel,
+                material.normalTexture,
+                textureRefs,
+                normalTextureIndex,
+                normalUvIndex
+            )
+
+                // Emissive texture
+                extractTextureAndUV_Index(
+                    gltfModel,
+                    material.emissiveTexture,
+                    textureRefs,
+                    emissiveTextureIndex,
+                    emissiveUvIndex
+                )
+
+                // Occlusion texture
+                extractTextureAndUV_Index(
+                    gltfModel,
+                    material.occlusionTexture,
+                    textureRefs,
+                    occlusionTextureIndex,
+                    occlusionUV_Index
+                )
+
+            {// BaseColorFactor
+                baseColorFactor[0] = static_cast<float>(material.pbrMetallicRoughness.baseColorFactor[0]);
+                baseColorFactor[1] = static_cast<float>(material.pbrMetallicRoughness.baseColorFactor[1]);
+                baseColorFactor[2] = static_cast<float>(material.pbrMetallicRoughness.baseColorFactor[2]);
+                baseColorFactor[3] = static_cast<float>(material.pbrMetallicRoughness.baseColorFactor[3]);
+            }
+            metallicFactor = static_cast<float>(material.pbrMetallicRoughness.metallicFactor);
+            roughnessFactor = static_cast<float>(material.pbrMetallicRoughness.roughnessFactor);
+            {// EmissiveFactor
+                emissiveFactor[0] = static_cast<float>(material.emissiveFactor[0]);
+                emissiveFactor[1] = static_cast<float>(material.emissiveFactor[1]);
+                emissiveFactor[2] = static_cast<float>(material.emissiveFactor[2]);
+            }
+
+            alphaCutoff = static_cast<float>(material.alphaCutoff);
+            alphaMode = [&material]()->AlphaMode
             {
-                for (auto& primitive : mesh.primitives)
+                if (material.alphaMode == "OPAQUE")
                 {
-                    {// Indices
-                        MFA_REQUIRE((primitive.indices < gltfModel.accessors.size()));
-                        auto const& accessor = gltfModel.accessors[primitive.indices];
-                        totalIndicesCount += static_cast<uint32_t>(accessor.count);
-                    }
-                    {// Positions
-                        MFA_REQUIRE((primitive.attributes["POSITION"] < gltfModel.accessors.size()));
-                        auto const& accessor = gltfModel.accessors[primitive.attributes["POSITION"]];
-                        totalVerticesCount += static_cast<uint32_t>(accessor.count);
-                    }
+                    return AlphaMode::Opaque;
                 }
-            }
+                if (material.alphaMode == "BLEND")
+                {
+                    return AlphaMode::Blend;
+                }
+                if (material.alphaMode == "MASK")
+                {
+                    return AlphaMode::Mask;
+                }
+                MFA_LOG_ERROR("Unhandled format detected: %s", material.alphaMode.c_str());
+                return AlphaMode::Invalid;
+            }();
+            doubleSided = material.doubleSided;
         }
 
-        auto mesh = std::make_shared<Mesh>(
-            totalVerticesCount,
-            totalIndicesCount,
-            Memory::AllocSize(sizeof(Vertex) * totalVerticesCount),
-            Memory::AllocSize(sizeof(Index) * totalIndicesCount)
-        );
+        uint32_t primitiveIndicesCount = 0;
+        {// Indices
+            MFA_REQUIRE(gltfPrimitive.indices < gltfModel.accessors.size());
+            auto const& accessor = gltfModel.accessors[gltfPrimitive.indices];
+            auto const& bufferView = gltfModel.bufferViews[accessor.bufferView];
+            MFA_REQUIRE(bufferView.buffer < gltfModel.buffers.size());
+            auto const& buffer = gltfModel.buffers[bufferView.buffer];
+            primitiveIndicesCount = static_cast<uint32_t>(accessor.count);
 
-        // Step2: Fill subMeshes
-        uint32_t primitiveUniqueId = 0;
-        std::vector<Vertex> primitiveVertices{};
-        std::vector<Index> primitiveIndices{};
-        for (auto& gltfMesh : gltfModel.meshes)
-        {
-            auto const meshIndex = mesh->InsertSubMesh();
-            if (false == gltfMesh.primitives.empty())
+            switch (accessor.componentType)
+            {
+            case TINYGLTF_PARAMETER_TYPE_UNSIGNED_INT:
             {
-                for (auto& gltfPrimitive : gltfMesh.primitives)
+                auto const* gltfIndices = reinterpret_cast<uint32_t const*>(
+                    &buffer.data[bufferView.byteOffset + accessor.byteOffset]
+                    );
+                for (uint32_t i = 0; i < primitiveIndicesCount; i++)
                 {
-                    primitiveIndices.erase(primitiveIndices.begin(), primitiveIndices.end());
-                    primitiveVertices.erase(primitiveVertices.begin(), primitiveVertices.end());
-
-                    int16_t baseColorTextureIndex = -1;
-                    int32_t baseColorUvIndex = -1;
-                    int16_t metallicRoughnessTextureIndex = -1;
-                    int32_t metallicRoughnessUvIndex = -1;
-                    int16_t normalTextureIndex = -1;
-                    int32_t normalUvIndex = -1;
-                    int16_t emissiveTextureIndex = -1;
-                    int32_t emissiveUvIndex = -1;
-                    int16_t occlusionTextureIndex = -1;
-                    int32_t occlusionUV_Index = -1;
-                    float baseColorFactor[4]{1.0f, 1.0f, 1.0f, 1.0f};
-                    float metallicFactor = 0;
-                    float roughnessFactor = 0;
-                    float emissiveFactor[3]{};
-                    bool doubleSided = false;
-                    float alphaCutoff = 0.0f;
-
-                    using AlphaMode = AS::GLTF::AlphaMode;
-                    AlphaMode alphaMode = AlphaMode::Opaque;
-
-                    uint32_t uniqueId = primitiveUniqueId;
-                    primitiveUniqueId++;
-                    if (gltfPrimitive.material >= 0)
-                    {// Material
-                        auto const& material = gltfModel.materials[gltfPrimitive.material];
-
-                        // Base color texture
-                        extractTextureAndUV_Index(
-                            gltfModel,
-                            material.pbrMetallicRoughness.baseColorTexture,
-                            textureRefs,
-                            baseColorTextureIndex,
-                            baseColorUvIndex
-                        );
-
-                        // Metallic-roughness texture
-                        extractTextureAndUV_Index(
-                            gltfModel,
-                            material.pbrMetallicRoughness.metallicRoughnessTexture,
-                            textureRefs,
-                            metallicRoughnessTextureIndex,
-                            metallicRoughnessUvIndex
-                        );
+                    primitiveIndices.emplace_back(gltfIndices[i] + indicesVertexStartingIndex);
+                }
+            }
+            break;
+            case TINYGLTF_PARAMETER_TYPE_UNSIGNED_SHORT:
+            {
+                auto const* gltfIndices = reinterpret_cast<uint16_t const*>(
+                    &buffer.data[bufferView.byteOffset + accessor.byteOffset]
+                    );
+                for (uint32_t i = 0; i < primitiveIndicesCount; i++)
+                {
+                    primitiveIndices.emplace_back(gltfIndices[i] + indicesVertexStartingIndex);
+                }
+            }
+            break;
+            case TINYGLTF_PARAMETER_TYPE_UNSIGNED_BYTE:
+            {
+                auto const* gltfIndices = reinterpret_cast<uint8_t const*>(
+                    &buffer.data[bufferView.byteOffset + accessor.byteOffset]
+                    );
+                for (uint32_t i = 0; i < primitiveIndicesCount; i++)
+                {
+                    primitiveIndices.emplace_back(gltfIndices[i] + indicesVertexStartingIndex);
+                }
+            }
+            break;
+            default:
+                MFA_NOT_IMPLEMENTED_YET("Mohammad Fakhreddin");
+            }
+        }
 
-                        // Normal texture
-                        extractTextureAndUV_Index(
-                            gltfModel,
-                            material.normalTexture,
-                            textureRefs,
-                            normalTextureIndex,
-                            normalUvIndex
-                        )
-
-                            // Emissive texture
-                            extractTextureAndUV_Index(
-                                gltfModel,
-                                material.emissiveTexture,
-                                textureRefs,
-                                emissiveTextureIndex,
-                                emissiveUvIndex
-                            )
-
-                            // Occlusion texture
-                            extractTextureAndUV_Index(
-                                gltfModel,
-                                material.occlusionTexture,
-                                textureRefs,
-                                occlusionTextureIndex,
-                                occlusionUV_Index
-                            )
-
-                        {// BaseColorFactor
-                            baseColorFactor[0] = static_cast<float>(material.pbrMetallicRoughness.baseColorFactor[0]);
-                            baseColorFactor[1] = static_cast<float>(material.pbrMetallicRoughness.baseColorFactor[1]);
-                            baseColorFactor[2] = static_cast<float>(material.pbrMetallicRoughness.baseColorFactor[2]);
-                            baseColorFactor[3] = static_cast<float>(material.pbrMetallicRoughness.baseColorFactor[3]);
-                        }
-                        metallicFactor = static_cast<float>(material.pbrMetallicRoughness.metallicFactor);
-                        roughnessFactor = static_cast<float>(material.pbrMetallicRoughness.roughnessFactor);
-                        {// EmissiveFactor
-                            emissiveFactor[0] = static_cast<float>(material.emissiveFactor[0]);
-                            emissiveFactor[1] = static_cast<float>(material.emissiveFactor[1]);
-                            emissiveFactor[2] = static_cast<float>(material.emissiveFactor[2]);
-                        }
+        float const* positions = nullptr;
+        uint32_t primitiveVertexCount = 0;
+        float positionsMinValue[3]{};
+        float positionsMaxValue[3]{};
+        bool hasPositionMinMax = false;
+        {// Position
+            auto const result = GLTF_extractPrimitiveDataFromBuffer(
+                gltfModel,
+                gltfPrimitive,
+                "POSITION",
+                TINYGLTF_COMPONENT_TYPE_FLOAT,
+                positions,
+                primitiveVertexCount
+            );
+            MFA_ASSERT(result);
+        }
 
-                        alphaCutoff = static_cast<float>(material.alphaCutoff);
-                        alphaMode = [&material]()->AlphaMode
-                        {
-                            if (material.alphaMode == "OPAQUE")
-                            {
-                                return AlphaMode::Opaque;
-                            }
-                            if (material.alphaMode == "BLEND")
-                            {
-                                return AlphaMode::Blend;
-                            }
-                            if (material.alphaMode == "MASK")
-                            {
-                                return AlphaMode::Mask;
-                            }
-                            MFA_LOG_ERROR("Unhandled format detected: %s", material.alphaMode.c_str());
-                            return AlphaMode::Invalid;
-                        }();
-                        doubleSided = material.doubleSided;
-                    }
+        float const* baseColorUVs = nullptr;
+        float baseColorUV_Min[2]{};
+        float baseColorUV_Max[2]{};
+        bool hasBaseColorUvMinMax = false;
+        if (baseColorUvIndex >= 0)
+        {// BaseColor
+            uint32_t baseColorUvsCount = 0;
+            auto texture_coordinate_key_name = GLTF_generateUvKeyword(baseColorUvIndex);
+            auto const result = GLTF_extractPrimitiveDataFromBuffer(
+                gltfModel,
+                gltfPrimitive,
+                texture_coordinate_key_name.c_str(),
+                TINYGLTF_COMPONENT_TYPE_FLOAT,
+                baseColorUVs,
+                baseColorUvsCount
+            );
+            MFA_ASSERT(result == true);
+            MFA_ASSERT(baseColorUvsCount == primitiveVertexCount);
+        }
 
-                    uint32_t primitiveIndicesCount = 0;
-                    {// Indices
-                        MFA_REQUIRE(gltfPrimitive.indices < gltfModel.accessors.size());
-                        auto const& accessor = gltfModel.accessors[gltfPrimitive.indices];
-                        auto const& bufferView = gltfModel.bufferViews[accessor.bufferView];
-                        MFA_REQUIRE(bufferView.buffer < gltfModel.buffers.size());
-                        auto const& buffer = gltfModel.buffers[bufferView.buffer];
-                        primitiveIndicesCount = static_cast<uint32_t>(accessor.count);
+        float const* metallicRoughnessUvs = nullptr;
+        float metallicRoughnessUVMin[2]{};
+        float metallicRoughnessUVMax[2]{};
+        bool hasMetallicRoughnessUvMinMax = false;
+        if (metallicRoughnessUvIndex >= 0)
+        {// MetallicRoughness uvs
+            std::string texture_coordinate_key_name = GLTF_generateUvKeyword(metallicRoughnessUvIndex);
+            uint32_t metallicRoughnessUvsCount = 0;
+            auto const result = GLTF_extractPrimitiveDataFromBuffer(
+                gltfModel,
+                gltfPrimitive,
+                texture_coordinate_key_name.c_str(),
+                TINYGLTF_COMPONENT_TYPE_FLOAT,
+                metallicRoughnessUvs,
+                metallicRoughnessUvsCount
+            );
+            MFA_ASSERT(result == true);
+            MFA_ASSERT(metallicRoughnessUvsCount == primitiveVertexCount);
+        }
 
-                        switch (accessor.componentType)
-                        {
-                        case TINYGLTF_PARAMETER_TYPE_UNSIGNED_INT:
-                        {
-                            auto const* gltfIndices = reinterpret_cast<uint32_t const*>(
-                                &buffer.data[bufferView.byteOffset + accessor.byteOffset]
-                                );
-                            for (uint32_t i = 0; i < primitiveIndicesCount; i++)
-                            {
-                                primitiveIndices.emplace_back(gltfIndices[i] + indicesVertexStartingIndex);
-                            }
-                        }
-                        break;
-                        case TINYGLTF_PARAMETER_TYPE_UNSIGNED_SHORT:
-                        {
-                            auto const* gltfIndices = reinterpret_cast<uint16_t const*>(
-                                &buffer.data[bufferView.byteOffset + accessor.byteOffset]
-                                );
-                            for (uint32_t i = 0; i < primitiveIndicesCount; i++)
-                            {
-                                primitiveIndices.emplace_back(gltfIndices[i] + indicesVertexStartingIndex);
-                            }
-                        }
-                        break;
-                        case TINYGLTF_PARAMETER_TYPE_UNSIGNED_BYTE:
-                        {
-                            auto const* gltfIndices = reinterpret_cast<uint8_t const*>(
-                                &buffer.data[bufferView.byteOffset + accessor.byteOffset]
-                                );
-                            for (uint32_t i = 0; i < primitiveIndicesCount; i++)
-                            {
-                                primitiveIndices.emplace_back(gltfIndices[i] + indicesVertexStartingIndex);
-                            }
-                        }
-                        break;
-                        default:
-                            MFA_NOT_IMPLEMENTED_YET("Mohammad Fakhreddin");
-                        }
-                    }
+        float const* emissionUVs = nullptr;
+        float emissionUV_Min[2]{};
+        float emissionUV_Max[2]{};
+        bool hasEmissionUvMinMax = false;
+        if (emissiveUvIndex >= 0)
+        {// Emission uvs
+            std::string textureCoordinateKeyName = GLTF_generateUvKeyword(emissiveUvIndex);
+            uint32_t emissionUvCount = 0;
+            auto const result = GLTF_extractPrimitiveDataFromBuffer(
+                gltfModel,
+                gltfPrimitive,
+                textureCoordinateKeyName.c_str(),
+                TINYGLTF_COMPONENT_TYPE_FLOAT,
+                emissionUVs,
+                emissionUvCount
+            );
+            MFA_ASSERT(result == true);
+            MFA_ASSERT(emissionUvCount == primitiveVertexCount);
+        }
 
-                    float const* positions = nullptr;
-                    uint32_t primitiveVertexCount = 0;
-                    float positionsMinValue[3]{};
-                    float positionsMaxValue[3]{};
-                    bool hasPositionMinMax = false;
-                    {// Position
-                        auto const result = GLTF_extractPrimitiveDataFromBuffer(
-                            gltfModel,
-                            gltfPrimitive,
-                            "POSITION",
-                            TINYGLTF_COMPONENT_TYPE_FLOAT,
-                            positions,
-                            primitiveVertexCount
-                        );
-                        MFA_ASSERT(result);
-                    }
+        float const* occlusionUVs = nullptr;
+        float occlusionUV_Min[2]{};
+        float occlusionUV_Max[2]{};
+        bool hasOcclusionUV_MinMax = false;
+        if (occlusionUV_Index >= 0)
+        {// Occlusion uvs
+            std::string textureCoordinateKeyName = GLTF_generateUvKeyword(occlusionUV_Index);
+            uint32_t occlusionUV_Count = 0;
+            auto const result = GLTF_extractPrimitiveDataFromBuffer(
+                gltfModel,
+                gltfPrimitive,
+                textureCoordinateKeyName.c_str(),
+                TINYGLTF_COMPONENT_TYPE_FLOAT,
+                occlusionUVs,
+                occlusionUV_Count
+            );
+            MFA_ASSERT(result == true);
+            MFA_ASSERT(occlusionUV_Count == primitiveVertexCount);
+        }
 
-                    float const* baseColorUVs = nullptr;
-                    float baseColorUV_Min[2]{};
-                    float baseColorUV_Max[2]{};
-                    bool hasBaseColorUvMinMax = false;
-                    if (baseColorUvIndex >= 0)
-                    {// BaseColor
-                        uint32_t baseColorUvsCount = 0;
-                        auto texture_coordinate_key_name = generateUvKeyword(baseColorUvIndex);
-                        auto const result = GLTF_extractPrimitiveDataFromBuffer(
-                            gltfModel,
-                            gltfPrimitive,
-                            texture_coordinate_key_name.c_str(),
-                            TINYGLTF_COMPONENT_TYPE_FLOAT,
-                            baseColorUVs,
-                            baseColorUvsCount
-                        );
-                        MFA_ASSERT(result == true);
-                        MFA_ASSERT(baseColorUvsCount == primitiveVertexCount);
-                    }
+        float const* normalsUVs = nullptr;
+        float normalsUV_Min[2]{};
+        float normalsUV_Max[2]{};
+        bool hasNormalUvMinMax = false;
+        if (normalUvIndex >= 0)
+        {// Normal uvs
+            std::string texture_coordinate_key_name = GLTF_generateUvKeyword(normalUvIndex);
+            uint32_t normalUvsCount = 0;
+            auto const result = GLTF_extractPrimitiveDataFromBuffer(
+                gltfModel,
+                gltfPrimitive,
+                texture_coordinate_key_name.c_str(),
+                TINYGLTF_COMPONENT_TYPE_FLOAT,
+                normalsUVs,
+                normalUvsCount
+            );
+            MFA_ASSERT(result == true);
+            MFA_ASSERT(normalUvsCount == primitiveVertexCount);
+        }
+        float const* normalValues = nullptr;
+        float normalsValuesMin[3]{};
+        float normalsValuesMax[3]{};
+        bool hasNormalValueMinMax = false;
+        {// Normal values
+            uint32_t normalValuesCount = 0;
+            auto const result = GLTF_extractPrimitiveDataFromBuffer(
+                gltfModel,
+                gltfPrimitive,
+                "NORMAL",
+                TINYGLTF_COMPONENT_TYPE_FLOAT,
+                normalValues,
+                normalValuesCount
+            );
+            MFA_ASSERT(result == false || normalValuesCount == primitiveVertexCount);
+        }
 
-                    float const* metallicRoughnessUvs = nullptr;
-                    float metallicRoughnessUVMin[2]{};
-                    float metallicRoughnessUVMax[2]{};
-                    bool hasMetallicRoughnessUvMinMax = false;
-                    if (metallicRoughnessUvIndex >= 0)
-                    {// MetallicRoughness uvs
-                        std::string texture_coordinate_key_name = generateUvKeyword(metallicRoughnessUvIndex);
-                        uint32_t metallicRoughnessUvsCount = 0;
-                        auto const result = GLTF_extractPrimitiveDataFromBuffer(
-                            gltfModel,
-                            gltfPrimitive,
-                            texture_coordinate_key_name.c_str(),
-                            TINYGLTF_COMPONENT_TYPE_FLOAT,
-                            metallicRoughnessUvs,
-                            metallicRoughnessUvsCount
-                        );
-                        MFA_ASSERT(result == true);
-                        MFA_ASSERT(metallicRoughnessUvsCount == primitiveVertexCount);
-                    }
+        float const* tangentValues = nullptr;
+        float tangentsValuesMin[4]{};
+        float tangentsValuesMax[4]{};
+        bool hasTangentsValuesMinMax = false;
+        {// Tangent values
+            uint32_t tangentValuesCount = 0;
+            auto const result = GLTF_extractPrimitiveDataFromBuffer(
+                gltfModel,
+                gltfPrimitive,
+                "TANGENT",
+                TINYGLTF_COMPONENT_TYPE_FLOAT,
+                tangentValues,
+                tangentValuesCount
+            );
+            MFA_ASSERT(result == false || tangentValuesCount == primitiveVertexCount);
+        }
 
-                    float const* emissionUVs = nullptr;
-                    float emissionUV_Min[2]{};
-                    float emissionUV_Max[2]{};
-                    bool hasEmissionUvMinMax = false;
-                    if (emissiveUvIndex >= 0)
-                    {// Emission uvs
-                        std::string textureCoordinateKeyName = generateUvKeyword(emissiveUvIndex);
-                        uint32_t emissionUvCount = 0;
-                        auto const result = GLTF_extractPrimitiveDataFromBuffer(
-                            gltfModel,
-                            gltfPrimitive,
-                            textureCoordinateKeyName.c_str(),
-                            TINYGLTF_COMPONENT_TYPE_FLOAT,
-                            emissionUVs,
-                            emissionUvCount
-                        );
-                        MFA_ASSERT(result == true);
-                        MFA_ASSERT(emissionUvCount == primitiveVertexCount);
-                    }
 
-                    float const* occlusionUVs = nullptr;
-                    float occlusionUV_Min[2]{};
-                    float occlusionUV_Max[2]{};
-                    bool hasOcclusionUV_MinMax = false;
-                    if (occlusionUV_Index >= 0)
-                    {// Occlusion uvs
-                        std::string textureCoordinateKeyName = generateUvKeyword(occlusionUV_Index);
-                        uint32_t occlusionUV_Count = 0;
-                        auto const result = GLTF_extractPrimitiveDataFromBuffer(
-                            gltfModel,
-                            gltfPrimitive,
-                            textureCoordinateKeyName.c_str(),
-                            TINYGLTF_COMPONENT_TYPE_FLOAT,
-                            occlusionUVs,
-                            occlusionUV_Count
-                        );
-                        MFA_ASSERT(result == true);
-                        MFA_ASSERT(occlusionUV_Count == primitiveVertexCount);
-                    }
+        uint32_t jointItemCount = 0;
+        std::vector<uint16_t> jointValues{};
+        int jointAccessorType = 0;
+        {// Joints
+            void const* rawJointValues = nullptr;
+            int componentType = 0;
+            uint32_t jointValuesCount = 0;
+            GLTF_extractPrimitiveDataAndTypeFromBuffer(
+                gltfModel,
+                gltfPrimitive,
+                "JOINTS_0",
+                jointAccessorType,
+                componentType,
+                rawJointValues,
+                jointValuesCount
+            );
+            jointItemCount = jointValuesCount * jointAccessorType;
+            jointValues.resize(jointItemCount);
+            switch (componentType)
+            {
+            case 0:
+                break;
+            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+            {
+                auto const* shortJointValues = static_cast<uint16_t const*>(rawJointValues);
+                for (uint32_t i = 0; i < jointItemCount; ++i)
+                {
+                    jointValues[i] = shortJointValues[i];
+                }
+            }
+            break;
+            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+            {
+                auto const* byteJointValues = static_cast<uint8_t const*>(rawJointValues);
+                for (uint32_t i = 0; i < jointItemCount; ++i)
+                {
+                    jointValues[i] = byteJointValues[i];
+                }
+            }
+            break;
+            default:
+                MFA_CRASH("Unhandled type");
+            }
+            MFA_ASSERT((jointAccessorType > 0 || jointItemCount == 0));
+        }
+        std::vector<float> weightValues{};
+        {// Weights
+            int componentType = 0;
+            int accessorType = 0;
+            uint32_t rawValuesCount = 0;
+            void const* rawValues = nullptr;
+
+            GLTF_extractPrimitiveDataAndTypeFromBuffer(
+                gltfModel,
+                gltfPrimitive,
+                "WEIGHTS_0",
+                accessorType,
+                componentType,
+                rawValues,
+                rawValuesCount
+            );
 
-                    float const* normalsUVs = nullptr;
-                    float normalsUV_Min[2]{};
-                    float normalsUV_Max[2]{};
-                    bool hasNormalUvMinMax = false;
-                    if (normalUvIndex >= 0)
-                    {// Normal uvs
-                        std::string texture_coordinate_key_name = generateUvKeyword(normalUvIndex);
-                        uint32_t normalUvsCount = 0;
-                        auto const result = GLTF_extractPrimitiveDataFromBuffer(
-                            gltfModel,
-                            gltfPrimitive,
-                            texture_coordinate_key_name.c_str(),
-                            TINYGLTF_COMPONENT_TYPE_FLOAT,
-                            normalsUVs,
-                            normalUvsCount
-                        );
-                        MFA_ASSERT(result == true);
-                        MFA_ASSERT(normalUvsCount == primitiveVertexCount);
-                    }
-                    float const* normalValues = nullptr;
-                    float normalsValuesMin[3]{};
-                    float normalsValuesMax[3]{};
-                    bool hasNormalValueMinMax = false;
-                    {// Normal values
-                        uint32_t normalValuesCount = 0;
-                        auto const result = GLTF_extractPrimitiveDataFromBuffer(
-                            gltfModel,
-                            gltfPrimitive,
-                            "NORMAL",
-                            TINYGLTF_COMPONENT_TYPE_FLOAT,
-                            normalValues,
-                            normalValuesCount
-                        );
-                        MFA_ASSERT(result == false || normalValuesCount == primitiveVertexCount);
-                    }
+            auto itemCount = rawValuesCount * accessorType;
 
-                    float const* tangentValues = nullptr;
-                    float tangentsValuesMin[4]{};
-                    float tangentsValuesMax[4]{};
-                    bool hasTangentsValuesMinMax = false;
-                    {// Tangent values
-                        uint32_t tangentValuesCount = 0;
-                        auto const result = GLTF_extractPrimitiveDataFromBuffer(
-                            gltfModel,
-                            gltfPrimitive,
-                            "TANGENT",
-                            TINYGLTF_COMPONENT_TYPE_FLOAT,
-                            tangentValues,
-                            tangentValuesCount
-                        );
-                        MFA_ASSERT(result == false || tangentValuesCount == primitiveVertexCount);
-                    }
+            MFA_ASSERT(itemCount == jointItemCount);
+            MFA_ASSERT(accessorType == jointAccessorType);
 
+            weightValues.resize(itemCount);
+            switch (componentType)
+            {
+            case 0:
+                break;
+            case TINYGLTF_COMPONENT_TYPE_FLOAT:
+            {
+                auto const* floatWeightValues = static_cast<float const*>(rawValues);
+                for (uint32_t i = 0; i < jointItemCount; ++i)
+                {
+                    weightValues[i] = floatWeightValues[i];
+                }
+            }
+            break;
+            default:
+                MFA_CRASH("Unhandled type");
+            }
+            MFA_ASSERT((accessorType > 0 || itemCount == 0));
+        }
+        // TODO Start from here, Assign weight and joint
+        float const* colors = nullptr;
+        float colorsMinValue[3]{ 0 };
+        float colorsMaxValue[3]{ 1 };
+        float colorsMinMaxDiff[3]{ 1 };
+        if (gltfPrimitive.attributes["COLOR"] >= 0)
+        {
+            MFA_REQUIRE(gltfPrimitive.attributes["COLOR"] < gltfModel.accessors.size());
+            auto const& accessor = gltfModel.accessors[gltfPrimitive.attributes["COLOR"]];
+            //MFA_ASSERT(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT);
+            //TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT
+            if (accessor.minValues.size() == 3 && accessor.maxValues.size() == 3)
+            {
+                colorsMinValue[0] = static_cast<float>(accessor.minValues[0]);
+                colorsMinValue[1] = static_cast<float>(accessor.minValues[1]);
+                colorsMinValue[2] = static_cast<float>(accessor.minValues[2]);
+                colorsMaxValue[0] = static_cast<float>(accessor.maxValues[0]);
+                colorsMaxValue[1] = static_cast<float>(accessor.maxValues[1]);
+                colorsMaxValue[2] = static_cast<float>(accessor.maxValues[2]);
+                colorsMinMaxDiff[0] = colorsMaxValue[0] - colorsMinValue[0];
+                colorsMinMaxDiff[1] = colorsMaxValue[1] - colorsMinValue[1];
+                colorsMinMaxDiff[2] = colorsMaxValue[2] - colorsMinValue[2];
+            }
+            auto const& bufferView = gltfModel.bufferViews[accessor.bufferView];
+            MFA_REQUIRE(bufferView.buffer < gltfModel.buffers.size());
+            auto const& buffer = gltfModel.buffers[bufferView.buffer];
+            colors = reinterpret_cast<const float*>(                           // TODO: Variable not used! Why?
+                &buffer.data[bufferView.byteOffset + accessor.byteOffset]
+                );
+        }
 
-                    uint32_t jointItemCount = 0;
-                    std::vector<uint16_t> jointValues{};
-                    int jointAccessorType = 0;
-                    {// Joints
-                        void const* rawJointValues = nullptr;
-                        int componentType = 0;
-                        uint32_t jointValuesCount = 0;
-                        GLTF_extractPrimitiveDataAndTypeFromBuffer(
-                            gltfModel,
-                            gltfPrimitive,
-                            "JOINTS_0",
-                            jointAccessorType,
-                            componentType,
-                            rawJointValues,
-                            jointValuesCount
-                        );
-                        jointItemCount = jointValuesCount * jointAccessorType;
-                        jointValues.resize(jointItemCount);
-                        switch (componentType)
-                        {
-                        case 0:
-                            break;
-                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
-                        {
-                            auto const* shortJointValues = static_cast<uint16_t const*>(rawJointValues);
-                            for (uint32_t i = 0; i < jointItemCount; ++i)
-                            {
-                                jointValues[i] = shortJointValues[i];
-                            }
-                        }
-                        break;
-                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
-                        {
-                            auto const* byteJointValues = static_cast<uint8_t const*>(rawJointValues);
-                            for (uint32_t i = 0; i < jointItemCount; ++i)
-                            {
-                                jointValues[i] = byteJointValues[i];
-                            }
-                        }
-                        break;
-                        default:
-                            MFA_CRASH("Unhandled type");
-                        }
-                        MFA_ASSERT((jointAccessorType > 0 || jointItemCount == 0));
-                    }
-                    std::vector<float> weightValues{};
-                    {// Weights
-                        int componentType = 0;
-                        int accessorType = 0;
-                        uint32_t rawValuesCount = 0;
-                        void const* rawValues = nullptr;
-
-                        GLTF_extractPrimitiveDataAndTypeFromBuffer(
-                            gltfModel,
-                            gltfPrimitive,
-                            "WEIGHTS_0",
-                            accessorType,
-                            componentType,
-                            rawValues,
-                            rawValuesCount
-                        );
+        bool hasPosition = positions != nullptr;
+        MFA_ASSERT(hasPosition == true);
+        bool hasBaseColorTexture = baseColorUVs != nullptr;
+        MFA_ASSERT(baseColorUVs != nullptr == baseColorTextureIndex >= 0);
+        bool hasNormalValue = normalValues != nullptr;
+        MFA_ASSERT(hasNormalValue == true);
+        bool hasNormalTexture = normalsUVs != nullptr;
+        MFA_ASSERT(normalsUVs != nullptr == normalTextureIndex >= 0);
+        bool hasCombinedMetallicRoughness = metallicRoughnessUvs != nullptr;
+        MFA_ASSERT(metallicRoughnessUvs != nullptr == metallicRoughnessTextureIndex >= 0);
+        bool hasEmissiveTexture = emissionUVs != nullptr;
+        MFA_ASSERT(emissionUVs != nullptr == emissiveTextureIndex >= 0);
+        bool hasOcclusionTexture = occlusionUVs != nullptr;
+        MFA_ASSERT((occlusionUVs != nullptr) == (occlusionTextureIndex >= 0));
+        bool hasTangentValue = tangentValues != nullptr;
+        bool hasSkin = jointItemCount > 0;
+        primitiveVertices.reserve(primitiveVertexCount);
+        for (uint32_t i = 0; i < primitiveVertexCount; ++i)
+        {
+            primitiveVertices.emplace_back();
+            auto& vertex = primitiveVertices.back();
 
-                        auto itemCount = rawValuesCount * accessorType;
+            // Positions
+            if (hasPosition)
+            {
+                copyDataIntoVertexMember(
+                    &vertex.position[0],
+                    3,
+                    positions,
+                    i
+                );
+            }
 
-                        MFA_ASSERT(itemCount == jointItemCount);
-                        MFA_ASSERT(accessorType == jointAccessorType);
+            // Normal values
+            if (hasNormalValue)
+            {
+                copyDataIntoVertexMember(
+                    &vertex.normal[0],
+                    3,
+                    normalValues,
+                    i
+                );
+            }
 
-                        weightValues.resize(itemCount);
-                        switch (componentType)
-                        {
-                        case 0:
-                            break;
-                        case TINYGLTF_COMPONENT_TYPE_FLOAT:
-                        {
-                            auto const* floatWeightValues = static_cast<float const*>(rawValues);
-                            for (uint32_t i = 0; i < jointItemCount; ++i)
-                            {
-                                weightValues[i] = floatWeightValues[i];
-                            }
-                        }
-                        break;
-                        default:
-                            MFA_CRASH("Unhandled type");
-                        }
-                        MFA_ASSERT((accessorType > 0 || itemCount == 0));
-                    }
-                    // TODO Start from here, Assign weight and joint
-                    float const* colors = nullptr;
-                    float colorsMinValue[3]{ 0 };
-                    float colorsMaxValue[3]{ 1 };
-                    float colorsMinMaxDiff[3]{ 1 };
-                    if (gltfPrimitive.attributes["COLOR"] >= 0)
-                    {
-                        MFA_REQUIRE(gltfPrimitive.attributes["COLOR"] < gltfModel.accessors.size());
-                        auto const& accessor = gltfModel.accessors[gltfPrimitive.attributes["COLOR"]];
-                        //MFA_ASSERT(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT);
-                        //TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT
-                        if (accessor.minValues.size() == 3 && accessor.maxValues.size() == 3)
-                        {
-                            colorsMinValue[0] = static_cast<float>(accessor.minValues[0]);
-                            colorsMinValue[1] = static_cast<float>(accessor.minValues[1]);
-                            colorsMinValue[2] = static_cast<float>(accessor.minValues[2]);
-                            colorsMaxValue[0] = static_cast<float>(accessor.maxValues[0]);
-                            colorsMaxValue[1] = static_cast<float>(accessor.maxValues[1]);
-                            colorsMaxValue[2] = static_cast<float>(accessor.maxValues[2]);
-                            colorsMinMaxDiff[0] = colorsMaxValue[0] - colorsMinValue[0];
-                            colorsMinMaxDiff[1] = colorsMaxValue[1] - colorsMinValue[1];
-                            colorsMinMaxDiff[2] = colorsMaxValue[2] - colorsMinValue[2];
-                        }
-                        auto const& bufferView = gltfModel.bufferViews[accessor.bufferView];
-                        MFA_REQUIRE(bufferView.buffer < gltfModel.buffers.size());
-                        auto const& buffer = gltfModel.buffers[bufferView.buffer];
-                        colors = reinterpret_cast<const float*>(                           // TODO: Variable not used! Why?
-                            &buffer.data[bufferView.byteOffset + accessor.byteOffset]
-                            );
-                    }
+            // Normal uvs
+            if (hasNormalTexture)
+            {
+                copyDataIntoVertexMember(
+                    &vertex.normalMapUV[0],
+                    2,
+                    normalsUVs,
+                    i
+                );
+            }
 
-                    bool hasPosition = positions != nullptr;
-                    MFA_ASSERT(hasPosition == true);
-                    bool hasBaseColorTexture = baseColorUVs != nullptr;
-                    MFA_ASSERT(baseColorUVs != nullptr == baseColorTextureIndex >= 0);
-                    bool hasNormalValue = normalValues != nullptr;
-                    MFA_ASSERT(hasNormalValue == true);
-                    bool hasNormalTexture = normalsUVs != nullptr;
-                    MFA_ASSERT(normalsUVs != nullptr == normalTextureIndex >= 0);
-                    bool hasCombinedMetallicRoughness = metallicRoughnessUvs != nullptr;
-                    MFA_ASSERT(metallicRoughnessUvs != nullptr == metallicRoughnessTextureIndex >= 0);
-                    bool hasEmissiveTexture = emissionUVs != nullptr;
-                    MFA_ASSERT(emissionUVs != nullptr == emissiveTextureIndex >= 0);
-                    bool hasOcclusionTexture = occlusionUVs != nullptr;
-                    MFA_ASSERT((occlusionUVs != nullptr) == (occlusionTextureIndex >= 0));
-                    bool hasTangentValue = tangentValues != nullptr;
-                    bool hasSkin = jointItemCount > 0;
-                    for (uint32_t i = 0; i < primitiveVertexCount; ++i)
-                    {
-                        primitiveVertices.emplace_back();
-                        auto& vertex = primitiveVertices.back();
+            if (hasTangentValue)
+            {// Tangent
+                copyDataIntoVertexMember(
+                    &vertex.tangent[0],
+                    4,
+                    tangentValues,
+                    i
+                );
+            }
 
-                        // Positions
-                        if (hasPosition)
-                        {
-                            copyDataIntoVertexMember(
-                                &vertex.position[0],
-                                3,
-                                positions,
-                                i
-                            );
-                        }
+            if (hasEmissiveTexture)
+            {// Emissive
+                copyDataIntoVertexMember(
+                    &vertex.emissionUV[0],
+                    2,
+                    emissionUVs,
+                    i
+                );
+            }
 
-                        // Normal values
-                        if (hasNormalValue)
-                        {
-                            copyDataIntoVertexMember(
-                                &vertex.normal[0],
-                                3,
-                                normalValues,
-                                i
-                            );
-                        }
+            if (hasBaseColorTexture)
+            {// BaseColor
+                copyDataIntoVertexMember(
+                    &vertex.baseColorUV[0],
+                    2,
+                    baseColorUVs,
+                    i
+                );
+            }
 
-                        // Normal uvs
-                        if (hasNormalTexture)
-                        {
-                            copyDataIntoVertexMember(
-                                &vertex.normalMapUV[0],
-                                2,
-                                normalsUVs,
-                                i
-                            );
-                        }
+            if (hasOcclusionTexture)
+            {// Occlusion
+                copyDataIntoVertexMember(
+                    &vertex.occlusionUV[0],
+                    2,
+                    occlusionUVs,
+                    i
+                );
+            }
 
-                        if (hasTangentValue)
-                        {// Tangent
-                            copyDataIntoVertexMember(
-                                &vertex.tangent[0],
-                                4,
-                                tangentValues,
-                                i
-                            );
-                        }
+            if (hasCombinedMetallicRoughness)
+            {// MetallicRoughness
+                vertex.roughnessUV[0] = metallicRoughnessUvs[i * 2 + 0];
+                vertex.roughnessUV[1] = metallicRoughnessUvs[i * 2 + 1];
+                Memory::Copy(vertex.metallicUV, vertex.roughnessUV);
+                static_assert(sizeof(vertex.roughnessUV) == sizeof(vertex.metallicUV));
+                if (hasMetallicRoughnessUvMinMax)
+                {
+                    MFA_ASSERT(vertex.roughnessUV[0] >= metallicRoughnessUVMin[0]);
+                    MFA_ASSERT(vertex.roughnessUV[0] <= metallicRoughnessUVMax[0]);
+                    MFA_ASSERT(vertex.roughnessUV[1] >= metallicRoughnessUVMin[1]);
+                    MFA_ASSERT(vertex.roughnessUV[1] <= metallicRoughnessUVMax[1]);
+                }
+            }
+            // TODO WTF ? Outside of range error. Why do we need color range anyways ?
+            // vertex.color[0] = static_cast<uint8_t>((256/(colorsMinMaxDiff[0])) * colors[i * 3 + 0]);
+            // vertex.color[1] = static_cast<uint8_t>((256/(colorsMinMaxDiff[1])) * colors[i * 3 + 1]);
+            // vertex.color[2] = static_cast<uint8_t>((256/(colorsMinMaxDiff[2])) * colors[i * 3 + 2]);
 
-                        if (hasEmissiveTexture)
-                        {// Emissive
-                            copyDataIntoVertexMember(
-                                &vertex.emissionUV[0],
-                                2,
-                                emissionUVs,
-                                i
-                            );
-                        }
+            vertex.hasSkin = hasSkin ? 1 : 0;
 
-                        if (hasBaseColorTexture)
-                        {// BaseColor
-                            copyDataIntoVertexMember(
-                                &vertex.baseColorUV[0],
-                                2,
-                                baseColorUVs,
-                                i
-                            );
-                        }
+            // Joint and weight
+            if (hasSkin)
+            {
+                for (int j = 0; j < jointAccessorType; j++)
+                {
+                    vertex.jointIndices[j] = jointValues[i * jointAccessorType + j];
+                    vertex.jointWeights[j] = weightValues[i * jointAccessorType + j];
+                }
+                for (int j = jointAccessorType; j < 4; j++)
+                {
+                    vertex.jointIndices[j] = 0;
+                    vertex.jointWeights[j] = 0;
+                }
+            }
+        }
 
-                        if (hasOcclusionTexture)
-                        {// Occlusion
-                            copyDataIntoVertexMember(
-                                &vertex.occlusionUV[0],
-                                2,
-                                occlusionUVs,
-                                i
-                            );
-                        }
+        {// Primitive
+            auto & primitive = outPrimitive.primitive;
+            primitive.uniqueId = uniqueId;
+            primitive.baseColorTextureIndex = baseColorTextureIndex;
+            primitive.metallicRoughnessTextureIndex = metallicRoughnessTextureIndex;
+            primitive.normalTextureIndex = normalTextureIndex;
+            primitive.emissiveTextureIndex = emissiveTextureIndex;
+            primitive.occlusionTextureIndex = occlusionTextureIndex;
+            Memory::Copy(primitive.baseColorFactor, baseColorFactor);
+            primitive.metallicFactor = metallicFactor;
+            primitive.roughnessFactor = roughnessFactor;
+            Memory::Copy(primitive.emissiveFactor, emissiveFactor);
+            //primitive.occlusionStrengthFactor = occlusion
+            primitive.hasBaseColorTexture = hasBaseColorTexture;
+            primitive.hasEmissiveTexture = hasEmissiveTexture;
+            primitive.hasMetallicRoughnessTexture = hasCombinedMetallicRoughness;
+            primitive.hasNormalBuffer = hasNormalValue;
+            primitive.hasNormalTexture = hasNormalTexture;
+            primitive.hasTangentBuffer = hasTangentValue;
+            primitive.hasSkin = hasSkin;
+            primitive.hasPositionMinMax = hasPositionMinMax;
+            Memory::Copy(primitive.positionMin, positionsMinValue);
+            Memory::Copy(primitive.positionMax, positionsMaxValue);
+
+            primitive.alphaMode = alphaMode;
+            primitive.alphaCutoff = alphaCutoff;
+            primitive.doubleSided = doubleSided;
+            // -1 means the default, Which is triangles
+            primitive.topology = gltfPrimitive.mode >= 0 && gltfPrimitive.mode <= TINYGLTF_MODE_TRIANGLE_FAN
+                ? static_cast<AS::GLTF::PrimitiveTopology>(gltfPrimitive.mode)
+                : AS::GLTF::PrimitiveTopology::TriangleList;
+        }
+    }
 
-                        if (hasCombinedMetallicRoughness)
-                        {// MetallicRoughness
-                            vertex.roughnessUV[0] = metallicRoughnessUvs[i * 2 + 0];
-                            vertex.roughnessUV[1] = metallicRoughnessUvs[i * 2 + 1];
-                            Memory::Copy(vertex.metallicUV, vertex.roughnessUV);
-                            static_assert(sizeof(vertex.roughnessUV) == sizeof(vertex.metallicUV));
-                            if (hasMetallicRoughnessUvMinMax)
-                            {
-                                MFA_ASSERT(vertex.roughnessUV[0] >= metallicRoughnessUVMin[0]);
-                                MFA_ASSERT(vertex.roughnessUV[0] <= metallicRoughnessUVMax[0]);
-                                MFA_ASSERT(vertex.roughnessUV[1] >= metallicRoughnessUVMin[1]);
-                                MFA_ASSERT(vertex.roughnessUV[1] <= metallicRoughnessUVMax[1]);
-                            }
-                        }
-                        // TODO WTF ? Outside of range error. Why do we need color range anyways ?
-                        // vertex.color[0] = static_cast<uint8_t>((256/(colorsMinMaxDiff[0])) * colors[i * 3 + 0]);
-                        // vertex.color[1] = static_cast<uint8_t>((256/(colorsMinMaxDiff[1])) * colors[i * 3 + 1]);
-                        // vertex.color[2] = static_cast<uint8_t>((256/(colorsMinMaxDiff[2])) * colors[i * 3 + 2]);
+    //-------------------------------------------------------------------------------------------------
 
-                        vertex.hasSkin = hasSkin ? 1 : 0;
+    static std::shared_ptr<Mesh> GLTF_extractSubMeshes(
+        tinygltf::Model& gltfModel,
+        std::vector<TextureRef> const& textureRefs,
+        std::function<void()> const& onPrimitiveExtracted
+    )
+    {
+        struct PrimitiveJob
+        {
+            uint32_t subMeshIndex = 0;
+            tinygltf::Primitive* gltfPrimitive = nullptr;
+            uint32_t indicesVertexStartingIndex = 0;
+        };
 
-                        // Joint and weight
-                        if (hasSkin)
-                        {
-                            for (int j = 0; j < jointAccessorType; j++)
-                            {
-                                vertex.jointIndices[j] = jointValues[i * jointAccessorType + j];
-                                vertex.jointWeights[j] = weightValues[i * jointAccessorType + j];
-                            }
-                            for (int j = jointAccessorType; j < 4; j++)
-                            {
-                                vertex.jointIndices[j] = 0;
-                                vertex.jointWeights[j] = 0;
-                            }
-                        }
-                    }
+        // Step1: Iterate over all meshes and gather required information for asset buffer
+        uint32_t totalIndicesCount = 0;
+        uint32_t totalVerticesCount = 0;
+        std::vector<PrimitiveJob> jobs{};
+        for (uint32_t meshIndex = 0; meshIndex < static_cast<uint32_t>(gltfModel.meshes.size()); ++meshIndex)
+        {
+            for (auto& primitive : gltfModel.meshes[meshIndex].primitives)
+            {
+                jobs.emplace_back(PrimitiveJob{
+                    .subMeshIndex = meshIndex,
+                    .gltfPrimitive = &primitive,
+                    .indicesVertexStartingIndex = totalVerticesCount
+                });
+                {// Indices
+                    MFA_REQUIRE((primitive.indices < gltfModel.accessors.size()));
+                    auto const& accessor = gltfModel.accessors[primitive.indices];
+                    totalIndicesCount += static_cast<uint32_t>(accessor.count);
+                }
+                {// Positions
+                    MFA_REQUIRE((primitive.attributes["POSITION"] < gltfModel.accessors.size()));
+                    auto const& accessor = gltfModel.accessors[primitive.attributes["POSITION"]];
+                    totalVerticesCount += static_cast<uint32_t>(accessor.count);
+                }
+            }
+        }
 
-                    {// Creating new subMesh
-                        Primitive primitive{};
-                        primitive.uniqueId = uniqueId;
-                        primitive.baseColorTextureIndex = baseColorTextureIndex;
-                        primitive.metallicRoughnessTextureIndex = metallicRoughnessTextureIndex;
-                        primitive.normalTextureIndex = normalTextureIndex;
-                        primitive.emissiveTextureIndex = emissiveTextureIndex;
-                        primitive.occlusionTextureIndex = occlusionTextureIndex;
-                        Memory::Copy(primitive.baseColorFactor, baseColorFactor);
-                        primitive.metallicFactor = metallicFactor;
-                        primitive.roughnessFactor = roughnessFactor;
-                        Memory::Copy(primitive.emissiveFactor, emissiveFactor);
-                        //primitive.occlusionStrengthFactor = occlusion
-                        primitive.hasBaseColorTexture = hasBaseColorTexture;
-                        primitive.hasEmissiveTexture = hasEmissiveTexture;
-                        primitive.hasMetallicRoughnessTexture = hasCombinedMetallicRoughness;
-                        primitive.hasNormalBuffer = hasNormalValue;
-                        primitive.hasNormalTexture = hasNormalTexture;
-                        primitive.hasTangentBuffer = hasTangentValue;
-                        primitive.hasSkin = hasSkin;
-                        primitive.hasPositionMinMax = hasPositionMinMax;
-                        Memory::Copy(primitive.positionMin, positionsMinValue);
-                        Memory::Copy(primitive.positionMax, positionsMaxValue);
-
-                        primitive.alphaMode = alphaMode;
-                        primitive.alphaCutoff = alphaCutoff;
-                        primitive.doubleSided = doubleSided;
-
-                        mesh->InsertPrimitive(
-                            meshIndex,
-                            primitive,
-                            static_cast<uint32_t>(primitiveVertices.size()),
-                            primitiveVertices.data(),
-                            static_cast<uint32_t>(primitiveIndices.size()),
-                            primitiveIndices.data()
-                        );
-                    }
-                    indicesVertexStartingIndex += primitiveVertexCount;
+        auto mesh = std::make_shared<Mesh>(
+            totalVerticesCount,
+            totalIndicesCount,
+            Memory::AllocSize(sizeof(Vertex) * totalVerticesCount),
+            Memory::AllocSize(sizeof(Index) * totalIndicesCount)
+        );
 
+        // Step2: Extract the primitives in parallel, Each job writes to its own slot
+        std::vector<ExtractedPrimitive> primitives(jobs.size());
+        JobSystem::ParallelFor(static_cast<int>(jobs.size()), 1, [&](int const begin, int const end)->void
+        {
+            for (int i = begin; i < end; ++i)
+            {
+                auto const& job = jobs[i];
+                GLTF_extractPrimitive(
+                    gltfModel,
+                    *job.gltfPrimitive,
+                    textureRefs,
+                    static_cast<uint32_t>(i),
+                    job.indicesVertexStartingIndex,
+                    primitives[i]
+                );
+                if (onPrimitiveExtracted != nullptr)
+                {
+                    onPrimitiveExtracted();
                 }
             }
+        });
+
+        // Step3: Fill subMeshes in the original order
+        for (size_t i = 0; i < gltfModel.meshes.size(); ++i)
+        {
+            [[maybe_unused]] auto const subMeshIndex = mesh->InsertSubMesh();
+            MFA_ASSERT(subMeshIndex == i);
+        }
+        for (size_t i = 0; i < jobs.size(); ++i)
+        {
+            auto& extracted = primitives[i];
+            mesh->InsertPrimitive(
+                jobs[i].subMeshIndex,
+                extracted.primitive,
+                static_cast<uint32_t>(extracted.vertices.size()),
+                extracted.vertices.data(),
+                static_cast<uint32_t>(extracted.indices.size()),
+                extracted.indices.data()
+            );
+            // Releasing each copy after it is inserted keeps the peak memory lower
+            extracted = {};
         }
         return mesh;
     }
 
 	//-------------------------------------------------------------------------------------------------
 
-    std::shared_ptr<MFA::Importer::Model> GLTF_Model(std::string const& path)
+    // Textures are mipmapped and block compressed on import, The result is baked next to the image so the next
+    // import only reads it back
+    static std::shared_ptr<AS::Texture> GLTF_loadTexture(std::string const& path, bool const isColor)
+    {
+        auto const extension = std::filesystem::path(path).extension().string();
+
+        std::shared_ptr<AS::Texture> texture{};
+        if (extension == ".png" || extension == ".jpg" || extension == ".jpeg")
+        {
+            texture = Importer::CompressedImage(path, ImageImportParams{
+                .sRGB = isColor,
+                .compression = ImageCompression::BC7
+            });
+        }
+        else
+        {
+            MFA_ASSERT(false);
+        }
+
+        MFA_ASSERT(texture != nullptr);
+        return texture;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // The cache keeps only the uris of the textures, So the color flag is recovered from the primitives that use them
+    static std::vector<bool> GLTF_findColorTextures(Mesh const& mesh, size_t const textureCount)
+    {
+        std::vector<bool> isColor(textureCount, false);
+        auto const markColor = [&isColor](bool const hasTexture, int const textureIndex)->void
+        {
+            if (hasTexture && textureIndex >= 0 && static_cast<size_t>(textureIndex) < isColor.size())
+            {
+                isColor[textureIndex] = true;
+            }
+        };
+        for (auto const& subMesh : mesh.GetMeshData()->subMeshes)
+        {
+            for (auto const& primitive : subMesh.primitives)
+            {
+                markColor(primitive.hasBaseColorTexture, primitive.baseColorTextureIndex);
+                markColor(primitive.hasEmissiveTexture, primitive.emissiveTextureIndex);
+            }
+        }
+        return isColor;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Hashes the gltf file and every external buffer that it references. Images have their own cache next to them, So
+    // they are not part of the hash.
+    static uint64_t GLTF_hashSource(
+        std::string const& baseDirectory,
+        std::string const& extension,
+        BaseBlob const& file
+    )
+    {
+        auto hash = Hash::Hash64(file.Ptr(), file.Len(), AS::GLTF::Cache::Version);
+
+        char const* jsonBegin = file.As<char>();
+        char const* jsonEnd = jsonBegin + file.Len();
+        if (extension == ".glb")
+        {
+            // 12 bytes of header, Then the json chunk length and type
+            if (file.Len() < 20)
+            {
+                return hash;
+            }
+            uint32_t jsonLength = 0;
+            std::memcpy(&jsonLength, file.Ptr() + 12, sizeof(jsonLength));
+            jsonBegin += 20;
+            jsonEnd = jsonBegin + std::min<size_t>(jsonLength, file.Len() - 20);
+        }
+
+        auto const json = nlohmann::json::parse(jsonBegin, jsonEnd, nullptr, false);
+        if (json.is_discarded() == true || json.contains("buffers") == false)
+        {
+            return hash;
+        }
+        for (auto const& buffer : json["buffers"])
+        {
+            if (buffer.contains("uri") == false || buffer["uri"].is_string() == false)
+            {
+                continue;
+            }
+            auto const uri = buffer["uri"].get<std::string>();
+            // Embedded buffers are already part of the file
+            if (uri.rfind("data:", 0) == 0)
+            {
+                continue;
+            }
+            auto const bufferPath = baseDirectory + "/" + uri;
+            std::error_code errorCode{};
+            if (std::filesystem::exists(bufferPath, errorCode) == false)
+            {
+                hash = Hash::Combine(hash, 0);
+                continue;
+            }
+            auto const bufferFile = File::Map(bufferPath);
+            hash = Hash::Combine(
+                hash,
+                bufferFile != nullptr ? Hash::Hash64(bufferFile->Ptr(), bufferFile->Len()) : 0
+            );
+        }
+        return hash;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    static std::shared_ptr<Model> GLTF_load(std::string const& path, GLTF_LoadProgress* progress)
     {
+        auto const completeStep = [progress]()->void
+        {
+            if (progress != nullptr)
+            {
+                progress->completedSteps.fetch_add(1, std::memory_order_relaxed);
+            }
+        };
+
         std::shared_ptr<Model> model = nullptr;
         if (MFA_VERIFY(path.empty() == false))
         {
@@ -1125,25 +1346,71 @@ namespace MFA::Importer
             TG::Model gltfModel{};
 
             auto const extension = std::filesystem::path(path).extension().string();
+            auto const baseDirectory = std::filesystem::path(path).parent_path().string();
+
+            // The parser reads straight from the mapped file instead of a copy of it
+            auto const file = File::Map(path);
+            if (file == nullptr)
+            {
+                MFA_LOG_ERROR("ImportGltf Error: Failed to read %s", path.c_str());
+                return model;
+            }
+
+            auto const sourceHash = GLTF_hashSource(baseDirectory, extension, *file);
+            auto const cachePath = path + ".cache";
+            {// Baked cache, Only the textures are left to decode
+                AS::GLTF::Cache::Content cached{};
+                if (AS::GLTF::Cache::Read(cachePath, sourceHash, cached) == true)
+                {
+                    if (progress != nullptr)
+                    {
+                        progress->totalSteps.store(
+                            static_cast<int>(1 + cached.textureUris.size()),
+                            std::memory_order_relaxed
+                        );
+                    }
+                    completeStep();
+
+                    std::vector<std::shared_ptr<AS::Texture>> textures(cached.textureUris.size());
+                    auto const isColor = GLTF_findColorTextures(*cached.mesh, cached.textureUris.size());
+                    JobSystem::ParallelFor(static_cast<int>(textures.size()), 1, [&](int const begin, int const end)->void
+                    {
+                        for (int i = begin; i < end; ++i)
+                        {
+                            textures[i] = GLTF_loadTexture(baseDirectory + "/" + cached.textureUris[i], isColor[i]);
+                            completeStep();
+                        }
+                    });
+
+                    model = std::make_shared<Model>();
+                    model->mesh = cached.mesh;
+                    model->textures = std::move(textures);
+                    return model;
+                }
+            }
 
             bool success = false;
 
             if (extension == ".gltf")
             {
-                success = loader.LoadASCIIFromFile(
+                success = loader.LoadASCIIFromString(
                     &gltfModel,
                     &error,
                     &warning,
-                    path
+                    file->As<char>(),
+                    static_cast<unsigned int>(file->Len()),
+                    baseDirectory
                 );
             }
             else if (extension == ".glb")
             {
-                success = loader.LoadBinaryFromFile(
+                success = loader.LoadBinaryFromMemory(
                     &gltfModel,
                     &error,
                     &warning,
-                    path
+                    file->Ptr(),
+                    static_cast<unsigned int>(file->Len()),
+                    baseDirectory
                 );
             }
             else
@@ -1163,6 +1430,14 @@ namespace MFA::Importer
             {
                 std::shared_ptr<Mesh> mesh{};
                 std::vector<TextureRef> textureRefs{};
+                std::vector<std::shared_ptr<AS::Texture>> textures{};
+
+                // Decode jobs write into textures, So we cannot leave before all of them are done
+                std::atomic<int> remainingTextures = 0;
+                MFA_DEFFER([&remainingTextures]()->void
+                {
+                    JobSystem::Wait(remainingTextures);
+                });
 
                 // TODO Camera
                 if (false == gltfModel.meshes.empty())
@@ -1174,8 +1449,39 @@ namespace MFA::Importer
                         textureRefs
                     );
 
+                    if (progress != nullptr)
+                    {
+                        // Parsing, Textures, Primitives and the final processing of the mesh
+                        size_t primitiveCount = 0;
+                        for (auto const& gltfMesh : gltfModel.meshes)
+                        {
+                            primitiveCount += gltfMesh.primitives.size();
+                        }
+                        progress->totalSteps.store(
+                            static_cast<int>(2 + textureRefs.size() + primitiveCount),
+                            std::memory_order_relaxed
+                        );
+                    }
+                    completeStep();
+
+                    // Decoding is independent of the mesh, So the jobs run while this thread extracts the primitives
+                    textures.resize(textureRefs.size());
+                    remainingTextures.store(static_cast<int>(textureRefs.size()), std::memory_order_relaxed);
+                    for (size_t i = 0; i < textureRefs.size(); ++i)
+                    {
+                        JobSystem::Dispatch([&textures, &textureRefs, &remainingTextures, &completeStep, i]()->void
+                        {
+                            MFA_DEFFER([&remainingTextures]()->void
+                            {
+                                remainingTextures.fetch_sub(1, std::memory_order_release);
+                            });
+                            textures[i] = GLTF_loadTexture(textureRefs[i].relativePath, textureRefs[i].isColor);
+                            completeStep();
+                        });
+                    }
+
                     // SubMeshes
-                    mesh = GLTF_extractSubMeshes(gltfModel, textureRefs);
+                    mesh = GLTF_extractSubMeshes(gltfModel, textureRefs, completeStep);
                     if (mesh == nullptr)
                     {
                         return model;
@@ -1189,25 +1495,40 @@ namespace MFA::Importer
                 GLTF_extractAnimations(gltfModel, mesh.get());
                 mesh->FinalizeData();
 
-                std::vector<std::shared_ptr<AS::Texture>> textures{};
-                for (size_t i = 0; i < textureRefs.size(); ++i)
-                {
-                    auto const path = textureRefs[i].relativePath;
-                    auto const extension = std::filesystem::path(path).extension().string();
+                auto const renderingStats = mesh->OptimizeForRendering();
+                MFA_LOG_INFO(
+                    "Optimized %s for rendering. ACMR: %f -> %f, ATVR: %f -> %f",
+                    path.c_str(),
+                    renderingStats.before.ACMR(),
+                    renderingStats.after.ACMR(),
+                    renderingStats.before.ATVR(),
+                    renderingStats.after.ATVR()
+                );
 
-                    std::shared_ptr<AS::Texture> texture{};
-                    if (extension == ".png" || extension == ".jpg" || extension == ".jpeg")
-                    {
-                        texture = Importer::UncompressedImage(path);
-                    }
-                    else
-                    {
-                        MFA_ASSERT(false);
-                    }
+                // After the last step that moves vertices around, So the streams match the final index buffer
+                auto const memoryReport = mesh->PackVertices(AS::GLTF::PackingParams{});
+                MFA_LOG_INFO(
+                    "Packed vertices of %s. %zu vertices, %zu -> %zu bytes (%fx)",
+                    path.c_str(),
+                    memoryReport.vertexCount,
+                    memoryReport.unpackedBytes,
+                    memoryReport.packedBytes,
+                    memoryReport.CompressionRatio()
+                );
 
-                    MFA_ASSERT(texture != nullptr);
-                    textures.emplace_back(texture);
+                std::vector<std::string> textureUris{};
+                textureUris.reserve(textureRefs.size());
+                for (auto const& textureRef : textureRefs)
+                {
+                    textureUris.emplace_back(textureRef.gltfName);
+                }
+                if (AS::GLTF::Cache::Write(cachePath, sourceHash, *mesh, textureUris) == false)
+                {
+                    MFA_LOG_WARN("Failed to bake %s into %s", path.c_str(), cachePath.c_str());
                 }
+                completeStep();
+
+                JobSystem::Wait(remainingTextures);
 
                 model = std::make_shared<Model>();
                 model->mesh = mesh;
@@ -1219,4 +1540,81 @@ namespace MFA::Importer
 
     //-------------------------------------------------------------------------------------------------
 
+    float GLTF_LoadProgress::Ratio() const
+    {
+        auto const total = totalSteps.load(std::memory_order_relaxed);
+        if (total <= 0)
+        {
+            return 0.0f;
+        }
+        auto const completed = completedSteps.load(std::memory_order_relaxed);
+        return std::min(static_cast<float>(completed) / static_cast<float>(total), 1.0f);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    float GLTF_ModelHandle::Progress() const
+    {
+        if (IsReady() == true)
+        {
+            return 1.0f;
+        }
+        return progress != nullptr ? progress->Ratio() : 0.0f;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool GLTF_ModelHandle::IsReady() const
+    {
+        return future.valid() && future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<Model> GLTF_ModelHandle::Get() const
+    {
+        if (MFA_VERIFY(future.valid()) == false)
+        {
+            return nullptr;
+        }
+        JobSystem::WaitUntil([this]()->bool
+        {
+            return IsReady();
+        });
+        return future.get();
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<Model> GLTF_Model(std::string const& path)
+    {
+        return GLTF_load(path, nullptr);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    GLTF_ModelHandle GLTF_ModelAsync(std::string const& path)
+    {
+        GLTF_ModelHandle handle{};
+        handle.progress = std::make_shared<GLTF_LoadProgress>();
+
+        // Without a job system there is no thread to load on
+        if (JobSystem::HasInstance() == false)
+        {
+            std::promise<std::shared_ptr<Model>> promise{};
+            promise.set_value(GLTF_load(path, handle.progress.get()));
+            handle.future = promise.get_future().share();
+            return handle;
+        }
+
+        // Reading the file blocks, So the load starts on an io thread and fans out to the compute threads from there
+        handle.future = JobSystem::AssignIOTask<std::shared_ptr<Model>>([path, progress = handle.progress]()->std::shared_ptr<Model>
+        {
+            return GLTF_load(path, progress.get());
+        }).share();
+        return handle;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
 }
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include "AssetGLTF_Mesh.hpp"
 #include "AssetGLTF_Model.hpp"
 
+#include <atomic>
+#include <future>
 #include <memory>
 #include <string>
 
@@ -20,5 +22,36 @@ namespace MFA::Importer
     using Node = AS::GLTF::Node;
     using Skin = AS::GLTF::Skin;
 
+    struct GLTF_LoadProgress
+    {
+        std::atomic<int> completedSteps = 0;
+        std::atomic<int> totalSteps = 0;            // Zero until the file is parsed
+
+        [[nodiscard]]
+        float Ratio() const;
+    };
+
+    struct GLTF_ModelHandle
+    {
+        std::shared_future<std::shared_ptr<Model>> future{};
+        std::shared_ptr<GLTF_LoadProgress> progress{};
+
+        // From 0 to 1
+        [[nodiscard]]
+        float Progress() const;
+
+        [[nodiscard]]
+        bool IsReady() const;
+
+        // Runs pending jobs on the calling thread until the model is loaded. Returns nullptr if loading failed.
+        [[nodiscard]]
+        std::shared_ptr<Model> Get() const;
+    };
+
+    // Textures are decoded and primitives are extracted in parallel over the JobSystem
     std::shared_ptr<Model> GLTF_Model(std::string const& path);
+
+    // Same as GLTF_Model but returns immediately, So the frame loop can poll the handle instead of waiting
+    [[nodiscard]]
+    GLTF_ModelHandle GLTF_ModelAsync(std::string const& path);
 }
@@ -66,6 +66,16 @@ namespace MFA::Importer
 			outputPath.c_str()
 		);
 		auto const result = std::system(command.c_str());
+		if (result != 0)
+		{
+			// The asserts of the callers are gone in release, So this is the only trace of the spv being out of date
+			MFA_LOG_ERROR(
+				"Failed to compile %s (%d), The prebuilt %s is used instead",
+				inputPath.c_str(),
+				result,
+				outputPath.c_str()
+			);
+		}
 		return result == 0;
 	}
 
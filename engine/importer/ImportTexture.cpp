@@ -1,20 +1,26 @@
 #include "ImportTexture.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 
 #include "AssetTexture.hpp"
+#include "AssetTexture_BlockCompression.hpp"
+#include "AssetTexture_Cache.hpp"
+#include "AssetTexture_KTX.hpp"
+#include "AssetTexture_PixelConversion.hpp"
 #include "BedrockAssert.hpp"
 #include "BedrockDeffer.hpp"
 #include "BedrockFile.hpp"
+#include "BedrockHash.hpp"
 #include "BedrockMemory.hpp"
 #include "BedrockPath.hpp"
+#include "JobSystem.hpp"
 
 #include "stb_image.h"
 #include "stb_image_resize.h"
-// #include "ktx.h"
-// #include "vulkan/vulkan_core.h"
-// #include "ktxvulkan.h"
 
 namespace MFA::Importer
 {
@@ -26,15 +32,14 @@ namespace MFA::Importer
         int32_t width = 0;
         int32_t height = 0;
         int32_t stbi_components = 0;
-        std::shared_ptr<Blob> stbi_pixels;
         Format format = Format::INVALID;
         std::shared_ptr<Blob> pixels;
         uint32_t components = 0;
         [[nodiscard]]
         bool valid() const
         {
-            return stbi_pixels != nullptr &&
-                stbi_pixels->IsValid() == true &&
+            return pixels != nullptr &&
+                pixels->IsValid() == true &&
                 width > 0 &&
                 height > 0 &&
                 stbi_components > 0;
@@ -49,20 +54,13 @@ namespace MFA::Importer
         // Format not supported
     };
 
-    static LoadResult LoadUncompressed(Data& outImageData, std::string const& path, bool prefer_srgb)
+    static LoadResult LoadUncompressed(Data& outImageData, BaseBlob const& rawFile, bool prefer_srgb)
     {
         LoadResult ret = LoadResult::Invalid;
 
-        auto const rawFile = File::Read(path);
-
-        if (rawFile == nullptr)
-        {
-            return ret;
-        }
-
         auto* readData = stbi_load_from_memory(
-            rawFile->Ptr(),
-            static_cast<int>(rawFile->Len()),
+            rawFile.Ptr(),
+            static_cast<int>(rawFile.Len()),
             &outImageData.width,
             &outImageData.height,
             &outImageData.stbi_components,
@@ -76,13 +74,6 @@ namespace MFA::Importer
             MFA_ASSERT(outImageData.height > 0);
             MFA_ASSERT(outImageData.stbi_components > 0);
 
-            auto blobSize = static_cast<size_t>(outImageData.width) *
-                outImageData.height *
-                outImageData.stbi_components *
-                sizeof(uint8_t);
-
-            outImageData.stbi_pixels = Memory::Alloc(readData, blobSize);
-
             outImageData.components = outImageData.stbi_components;
             if (prefer_srgb)
             {
@@ -119,32 +110,39 @@ namespace MFA::Importer
                 }
             }
             MFA_ASSERT(outImageData.components >= static_cast<uint32_t>(outImageData.stbi_components));
-            if (static_cast<int>(outImageData.components) == outImageData.stbi_components)
+            // Stb owns its buffer, So it is converted (Or copied) straight into the final blob
+            auto const width = static_cast<size_t>(outImageData.width);
+            auto const inputComponents = static_cast<size_t>(outImageData.stbi_components);
+            auto const outputComponents = static_cast<size_t>(outImageData.components);
+            outImageData.pixels = Memory::AllocSize(width * outImageData.height * outputComponents);
+            auto * output = outImageData.pixels->As<uint8_t>();
+
+            int const grain = static_cast<int>(std::max<size_t>(16384 / width, 1));
+            JobSystem::ParallelFor(outImageData.height, grain, [&](int const startRow, int const endRow)->void
             {
-                outImageData.pixels = outImageData.stbi_pixels;
-            }
-            else
-            {
-                auto const size = static_cast<size_t>(outImageData.width) *
-                    outImageData.height *
-                    outImageData.components *
-                    sizeof(uint8_t);
-
-                outImageData.pixels = Memory::AllocSize(size);
-
-                auto* pixels_array = outImageData.pixels->As<uint8_t>();
-                auto const* stbi_pixels_array = outImageData.stbi_pixels->As<uint8_t>();
-                // This can be parallized using openMP
-                for (int pixel_index = 0; pixel_index < outImageData.width * outImageData.height; pixel_index++)
+                auto const pixelCount = width * static_cast<size_t>(endRow - startRow);
+                auto const * rowInput = readData + width * startRow * inputComponents;
+                auto * rowOutput = output + width * startRow * outputComponents;
+                if (outputComponents == inputComponents)
                 {
-                    for (uint32_t component_index = 0; component_index < outImageData.components; component_index++)
-                    {
-                        pixels_array[pixel_index * outImageData.components + component_index] = static_cast<int64_t>(component_index) < outImageData.stbi_components
-                            ? stbi_pixels_array[pixel_index * outImageData.stbi_components + component_index]
-                            : 255u;
-                    }
+                    std::memcpy(rowOutput, rowInput, pixelCount * inputComponents);
+                    return;
                 }
-            }
+                switch (inputComponents)
+                {
+                case 1:
+                    AS::PixelConversion::RToRGBA(rowInput, rowOutput, pixelCount);
+                    break;
+                case 2:
+                    AS::PixelConversion::GreyAlphaToRGBA(rowInput, rowOutput, pixelCount);
+                    break;
+                case 3:
+                    AS::PixelConversion::RGBToRGBA(rowInput, rowOutput, pixelCount);
+                    break;
+                default:
+                    MFA_ASSERT(false);
+                }
+            });
             ret = LoadResult::Success;
         }
         else
@@ -154,6 +152,19 @@ namespace MFA::Importer
         return ret;
     }
 
+    static LoadResult LoadUncompressed(Data& outImageData, std::string const& path, bool prefer_srgb)
+    {
+        // Stb decodes straight from the mapped file
+        auto const rawFile = File::Map(path);
+
+        if (rawFile == nullptr)
+        {
+            return LoadResult::Invalid;
+        }
+
+        return LoadUncompressed(outImageData, *rawFile, prefer_srgb);
+    }
+
     //-------------------------------------------------------------------------------------------------
 
     struct ResizeInputParams
@@ -253,6 +264,307 @@ namespace MFA::Importer
 
     //-------------------------------------------------------------------------------------------------
 
+    // Source pixels that a destination pixel covers and how much of it each one covers
+    struct FilterTap
+    {
+        uint32_t index = 0;
+        float weight = 0.0f;
+    };
+
+    static std::vector<std::vector<FilterTap>> ComputeFilterTaps(uint32_t const sourceSize, uint32_t const destinationSize)
+    {
+        std::vector<std::vector<FilterTap>> taps(destinationSize);
+        float const ratio = static_cast<float>(sourceSize) / static_cast<float>(destinationSize);
+        for (uint32_t i = 0; i < destinationSize; ++i)
+        {
+            // Odd sizes are not dropped, The pixels on the border are shared between two destination pixels
+            float const begin = static_cast<float>(i) * ratio;
+            float const end = begin + ratio;
+            for (auto source = static_cast<uint32_t>(begin); source < sourceSize && static_cast<float>(source) < end; ++source)
+            {
+                float const coverage = std::min(end, static_cast<float>(source + 1)) - std::max(begin, static_cast<float>(source));
+                if (coverage > 0.0f)
+                {
+                    taps[i].emplace_back(FilterTap{.index = source, .weight = coverage / ratio});
+                }
+            }
+        }
+        return taps;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    struct SRGBTables
+    {
+        static constexpr uint32_t EncodeSteps = 1 << 14;
+
+        float decode[256]{};
+        uint8_t encode[EncodeSteps + 1]{};
+
+        SRGBTables()
+        {
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                float const value = static_cast<float>(i) / 255.0f;
+                decode[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+            }
+            for (uint32_t i = 0; i <= EncodeSteps; ++i)
+            {
+                float const value = static_cast<float>(i) / static_cast<float>(EncodeSteps);
+                float const encoded = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+                encode[i] = static_cast<uint8_t>(std::lround(std::clamp(encoded, 0.0f, 1.0f) * 255.0f));
+            }
+        }
+
+        [[nodiscard]]
+        uint8_t Encode(float const linear) const
+        {
+            auto const step = std::lround(std::clamp(linear, 0.0f, 1.0f) * static_cast<float>(EncodeSteps));
+            return encode[step];
+        }
+    };
+
+    static SRGBTables const & GetSRGBTables()
+    {
+        static SRGBTables const tables{};
+        return tables;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    struct MipInfo
+    {
+        std::shared_ptr<Blob> pixels{};
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    // Box filter that covers odd sizes as well. Colors are averaged in linear space and weighted by their alpha,
+    // So the chain does not darken and transparent texels do not bleed into their neighbours.
+    static MipInfo DownsampleMip(
+        MipInfo const& source,
+        uint32_t const components,
+        bool const useSRGB
+    )
+    {
+        MipInfo destination{
+            .width = std::max<uint32_t>(source.width / 2, 1),
+            .height = std::max<uint32_t>(source.height / 2, 1)
+        };
+        destination.pixels = Memory::AllocSize(static_cast<size_t>(destination.width) * destination.height * components);
+
+        auto const columnTaps = ComputeFilterTaps(source.width, destination.width);
+        auto const rowTaps = ComputeFilterTaps(source.height, destination.height);
+        auto const& tables = GetSRGBTables();
+        bool const hasAlpha = components == 4;
+        // Alpha is never sRGB encoded
+        uint32_t const colorComponents = hasAlpha ? 3 : components;
+
+        auto const* input = source.pixels->As<uint8_t>();
+        auto* output = destination.pixels->As<uint8_t>();
+        int const grain = static_cast<int>(std::max<uint32_t>(4096 / destination.width, 1));
+        JobSystem::ParallelFor(static_cast<int>(destination.height), grain, [&](int const begin, int const end)->void
+        {
+            for (int y = begin; y < end; ++y)
+            {
+                for (uint32_t x = 0; x < destination.width; ++x)
+                {
+                    float sum[4]{};
+                    for (auto const& rowTap : rowTaps[y])
+                    {
+                        for (auto const& columnTap : columnTaps[x])
+                        {
+                            float const weight = rowTap.weight * columnTap.weight;
+                            auto const* pixel = input + (static_cast<size_t>(rowTap.index) * source.width + columnTap.index) * components;
+                            float const alpha = hasAlpha ? static_cast<float>(pixel[3]) / 255.0f : 1.0f;
+                            for (uint32_t c = 0; c < colorComponents; ++c)
+                            {
+                                float const value = useSRGB ? tables.decode[pixel[c]] : static_cast<float>(pixel[c]) / 255.0f;
+                                sum[c] += value * alpha * weight;
+                            }
+                            if (hasAlpha)
+                            {
+                                sum[3] += alpha * weight;
+                            }
+                        }
+                    }
+
+                    auto* pixel = output + (static_cast<size_t>(y) * destination.width + x) * components;
+                    float const inverseAlpha = hasAlpha && sum[3] > 0.0f ? 1.0f / sum[3] : 1.0f;
+                    for (uint32_t c = 0; c < colorComponents; ++c)
+                    {
+                        float const value = sum[c] * inverseAlpha;
+                        pixel[c] = useSRGB
+                            ? tables.Encode(value)
+                            : static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+                    }
+                    if (hasAlpha)
+                    {
+                        pixel[3] = static_cast<uint8_t>(std::lround(std::clamp(sum[3], 0.0f, 1.0f) * 255.0f));
+                    }
+                }
+            }
+        });
+        return destination;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    static Format ChooseCompressedFormat(ImageImportParams const& params, bool const hasAlpha)
+    {
+        switch (params.compression)
+        {
+        case ImageCompression::BC1:
+            if (params.sRGB)
+            {
+                return hasAlpha ? Format::BC1_UNorm_sRGB_RGBA : Format::BC1_UNorm_sRGB_RGB;
+            }
+            return hasAlpha ? Format::BC1_UNorm_Linear_RGBA : Format::BC1_UNorm_Linear_RGB;
+        case ImageCompression::BC4:
+            return Format::BC4_UNorm_Linear_R;
+        case ImageCompression::BC5:
+            return Format::BC5_UNorm_Linear_RG;
+        case ImageCompression::BC7:
+            if (params.sRGB)
+            {
+                return hasAlpha ? Format::BC7_UNorm_sRGB_RGBA : Format::BC7_UNorm_sRGB_RGB;
+            }
+            return hasAlpha ? Format::BC7_UNorm_Linear_RGBA : Format::BC7_UNorm_Linear_RGB;
+        default:
+            return Format::INVALID;
+        }
+    }
+
+    static char const* GetCacheTag(ImageCompression const compression)
+    {
+        switch (compression)
+        {
+        case ImageCompression::BC1: return "bc1";
+        case ImageCompression::BC4: return "bc4";
+        case ImageCompression::BC5: return "bc5";
+        case ImageCompression::BC7: return "bc7";
+        default: return "mips";
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<AS::Texture> CompressedImage(std::string const& path, ImageImportParams const& params)
+    {
+        std::shared_ptr<AS::Texture> texture{};
+
+        auto const rawFile = File::Map(path);
+        if (rawFile == nullptr)
+        {
+            return texture;
+        }
+
+        auto sourceHash = Hash::Hash64(rawFile->Ptr(), rawFile->Len(), AS::TextureCache::Version);
+        sourceHash = Hash::Combine(sourceHash, params.generateMipmaps ? 1 : 0);
+        sourceHash = Hash::Combine(sourceHash, params.sRGB ? 1 : 0);
+        sourceHash = Hash::Combine(sourceHash, static_cast<uint64_t>(params.compression));
+        auto const cachePath = path + "." + GetCacheTag(params.compression) + ".cache";
+        if (params.useCache && AS::TextureCache::Read(cachePath, sourceHash, path, texture) == true)
+        {
+            return texture;
+        }
+
+        bool const compress = params.compression != ImageCompression::None;
+        bool const colorData = params.compression != ImageCompression::BC4 && params.compression != ImageCompression::BC5;
+
+        Data imageData{};
+        if (LoadUncompressed(imageData, *rawFile, params.sRGB && colorData) != LoadResult::Success)
+        {
+            MFA_LOG_WARN("Failed to decode %s", path.c_str());
+            return texture;
+        }
+        MFA_ASSERT(imageData.valid());
+
+        auto format = imageData.format;
+        uint32_t components = imageData.components;
+        auto pixels = imageData.pixels;
+        if (compress)
+        {
+            // Rgba images that are fully opaque still get the cheaper rgb formats
+            bool hasAlpha = false;
+            if (imageData.stbi_components == 4)
+            {
+                size_t const pixelCount = static_cast<size_t>(imageData.width) * imageData.height;
+                auto const* sourcePixels = pixels->As<uint8_t>();
+                for (size_t i = 0; i < pixelCount && hasAlpha == false; ++i)
+                {
+                    hasAlpha = sourcePixels[i * 4 + 3] != 255;
+                }
+            }
+            format = ChooseCompressedFormat(params, hasAlpha);
+            // Encoders always read rgba
+            if (components != 4)
+            {
+                size_t const pixelCount = static_cast<size_t>(imageData.width) * imageData.height;
+                auto expanded = Memory::AllocSize(pixelCount * 4);
+                auto* expandedPixels = expanded->As<uint8_t>();
+                auto const* sourcePixels = pixels->As<uint8_t>();
+                for (size_t i = 0; i < pixelCount; ++i)
+                {
+                    for (uint32_t c = 0; c < 4; ++c)
+                    {
+                        expandedPixels[i * 4 + c] = c < components ? sourcePixels[i * components + c] : (c == 3 ? 255 : 0);
+                    }
+                }
+                pixels = std::move(expanded);
+                components = 4;
+            }
+        }
+        bool const useSRGB = AS::Texture::FormatInfo(format).color_space == 1;
+
+        AS::Texture::Dimensions const dimensions{
+            .width = static_cast<uint32_t>(imageData.width),
+            .height = static_cast<uint32_t>(imageData.height),
+            .depth = 1
+        };
+        uint8_t const mipCount = params.generateMipmaps ? AS::Texture::MaxMipCount(dimensions) : 1;
+
+        // Every level is filtered from the previous one, Each level is parallel on its own
+        std::vector<MipInfo> mips{};
+        mips.reserve(mipCount);
+        mips.emplace_back(MipInfo{.pixels = pixels, .width = dimensions.width, .height = dimensions.height});
+        for (uint8_t level = 1; level < mipCount; ++level)
+        {
+            mips.emplace_back(DownsampleMip(mips.back(), components, useSRGB));
+        }
+
+        texture = std::make_shared<AS::Texture>(path, format, 1, 1, mipCount);
+        size_t offset = 0;
+        for (uint8_t level = 0; level < mipCount; ++level)
+        {
+            auto const& mip = mips[level];
+            auto data = compress
+                ? AS::BlockCompression::Encode(format, mip.pixels->As<uint8_t>(), mip.width, mip.height)
+                : mip.pixels;
+            MFA_ASSERT(data->Len() == AS::Texture::MipSizeBytes(format, 1, AS::Texture::Dimensions{
+                .width = mip.width, .height = mip.height, .depth = 1
+            }));
+
+            texture->SetMipmapDimension(level, AS::Texture::Dimensions{
+                .width = mip.width,
+                .height = mip.height,
+                .depth = 1
+            });
+            texture->SetMipmapOffset(level, offset);
+            texture->SetMipmapData(level, data);
+            offset += data->Len();
+        }
+
+        if (params.useCache && AS::TextureCache::Write(cachePath, sourceHash, *texture) == false)
+        {
+            MFA_LOG_WARN("Failed to bake %s into %s", path.c_str(), cachePath.c_str());
+        }
+
+        return texture;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
     std::shared_ptr<AS::Texture> ErrorTexture()
     {
         auto data = Memory::AllocSize(4);
@@ -274,133 +586,15 @@ namespace MFA::Importer
 
     //-------------------------------------------------------------------------------------------------
 
-    // static Format MapVkFormat(ktx_uint32_t vkFormat) {
-    //     switch (vkFormat) {
-    //         case VK_FORMAT_R8G8B8A8_SRGB: //return Format::UNCOMPRESSED_UNORM_R8G8B8A8_SRGB;              // VK_FORMAT_R8G8B8A8_SRGB
-    //         case VK_FORMAT_R8G8B8A8_UNORM: return Format::UNCOMPRESSED_UNORM_R8G8B8A8_LINEAR;           // VK_FORMAT_R8G8B8A8_UNORM
-    //         case VK_FORMAT_R16G16B16A16_UNORM: return Format::UNCOMPRESSED_UNORM_R16G16B16A16_LINEAR;   // VK_FORMAT_R16G16B16A16_UNORM
-    //         case VK_FORMAT_BC7_UNORM_BLOCK: return Format::BC7_UNorm_Linear_RGBA;                       // VK_FORMAT_BC7_UNORM_BLOCK
-    //         case VK_FORMAT_BC7_SRGB_BLOCK: return Format::BC7_UNorm_sRGB_RGBA;                          // VK_FORMAT_BC7_SRGB_BLOCK
-    //         case VK_FORMAT_BC6H_UFLOAT_BLOCK: return Format::BC6H_UFloat_Linear_RGB;                    // VK_FORMAT_BC6H_UFLOAT_BLOCK
-    //         case VK_FORMAT_BC6H_SFLOAT_BLOCK: return Format::BC6H_SFloat_Linear_RGB;                    // VK_FORMAT_BC6H_SFLOAT_BLOCK
-    //         case VK_FORMAT_ASTC_4x4_UNORM_BLOCK: return Format::ASTC_4x4_UNORM_BLOCK;
-    //         case VK_FORMAT_ASTC_4x4_SRGB_BLOCK: return Format::ASTC_4x4_SRGB_BLOCK;
-    //         case VK_FORMAT_ASTC_5x4_UNORM_BLOCK: return Format::ASTC_5x4_UNORM_BLOCK;
-    //         case VK_FORMAT_ASTC_5x4_SRGB_BLOCK: return Format::ASTC_5x4_SRGB_BLOCK;
-    //         case VK_FORMAT_ASTC_5x5_UNORM_BLOCK: return Format::ASTC_5x5_UNORM_BLOCK;
-    //         case VK_FORMAT_ASTC_5x5_SRGB_BLOCK: return Format::ASTC_5x5_SRGB_BLOCK;
-    //         case VK_FORMAT_ASTC_6x5_UNORM_BLOCK: return Format::ASTC_6x5_UNORM_BLOCK;
-    //         case VK_FORMAT_ASTC_6x5_SRGB_BLOCK: return Format::ASTC_6x5_SRGB_BLOCK;
-    //         case VK_FORMAT_ASTC_6x6_UNORM_BLOCK: return Format::ASTC_6x6_UNORM_BLOCK;
-    //         case VK_FORMAT_ASTC_6x6_SRGB_BLOCK: return Format::ASTC_6x6_SRGB_BLOCK;
-    //         case VK_FORMAT_ASTC_8x5_UNORM_BLOCK: return Format::ASTC_8x5_UNORM_BLOCK;
-    //         case VK_FORMAT_ASTC_8x5_SRGB_BLOCK: return Format::ASTC_8x5_SRGB_BLOCK;
-    //         case VK_FORMAT_ASTC_8x6_UNORM_BLOCK: return Format::ASTC_8x6_UNORM_BLOCK;
-    //         case VK_FORMAT_ASTC_8x6_SRGB_BLOCK: return Format::ASTC_8x6_SRGB_BLOCK;
-    //         case VK_FORMAT_ASTC_8x8_UNORM_BLOCK: return Format::ASTC_8x8_UNORM_BLOCK;
-    //         case VK_FORMAT_ASTC_8x8_SRGB_BLOCK: return Format::ASTC_8x8_SRGB_BLOCK;
-    //         case VK_FORMAT_ASTC_10x5_UNORM_BLOCK: return Format::ASTC_10x5_UNORM_BLOCK;
-    //         case VK_FORMAT_ASTC_10x5_SRGB_BLOCK: return Format::ASTC_10x5_SRGB_BLOCK;
-    //         case VK_FORMAT_ASTC_10x6_UNORM_BLOCK: return Format::ASTC_10x6_UNORM_BLOCK;
-    //         case VK_FORMAT_ASTC_10x6_SRGB_BLOCK: return Format::ASTC_10x6_SRGB_BLOCK;
-    //         case VK_FORMAT_ASTC_10x8_UNORM_BLOCK: return Format::ASTC_10x8_UNORM_BLOCK;
-    //         case VK_FORMAT_ASTC_10x8_SRGB_BLOCK: return Format::ASTC_10x8_SRGB_BLOCK;
-    //         case VK_FORMAT_ASTC_10x10_UNORM_BLOCK: return Format::ASTC_10x10_UNORM_BLOCK;
-    //         case VK_FORMAT_ASTC_10x10_SRGB_BLOCK: return Format::ASTC_10x10_SRGB_BLOCK;
-    //         case VK_FORMAT_ASTC_12x10_UNORM_BLOCK: return Format::ASTC_12x10_UNORM_BLOCK;
-    //         case VK_FORMAT_ASTC_12x10_SRGB_BLOCK: return Format::ASTC_12x10_SRGB_BLOCK;
-    //         case VK_FORMAT_ASTC_12x12_UNORM_BLOCK: return Format::ASTC_12x12_UNORM_BLOCK;
-    //         case VK_FORMAT_ASTC_12x12_SRGB_BLOCK: return Format::ASTC_12x12_SRGB_BLOCK;
-    //         default: MFA_ASSERT(false); return Format::INVALID;
-    //     }
-    // }
-    //
-    // KTX_error_code WorstMipmapLoadHandler(
-    //     int mipLevel,
-    //     int face,
-    //     int width,
-    //     int height,
-    //     int depth,
-    //     ktx_uint64_t faceLodSize,
-    //     void* pixels,
-    //     void* userData
-    // )
-    // {
-    //     // TODO: Multiple face is not supported yet.
-    //     auto * texture = (AS::Texture *)userData;
-    //     texture->SetMipmapDimension(mipLevel, AS::Texture::Dimensions{
-    //         .width = static_cast<uint32_t>(width),
-    //         .height = static_cast<uint32_t>(height),
-    //         .depth = (uint16_t)depth
-    //     });
-    //     texture->SetMipmapSize(mipLevel, faceLodSize);
-    //     auto blob = Memory::AllocSize(faceLodSize);
-    //     std::memcpy(blob->Ptr(), pixels, blob->Len());
-    //     texture->SetMipmapData(mipLevel, std::move(blob));
-    //
-    //     return KTX_SUCCESS;
-    // }
-    //
-    // std::shared_ptr<Asset::Texture> LoadKtxMetadata(char const *path)
-    // {
-    //     MFA_ASSERT(std::filesystem::exists(path));
-    //
-    //     ktxTexture* ktx;
-    //
-    //     FILE* fp = fopen(path, "rb");
-    //     MFA_ASSERT(fp != nullptr);
-    //     auto result = ktxTexture_CreateFromStdioStream(fp, KTX_TEXTURE_CREATE_NO_FLAGS, &ktx);
-    //     // auto result = ktxTexture_CreateFromNamedFile(path, KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &ktx);
-    //
-    //     MFA_DEFFER([&ktx]()->void
-    //     {
-    //         ktxTexture_Destroy(ktx);
-    //     });
-    //
-    //     if (result != KTX_SUCCESS)
-    //     {
-    //         MFA_LOG_WARN(
-    //             "Failed to load ktx file with name: %s\n Reason: %s\n"
-    //             , path
-    //             , ktxErrorString(result)
-    //         );
-    //         return nullptr;
-    //     }
-    //
-    //     if (ktx->classId != ktxTexture2_c)
-    //     {
-    //         MFA_LOG_WARN("Only level 2 ktx is supported");
-    //         return nullptr;
-    //     }
-    //
-    //     ktxTexture2* ktx2;
-    //     if (ktx->classId == ktxTexture2_c) {
-    //         ktx2 = (ktxTexture2*)ktx;
-    //         // iF TEXTURE NEEDS TRANSCODING THE WE HAVE TO LOAD THE WHOLE THING
-    //         if (ktxTexture2_NeedsTranscoding(ktx2)) {
-    //             MFA_ASSERT(false);
-    //             KTX_error_code transcodeResult = ktxTexture2_TranscodeBasis(ktx2, KTX_TTF_RGBA32, 0);
-    //             if (transcodeResult != KTX_SUCCESS) {
-    //                 MFA_LOG_WARN("Transcoding failed: %s\n", ktxErrorString(transcodeResult));
-    //                 return nullptr;
-    //             }
-    //         }
-    //     }
-    //     else
-    //     {
-    //         MFA_LOG_WARN("Failed to load %s because only ktx2 is supported", path);
-    //         return nullptr;
-    //     }
-    //
-    //     auto vkFormat = ktx2->vkFormat;
-    //     auto const format = MapVkFormat(vkFormat);
-    //
-    //     auto const texture = std::make_shared<AS::Texture>(path, format, ktx->numFaces, ktx->numLayers, ktx->numLevels);
-    //
-    //     ktxTexture_IterateLoadLevelFaces(ktx, WorstMipmapLoadHandler, texture.get());
-    //
-    //     return texture;
-    // }
+    std::shared_ptr<AS::Texture> KtxImage(std::string const& path, uint8_t const largestMipLevel)
+    {
+        auto const reader = AS::KTX::Reader::Open(path);
+        if (reader == nullptr)
+        {
+            return nullptr;
+        }
+        return reader->CreateTexture(largestMipLevel);
+    }
 
     //-------------------------------------------------------------------------------------------------
 
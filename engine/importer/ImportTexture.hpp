@@ -8,12 +8,39 @@
 namespace MFA::Importer
 {
 
+    enum class ImageCompression : uint8_t
+    {
+        None,
+        BC1,                                // Rgb or rgb with 1 bit alpha, 4 bits per pixel
+        BC4,                                // Red channel only, 4 bits per pixel
+        BC5,                                // Red and green channels, 8 bits per pixel. Meant for normal maps
+        BC7                                 // Rgb or rgba, 8 bits per pixel
+    };
+
+    struct ImageImportParams
+    {
+        bool generateMipmaps = true;
+        // Color data like albedo. Mipmaps are filtered in linear space and the texture is sampled as sRGB.
+        // Ignored by BC4 and BC5 because they have no sRGB format.
+        bool sRGB = true;
+        ImageCompression compression = ImageCompression::BC7;
+        // Bakes the result next to the source file, So the next import skips filtering and compression
+        bool useCache = true;
+    };
+
     [[nodiscard]]
     std::shared_ptr<Asset::Texture> UncompressedImage(std::string const& path);
 
+    // Builds the mipmap chain and block compresses every level on the job system
+    [[nodiscard]]
+    std::shared_ptr<Asset::Texture> CompressedImage(std::string const& path, ImageImportParams const& params = {});
+
     [[nodiscard]]
     std::shared_ptr<Asset::Texture> ErrorTexture();
 
-    // std::shared_ptr<Asset::Texture> LoadKtxMetadata(char const * path);
+    // Reads a ktx2 file. Levels larger than largestMipLevel only get their dimensions and size,
+    // Use AS::KTX::Reader to stream them in later.
+    [[nodiscard]]
+    std::shared_ptr<Asset::Texture> KtxImage(std::string const& path, uint8_t largestMipLevel = 0);
 
 }
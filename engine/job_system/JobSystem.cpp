@@ -1,13 +1,22 @@
 #include "JobSystem.hpp"
 
+#include "ThreadUtils.hpp"
+
 //----------------------------------------------------------------------------------------------------------------------
 
 std::shared_ptr<MFA::JobSystem> MFA::JobSystem::Instantiate()
+{
+    return Instantiate(InitParams{});
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::shared_ptr<MFA::JobSystem> MFA::JobSystem::Instantiate(InitParams const & params)
 {
     std::shared_ptr<MFA::JobSystem> shared_ptr = _instance.lock();
     if (shared_ptr == nullptr)
     {
-        shared_ptr = std::make_shared<MFA::JobSystem>();
+        shared_ptr = std::make_shared<MFA::JobSystem>(params);
         _instance = shared_ptr;
     }
     return shared_ptr;
@@ -26,7 +35,69 @@ bool MFA::JobSystem::HasInstance() { return !_instance.expired(); }
 
 //----------------------------------------------------------------------------------------------------------------------
 
-MFA::JobSystem::JobSystem() = default;
+MFA::JobSystem::JobSystem(InitParams const & params)
+    : threadPool(ComputePoolParams(params))
+{
+    if (params.ioThreadCount > 0)
+    {
+        ioThreadPool = std::make_unique<ThreadPool>(IOPoolParams(params));
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 MFA::JobSystem::~JobSystem() = default;
 
+//----------------------------------------------------------------------------------------------------------------------
+
+MFA::ThreadPool::Params MFA::JobSystem::ComputePoolParams(InitParams const & params)
+{
+    std::vector<int> cores{};
+    if (params.numaNode >= 0)
+    {
+        cores = ThreadUtils::NumaNodeCores(params.numaNode);
+    }
+    else
+    {
+        for (int core = 0; core < ThreadUtils::HardwareThreadCount(); ++core)
+        {
+            cores.emplace_back(core);
+        }
+    }
+
+    int const coreCount = static_cast<int>(cores.size());
+    int const reservedCount = std::max(params.reservedThreadCount, 0) + std::max(params.ioThreadCount, 0);
+
+    ThreadPool::Params poolParams{};
+    poolParams.name = "Compute";
+    poolParams.threadCount = params.threadCount > 0
+        ? params.threadCount
+        : std::max(coreCount - reservedCount, 1);
+
+    if (params.pinThreads == true)
+    {
+        // Reserved threads keep the first cores
+        int const skipCount = coreCount > reservedCount ? reservedCount : 0;
+        poolParams.cores.assign(cores.begin() + skipCount, cores.end());
+        poolParams.pinEachThread = true;
+    }
+    else if (params.numaNode >= 0)
+    {
+        poolParams.cores = std::move(cores);
+        poolParams.pinEachThread = false;
+    }
+    return poolParams;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+MFA::ThreadPool::Params MFA::JobSystem::IOPoolParams(InitParams const & params)
+{
+    ThreadPool::Params poolParams{};
+    poolParams.name = "IO";
+    poolParams.threadCount = std::max(params.ioThreadCount, 1);
+    poolParams.lowPriority = true;
+    return poolParams;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "ThreadPool.hpp"
+#include "BedrockDeffer.hpp"
 
+#include <algorithm>
+#include <exception>
 #include <future>
 
 namespace MFA
@@ -10,13 +13,31 @@ namespace MFA
     {
     public:
 
+        struct InitParams
+        {
+            // Compute threads, 0 means every hardware thread that is not reserved
+            int threadCount = 0;
+            // Hardware threads that are left for the main thread and the other engine threads
+            int reservedThreadCount = 1;
+            // Blocking work (File reads for example) goes to these low priority threads so it never occupies
+            // the compute threads. 0 routes io tasks to the compute threads.
+            int ioThreadCount = 1;
+            // Pins each compute thread to its own core, The first reserved cores are skipped
+            bool pinThreads = false;
+            // Keeps the compute threads on the cores of this numa node, -1 means any node
+            int numaNode = -1;
+        };
+
         static std::shared_ptr<JobSystem> Instantiate();
 
+        // Params are ignored if there is an instance already
+        static std::shared_ptr<JobSystem> Instantiate(InitParams const & params);
+
         static void Destroy();
 
         [[nodiscard]] static bool HasInstance();
 
-        explicit JobSystem();
+        explicit JobSystem(InitParams const & params);
 
         ~JobSystem();
 
@@ -29,41 +50,194 @@ namespace MFA
                 MFA_LOG_WARN("Failed to execute task");
                 return {};
             }
+            return assignTask(instance->threadPool, std::move(task));
+        }
 
-            struct Params
+        template <typename T>
+        static std::future<T> AssignTask(std::function<T()> task)
+        {
+            auto instance = _instance.lock();
+            if (instance == nullptr)
             {
-                std::promise<void> promise{};
-            };
-            auto params = std::make_shared<Params>();
+                MFA_LOG_WARN("Failed to execute task");
+                return {};
+            }
+            return assignTask<T>(instance->threadPool, std::move(task));
+        }
 
-            instance->threadPool.AssignTask(
-            [task, params]()
+        // For blocking tasks like file reads
+        static std::future<void> AssignIOTask(std::function<void()> task)
+        {
+            auto instance = _instance.lock();
+            if (instance == nullptr)
             {
-                task();
-                params->promise.set_value();
-            });
-            return params->promise.get_future();
+                MFA_LOG_WARN("Failed to execute io task");
+                return {};
+            }
+            return assignTask(instance->ioPool(), std::move(task));
         }
 
         template <typename T>
-        static std::future<T> AssignTask(std::function<T()> task)
+        static std::future<T> AssignIOTask(std::function<T()> task)
         {
             auto instance = _instance.lock();
             if (instance == nullptr)
             {
-                MFA_LOG_WARN("Failed to execute task");
+                MFA_LOG_WARN("Failed to execute io task");
                 return {};
             }
+            return assignTask<T>(instance->ioPool(), std::move(task));
+        }
 
-            std::promise<T> promise{};
-            struct Params
+        // Fire and forget, No promise or shared state is allocated. Runs on the calling thread if there is no instance.
+        static void Dispatch(ThreadPool::Task const & task)
+        {
+            auto instance = _instance.lock();
+            if (instance == nullptr)
             {
-                std::promise<T> promise{};
+                task();
+                return;
+            }
+            instance->threadPool.AssignTask(task);
+        }
+
+        // Runs one queued job on the calling thread, Returns false if there was nothing to run
+        static bool TryToRunPendingTask()
+        {
+            auto instance = _instance.lock();
+            return instance != nullptr && instance->threadPool.TryToRunPendingTask();
+        }
+
+        // The calling thread runs pending jobs until the predicate is satisfied instead of sleeping on a future.
+        template <typename Predicate>
+        static void WaitUntil(Predicate const & predicate)
+        {
+            auto instance = _instance.lock();
+            SpinBackoff backoff{};
+            while (predicate() == false)
+            {
+                if (instance != nullptr && instance->threadPool.TryToRunPendingTask() == true)
+                {
+                    backoff.Reset();
+                }
+                else
+                {
+                    backoff.Pause();
+                }
+            }
+        }
+
+        // Counter based fork/join: Increment the counter per job, Decrement it when the job is done.
+        static void Wait(std::atomic<int> const & counter)
+        {
+            WaitUntil([&counter]()->bool
+            {
+                return counter.load(std::memory_order_acquire) <= 0;
+            });
+        }
+
+        // Calls fn(start, end) for consecutive chunks of [0, count) with at most grainSize items each.
+        // Chunks are handed out dynamically to at most one helper job per thread, And the calling thread works on them
+        // too, So the cost is independent of the chunk count and nothing is allocated per chunk.
+        // Rethrows the first exception that fn has thrown on any of the threads.
+        template <typename Function>
+        static void ParallelFor(int const count, int const grainSize, Function const & fn)
+        {
+            if (count <= 0)
+            {
+                return;
+            }
+
+            int const grain = std::max(grainSize, 1);
+            int const chunkCount = (count + grain - 1) / grain;
+
+            auto instance = _instance.lock();
+            int const helperCount = instance != nullptr
+                ? std::min(instance->threadPool.NumberOfAvailableThreads(), chunkCount - 1)
+                : 0;
+            if (helperCount <= 0)
+            {
+                fn(0, count);
+                return;
+            }
+
+            struct State
+            {
+                std::atomic<int> nextChunk{0};
+                std::atomic<int> activeHelpers{0};
+                int count;
+                int grain;
+                int chunkCount;
+                Function const * fn;
+                std::atomic<bool> exceptionLock{false};
+                std::exception_ptr exception{};
+
+                // Never throws, The first exception is kept for the calling thread and the remaining chunks are skipped
+                void RunChunks()
+                {
+                    try
+                    {
+                        while (true)
+                        {
+                            int const chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+                            if (chunk >= chunkCount)
+                            {
+                                break;
+                            }
+                            int const start = chunk * grain;
+                            (*fn)(start, std::min(start + grain, count));
+                        }
+                    }
+                    catch (...)
+                    {
+                        nextChunk.store(chunkCount, std::memory_order_relaxed);
+                        MFA_SCOPE_LOCK(exceptionLock)
+                        if (exception == nullptr)
+                        {
+                            exception = std::current_exception();
+                        }
+                    }
+                }
             };
-            auto params = std::make_shared<Params>();
 
-            instance->threadPool.AssignTask([task, params]() { params->promise.set_value(task()); });
-            return params->promise.get_future();
+            State state{};
+            state.count = count;
+            state.grain = grain;
+            state.chunkCount = chunkCount;
+            state.fn = &fn;
+            state.activeHelpers = helperCount;
+
+            // The capture is a single pointer so it fits in the std::function small buffer
+            State * statePtr = &state;
+            for (int i = 0; i < helperCount; ++i)
+            {
+                instance->threadPool.AssignTask([statePtr]()->void
+                {
+                    MFA_DEFFER([statePtr]()->void
+                    {
+                        statePtr->activeHelpers.fetch_sub(1, std::memory_order_release);
+                    });
+                    statePtr->RunChunks();
+                });
+            }
+
+            // Helpers still reference the state on our stack, So we cannot leave before all of them are done.
+            // (Even when fn throws on this thread)
+            state.RunChunks();
+            Wait(state.activeHelpers);
+
+            if (state.exception != nullptr)
+            {
+                std::rethrow_exception(state.exception);
+            }
+        }
+
+        // Returns 0 if there is no instance
+        [[nodiscard]]
+        static int AvailableThreadCount()
+        {
+            auto instance = _instance.lock();
+            return instance != nullptr ? instance->threadPool.NumberOfAvailableThreads() : 0;
         }
 
         [[nodiscard]]
@@ -72,6 +246,24 @@ namespace MFA
             return threadPool.NumberOfAvailableThreads();
         }
 
+        [[nodiscard]]
+        ThreadPool::Stats GetStats() const
+        {
+            return threadPool.GetStats();
+        }
+
+        [[nodiscard]]
+        ThreadPool::Stats GetIOStats() const
+        {
+            return ioThreadPool != nullptr ? ioThreadPool->GetStats() : ThreadPool::Stats{};
+        }
+
+        [[nodiscard]]
+        auto NumberOfIOThreads() const
+        {
+            return ioThreadPool != nullptr ? ioThreadPool->NumberOfAvailableThreads() : 0;
+        }
+
         [[nodiscard]]
         auto IsMainThread() const
         {
@@ -82,11 +274,53 @@ namespace MFA
 
     private:
 
+        static std::future<void> assignTask(ThreadPool & pool, std::function<void()> task)
+        {
+            struct Params
+            {
+                std::promise<void> promise{};
+            };
+            auto params = std::make_shared<Params>();
+
+            pool.AssignTask(
+            [task, params]()
+            {
+                task();
+                params->promise.set_value();
+            });
+            return params->promise.get_future();
+        }
+
+        template <typename T>
+        static std::future<T> assignTask(ThreadPool & pool, std::function<T()> task)
+        {
+            struct Params
+            {
+                std::promise<T> promise{};
+            };
+            auto params = std::make_shared<Params>();
+
+            pool.AssignTask([task, params]() { params->promise.set_value(task()); });
+            return params->promise.get_future();
+        }
+
+        [[nodiscard]]
+        ThreadPool & ioPool()
+        {
+            return ioThreadPool != nullptr ? *ioThreadPool : threadPool;
+        }
+
+        [[nodiscard]]
+        static ThreadPool::Params ComputePoolParams(InitParams const & params);
+
+        [[nodiscard]]
+        static ThreadPool::Params IOPoolParams(InitParams const & params);
+
 		inline static std::weak_ptr<JobSystem> _instance {};
 
-        static constexpr int MaxThreadCount = 4;
-        static constexpr int MinThreadCount = 1;
-        ThreadPool threadPool{std::max(std::min(MaxThreadCount, (int)(std::thread::hardware_concurrency() * 0.5f)), MinThreadCount)};
+        ThreadPool threadPool;
+
+        std::unique_ptr<ThreadPool> ioThreadPool{};
 
     };
 } // namespace MFA
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "BedrockAssert.hpp"
+#include "ScopeLock.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace MFA
+{
+
+    // Bounded lock-free multi producer multi consumer ring queue (Dmitry Vyukov's design).
+    // Every cell carries a sequence number so producers and consumers only contend on a single atomic counter each.
+    // Cells and counters live on their own cache lines to avoid false sharing.
+    template <typename T>
+    class MPMCQueue
+    {
+    public:
+
+        explicit MPMCQueue(size_t const capacity = 1024)
+            : mMask(capacity - 1)
+            , mCells(std::make_unique<Cell[]>(capacity))
+        {
+            MFA_ASSERT(capacity >= 2 && (capacity & (capacity - 1)) == 0);
+            for (size_t i = 0; i < capacity; ++i)
+            {
+                mCells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MPMCQueue(MPMCQueue const &) noexcept = delete;
+        MPMCQueue(MPMCQueue &&) noexcept = delete;
+        MPMCQueue & operator = (MPMCQueue const &) noexcept = delete;
+        MPMCQueue & operator = (MPMCQueue &&) noexcept = delete;
+
+        // Returns false if the queue is full. The item is untouched in that case.
+        bool TryToPush(T && newData)
+        {
+            size_t position = mEnqueuePos.load(std::memory_order_relaxed);
+            Cell * cell = nullptr;
+            while (true)
+            {
+                cell = &mCells[position & mMask];
+                size_t const sequence = cell->sequence.load(std::memory_order_acquire);
+                auto const diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+                if (diff == 0)
+                {
+                    if (mEnqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    position = mEnqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+            cell->data = std::move(newData);
+            cell->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Blocks with backoff until there is room in the queue
+        void Push(T && newData)
+        {
+            SpinBackoff backoff{};
+            while (TryToPush(std::move(newData)) == false)
+            {
+                backoff.Pause();
+            }
+        }
+
+        // Returns false if the queue is empty
+        bool TryToPop(T & outData)
+        {
+            size_t position = mDequeuePos.load(std::memory_order_relaxed);
+            Cell * cell = nullptr;
+            while (true)
+            {
+                cell = &mCells[position & mMask];
+                size_t const sequence = cell->sequence.load(std::memory_order_acquire);
+                auto const diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+                if (diff == 0)
+                {
+                    if (mDequeuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    position = mDequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+            outData = std::move(cell->data);
+            // Releasing whatever the moved-from item still holds (Captured state of a std::function for example)
+            cell->data = T{};
+            cell->sequence.store(position + mMask + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Blocks with backoff until an item is available
+        void Pop(T & outData)
+        {
+            SpinBackoff backoff{};
+            while (TryToPop(outData) == false)
+            {
+                backoff.Pause();
+            }
+        }
+
+        void PopAll()
+        {
+            T data{};
+            while (TryToPop(data) == true);
+        }
+
+        // Approximate when called concurrently
+        [[nodiscard]]
+        size_t ItemCount() const
+        {
+            size_t const enqueuePos = mEnqueuePos.load(std::memory_order_relaxed);
+            size_t const dequeuePos = mDequeuePos.load(std::memory_order_relaxed);
+            return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+        }
+
+        [[nodiscard]]
+        bool IsEmpty() const
+        {
+            return ItemCount() == 0;
+        }
+
+        [[nodiscard]]
+        size_t Capacity() const
+        {
+            return mMask + 1;
+        }
+
+    private:
+
+        static constexpr size_t CacheLineSize = 64;
+
+        struct alignas(CacheLineSize) Cell
+        {
+            std::atomic<size_t> sequence{};
+            T data{};
+        };
+
+        size_t const mMask;
+        std::unique_ptr<Cell[]> mCells;
+
+        alignas(CacheLineSize) std::atomic<size_t> mEnqueuePos{0};
+        alignas(CacheLineSize) std::atomic<size_t> mDequeuePos{0};
+
+    };
+
+}
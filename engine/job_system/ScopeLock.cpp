@@ -4,6 +4,15 @@
 
 #include <thread>
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#define MFA_CPU_PAUSE()     _mm_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define MFA_CPU_PAUSE()     __asm__ __volatile__("yield")
+#else
+#define MFA_CPU_PAUSE()
+#endif
+
 namespace MFA
 {
 
@@ -24,6 +33,7 @@ namespace MFA
 
     void Lock(std::atomic<bool> &lock)
     {
+        SpinBackoff backoff{};
         while (true)
         {
             bool expectedValue = false;
@@ -32,7 +42,7 @@ namespace MFA
             {
                 break;
             }
-            std::this_thread::yield();
+            backoff.Pause();
         }
         MFA_ASSERT(lock == true);
     }
@@ -47,20 +57,42 @@ namespace MFA
 
     //==================================================================================================================
 
-    ScopeLock::ScopeLock(std::atomic<bool> & lock)
-        : mLock(lock)
+    void SpinBackoff::Pause()
     {
-        while (true)
+        if (mSpinCount <= MaxSpinCount)
         {
-            bool expectedValue = false;
-            bool const desiredValue = true;
-            if (mLock.compare_exchange_strong(expectedValue, desiredValue) == true)
+            for (int i = 0; i < mSpinCount; ++i)
             {
-                break;
+                MFA_CPU_PAUSE();
             }
+            mSpinCount *= 2;
+        }
+        else
+        {
             std::this_thread::yield();
         }
-        MFA_ASSERT(mLock == true);
+    }
+
+    //==================================================================================================================
+
+    void SpinBackoff::Reset()
+    {
+        mSpinCount = 1;
+    }
+
+    //==================================================================================================================
+
+    bool SpinBackoff::IsYielding() const
+    {
+        return mSpinCount > MaxSpinCount;
+    }
+
+    //==================================================================================================================
+
+    ScopeLock::ScopeLock(std::atomic<bool> & lock)
+        : mLock(lock)
+    {
+        Lock(mLock);
     }
 
     ScopeLock::~ScopeLock()
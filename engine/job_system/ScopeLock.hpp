@@ -12,6 +12,27 @@ namespace MFA {
 
     void Unlock(std::atomic<bool>& lock);
 
+    // Exponential backoff for spin loops. Starts with cpu pause instructions and falls back to yielding the thread
+    // once the wait gets long, So contended spinners stop burning the cores that the lock owner needs.
+    class SpinBackoff
+    {
+    public:
+
+        void Pause();
+
+        void Reset();
+
+        [[nodiscard]]
+        bool IsYielding() const;
+
+    private:
+
+        static constexpr int MaxSpinCount = 64;
+
+        int mSpinCount = 1;
+
+    };
+
     class ScopeLock
     {
     public:
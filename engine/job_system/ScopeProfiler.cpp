@@ -2,22 +2,384 @@
 
 #include "BedrockAssert.hpp"
 #include "BedrockLog.hpp"
+#include "ScopeLock.hpp"
 
-#include <thread>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace MFA {
 
-    ScopeProfiler::ScopeProfiler(std::string text)
-        : _text(std::move(text))
-        , _start(std::chrono::high_resolution_clock::now())
+    //-------------------------------------------------------------------------------------------------
+
+    namespace
+    {
+        static_assert((Profiler::EventCapacity & (Profiler::EventCapacity - 1)) == 0);
+
+        struct ThreadBuffer
+        {
+            int threadId = 0;
+            std::string threadName{};
+            std::unique_ptr<Profiler::Event[]> events = std::make_unique<Profiler::Event[]>(Profiler::EventCapacity);
+            uint64_t writeIdx = 0;
+            uint32_t depth = 0;                 // Owner thread only
+            // Only contended while a reader copies the events
+            std::atomic<bool> lock{false};
+        };
+
+        struct ProfilerState
+        {
+            std::chrono::steady_clock::time_point const epoch = std::chrono::steady_clock::now();
+            std::atomic<bool> isEnabled{true};
+
+            std::mutex registryMutex{};
+            std::vector<std::shared_ptr<ThreadBuffer>> threads{};
+            std::unordered_set<std::string> names{};
+
+            std::atomic<bool> frameLock{false};
+            std::array<Profiler::Frame, Profiler::FrameCapacity> frames{};
+            int64_t frameCount = 0;
+            int64_t frameBeginNs = -1;
+        };
+
+        ProfilerState & State()
+        {
+            static ProfilerState state{};
+            return state;
+        }
+
+        std::shared_ptr<ThreadBuffer> RegisterThread()
+        {
+            auto & state = State();
+            auto buffer = std::make_shared<ThreadBuffer>();
+            std::lock_guard lock{state.registryMutex};
+            buffer->threadId = static_cast<int>(state.threads.size());
+            buffer->threadName = "Thread" + std::to_string(buffer->threadId);
+            state.threads.emplace_back(buffer);
+            return buffer;
+        }
+
+        // The registry keeps the buffer alive after the thread is gone, So its events still show up in the trace
+        ThreadBuffer & CurrentThreadBuffer()
+        {
+            thread_local std::shared_ptr<ThreadBuffer> buffer = RegisterThread();
+            return *buffer;
+        }
+
+        void Record(ThreadBuffer & buffer, Profiler::Event const & event)
+        {
+            MFA_SCOPE_LOCK(buffer.lock)
+            buffer.events[buffer.writeIdx & (Profiler::EventCapacity - 1)] = event;
+            ++buffer.writeIdx;
+        }
+
+        void WriteJsonString(std::ofstream & file, char const * text)
+        {
+            file << '"';
+            for (char const * c = text; *c != '\0'; ++c)
+            {
+                switch (*c)
+                {
+                case '"':
+                    file << "\\\"";
+                    break;
+                case '\\':
+                    file << "\\\\";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(*c) < 0x20)
+                    {
+                        file << ' ';
+                    }
+                    else
+                    {
+                        file << *c;
+                    }
+                }
+            }
+            file << '"';
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void Profiler::BeginScope(char const * name)
+    {
+        auto const timeNs = NowNs();
+        auto & buffer = CurrentThreadBuffer();
+        Record(buffer, Event{
+            .name = name,
+            .timeNs = timeNs,
+            .depth = buffer.depth,
+            .type = EventType::Begin
+        });
+        ++buffer.depth;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void Profiler::EndScope()
+    {
+        auto const timeNs = NowNs();
+        auto & buffer = CurrentThreadBuffer();
+        MFA_ASSERT(buffer.depth > 0);
+        --buffer.depth;
+        Record(buffer, Event{
+            .name = nullptr,
+            .timeNs = timeNs,
+            .depth = buffer.depth,
+            .type = EventType::End
+        });
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void Profiler::MarkFrame()
+    {
+        auto const timeNs = NowNs();
+        auto & state = State();
+        MFA_SCOPE_LOCK(state.frameLock)
+        if (state.frameBeginNs >= 0)
+        {
+            state.frames[state.frameCount % FrameCapacity] = Frame{
+                .index = state.frameCount,
+                .beginNs = state.frameBeginNs,
+                .endNs = timeNs
+            };
+            ++state.frameCount;
+        }
+        state.frameBeginNs = timeNs;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    char const * Profiler::InternName(std::string const & name)
+    {
+        // Scopes with a dynamic name intern it every time, So the registry lock is only taken the first time a
+        // thread sees a name
+        thread_local std::unordered_map<std::string, char const *> threadNames{};
+        auto const findResult = threadNames.find(name);
+        if (findResult != threadNames.end())
+        {
+            return findResult->second;
+        }
+
+        char const * internedName = nullptr;
+        {
+            auto & state = State();
+            std::lock_guard lock{state.registryMutex};
+            // Nodes of an unordered_set never move, So the pointer stays valid
+            internedName = state.names.emplace(name).first->c_str();
+        }
+        threadNames.emplace(name, internedName);
+        return internedName;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void Profiler::SetThreadName(std::string const & name)
+    {
+        auto & buffer = CurrentThreadBuffer();
+        MFA_SCOPE_LOCK(buffer.lock)
+        buffer.threadName = name;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void Profiler::SetEnabled(bool const enabled)
+    {
+        State().isEnabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool Profiler::IsEnabled()
     {
-        
+        return State().isEnabled.load(std::memory_order_relaxed);
     }
 
+    //-------------------------------------------------------------------------------------------------
+
+    int64_t Profiler::NowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - State().epoch
+        ).count();
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::vector<Profiler::ThreadEvents> Profiler::CollectEvents(int64_t const beginNs, int64_t const endNs)
+    {
+        auto & state = State();
+        std::vector<std::shared_ptr<ThreadBuffer>> threads{};
+        {
+            std::lock_guard lock{state.registryMutex};
+            threads = state.threads;
+        }
+
+        std::vector<ThreadEvents> result{};
+        result.reserve(threads.size());
+        for (auto const & buffer : threads)
+        {
+            auto & threadEvents = result.emplace_back();
+
+            MFA_SCOPE_LOCK(buffer->lock)
+            threadEvents.threadId = buffer->threadId;
+            threadEvents.threadName = buffer->threadName;
+
+            // Events of a thread are in time order, So we walk back from the newest one and stop at beginNs
+            auto const oldestIdx = buffer->writeIdx > EventCapacity ? buffer->writeIdx - EventCapacity : 0;
+            for (auto idx = buffer->writeIdx; idx > oldestIdx; --idx)
+            {
+                auto const & event = buffer->events[(idx - 1) & (EventCapacity - 1)];
+                if (event.timeNs < beginNs)
+                {
+                    break;
+                }
+                if (event.timeNs <= endNs)
+                {
+                    threadEvents.events.emplace_back(event);
+                }
+            }
+            std::reverse(threadEvents.events.begin(), threadEvents.events.end());
+        }
+        return result;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::vector<Profiler::Frame> Profiler::CollectFrames()
+    {
+        auto & state = State();
+        MFA_SCOPE_LOCK(state.frameLock)
+        auto const count = std::min<int64_t>(state.frameCount, FrameCapacity);
+        std::vector<Frame> frames{};
+        frames.reserve(count);
+        for (auto index = state.frameCount - count; index < state.frameCount; ++index)
+        {
+            frames.emplace_back(state.frames[index % FrameCapacity]);
+        }
+        return frames;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool Profiler::ExportChromeTrace(std::string const & path)
+    {
+        auto const threads = CollectEvents();
+        auto const frames = CollectFrames();
+
+        std::ofstream file{path, std::ios::out | std::ios::trunc};
+        if (file.is_open() == false)
+        {
+            MFA_LOG_WARN("Failed to open %s for writing the trace", path.c_str());
+            return false;
+        }
+
+        file << std::fixed << std::setprecision(3);
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+        bool isFirst = true;
+        auto const beginEvent = [&file, &isFirst]()->void
+        {
+            file << (isFirst ? "\n" : ",\n");
+            isFirst = false;
+        };
+
+        size_t eventCount = 0;
+        for (auto const & thread : threads)
+        {
+            beginEvent();
+            file << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << thread.threadId << R"(,"args":{"name":)";
+            WriteJsonString(file, thread.threadName.c_str());
+            file << "}}";
+
+            // The ring may have dropped the begin of the oldest scopes, Their end events have nothing to close
+            uint32_t openScopes = 0;
+            for (auto const & event : thread.events)
+            {
+                if (event.type == EventType::End)
+                {
+                    if (openScopes == 0)
+                    {
+                        continue;
+                    }
+                    --openScopes;
+                    beginEvent();
+                    file << R"({"ph":"E","pid":1,"tid":)" << thread.threadId
+                        << R"(,"ts":)" << static_cast<double>(event.timeNs) / 1000.0 << "}";
+                }
+                else
+                {
+                    ++openScopes;
+                    beginEvent();
+                    file << R"({"name":)";
+                    WriteJsonString(file, event.name);
+                    file << R"(,"cat":"MFA","ph":"B","pid":1,"tid":)" << thread.threadId
+                        << R"(,"ts":)" << static_cast<double>(event.timeNs) / 1000.0 << "}";
+                }
+                ++eventCount;
+            }
+        }
+
+        for (auto const & frame : frames)
+        {
+            beginEvent();
+            file << R"({"name":"Frame )" << frame.index << R"(","ph":"i","s":"g","pid":1,"tid":0,"ts":)"
+                << static_cast<double>(frame.beginNs) / 1000.0 << "}";
+        }
+
+        file << "\n]}\n";
+        file.close();
+        if (file.fail() == true)
+        {
+            MFA_LOG_WARN("Failed to write the trace into %s", path.c_str());
+            return false;
+        }
+
+        MFA_LOG_INFO("Profiler: Exported %zu events and %zu frames to %s", eventCount, frames.size(), path.c_str());
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    ScopeProfiler::ScopeProfiler(char const * name)
+        : _isActive(Profiler::IsEnabled())
+    {
+        if (_isActive == true)
+        {
+            Profiler::BeginScope(name);
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    ScopeProfiler::ScopeProfiler(std::string const & name)
+        : _isActive(Profiler::IsEnabled())
+    {
+        if (_isActive == true)
+        {
+            Profiler::BeginScope(Profiler::InternName(name));
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
     ScopeProfiler::~ScopeProfiler()
     {
-        auto end = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> duration = end - _start;
-        MFA_LOG_INFO("Profiler: %s took %f seconds", _text.c_str(), duration.count());
+        if (_isActive == true)
+        {
+            Profiler::EndScope();
+        }
     }
+
+    //-------------------------------------------------------------------------------------------------
+
 }
@@ -5,12 +5,100 @@
 #include "BedrockPlatforms.hpp"
 
 #include <atomic>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
 
 namespace MFA {
+
+    // Records begin/end events into a ring buffer per thread. Recording only takes an uncontended spin lock, Readers
+    // (The profiler window and the trace exporter) copy the part of the rings that they need.
+    // Scopes are recorded only when the project is built with MFA_PROFILER_ENABLED, Otherwise the macros at the
+    // bottom of this file compile to nothing.
+    class Profiler
+    {
+    public:
+
+        enum class EventType : uint8_t
+        {
+            Begin,
+            End
+        };
+
+        struct Event
+        {
+            char const * name = nullptr;
+            int64_t timeNs = 0;
+            uint32_t depth = 0;
+            EventType type = EventType::Begin;
+        };
+
+        struct ThreadEvents
+        {
+            int threadId = 0;
+            std::string threadName{};
+            std::vector<Event> events{};         // Sorted by time
+        };
+
+        struct Frame
+        {
+            int64_t index = 0;
+            int64_t beginNs = 0;
+            int64_t endNs = 0;
+        };
+
+        // Per thread. The oldest events get overwritten when the ring is full.
+        static constexpr size_t EventCapacity = 1 << 16;
+
+        static constexpr size_t FrameCapacity = 256;
+
+        static void BeginScope(char const * name);
+
+        static void EndScope();
+
+        // Closes the current frame and starts the next one. Call it once per frame from the main loop.
+        static void MarkFrame();
+
+        // Returns a pointer that stays valid until the end of the program, Use it for names that are not literals.
+        // Names that this thread has interned before are found without taking the global lock.
+        [[nodiscard]]
+        static char const * InternName(std::string const & name);
+
+        static void SetThreadName(std::string const & name);
+
+        static void SetEnabled(bool enabled);
+
+        [[nodiscard]]
+        static bool IsEnabled();
+
+        // Nanoseconds since the profiler started
+        [[nodiscard]]
+        static int64_t NowNs();
+
+        // Events of every thread that happened in [beginNs, endNs]
+        [[nodiscard]]
+        static std::vector<ThreadEvents> CollectEvents(
+            int64_t beginNs = 0,
+            int64_t endNs = std::numeric_limits<int64_t>::max()
+        );
+
+        // Completed frames, Oldest first
+        [[nodiscard]]
+        static std::vector<Frame> CollectFrames();
+
+        // Writes every recorded event in Chrome trace event format (chrome://tracing, ui.perfetto.dev)
+        static bool ExportChromeTrace(std::string const & path);
+
+    };
+
     class ScopeProfiler
     {
     public:
-        explicit ScopeProfiler(std::string text);
+        // The name has to outlive the profiler (String literals or InternName results)
+        explicit ScopeProfiler(char const * name);
+        // For names that change between calls, Interns the name on every scope
+        explicit ScopeProfiler(std::string const & name);
         ~ScopeProfiler();
 
         ScopeProfiler(ScopeProfiler const &) noexcept = delete;
@@ -20,9 +108,20 @@ namespace MFA {
 
     private:
 
-        std::string const _text;
-        supportedClock::time_point _start{};
+        // The profiler can get disabled in the middle of a scope, We still have to close what we opened
+        bool const _isActive;
     };
 }
 
-#define MFA_SCOPE_Profiler(lock)        MFA::ScopeProfiler MFA_UNIQUE_NAME(__scopeProfiler) {lock};
+#ifdef MFA_PROFILER_ENABLED
+// The name is interned once per call site, So it has to be a string literal. Pasting it next to "" makes any other
+// name a compile error, Names that change between calls go to MFA::ScopeProfiler with a std::string instead.
+#define MFA_SCOPE_Profiler__IMPL(name, id)                                                              \
+static char const * const MFA_CONCAT(__profilerName, id) = MFA::Profiler::InternName("" name);          \
+MFA::ScopeProfiler MFA_CONCAT(__scopeProfiler, id) {MFA_CONCAT(__profilerName, id)};
+#define MFA_SCOPE_Profiler(name)        MFA_SCOPE_Profiler__IMPL(name, __COUNTER__)
+#define MFA_PROFILER_FRAME()            MFA::Profiler::MarkFrame();
+#else
+#define MFA_SCOPE_Profiler(name)
+#define MFA_PROFILER_FRAME()
+#endif
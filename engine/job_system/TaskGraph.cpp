@@ -0,0 +1,259 @@
+#include "TaskGraph.hpp"
+
+#include "BedrockAssert.hpp"
+#include "JobSystem.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace MFA
+{
+
+    //-------------------------------------------------------------------------------------------------
+
+    TaskGraph::TaskGraph() = default;
+
+    //-------------------------------------------------------------------------------------------------
+
+    TaskGraph::~TaskGraph()
+    {
+        MFA_ASSERT(_activeHelpers == 0);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    TaskGraph::NodeId TaskGraph::AddTask(Task task)
+    {
+        MFA_ASSERT(task != nullptr);
+        auto const nodeId = static_cast<NodeId>(_nodes.size());
+        auto & node = _nodes.emplace_back();
+        node.task = std::move(task);
+        return nodeId;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    TaskGraph::NodeId TaskGraph::AddTask(Task task, std::initializer_list<NodeId> dependencies)
+    {
+        auto const nodeId = AddTask(std::move(task));
+        for (auto const dependency : dependencies)
+        {
+            AddDependency(dependency, nodeId);
+        }
+        return nodeId;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TaskGraph::AddDependency(NodeId const before, NodeId const after)
+    {
+        MFA_ASSERT(before >= 0 && before < TaskCount());
+        MFA_ASSERT(after >= 0 && after < TaskCount());
+        MFA_ASSERT(before != after);
+        _nodes[before].successors.emplace_back(after);
+        _nodes[after].dependencyCount += 1;
+        _isValidated = false;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TaskGraph::Run()
+    {
+        if (_nodes.empty())
+        {
+            return;
+        }
+
+        prepare();
+
+        for (NodeId nodeId = 0; nodeId < TaskCount(); ++nodeId)
+        {
+            if (_nodes[nodeId].dependencyCount == 0)
+            {
+                _readyNodes->Push(NodeId{nodeId});
+            }
+        }
+        _maxHelpers = JobSystem::AvailableThreadCount();
+        auto const rootCount = static_cast<int>(_readyNodes->ItemCount());
+        for (int i = 0; i < rootCount - 1; ++i)
+        {
+            spawnHelper();
+        }
+
+        // Helpers reference this object, So we wait for them as well as for the tasks
+        SpinBackoff backoff{};
+        while (_remainingNodes.load(std::memory_order_acquire) > 0 || _activeHelpers.load(std::memory_order_acquire) > 0)
+        {
+            NodeId nodeId{};
+            if (_readyNodes->TryToPop(nodeId) == true)
+            {
+                execute(nodeId);
+                backoff.Reset();
+            }
+            else if (JobSystem::TryToRunPendingTask() == true)
+            {
+                backoff.Reset();
+            }
+            else
+            {
+                backoff.Pause();
+            }
+        }
+
+        if (_exception != nullptr)
+        {
+            std::exception_ptr exception = nullptr;
+            std::swap(exception, _exception);
+            std::rethrow_exception(exception);
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TaskGraph::Clear()
+    {
+        MFA_ASSERT(_activeHelpers == 0);
+        _nodes.clear();
+        _isValidated = false;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    int TaskGraph::TaskCount() const
+    {
+        return static_cast<int>(_nodes.size());
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TaskGraph::prepare()
+    {
+        auto const nodeCount = _nodes.size();
+
+        // A cycle among non-root nodes would never get ready and Run would wait for it forever
+        if (_isValidated == false)
+        {
+            if (isAcyclic() == false)
+            {
+                MFA_CRASH("TaskGraph has a dependency cycle");
+            }
+            _isValidated = true;
+        }
+
+        // Buffers are kept between runs, We only grow them
+        if (_pendingCapacity < nodeCount)
+        {
+            _pendingDependencies = std::make_unique<std::atomic<int>[]>(nodeCount);
+            _pendingCapacity = nodeCount;
+        }
+        auto const queueCapacity = std::bit_ceil(std::max<size_t>(nodeCount, 2));
+        if (_readyNodes == nullptr || _readyNodes->Capacity() < queueCapacity)
+        {
+            _readyNodes = std::make_unique<MPMCQueue<NodeId>>(queueCapacity);
+        }
+
+        for (size_t i = 0; i < nodeCount; ++i)
+        {
+            _pendingDependencies[i].store(_nodes[i].dependencyCount, std::memory_order_relaxed);
+        }
+        _remainingNodes.store(static_cast<int>(nodeCount), std::memory_order_release);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Kahn's algorithm: Every node of an acyclic graph is visited once all of its dependencies are removed
+    bool TaskGraph::isAcyclic() const
+    {
+        std::vector<int> dependencyCounts(_nodes.size());
+        std::vector<NodeId> readyNodes{};
+        readyNodes.reserve(_nodes.size());
+        for (NodeId nodeId = 0; nodeId < TaskCount(); ++nodeId)
+        {
+            dependencyCounts[nodeId] = _nodes[nodeId].dependencyCount;
+            if (dependencyCounts[nodeId] == 0)
+            {
+                readyNodes.emplace_back(nodeId);
+            }
+        }
+
+        int visitedCount = 0;
+        while (readyNodes.empty() == false)
+        {
+            NodeId const nodeId = readyNodes.back();
+            readyNodes.pop_back();
+            ++visitedCount;
+            for (auto const successor : _nodes[nodeId].successors)
+            {
+                if (--dependencyCounts[successor] == 0)
+                {
+                    readyNodes.emplace_back(successor);
+                }
+            }
+        }
+        return visitedCount == TaskCount();
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TaskGraph::execute(NodeId const nodeId)
+    {
+        auto const & node = _nodes[nodeId];
+        try
+        {
+            node.task();
+        }
+        catch (...)
+        {
+            MFA_SCOPE_LOCK(_exceptionLock)
+            if (_exception == nullptr)
+            {
+                _exception = std::current_exception();
+            }
+        }
+
+        for (auto const successor : node.successors)
+        {
+            if (_pendingDependencies[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                _readyNodes->Push(NodeId{successor});
+                spawnHelper();
+            }
+        }
+
+        _remainingNodes.fetch_sub(1, std::memory_order_release);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TaskGraph::spawnHelper()
+    {
+        int activeHelpers = _activeHelpers.load(std::memory_order_relaxed);
+        while (activeHelpers < _maxHelpers)
+        {
+            if (_activeHelpers.compare_exchange_weak(activeHelpers, activeHelpers + 1, std::memory_order_acq_rel))
+            {
+                JobSystem::Dispatch([this]()->void
+                {
+                    helperLoop();
+                });
+                return;
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TaskGraph::helperLoop()
+    {
+        NodeId nodeId{};
+        while (_readyNodes->TryToPop(nodeId) == true)
+        {
+            execute(nodeId);
+        }
+        // Last access to this object, A node that gets ready after this point is picked up by the thread in Run
+        _activeHelpers.fetch_sub(1, std::memory_order_release);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "MPMCQueue.hpp"
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+namespace MFA
+{
+
+    // Tasks with dependencies that run over the JobSystem. Build the graph once and Run it as many times as needed,
+    // Running does not allocate per task. A task becomes ready when all of its dependencies are done.
+    class TaskGraph
+    {
+    public:
+
+        using Task = std::function<void()>;
+        using NodeId = int;
+
+        explicit TaskGraph();
+
+        ~TaskGraph();
+
+        TaskGraph(TaskGraph const &) noexcept = delete;
+        TaskGraph(TaskGraph &&) noexcept = delete;
+        TaskGraph & operator = (TaskGraph const &) noexcept = delete;
+        TaskGraph & operator = (TaskGraph &&) noexcept = delete;
+
+        NodeId AddTask(Task task);
+
+        NodeId AddTask(Task task, std::initializer_list<NodeId> dependencies);
+
+        // "after" is not going to start before "before" is done
+        void AddDependency(NodeId before, NodeId after);
+
+        // Blocks until every task is done. The calling thread executes tasks as well.
+        // Rethrows the first exception that a task has thrown. Throws before running anything if the graph has a cycle.
+        void Run();
+
+        void Clear();
+
+        [[nodiscard]]
+        int TaskCount() const;
+
+    private:
+
+        struct Node
+        {
+            Task task{};
+            std::vector<NodeId> successors{};
+            int dependencyCount = 0;
+        };
+
+        void prepare();
+
+        [[nodiscard]]
+        bool isAcyclic() const;
+
+        void execute(NodeId nodeId);
+
+        void spawnHelper();
+
+        void helperLoop();
+
+        std::vector<Node> _nodes{};
+        // Cycle check only runs again after the graph has changed
+        bool _isValidated = false;
+
+        std::unique_ptr<std::atomic<int>[]> _pendingDependencies{};
+        size_t _pendingCapacity = 0;
+
+        std::unique_ptr<MPMCQueue<NodeId>> _readyNodes{};
+
+        std::atomic<int> _remainingNodes{0};
+        std::atomic<int> _activeHelpers{0};
+        int _maxHelpers = 0;
+
+        std::atomic<bool> _exceptionLock{false};
+        std::exception_ptr _exception{};
+
+    };
+
+}
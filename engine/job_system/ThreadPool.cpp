@@ -1,17 +1,30 @@
 #include "ThreadPool.hpp"
 
+#include "ScopeProfiler.hpp"
+#include "ThreadUtils.hpp"
+
 namespace MFA
 {
 
     //-------------------------------------------------------------------------------------------------
 
-    ThreadPool::ThreadPool(int threadCount)
+    ThreadPool::ThreadPool(int const threadCount)
+        : ThreadPool(Params{.threadCount = threadCount})
+    {}
+
+    //-------------------------------------------------------------------------------------------------
+
+    ThreadPool::ThreadPool(Params params)
+        : mParams(std::move(params))
     {
         mMainThreadId = std::this_thread::get_id();
-        // mNumberOfThreads = std::max(std::min(4, (int)(std::thread::hardware_concurrency() * 0.5f)), 1);
-        mNumberOfThreads = threadCount;// std::max((int)(std::thread::hardware_concurrency() * 0.5f), 1);
-        // mNumberOfThreads = 1;
-        MFA_LOG_INFO("Job system is running on %d threads. Available threads are: %d", mNumberOfThreads, static_cast<int>(std::thread::hardware_concurrency()));
+        mNumberOfThreads = std::max(mParams.threadCount, 1);
+        MFA_LOG_INFO(
+            "%s pool is running on %d threads. Available threads are: %d",
+            mParams.name.c_str(),
+            mNumberOfThreads,
+            ThreadUtils::HardwareThreadCount()
+        );
 
         mIsAlive = true;
 
@@ -19,6 +32,11 @@ namespace MFA
         {
             mThreadObjects.emplace_back(std::make_unique<ThreadObject>(threadIndex, *this));
         }
+        // Workers look into each other's deques, So none of them can start before the list is complete
+        for (auto const & thread : mThreadObjects)
+        {
+            thread->Start();
+        }
     }
 
     //-------------------------------------------------------------------------------------------------
@@ -41,15 +59,24 @@ namespace MFA
     {
         MFA_ASSERT(task != nullptr);
 
-        if (mIsAlive == true)
+        if (mIsAlive == false)
         {
-            mThreadObjects[mNextTaskIdx]->AssignTask(task);
-            mNextTaskIdx = (mNextTaskIdx + 1) % mThreadObjects.size();
+            task();
+            return;
         }
-        else
+
+        auto * threadObject = currentThreadObject();
+        if (threadObject == nullptr)
         {
+            mSharedTasks.Push(Task(task));
+        }
+        else if (threadObject->PushLocalTask(task) == false && mSharedTasks.TryToPush(Task(task)) == false)
+        {
+            // Every queue is full, Running the task here is better than blocking a worker on the other workers
             task();
+            return;
         }
+        notifyIdleThread();
     }
 
     //-------------------------------------------------------------------------------------------------
@@ -61,12 +88,13 @@ namespace MFA
 
     //-------------------------------------------------------------------------------------------------
 
-    void ThreadPool::CancelTasks() const
+    void ThreadPool::CancelTasks()
     {
         for (auto const &thread : mThreadObjects)
         {
             thread->CancelTasks();
         }
+        mSharedTasks.PopAll();
     }
 
     //-------------------------------------------------------------------------------------------------
@@ -76,12 +104,64 @@ namespace MFA
         mIsAlive = false;
         for (auto const & thread : mThreadObjects)
         {
-            thread->Notify();
+            thread->wake();
         }
         for (auto const & thread : mThreadObjects)
         {
             thread->Join();
         }
+        CancelTasks();
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    ThreadPool::ThreadObject * ThreadPool::currentThreadObject() const
+    {
+        if (CurrentThreadObject != nullptr && &CurrentThreadObject->mParent == this)
+        {
+            return CurrentThreadObject;
+        }
+        return nullptr;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool ThreadPool::hasSharedTask()
+    {
+        if (mSharedTasks.IsEmpty() == false)
+        {
+            return true;
+        }
+        for (auto const & thread : mThreadObjects)
+        {
+            if (thread->HasStealableTask() == true)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void ThreadPool::notifyIdleThread()
+    {
+        // Pairs with the fence in ThreadObject::park. Either the parking thread sees the new task or we see it parked.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (mParkedThreadCount.load(std::memory_order_seq_cst) == 0)
+        {
+            return;
+        }
+        // Busy and spinning threads will pick up the task on their own, So we only wake a parked one.
+        auto const threadCount = static_cast<uint32_t>(mThreadObjects.size());
+        uint32_t const startIdx = mNextTaskIdx.fetch_add(1, std::memory_order_relaxed);
+        for (uint32_t i = 0; i < threadCount; ++i)
+        {
+            if (mThreadObjects[(startIdx + i) % threadCount]->Unpark() == true)
+            {
+                return;
+            }
+        }
     }
 
     //-------------------------------------------------------------------------------------------------
@@ -89,8 +169,15 @@ namespace MFA
     ThreadPool::ThreadObject::ThreadObject(int const threadNumber, ThreadPool & parent)
         :
         mParent(parent),
-        mThreadNumber(threadNumber)
+        mThreadNumber(threadNumber),
+        mRandomState(static_cast<uint32_t>(threadNumber) * 2654435761u + 1u)
+    {}
+
+    //-------------------------------------------------------------------------------------------------
+
+    void ThreadPool::ThreadObject::Start()
     {
+        MFA_ASSERT(mThread == nullptr);
         mThread = std::make_unique<std::thread>([this]()-> void
         {
             mainLoop();
@@ -106,9 +193,11 @@ namespace MFA
 
     //-------------------------------------------------------------------------------------------------
 
-    bool ThreadPool::ThreadObject::AwakeCondition(int idx)
+    bool ThreadPool::ThreadObject::HasPendingWork()
     {
-        return mTasks.IsEmpty() == false || mParent.mIsAlive == false;
+        return mTasks.IsEmpty() == false ||
+            mLocalTasks.IsEmpty() == false ||
+            mParent.hasSharedTask() == true;
     }
 
     //-------------------------------------------------------------------------------------------------
@@ -116,7 +205,59 @@ namespace MFA
     void ThreadPool::ThreadObject::AssignTask(Task const &task)
     {
         mTasks.Push(task);
-        Notify();
+        // Pinned tasks can only run on this thread, So it has to be this one that wakes up
+        Unpark();
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool ThreadPool::ThreadObject::PushLocalTask(Task const & task)
+    {
+        // A full deque also ends up here, Every position that is still in it keeps its slot used
+        auto & slot = mTaskSlots[mLocalTasks.NextPushIndex() & (LocalTaskCapacity - 1)];
+        if (slot.isUsed.load(std::memory_order_acquire) == true)
+        {
+            return false;
+        }
+        slot.task = task;
+        slot.isUsed.store(true, std::memory_order_relaxed);
+        if (mLocalTasks.Push(&slot) == false)
+        {
+            slot.task = nullptr;
+            slot.isUsed.store(false, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool ThreadPool::ThreadObject::StealTask(Task & outTask)
+    {
+        TaskSlot * slot = nullptr;
+        if (mLocalTasks.Steal(slot) == false)
+        {
+            return false;
+        }
+        takeTask(*slot, outTask);
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void ThreadPool::ThreadObject::takeTask(TaskSlot & slot, Task & outTask)
+    {
+        outTask = std::move(slot.task);
+        slot.task = nullptr;
+        // Pairs with the acquire in PushLocalTask, The owner may only fill the slot again after the move
+        slot.isUsed.store(false, std::memory_order_release);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool ThreadPool::ThreadObject::HasStealableTask() const
+    {
+        return mLocalTasks.IsEmpty() == false;
     }
 
     //-------------------------------------------------------------------------------------------------
@@ -124,13 +265,19 @@ namespace MFA
     void ThreadPool::ThreadObject::CancelTasks()
     {
         mTasks.PopAll();
+        // Steal can fail spuriously when it races with the owner, So we keep trying until the deque is drained.
+        while (mLocalTasks.IsEmpty() == false)
+        {
+            Task task;
+            StealTask(task);
+        }
     }
 
     //-------------------------------------------------------------------------------------------------
 
     void ThreadPool::ThreadObject::Join() const
     {
-        if (mThread->joinable())
+        if (mThread != nullptr && mThread->joinable())
         {
             mThread->join();
         }
@@ -138,21 +285,32 @@ namespace MFA
 
     //-------------------------------------------------------------------------------------------------
 
-    bool ThreadPool::ThreadObject::IsFree()
+    bool ThreadPool::ThreadObject::IsFree() const
+    {
+        return mIsBusy == false;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool ThreadPool::ThreadObject::Unpark()
     {
-        auto const isFree = mIsBusy == false;
-        if (isFree == false)
+        std::lock_guard<std::mutex> lock{mParkMutex};
+        if (mIsParked == false || mWakeRequested == true)
         {
-            mCondition.notify_one();
+            return false;
         }
-        return isFree;
+        mWakeRequested = true;
+        mParkCondition.notify_one();
+        return true;
     }
 
     //-------------------------------------------------------------------------------------------------
 
-    void ThreadPool::ThreadObject::Notify()
+    void ThreadPool::ThreadObject::wake()
     {
-        mCondition.notify_one();
+        std::lock_guard<std::mutex> lock{mParkMutex};
+        mWakeRequested = true;
+        mParkCondition.notify_one();
     }
 
     //-------------------------------------------------------------------------------------------------
@@ -166,40 +324,239 @@ namespace MFA
 
     void ThreadPool::ThreadObject::mainLoop()
     {
-        std::mutex mutex{};
-        std::unique_lock<std::mutex> mLock{ mutex };
-        while (mParent.mIsAlive)
+        CurrentThreadObject = this;
+
+        auto const & params = mParent.mParams;
+        auto const threadName = params.name + std::to_string(mThreadNumber);
+        ThreadUtils::SetCurrentThreadName(threadName);
+        Profiler::SetThreadName(threadName);
+        if (params.cores.empty() == false)
         {
-            mCondition.wait(mLock, [this]()->bool
-                {
-                    return AwakeCondition(mThreadNumber);
-                }
-            );
-            mIsBusy = true;
-            while (mParent.mIsAlive == true)
+            auto const cores = params.pinEachThread == true
+                ? std::vector<int>{params.cores[mThreadNumber % params.cores.size()]}
+                : params.cores;
+            if (ThreadUtils::SetCurrentThreadAffinity(cores) == false)
             {
-                Task currentTask;
-                bool isEmpty = false;
+                MFA_LOG_WARN("Failed to set the affinity of %s thread %d", params.name.c_str(), mThreadNumber);
+            }
+        }
+        if (params.lowPriority == true && ThreadUtils::SetCurrentThreadLowPriority() == false)
+        {
+            MFA_LOG_WARN("Failed to lower the priority of %s thread %d", params.name.c_str(), mThreadNumber);
+        }
 
-                while (mTasks.TryToPop(currentTask, isEmpty) == false && isEmpty == false);
-                if (isEmpty == true)
-                {
-	                break;
-                }
-                try
-                {
-                    if (currentTask != nullptr)
-                    {
-                        currentTask();
-                    }
-                }
-                catch (std::exception const & exception)
+        while (mParent.mIsAlive == true)
+        {
+            Task currentTask;
+            if (findTask(currentTask) == true || spinForTask(currentTask) == true)
+            {
+                mIsBusy = true;
+                mParent.executeTask(currentTask);
+                mExecutedTasks.store(mExecutedTasks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                continue;
+            }
+            mIsBusy = false;
+            park();
+        }
+        mIsBusy = false;
+
+        CurrentThreadObject = nullptr;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool ThreadPool::ThreadObject::spinForTask(Task & outTask)
+    {
+        for (int i = 0; i < mSpinLimit && mParent.mIsAlive == true; ++i)
+        {
+            SpinBackoff backoff{};
+            // A few pause instructions between the attempts, Never yielding
+            while (backoff.IsYielding() == false)
+            {
+                backoff.Pause();
+            }
+            mSpins.store(mSpins.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+            if (findTask(outTask) == true)
+            {
+                // Spinning paid off, Spinning for longer next time
+                mSpinLimit = std::min(mSpinLimit * 2, MaxSpinCount);
+                return true;
+            }
+        }
+        mSpinLimit = std::max(mSpinLimit / 2, MinSpinCount);
+        return false;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void ThreadPool::ThreadObject::park()
+    {
+        std::unique_lock<std::mutex> lock{mParkMutex};
+        mIsParked = true;
+        mParent.mParkedThreadCount.fetch_add(1, std::memory_order_seq_cst);
+        // Pairs with the fence in ThreadPool::notifyIdleThread
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        // A task could have arrived while we were registering, Its producer may have seen us as awake
+        if (mWakeRequested == false && mParent.mIsAlive == true && HasPendingWork() == false)
+        {
+            mParks.store(mParks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            mParkCondition.wait(lock, [this]()->bool
+            {
+                return mWakeRequested == true || mParent.mIsAlive == false;
+            });
+            mWakeups.store(mWakeups.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        mWakeRequested = false;
+        mIsParked = false;
+        mParent.mParkedThreadCount.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool ThreadPool::ThreadObject::findTask(Task & outTask)
+    {
+        // Pinned tasks first since no one else can run them
+        bool isEmpty = false;
+        while (mTasks.TryToPop(outTask, isEmpty) == false && isEmpty == false);
+        if (isEmpty == false)
+        {
+            return true;
+        }
+
+        TaskSlot * localTask = nullptr;
+        if (mLocalTasks.Pop(localTask) == true)
+        {
+            takeTask(*localTask, outTask);
+            return true;
+        }
+
+        if (mParent.mSharedTasks.TryToPop(outTask) == true)
+        {
+            return true;
+        }
+
+        return stealFromOthers(outTask);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool ThreadPool::ThreadObject::stealFromOthers(Task & outTask)
+    {
+        // Xorshift, We only need the victims to be spread out
+        mRandomState ^= mRandomState << 13;
+        mRandomState ^= mRandomState >> 17;
+        mRandomState ^= mRandomState << 5;
+        if (mParent.stealTask(outTask, this, mRandomState) == true)
+        {
+            mSteals.store(mSteals.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool ThreadPool::stealTask(Task & outTask, ThreadObject const * thief, uint32_t const randomValue) const
+    {
+        auto const threadCount = static_cast<uint32_t>(mThreadObjects.size());
+        for (uint32_t i = 0; i < threadCount; ++i)
+        {
+            auto & victim = mThreadObjects[(randomValue + i) % threadCount];
+            if (victim.get() == thief)
+            {
+                continue;
+            }
+            // A failed steal can be a lost race, So we retry while the victim still has something
+            while (victim->HasStealableTask() == true)
+            {
+                if (victim->StealTask(outTask) == true)
                 {
-                    while (mParent.mExceptions.TryToPush(exception.what()) == false);
+                    return true;
                 }
             }
-            mIsBusy = false;
         }
+        return false;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void ThreadPool::executeTask(Task const & task)
+    {
+        try
+        {
+            if (task != nullptr)
+            {
+                task();
+            }
+        }
+        catch (std::exception const & exception)
+        {
+            if (mExceptions.TryToPush(exception.what()) == false)
+            {
+                MFA_LOG_ERROR("Exception queue is full, Dropping: %s", exception.what());
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool ThreadPool::TryToRunPendingTask()
+    {
+        if (mIsAlive == false)
+        {
+            return false;
+        }
+
+        Task task;
+        auto * threadObject = currentThreadObject();
+        if (threadObject != nullptr)
+        {
+            if (threadObject->findTask(task) == false)
+            {
+                return false;
+            }
+        }
+        else if (mSharedTasks.TryToPop(task) == false)
+        {
+            if (stealTask(task, nullptr, mNextTaskIdx.fetch_add(1, std::memory_order_relaxed)) == false)
+            {
+                return false;
+            }
+            mHelperSteals.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        executeTask(task);
+        if (threadObject == nullptr)
+        {
+            mHelpedTasks.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            auto & executedTasks = threadObject->mExecutedTasks;
+            executedTasks.store(executedTasks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    ThreadPool::Stats ThreadPool::GetStats() const
+    {
+        Stats stats{};
+        for (auto const & thread : mThreadObjects)
+        {
+            stats.executedTasks += thread->mExecutedTasks.load(std::memory_order_relaxed);
+            stats.steals += thread->mSteals.load(std::memory_order_relaxed);
+            stats.spins += thread->mSpins.load(std::memory_order_relaxed);
+            stats.parks += thread->mParks.load(std::memory_order_relaxed);
+            stats.wakeups += thread->mWakeups.load(std::memory_order_relaxed);
+        }
+        stats.helpedTasks = mHelpedTasks.load(std::memory_order_relaxed);
+        stats.steals += mHelperSteals.load(std::memory_order_relaxed);
+        return stats;
     }
 
     //-------------------------------------------------------------------------------------------------
@@ -222,21 +579,10 @@ namespace MFA
     {
         std::vector<std::string> exceptions{};
 
-        while (true)
+        std::string exception;
+        while (mExceptions.TryToPop(exception) == true)
         {
-            std::string exception;
-            bool isEmpty = false;
-            if (mExceptions.TryToPop(exception, isEmpty))
-            {
-                if (isEmpty == false)
-                {
-                    exceptions.emplace_back(exception);
-                }
-                else
-                {
-	                break;
-                }
-            }
+            exceptions.emplace_back(std::move(exception));
         }
         return exceptions;
     }
@@ -1,11 +1,14 @@
 #pragma once
 
+#include "MPMCQueue.hpp"
 #include "ThreadSafeQueue.hpp"
+#include "WorkStealingQueue.hpp"
 
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
+#include <string>
 #include <vector>
 
 namespace MFA
@@ -17,8 +20,36 @@ namespace MFA
 
         using Task = std::function<void()>;
         
+        struct Params
+        {
+            int threadCount = 1;
+            // Empty means that the os decides
+            std::vector<int> cores{};
+            // Pins thread i to cores[i % cores.size()] instead of letting it run on any of the cores
+            bool pinEachThread = true;
+            bool lowPriority = false;
+            // Used for logs and thread names
+            std::string name = "Compute";
+        };
+
+        // Counters for profiling, They only grow
+        struct Stats
+        {
+            uint64_t executedTasks = 0;
+            // Tasks that were executed by threads outside of the pool while they were waiting
+            uint64_t helpedTasks = 0;
+            uint64_t steals = 0;
+            // Rounds that idle workers spent looking for a task before going to sleep
+            uint64_t spins = 0;
+            uint64_t parks = 0;
+            uint64_t wakeups = 0;
+        };
+
+        // Tasks that are assigned from a worker thread go to the worker's own deque, Tasks from other threads go to
+        // the shared queue. Idle workers steal from the busy ones so a single slow task cannot stall the others.
+        explicit ThreadPool(Params params);
+
         explicit ThreadPool(int threadCount);
-        // We can have a threadPool with custom number of threads
 
         ~ThreadPool();
 
@@ -32,14 +63,22 @@ namespace MFA
 
         void AssignTask(Task const & task);
 
+        // Pinned tasks are never stolen by other threads
         void AssignTask(int threadIdx, Task const & task) const;
 
-        void CancelTasks() const;
+        void CancelTasks();
+
+        // Runs one queued task on the calling thread. Used by threads that wait on other jobs so they help instead of
+        // blocking. Returns false if there was nothing to run.
+        bool TryToRunPendingTask();
 
         void Terminate();
 
         [[nodiscard]]
         int NumberOfAvailableThreads() const;
+
+        [[nodiscard]]
+        Stats GetStats() const;
         
         class ThreadObject
         {
@@ -54,38 +93,100 @@ namespace MFA
             ThreadObject & operator = (ThreadObject const &) noexcept = delete;
             ThreadObject & operator = (ThreadObject &&) noexcept = delete;
 
+            void Start();
+
             void Join() const;
 
             [[nodiscard]]
-            bool IsFree();
+            bool IsFree() const;
 
-            void Notify();
+            // Wakes the thread if it is parked, Returns false if it was not parked or someone else woke it already
+            bool Unpark();
 
             [[nodiscard]]
             int GetThreadNumber() const;
 
-            bool AwakeCondition(int idx);
+            [[nodiscard]]
+            bool HasPendingWork();
 
             void AssignTask(Task const & task);
 
+            // Returns false if the deque is full or the slot of the next position is still being emptied by a thief
+            bool PushLocalTask(Task const & task);
+
+            bool StealTask(Task & outTask);
+
+            [[nodiscard]]
+            bool HasStealableTask() const;
+
             void CancelTasks();
 
         private:
 
+            friend class ThreadPool;
+
             void mainLoop();
-            
+
+            bool findTask(Task & outTask);
+
+            bool stealFromOthers(Task & outTask);
+
+            // Bounded spin before parking, The bound adapts to how often spinning pays off
+            bool spinForTask(Task & outTask);
+
+            void park();
+
+            void wake();
+
             ThreadPool & mParent;
 
             int mThreadNumber;
 
-            std::condition_variable mCondition;
+            std::mutex mParkMutex;
+
+            std::condition_variable mParkCondition;
+
+            // Both are guarded by mParkMutex
+            bool mIsParked = false;
+            bool mWakeRequested = false;
+
+            static constexpr int MinSpinCount = 16;
+            static constexpr int MaxSpinCount = 1024;
+            int mSpinLimit = MinSpinCount * 4;
 
             std::unique_ptr<std::thread> mThread;
 
             std::atomic<bool> mIsBusy = false;
 
+            // Only the owner thread writes to these
+            std::atomic<uint64_t> mExecutedTasks{0};
+            std::atomic<uint64_t> mSteals{0};
+            std::atomic<uint64_t> mSpins{0};
+            std::atomic<uint64_t> mParks{0};
+            std::atomic<uint64_t> mWakeups{0};
+
             ThreadSafeQueue<Task> mTasks{};
 
+            struct TaskSlot
+            {
+                Task task{};
+                // Set by the owner when it fills the slot, Cleared by the thread that took the task once it moved out
+                std::atomic<bool> isUsed = false;
+            };
+
+            // Moves the task out of the slot and hands the slot back to the owner
+            static void takeTask(TaskSlot & slot, Task & outTask);
+
+            static constexpr int64_t LocalTaskCapacity = 4096;
+
+            // Slot i holds the task of every deque position p where p % LocalTaskCapacity == i, So pushing a task
+            // never allocates
+            std::unique_ptr<TaskSlot[]> mTaskSlots = std::make_unique<TaskSlot[]>(LocalTaskCapacity);
+
+            WorkStealingQueue<TaskSlot *> mLocalTasks{LocalTaskCapacity};
+
+            uint32_t mRandomState = 0;
+
         };
 
         bool AllThreadsAreIdle() const;
@@ -93,19 +194,44 @@ namespace MFA
         std::vector<std::string> Exceptions();
 
     private:
-        
+
+        [[nodiscard]]
+        ThreadObject * currentThreadObject() const;
+
+        [[nodiscard]]
+        bool hasSharedTask();
+
+        void notifyIdleThread();
+
+        bool stealTask(Task & outTask, ThreadObject const * thief, uint32_t randomValue) const;
+
+        void executeTask(Task const & task);
+
+        Params const mParams;
+
         std::vector<std::unique_ptr<ThreadObject>> mThreadObjects;
 
-        bool mIsAlive = true;
+        std::atomic<bool> mIsAlive = true;
+
+        static constexpr size_t SharedTaskCapacity = 1 << 14;
+        MPMCQueue<Task> mSharedTasks{SharedTaskCapacity};
 
         int mNumberOfThreads = 0;
 
-        ThreadSafeQueue<std::string> mExceptions{};
+        static constexpr size_t ExceptionCapacity = 64;
+        MPMCQueue<std::string> mExceptions{ExceptionCapacity};
+
+        std::atomic<uint32_t> mNextTaskIdx {};
 
-        int mNextTaskIdx {};
+        std::atomic<int> mParkedThreadCount {0};
+
+        std::atomic<uint64_t> mHelpedTasks {0};
+        std::atomic<uint64_t> mHelperSteals {0};
 
         std::thread::id mMainThreadId{};
 
+        static inline thread_local ThreadObject * CurrentThreadObject = nullptr;
+
     };
 
 }
@@ -19,14 +19,16 @@ public:
         }
 
         MFA_ASSERT(mLock == true);
-        mData.push(newData);
+        mData.push(std::move(newData));
         mLock = false;
         return true;
     }
 
     void Push(T newData)
     {
-        while (TryToPush(newData) == false);
+        Lock(mLock);
+        mData.push(std::move(newData));
+        Unlock(mLock);
     }
 
     // Returns front item
@@ -44,7 +46,7 @@ public:
         bool success = true;
         if (mData.empty() == false) 
         {
-            outData = mData.front();
+            outData = std::move(mData.front());
             isEmpty = false;
             mData.pop();
         }
@@ -55,7 +57,11 @@ public:
 
     void Pop(T & outData, bool& isEmpty)
     {
-        while (TryToPop(outData, isEmpty) == false);
+        SpinBackoff backoff{};
+        while (TryToPop(outData, isEmpty) == false)
+        {
+            backoff.Pause();
+        }
     }
 
     [[nodiscard]]
@@ -65,29 +71,19 @@ public:
 
         bool isEmpty;
         T outData;
-        while (TryToPop(outData, isEmpty) == false);
+        Pop(outData, isEmpty);
 
         return outData;
     }
 
     void PopAll()
     {
-        bool expectedValue = false;
-        bool const desiredValue = true;
-
-        while(true)
-        {
-            if (mLock.compare_exchange_strong(expectedValue, desiredValue) == false) {
-                continue;
-            }
-            break;
-        }
-
+        Lock(mLock);
         while (mData.empty() == false)
         {
             mData.pop();
         }
-        mLock = false;
+        Unlock(mLock);
     }
 
     [[nodiscard]]
@@ -0,0 +1,161 @@
+#include "ThreadUtils.hpp"
+
+#include "BedrockLog.hpp"
+#include "BedrockPlatforms.hpp"
+#include "BedrockString.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#if defined(__PLATFORM_WIN__)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__PLATFORM_LINUX__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(__PLATFORM_MAC__)
+#include <pthread.h>
+#endif
+
+namespace MFA::ThreadUtils
+{
+
+    //-------------------------------------------------------------------------------------------------
+
+    int HardwareThreadCount()
+    {
+        return std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    int NumaNodeCount()
+    {
+#if defined(__PLATFORM_LINUX__)
+        int count = 0;
+        while (std::filesystem::exists("/sys/devices/system/node/node" + std::to_string(count)))
+        {
+            ++count;
+        }
+        return std::max(count, 1);
+#else
+        return 1;
+#endif
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::vector<int> NumaNodeCores(int const numaNode)
+    {
+        std::vector<int> cores{};
+#if defined(__PLATFORM_LINUX__)
+        // Format is a comma separated list of ranges. For example: 0-7,16-23
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(numaNode) + "/cpulist");
+        std::string cpuList{};
+        if (file.good() && std::getline(file, cpuList))
+        {
+            for (auto const & range : String::Split(cpuList, ","))
+            {
+                if (range.empty())
+                {
+                    continue;
+                }
+                auto const bounds = String::Split(range, "-");
+                int const first = std::stoi(bounds[0]);
+                int const last = bounds.size() > 1 ? std::stoi(bounds[1]) : first;
+                for (int core = first; core <= last; ++core)
+                {
+                    cores.emplace_back(core);
+                }
+            }
+        }
+        if (cores.empty() == false)
+        {
+            return cores;
+        }
+        MFA_LOG_WARN("Failed to read the cores of numa node %d, Using every core instead", numaNode);
+#endif
+        int const threadCount = HardwareThreadCount();
+        for (int core = 0; core < threadCount; ++core)
+        {
+            cores.emplace_back(core);
+        }
+        return cores;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool SetCurrentThreadAffinity(std::vector<int> const & cores)
+    {
+        if (cores.empty())
+        {
+            return false;
+        }
+#if defined(__PLATFORM_WIN__)
+        DWORD_PTR mask = 0;
+        for (auto const core : cores)
+        {
+            if (core < static_cast<int>(sizeof(DWORD_PTR) * 8))
+            {
+                mask |= DWORD_PTR{1} << core;
+            }
+        }
+        return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(__PLATFORM_LINUX__)
+        cpu_set_t cpuSet{};
+        CPU_ZERO(&cpuSet);
+        for (auto const core : cores)
+        {
+            if (core >= 0 && core < CPU_SETSIZE)
+            {
+                CPU_SET(core, &cpuSet);
+            }
+        }
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) == 0;
+#else
+        // Mac only supports affinity hints through thread_policy_set which the scheduler is free to ignore
+        return false;
+#endif
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool SetCurrentThreadLowPriority()
+    {
+#if defined(__PLATFORM_WIN__)
+        return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL) != 0;
+#elif defined(__PLATFORM_LINUX__)
+        // On linux the nice value is per thread when it is set through the thread id
+        auto const threadId = static_cast<id_t>(syscall(SYS_gettid));
+        return setpriority(PRIO_PROCESS, threadId, 10) == 0;
+#elif defined(__PLATFORM_MAC__)
+        return pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0) == 0;
+#else
+        return false;
+#endif
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void SetCurrentThreadName(std::string const & name)
+    {
+#if defined(__PLATFORM_LINUX__)
+        // Linux limit is 16 characters including the null terminator
+        pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#elif defined(__PLATFORM_MAC__)
+        pthread_setname_np(name.c_str());
+#else
+        (void)name;
+#endif
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
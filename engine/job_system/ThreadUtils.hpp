@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace MFA::ThreadUtils
+{
+
+    // Returns at least 1 even if the platform cannot tell
+    [[nodiscard]]
+    int HardwareThreadCount();
+
+    [[nodiscard]]
+    int NumaNodeCount();
+
+    // Logical cores that belong to the numa node. Returns every core on platforms without numa information.
+    [[nodiscard]]
+    std::vector<int> NumaNodeCores(int numaNode);
+
+    // Pins the calling thread to the given logical cores, Returns false if the platform does not support it
+    bool SetCurrentThreadAffinity(std::vector<int> const & cores);
+
+    // Used for io threads so they do not compete with the main and compute threads
+    bool SetCurrentThreadLowPriority();
+
+    // Shows up in debuggers and profilers. Long names are truncated on linux.
+    void SetCurrentThreadName(std::string const & name);
+
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "BedrockAssert.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace MFA
+{
+
+    // Bounded Chase-Lev deque (Le, Pop, Cohen, Zappa Nardelli 2013).
+    // Only the owner thread may call Push and Pop, any thread may call Steal.
+    // T has to be trivially copyable (We store task pointers in it).
+    template <typename T>
+    class WorkStealingQueue
+    {
+    public:
+
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        explicit WorkStealingQueue(int64_t const capacity = 4096)
+            : mCapacity(capacity)
+            , mMask(capacity - 1)
+            , mBuffer(std::make_unique<std::atomic<T>[]>(capacity))
+        {
+            MFA_ASSERT(capacity > 0 && (capacity & (capacity - 1)) == 0);
+        }
+
+        WorkStealingQueue(WorkStealingQueue const &) noexcept = delete;
+        WorkStealingQueue(WorkStealingQueue &&) noexcept = delete;
+        WorkStealingQueue & operator = (WorkStealingQueue const &) noexcept = delete;
+        WorkStealingQueue & operator = (WorkStealingQueue &&) noexcept = delete;
+
+        // Owner only. Returns false when the deque is full.
+        bool Push(T const item)
+        {
+            int64_t const bottom = mBottom.load(std::memory_order_relaxed);
+            int64_t const top = mTop.load(std::memory_order_acquire);
+            if (bottom - top >= mCapacity)
+            {
+                return false;
+            }
+            mBuffer[bottom & mMask].store(item, std::memory_order_relaxed);
+            mBottom.store(bottom + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Owner only. Takes from the bottom (LIFO) to keep the cache warm.
+        bool Pop(T & outItem)
+        {
+            int64_t const bottom = mBottom.load(std::memory_order_relaxed) - 1;
+            mBottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = mTop.load(std::memory_order_relaxed);
+
+            if (top > bottom)
+            {
+                mBottom.store(bottom + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            outItem = mBuffer[bottom & mMask].load(std::memory_order_relaxed);
+            if (top != bottom)
+            {
+                return true;
+            }
+
+            // Last item, We have to race with the thieves for it
+            bool const success = mTop.compare_exchange_strong(
+                top,
+                top + 1,
+                std::memory_order_seq_cst,
+                std::memory_order_relaxed
+            );
+            mBottom.store(bottom + 1, std::memory_order_relaxed);
+            return success;
+        }
+
+        // Any thread. Takes from the top (FIFO). A false result does not mean the deque is empty, It can also mean
+        // that we lost the race with another thief or the owner.
+        bool Steal(T & outItem)
+        {
+            int64_t top = mTop.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t const bottom = mBottom.load(std::memory_order_acquire);
+
+            if (top >= bottom)
+            {
+                return false;
+            }
+
+            T const item = mBuffer[top & mMask].load(std::memory_order_relaxed);
+            if (mTop.compare_exchange_strong(
+                top,
+                top + 1,
+                std::memory_order_seq_cst,
+                std::memory_order_relaxed
+            ) == false)
+            {
+                return false;
+            }
+            outItem = item;
+            return true;
+        }
+
+        // Owner only. Position that the next Push stores its item at, Lets the owner keep what the items point to in
+        // a ring of its own
+        [[nodiscard]]
+        int64_t NextPushIndex() const
+        {
+            return mBottom.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]]
+        bool IsEmpty() const
+        {
+            return ItemCount() == 0;
+        }
+
+        // Approximate when called concurrently
+        [[nodiscard]]
+        size_t ItemCount() const
+        {
+            int64_t const bottom = mBottom.load(std::memory_order_relaxed);
+            int64_t const top = mTop.load(std::memory_order_relaxed);
+            return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+        }
+
+    private:
+
+        int64_t const mCapacity;
+        int64_t const mMask;
+
+        alignas(64) std::atomic<int64_t> mTop{0};
+        alignas(64) std::atomic<int64_t> mBottom{0};
+
+        std::unique_ptr<std::atomic<T>[]> mBuffer;
+
+    };
+
+}
@@ -54,6 +54,7 @@ namespace MFA
         mDirtyCounter = (int)mBufferGroup->buffers.size();
         MFA_ASSERT(data.Len() <= mData->Len());
         std::memcpy(mData->Ptr(), data.Ptr(), data.Len());
+        mDataSize = data.Len();
     }
 
     //-----------------------------------------------------------------------------------------------
@@ -96,16 +97,21 @@ namespace MFA
     {
         if (mDirtyCounter > 0)
         {
-            RB::UpdateHostVisibleBuffer(
-                LogicalDevice::GetVkDevice(),
-                *mHostVisibleBuffer->buffers[recordState.frameIndex % mHostVisibleBuffer->buffers.size()],
-                Alias(mData->Ptr(), mData->Len())
-            );
-            RB::UpdateLocalBuffer(
-                recordState.commandBuffer,
-                *mLocalBuffer->buffers[recordState.frameIndex % mLocalBuffer->buffers.size()],
-                *mHostVisibleBuffer->buffers[recordState.frameIndex % mHostVisibleBuffer->buffers.size()]
-            );
+            // A zero sized copy is not valid, So there is nothing to record when no data is set
+            if (mDataSize > 0)
+            {
+                RB::UpdateHostVisibleBuffer(
+                    LogicalDevice::GetVkDevice(),
+                    *mHostVisibleBuffer->buffers[recordState.frameIndex % mHostVisibleBuffer->buffers.size()],
+                    Alias(mData->Ptr(), mDataSize)
+                );
+                RB::UpdateLocalBuffer(
+                    recordState.commandBuffer,
+                    *mLocalBuffer->buffers[recordState.frameIndex % mLocalBuffer->buffers.size()],
+                    *mHostVisibleBuffer->buffers[recordState.frameIndex % mHostVisibleBuffer->buffers.size()],
+                    static_cast<VkDeviceSize>(mDataSize)
+                );
+            }
             --mDirtyCounter;
         }
     }
@@ -117,6 +123,7 @@ namespace MFA
         mDirtyCounter = (int)mLocalBuffer->buffers.size();
         MFA_ASSERT(data.Len() <= mData->Len());
         std::memcpy(mData->Ptr(), data.Ptr(), data.Len());
+        mDataSize = data.Len();
     }
 
     //-----------------------------------------------------------------------------------------------
@@ -125,6 +132,7 @@ namespace MFA
     {
         // Returns the data and resets the counter.
         mDirtyCounter = (int)LogicalDevice::GetMaxFramePerFlight();
+        mDataSize = mData->Len();
         return mData->Ptr();
     }
 
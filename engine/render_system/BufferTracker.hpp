@@ -15,8 +15,10 @@ namespace MFA
 
         void Update(RT::CommandRecordState const & recordState);
 
+        // Only the bytes of data are uploaded until the next call to SetData or Data
         void SetData(Alias const & data);
 
+        // The whole buffer is uploaded since the caller can write to any part of it
         [[nodiscard]]
         uint8_t * Data();
 
@@ -27,6 +29,8 @@ namespace MFA
         std::shared_ptr<RT::BufferGroup> mBufferGroup;
         int mDirtyCounter = 0;
         std::unique_ptr<Blob> mData {};
+        // Bytes from the start of mData that Update copies to the gpu
+        size_t mDataSize = 0;
     };
 
     // Only use it for the data that is frequently updated
@@ -47,8 +51,10 @@ namespace MFA
 
         void Update(RT::CommandRecordState const & recordState);
 
+        // Only the bytes of data are uploaded until the next call to SetData or Data
         void SetData(Alias const & data);
 
+        // The whole buffer is uploaded since the caller can write to any part of it
         [[nodiscard]]
         uint8_t * Data();
 
@@ -64,5 +70,7 @@ namespace MFA
         std::shared_ptr<RT::BufferGroup> mHostVisibleBuffer{};
         int mDirtyCounter = 0;
         std::unique_ptr<Blob> mData {};
+        // Bytes from the start of mData that Update copies to the gpu
+        size_t mDataSize = 0;
     };
 }
\ No newline at end of file
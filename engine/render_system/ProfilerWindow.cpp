@@ -0,0 +1,220 @@
+#include "ProfilerWindow.hpp"
+
+#include "implot.h"
+
+#include <cstring>
+
+namespace MFA
+{
+
+    //-------------------------------------------------------------------------------------------------
+
+    ProfilerWindow::ProfilerWindow(std::shared_ptr<UI> ui, std::string tracePath)
+        : _ui(std::move(ui))
+        , _tracePath(std::move(tracePath))
+    {
+        MFA_ASSERT(_ui != nullptr);
+        _updateSignalId = _ui->UpdateSignal.Register([this]()->void{ Display(); });
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    ProfilerWindow::~ProfilerWindow()
+    {
+        _ui->UpdateSignal.UnRegister(_updateSignalId);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void ProfilerWindow::Display()
+    {
+        if (_isPaused == false)
+        {
+            CaptureLastFrame();
+        }
+
+        _ui->BeginWindow("Profiler");
+
+#ifndef MFA_PROFILER_ENABLED
+        ImGui::TextDisabled("Scopes are not recorded, Build with MFA_PROFILER to enable them");
+#endif
+
+        bool isEnabled = Profiler::IsEnabled();
+        if (ImGui::Checkbox("Record", &isEnabled))
+        {
+            Profiler::SetEnabled(isEnabled);
+        }
+        ImGui::SameLine();
+        ImGui::Checkbox("Pause", &_isPaused);
+        ImGui::SameLine();
+        if (ImGui::Button("Export trace"))
+        {
+            Profiler::ExportChromeTrace(_tracePath);
+        }
+
+        if (_frameTimesMs.empty() == false)
+        {
+            float sumMs = 0.0f;
+            float maxMs = 0.0f;
+            for (auto const frameTimeMs : _frameTimesMs)
+            {
+                sumMs += frameTimeMs;
+                maxMs = std::max(maxMs, frameTimeMs);
+            }
+            ImGui::Text(
+                "Frame %lld: %.3f ms, Average: %.3f ms, Max: %.3f ms",
+                static_cast<long long>(_capturedFrame.index),
+                _frameTimesMs.back(),
+                sumMs / static_cast<float>(_frameTimesMs.size()),
+                maxMs
+            );
+
+            if (ImPlot::BeginPlot("##FrameTimes", ImVec2(-1, 150)))
+            {
+                ImPlot::SetupAxes(nullptr, "ms", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+                ImPlot::PlotLine("Frame time", _frameTimesMs.data(), static_cast<int>(_frameTimesMs.size()));
+                ImPlot::EndPlot();
+            }
+        }
+
+        for (auto const & tree : _threadTrees)
+        {
+            if (tree.nodes.size() <= 1)
+            {
+                continue;
+            }
+            if (ImGui::CollapsingHeader(tree.threadName.c_str(), ImGuiTreeNodeFlags_DefaultOpen) == false)
+            {
+                continue;
+            }
+            ImGui::PushID(tree.threadName.c_str());
+            if (ImGui::BeginTable("Scopes", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable | ImGuiTableFlags_BordersInnerV))
+            {
+                ImGui::TableSetupColumn("Scope", ImGuiTableColumnFlags_WidthStretch);
+                ImGui::TableSetupColumn("Time (ms)", ImGuiTableColumnFlags_WidthFixed);
+                ImGui::TableSetupColumn("Frame %", ImGuiTableColumnFlags_WidthFixed);
+                ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_WidthFixed);
+                ImGui::TableHeadersRow();
+                for (auto const childIdx : tree.nodes[0].children)
+                {
+                    DisplayNode(tree, childIdx);
+                }
+                ImGui::EndTable();
+            }
+            ImGui::PopID();
+        }
+
+        _ui->EndWindow();
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void ProfilerWindow::CaptureLastFrame()
+    {
+        auto const frames = Profiler::CollectFrames();
+
+        _frameTimesMs.clear();
+        _frameTimesMs.reserve(frames.size());
+        for (auto const & frame : frames)
+        {
+            _frameTimesMs.emplace_back(static_cast<float>(frame.endNs - frame.beginNs) / 1'000'000.0f);
+        }
+
+        _threadTrees.clear();
+        if (frames.empty() == true)
+        {
+            return;
+        }
+        _capturedFrame = frames.back();
+
+        auto const threads = Profiler::CollectEvents(_capturedFrame.beginNs, _capturedFrame.endNs);
+        _threadTrees.reserve(threads.size());
+        for (auto const & thread : threads)
+        {
+            auto & tree = _threadTrees.emplace_back();
+            tree.threadName = thread.threadName;
+            tree.nodes.emplace_back();
+
+            struct OpenScope
+            {
+                int nodeIdx;
+                int64_t beginNs;
+            };
+            std::vector<OpenScope> stack{OpenScope{.nodeIdx = 0, .beginNs = 0}};
+
+            for (auto const & event : thread.events)
+            {
+                if (event.type == Profiler::EventType::Begin)
+                {
+                    // Calls with the same name under the same parent are merged into one node
+                    auto const parentIdx = stack.back().nodeIdx;
+                    int nodeIdx = -1;
+                    for (auto const childIdx : tree.nodes[parentIdx].children)
+                    {
+                        if (std::strcmp(tree.nodes[childIdx].name, event.name) == 0)
+                        {
+                            nodeIdx = childIdx;
+                            break;
+                        }
+                    }
+                    if (nodeIdx < 0)
+                    {
+                        nodeIdx = static_cast<int>(tree.nodes.size());
+                        tree.nodes.emplace_back(Node{.name = event.name});
+                        tree.nodes[parentIdx].children.emplace_back(nodeIdx);
+                    }
+                    stack.emplace_back(OpenScope{.nodeIdx = nodeIdx, .beginNs = event.timeNs});
+                }
+                // Scopes that began before this frame have no node to close
+                else if (stack.size() > 1)
+                {
+                    auto & node = tree.nodes[stack.back().nodeIdx];
+                    node.totalNs += event.timeNs - stack.back().beginNs;
+                    node.calls += 1;
+                    stack.pop_back();
+                }
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void ProfilerWindow::DisplayNode(ThreadTree const & tree, int const nodeIdx) const
+    {
+        auto const & node = tree.nodes[nodeIdx];
+        // Scopes that are still open at the end of the frame
+        if (node.calls == 0)
+        {
+            return;
+        }
+
+        auto const frameNs = std::max<int64_t>(_capturedFrame.endNs - _capturedFrame.beginNs, 1);
+
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_DefaultOpen;
+        if (node.children.empty() == true)
+        {
+            flags |= ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+        }
+        bool const isOpen = ImGui::TreeNodeEx(reinterpret_cast<void const *>(static_cast<intptr_t>(nodeIdx)), flags, "%s", node.name);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", static_cast<double>(node.totalNs) / 1'000'000.0);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.1f", 100.0 * static_cast<double>(node.totalNs) / static_cast<double>(frameNs));
+        ImGui::TableNextColumn();
+        ImGui::Text("%d", node.calls);
+
+        if (isOpen == true && node.children.empty() == false)
+        {
+            for (auto const childIdx : node.children)
+            {
+                DisplayNode(tree, childIdx);
+            }
+            ImGui::TreePop();
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
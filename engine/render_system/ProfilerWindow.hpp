@@ -0,0 +1,58 @@
+#pragma once
+
+#include "ScopeProfiler.hpp"
+#include "UI.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace MFA
+{
+    // Live view of the scope profiler. Shows the frame time history and the scope hierarchy of the last frame for
+    // every thread. Draws itself through the UpdateSignal of the UI.
+    class ProfilerWindow
+    {
+    public:
+
+        explicit ProfilerWindow(std::shared_ptr<UI> ui, std::string tracePath = "profiler_trace.json");
+
+        ~ProfilerWindow();
+
+        ProfilerWindow(ProfilerWindow const &) noexcept = delete;
+        ProfilerWindow(ProfilerWindow &&) noexcept = delete;
+        ProfilerWindow & operator = (ProfilerWindow const &) noexcept = delete;
+        ProfilerWindow & operator = (ProfilerWindow &&) noexcept = delete;
+
+    private:
+
+        struct Node
+        {
+            char const * name = nullptr;
+            int64_t totalNs = 0;
+            int calls = 0;
+            std::vector<int> children{};
+        };
+
+        struct ThreadTree
+        {
+            std::string threadName{};
+            std::vector<Node> nodes{};          // Index 0 is the root
+        };
+
+        void Display();
+
+        void CaptureLastFrame();
+
+        void DisplayNode(ThreadTree const & tree, int nodeIdx) const;
+
+        std::shared_ptr<UI> _ui{};
+        SignalId _updateSignalId = SignalIdInvalid;
+        std::string const _tracePath;
+
+        bool _isPaused = false;
+        std::vector<float> _frameTimesMs{};
+        Profiler::Frame _capturedFrame{};
+        std::vector<ThreadTree> _threadTrees{};
+    };
+}
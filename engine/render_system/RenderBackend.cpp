@@ -2759,11 +2759,24 @@ namespace MFA::RenderBackend
     )
     {
         // MFA_ASSERT(buffer.size == stageBuffer.size);
+        UpdateLocalBuffer(commandBuffer, buffer, stageBuffer, buffer.size);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void UpdateLocalBuffer(
+        VkCommandBuffer commandBuffer,
+        RT::BufferAndMemory const& buffer,
+        RT::BufferAndMemory const& stageBuffer,
+        VkDeviceSize const size
+    )
+    {
+        MFA_ASSERT(size <= buffer.size && size <= stageBuffer.size);
         CopyBuffer(
             commandBuffer,
             stageBuffer.buffer,
             buffer.buffer,
-            buffer.size
+            size
         );
     }
 
@@ -3178,6 +3191,14 @@ namespace MFA::RenderBackend
             return VkFormat::VK_FORMAT_BC6H_SFLOAT_BLOCK;
         case Format::BC6H_UFloat_Linear_RGB:
             return VkFormat::VK_FORMAT_BC6H_UFLOAT_BLOCK;
+        case Format::BC1_UNorm_Linear_RGB:
+            return VkFormat::VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+        case Format::BC1_UNorm_Linear_RGBA:
+            return VkFormat::VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+        case Format::BC1_UNorm_sRGB_RGB:
+            return VkFormat::VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+        case Format::BC1_UNorm_sRGB_RGBA:
+            return VkFormat::VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
         case Format::BC7_UNorm_Linear_RGB:
         case Format::BC7_UNorm_Linear_RGBA:
             return VkFormat::VK_FORMAT_BC7_UNORM_BLOCK;
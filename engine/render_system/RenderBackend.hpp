@@ -588,6 +588,14 @@ namespace MFA::RenderBackend
         RT::BufferAndMemory const& stageBuffer
     );
 
+    // Copies the first size bytes of the stage buffer
+    void UpdateLocalBuffer(
+        VkCommandBuffer commandBuffer,
+        RT::BufferAndMemory const& buffer,
+        RT::BufferAndMemory const& stageBuffer,
+        VkDeviceSize size
+    );
+
     std::shared_ptr<RT::BufferAndMemory> CreateVertexBuffer(
         VkDevice device,
         VkPhysicalDevice physicalDevice,
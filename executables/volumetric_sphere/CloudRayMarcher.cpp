@@ -0,0 +1,881 @@
+#include "CloudRayMarcher.hpp"
+
+#include "BedrockAssert.hpp"
+#include "BedrockLog.hpp"
+#include "BedrockMath.hpp"
+#include "JobSystem.hpp"
+#include "NoiseGenerator.hpp"
+#include "SimdFloat4.hpp"
+
+#include "stb_image_write.h"
+
+#include <glm/ext/matrix_transform.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+
+using namespace MFA;
+using namespace Simd;
+
+//======================================================================================================================
+
+namespace
+{
+    static constexpr uint32_t TileSize = 16;
+
+    struct Float4x3
+    {
+        Float4 x;
+        Float4 y;
+        Float4 z;
+    };
+
+    Float4 Saturate(Float4 const & value)
+    {
+        return Min(Max(value, Set(0.0f)), Set(1.0f));
+    }
+
+    Float4 Dot(Float4x3 const & a, glm::vec3 const & b)
+    {
+        return a.x * Set(b.x) + a.y * Set(b.y) + a.z * Set(b.z);
+    }
+
+    Float4x3 RayPoint(glm::vec3 const & origin, Float4x3 const & direction, Float4 const & distance)
+    {
+        return Float4x3{
+            .x = Set(origin.x) + direction.x * distance,
+            .y = Set(origin.y) + direction.y * distance,
+            .z = Set(origin.z) + direction.z * distance,
+        };
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Trilinear lookups into a tiling rgba8 volume
+    struct VolumeSampler
+    {
+        uint8_t const * voxels = nullptr;
+        int resolution = 0;
+        // Texels per world unit
+        float scale = 0.0f;
+
+        // Every channel is in [0, 1]
+        void Sample(Float4x3 const & position, Float4 outChannels[4]) const
+        {
+            alignas(16) float fractions[3][LaneCount];
+            alignas(16) float corners[8][4][LaneCount];
+            float coordinates[3][LaneCount];
+            Store(position.x * Set(scale) - Set(0.5f), coordinates[0]);
+            Store(position.y * Set(scale) - Set(0.5f), coordinates[1]);
+            Store(position.z * Set(scale) - Set(0.5f), coordinates[2]);
+
+            for (int lane = 0; lane < LaneCount; ++lane)
+            {
+                size_t offsets[3][2];
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    float const floor = std::floor(coordinates[axis][lane]);
+                    fractions[axis][lane] = coordinates[axis][lane] - floor;
+                    int cell = static_cast<int>(floor) % resolution;
+                    cell = cell < 0 ? cell + resolution : cell;
+                    int const next = cell + 1 == resolution ? 0 : cell + 1;
+                    // Strides of x, y and z are 1, resolution and resolution^2 voxels
+                    size_t const stride = axis == 0 ? 1 : axis == 1 ? resolution : static_cast<size_t>(resolution) * resolution;
+                    offsets[axis][0] = cell * stride * 4;
+                    offsets[axis][1] = next * stride * 4;
+                }
+                for (int corner = 0; corner < 8; ++corner)
+                {
+                    auto const * voxel = voxels +
+                        offsets[0][corner & 1] +
+                        offsets[1][(corner >> 1) & 1] +
+                        offsets[2][corner >> 2];
+                    for (int channel = 0; channel < 4; ++channel)
+                    {
+                        corners[corner][channel][lane] = static_cast<float>(voxel[channel]);
+                    }
+                }
+            }
+
+            Float4 const u = Load(fractions[0]);
+            Float4 const v = Load(fractions[1]);
+            Float4 const w = Load(fractions[2]);
+            for (int channel = 0; channel < 4; ++channel)
+            {
+                auto const corner = [&](int const index) { return Load(corners[index][channel]); };
+                Float4 const near = Lerp(Lerp(corner(0), corner(1), u), Lerp(corner(2), corner(3), u), v);
+                Float4 const far = Lerp(Lerp(corner(4), corner(5), u), Lerp(corner(6), corner(7), u), v);
+                outChannels[channel] = Lerp(near, far, w) * Set(1.0f / 255.0f);
+            }
+        }
+    };
+
+    //-------------------------------------------------------------------------------------------------
+
+    struct Scene
+    {
+        CloudRayMarcher::Params const & params;
+        VolumeSampler shape;
+        VolumeSampler detail;
+        // Nullptr when empty space skipping is off
+        AS::SparseVolume const * occupancy;
+        // Cells of the occupancy up to this value cannot reach the coverage
+        uint8_t occupancyThreshold;
+        // Sphere where the falloff lets the shape reach the coverage
+        float innerRadius2;
+        // Unit vector that points from the clouds to the light
+        glm::vec3 toLight;
+        glm::vec3 radiance;
+        glm::vec3 ambient;
+        float radius2;
+    };
+
+    struct TileStats
+    {
+        uint64_t rayCount = 0;
+        uint64_t hitCount = 0;
+        uint64_t earlyExitCount = 0;
+        uint64_t stepCount = 0;
+        uint64_t skippedStepCount = 0;
+        uint64_t lightSampleCount = 0;
+        uint32_t maxStepsPerRay = 0;
+    };
+
+    // Density in [0, 1] for the lanes in the mask and 0 for the rest
+    Float4 Density(Scene const & scene, Float4x3 const & position, Mask4 const & mask)
+    {
+        auto const & params = scene.params;
+        Float4x3 const offset {
+            .x = position.x - Set(params.sphereCenter.x),
+            .y = position.y - Set(params.sphereCenter.y),
+            .z = position.z - Set(params.sphereCenter.z),
+        };
+        Float4 const distance2 = offset.x * offset.x + offset.y * offset.y + offset.z * offset.z;
+        // Fades the shape out towards the surface of the sphere
+        Float4 const falloff = Saturate((Set(1.0f) - Sqrt(distance2 * Set(1.0f / scene.radius2))) * Set(4.0f));
+        Mask4 const inside = mask & (falloff > Set(0.0f));
+        if (MoveMask(inside) == 0)
+        {
+            return Set(0.0f);
+        }
+
+        // Perlin-Worley remapped by the worley fbm of the other channels
+        Float4 shape[4];
+        scene.shape.Sample(position, shape);
+        Float4 const worley = shape[1] * Set(0.625f) + shape[2] * Set(0.25f) + shape[3] * Set(0.125f);
+        Float4 const base = (shape[0] - worley + Set(1.0f)) / (Set(2.0f) - worley) * falloff;
+        Float4 density = Saturate((base - Set(1.0f - params.coverage)) / Set(std::max(params.coverage, 1e-3f)));
+
+        Mask4 const cloudy = inside & (density > Set(0.0f));
+        if (MoveMask(cloudy) != 0 && params.detailStrength > 0.0f)
+        {
+            Float4 detail[4];
+            scene.detail.Sample(position, detail);
+            Float4 const erosion = detail[3] * Set(params.detailStrength);
+            density = Saturate((density - erosion) / Max(Set(1.0f) - erosion, Set(1e-3f)));
+        }
+        return Select(inside, density, Set(0.0f));
+    }
+
+    // The base shape is (perlinWorley - worley + 1) / (2 - worley) times a falloff in [0, 1]. It grows with perlinWorley
+    // and shrinks with worley, And a trilinear sample of either channel stays between the eight voxels that it reads.
+    // So the bound of a sample is the remap of the largest perlinWorley and the smallest worley of its eight voxels.
+    // The detail erosion only ever lowers the density.
+    // Voxel v of the result holds the bound of the samples that read voxels v - 1 and v on every axis, Wrapped like the
+    // sampler. It has resolution + 1 voxels per axis so that the samples within half a texel of either border of a
+    // repetition find their bound inside the volume.
+    std::vector<uint8_t> BuildShapeBound(uint8_t const * voxels, int const resolution)
+    {
+        int const boundResolution = resolution + 1;
+        std::vector<uint8_t> bound(static_cast<size_t>(boundResolution) * boundResolution * boundResolution);
+        JobSystem::ParallelFor(boundResolution, 1, [&](int const begin, int const end)->void
+        {
+            for (int z = begin; z < end; ++z)
+            {
+                for (int y = 0; y < boundResolution; ++y)
+                {
+                    for (int x = 0; x < boundResolution; ++x)
+                    {
+                        float maxPerlinWorley = 0.0f;
+                        float minWorley = 1.0f;
+                        for (int corner = 0; corner < 8; ++corner)
+                        {
+                            glm::ivec3 const voxel {
+                                (x - 1 + (corner & 1) + resolution) % resolution,
+                                (y - 1 + ((corner >> 1) & 1) + resolution) % resolution,
+                                (z - 1 + (corner >> 2) + resolution) % resolution,
+                            };
+                            auto const * channels = voxels +
+                                ((static_cast<size_t>(voxel.z) * resolution + voxel.y) * resolution + voxel.x) * 4;
+                            maxPerlinWorley = std::max(maxPerlinWorley, static_cast<float>(channels[0]) * (1.0f / 255.0f));
+                            minWorley = std::min(
+                                minWorley,
+                                (0.625f * channels[1] + 0.25f * channels[2] + 0.125f * channels[3]) * (1.0f / 255.0f)
+                            );
+                        }
+                        float const base = (maxPerlinWorley - minWorley + 1.0f) / (2.0f - minWorley);
+                        // Rounded up with half a level to spare, So float rounding in the marcher cannot go past the bound
+                        bound[(static_cast<size_t>(z) * boundResolution + y) * boundResolution + x] = static_cast<uint8_t>(
+                            std::clamp(std::ceil(base * 255.0f + 0.5f), 0.0f, 255.0f)
+                        );
+                    }
+                }
+            }
+        });
+        return bound;
+    }
+
+    // Largest bound that still leaves the density at 0. The density is above 0 only where base > 1 - coverage.
+    uint8_t OccupancyThreshold(float const coverage)
+    {
+        return static_cast<uint8_t>(std::clamp(std::floor((1.0f - coverage) * 255.0f), 0.0f, 255.0f));
+    }
+
+    // Distance along the ray where the shape can first make a cloud, EndDistance when it cannot before that.
+    // OutCheckDistance is where the brick that holds that point ends, Rays do not have to look again before it.
+    // The shape can only reach the coverage inside the inner sphere where the falloff is above 1 - coverage. Inside of
+    // it the shape volume repeats, So the ray is cut at the borders of every repetition and each piece is looked up in
+    // the occupancy hierarchy on its own.
+    float SkipEmptySpace(
+        Scene const & scene,
+        glm::vec3 const & origin,
+        glm::vec3 const & direction,
+        float distance,
+        float const endDistance,
+        float & outCheckDistance
+    )
+    {
+        outCheckDistance = endDistance;
+
+        glm::vec3 const offset = origin - scene.params.sphereCenter;
+        float const b = glm::dot(direction, offset);
+        float const discriminant = b * b - (glm::dot(offset, offset) - scene.innerRadius2);
+        if (discriminant <= 0.0f)
+        {
+            return endDistance;
+        }
+        float const root = std::sqrt(discriminant);
+        distance = std::max(distance, -b - root);
+        float const innerEnd = std::min(endDistance, -b + root);
+
+        auto const resolution = static_cast<float>(scene.shape.resolution);
+        float const brickSize = static_cast<float>(AS::SparseVolume::BrickSize);
+        // The occupancy has voxel centers at i + 0.5 like the sampler, So texels map to it without an offset
+        glm::vec3 const texelOrigin = origin * scene.shape.scale;
+        glm::vec3 const texelDirection = direction * scene.shape.scale;
+        while (distance < innerEnd)
+        {
+            glm::vec3 const repetition = glm::floor((texelOrigin + texelDirection * distance) / resolution);
+            glm::vec3 const localOrigin = texelOrigin - repetition * resolution;
+            float repetitionExit = innerEnd;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (texelDirection[axis] != 0.0f)
+                {
+                    float const border = texelDirection[axis] > 0.0f ? resolution : 0.0f;
+                    repetitionExit = std::min(repetitionExit, (border - localOrigin[axis]) / texelDirection[axis]);
+                }
+            }
+            float const occupied = scene.occupancy->SkipEmptySpace(
+                localOrigin,
+                texelDirection,
+                distance,
+                repetitionExit,
+                scene.occupancyThreshold
+            );
+            if (occupied < repetitionExit)
+            {
+                glm::vec3 const brick = glm::floor((localOrigin + texelDirection * occupied) / brickSize);
+                outCheckDistance = repetitionExit;
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    if (texelDirection[axis] != 0.0f)
+                    {
+                        float const border = (brick[axis] + (texelDirection[axis] > 0.0f ? 1.0f : 0.0f)) * brickSize;
+                        outCheckDistance = std::min(outCheckDistance, (border - localOrigin[axis]) / texelDirection[axis]);
+                    }
+                }
+                outCheckDistance = std::max(outCheckDistance, occupied);
+                return occupied;
+            }
+            // Nudged past the border so the next lookup lands in the next repetition
+            distance = std::max(repetitionExit, distance) + 1e-3f / scene.shape.scale;
+        }
+        return endDistance;
+    }
+
+    // Moves the lanes in laneBits to the first step at or after the end of the empty space in front of them.
+    // The steps stay on the same grid as without skipping and the samples in between are 0, So the result is the same.
+    Float4 SkipEmptySpace(
+        Scene const & scene,
+        glm::vec3 const & origin,
+        Float4x3 const & direction,
+        Float4 const & distance,
+        Float4 const & farDistance,
+        float const stepLength,
+        int const laneBits,
+        int const uniqueBits,
+        float checkDistances[LaneCount],
+        TileStats & stats
+    )
+    {
+        alignas(16) float distances[LaneCount], farDistances[LaneCount];
+        alignas(16) float dx[LaneCount], dy[LaneCount], dz[LaneCount];
+        Store(distance, distances);
+        Store(farDistance, farDistances);
+        Store(direction.x, dx);
+        Store(direction.y, dy);
+        Store(direction.z, dz);
+        for (int lane = 0; lane < LaneCount; ++lane)
+        {
+            if (((laneBits >> lane) & 1) == 0)
+            {
+                continue;
+            }
+            float const occupied = SkipEmptySpace(
+                scene,
+                origin,
+                glm::vec3{dx[lane], dy[lane], dz[lane]},
+                distances[lane],
+                farDistances[lane],
+                checkDistances[lane]
+            );
+            if (occupied > distances[lane])
+            {
+                float const skippedSteps = std::ceil((occupied - distances[lane]) / stepLength);
+                distances[lane] += skippedSteps * stepLength;
+                if (((uniqueBits >> lane) & 1) != 0)
+                {
+                    stats.skippedStepCount += static_cast<uint64_t>(skippedSteps);
+                }
+            }
+        }
+        return Load(distances);
+    }
+
+    // Transmittance from the samples to the light with the Beer-Lambert law
+    Float4 LightTransmittance(Scene const & scene, Float4x3 const & position, Mask4 const & mask, TileStats & stats)
+    {
+        auto const & params = scene.params;
+        glm::vec3 const & toLight = scene.toLight;
+        Float4x3 const offset {
+            .x = position.x - Set(params.sphereCenter.x),
+            .y = position.y - Set(params.sphereCenter.y),
+            .z = position.z - Set(params.sphereCenter.z),
+        };
+        // The samples are inside the sphere, So the far intersection is always in front of them
+        Float4 const b = Dot(offset, toLight);
+        Float4 const c = offset.x * offset.x + offset.y * offset.y + offset.z * offset.z - Set(scene.radius2);
+        Float4 const exitDistance = Max(Sqrt(Max(b * b - c, Set(0.0f))) - b, Set(0.0f));
+        Float4 const stepLength = exitDistance * Set(1.0f / static_cast<float>(params.lightSteps));
+
+        Float4 opticalDepth = Set(0.0f);
+        for (int step = 0; step < params.lightSteps; ++step)
+        {
+            Float4 const distance = stepLength * Set(static_cast<float>(step) + 0.5f);
+            Float4x3 const sample {
+                .x = position.x + Set(toLight.x) * distance,
+                .y = position.y + Set(toLight.y) * distance,
+                .z = position.z + Set(toLight.z) * distance,
+            };
+            opticalDepth = opticalDepth + Density(scene, sample, mask) * stepLength;
+        }
+        stats.lightSampleCount += static_cast<uint64_t>(std::popcount(static_cast<unsigned>(MoveMask(mask)))) * params.lightSteps;
+        return Exp(opticalDepth * Set(-params.extinction));
+    }
+
+    // Relative to isotropic scattering (The 1 / 4pi is left out), So a light intensity of 1 makes a thin cloud
+    // about as bright as the light
+    float HenyeyGreenstein(float const cosTheta, float const g)
+    {
+        float const g2 = g * g;
+        float const denominator = 1.0f + g2 - 2.0f * g * cosTheta;
+        return (1.0f - g2) / (denominator * std::sqrt(denominator));
+    }
+
+    // Stable per pixel offset of the first step, So the step pattern does not show up as bands
+    float StepJitter(uint32_t const x, uint32_t const y)
+    {
+        uint32_t hash = x * 0x8DA6B343u ^ y * 0xD8163841u;
+        hash ^= hash >> 16;
+        hash *= 0x7FEB352Du;
+        hash ^= hash >> 15;
+        return static_cast<float>(hash >> 8) * (1.0f / 16777216.0f);
+    }
+
+    uint8_t EncodeSRGB(float const linear)
+    {
+        float const value = std::clamp(linear, 0.0f, 1.0f);
+        float const encoded = value <= 0.0031308f
+            ? value * 12.92f
+            : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+        return static_cast<uint8_t>(encoded * 255.0f + 0.5f);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Marches four rays together and returns their linear colors and depths.
+    // Only the lanes in uniqueBits count towards the stats, The others repeat a pixel to fill the packet.
+    void MarchPacket(
+        Scene const & scene,
+        glm::vec3 const & origin,
+        Float4x3 const & direction,
+        float const * jitter,
+        int const uniqueBits,
+        Float4 outColor[3],
+        Float4 & outDepth,
+        TileStats & stats
+    )
+    {
+        auto const & params = scene.params;
+        stats.rayCount += std::popcount(static_cast<unsigned>(uniqueBits));
+
+        Float4 red = Set(0.0f);
+        Float4 green = Set(0.0f);
+        Float4 blue = Set(0.0f);
+        Float4 transmittance = Set(1.0f);
+        Float4 depthSum = Set(0.0f);
+        Float4 depthWeight = Set(0.0f);
+
+        glm::vec3 const offset = origin - params.sphereCenter;
+        Float4 const b = Dot(direction, offset);
+        Float4 const c = Set(glm::dot(offset, offset) - scene.radius2);
+        Float4 const discriminant = b * b - c;
+        Float4 const root = Sqrt(Max(discriminant, Set(0.0f)));
+        Float4 const farDistance = Set(0.0f) - b + root;
+        Float4 const nearDistance = Max(Set(0.0f) - b - root, Set(0.0f));
+        Mask4 const hit = (discriminant > Set(0.0f)) & (farDistance > Set(0.0f));
+        int const hitBits = MoveMask(hit);
+
+        if (hitBits != 0)
+        {
+            stats.hitCount += std::popcount(static_cast<unsigned>(hitBits & uniqueBits));
+
+            // The same step length for every ray, So the step count of a ray follows the length of its chord
+            float const stepLength = 2.0f * params.sphereRadius / static_cast<float>(params.maxSteps);
+            Float4 const stepLength4 = Set(stepLength);
+            Float4 distance = nearDistance + Load(jitter) * stepLength4;
+
+            alignas(16) float phases[LaneCount];
+            {
+                alignas(16) float dx[LaneCount], dy[LaneCount], dz[LaneCount];
+                Store(direction.x, dx);
+                Store(direction.y, dy);
+                Store(direction.z, dz);
+                for (int lane = 0; lane < LaneCount; ++lane)
+                {
+                    // The light reaches the camera against the ray direction, So looking at the light is forward scattering
+                    float const cosTheta = glm::dot(glm::vec3{dx[lane], dy[lane], dz[lane]}, scene.toLight);
+                    phases[lane] = HenyeyGreenstein(cosTheta, params.anisotropy);
+                }
+            }
+            Float4 const phase = Load(phases);
+
+            uint32_t stepsPerLane[LaneCount] {};
+            // Lanes whose last sample was empty look for the next occupied space before the next sample,
+            // Unless they are still in the brick where they found it the last time
+            int skipBits = scene.occupancy != nullptr ? hitBits : 0;
+            alignas(16) float checkDistances[LaneCount] {};
+            for (int step = 0; step < params.maxSteps; ++step)
+            {
+                Mask4 active = hit &
+                    (distance < farDistance) &
+                    (transmittance > Set(params.minTransmittance));
+                int activeBits = MoveMask(active);
+                skipBits &= ~MoveMask(distance < Load(checkDistances));
+                if ((activeBits & skipBits) != 0)
+                {
+                    distance = SkipEmptySpace(
+                        scene,
+                        origin,
+                        direction,
+                        distance,
+                        farDistance,
+                        stepLength,
+                        activeBits & skipBits,
+                        uniqueBits,
+                        checkDistances,
+                        stats
+                    );
+                    active = active & (distance < farDistance);
+                    activeBits = MoveMask(active);
+                }
+                if (activeBits == 0)
+                {
+                    break;
+                }
+                for (int lane = 0; lane < LaneCount; ++lane)
+                {
+                    stepsPerLane[lane] += (activeBits >> lane) & 1;
+                }
+
+                auto const position = RayPoint(origin, direction, distance);
+                Float4 const density = Density(scene, position, active);
+                Mask4 const cloudy = active & (density > Set(0.0f));
+                if (MoveMask(cloudy) != 0)
+                {
+                    Float4 const lightTransmittance = LightTransmittance(scene, position, cloudy, stats);
+                    Float4 const stepTransmittance = Exp(density * Set(-params.extinction * stepLength));
+                    // Energy conserving integration over the step, The scattering albedo is 1
+                    Float4 const scattered = Select(cloudy, transmittance * (Set(1.0f) - stepTransmittance), Set(0.0f));
+                    depthSum = depthSum + scattered * distance;
+                    depthWeight = depthWeight + scattered;
+                    Float4 const direct = lightTransmittance * phase;
+                    red = red + scattered * (direct * Set(scene.radiance.r) + Set(scene.ambient.r));
+                    green = green + scattered * (direct * Set(scene.radiance.g) + Set(scene.ambient.g));
+                    blue = blue + scattered * (direct * Set(scene.radiance.b) + Set(scene.ambient.b));
+                    transmittance = Select(cloudy, transmittance * stepTransmittance, transmittance);
+                }
+                if (scene.occupancy != nullptr)
+                {
+                    skipBits = activeBits & ~MoveMask(cloudy);
+                }
+                distance = distance + stepLength4;
+            }
+
+            alignas(16) float remaining[LaneCount];
+            Store(transmittance, remaining);
+            for (int lane = 0; lane < LaneCount; ++lane)
+            {
+                if (((uniqueBits >> lane) & 1) == 0)
+                {
+                    continue;
+                }
+                stats.stepCount += stepsPerLane[lane];
+                stats.maxStepsPerRay = std::max(stats.maxStepsPerRay, stepsPerLane[lane]);
+                if (((hitBits >> lane) & 1) != 0 && remaining[lane] <= params.minTransmittance)
+                {
+                    ++stats.earlyExitCount;
+                }
+            }
+        }
+
+        outColor[0] = red + transmittance * Set(params.backgroundColor.r);
+        outColor[1] = green + transmittance * Set(params.backgroundColor.g);
+        outColor[2] = blue + transmittance * Set(params.backgroundColor.b);
+        outDepth = Select(
+            depthWeight > Set(1e-4f),
+            depthSum / Max(depthWeight, Set(1e-4f)),
+            Set(std::numeric_limits<float>::infinity())
+        );
+    }
+
+}
+
+//======================================================================================================================
+
+CloudRayMarcher::CloudRayMarcher(uint32_t const seed)
+    : CloudRayMarcher(
+        NoiseGenerator::LoadOrBakeCloudShapeVolume(std::filesystem::temp_directory_path().string(), 128, seed),
+        NoiseGenerator::LoadOrBakeCloudDetailVolume(std::filesystem::temp_directory_path().string(), 32, seed)
+    )
+{}
+
+//======================================================================================================================
+
+CloudRayMarcher::CloudRayMarcher(
+    std::shared_ptr<AS::Texture> shapeVolume,
+    std::shared_ptr<AS::Texture> detailVolume
+)
+{
+    auto const makeVolume = [](std::shared_ptr<AS::Texture> texture)->Volume
+    {
+        MFA_ASSERT(texture != nullptr);
+        MFA_ASSERT(texture->GetFormat() == AS::Texture::Format::UNCOMPRESSED_UNORM_R8G8B8A8_LINEAR);
+        auto const & dimension = texture->GetMipmapDimension(0);
+        MFA_ASSERT(dimension.width == dimension.height && dimension.width == dimension.depth);
+        Volume volume{};
+        volume.voxels = texture->GetMipmapBuffer(0)->As<uint8_t>();
+        volume.resolution = static_cast<int>(dimension.width);
+        volume.texture = std::move(texture);
+        return volume;
+    };
+    _shape = makeVolume(std::move(shapeVolume));
+    _detail = makeVolume(std::move(detailVolume));
+    _shapeBound = BuildShapeBound(_shape.voxels, _shape.resolution);
+}
+
+//======================================================================================================================
+
+CloudRayMarcher::View CloudRayMarcher::LookAtView(
+    glm::vec3 const & position,
+    glm::vec3 const & target,
+    uint32_t const width,
+    uint32_t const height,
+    float const fovDeg
+)
+{
+    MFA_ASSERT(width > 0 && height > 0);
+    glm::mat4 projection {0.0f};
+    Math::PerspectiveProjection(
+        projection,
+        static_cast<float>(width) / static_cast<float>(height),
+        fovDeg,
+        0.01f,
+        1000.0f
+    );
+    // The projection looks down -z, And ndc y points down in vulkan so the view is built with world down as its up
+    auto const view = glm::lookAtRH(position, target, -Math::UpVec3);
+    return View {
+        .cameraPosition = position,
+        .viewProjection = projection * view,
+        .width = width,
+        .height = height
+    };
+}
+
+//======================================================================================================================
+
+CloudRayMarcher::Frame CloudRayMarcher::RenderFrame(
+    View const & view,
+    Params const & params,
+    PixelFilter const & filter,
+    Stats * outStats
+) const
+{
+    MFA_ASSERT(params.sphereRadius > 0.0f);
+    MFA_ASSERT(params.maxSteps > 0 && params.lightSteps > 0);
+
+    auto const startTime = std::chrono::steady_clock::now();
+
+    size_t const pixelCount = static_cast<size_t>(view.width) * view.height;
+    Frame frame {.width = view.width, .height = view.height};
+    frame.colors.resize(pixelCount, glm::vec3{0.0f});
+    frame.depths.resize(pixelCount, std::numeric_limits<float>::infinity());
+
+    glm::vec3 toLight = -params.lightDirection;
+    float const lightLength = glm::length(toLight);
+    toLight = lightLength > 0.0f ? toLight / lightLength : glm::vec3{0.0f, 1.0f, 0.0f};
+
+    auto const occupancy = params.skipEmptySpace ? GetOccupancy(params.coverage) : nullptr;
+    // The falloff is 4 * (1 - r / R) and the density needs a base above 1 - coverage, With a little to spare
+    float const innerRadius = params.sphereRadius * std::min((1.0f - (1.0f - params.coverage) * 0.25f) * 1.001f, 1.0f);
+
+    Scene const scene {
+        .params = params,
+        .shape = VolumeSampler {
+            .voxels = _shape.voxels,
+            .resolution = _shape.resolution,
+            .scale = static_cast<float>(_shape.resolution) / params.shapeScale
+        },
+        .detail = VolumeSampler {
+            .voxels = _detail.voxels,
+            .resolution = _detail.resolution,
+            .scale = static_cast<float>(_detail.resolution) / params.detailScale
+        },
+        .occupancy = occupancy.get(),
+        .occupancyThreshold = OccupancyThreshold(params.coverage),
+        .innerRadius2 = innerRadius * innerRadius,
+        .toLight = toLight,
+        .radiance = params.lightColor * params.lightIntensity,
+        .ambient = params.lightColor * params.ambientStrength,
+        .radius2 = params.sphereRadius * params.sphereRadius,
+    };
+
+    auto const inverseViewProjection = InverseViewProjection(view);
+
+    uint32_t const tilesX = (view.width + TileSize - 1) / TileSize;
+    uint32_t const tilesY = (view.height + TileSize - 1) / TileSize;
+    std::vector<TileStats> tileStats(static_cast<size_t>(tilesX) * tilesY);
+
+    JobSystem::ParallelFor(static_cast<int>(tileStats.size()), 1, [&](int const begin, int const end)->void
+    {
+        std::vector<glm::uvec2> pixels{};
+        pixels.reserve(TileSize * TileSize);
+        for (int tile = begin; tile < end; ++tile)
+        {
+            auto & stats = tileStats[tile];
+            uint32_t const beginX = (tile % tilesX) * TileSize;
+            uint32_t const beginY = (tile / tilesX) * TileSize;
+            uint32_t const endX = std::min(beginX + TileSize, view.width);
+            uint32_t const endY = std::min(beginY + TileSize, view.height);
+
+            // 2x2 quads in order, So the rays of a packet stay close to each other
+            pixels.clear();
+            for (uint32_t y = beginY; y < endY; y += 2)
+            {
+                for (uint32_t x = beginX; x < endX; x += 2)
+                {
+                    for (uint32_t quad = 0; quad < 4; ++quad)
+                    {
+                        glm::uvec2 const pixel {x + (quad & 1), y + (quad >> 1)};
+                        if (pixel.x < endX && pixel.y < endY && (filter == nullptr || filter(pixel.x, pixel.y)))
+                        {
+                            pixels.emplace_back(pixel);
+                        }
+                    }
+                }
+            }
+
+            for (size_t first = 0; first < pixels.size(); first += LaneCount)
+            {
+                // Lanes past the end of the list repeat its last pixel
+                glm::uvec2 lanePixels[LaneCount];
+                int uniqueBits = 0;
+                alignas(16) float dx[LaneCount], dy[LaneCount], dz[LaneCount], jitter[LaneCount];
+                for (int lane = 0; lane < LaneCount; ++lane)
+                {
+                    if (first + lane < pixels.size())
+                    {
+                        uniqueBits |= 1 << lane;
+                    }
+                    lanePixels[lane] = pixels[std::min(first + lane, pixels.size() - 1)];
+                    auto const direction = RayDirection(view, inverseViewProjection, lanePixels[lane].x, lanePixels[lane].y);
+                    dx[lane] = direction.x;
+                    dy[lane] = direction.y;
+                    dz[lane] = direction.z;
+                    jitter[lane] = StepJitter(lanePixels[lane].x, lanePixels[lane].y);
+                }
+
+                Float4 color[3];
+                Float4 depth;
+                MarchPacket(
+                    scene,
+                    view.cameraPosition,
+                    Float4x3{.x = Load(dx), .y = Load(dy), .z = Load(dz)},
+                    jitter,
+                    uniqueBits,
+                    color,
+                    depth,
+                    stats
+                );
+
+                alignas(16) float channels[3][LaneCount];
+                alignas(16) float depths[LaneCount];
+                for (int channel = 0; channel < 3; ++channel)
+                {
+                    Store(color[channel], channels[channel]);
+                }
+                Store(depth, depths);
+                for (int lane = 0; lane < LaneCount; ++lane)
+                {
+                    auto const index = static_cast<size_t>(lanePixels[lane].y) * view.width + lanePixels[lane].x;
+                    frame.colors[index] = glm::vec3{channels[0][lane], channels[1][lane], channels[2][lane]};
+                    frame.depths[index] = depths[lane];
+                }
+            }
+        }
+    });
+
+    if (outStats != nullptr)
+    {
+        Stats stats {};
+        for (auto const & tile : tileStats)
+        {
+            stats.hitCount += tile.hitCount;
+            stats.earlyExitCount += tile.earlyExitCount;
+            stats.stepCount += tile.stepCount;
+            stats.skippedStepCount += tile.skippedStepCount;
+            stats.lightSampleCount += tile.lightSampleCount;
+            stats.maxStepsPerRay = std::max(stats.maxStepsPerRay, tile.maxStepsPerRay);
+            stats.rayCount += tile.rayCount;
+        }
+        stats.renderTimeMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - startTime
+        ).count();
+        *outStats = stats;
+    }
+
+    return frame;
+}
+
+//======================================================================================================================
+
+CloudRayMarcher::Image CloudRayMarcher::Render(View const & view, Params const & params, Stats * outStats) const
+{
+    return Encode(RenderFrame(view, params, nullptr, outStats));
+}
+
+//======================================================================================================================
+
+CloudRayMarcher::Image CloudRayMarcher::Encode(Frame const & frame)
+{
+    Image image {.width = frame.width, .height = frame.height};
+    image.pixels.resize(frame.colors.size() * 4);
+    for (size_t i = 0; i < frame.colors.size(); ++i)
+    {
+        auto * pixel = image.pixels.data() + i * 4;
+        for (int channel = 0; channel < 3; ++channel)
+        {
+            pixel[channel] = EncodeSRGB(frame.colors[i][channel]);
+        }
+        pixel[3] = 255;
+    }
+    return image;
+}
+
+//======================================================================================================================
+
+glm::dmat4 CloudRayMarcher::InverseViewProjection(View const & view)
+{
+    return glm::inverse(glm::dmat4{view.viewProjection});
+}
+
+//======================================================================================================================
+
+glm::vec3 CloudRayMarcher::RayDirection(
+    View const & view,
+    glm::dmat4 const & inverseViewProjection,
+    float const x,
+    float const y
+)
+{
+    // A point on the far plane, Points close to the near plane lose most of their precision to the camera position
+    glm::dvec4 const ndc {
+        (static_cast<double>(x) + 0.5) / static_cast<double>(view.width) * 2.0 - 1.0,
+        (static_cast<double>(y) + 0.5) / static_cast<double>(view.height) * 2.0 - 1.0,
+        1.0,
+        1.0
+    };
+    auto const world = inverseViewProjection * ndc;
+    return glm::vec3{glm::normalize(glm::dvec3{world} / world.w - glm::dvec3{view.cameraPosition})};
+}
+
+//======================================================================================================================
+
+bool CloudRayMarcher::WritePNG(Image const & image, std::string const & path)
+{
+    MFA_ASSERT(image.pixels.size() == static_cast<size_t>(image.width) * image.height * 4);
+    auto const result = stbi_write_png(
+        path.c_str(),
+        static_cast<int>(image.width),
+        static_cast<int>(image.height),
+        4,
+        image.pixels.data(),
+        static_cast<int>(image.width * 4)
+    );
+    if (result == 0)
+    {
+        MFA_LOG_WARN("Failed to write %s", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+//======================================================================================================================
+
+std::shared_ptr<AS::SparseVolume const> CloudRayMarcher::GetOccupancy(float const coverage) const
+{
+    auto const threshold = OccupancyThreshold(coverage);
+    std::lock_guard lock{_occupancyMutex};
+    if (_occupancy == nullptr || _occupancyThreshold != threshold)
+    {
+        // Bricks that cannot reach the threshold are not stored, The hierarchy is all that the marcher reads
+        auto const dimension = static_cast<uint32_t>(_shape.resolution) + 1;
+        _occupancy = AS::SparseVolume::BuildFromDense(
+            _shapeBound.data(),
+            AS::SparseVolume::Dimensions{.width = dimension, .height = dimension, .depth = static_cast<uint16_t>(dimension)},
+            1,
+            0,
+            threshold
+        );
+        _occupancyThreshold = threshold;
+    }
+    return _occupancy;
+}
+
+//======================================================================================================================
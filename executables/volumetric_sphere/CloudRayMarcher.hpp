@@ -0,0 +1,170 @@
+#pragma once
+
+#include "AssetSparseVolume.hpp"
+#include "AssetTexture.hpp"
+
+#include <glm/glm.hpp>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Cpu reference of the cloud ray marcher. It renders a sphere of cloud whose density comes from the noise volumes,
+// So shader changes can be compared against a known image and step counts can be profiled on machines without a gpu.
+// Tiles of the image are rendered in parallel on the job system, Pixels are marched four at a time,
+// Taken from 2x2 quads so the rays of a packet stay close.
+// Rays jump over the space where the clouds cannot reach the coverage, The outer shell of the sphere where the falloff is
+// too low and the bricks of a sparse volume that holds an upper bound of the remapped shape.
+class CloudRayMarcher
+{
+public:
+
+    struct Params
+    {
+        glm::vec3 sphereCenter{};
+        float sphereRadius = 8.0f;
+        // World units that one repetition of the shape volume covers
+        float shapeScale = 12.0f;
+        float detailScale = 3.0f;
+        // How much the detail volume erodes the shape
+        float detailStrength = 0.35f;
+        // Fraction of the sphere that is filled with cloud
+        float coverage = 0.4f;
+        // Extinction per world unit at density 1, Scattering is the same since the albedo is 1
+        float extinction = 2.0f;
+        // Henyey-Greenstein anisotropy, Positive values scatter forward
+        float anisotropy = 0.5f;
+        // Steps across the whole diameter, Shorter chords take fewer steps
+        int maxSteps = 128;
+        int lightSteps = 6;
+        // Rays stop early once almost nothing behind the current sample is visible
+        float minTransmittance = 0.01f;
+        // Turning it off only changes the step counts, Not the image
+        bool skipEmptySpace = true;
+        // Direction that the light travels in
+        glm::vec3 lightDirection {-1.0f, 0.0f, -1.0f};
+        glm::vec3 lightColor {1.0f, 1.0f, 1.0f};
+        float lightIntensity = 1.0f;
+        float ambientStrength = 0.25f;
+        glm::vec3 backgroundColor {0.02f, 0.02f, 0.03f};
+    };
+
+    struct View
+    {
+        glm::vec3 cameraPosition{};
+        // Rows are in vulkan order, So ndc y = -1 is the first row of the image
+        glm::mat4 viewProjection{};
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    struct Stats
+    {
+        // Pixels that were marched
+        uint64_t rayCount = 0;
+        // Rays that went through the sphere
+        uint64_t hitCount = 0;
+        uint64_t earlyExitCount = 0;
+        uint64_t stepCount = 0;
+        // Steps that empty space skipping jumped over
+        uint64_t skippedStepCount = 0;
+        uint64_t lightSampleCount = 0;
+        uint32_t maxStepsPerRay = 0;
+        double renderTimeMs = 0.0;
+    };
+
+    struct Image
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        // Rgba8 with srgb encoded colors, The first row is the top of the image
+        std::vector<uint8_t> pixels{};
+    };
+
+    // Linear colors and depths, For passes that work on the marched values before they are encoded
+    struct Frame
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<glm::vec3> colors{};
+        // Distance from the camera weighted by how much each sample adds to the pixel, Infinity where no cloud was hit
+        std::vector<float> depths{};
+    };
+
+    // True for the pixels that should be marched
+    using PixelFilter = std::function<bool(uint32_t x, uint32_t y)>;
+
+    // Bakes the noise volumes with the given seed on the first run and saves them as ktx2 files in the temp directory,
+    // Later runs only read them back
+    explicit CloudRayMarcher(uint32_t seed = 0);
+
+    // Shape and detail have to be cubic rgba8 volumes like the ones from NoiseGenerator
+    explicit CloudRayMarcher(
+        std::shared_ptr<MFA::AS::Texture> shapeVolume,
+        std::shared_ptr<MFA::AS::Texture> detailVolume
+    );
+
+    // Camera at position that looks at target, For rendering without the app. Fov is horizontal like PerspectiveCamera.
+    [[nodiscard]]
+    static View LookAtView(
+        glm::vec3 const & position,
+        glm::vec3 const & target,
+        uint32_t width,
+        uint32_t height,
+        float fovDeg = 40.0f
+    );
+
+    // Pixels that the filter skips stay black with an infinite depth
+    [[nodiscard]]
+    Frame RenderFrame(
+        View const & view,
+        Params const & params,
+        PixelFilter const & filter = nullptr,
+        Stats * outStats = nullptr
+    ) const;
+
+    [[nodiscard]]
+    Image Render(View const & view, Params const & params, Stats * outStats = nullptr) const;
+
+    [[nodiscard]]
+    static Image Encode(Frame const & frame);
+
+    // Double precision, The depth row of the projection is almost the same as its w row and unprojecting in float moves
+    // rays by a noticeable fraction of a pixel
+    [[nodiscard]]
+    static glm::dmat4 InverseViewProjection(View const & view);
+
+    // Unit direction of the ray through the center of pixel (x, y), Fractional coordinates land between pixels
+    [[nodiscard]]
+    static glm::vec3 RayDirection(View const & view, glm::dmat4 const & inverseViewProjection, float x, float y);
+
+    // Uses the bundled stb_image_write
+    static bool WritePNG(Image const & image, std::string const & path);
+
+    // Sparse volume over one repetition of the shape volume that the marcher skips with, It is built on the first
+    // render with the given coverage and kept until the coverage changes
+    [[nodiscard]]
+    std::shared_ptr<MFA::AS::SparseVolume const> GetOccupancy(float coverage) const;
+
+private:
+
+    struct Volume
+    {
+        std::shared_ptr<MFA::AS::Texture> texture{};
+        uint8_t const * voxels = nullptr;
+        int resolution = 0;
+    };
+
+    Volume _shape{};
+    Volume _detail{};
+
+    // Upper bound of the remapped shape for the trilinear samples around every voxel, resolution + 1 voxels per axis
+    std::vector<uint8_t> _shapeBound{};
+
+    mutable std::mutex _occupancyMutex{};
+    mutable std::shared_ptr<MFA::AS::SparseVolume const> _occupancy{};
+    mutable uint8_t _occupancyThreshold = 0;
+
+};
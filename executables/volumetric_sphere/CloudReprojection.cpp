@@ -0,0 +1,431 @@
+#include "CloudReprojection.hpp"
+
+#include "BedrockAssert.hpp"
+#include "JobSystem.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+using namespace MFA;
+
+namespace
+{
+    // Order in which the pixels of a 4x4 cell are marched, Every 4 frames cover each 2x2 quarter of it once
+    constexpr uint8_t Bayer4Order[16] {0, 10, 2, 8, 5, 15, 7, 13, 1, 11, 3, 9, 4, 14, 6, 12};
+    // Same for a 2x2 cell
+    constexpr uint8_t Bayer2Order[4] {0, 3, 1, 2};
+
+    // Largest number of marched pixels around a pixel, Reached by the 4x4 cells
+    constexpr int MaxNeighborCount = 9;
+
+    struct Neighborhood
+    {
+        glm::vec3 colors[MaxNeighborCount]{};
+        float distances2[MaxNeighborCount]{};
+        int count = 0;
+        float nearestDepth = std::numeric_limits<float>::infinity();
+    };
+
+    //==================================================================================================================
+
+    glm::vec3 FetchHistory(CloudRayMarcher::Frame const & history, int x, int y)
+    {
+        x = std::clamp(x, 0, static_cast<int>(history.width) - 1);
+        y = std::clamp(y, 0, static_cast<int>(history.height) - 1);
+        return history.colors[static_cast<size_t>(y) * history.width + x];
+    }
+
+    //==================================================================================================================
+
+    // Pixel coordinates with centers at i + 0.5
+    glm::vec3 SampleHistory(CloudRayMarcher::Frame const & history, glm::vec2 const & pixel)
+    {
+        glm::vec2 const position = pixel - 0.5f;
+        glm::vec2 const base = glm::floor(position);
+        glm::vec2 const weight = position - base;
+        int const x = static_cast<int>(base.x);
+        int const y = static_cast<int>(base.y);
+        auto const top = glm::mix(FetchHistory(history, x, y), FetchHistory(history, x + 1, y), weight.x);
+        auto const bottom = glm::mix(FetchHistory(history, x, y + 1), FetchHistory(history, x + 1, y + 1), weight.x);
+        return glm::mix(top, bottom, weight.y);
+    }
+
+    //==================================================================================================================
+
+    bool ToPixel(glm::vec4 const & clip, uint32_t const width, uint32_t const height, glm::vec2 & outPixel)
+    {
+        if (clip.w <= 0.0f)
+        {
+            return false;
+        }
+        glm::vec2 const ndc = glm::vec2{clip} / clip.w;
+        outPixel = (ndc * 0.5f + 0.5f) * glm::vec2{static_cast<float>(width), static_cast<float>(height)};
+        return true;
+    }
+
+}
+
+//======================================================================================================================
+
+CloudReprojection::CloudReprojection()
+    : CloudReprojection(Params{})
+{}
+
+//======================================================================================================================
+
+CloudReprojection::CloudReprojection(Params const & params)
+    : _params(params)
+{}
+
+//======================================================================================================================
+
+bool CloudReprojection::IsRendered(uint32_t const x, uint32_t const y) const
+{
+    auto const cellSize = CellSize();
+    auto const offset = CellOffset(y);
+    return x % cellSize.x == offset.x && y % cellSize.y == offset.y;
+}
+
+//======================================================================================================================
+
+CloudRayMarcher::PixelFilter CloudReprojection::Filter() const
+{
+    return [this](uint32_t const x, uint32_t const y)->bool
+    {
+        return IsRendered(x, y);
+    };
+}
+
+//======================================================================================================================
+
+CloudRayMarcher::Frame CloudReprojection::Resolve(
+    CloudRayMarcher::Frame const & current,
+    CloudRayMarcher::View const & view,
+    Metrics * outMetrics
+)
+{
+    MFA_ASSERT(current.width == view.width && current.height == view.height);
+    MFA_ASSERT(current.colors.size() == static_cast<size_t>(current.width) * current.height);
+    MFA_ASSERT(current.depths.size() == current.colors.size());
+
+    if (_history.width != current.width || _history.height != current.height)
+    {
+        _hasHistory = false;
+    }
+
+    auto const width = static_cast<int>(current.width);
+    auto const height = static_cast<int>(current.height);
+    auto const cellSize = glm::ivec2{CellSize()};
+    // The neighborhood reaches one cell in every direction, For the checkerboard that is the 4 direct neighbors
+    int const radius = _params.pattern == Pattern::Checkerboard ? 1 : cellSize.x;
+
+    auto const inverseViewProjection = CloudRayMarcher::InverseViewProjection(view);
+
+    CloudRayMarcher::Frame resolved {.width = current.width, .height = current.height};
+    resolved.colors.resize(current.colors.size());
+    resolved.depths.resize(current.depths.size());
+
+    std::atomic<uint64_t> renderedCount = 0;
+    std::atomic<uint64_t> reusedCount = 0;
+    std::atomic<uint64_t> rejectedCount = 0;
+    std::atomic<uint64_t> clampedCount = 0;
+
+    auto const gatherNeighbors = [&](int const x, int const y, Neighborhood & neighborhood)->void
+    {
+        neighborhood = {};
+        int const rowBegin = std::max(y - radius, 0);
+        int const rowEnd = std::min(y + radius, height - 1);
+        for (int row = rowBegin; row <= rowEnd; ++row)
+        {
+            auto const offset = glm::ivec2{CellOffset(static_cast<uint32_t>(row))};
+            if (row % cellSize.y != offset.y)
+            {
+                continue;
+            }
+            // First marched column that is not left of the neighborhood
+            int const columnBegin = std::max(x - radius, 0);
+            int column = columnBegin + ((offset.x - columnBegin % cellSize.x) + cellSize.x) % cellSize.x;
+            int const columnEnd = std::min(x + radius, width - 1);
+            for (; column <= columnEnd; column += cellSize.x)
+            {
+                if (column == x && row == y)
+                {
+                    continue;
+                }
+                MFA_ASSERT(neighborhood.count < MaxNeighborCount);
+                auto const index = static_cast<size_t>(row) * current.width + column;
+                auto const dx = static_cast<float>(column - x);
+                auto const dy = static_cast<float>(row - y);
+                neighborhood.colors[neighborhood.count] = current.colors[index];
+                neighborhood.distances2[neighborhood.count] = dx * dx + dy * dy;
+                neighborhood.nearestDepth = std::min(neighborhood.nearestDepth, current.depths[index]);
+                ++neighborhood.count;
+            }
+        }
+    };
+
+    JobSystem::ParallelFor(height, 8, [&](int const begin, int const end)->void
+    {
+        uint64_t rendered = 0;
+        uint64_t reused = 0;
+        uint64_t rejected = 0;
+        uint64_t clamped = 0;
+
+        Neighborhood neighborhood{};
+        for (int y = begin; y < end; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                auto const index = static_cast<size_t>(y) * current.width + x;
+                if (IsRendered(static_cast<uint32_t>(x), static_cast<uint32_t>(y)) == true)
+                {
+                    resolved.colors[index] = current.colors[index];
+                    resolved.depths[index] = current.depths[index];
+                    ++rendered;
+                    continue;
+                }
+
+                gatherNeighbors(x, y, neighborhood);
+                float const depth = neighborhood.nearestDepth;
+                resolved.depths[index] = depth;
+
+                bool reprojected = false;
+                glm::vec2 previousPixel{};
+                if (_hasHistory == true)
+                {
+                    auto const direction = CloudRayMarcher::RayDirection(
+                        view,
+                        inverseViewProjection,
+                        static_cast<float>(x),
+                        static_cast<float>(y)
+                    );
+                    reprojected = std::isinf(depth)
+                        ? ReprojectDirection(direction, _historyView.viewProjection, _history.width, _history.height, previousPixel)
+                        : Reproject(
+                            view.cameraPosition + direction * depth,
+                            _historyView.viewProjection,
+                            _history.width,
+                            _history.height,
+                            previousPixel
+                        );
+                    reprojected = reprojected &&
+                        previousPixel.x >= 0.0f && previousPixel.x <= static_cast<float>(width) &&
+                        previousPixel.y >= 0.0f && previousPixel.y <= static_cast<float>(height);
+                }
+
+                if (neighborhood.count == 0)
+                {
+                    // Images that are smaller than a cell
+                    resolved.colors[index] = current.colors[index];
+                    ++rejected;
+                    continue;
+                }
+
+                if (reprojected == false)
+                {
+                    // Inverse square distance weights, So the closest marched pixels dominate
+                    glm::vec3 sum{};
+                    float weightSum = 0.0f;
+                    for (int i = 0; i < neighborhood.count; ++i)
+                    {
+                        float const weight = 1.0f / neighborhood.distances2[i];
+                        sum += neighborhood.colors[i] * weight;
+                        weightSum += weight;
+                    }
+                    resolved.colors[index] = sum / weightSum;
+                    ++rejected;
+                    continue;
+                }
+
+                glm::vec2 const pixelCenter {static_cast<float>(x) + 0.5f, static_cast<float>(y) + 0.5f};
+                bool const isStatic = glm::length(previousPixel - pixelCenter) < _params.staticThreshold;
+                auto color = isStatic
+                    ? _history.colors[index]
+                    : SampleHistory(_history, previousPixel);
+
+                if (_params.neighborhoodClamp == true && isStatic == false)
+                {
+                    glm::vec3 minColor = neighborhood.colors[0];
+                    glm::vec3 maxColor = neighborhood.colors[0];
+                    for (int i = 1; i < neighborhood.count; ++i)
+                    {
+                        minColor = glm::min(minColor, neighborhood.colors[i]);
+                        maxColor = glm::max(maxColor, neighborhood.colors[i]);
+                    }
+                    auto const clampedColor = glm::clamp(color, minColor, maxColor);
+                    if (clampedColor != color)
+                    {
+                        ++clamped;
+                    }
+                    color = clampedColor;
+                }
+
+                resolved.colors[index] = color;
+                ++reused;
+            }
+        }
+
+        renderedCount += rendered;
+        reusedCount += reused;
+        rejectedCount += rejected;
+        clampedCount += clamped;
+    });
+
+    _history = resolved;
+    _historyView = view;
+    _hasHistory = true;
+    _frameIndex = (_frameIndex + 1) % GetCycleLength();
+
+    if (outMetrics != nullptr)
+    {
+        Metrics metrics {
+            .renderedCount = renderedCount,
+            .reusedCount = reusedCount,
+            .rejectedCount = rejectedCount,
+            .clampedCount = clampedCount,
+        };
+        auto const reusableCount = metrics.reusedCount + metrics.rejectedCount;
+        metrics.reuseRate = reusableCount > 0
+            ? static_cast<float>(static_cast<double>(metrics.reusedCount) / static_cast<double>(reusableCount))
+            : 0.0f;
+        *outMetrics = metrics;
+    }
+
+    return resolved;
+}
+
+//======================================================================================================================
+
+void CloudReprojection::Reset()
+{
+    _history = {};
+    _historyView = {};
+    _hasHistory = false;
+    _frameIndex = 0;
+}
+
+//======================================================================================================================
+
+void CloudReprojection::SetParams(Params const & params)
+{
+    if (params.pattern != _params.pattern)
+    {
+        Reset();
+    }
+    _params = params;
+}
+
+//======================================================================================================================
+
+CloudReprojection::Params const & CloudReprojection::GetParams() const noexcept
+{
+    return _params;
+}
+
+//======================================================================================================================
+
+uint32_t CloudReprojection::GetCycleLength() const noexcept
+{
+    auto const cellSize = CellSize();
+    return cellSize.x * cellSize.y;
+}
+
+//======================================================================================================================
+
+bool CloudReprojection::Reproject(
+    glm::vec3 const & worldPosition,
+    glm::mat4 const & viewProjection,
+    uint32_t const width,
+    uint32_t const height,
+    glm::vec2 & outPixel
+)
+{
+    return ToPixel(viewProjection * glm::vec4{worldPosition, 1.0f}, width, height, outPixel);
+}
+
+//======================================================================================================================
+
+bool CloudReprojection::ReprojectDirection(
+    glm::vec3 const & direction,
+    glm::mat4 const & viewProjection,
+    uint32_t const width,
+    uint32_t const height,
+    glm::vec2 & outPixel
+)
+{
+    return ToPixel(viewProjection * glm::vec4{direction, 0.0f}, width, height, outPixel);
+}
+
+//======================================================================================================================
+
+float CloudReprojection::MeanAbsoluteError(CloudRayMarcher::Frame const & lhs, CloudRayMarcher::Frame const & rhs)
+{
+    MFA_ASSERT(lhs.colors.size() == rhs.colors.size());
+    if (lhs.colors.empty() == true)
+    {
+        return 0.0f;
+    }
+    double sum = 0.0;
+    for (size_t i = 0; i < lhs.colors.size(); ++i)
+    {
+        auto const difference = glm::abs(lhs.colors[i] - rhs.colors[i]);
+        sum += static_cast<double>(difference.r) + difference.g + difference.b;
+    }
+    return static_cast<float>(sum / static_cast<double>(lhs.colors.size() * 3));
+}
+
+//======================================================================================================================
+
+float CloudReprojection::MaxAbsoluteError(CloudRayMarcher::Frame const & lhs, CloudRayMarcher::Frame const & rhs)
+{
+    MFA_ASSERT(lhs.colors.size() == rhs.colors.size());
+    float result = 0.0f;
+    for (size_t i = 0; i < lhs.colors.size(); ++i)
+    {
+        auto const difference = glm::abs(lhs.colors[i] - rhs.colors[i]);
+        result = std::max(result, std::max(difference.r, std::max(difference.g, difference.b)));
+    }
+    return result;
+}
+
+//======================================================================================================================
+
+glm::uvec2 CloudReprojection::CellSize() const noexcept
+{
+    switch (_params.pattern)
+    {
+    case Pattern::Checkerboard:
+        return glm::uvec2{2, 1};
+    case Pattern::OneOfFour:
+        return glm::uvec2{2, 2};
+    case Pattern::OneOfSixteen:
+        return glm::uvec2{4, 4};
+    }
+    return glm::uvec2{1, 1};
+}
+
+//======================================================================================================================
+
+glm::uvec2 CloudReprojection::CellOffset(uint32_t const y) const noexcept
+{
+    switch (_params.pattern)
+    {
+    case Pattern::Checkerboard:
+        return glm::uvec2{(y + _frameIndex) & 1, 0};
+    case Pattern::OneOfFour:
+    {
+        auto const position = Bayer2Order[_frameIndex % 4];
+        return glm::uvec2{position % 2, position / 2};
+    }
+    case Pattern::OneOfSixteen:
+    {
+        auto const position = Bayer4Order[_frameIndex % 16];
+        return glm::uvec2{position % 4, position / 4};
+    }
+    }
+    return glm::uvec2{0, 0};
+}
+
+//======================================================================================================================
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "CloudRayMarcher.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+// Temporal reuse for the cloud ray marcher. Every frame only one pixel out of each cell of the pattern is marched, The
+// rest are reprojected from the previous resolved frame with the previous view projection and clamped to the colors of
+// the marched pixels around them. History that falls outside of the previous view is filled from the marched neighbors.
+// Works on the linear frames of the cpu reference, So the math can be checked against full renders.
+class CloudReprojection
+{
+public:
+
+    enum class Pattern : uint8_t
+    {
+        // Half of the pixels, Alternating every frame
+        Checkerboard,
+        // One pixel of each 2x2 cell
+        OneOfFour,
+        // One pixel of each 4x4 cell
+        OneOfSixteen,
+    };
+
+    struct Params
+    {
+        Pattern pattern = Pattern::OneOfFour;
+        bool neighborhoodClamp = true;
+        // History that moved less than this many pixels is trusted without clamping, So a still camera converges to
+        // the full render instead of losing the details that are missing from the neighborhood
+        float staticThreshold = 0.01f;
+    };
+
+    struct Metrics
+    {
+        uint64_t renderedCount = 0;
+        // Pixels that used history
+        uint64_t reusedCount = 0;
+        // Pixels without usable history that were filled from their neighbors
+        uint64_t rejectedCount = 0;
+        // Reused pixels whose history was outside of the neighborhood
+        uint64_t clampedCount = 0;
+        // Fraction of the pixels that were not marched this frame and came from history
+        float reuseRate = 0.0f;
+    };
+
+    CloudReprojection();
+
+    explicit CloudReprojection(Params const & params);
+
+    // Pixels of the given frame that have to be marched
+    [[nodiscard]]
+    bool IsRendered(uint32_t x, uint32_t y) const;
+
+    // IsRendered for the current frame, For CloudRayMarcher::RenderFrame
+    [[nodiscard]]
+    CloudRayMarcher::PixelFilter Filter() const;
+
+    // Current holds the pixels that the filter asked for. The resolved frame is returned and becomes the history
+    // of the next one. A frame with a different size than the history starts over.
+    [[nodiscard]]
+    CloudRayMarcher::Frame Resolve(
+        CloudRayMarcher::Frame const & current,
+        CloudRayMarcher::View const & view,
+        Metrics * outMetrics = nullptr
+    );
+
+    // Drops the history, For camera cuts
+    void Reset();
+
+    void SetParams(Params const & params);
+
+    [[nodiscard]]
+    Params const & GetParams() const noexcept;
+
+    // Frames needed to march every pixel once
+    [[nodiscard]]
+    uint32_t GetCycleLength() const noexcept;
+
+    // Pixel coordinates (Centers are at i + 0.5) of a world position in the image of viewProjection, Returns false
+    // when the position is behind the camera
+    [[nodiscard]]
+    static bool Reproject(
+        glm::vec3 const & worldPosition,
+        glm::mat4 const & viewProjection,
+        uint32_t width,
+        uint32_t height,
+        glm::vec2 & outPixel
+    );
+
+    // Same as Reproject for a direction, For the rays that hit nothing and are treated as infinitely far away
+    [[nodiscard]]
+    static bool ReprojectDirection(
+        glm::vec3 const & direction,
+        glm::mat4 const & viewProjection,
+        uint32_t width,
+        uint32_t height,
+        glm::vec2 & outPixel
+    );
+
+    // Mean of the absolute difference over every channel of every pixel
+    [[nodiscard]]
+    static float MeanAbsoluteError(CloudRayMarcher::Frame const & lhs, CloudRayMarcher::Frame const & rhs);
+
+    // Largest absolute difference of any channel
+    [[nodiscard]]
+    static float MaxAbsoluteError(CloudRayMarcher::Frame const & lhs, CloudRayMarcher::Frame const & rhs);
+
+private:
+
+    // Size of the cell that one marched pixel covers and where that pixel is in the current frame
+    [[nodiscard]]
+    glm::uvec2 CellSize() const noexcept;
+
+    [[nodiscard]]
+    glm::uvec2 CellOffset(uint32_t y) const noexcept;
+
+    Params _params{};
+
+    CloudRayMarcher::Frame _history{};
+    CloudRayMarcher::View _historyView{};
+    bool _hasHistory = false;
+
+    uint32_t _frameIndex = 0;
+
+};
@@ -49,6 +49,7 @@ VolumetricSphereApp::VolumetricSphereApp()
         }
     });
     _ui->UpdateSignal.Register([this]() -> void { OnUI(Time::DeltaTimeSec()); });
+    _profilerWindow = std::make_unique<ProfilerWindow>(_ui);
 
     LogicalDevice::ResizeEventSignal2.Register([this]() -> void { Resize(); });
 
@@ -90,6 +91,8 @@ void VolumetricSphereApp::Run()
 
     _time = Time::Instantiate(120, 30);
 
+    Profiler::SetThreadName("Main");
+
     bool shouldQuit = false;
 
     while (shouldQuit == false)
@@ -118,6 +121,8 @@ void VolumetricSphereApp::Run()
         }
 
         _time->Update();
+
+        MFA_PROFILER_FRAME()
     }
 
     _time.reset();
@@ -129,6 +134,8 @@ void VolumetricSphereApp::Run()
 
 void VolumetricSphereApp::Update(float deltaTime)
 {
+    MFA_SCOPE_Profiler("Update")
+
     if (_sceneWindowResized == true)
     {
         PrepareSceneRenderPass();
@@ -145,6 +152,8 @@ void VolumetricSphereApp::Update(float deltaTime)
 
 void VolumetricSphereApp::Render(MFA::RT::CommandRecordState &recordState)
 {
+    MFA_SCOPE_Profiler("Render")
+
     // device->BeginCommandBuffer(
     //     recordState,
     //     RT::CommandBufferType::Compute
@@ -378,6 +387,21 @@ void VolumetricSphereApp::DisplayParametersWindow()
     ImGui::InputInt("Shininess", &_shininess, 1, 256);
 
     _ui->EndWindow();
+
+    _ui->BeginWindow("Clouds");
+
+    ImGui::SliderFloat("Coverage", &_cloudParams.coverage, 0.0f, 1.0f);
+    ImGui::SliderFloat("Extinction", &_cloudParams.extinction, 0.0f, 10.0f);
+    ImGui::SliderFloat("Anisotropy", &_cloudParams.anisotropy, -0.99f, 0.99f);
+    ImGui::SliderFloat("Detail strength", &_cloudParams.detailStrength, 0.0f, 1.0f);
+    ImGui::SliderInt("Max steps", &_cloudParams.maxSteps, 1, 512);
+    ImGui::SliderInt("Light steps", &_cloudParams.lightSteps, 1, 32);
+    if (ImGui::Button("Save cpu reference"))
+    {
+        SaveCpuReference();
+    }
+
+    _ui->EndWindow();
 }
 
 //======================================================================================================================
@@ -403,3 +427,40 @@ void VolumetricSphereApp::DisplaySceneWindow()
 }
 
 //======================================================================================================================
+
+void VolumetricSphereApp::SaveCpuReference()
+{
+    MFA_SCOPE_Profiler("SaveCpuReference")
+
+    if (_cloudRayMarcher == nullptr)
+    {
+        _cloudRayMarcher = std::make_unique<CloudRayMarcher>();
+    }
+
+    auto params = _cloudParams;
+    params.lightDirection = _lightDirection;
+    params.lightColor = _lightColor;
+    params.lightIntensity = _lightIntensity;
+    params.ambientStrength = _ambientStrength;
+
+    CloudRayMarcher::View const view {
+        .cameraPosition = _camera->GlobalPosition(),
+        .viewProjection = _camera->ViewProjection(),
+        .width = _sceneWindowSize.width,
+        .height = _sceneWindowSize.height
+    };
+
+    CloudRayMarcher::Stats stats{};
+    auto const image = _cloudRayMarcher->Render(view, params, &stats);
+    if (CloudRayMarcher::WritePNG(image, "cloud_reference.png") == true)
+    {
+        MFA_LOG_INFO(
+            "Saved cloud_reference.png in %.1f ms, %.1f steps per hit ray, At most %u steps",
+            stats.renderTimeMs,
+            static_cast<double>(stats.stepCount) / static_cast<double>(std::max<uint64_t>(stats.hitCount, 1)),
+            stats.maxStepsPerRay
+        );
+    }
+}
+
+//======================================================================================================================
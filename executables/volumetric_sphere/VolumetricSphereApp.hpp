@@ -1,8 +1,10 @@
 #pragma once
 
+#include "CloudRayMarcher.hpp"
 #include "RenderTypes.hpp"
 #include "SceneRenderPass.hpp"
 #include "GridRenderer.hpp"
+#include "ProfilerWindow.hpp"
 #include "Time.hpp"
 #include "UI.hpp"
 #include "camera/ArcballCamera.hpp"
@@ -42,7 +44,11 @@ private:
     // You need to be able to select and view objects in the editor window
     void DisplaySceneWindow();
 
+    // Renders the current view with the cpu ray marcher and saves it next to the executable
+    void SaveCpuReference();
+
     std::shared_ptr<MFA::UI> _ui{};
+    std::unique_ptr<MFA::ProfilerWindow> _profilerWindow{};
     std::unique_ptr<MFA::Time> _time{};
     std::shared_ptr<MFA::SwapChainRenderResource> _swapChainResource{};
     std::shared_ptr<MFA::DepthRenderResource> _depthResource{};
@@ -75,4 +81,7 @@ private:
     float _specularLightIntensity = 1.0f;
     int _shininess = 32;
     float _ambientStrength = 0.25f;
+
+    std::unique_ptr<CloudRayMarcher> _cloudRayMarcher{};
+    CloudRayMarcher::Params _cloudParams{};
 };
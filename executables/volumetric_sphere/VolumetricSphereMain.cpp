@@ -1,12 +1,144 @@
 #include "BedrockLog.hpp"
 #include "BedrockPath.hpp"
+#include "CloudRayMarcher.hpp"
+#include "CloudReprojection.hpp"
+#include "JobSystem.hpp"
 #include "LogicalDevice.hpp"
 #include "VolumetricSphereApp.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
 using namespace MFA;
 
-int main()
+// VolumetricSphere --reference <output.png> [width] [height] renders the clouds on the cpu without opening a window
+static int RenderReference(int const argc, char * argv[])
+{
+    std::string const outputPath = argv[2];
+    uint32_t const width = argc > 3 ? static_cast<uint32_t>(std::atoi(argv[3])) : 800;
+    uint32_t const height = argc > 4 ? static_cast<uint32_t>(std::atoi(argv[4])) : 800;
+    if (width == 0 || height == 0)
+    {
+        MFA_LOG_ERROR("Invalid image size %ux%u", width, height);
+        return 1;
+    }
+
+    CloudRayMarcher const marcher{};
+    CloudRayMarcher::Stats stats{};
+    auto const image = marcher.Render(
+        CloudRayMarcher::LookAtView(glm::vec3{20.0f, 20.0f, 20.0f}, glm::vec3{}, width, height),
+        CloudRayMarcher::Params{},
+        &stats
+    );
+    if (CloudRayMarcher::WritePNG(image, outputPath) == false)
+    {
+        return 1;
+    }
+
+    MFA_LOG_INFO(
+        "Rendered %s in %.1f ms\nRays: %llu, Hits: %llu, Early exits: %llu\nSteps: %llu, Light samples: %llu, Max steps per ray: %u",
+        outputPath.c_str(),
+        stats.renderTimeMs,
+        static_cast<unsigned long long>(stats.rayCount),
+        static_cast<unsigned long long>(stats.hitCount),
+        static_cast<unsigned long long>(stats.earlyExitCount),
+        static_cast<unsigned long long>(stats.stepCount),
+        static_cast<unsigned long long>(stats.lightSampleCount),
+        stats.maxStepsPerRay
+    );
+    return 0;
+}
+
+// VolumetricSphere --temporal [frames] [checkerboard|4|16] orbits the camera with temporal reprojection and compares
+// every resolved frame against a full render
+static int MeasureReprojection(int const argc, char * argv[])
+{
+    int const frameCount = argc > 2 ? std::atoi(argv[2]) : 32;
+    std::string const patternName = argc > 3 ? argv[3] : "4";
+
+    CloudReprojection::Params reprojectionParams{};
+    if (patternName == "checkerboard")
+    {
+        reprojectionParams.pattern = CloudReprojection::Pattern::Checkerboard;
+    }
+    else if (patternName == "16")
+    {
+        reprojectionParams.pattern = CloudReprojection::Pattern::OneOfSixteen;
+    }
+    else if (patternName != "4")
+    {
+        MFA_LOG_ERROR("Unknown pattern %s, Expected checkerboard, 4 or 16", patternName.c_str());
+        return 1;
+    }
+
+    uint32_t constexpr width = 400;
+    uint32_t constexpr height = 400;
+    float constexpr orbitRadius = 28.0f;
+    // Degrees per frame, About what a slow arcball drag does at 60 fps
+    float constexpr orbitSpeed = 0.5f;
+
+    CloudRayMarcher const marcher{};
+    CloudRayMarcher::Params const params{};
+    CloudReprojection reprojection{reprojectionParams};
+
+    double errorSum = 0.0;
+    double reuseSum = 0.0;
+    uint64_t rayCount = 0;
+    uint64_t clampedCount = 0;
+    for (int frame = 0; frame < frameCount; ++frame)
+    {
+        float const angle = glm::radians(45.0f + orbitSpeed * static_cast<float>(frame));
+        auto const view = CloudRayMarcher::LookAtView(
+            glm::vec3{orbitRadius * std::cos(angle), 20.0f, orbitRadius * std::sin(angle)},
+            glm::vec3{},
+            width,
+            height
+        );
+
+        CloudRayMarcher::Stats stats{};
+        CloudReprojection::Metrics metrics{};
+        auto const resolved = reprojection.Resolve(
+            marcher.RenderFrame(view, params, reprojection.Filter(), &stats),
+            view,
+            &metrics
+        );
+        auto const reference = marcher.RenderFrame(view, params);
+
+        errorSum += CloudReprojection::MeanAbsoluteError(resolved, reference);
+        reuseSum += metrics.reuseRate;
+        rayCount += stats.rayCount;
+        clampedCount += metrics.clampedCount;
+    }
+
+    auto const frames = static_cast<double>(std::max(frameCount, 1));
+    MFA_LOG_INFO(
+        "Pattern %s over %d frames\nRays per frame: %.0f of %u, Reuse rate: %.3f, Clamped per frame: %.0f\nMean absolute error: %.5f",
+        patternName.c_str(),
+        frameCount,
+        static_cast<double>(rayCount) / frames,
+        width * height,
+        reuseSum / frames,
+        static_cast<double>(clampedCount) / frames,
+        errorSum / frames
+    );
+    return 0;
+}
+
+int main(int argc, char * argv[])
 {
+    auto const jobSystem = JobSystem::Instantiate();
+
+    if (argc > 2 && std::string(argv[1]) == "--reference")
+    {
+        return RenderReference(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--temporal")
+    {
+        return MeasureReprojection(argc, argv);
+    }
+
     LogicalDevice::InitParams params{.windowWidth = 1920,
                                      .windowHeight = 1080,
                                      .resizable = true,
@@ -23,4 +155,4 @@ int main()
     }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,889 @@
+#include "NoiseGenerator.hpp"
+
+#include "AssetTexture_KTX.hpp"
+#include "BedrockAssert.hpp"
+#include "BedrockLog.hpp"
+#include "BedrockMemory.hpp"
+#include "ImportTexture.hpp"
+#include "JobSystem.hpp"
+#include "SimdFloat4.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <map>
+#include <vector>
+
+using namespace MFA;
+
+namespace NoiseGenerator
+{
+    //======================================================================================================================
+
+    namespace
+    {
+        using Format = AS::Texture::Format;
+        using namespace Simd;
+
+        static constexpr int PacketSize = LaneCount;
+        static constexpr uint32_t WorleySalt = 0x68E31DA4u;
+
+        // Integer hash with a good avalanche, So neighbouring cells get unrelated values
+        uint32_t Mix(uint32_t value)
+        {
+            value ^= value >> 16;
+            value *= 0x7FEB352Du;
+            value ^= value >> 15;
+            value *= 0x846CA68Bu;
+            value ^= value >> 16;
+            return value;
+        }
+
+        // Every period gets its own seed, Otherwise the octaves would share their values at the origin
+        uint32_t LatticeSeed(uint32_t const seed, int const period)
+        {
+            return Mix(seed ^ Mix(static_cast<uint32_t>(period)));
+        }
+
+        uint32_t HashCell(int const x, int const y, int const z, uint32_t const latticeSeed)
+        {
+            return Mix(static_cast<uint32_t>(x) ^ Mix(static_cast<uint32_t>(y) ^ Mix(static_cast<uint32_t>(z) ^ latticeSeed)));
+        }
+
+        int Wrap(int const value, int const period)
+        {
+            int const remainder = value % period;
+            return remainder < 0 ? remainder + period : remainder;
+        }
+
+        // The edges of a cube, Four of them are repeated so the hash can pick one with a mask
+        constexpr float Gradients[16][3] {
+            {1, 1, 0}, {-1, 1, 0}, {1, -1, 0}, {-1, -1, 0},
+            {1, 0, 1}, {-1, 0, 1}, {1, 0, -1}, {-1, 0, -1},
+            {0, 1, 1}, {0, -1, 1}, {0, 1, -1}, {0, -1, -1},
+            {1, 1, 0}, {-1, 1, 0}, {0, -1, 1}, {0, -1, -1},
+        };
+
+        glm::vec3 Gradient(int const x, int const y, int const z, int const period, uint32_t const seed)
+        {
+            auto const hash = HashCell(Wrap(x, period), Wrap(y, period), Wrap(z, period), LatticeSeed(seed, period));
+            auto const & gradient = Gradients[hash & 15];
+            return glm::vec3{gradient[0], gradient[1], gradient[2]};
+        }
+
+        // Position of the feature point inside its cell, Every axis is in [0, 1)
+        glm::vec3 FeaturePoint(int const x, int const y, int const z, int const period, uint32_t const seed)
+        {
+            auto hash = HashCell(
+                Wrap(x, period),
+                Wrap(y, period),
+                Wrap(z, period),
+                LatticeSeed(seed ^ WorleySalt, period)
+            );
+            glm::vec3 point{};
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                point[axis] = static_cast<float>(hash >> 8) * (1.0f / 16777216.0f);
+                hash = Mix(hash);
+            }
+            return point;
+        }
+
+        float Fade(float const t)
+        {
+            return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+        }
+
+        //-------------------------------------------------------------------------------------------------
+
+        // One gradient or feature point per cell, Indexed by (z * period + y) * period + x
+        struct Lattice
+        {
+            int period = 0;
+            std::vector<float> x{};
+            std::vector<float> y{};
+            std::vector<float> z{};
+        };
+
+        template <typename Generator>
+        std::shared_ptr<Lattice const> MakeLattice(int const period, Generator const & generator)
+        {
+            auto lattice = std::make_shared<Lattice>();
+            size_t const count = static_cast<size_t>(period) * period * period;
+            lattice->period = period;
+            lattice->x.resize(count);
+            lattice->y.resize(count);
+            lattice->z.resize(count);
+            JobSystem::ParallelFor(period, 1, [&](int const begin, int const end)->void
+            {
+                for (int z = begin; z < end; ++z)
+                {
+                    for (int y = 0; y < period; ++y)
+                    {
+                        for (int x = 0; x < period; ++x)
+                        {
+                            auto const index = (static_cast<size_t>(z) * period + y) * period + x;
+                            auto const value = generator(x, y, z);
+                            lattice->x[index] = value.x;
+                            lattice->y[index] = value.y;
+                            lattice->z[index] = value.z;
+                        }
+                    }
+                }
+            });
+            return lattice;
+        }
+
+        // The fbm functions reuse the same periods, So each lattice is built once per volume
+        class LatticeCache
+        {
+        public:
+
+            explicit LatticeCache(uint32_t const seed)
+                : mSeed(seed)
+            {}
+
+            std::shared_ptr<Lattice const> const & Gradients(int const period)
+            {
+                auto & lattice = mGradients[period];
+                if (lattice == nullptr)
+                {
+                    lattice = MakeLattice(period, [this, period](int const x, int const y, int const z)->glm::vec3
+                    {
+                        return Gradient(x, y, z, period, mSeed);
+                    });
+                }
+                return lattice;
+            }
+
+            std::shared_ptr<Lattice const> const & FeaturePoints(int const period)
+            {
+                auto & lattice = mFeaturePoints[period];
+                if (lattice == nullptr)
+                {
+                    lattice = MakeLattice(period, [this, period](int const x, int const y, int const z)->glm::vec3
+                    {
+                        return FeaturePoint(x, y, z, period, mSeed);
+                    });
+                }
+                return lattice;
+            }
+
+        private:
+
+            uint32_t const mSeed;
+            std::map<int, std::shared_ptr<Lattice const>> mGradients{};
+            std::map<int, std::shared_ptr<Lattice const>> mFeaturePoints{};
+        };
+
+        //-------------------------------------------------------------------------------------------------
+
+        Float4 Fade(Float4 const & t)
+        {
+            return t * t * t * (t * (t * Set(6.0f) - Set(15.0f)) + Set(10.0f));
+        }
+
+        Float4 Clamp01(Float4 const & value)
+        {
+            return Min(Max(value, Set(0.0f)), Set(1.0f));
+        }
+
+        //-------------------------------------------------------------------------------------------------
+
+        // Y and z are the same for the whole row, So the neighbouring lattice rows are found once per row
+        struct RowFrame
+        {
+            // [z - 1, z, z + 1][y - 1, y, y + 1] -> (z * period + y) * period
+            size_t rowOffsets[3][3]{};
+            float fractionY = 0.0f;
+            float fractionZ = 0.0f;
+        };
+
+        RowFrame MakeRowFrame(int const period, float const y, float const z)
+        {
+            RowFrame frame{};
+            int const cellY = static_cast<int>(std::floor(y));
+            int const cellZ = static_cast<int>(std::floor(z));
+            frame.fractionY = y - static_cast<float>(cellY);
+            frame.fractionZ = z - static_cast<float>(cellZ);
+            for (int offsetZ = 0; offsetZ < 3; ++offsetZ)
+            {
+                for (int offsetY = 0; offsetY < 3; ++offsetY)
+                {
+                    auto const wrappedZ = static_cast<size_t>(Wrap(cellZ + offsetZ - 1, period));
+                    auto const wrappedY = static_cast<size_t>(Wrap(cellY + offsetY - 1, period));
+                    frame.rowOffsets[offsetZ][offsetY] = (wrappedZ * period + wrappedY) * period;
+                }
+            }
+            return frame;
+        }
+
+        // X positions of four consecutive voxels are split into their cells and the fractions inside them.
+        // Positions are never negative and stay below the period, So truncation is the floor.
+        struct PacketCells
+        {
+            // [x - 1, x, x + 1][lane]
+            int cells[3][PacketSize]{};
+            float fractions[PacketSize]{};
+        };
+
+        PacketCells MakePacketCells(int const period, float const * positionsX)
+        {
+            PacketCells packet{};
+            for (int lane = 0; lane < PacketSize; ++lane)
+            {
+                int const cell = std::min(static_cast<int>(positionsX[lane]), period - 1);
+                packet.fractions[lane] = positionsX[lane] - static_cast<float>(cell);
+                packet.cells[0][lane] = cell == 0 ? period - 1 : cell - 1;
+                packet.cells[1][lane] = cell;
+                packet.cells[2][lane] = cell + 1 == period ? 0 : cell + 1;
+            }
+            return packet;
+        }
+
+        // Loads the lattice values of one neighbour cell for every lane
+        void Gather(
+            Lattice const & lattice,
+            size_t const rowOffset,
+            int const * cells,
+            Float4 & outX,
+            Float4 & outY,
+            Float4 & outZ
+        )
+        {
+            alignas(16) float x[PacketSize];
+            alignas(16) float y[PacketSize];
+            alignas(16) float z[PacketSize];
+            for (int lane = 0; lane < PacketSize; ++lane)
+            {
+                auto const index = rowOffset + cells[lane];
+                x[lane] = lattice.x[index];
+                y[lane] = lattice.y[index];
+                z[lane] = lattice.z[index];
+            }
+            outX = Load(x);
+            outY = Load(y);
+            outZ = Load(z);
+        }
+
+        Float4 PerlinPacket(Lattice const & lattice, RowFrame const & frame, float const * positionsX)
+        {
+            auto const packet = MakePacketCells(lattice.period, positionsX);
+            Float4 const fractionX = Load(packet.fractions);
+
+            Float4 corners[2][2][2];
+            for (int cornerZ = 0; cornerZ < 2; ++cornerZ)
+            {
+                Float4 const distanceZ = Set(frame.fractionZ - static_cast<float>(cornerZ));
+                for (int cornerY = 0; cornerY < 2; ++cornerY)
+                {
+                    Float4 const distanceY = Set(frame.fractionY - static_cast<float>(cornerY));
+                    auto const rowOffset = frame.rowOffsets[cornerZ + 1][cornerY + 1];
+                    for (int cornerX = 0; cornerX < 2; ++cornerX)
+                    {
+                        Float4 gradientX, gradientY, gradientZ;
+                        Gather(lattice, rowOffset, packet.cells[cornerX + 1], gradientX, gradientY, gradientZ);
+                        Float4 const distanceX = fractionX - Set(static_cast<float>(cornerX));
+                        corners[cornerZ][cornerY][cornerX] = gradientX * distanceX +
+                            gradientY * distanceY +
+                            gradientZ * distanceZ;
+                    }
+                }
+            }
+
+            Float4 const u = Fade(fractionX);
+            Float4 const v = Set(Fade(frame.fractionY));
+            Float4 const w = Set(Fade(frame.fractionZ));
+            Float4 const near = Lerp(
+                Lerp(corners[0][0][0], corners[0][0][1], u),
+                Lerp(corners[0][1][0], corners[0][1][1], u),
+                v
+            );
+            Float4 const far = Lerp(
+                Lerp(corners[1][0][0], corners[1][0][1], u),
+                Lerp(corners[1][1][0], corners[1][1][1], u),
+                v
+            );
+            return Lerp(near, far, w);
+        }
+
+        // The closest feature points are always in the 27 cells around the voxel
+        void WorleyPacket(
+            Lattice const & lattice,
+            RowFrame const & frame,
+            float const * positionsX,
+            Float4 & outF1,
+            Float4 & outF2
+        )
+        {
+            auto const packet = MakePacketCells(lattice.period, positionsX);
+            Float4 const fractionX = Load(packet.fractions);
+
+            Float4 f1 = Set(1e9f);
+            Float4 f2 = Set(1e9f);
+            for (int offsetZ = 0; offsetZ < 3; ++offsetZ)
+            {
+                Float4 const cellZ = Set(static_cast<float>(offsetZ - 1) - frame.fractionZ);
+                for (int offsetY = 0; offsetY < 3; ++offsetY)
+                {
+                    Float4 const cellY = Set(static_cast<float>(offsetY - 1) - frame.fractionY);
+                    auto const rowOffset = frame.rowOffsets[offsetZ][offsetY];
+                    for (int offsetX = 0; offsetX < 3; ++offsetX)
+                    {
+                        Float4 pointX, pointY, pointZ;
+                        Gather(lattice, rowOffset, packet.cells[offsetX], pointX, pointY, pointZ);
+                        Float4 const dx = pointX + Set(static_cast<float>(offsetX - 1)) - fractionX;
+                        Float4 const dy = pointY + cellY;
+                        Float4 const dz = pointZ + cellZ;
+                        Float4 const distance = dx * dx + dy * dy + dz * dz;
+                        f2 = Min(f2, Max(f1, distance));
+                        f1 = Min(f1, distance);
+                    }
+                }
+            }
+            outF1 = Sqrt(f1);
+            outF2 = Sqrt(f2);
+        }
+
+        //-------------------------------------------------------------------------------------------------
+
+        // Rows are padded to whole packets, The padding lanes repeat the last voxel
+        uint32_t PaddedLength(uint32_t const resolution)
+        {
+            return (resolution + PacketSize - 1) / PacketSize * PacketSize;
+        }
+
+        // Lattice coordinates of four voxels of a row
+        void PacketPositions(uint32_t const resolution, float const scale, uint32_t const x, float * outPositions)
+        {
+            for (int lane = 0; lane < PacketSize; ++lane)
+            {
+                auto const voxel = std::min(x + lane, resolution - 1);
+                outPositions[lane] = (static_cast<float>(voxel) + 0.5f) * scale;
+            }
+        }
+
+        struct Octave
+        {
+            std::shared_ptr<Lattice const> lattice{};
+            float weight = 0.0f;
+        };
+
+        // Frequency doubles every octave, Weights are normalized so the sum stays in the range of a single octave
+        std::vector<Octave> MakeOctaves(
+            std::vector<float> const & weights,
+            int const frequency,
+            std::function<std::shared_ptr<Lattice const>(int period)> const & getLattice
+        )
+        {
+            float weightSum = 0.0f;
+            for (auto const weight : weights)
+            {
+                weightSum += weight;
+            }
+            MFA_ASSERT(weightSum > 0.0f);
+
+            std::vector<Octave> octaves{};
+            int period = frequency;
+            for (auto const weight : weights)
+            {
+                octaves.emplace_back(Octave{.lattice = getLattice(period), .weight = weight / weightSum});
+                period *= 2;
+            }
+            return octaves;
+        }
+
+        std::vector<float> GainWeights(int const octaveCount, float const gain)
+        {
+            std::vector<float> weights(std::max(octaveCount, 1));
+            float amplitude = 1.0f;
+            for (auto & weight : weights)
+            {
+                weight = amplitude;
+                amplitude *= gain;
+            }
+            return weights;
+        }
+
+        // Weights that the cloud volumes use for worley fbm
+        std::vector<float> const CloudWorleyWeights {0.625f, 0.25f, 0.125f};
+
+        // Perlin fbm in [-1, 1]
+        void PerlinRow(
+            std::vector<Octave> const & octaves,
+            uint32_t const resolution,
+            uint32_t const y,
+            uint32_t const z,
+            float * outRow
+        )
+        {
+            std::fill_n(outRow, PaddedLength(resolution), 0.0f);
+            for (auto const & octave : octaves)
+            {
+                auto const & lattice = *octave.lattice;
+                float const scale = static_cast<float>(lattice.period) / static_cast<float>(resolution);
+                auto const frame = MakeRowFrame(
+                    lattice.period,
+                    (static_cast<float>(y) + 0.5f) * scale,
+                    (static_cast<float>(z) + 0.5f) * scale
+                );
+                Float4 const weight = Set(octave.weight);
+                for (uint32_t x = 0; x < resolution; x += PacketSize)
+                {
+                    float positions[PacketSize];
+                    PacketPositions(resolution, scale, x, positions);
+                    Store(Load(outRow + x) + PerlinPacket(lattice, frame, positions) * weight, outRow + x);
+                }
+            }
+        }
+
+        // Inverted worley fbm in [0, 1]
+        void WorleyRow(
+            std::vector<Octave> const & octaves,
+            WorleyFeature const feature,
+            uint32_t const resolution,
+            uint32_t const y,
+            uint32_t const z,
+            float * outRow
+        )
+        {
+            std::fill_n(outRow, PaddedLength(resolution), 0.0f);
+            for (auto const & octave : octaves)
+            {
+                auto const & lattice = *octave.lattice;
+                float const scale = static_cast<float>(lattice.period) / static_cast<float>(resolution);
+                auto const frame = MakeRowFrame(
+                    lattice.period,
+                    (static_cast<float>(y) + 0.5f) * scale,
+                    (static_cast<float>(z) + 0.5f) * scale
+                );
+                Float4 const weight = Set(octave.weight);
+                for (uint32_t x = 0; x < resolution; x += PacketSize)
+                {
+                    float positions[PacketSize];
+                    PacketPositions(resolution, scale, x, positions);
+                    Float4 f1, f2;
+                    WorleyPacket(lattice, frame, positions, f1, f2);
+                    Float4 value = f1;
+                    switch (feature)
+                    {
+                    case WorleyFeature::F1:
+                        value = f1;
+                        break;
+                    case WorleyFeature::F2:
+                        value = f2;
+                        break;
+                    case WorleyFeature::F2MinusF1:
+                        value = f2 - f1;
+                        break;
+                    }
+                    value = Set(1.0f) - Clamp01(value);
+                    Store(Load(outRow + x) + value * weight, outRow + x);
+                }
+            }
+        }
+
+        // Billowy perlin noise remapped so the worley noise becomes its new minimum
+        void PerlinWorleyRow(
+            std::vector<Octave> const & perlinOctaves,
+            std::vector<Octave> const & worleyOctaves,
+            uint32_t const resolution,
+            uint32_t const y,
+            uint32_t const z,
+            float * scratchRow,
+            float * outRow
+        )
+        {
+            PerlinRow(perlinOctaves, resolution, y, z, outRow);
+            WorleyRow(worleyOctaves, WorleyFeature::F1, resolution, y, z, scratchRow);
+            for (uint32_t x = 0; x < resolution; x += PacketSize)
+            {
+                Float4 const perlin = Clamp01(Abs(Load(outRow + x)));
+                Float4 const worley = Load(scratchRow + x);
+                Store(worley + perlin * (Set(1.0f) - worley), outRow + x);
+            }
+        }
+
+        //-------------------------------------------------------------------------------------------------
+
+        // Calls rowFunction(y, z, rows) for every row of the volume in parallel over the slices.
+        // Rows holds one padded row per channel followed by the scratch rows, Values are quantized from [0, 1].
+        template <typename RowFunction>
+        std::shared_ptr<AS::Texture> BakeVolume(
+            Format const format,
+            uint32_t const resolution,
+            uint32_t const channelCount,
+            uint32_t const scratchRowCount,
+            RowFunction const & rowFunction
+        )
+        {
+            MFA_ASSERT(resolution > 0 && resolution <= UINT16_MAX);
+            auto const rowLength = PaddedLength(resolution);
+            auto data = std::shared_ptr<Blob>(Memory::AllocSize(
+                static_cast<size_t>(resolution) * resolution * resolution * channelCount
+            ));
+            auto * voxels = data->As<uint8_t>();
+
+            JobSystem::ParallelFor(static_cast<int>(resolution), 1, [&](int const begin, int const end)->void
+            {
+                std::vector<float> rows(static_cast<size_t>(rowLength) * (channelCount + scratchRowCount));
+                for (auto z = static_cast<uint32_t>(begin); z < static_cast<uint32_t>(end); ++z)
+                {
+                    for (uint32_t y = 0; y < resolution; ++y)
+                    {
+                        rowFunction(y, z, rows.data());
+                        auto * output = voxels + ((static_cast<size_t>(z) * resolution + y) * resolution) * channelCount;
+                        for (uint32_t channel = 0; channel < channelCount; ++channel)
+                        {
+                            auto const * row = rows.data() + static_cast<size_t>(channel) * rowLength;
+                            for (uint32_t x = 0; x < resolution; ++x)
+                            {
+                                float const value = std::clamp(row[x], 0.0f, 1.0f);
+                                output[x * channelCount + channel] = static_cast<uint8_t>(value * 255.0f + 0.5f);
+                            }
+                        }
+                    }
+                }
+            });
+
+            auto const depth = static_cast<uint16_t>(resolution);
+            auto texture = std::make_shared<AS::Texture>(format, 1, depth, 1);
+            texture->SetMipmapDimension(0, AS::Texture::Dimensions{
+                .width = resolution,
+                .height = resolution,
+                .depth = depth
+            });
+            texture->SetMipmapOffset(0, 0);
+            texture->SetMipmapData(0, data);
+            return texture;
+        }
+
+        // Octaves whose cells would be smaller than two voxels only add aliasing
+        int UsefulOctaveCount(uint32_t const resolution, int const frequency, int const maxOctaves)
+        {
+            int count = 1;
+            while (count < maxOctaves && (frequency << count) * 2 <= static_cast<int>(resolution))
+            {
+                ++count;
+            }
+            return count;
+        }
+
+    }
+
+    //======================================================================================================================
+
+    float Perlin(glm::vec3 const & position, int const period, uint32_t const seed)
+    {
+        MFA_ASSERT(period > 0);
+        glm::vec3 const cellPosition = glm::floor(position);
+        glm::ivec3 const cell{cellPosition};
+        glm::vec3 const fraction = position - cellPosition;
+
+        float corners[2][2][2];
+        for (int z = 0; z < 2; ++z)
+        {
+            for (int y = 0; y < 2; ++y)
+            {
+                for (int x = 0; x < 2; ++x)
+                {
+                    auto const gradient = Gradient(cell.x + x, cell.y + y, cell.z + z, period, seed);
+                    corners[z][y][x] = glm::dot(gradient, fraction - glm::vec3{x, y, z});
+                }
+            }
+        }
+
+        float const u = Fade(fraction.x);
+        float const v = Fade(fraction.y);
+        float const w = Fade(fraction.z);
+        float const near = glm::mix(
+            glm::mix(corners[0][0][0], corners[0][0][1], u),
+            glm::mix(corners[0][1][0], corners[0][1][1], u),
+            v
+        );
+        float const far = glm::mix(
+            glm::mix(corners[1][0][0], corners[1][0][1], u),
+            glm::mix(corners[1][1][0], corners[1][1][1], u),
+            v
+        );
+        return glm::mix(near, far, w);
+    }
+
+    //======================================================================================================================
+
+    glm::vec2 Worley(glm::vec3 const & position, int const period, uint32_t const seed)
+    {
+        MFA_ASSERT(period > 0);
+        glm::vec3 const cellPosition = glm::floor(position);
+        glm::ivec3 const cell{cellPosition};
+        glm::vec3 const fraction = position - cellPosition;
+
+        float f1 = 1e9f;
+        float f2 = 1e9f;
+        for (int z = -1; z <= 1; ++z)
+        {
+            for (int y = -1; y <= 1; ++y)
+            {
+                for (int x = -1; x <= 1; ++x)
+                {
+                    auto const point = FeaturePoint(cell.x + x, cell.y + y, cell.z + z, period, seed) +
+                        glm::vec3{x, y, z};
+                    auto const delta = point - fraction;
+                    float const distance = glm::dot(delta, delta);
+                    f2 = std::min(f2, std::max(f1, distance));
+                    f1 = std::min(f1, distance);
+                }
+            }
+        }
+        return glm::vec2{std::sqrt(f1), std::sqrt(f2)};
+    }
+
+    //======================================================================================================================
+
+    std::shared_ptr<AS::Texture> PerlinVolume(VolumeParams const & params)
+    {
+        MFA_ASSERT(params.frequency > 0);
+        LatticeCache cache{params.seed};
+        auto const octaves = MakeOctaves(
+            GainWeights(params.octaves, params.gain),
+            params.frequency,
+            [&cache](int const period) { return cache.Gradients(period); }
+        );
+
+        return BakeVolume(
+            Format::UNCOMPRESSED_UNORM_R8_LINEAR,
+            params.resolution,
+            1,
+            0,
+            [&](uint32_t const y, uint32_t const z, float * rows)->void
+            {
+                PerlinRow(octaves, params.resolution, y, z, rows);
+                for (uint32_t x = 0; x < params.resolution; x += PacketSize)
+                {
+                    Store(Load(rows + x) * Set(0.5f) + Set(0.5f), rows + x);
+                }
+            }
+        );
+    }
+
+    //======================================================================================================================
+
+    std::shared_ptr<AS::Texture> WorleyVolume(VolumeParams const & params, WorleyFeature const feature)
+    {
+        MFA_ASSERT(params.frequency > 0);
+        LatticeCache cache{params.seed};
+        auto const octaves = MakeOctaves(
+            GainWeights(params.octaves, params.gain),
+            params.frequency,
+            [&cache](int const period) { return cache.FeaturePoints(period); }
+        );
+
+        return BakeVolume(
+            Format::UNCOMPRESSED_UNORM_R8_LINEAR,
+            params.resolution,
+            1,
+            0,
+            [&](uint32_t const y, uint32_t const z, float * rows)->void
+            {
+                WorleyRow(octaves, feature, params.resolution, y, z, rows);
+            }
+        );
+    }
+
+    //======================================================================================================================
+
+    std::shared_ptr<AS::Texture> PerlinWorleyVolume(VolumeParams const & params)
+    {
+        MFA_ASSERT(params.frequency > 0);
+        LatticeCache cache{params.seed};
+        auto const perlinOctaves = MakeOctaves(
+            GainWeights(params.octaves, params.gain),
+            params.frequency,
+            [&cache](int const period) { return cache.Gradients(period); }
+        );
+        auto const worleyOctaves = MakeOctaves(
+            CloudWorleyWeights,
+            params.frequency,
+            [&cache](int const period) { return cache.FeaturePoints(period); }
+        );
+
+        auto const rowLength = PaddedLength(params.resolution);
+        return BakeVolume(
+            Format::UNCOMPRESSED_UNORM_R8_LINEAR,
+            params.resolution,
+            1,
+            1,
+            [&](uint32_t const y, uint32_t const z, float * rows)->void
+            {
+                PerlinWorleyRow(perlinOctaves, worleyOctaves, params.resolution, y, z, rows + rowLength, rows);
+            }
+        );
+    }
+
+    //======================================================================================================================
+
+    std::shared_ptr<AS::Texture> CloudShapeVolume(uint32_t const resolution, uint32_t const seed)
+    {
+        static constexpr int BaseFrequency = 4;
+        static constexpr int MaxPerlinOctaves = 7;
+
+        LatticeCache cache{seed};
+        auto const getGradients = [&cache](int const period) { return cache.Gradients(period); };
+        auto const getFeaturePoints = [&cache](int const period) { return cache.FeaturePoints(period); };
+
+        auto const perlinOctaves = MakeOctaves(
+            GainWeights(UsefulOctaveCount(resolution, BaseFrequency, MaxPerlinOctaves), 0.5f),
+            BaseFrequency,
+            getGradients
+        );
+        std::vector<Octave> worleyOctaves[4] {
+            MakeOctaves(CloudWorleyWeights, BaseFrequency, getFeaturePoints),
+            MakeOctaves(CloudWorleyWeights, BaseFrequency * 2, getFeaturePoints),
+            MakeOctaves(CloudWorleyWeights, BaseFrequency * 4, getFeaturePoints),
+            MakeOctaves(CloudWorleyWeights, BaseFrequency * 8, getFeaturePoints),
+        };
+
+        auto const rowLength = PaddedLength(resolution);
+        return BakeVolume(
+            Format::UNCOMPRESSED_UNORM_R8G8B8A8_LINEAR,
+            resolution,
+            4,
+            1,
+            [&](uint32_t const y, uint32_t const z, float * rows)->void
+            {
+                PerlinWorleyRow(perlinOctaves, worleyOctaves[0], resolution, y, z, rows + rowLength * 4, rows);
+                for (int channel = 1; channel < 4; ++channel)
+                {
+                    WorleyRow(worleyOctaves[channel], WorleyFeature::F1, resolution, y, z, rows + rowLength * channel);
+                }
+            }
+        );
+    }
+
+    //======================================================================================================================
+
+    std::shared_ptr<AS::Texture> CloudDetailVolume(uint32_t const resolution, uint32_t const seed)
+    {
+        static constexpr int BaseFrequency = 2;
+
+        LatticeCache cache{seed};
+        auto const getFeaturePoints = [&cache](int const period) { return cache.FeaturePoints(period); };
+        std::vector<Octave> worleyOctaves[3] {
+            MakeOctaves(CloudWorleyWeights, BaseFrequency, getFeaturePoints),
+            MakeOctaves(CloudWorleyWeights, BaseFrequency * 2, getFeaturePoints),
+            MakeOctaves(CloudWorleyWeights, BaseFrequency * 4, getFeaturePoints),
+        };
+
+        auto const rowLength = PaddedLength(resolution);
+        return BakeVolume(
+            Format::UNCOMPRESSED_UNORM_R8G8B8A8_LINEAR,
+            resolution,
+            4,
+            0,
+            [&](uint32_t const y, uint32_t const z, float * rows)->void
+            {
+                for (int channel = 0; channel < 3; ++channel)
+                {
+                    WorleyRow(worleyOctaves[channel], WorleyFeature::F1, resolution, y, z, rows + rowLength * channel);
+                }
+                for (uint32_t x = 0; x < resolution; x += PacketSize)
+                {
+                    Float4 const detail = Load(rows + x) * Set(CloudWorleyWeights[0]) +
+                        Load(rows + rowLength + x) * Set(CloudWorleyWeights[1]) +
+                        Load(rows + rowLength * 2 + x) * Set(CloudWorleyWeights[2]);
+                    Store(detail, rows + rowLength * 3 + x);
+                }
+            }
+        );
+    }
+
+    //======================================================================================================================
+
+    std::shared_ptr<AS::Texture> LoadOrBakeVolume(
+        std::string const & path,
+        Format const format,
+        uint32_t const resolution,
+        std::function<std::shared_ptr<AS::Texture>()> const & bake
+    )
+    {
+        if (std::filesystem::exists(path))
+        {
+            auto texture = Importer::KtxImage(path);
+            if (texture != nullptr)
+            {
+                auto const & dimension = texture->GetMipmapDimension(0);
+                if (texture->GetFormat() == format &&
+                    texture->GetMipCount() == 1 &&
+                    dimension.width == resolution &&
+                    dimension.height == resolution &&
+                    dimension.depth == resolution)
+                {
+                    return texture;
+                }
+            }
+            MFA_LOG_WARN("%s does not hold the expected volume, Baking it again", path.c_str());
+        }
+
+        auto texture = bake();
+        MFA_ASSERT(texture != nullptr);
+        if (AS::KTX::Write(path, *texture) == false)
+        {
+            MFA_LOG_WARN("Failed to save the volume into %s", path.c_str());
+        }
+        return texture;
+    }
+
+    //======================================================================================================================
+
+    static std::string VolumePath(
+        std::string const & directory,
+        char const * name,
+        uint32_t const resolution,
+        uint32_t const seed
+    )
+    {
+        auto const fileName = std::string(name) + "_" + std::to_string(resolution) + "_seed" + std::to_string(seed) +
+            "_v" + std::to_string(VolumeVersion) + ".ktx2";
+        return (std::filesystem::path(directory) / fileName).string();
+    }
+
+    //======================================================================================================================
+
+    std::shared_ptr<AS::Texture> LoadOrBakeCloudShapeVolume(
+        std::string const & directory,
+        uint32_t const resolution,
+        uint32_t const seed
+    )
+    {
+        return LoadOrBakeVolume(
+            VolumePath(directory, "cloud_shape", resolution, seed),
+            Format::UNCOMPRESSED_UNORM_R8G8B8A8_LINEAR,
+            resolution,
+            [resolution, seed]()->std::shared_ptr<AS::Texture>
+            {
+                return CloudShapeVolume(resolution, seed);
+            }
+        );
+    }
+
+    //======================================================================================================================
+
+    std::shared_ptr<AS::Texture> LoadOrBakeCloudDetailVolume(
+        std::string const & directory,
+        uint32_t const resolution,
+        uint32_t const seed
+    )
+    {
+        return LoadOrBakeVolume(
+            VolumePath(directory, "cloud_detail", resolution, seed),
+            Format::UNCOMPRESSED_UNORM_R8G8B8A8_LINEAR,
+            resolution,
+            [resolution, seed]()->std::shared_ptr<AS::Texture>
+            {
+                return CloudDetailVolume(resolution, seed);
+            }
+        );
+    }
+
+    //======================================================================================================================
+}
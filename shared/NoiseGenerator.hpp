@@ -0,0 +1,96 @@
+#pragma once
+
+#include "AssetTexture.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+// Tileable noise for the cloud volumes. Positions are in lattice cells and every function repeats after `period`
+// cells on each axis, So a volume that covers exactly one period wraps around without a seam.
+// The volumes are baked slice by slice on the job system, Four voxels of a row at a time.
+namespace NoiseGenerator
+{
+    // Roughly in [-1, 1]
+    [[nodiscard]]
+    float Perlin(glm::vec3 const & position, int period, uint32_t seed);
+
+    // Distance to the closest (x) and the second closest (y) feature point, In cells
+    [[nodiscard]]
+    glm::vec2 Worley(glm::vec3 const & position, int period, uint32_t seed);
+
+    struct VolumeParams
+    {
+        uint32_t resolution = 128;
+        // Lattice cells across the volume in the first octave
+        int frequency = 4;
+        // Each octave doubles the frequency, So the volume still tiles
+        int octaves = 1;
+        // Amplitude of an octave relative to the previous one
+        float gain = 0.5f;
+        uint32_t seed = 0;
+    };
+
+    enum class WorleyFeature
+    {
+        F1,
+        F2,
+        F2MinusF1
+    };
+
+    // The volumes are resolution^3 voxels with a single mip level and linear values
+
+    // R8, The fbm is mapped from [-1, 1] to [0, 1]
+    [[nodiscard]]
+    std::shared_ptr<MFA::AS::Texture> PerlinVolume(VolumeParams const & params);
+
+    // R8, Inverted so the cells are bright and the borders between them are dark
+    [[nodiscard]]
+    std::shared_ptr<MFA::AS::Texture> WorleyVolume(VolumeParams const & params, WorleyFeature feature);
+
+    // R8, Billowy perlin fbm remapped by three octaves of worley noise. Octaves and gain only apply to the perlin part.
+    [[nodiscard]]
+    std::shared_ptr<MFA::AS::Texture> PerlinWorleyVolume(VolumeParams const & params);
+
+    // Rgba8 base shape of the clouds: Perlin-Worley in red and worley fbm with 2, 4 and 8 times the frequency
+    // in green, blue and alpha
+    [[nodiscard]]
+    std::shared_ptr<MFA::AS::Texture> CloudShapeVolume(uint32_t resolution = 128, uint32_t seed = 0);
+
+    // Rgba8 erosion detail: Worley fbm with increasing frequency in red, green and blue and their weighted sum in alpha
+    [[nodiscard]]
+    std::shared_ptr<MFA::AS::Texture> CloudDetailVolume(uint32_t resolution = 32, uint32_t seed = 0);
+
+    // Bump whenever a volume function changes, So volumes that were saved by an older version are baked again
+    static constexpr uint32_t VolumeVersion = 1;
+
+    // Reads the volume from the ktx2 file at path, Or bakes it and saves it there so the next run only reads it.
+    // Files that cannot be read or that hold another format or size are baked again.
+    [[nodiscard]]
+    std::shared_ptr<MFA::AS::Texture> LoadOrBakeVolume(
+        std::string const & path,
+        MFA::AS::Texture::Format format,
+        uint32_t resolution,
+        std::function<std::shared_ptr<MFA::AS::Texture>()> const & bake
+    );
+
+    // Cloud volumes saved in directory, The file names hold the resolution, The seed and VolumeVersion
+
+    [[nodiscard]]
+    std::shared_ptr<MFA::AS::Texture> LoadOrBakeCloudShapeVolume(
+        std::string const & directory,
+        uint32_t resolution = 128,
+        uint32_t seed = 0
+    );
+
+    [[nodiscard]]
+    std::shared_ptr<MFA::AS::Texture> LoadOrBakeCloudDetailVolume(
+        std::string const & directory,
+        uint32_t resolution = 32,
+        uint32_t seed = 0
+    );
+
+}
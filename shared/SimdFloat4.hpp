@@ -0,0 +1,143 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MFA_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+// Four floats that are processed together, For code that evaluates packets of voxels or rays.
+// Uses SSE2 when the compiler targets it and plain loops otherwise, So the results are the same on every platform.
+namespace Simd
+{
+    static constexpr int LaneCount = 4;
+
+#ifdef MFA_SIMD_SSE2
+
+    struct Float4
+    {
+        __m128 value;
+    };
+
+    // All bits of a lane are set when the lane is true
+    struct Mask4
+    {
+        __m128 value;
+    };
+
+    inline Float4 Load(float const * values) { return Float4{_mm_loadu_ps(values)}; }
+    inline Float4 Set(float const value) { return Float4{_mm_set1_ps(value)}; }
+    inline void Store(Float4 const & values, float * output) { _mm_storeu_ps(output, values.value); }
+
+    inline Float4 operator + (Float4 const & a, Float4 const & b) { return Float4{_mm_add_ps(a.value, b.value)}; }
+    inline Float4 operator - (Float4 const & a, Float4 const & b) { return Float4{_mm_sub_ps(a.value, b.value)}; }
+    inline Float4 operator * (Float4 const & a, Float4 const & b) { return Float4{_mm_mul_ps(a.value, b.value)}; }
+    inline Float4 operator / (Float4 const & a, Float4 const & b) { return Float4{_mm_div_ps(a.value, b.value)}; }
+    inline Float4 Min(Float4 const & a, Float4 const & b) { return Float4{_mm_min_ps(a.value, b.value)}; }
+    inline Float4 Max(Float4 const & a, Float4 const & b) { return Float4{_mm_max_ps(a.value, b.value)}; }
+    inline Float4 Sqrt(Float4 const & a) { return Float4{_mm_sqrt_ps(a.value)}; }
+    inline Float4 Abs(Float4 const & a) { return Float4{_mm_andnot_ps(_mm_set1_ps(-0.0f), a.value)}; }
+
+    inline Mask4 operator < (Float4 const & a, Float4 const & b) { return Mask4{_mm_cmplt_ps(a.value, b.value)}; }
+    inline Mask4 operator > (Float4 const & a, Float4 const & b) { return Mask4{_mm_cmpgt_ps(a.value, b.value)}; }
+    inline Mask4 operator & (Mask4 const & a, Mask4 const & b) { return Mask4{_mm_and_ps(a.value, b.value)}; }
+    inline Mask4 operator | (Mask4 const & a, Mask4 const & b) { return Mask4{_mm_or_ps(a.value, b.value)}; }
+
+    // Bit i is set when lane i is true
+    inline int MoveMask(Mask4 const & mask) { return _mm_movemask_ps(mask.value); }
+
+    // Lanes of a where the mask is true and lanes of b elsewhere
+    inline Float4 Select(Mask4 const & mask, Float4 const & a, Float4 const & b)
+    {
+        return Float4{_mm_or_ps(_mm_and_ps(mask.value, a.value), _mm_andnot_ps(mask.value, b.value))};
+    }
+
+#else
+
+    struct Float4
+    {
+        float value[LaneCount];
+    };
+
+    struct Mask4
+    {
+        bool value[LaneCount];
+    };
+
+    template <typename Function>
+    Float4 PerLane(Function const & function)
+    {
+        Float4 result{};
+        for (int lane = 0; lane < LaneCount; ++lane)
+        {
+            result.value[lane] = function(lane);
+        }
+        return result;
+    }
+
+    template <typename Function>
+    Mask4 PerLaneMask(Function const & function)
+    {
+        Mask4 result{};
+        for (int lane = 0; lane < LaneCount; ++lane)
+        {
+            result.value[lane] = function(lane);
+        }
+        return result;
+    }
+
+    inline Float4 Load(float const * values) { return PerLane([&](int const i) { return values[i]; }); }
+    inline Float4 Set(float const value) { return PerLane([&](int) { return value; }); }
+    inline void Store(Float4 const & values, float * output) { std::copy_n(values.value, LaneCount, output); }
+
+    inline Float4 operator + (Float4 const & a, Float4 const & b) { return PerLane([&](int const i) { return a.value[i] + b.value[i]; }); }
+    inline Float4 operator - (Float4 const & a, Float4 const & b) { return PerLane([&](int const i) { return a.value[i] - b.value[i]; }); }
+    inline Float4 operator * (Float4 const & a, Float4 const & b) { return PerLane([&](int const i) { return a.value[i] * b.value[i]; }); }
+    inline Float4 operator / (Float4 const & a, Float4 const & b) { return PerLane([&](int const i) { return a.value[i] / b.value[i]; }); }
+    inline Float4 Min(Float4 const & a, Float4 const & b) { return PerLane([&](int const i) { return std::min(a.value[i], b.value[i]); }); }
+    inline Float4 Max(Float4 const & a, Float4 const & b) { return PerLane([&](int const i) { return std::max(a.value[i], b.value[i]); }); }
+    inline Float4 Sqrt(Float4 const & a) { return PerLane([&](int const i) { return std::sqrt(a.value[i]); }); }
+    inline Float4 Abs(Float4 const & a) { return PerLane([&](int const i) { return std::abs(a.value[i]); }); }
+
+    inline Mask4 operator < (Float4 const & a, Float4 const & b) { return PerLaneMask([&](int const i) { return a.value[i] < b.value[i]; }); }
+    inline Mask4 operator > (Float4 const & a, Float4 const & b) { return PerLaneMask([&](int const i) { return a.value[i] > b.value[i]; }); }
+    inline Mask4 operator & (Mask4 const & a, Mask4 const & b) { return PerLaneMask([&](int const i) { return a.value[i] && b.value[i]; }); }
+    inline Mask4 operator | (Mask4 const & a, Mask4 const & b) { return PerLaneMask([&](int const i) { return a.value[i] || b.value[i]; }); }
+
+    inline int MoveMask(Mask4 const & mask)
+    {
+        int bits = 0;
+        for (int lane = 0; lane < LaneCount; ++lane)
+        {
+            bits |= mask.value[lane] ? 1 << lane : 0;
+        }
+        return bits;
+    }
+
+    inline Float4 Select(Mask4 const & mask, Float4 const & a, Float4 const & b)
+    {
+        return PerLane([&](int const i) { return mask.value[i] ? a.value[i] : b.value[i]; });
+    }
+
+#endif
+
+    inline Float4 Lerp(Float4 const & a, Float4 const & b, Float4 const & t)
+    {
+        return a + (b - a) * t;
+    }
+
+    // There is no vector exp in SSE2, So it goes through the lanes one by one
+    inline Float4 Exp(Float4 const & a)
+    {
+        alignas(16) float values[LaneCount];
+        Store(a, values);
+        for (auto & value : values)
+        {
+            value = std::exp(value);
+        }
+        return Load(values);
+    }
+
+}
@@ -0,0 +1,265 @@
+#include "TestUtils.hpp"
+
+#include "AssetGLTF_Animation.hpp"
+#include "AssetGLTF_Mesh.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace MFA;
+using namespace MFA::Asset::GLTF;
+
+// Keyframe sampling against reference formulas, The node transforms and palettes of AnimationBatch and the checks
+// that keep invalid node, Joint and sampler indices from being read.
+
+namespace
+{
+    bool IsNear(glm::vec4 const & lhs, glm::vec4 const & rhs, float const epsilon = 1e-5f)
+    {
+        return glm::all(glm::lessThanEqual(glm::abs(lhs - rhs), glm::vec4{epsilon}));
+    }
+
+    bool IsNear(glm::mat4 const & lhs, glm::mat4 const & rhs, float const epsilon = 1e-5f)
+    {
+        for (int column = 0; column < 4; ++column)
+        {
+            if (IsNear(lhs[column], rhs[column], epsilon) == false)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    Animation::Sampler::InputAndOutput Key(float const time, glm::vec4 const & value)
+    {
+        Animation::Sampler::InputAndOutput key{.input = time};
+        for (int i = 0; i < 4; ++i)
+        {
+            key.output[i] = value[i];
+        }
+        return key;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Root with one child, The child is the only joint of the skin
+    std::shared_ptr<MeshData> CreateRig()
+    {
+        auto meshData = std::make_shared<MeshData>();
+        meshData->nodes.emplace_back(meshData->transformStore).children = {1};
+        meshData->nodes.emplace_back(meshData->transformStore);
+        auto & child = meshData->nodes[1];
+        child.parent = 0;
+        child.transform.SetLocalPosition(glm::vec3{0.0f, 2.0f, 0.0f});
+
+        auto & skin = meshData->skins.emplace_back();
+        skin.joints = {1};
+        skin.inverseBindMatrices = {glm::translate(glm::mat4{1.0f}, glm::vec3{0.0f, -2.0f, 0.0f})};
+        return meshData;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestLinearAndStep()
+    {
+        Animation animation{.name = "Walk"};
+        animation.samplers.resize(2);
+        animation.samplers[0].interpolation = Animation::Interpolation::Linear;
+        animation.samplers[0].inputAndOutput = {Key(0.0f, glm::vec4{0.0f}), Key(1.0f, glm::vec4{2.0f}), Key(3.0f, glm::vec4{6.0f})};
+        animation.samplers[1].interpolation = Animation::Interpolation::Step;
+        animation.samplers[1].inputAndOutput = animation.samplers[0].inputAndOutput;
+        animation.channels = {
+            {.path = Animation::Path::Translation, .nodeIndex = 0, .samplerIndex = 0},
+            {.path = Animation::Path::Scale, .nodeIndex = 0, .samplerIndex = 1},
+        };
+        animation.startTime = 0.0f;
+        animation.endTime = 3.0f;
+
+        AnimationClip const clip{animation, 1};
+        MFA_TEST_CHECK(clip.GetTracks().size() == 2);
+        MFA_TEST_CHECK(clip.GetDuration() == 3.0f);
+
+        // Forward, Then back to the start, Then past the end
+        uint32_t linearCursor = 0;
+        uint32_t stepCursor = 0;
+        float const times[] {0.5f, 1.0f, 2.0f, 2.5f, 0.25f, 4.0f};
+        float const linearValues[] {1.0f, 2.0f, 4.0f, 5.0f, 0.5f, 6.0f};
+        float const stepValues[] {0.0f, 2.0f, 2.0f, 2.0f, 0.0f, 6.0f};
+        for (int i = 0; i < 6; ++i)
+        {
+            MFA_TEST_CHECK(IsNear(clip.Sample(0, times[i], linearCursor), glm::vec4{linearValues[i]}));
+            MFA_TEST_CHECK(IsNear(clip.Sample(1, times[i], stepCursor), glm::vec4{stepValues[i]}));
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // p(t) = (2t^3 - 3t^2 + 1) v0 + (t^3 - 2t^2 + t) d b0 + (-2t^3 + 3t^2) v1 + (t^3 - t^2) d a1 from the GLTF spec,
+    // d is the time between the keys. The first value is 0, So its term is left out.
+    void TestCubicSpline()
+    {
+        Animation animation{.name = "Bounce"};
+        auto & sampler = animation.samplers.emplace_back();
+        sampler.interpolation = Animation::Interpolation::CubicSpline;
+        auto first = Key(0.0f, glm::vec4{0.0f});
+        first.outTangent[0] = 1.0f;
+        first.outTangent[1] = -3.0f;
+        auto second = Key(2.0f, glm::vec4{1.0f, 1.0f, 0.0f, 0.0f});
+        second.inTangent[0] = 0.0f;
+        second.inTangent[1] = 2.0f;
+        sampler.inputAndOutput = {first, second};
+        animation.channels = {{.path = Animation::Path::Translation, .nodeIndex = 0, .samplerIndex = 0}};
+        animation.startTime = 0.0f;
+        animation.endTime = 2.0f;
+
+        AnimationClip const clip{animation, 1};
+        uint32_t cursor = 0;
+        for (float const time : {0.0f, 0.5f, 1.0f, 1.5f, 2.0f})
+        {
+            float const t = time / 2.0f;
+            float const h10 = t * t * t - 2.0f * t * t + t;
+            float const h01 = -2.0f * t * t * t + 3.0f * t * t;
+            float const h11 = t * t * t - t * t;
+            glm::vec4 const expected {
+                h10 * 2.0f * 1.0f + h01 * 1.0f,
+                h10 * 2.0f * -3.0f + h01 * 1.0f + h11 * 2.0f * 2.0f,
+                0.0f,
+                0.0f
+            };
+            MFA_TEST_CHECK(IsNear(clip.Sample(0, time, cursor), expected));
+        }
+        // Half way with an out tangent of 1 over a 2 second key, 0.125 * 2 + 0.5
+        MFA_TEST_CHECK(std::abs(clip.Sample(0, 1.0f, cursor).x - 0.75f) < 1e-5f);
+
+        // Rotations stay unit quaternions
+        Animation rotation{.name = "Turn"};
+        auto & rotationSampler = rotation.samplers.emplace_back();
+        rotationSampler.interpolation = Animation::Interpolation::CubicSpline;
+        rotationSampler.inputAndOutput = {Key(0.0f, glm::vec4{0.0f, 0.0f, 0.0f, 1.0f}), Key(1.0f, glm::vec4{0.0f, 1.0f, 0.0f, 0.0f})};
+        rotation.channels = {{.path = Animation::Path::Rotation, .nodeIndex = 0, .samplerIndex = 0}};
+        AnimationClip const rotationClip{rotation, 1};
+        cursor = 0;
+        MFA_TEST_CHECK(std::abs(glm::length(rotationClip.Sample(0, 0.3f, cursor)) - 1.0f) < 1e-5f);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestInvalidIndicesAreDropped()
+    {
+        Animation animation{.name = "Broken"};
+        animation.samplers.emplace_back().inputAndOutput = {Key(0.0f, glm::vec4{1.0f})};
+        animation.channels = {
+            {.path = Animation::Path::Translation, .nodeIndex = 5, .samplerIndex = 0},
+            {.path = Animation::Path::Translation, .nodeIndex = 0, .samplerIndex = 3},
+            {.path = Animation::Path::Scale, .nodeIndex = 1, .samplerIndex = 0},
+        };
+        AnimationClip const clip{animation, 2};
+        MFA_TEST_CHECK(clip.GetTracks().size() == 1 && clip.GetTracks()[0].nodeIndex == 1);
+
+        // A joint that points past the nodes keeps an identity matrix, A child that does not exist is skipped
+        auto meshData = CreateRig();
+        meshData->skins[0].joints.emplace_back(7);
+        meshData->nodes[0].children.emplace_back(9);
+        meshData->animations.emplace_back(animation);
+        AnimationBatch batch{meshData};
+        auto const instance = batch.AddInstance();
+        batch.SetLayer(instance, 0, AnimationBatch::Layer{.clipIndex = 0});
+        batch.Update(0.1f);
+        MFA_TEST_CHECK(batch.GetJointCount() == 2);
+        MFA_TEST_CHECK(IsNear(batch.GetJointPalette(instance, 0)[1], glm::mat4{1.0f}));
+
+        // Influences of joints that are not in the palette are ignored
+        Vertex vertex{};
+        vertex.position = glm::vec3{1.0f, 2.0f, 3.0f};
+        vertex.hasSkin = 1;
+        vertex.jointIndices[0] = 0;
+        vertex.jointWeights[0] = 1.0f;
+        vertex.jointIndices[1] = 9;
+        vertex.jointWeights[1] = 1.0f;
+        vertex.jointIndices[2] = -1;
+        vertex.jointWeights[2] = 1.0f;
+        glm::vec3 position{};
+        glm::mat4 const palette{1.0f};
+        AnimationBatch::SkinVertices(&palette, 1, &vertex, 1, &position);
+        MFA_TEST_CHECK(IsNear(glm::vec4{position, 0.0f}, glm::vec4{1.0f, 2.0f, 3.0f, 0.0f}));
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestBatchTransformsAndBlending()
+    {
+        auto meshData = CreateRig();
+        Animation lift{.name = "Lift", .startTime = 0.0f, .endTime = 1.0f};
+        lift.samplers.emplace_back().inputAndOutput = {Key(0.0f, glm::vec4{0.0f}), Key(1.0f, glm::vec4{0.0f, 0.0f, 4.0f, 0.0f})};
+        lift.samplers[0].interpolation = Animation::Interpolation::Linear;
+        lift.channels = {{.path = Animation::Path::Translation, .nodeIndex = 0, .samplerIndex = 0}};
+        meshData->animations.emplace_back(lift);
+
+        Animation turn{.name = "Turn", .startTime = 0.0f, .endTime = 1.0f};
+        auto const quarter = glm::angleAxis(glm::radians(90.0f), glm::vec3{0.0f, 0.0f, 1.0f});
+        turn.samplers.emplace_back().inputAndOutput = {
+            Key(0.0f, glm::vec4{quarter.x, quarter.y, quarter.z, quarter.w}),
+            Key(1.0f, glm::vec4{quarter.x, quarter.y, quarter.z, quarter.w})
+        };
+        turn.samplers[0].interpolation = Animation::Interpolation::Linear;
+        turn.channels = {{.path = Animation::Path::Rotation, .nodeIndex = 0, .samplerIndex = 0}};
+        meshData->animations.emplace_back(turn);
+
+        AnimationBatch batch{meshData};
+        MFA_TEST_CHECK(batch.FindClip("Turn") == 1 && batch.FindClip("Jump") == -1);
+        auto const instance = batch.AddInstance();
+
+        // Rest pose, The skinned child is where its inverse bind matrix expects it
+        MFA_TEST_CHECK(IsNear(batch.GetJointPalette(instance, 0)[0], glm::mat4{1.0f}));
+
+        batch.SetLayer(instance, 0, AnimationBatch::Layer{.clipIndex = 0, .loop = false});
+        batch.Update(0.5f);
+        glm::mat4 const lifted = glm::translate(glm::mat4{1.0f}, glm::vec3{0.0f, 0.0f, 2.0f});
+        MFA_TEST_CHECK(IsNear(batch.GetNodeTransforms(instance)[0], lifted));
+        MFA_TEST_CHECK(IsNear(batch.GetNodeTransforms(instance)[1], lifted * glm::translate(glm::mat4{1.0f}, glm::vec3{0.0f, 2.0f, 0.0f})));
+        MFA_TEST_CHECK(IsNear(batch.GetJointPalette(instance, 0)[0], lifted));
+
+        // Without looping the time stops at the end of the clip
+        batch.Update(2.0f);
+        MFA_TEST_CHECK(batch.GetLayer(instance, 0).time == 1.0f);
+
+        // The second layer blends its whole pose, So half of the turn also pulls the lift half way back to the rest pose
+        batch.SetLayer(instance, 1, AnimationBatch::Layer{.clipIndex = 1, .weight = 0.5f});
+        batch.Update(0.0f);
+        auto const eighth = glm::angleAxis(glm::radians(45.0f), glm::vec3{0.0f, 0.0f, 1.0f});
+        glm::mat4 const expected = glm::translate(glm::mat4{1.0f}, glm::vec3{0.0f, 0.0f, 2.0f}) * glm::mat4_cast(eighth);
+        MFA_TEST_CHECK(IsNear(batch.GetNodeTransforms(instance)[0], expected));
+
+        // Skinning follows the palette
+        Vertex vertex{};
+        vertex.position = glm::vec3{0.0f, 2.0f, 0.0f};
+        vertex.normal = glm::vec3{0.0f, 1.0f, 0.0f};
+        vertex.hasSkin = 1;
+        vertex.jointWeights[0] = 1.0f;
+        glm::vec3 position{};
+        glm::vec3 normal{};
+        batch.SkinVertices(instance, 0, &vertex, 1, &position, &normal);
+        auto const palette = batch.GetJointPalette(instance, 0)[0];
+        MFA_TEST_CHECK(IsNear(glm::vec4{position, 1.0f}, palette * glm::vec4{0.0f, 2.0f, 0.0f, 1.0f}));
+        MFA_TEST_CHECK(IsNear(glm::vec4{normal, 0.0f}, glm::normalize(palette * glm::vec4{0.0f, 1.0f, 0.0f, 0.0f})));
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main()
+{
+    TestLinearAndStep();
+    TestCubicSpline();
+    TestInvalidIndicesAreDropped();
+    TestBatchTransformsAndBlending();
+
+    return Test::Result();
+}
@@ -0,0 +1,110 @@
+#include "TestUtils.hpp"
+
+#include "BedrockCommon.hpp"
+#include "CloudRayMarcher.hpp"
+#include "JobSystem.hpp"
+#include "NoiseGenerator.hpp"
+
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace MFA;
+
+// Renders the reference view and compares it with the golden image in data/. Small volumes keep the bake short.
+// Run with --update to write a new golden image after an intended change to the look of the clouds.
+
+namespace
+{
+    static constexpr uint32_t Width = 96;
+    static constexpr uint32_t Height = 72;
+    // Rounding differences between compilers and instruction sets move single pixels by a few levels at most
+    static constexpr int MaxPixelDifference = 8;
+    static constexpr double MaxMeanDifference = 0.5;
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::string GoldenPath()
+    {
+        return std::string(TO_LITERAL(MFA_TEST_DATA_DIR)) + "/CloudRayMarcherGolden.png";
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    CloudRayMarcher::Image Render(CloudRayMarcher::Stats & outStats)
+    {
+        CloudRayMarcher const marcher{NoiseGenerator::CloudShapeVolume(32, 0), NoiseGenerator::CloudDetailVolume(16, 0)};
+        return marcher.Render(
+            CloudRayMarcher::LookAtView(glm::vec3{20.0f, 20.0f, 20.0f}, glm::vec3{}, Width, Height),
+            CloudRayMarcher::Params{},
+            &outStats
+        );
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void CompareWithGolden(CloudRayMarcher::Image const & image)
+    {
+        int width = 0;
+        int height = 0;
+        int components = 0;
+        auto * golden = stbi_load(GoldenPath().c_str(), &width, &height, &components, 4);
+        MFA_TEST_CHECK(golden != nullptr);
+        if (golden == nullptr)
+        {
+            return;
+        }
+        MFA_TEST_CHECK(width == static_cast<int>(image.width) && height == static_cast<int>(image.height));
+        if (width == static_cast<int>(image.width) && height == static_cast<int>(image.height))
+        {
+            int maxDifference = 0;
+            double differenceSum = 0.0;
+            for (size_t i = 0; i < image.pixels.size(); ++i)
+            {
+                int const difference = std::abs(static_cast<int>(image.pixels[i]) - static_cast<int>(golden[i]));
+                maxDifference = std::max(maxDifference, difference);
+                differenceSum += difference;
+            }
+            double const meanDifference = differenceSum / static_cast<double>(image.pixels.size());
+            std::printf("Max difference: %d, Mean difference: %.4f\n", maxDifference, meanDifference);
+            MFA_TEST_CHECK(maxDifference <= MaxPixelDifference);
+            MFA_TEST_CHECK(meanDifference <= MaxMeanDifference);
+        }
+        stbi_image_free(golden);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main(int argc, char ** argv)
+{
+    auto jobSystem = JobSystem::Instantiate();
+
+    CloudRayMarcher::Stats stats{};
+    auto const image = Render(stats);
+
+    // The view has to hit the clouds, Otherwise the comparison says nothing
+    MFA_TEST_CHECK(stats.rayCount == Width * Height);
+    MFA_TEST_CHECK(stats.hitCount > stats.rayCount / 4);
+    MFA_TEST_CHECK(stats.stepCount > 0 && stats.lightSampleCount > 0);
+
+    if (argc > 1 && std::strcmp(argv[1], "--update") == 0)
+    {
+        MFA_TEST_CHECK(CloudRayMarcher::WritePNG(image, GoldenPath()) == true);
+        std::printf("Updated %s\n", GoldenPath().c_str());
+    }
+    else
+    {
+        CompareWithGolden(image);
+    }
+
+    jobSystem.reset();
+    JobSystem::Destroy();
+
+    return Test::Result();
+}
@@ -0,0 +1,353 @@
+#include "TestUtils.hpp"
+
+#include "DisplayListCache.hpp"
+
+#include <cstdint>
+
+using namespace MFA;
+
+// Items of the display list cache against the same primitives that are added to a display list directly. An update
+// that replaces a few items has to replay into the display list that a full recording of the new page gives.
+
+namespace
+{
+    using Type = DisplayList::PrimitiveType;
+    using Key = DisplayListCache::Key;
+
+    struct Instance
+    {
+        float values[4]{};
+    };
+
+    struct TextVertex
+    {
+        float position[2]{};
+        float uv[2]{};
+    };
+
+    // Two fonts and what the display list gets for them, Only their addresses are used
+    int const Fonts[4]{};
+    void const * const FontA = &Fonts[0];
+    void const * const FontB = &Fonts[1];
+    void const * const ResolvedFontA = &Fonts[2];
+    void const * const ResolvedFontB = &Fonts[3];
+
+    void const * Resolve(Type const type, void const * resource)
+    {
+        if (type != Type::Text)
+        {
+            return resource;
+        }
+        return resource == FontA ? ResolvedFontA : ResolvedFontB;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    DisplayList::Bounds Rect(float const x, float const y, float const width, float const height)
+    {
+        return DisplayList::Bounds{.min = glm::vec2{x, y}, .max = glm::vec2{x + width, y + height}};
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Sends the same calls to the cache or straight to a display list, A display list has no items
+    struct Recorder
+    {
+        DisplayListCache * cache = nullptr;
+        DisplayList * displayList = nullptr;
+
+        void BeginItem(Key const key)
+        {
+            if (cache != nullptr)
+            {
+                cache->BeginItem(key);
+            }
+        }
+
+        void EndItem()
+        {
+            if (cache != nullptr)
+            {
+                cache->EndItem();
+            }
+        }
+
+        void Fill(DisplayList::Bounds const & bounds, float const id)
+        {
+            Instance const instance{.values = {id}};
+            if (cache != nullptr)
+            {
+                cache->AddInstance(Type::SolidFill, nullptr, instance, bounds);
+            }
+            else
+            {
+                displayList->AddInstance(Type::SolidFill, nullptr, instance, bounds);
+            }
+        }
+
+        void Text(void const * font, DisplayList::Bounds const & bounds, float const id)
+        {
+            TextVertex vertices[6]{};
+            vertices[0].uv[0] = id;
+            if (cache != nullptr)
+            {
+                cache->AddVertices(Type::Text, font, vertices, 6, bounds);
+            }
+            else
+            {
+                displayList->AddVertices(Type::Text, Resolve(Type::Text, font), vertices, 6, bounds);
+            }
+        }
+    };
+
+    //-------------------------------------------------------------------------------------------------
+
+    // A row of the page with a nested item, The version changes what the row draws
+    void DrawRow(Recorder & recorder, uint32_t const row, uint32_t const version)
+    {
+        auto const y = static_cast<float>(row) * 40.0f;
+        recorder.BeginItem(row * 10 + 1);
+        recorder.Fill(Rect(0.0f, y, 200.0f, 30.0f), static_cast<float>(row * 100 + version));
+        for (uint32_t i = 0; i <= version % 3; ++i)
+        {
+            recorder.Text(i % 2 == 0 ? FontA : FontB, Rect(10.0f + static_cast<float>(i) * 30.0f, y, 20.0f, 20.0f),
+                static_cast<float>(version));
+        }
+        recorder.BeginItem(row * 10 + 2);
+        recorder.Fill(Rect(150.0f, y + 5.0f, 20.0f, 20.0f), static_cast<float>(version));
+        recorder.EndItem();
+        recorder.EndItem();
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void DrawPage(Recorder & recorder, uint32_t const (& versions)[4])
+    {
+        // Background that belongs to no item
+        recorder.Fill(Rect(0.0f, 0.0f, 400.0f, 400.0f), -1.0f);
+        for (uint32_t row = 0; row < 4; ++row)
+        {
+            DrawRow(recorder, row, versions[row]);
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void Replay(DisplayListCache & cache, DisplayList & displayList)
+    {
+        displayList.Begin();
+        cache.Replay(displayList, Resolve);
+        displayList.End();
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    DisplayList Direct(uint32_t const (& versions)[4])
+    {
+        DisplayList displayList{};
+        Recorder recorder{.displayList = &displayList};
+        displayList.Begin();
+        DrawPage(recorder, versions);
+        displayList.End();
+        return displayList;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool IsSame(DisplayList const & lhs, DisplayList const & rhs)
+    {
+        for (size_t i = 0; i < DisplayList::PrimitiveTypeCount; ++i)
+        {
+            if (lhs.GetArena(static_cast<Type>(i)) != rhs.GetArena(static_cast<Type>(i)))
+            {
+                return false;
+            }
+        }
+        auto const & lhsBatches = lhs.GetBatches();
+        auto const & rhsBatches = rhs.GetBatches();
+        if (lhsBatches.size() != rhsBatches.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < lhsBatches.size(); ++i)
+        {
+            auto const & lhsBatch = lhsBatches[i];
+            auto const & rhsBatch = rhsBatches[i];
+            if (lhsBatch.type != rhsBatch.type || lhsBatch.resource != rhsBatch.resource ||
+                lhsBatch.drawCount != rhsBatch.drawCount || lhsBatch.bounds.min != rhsBatch.bounds.min ||
+                lhsBatch.bounds.max != rhsBatch.bounds.max)
+            {
+                return false;
+            }
+            auto const lhsDraws = lhs.GetDraws(lhsBatch);
+            auto const rhsDraws = rhs.GetDraws(rhsBatch);
+            for (size_t j = 0; j < lhsDraws.size(); ++j)
+            {
+                if (lhsDraws[j].firstElement != rhsDraws[j].firstElement ||
+                    lhsDraws[j].elementCount != rhsDraws[j].elementCount)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestReplayMatchesDirect()
+    {
+        uint32_t const versions[4]{0, 1, 2, 3};
+
+        DisplayListCache cache{};
+        Recorder recorder{.cache = &cache};
+        cache.Begin();
+        DrawPage(recorder, versions);
+        cache.End();
+
+        DisplayList displayList{};
+        Replay(cache, displayList);
+        MFA_TEST_CHECK(IsSame(displayList, Direct(versions)) == true);
+
+        auto const & stats = cache.GetStats();
+        MFA_TEST_CHECK(stats.itemCount == 8);
+        MFA_TEST_CHECK(stats.primitiveCount == displayList.GetStats().primitiveCount);
+        MFA_TEST_CHECK(stats.byteCount == displayList.GetStats().byteCount);
+        MFA_TEST_CHECK(stats.garbageByteCount == 0);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestUpdateMatchesDirect()
+    {
+        uint32_t versions[4]{0, 0, 0, 0};
+
+        DisplayListCache cache{};
+        Recorder recorder{.cache = &cache};
+        cache.Begin();
+        DrawPage(recorder, versions);
+        cache.End();
+
+        // Rows in the middle and at the end change, The nested items are recorded again with them
+        versions[1] = 2;
+        versions[3] = 4;
+        cache.BeginUpdate();
+        DrawRow(recorder, 1, versions[1]);
+        DrawRow(recorder, 3, versions[3]);
+        MFA_TEST_CHECK(cache.EndUpdate() == true);
+
+        DisplayList displayList{};
+        Replay(cache, displayList);
+        MFA_TEST_CHECK(IsSame(displayList, Direct(versions)) == true);
+        MFA_TEST_CHECK(cache.GetStats().itemCount == 8);
+        MFA_TEST_CHECK(cache.GetStats().primitiveCount == displayList.GetStats().primitiveCount);
+
+        // A nested item can be replaced on its own
+        cache.BeginUpdate();
+        cache.BeginItem(3 * 10 + 2);
+        Recorder{.cache = &cache}.Fill(Rect(150.0f, 125.0f, 20.0f, 20.0f), 7.0f);
+        cache.EndItem();
+        MFA_TEST_CHECK(cache.EndUpdate() == true);
+
+        Replay(cache, displayList);
+        auto const & fills = displayList.GetArena(Type::SolidFill);
+        auto const * instances = reinterpret_cast<Instance const *>(fills.data());
+        auto const fillCount = fills.size() / sizeof(Instance);
+        MFA_TEST_CHECK(fillCount == 9 && instances[fillCount - 1].values[0] == 7.0f);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestMissingKeyFails()
+    {
+        uint32_t const versions[4]{0, 1, 2, 3};
+
+        DisplayListCache cache{};
+        Recorder recorder{.cache = &cache};
+        cache.Begin();
+        DrawPage(recorder, versions);
+        cache.End();
+        auto const stats = cache.GetStats();
+
+        // Row 4 was never recorded, So there is no place for it
+        cache.BeginUpdate();
+        DrawRow(recorder, 4, 0);
+        MFA_TEST_CHECK(cache.EndUpdate() == false);
+
+        // Nothing of the unknown row is kept
+        MFA_TEST_CHECK(cache.GetStats().itemCount == stats.itemCount);
+        MFA_TEST_CHECK(cache.GetStats().primitiveCount == stats.primitiveCount);
+        DisplayList displayList{};
+        Replay(cache, displayList);
+        MFA_TEST_CHECK(IsSame(displayList, Direct(versions)) == true);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestResolverIsCalledOncePerResource()
+    {
+        uint32_t const versions[4]{2, 2, 2, 2};
+
+        DisplayListCache cache{};
+        Recorder recorder{.cache = &cache};
+        cache.Begin();
+        DrawPage(recorder, versions);
+        cache.End();
+
+        int callCount = 0;
+        DisplayList displayList{};
+        displayList.Begin();
+        cache.Replay(displayList, [&callCount](Type const type, void const * resource)->void const *
+        {
+            ++callCount;
+            return Resolve(type, resource);
+        });
+        displayList.End();
+        // Fills without a resource, FontA and FontB
+        MFA_TEST_CHECK(callCount == 3);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestGarbageIsCompacted()
+    {
+        uint32_t versions[4]{0, 0, 0, 0};
+
+        DisplayListCache cache{};
+        Recorder recorder{.cache = &cache};
+        cache.Begin();
+        DrawPage(recorder, versions);
+        cache.End();
+
+        bool isBounded = true;
+        for (uint32_t frame = 1; frame < 50; ++frame)
+        {
+            auto const row = frame % 4;
+            versions[row] = frame;
+            cache.BeginUpdate();
+            DrawRow(recorder, row, versions[row]);
+            MFA_TEST_CHECK(cache.EndUpdate() == true);
+            isBounded &= cache.GetStats().garbageByteCount <= cache.GetStats().byteCount;
+        }
+        MFA_TEST_CHECK(isBounded == true);
+        MFA_TEST_CHECK(cache.GetStats().itemCount == 8);
+
+        DisplayList displayList{};
+        Replay(cache, displayList);
+        MFA_TEST_CHECK(IsSame(displayList, Direct(versions)) == true);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main()
+{
+    TestReplayMatchesDirect();
+    TestUpdateMatchesDirect();
+    TestMissingKeyFails();
+    TestResolverIsCalledOncePerResource();
+    TestGarbageIsCompacted();
+
+    return Test::Result();
+}
@@ -0,0 +1,207 @@
+#include "TestUtils.hpp"
+
+#include "DisplayList.hpp"
+
+#include <cstdint>
+
+using namespace MFA;
+
+// Batches that the display list builds from a stream of primitives, The painter's order of the primitives that
+// overlap and the counters of Stats. The list has no gpu dependency, So the draws are checked as plain ranges.
+
+namespace
+{
+    using Type = DisplayList::PrimitiveType;
+
+    struct Instance
+    {
+        float values[4]{};
+    };
+
+    struct TextVertex
+    {
+        float position[2]{};
+        float uv[2]{};
+    };
+
+    // Two fonts, Only their addresses are used
+    int const Fonts[2]{};
+    void const * const FontA = &Fonts[0];
+    void const * const FontB = &Fonts[1];
+
+    //-------------------------------------------------------------------------------------------------
+
+    DisplayList::Bounds Rect(float const x, float const y, float const width, float const height)
+    {
+        return DisplayList::Bounds{.min = glm::vec2{x, y}, .max = glm::vec2{x + width, y + height}};
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void AddFill(DisplayList & displayList, DisplayList::Bounds const & bounds, float const id)
+    {
+        displayList.AddInstance(Type::SolidFill, nullptr, Instance{.values = {id}}, bounds);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void AddText(DisplayList & displayList, void const * font, DisplayList::Bounds const & bounds)
+    {
+        TextVertex const vertices[6]{};
+        displayList.AddVertices(Type::Text, font, vertices, 6, bounds);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Value that AddFill stored for the element
+    float FillId(DisplayList const & displayList, uint32_t const element)
+    {
+        auto const & arena = displayList.GetArena(Type::SolidFill);
+        return reinterpret_cast<Instance const *>(arena.data())[element].values[0];
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestDisjointPrimitivesMerge()
+    {
+        DisplayList displayList{};
+        displayList.Begin();
+        // Fills and text that take turns but never overlap, A row of labels with their backgrounds next to them
+        for (int i = 0; i < 4; ++i)
+        {
+            auto const x = static_cast<float>(i) * 100.0f;
+            AddFill(displayList, Rect(x, 0.0f, 40.0f, 20.0f), static_cast<float>(i));
+            AddText(displayList, i % 2 == 0 ? FontA : FontB, Rect(x + 50.0f, 0.0f, 40.0f, 20.0f));
+        }
+        displayList.End();
+
+        auto const & batches = displayList.GetBatches();
+        MFA_TEST_CHECK(batches.size() == 3);
+        if (batches.size() != 3)
+        {
+            return;
+        }
+        MFA_TEST_CHECK(batches[0].type == Type::SolidFill && batches[0].drawCount == 4);
+        MFA_TEST_CHECK(batches[1].type == Type::Text && batches[1].resource == FontA && batches[1].drawCount == 2);
+        MFA_TEST_CHECK(batches[2].type == Type::Text && batches[2].resource == FontB && batches[2].drawCount == 2);
+
+        // Draws of a batch keep the order of the calls
+        auto const fills = displayList.GetDraws(batches[0]);
+        bool isInOrder = true;
+        for (uint32_t i = 0; i < fills.size(); ++i)
+        {
+            isInOrder &= fills[i].elementCount == 1 && FillId(displayList, fills[i].firstElement) == static_cast<float>(i);
+        }
+        MFA_TEST_CHECK(isInOrder == true);
+
+        auto const texts = displayList.GetDraws(batches[2]);
+        MFA_TEST_CHECK(texts.size() == 2 && texts[0].firstElement == 6 && texts[1].firstElement == 18);
+        MFA_TEST_CHECK(texts.size() == 2 && texts[0].elementCount == 6);
+
+        MFA_TEST_CHECK(batches[0].bounds.min == glm::vec2(0.0f, 0.0f));
+        MFA_TEST_CHECK(batches[0].bounds.max == glm::vec2(340.0f, 20.0f));
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestOverlapKeepsPainterOrder()
+    {
+        DisplayList displayList{};
+        displayList.Begin();
+        // Background, Text on it and a highlight over the text, The highlight cannot join the background
+        AddFill(displayList, Rect(0.0f, 0.0f, 100.0f, 100.0f), 0.0f);
+        AddText(displayList, FontA, Rect(10.0f, 10.0f, 50.0f, 20.0f));
+        AddFill(displayList, Rect(20.0f, 15.0f, 10.0f, 10.0f), 1.0f);
+        // Only overlaps the background, So it can go back to the first batch
+        AddFill(displayList, Rect(80.0f, 80.0f, 10.0f, 10.0f), 2.0f);
+        displayList.End();
+
+        auto const & batches = displayList.GetBatches();
+        MFA_TEST_CHECK(batches.size() == 3);
+        if (batches.size() != 3)
+        {
+            return;
+        }
+        MFA_TEST_CHECK(batches[0].type == Type::SolidFill && batches[0].drawCount == 1);
+        MFA_TEST_CHECK(batches[1].type == Type::Text);
+        MFA_TEST_CHECK(batches[2].type == Type::SolidFill && batches[2].drawCount == 2);
+
+        auto const background = displayList.GetDraws(batches[0]);
+        auto const highlights = displayList.GetDraws(batches[2]);
+        MFA_TEST_CHECK(background.size() == 1 && FillId(displayList, background[0].firstElement) == 0.0f);
+        MFA_TEST_CHECK(highlights.size() == 2 && FillId(displayList, highlights[0].firstElement) == 1.0f);
+        MFA_TEST_CHECK(highlights.size() == 2 && FillId(displayList, highlights[1].firstElement) == 2.0f);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestLookBackIsBounded()
+    {
+        DisplayList displayList{};
+        displayList.Begin();
+        AddText(displayList, FontA, Rect(0.0f, 0.0f, 10.0f, 10.0f));
+        // Disjoint batches of other resources that push the first batch out of reach
+        for (uint32_t i = 0; i < DisplayList::MaxBatchLookBack; ++i)
+        {
+            displayList.AddInstance(
+                Type::Image,
+                reinterpret_cast<void const *>(static_cast<uintptr_t>(i + 1)),
+                Instance{},
+                Rect(static_cast<float>(i + 1) * 20.0f, 0.0f, 10.0f, 10.0f)
+            );
+        }
+        AddText(displayList, FontA, Rect(0.0f, 50.0f, 10.0f, 10.0f));
+        displayList.End();
+
+        auto const & batches = displayList.GetBatches();
+        MFA_TEST_CHECK(batches.size() == DisplayList::MaxBatchLookBack + 2);
+        MFA_TEST_CHECK(batches.back().type == Type::Text && batches.back().drawCount == 1);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestStats()
+    {
+        DisplayList displayList{};
+        displayList.Begin();
+        MFA_TEST_CHECK(displayList.IsEmpty() == true);
+        AddFill(displayList, Rect(0.0f, 0.0f, 10.0f, 10.0f), 0.0f);
+        AddFill(displayList, Rect(20.0f, 0.0f, 10.0f, 10.0f), 1.0f);
+        displayList.AddInstance(Type::Border, nullptr, Instance{}, Rect(0.0f, 0.0f, 30.0f, 10.0f));
+        AddText(displayList, FontA, Rect(0.0f, 20.0f, 10.0f, 10.0f));
+        // Empty primitives are not recorded
+        displayList.AddVertices<TextVertex>(Type::Text, FontA, nullptr, 0, Rect(0.0f, 0.0f, 1.0f, 1.0f));
+        displayList.End();
+
+        auto const & stats = displayList.GetStats();
+        MFA_TEST_CHECK(stats.primitiveCount == 4);
+        MFA_TEST_CHECK(stats.batchCount == displayList.GetBatches().size());
+        MFA_TEST_CHECK(stats.batchCount == 3);
+        MFA_TEST_CHECK(stats.byteCount == 3 * sizeof(Instance) + 6 * sizeof(TextVertex));
+        MFA_TEST_CHECK(stats.primitiveCountPerType[static_cast<size_t>(Type::SolidFill)] == 2);
+        MFA_TEST_CHECK(stats.primitiveCountPerType[static_cast<size_t>(Type::Border)] == 1);
+        MFA_TEST_CHECK(stats.primitiveCountPerType[static_cast<size_t>(Type::Image)] == 0);
+        MFA_TEST_CHECK(stats.primitiveCountPerType[static_cast<size_t>(Type::Text)] == 1);
+        MFA_TEST_CHECK(displayList.GetArena(Type::SolidFill).size() == 2 * sizeof(Instance));
+
+        // Begin starts over, The next frame does not see the counters of the last one
+        displayList.Begin();
+        displayList.End();
+        MFA_TEST_CHECK(displayList.IsEmpty() == true);
+        MFA_TEST_CHECK(displayList.GetStats().primitiveCount == 0 && displayList.GetStats().byteCount == 0);
+        MFA_TEST_CHECK(displayList.GetBatches().empty() == true);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main()
+{
+    TestDisjointPrimitivesMerge();
+    TestOverlapKeepsPainterOrder();
+    TestLookBackIsBounded();
+    TestStats();
+
+    return Test::Result();
+}
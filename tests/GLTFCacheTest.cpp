@@ -0,0 +1,218 @@
+#include "TestUtils.hpp"
+
+#include "AssetGLTF_Cache.hpp"
+#include "AssetGLTF_Mesh.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace MFA;
+using namespace MFA::Asset::GLTF;
+
+namespace
+{
+    static constexpr uint64_t SourceHash = 0x1234;
+
+    // What a test changes in the otherwise valid mesh before it is written
+    struct Corruption
+    {
+        std::function<void(Primitive &)> primitive = [](Primitive &)->void {};
+        std::function<void(Mesh &)> mesh = [](Mesh &)->void {};
+    };
+
+    //-------------------------------------------------------------------------------------------------
+
+    // One triangle, Two nodes, A skin over both nodes and an animation on the child
+    std::shared_ptr<Mesh> CreateMesh(Corruption const & corruption)
+    {
+        std::vector<Vertex> vertices(3);
+        vertices[1].position = glm::vec3{1.0f, 0.0f, 0.0f};
+        vertices[2].position = glm::vec3{0.0f, 1.0f, 0.0f};
+        std::vector<Index> const indices{0, 1, 2};
+
+        auto mesh = std::make_shared<Mesh>(
+            3,
+            3,
+            Memory::AllocSize(sizeof(Vertex) * vertices.size()),
+            Memory::AllocSize(sizeof(Index) * indices.size())
+        );
+        Primitive primitive{};
+        primitive.hasBaseColorTexture = true;
+        primitive.baseColorTextureIndex = 0;
+        corruption.primitive(primitive);
+        mesh->InsertPrimitive(mesh->InsertSubMesh(), primitive, 3, vertices.data(), 3, indices.data());
+
+        auto & root = mesh->InsertNode();
+        root.name = "Root";
+        root.subMeshIndex = 0;
+        root.skin = 0;
+        root.children = {1};
+        auto & child = mesh->InsertNode();
+        child.name = "Child";
+
+        auto & skin = mesh->InsertSkin();
+        skin.joints = {0, 1};
+        skin.inverseBindMatrices = {glm::mat4{1.0f}, glm::mat4{1.0f}};
+        skin.skeletonRootNode = 0;
+
+        Animation animation{};
+        animation.name = "Wave";
+        auto & sampler = animation.samplers.emplace_back();
+        sampler.interpolation = Animation::Interpolation::CubicSpline;
+        sampler.inputAndOutput = {
+            {.input = 0.0f, .outTangent = {0.0f, 2.0f, 0.0f, 0.0f}},
+            {.input = 1.0f, .output = {1.0f, 0.0f, 0.0f, 0.0f}, .inTangent = {0.5f, 0.0f, 0.0f, 0.0f}}
+        };
+        animation.channels.emplace_back(Animation::Channel{
+            .path = Animation::Path::Translation,
+            .nodeIndex = 1,
+            .samplerIndex = 0
+        });
+        mesh->InsertAnimation(animation);
+
+        corruption.mesh(*mesh);
+        return mesh;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool WriteAndRead(std::string const & path, Corruption const & corruption)
+    {
+        auto const mesh = CreateMesh(corruption);
+        if (Cache::Write(path, SourceHash, *mesh, {"Albedo.png"}) == false)
+        {
+            return false;
+        }
+        Cache::Content content{};
+        return Cache::Read(path, SourceHash, content);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main()
+{
+    auto const path = (std::filesystem::temp_directory_path() / "mfa_gltf_cache_test.cache").string();
+
+    MFA_TEST_CHECK(WriteAndRead(path, Corruption{}) == true);
+
+    {// Round trip keeps the cross references
+        Cache::Content content{};
+        MFA_TEST_CHECK(Cache::Read(path, SourceHash, content) == true);
+        if (content.mesh != nullptr)
+        {
+            auto const & data = *content.mesh->GetMeshData();
+            MFA_TEST_CHECK(data.nodes.size() == 2);
+            MFA_TEST_CHECK(data.skins.size() == 1 && data.skins[0].joints.size() == 2);
+            MFA_TEST_CHECK(data.animations.size() == 1 && data.animations[0].channels[0].nodeIndex == 1);
+            if (data.animations.size() == 1)
+            {
+                auto const & sampler = data.animations[0].samplers[0];
+                MFA_TEST_CHECK(sampler.interpolation == Animation::Interpolation::CubicSpline);
+                MFA_TEST_CHECK(sampler.inputAndOutput.size() == 2);
+                MFA_TEST_CHECK(sampler.inputAndOutput[0].outTangent[1] == 2.0f);
+                MFA_TEST_CHECK(sampler.inputAndOutput[1].inTangent[0] == 0.5f);
+            }
+            MFA_TEST_CHECK(content.textureUris.size() == 1);
+        }
+    }
+
+    {// Packed streams come back byte for byte
+        auto const mesh = CreateMesh(Corruption{});
+        mesh->PackVertices();
+        MFA_TEST_CHECK(Cache::Write(path, SourceHash, *mesh, {"Albedo.png"}) == true);
+        Cache::Content content{};
+        MFA_TEST_CHECK(Cache::Read(path, SourceHash, content) == true);
+        if (content.mesh != nullptr)
+        {
+            auto const & expected = mesh->GetPackedVertices();
+            auto const & packedVertices = content.mesh->GetPackedVertices();
+            MFA_TEST_CHECK(packedVertices.size() == 1 && expected.size() == 1);
+            if (packedVertices.size() == 1 && expected.size() == 1)
+            {
+                auto const & packed = packedVertices[0];
+                MFA_TEST_CHECK(packed.vertexCount == 3);
+                MFA_TEST_CHECK(packed.layout.stride == expected[0].layout.stride);
+                MFA_TEST_CHECK(packed.layout.elements.size() == expected[0].layout.elements.size());
+                MFA_TEST_CHECK(packed.layout.positionScale == expected[0].layout.positionScale);
+                MFA_TEST_CHECK(packed.data->Len() == expected[0].data->Len());
+                MFA_TEST_CHECK(std::memcmp(packed.data->Ptr(), expected[0].data->Ptr(), packed.data->Len()) == 0);
+            }
+        }
+    }
+
+    // Streams that do not match their primitive
+    MFA_TEST_CHECK(WriteAndRead(path, Corruption{.mesh = [](Mesh & mesh)->void
+    {
+        mesh.PackVertices();
+        auto packedVertices = mesh.GetPackedVertices();
+        packedVertices.emplace_back(packedVertices[0]);
+        mesh.SetPackedVertices(std::move(packedVertices));
+    }}) == false);
+
+    MFA_TEST_CHECK(WriteAndRead(path, Corruption{.mesh = [](Mesh & mesh)->void
+    {
+        mesh.PackVertices();
+        auto packedVertices = mesh.GetPackedVertices();
+        packedVertices[0].layout.elements[0].offset = packedVertices[0].layout.stride;
+        mesh.SetPackedVertices(std::move(packedVertices));
+    }}) == false);
+
+    // Every index that points into another section has to be rejected when it is out of range, So the importer
+    // falls back to a full import instead of reading out of bounds later
+    MFA_TEST_CHECK(WriteAndRead(path, Corruption{.mesh = [](Mesh & mesh)->void
+    {
+        mesh.GetMeshData()->nodes[1].subMeshIndex = 1;
+    }}) == false);
+
+    MFA_TEST_CHECK(WriteAndRead(path, Corruption{.mesh = [](Mesh & mesh)->void
+    {
+        mesh.GetMeshData()->nodes[0].skin = 3;
+    }}) == false);
+
+    MFA_TEST_CHECK(WriteAndRead(path, Corruption{.mesh = [](Mesh & mesh)->void
+    {
+        mesh.GetMeshData()->skins[0].skeletonRootNode = 2;
+    }}) == false);
+
+    MFA_TEST_CHECK(WriteAndRead(path, Corruption{.mesh = [](Mesh & mesh)->void
+    {
+        mesh.GetMeshData()->skins[0].joints[1] = -2;
+    }}) == false);
+
+    MFA_TEST_CHECK(WriteAndRead(path, Corruption{.mesh = [](Mesh & mesh)->void
+    {
+        mesh.GetMeshData()->skins[0].inverseBindMatrices.pop_back();
+    }}) == false);
+
+    MFA_TEST_CHECK(WriteAndRead(path, Corruption{.mesh = [](Mesh & mesh)->void
+    {
+        mesh.GetMeshData()->animations[0].channels[0].nodeIndex = 2;
+    }}) == false);
+
+    MFA_TEST_CHECK(WriteAndRead(path, Corruption{.mesh = [](Mesh & mesh)->void
+    {
+        mesh.GetMeshData()->animations[0].channels[0].samplerIndex = 1;
+    }}) == false);
+
+    MFA_TEST_CHECK(WriteAndRead(path, Corruption{.primitive = [](Primitive & primitive)->void
+    {
+        primitive.baseColorTextureIndex = 1;
+    }}) == false);
+
+    // Unused texture indices are not read, So they are allowed to keep any default
+    MFA_TEST_CHECK(WriteAndRead(path, Corruption{.primitive = [](Primitive & primitive)->void
+    {
+        primitive.hasOcclusionTexture = false;
+        primitive.occlusionTextureIndex = 7;
+    }}) == true);
+
+    std::error_code error{};
+    std::filesystem::remove(path, error);
+
+    return Test::Result();
+}
@@ -0,0 +1,146 @@
+#include "TestUtils.hpp"
+
+#include "AssetGLTF_Mesh.hpp"
+#include "JobSystem.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace MFA;
+using namespace MFA::Asset::GLTF;
+
+namespace
+{
+    struct PrimitiveData
+    {
+        PrimitiveTopology topology = PrimitiveTopology::TriangleList;
+        std::vector<glm::vec3> positions{};
+        std::vector<Index> indices{};               // Relative to the primitive
+    };
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::shared_ptr<Mesh> CreateMesh(std::vector<PrimitiveData> const & primitives)
+    {
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+        for (auto const & primitive : primitives)
+        {
+            vertexCount += static_cast<uint32_t>(primitive.positions.size());
+            indexCount += static_cast<uint32_t>(primitive.indices.size());
+        }
+
+        auto mesh = std::make_shared<Mesh>(
+            vertexCount,
+            indexCount,
+            Memory::AllocSize(sizeof(Vertex) * vertexCount),
+            Memory::AllocSize(sizeof(Index) * indexCount)
+        );
+        auto const subMeshIndex = mesh->InsertSubMesh();
+        uint32_t vertexStart = 0;
+        for (auto const & data : primitives)
+        {
+            std::vector<Vertex> vertices(data.positions.size());
+            for (size_t i = 0; i < vertices.size(); ++i)
+            {
+                vertices[i].position = data.positions[i];
+            }
+            // Indices are global in the vertex buffer, Like the importer stores them
+            std::vector<Index> indices{};
+            for (auto const index : data.indices)
+            {
+                indices.emplace_back(index + vertexStart);
+            }
+            mesh->InsertPrimitive(
+                subMeshIndex,
+                Primitive{.topology = data.topology},
+                static_cast<uint32_t>(vertices.size()),
+                vertices.data(),
+                static_cast<uint32_t>(indices.size()),
+                indices.data()
+            );
+            vertexStart += static_cast<uint32_t>(vertices.size());
+        }
+        return mesh;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Two triangles of a quad, Written with duplicated corners so the weld has something to merge
+    PrimitiveData Quad()
+    {
+        return PrimitiveData{
+            .positions = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 0, 0}, {1, 1, 0}, {0, 1, 0}},
+            .indices = {0, 1, 2, 3, 4, 5}
+        };
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    PrimitiveData LineStrip()
+    {
+        return PrimitiveData{
+            .topology = PrimitiveTopology::LineStrip,
+            .positions = {{0, 0, 0}, {1, 0, 0}, {1, 0, 0}, {2, 0, 0}},
+            .indices = {0, 1, 2, 3}
+        };
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestOptimizeForRenderingSkipsNonTriangleLists()
+    {
+        auto brokenList = Quad();
+        brokenList.indices.pop_back();
+
+        auto const mesh = CreateMesh({Quad(), LineStrip(), brokenList});
+        auto const * indices = mesh->GetIndexData()->As<Index>();
+        std::vector<Index> const lineIndices{indices + 6, indices + 10};
+        std::vector<Index> const brokenIndices{indices + 10, indices + 15};
+
+        auto const stats = mesh->OptimizeForRendering();
+        MFA_TEST_CHECK(stats.skippedPrimitiveCount == 2);
+        MFA_TEST_CHECK(std::equal(lineIndices.begin(), lineIndices.end(), indices + 6));
+        MFA_TEST_CHECK(std::equal(brokenIndices.begin(), brokenIndices.end(), indices + 10));
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestWeldKeepsNonTriangleLists()
+    {
+        auto const mesh = CreateMesh({Quad(), LineStrip()});
+        mesh->Optimize();
+
+        auto const & primitives = mesh->GetMeshData()->subMeshes[0].primitives;
+        MFA_TEST_CHECK(primitives.size() == 2);
+        // The quad loses its two duplicated corners
+        MFA_TEST_CHECK(primitives[0].vertexCount == 4);
+        MFA_TEST_CHECK(primitives[0].indicesCount == 6);
+        // The line strip keeps its duplicated vertex and every index
+        MFA_TEST_CHECK(primitives[1].vertexCount == 4);
+        MFA_TEST_CHECK(primitives[1].indicesCount == 4);
+        MFA_TEST_CHECK(primitives[1].verticesStartingIndex == 4);
+
+        auto const * indices = mesh->GetIndexData()->As<Index>();
+        for (uint32_t k = 0; k < primitives[1].indicesCount; ++k)
+        {
+            MFA_TEST_CHECK(indices[primitives[1].indicesStartingIndex + k] == 4 + k);
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main()
+{
+    auto jobSystem = JobSystem::Instantiate();
+
+    TestOptimizeForRenderingSkipsNonTriangleLists();
+    TestWeldKeepsNonTriangleLists();
+
+    jobSystem.reset();
+    JobSystem::Destroy();
+
+    return Test::Result();
+}
@@ -0,0 +1,183 @@
+#include "TestUtils.hpp"
+
+#include "JobSystem.hpp"
+#include "NoiseGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+
+using namespace MFA;
+
+namespace
+{
+    static constexpr int Period = 4;
+    static constexpr float Epsilon = 1e-4f;
+
+    // Shifting a position by one period on any axis has to give the same value
+    void TestFunctionsRepeatAfterPeriod()
+    {
+        std::mt19937 random{42};
+        std::uniform_real_distribution<float> distribution{-8.0f, 8.0f};
+        glm::vec3 const axes[3] {{Period, 0, 0}, {0, Period, 0}, {0, 0, Period}};
+
+        float perlinError = 0.0f;
+        float worleyError = 0.0f;
+        for (int i = 0; i < 256; ++i)
+        {
+            glm::vec3 const position{distribution(random), distribution(random), distribution(random)};
+            auto const perlin = NoiseGenerator::Perlin(position, Period, 3);
+            auto const worley = NoiseGenerator::Worley(position, Period, 3);
+            for (auto const & axis : axes)
+            {
+                perlinError = std::max(perlinError, std::abs(NoiseGenerator::Perlin(position + axis, Period, 3) - perlin));
+                auto const shifted = NoiseGenerator::Worley(position - axis, Period, 3);
+                worleyError = std::max(worleyError, std::abs(shifted.x - worley.x));
+                worleyError = std::max(worleyError, std::abs(shifted.y - worley.y));
+            }
+        }
+        MFA_TEST_CHECK(perlinError < Epsilon);
+        MFA_TEST_CHECK(worleyError < Epsilon);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // A volume that covers one period wraps around without a seam, So the steps from the last voxel to the first one
+    // on each axis are about as large as the steps between neighbours inside the volume. Single steps are too noisy
+    // to compare on the high frequency channels, So the means are compared.
+    void CheckVolumeWraps(AS::Texture const & texture, uint32_t const channelCount)
+    {
+        auto const & dimension = texture.GetMipmapDimension(0);
+        auto const resolution = static_cast<int>(dimension.width);
+        auto const * voxels = texture.GetMipmapBuffer(0)->As<uint8_t>();
+        auto const voxel = [&](int const x, int const y, int const z, uint32_t const channel)->int
+        {
+            return voxels[((static_cast<size_t>(z) * resolution + y) * resolution + x) * channelCount + channel];
+        };
+
+        for (uint32_t channel = 0; channel < channelCount; ++channel)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                double seamSum = 0.0;
+                double interiorSum = 0.0;
+                for (int a = 0; a < resolution; ++a)
+                {
+                    for (int b = 0; b < resolution; ++b)
+                    {
+                        for (int c = 0; c < resolution; ++c)
+                        {
+                            int const next = (c + 1) % resolution;
+                            int const step = axis == 0 ? std::abs(voxel(next, a, b, channel) - voxel(c, a, b, channel))
+                                : axis == 1 ? std::abs(voxel(a, next, b, channel) - voxel(a, c, b, channel))
+                                : std::abs(voxel(a, b, next, channel) - voxel(a, b, c, channel));
+                            if (next == 0)
+                            {
+                                seamSum += step;
+                            }
+                            else
+                            {
+                                interiorSum += step;
+                            }
+                        }
+                    }
+                }
+                double const seamMean = seamSum / (resolution * resolution);
+                double const interiorMean = interiorSum / (resolution * resolution * (resolution - 1));
+                MFA_TEST_CHECK(seamMean <= interiorMean * 1.25 + 1.0);
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestVolumesTile()
+    {
+        NoiseGenerator::VolumeParams const params{.resolution = 24, .frequency = 3, .octaves = 3, .seed = 5};
+        CheckVolumeWraps(*NoiseGenerator::PerlinVolume(params), 1);
+        CheckVolumeWraps(*NoiseGenerator::WorleyVolume(params, NoiseGenerator::WorleyFeature::F1), 1);
+        CheckVolumeWraps(*NoiseGenerator::PerlinWorleyVolume(params), 1);
+        CheckVolumeWraps(*NoiseGenerator::CloudShapeVolume(32, 5), 4);
+        CheckVolumeWraps(*NoiseGenerator::CloudDetailVolume(16, 5), 4);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // The second load has to read the saved file back instead of baking again, And get the same voxels
+    void TestVolumeIsSavedAndLoaded()
+    {
+        auto const directory = std::filesystem::temp_directory_path() / "mfa_noise_generator_test";
+        std::error_code error{};
+        std::filesystem::remove_all(directory, error);
+        std::filesystem::create_directories(directory, error);
+        MFA_TEST_CHECK(!error);
+
+        auto const baked = NoiseGenerator::LoadOrBakeCloudDetailVolume(directory.string(), 16, 7);
+        size_t fileCount = 0;
+        for (auto const & entry : std::filesystem::directory_iterator(directory))
+        {
+            fileCount += entry.path().extension() == ".ktx2" ? 1 : 0;
+        }
+        MFA_TEST_CHECK(fileCount == 1);
+
+        int bakeCount = 0;
+        auto const path = std::filesystem::directory_iterator(directory)->path().string();
+        auto const loaded = NoiseGenerator::LoadOrBakeVolume(
+            path,
+            AS::Texture::Format::UNCOMPRESSED_UNORM_R8G8B8A8_LINEAR,
+            16,
+            [&bakeCount]()->std::shared_ptr<AS::Texture>
+            {
+                ++bakeCount;
+                return NoiseGenerator::CloudDetailVolume(16, 7);
+            }
+        );
+        MFA_TEST_CHECK(bakeCount == 0);
+        MFA_TEST_CHECK(baked != nullptr && loaded != nullptr);
+        if (baked != nullptr && loaded != nullptr)
+        {
+            auto const & expected = baked->GetMipmapBuffer(0);
+            auto const & actual = loaded->GetMipmapBuffer(0);
+            MFA_TEST_CHECK(actual != nullptr && actual->Len() == expected->Len());
+            MFA_TEST_CHECK(actual != nullptr && std::memcmp(actual->Ptr(), expected->Ptr(), expected->Len()) == 0);
+            MFA_TEST_CHECK(loaded->GetMipmapDimension(0).depth == 16);
+        }
+
+        // Another size under the same path is baked again
+        auto const resized = NoiseGenerator::LoadOrBakeVolume(
+            path,
+            AS::Texture::Format::UNCOMPRESSED_UNORM_R8G8B8A8_LINEAR,
+            8,
+            [&bakeCount]()->std::shared_ptr<AS::Texture>
+            {
+                ++bakeCount;
+                return NoiseGenerator::CloudDetailVolume(8, 7);
+            }
+        );
+        MFA_TEST_CHECK(bakeCount == 1);
+        MFA_TEST_CHECK(resized != nullptr && resized->GetMipmapDimension(0).width == 8);
+
+        std::filesystem::remove_all(directory, error);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main()
+{
+    auto jobSystem = JobSystem::Instantiate();
+
+    TestFunctionsRepeatAfterPeriod();
+    TestVolumesTile();
+    TestVolumeIsSavedAndLoaded();
+
+    jobSystem.reset();
+    JobSystem::Destroy();
+
+    return Test::Result();
+}
@@ -0,0 +1,128 @@
+#include "TestUtils.hpp"
+
+#include "AssetGLTF_Mesh.hpp"
+#include "AssetGLTF_PackedVertex.hpp"
+
+#include <cmath>
+#include <vector>
+
+using namespace MFA;
+using namespace MFA::Asset::GLTF;
+
+namespace
+{
+    // Half floats keep 11 bits of mantissa, Uvs in [0, 1] are off by at most 1/2048
+    static constexpr float UVTolerance = 1.0f / 1024.0f;
+
+    //-------------------------------------------------------------------------------------------------
+
+    std::vector<Vertex> CreateVertices()
+    {
+        std::vector<Vertex> vertices(64);
+        for (size_t i = 0; i < vertices.size(); ++i)
+        {
+            float const t = static_cast<float>(i) / static_cast<float>(vertices.size() - 1);
+            vertices[i].position = glm::vec3{t, 1.0f - t, t * 0.5f};
+            vertices[i].baseColorUV = glm::vec2{t, 0.25f};
+            vertices[i].metallicUV = glm::vec2{t, 1.0f - t};
+            vertices[i].roughnessUV = glm::vec2{1.0f - t, t * t};
+        }
+        return vertices;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool IsClose(glm::vec2 const & a, glm::vec2 const & b)
+    {
+        return std::abs(a.x - b.x) <= UVTolerance && std::abs(a.y - b.y) <= UVTolerance;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Separate metallic and roughness textures can use different uv sets, Both have to survive the packing
+    void TestSeparateMetallicRoughnessUVs()
+    {
+        auto const vertices = CreateVertices();
+        Primitive primitive{};
+        primitive.hasBaseColorTexture = true;
+        primitive.hasMetallicTexture = true;
+        primitive.hasRoughnessTexture = true;
+
+        auto const packed = PackVertices(primitive, vertices.data(), static_cast<uint32_t>(vertices.size()));
+        MFA_TEST_CHECK(packed.layout.Find(VertexAttribute::MetallicUV) != nullptr);
+        MFA_TEST_CHECK(packed.layout.Find(VertexAttribute::RoughnessUV) != nullptr);
+
+        bool isEachClose = true;
+        for (uint32_t i = 0; i < packed.vertexCount; ++i)
+        {
+            auto const unpacked = UnpackVertex(packed.layout, packed.data->Ptr() + i * packed.layout.stride);
+            isEachClose &= IsClose(unpacked.metallicUV, vertices[i].metallicUV);
+            isEachClose &= IsClose(unpacked.roughnessUV, vertices[i].roughnessUV);
+            isEachClose &= IsClose(unpacked.baseColorUV, vertices[i].baseColorUV);
+        }
+        MFA_TEST_CHECK(isEachClose == true);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestUnusedUVsAreDropped()
+    {
+        auto const vertices = CreateVertices();
+        Primitive primitive{};
+        primitive.hasMetallicTexture = true;
+
+        auto const packed = PackVertices(primitive, vertices.data(), static_cast<uint32_t>(vertices.size()));
+        MFA_TEST_CHECK(packed.layout.Find(VertexAttribute::MetallicUV) != nullptr);
+        MFA_TEST_CHECK(packed.layout.Find(VertexAttribute::RoughnessUV) == nullptr);
+        MFA_TEST_CHECK(packed.layout.Find(VertexAttribute::BaseColorUV) == nullptr);
+        MFA_TEST_CHECK(packed.layout.stride < sizeof(Vertex));
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // The mesh keeps one stream per primitive until its vertices change
+    void TestMeshKeepsStreams()
+    {
+        auto vertices = CreateVertices();
+        vertices.resize(6);
+        std::vector<Index> const indices{0, 1, 2, 3, 4, 5};
+        // Indices are relative to the whole vertex buffer
+        std::vector<Index> const secondIndices{6, 7, 8, 9, 10, 11};
+        Mesh mesh{
+            static_cast<uint32_t>(vertices.size() * 2),
+            static_cast<uint32_t>(indices.size() * 2),
+            Memory::AllocSize(sizeof(Vertex) * vertices.size() * 2),
+            Memory::AllocSize(sizeof(Index) * indices.size() * 2)
+        };
+        Primitive textured{};
+        textured.hasBaseColorTexture = true;
+        auto const subMeshIndex = mesh.InsertSubMesh();
+        mesh.InsertPrimitive(subMeshIndex, textured, 6, vertices.data(), 6, indices.data());
+        mesh.InsertPrimitive(subMeshIndex, Primitive{}, 6, vertices.data(), 6, secondIndices.data());
+
+        auto const report = mesh.PackVertices();
+        auto const & packedVertices = mesh.GetPackedVertices();
+        MFA_TEST_CHECK(packedVertices.size() == 2);
+        MFA_TEST_CHECK(report.vertexCount == 12 && report.packedBytes < report.unpackedBytes);
+        if (packedVertices.size() == 2)
+        {
+            MFA_TEST_CHECK(packedVertices[0].layout.Find(VertexAttribute::BaseColorUV) != nullptr);
+            MFA_TEST_CHECK(packedVertices[1].layout.Find(VertexAttribute::BaseColorUV) == nullptr);
+        }
+
+        mesh.OptimizeForRendering();
+        MFA_TEST_CHECK(mesh.GetPackedVertices().empty() == true);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main()
+{
+    TestSeparateMetallicRoughnessUVs();
+    TestUnusedUVsAreDropped();
+    TestMeshKeepsStreams();
+
+    return Test::Result();
+}
@@ -0,0 +1,165 @@
+#include "TestUtils.hpp"
+
+#include "JobSystem.hpp"
+#include "TaskGraph.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace MFA;
+
+namespace
+{
+    //-------------------------------------------------------------------------------------------------
+
+    void TestDependencyOrder()
+    {
+        TaskGraph graph{};
+        std::atomic<int> step{0};
+        std::vector<int> order(4, -1);
+
+        auto const root = graph.AddTask([&]()->void { order[0] = step.fetch_add(1); });
+        auto const left = graph.AddTask([&]()->void { order[1] = step.fetch_add(1); }, {root});
+        auto const right = graph.AddTask([&]()->void { order[2] = step.fetch_add(1); }, {root});
+        graph.AddTask([&]()->void { order[3] = step.fetch_add(1); }, {left, right});
+
+        // Runs twice to make sure the state is reset between runs
+        for (int run = 0; run < 2; ++run)
+        {
+            step = 0;
+            graph.Run();
+            MFA_TEST_CHECK(step == 4);
+            MFA_TEST_CHECK(order[0] == 0);
+            MFA_TEST_CHECK(order[1] > order[0] && order[2] > order[0]);
+            MFA_TEST_CHECK(order[3] == 3);
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // The root runs, But the cycle behind it never gets ready. Run has to throw instead of waiting forever.
+    void TestCycleIsRejected()
+    {
+        TaskGraph graph{};
+        std::atomic<int> executedCount{0};
+        auto const root = graph.AddTask([&]()->void { ++executedCount; });
+        auto const first = graph.AddTask([&]()->void { ++executedCount; }, {root});
+        auto const second = graph.AddTask([&]()->void { ++executedCount; }, {first});
+        graph.AddDependency(second, first);
+
+        bool hasThrown = false;
+        try
+        {
+            graph.Run();
+        }
+        catch (std::runtime_error const &)
+        {
+            hasThrown = true;
+        }
+        MFA_TEST_CHECK(hasThrown == true);
+        MFA_TEST_CHECK(executedCount == 0);
+
+        // The graph is usable again after it has been cleared
+        graph.Clear();
+        graph.AddTask([&]()->void { ++executedCount; });
+        graph.Run();
+        MFA_TEST_CHECK(executedCount == 1);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestTaskExceptionIsRethrown()
+    {
+        TaskGraph graph{};
+        std::atomic<int> executedCount{0};
+        auto const root = graph.AddTask([&]()->void { throw std::logic_error("task"); });
+        graph.AddTask([&]()->void { ++executedCount; }, {root});
+
+        bool hasThrown = false;
+        try
+        {
+            graph.Run();
+        }
+        catch (std::logic_error const &)
+        {
+            hasThrown = true;
+        }
+        MFA_TEST_CHECK(hasThrown == true);
+        // Successors still run, Only the first exception is reported
+        MFA_TEST_CHECK(executedCount == 1);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestParallelForCoversRange()
+    {
+        static constexpr int Count = 10000;
+        std::vector<std::atomic<int>> visits(Count);
+        JobSystem::ParallelFor(Count, 64, [&visits](int const start, int const end)->void
+        {
+            for (int i = start; i < end; ++i)
+            {
+                visits[i].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+
+        bool isEachVisitedOnce = true;
+        for (auto const & visit : visits)
+        {
+            isEachVisitedOnce &= visit.load() == 1;
+        }
+        MFA_TEST_CHECK(isEachVisitedOnce == true);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Chunks after the first one are likely to run on helpers, Their exception has to reach the caller
+    void TestParallelForRethrows()
+    {
+        static constexpr int Count = 4096;
+        static constexpr int Grain = 16;
+        for (int throwingChunk : {0, Count / Grain / 2, Count / Grain - 1})
+        {
+            bool hasThrown = false;
+            try
+            {
+                JobSystem::ParallelFor(Count, Grain, [throwingChunk](int const start, int)->void
+                {
+                    if (start / Grain == throwingChunk)
+                    {
+                        throw std::logic_error("chunk");
+                    }
+                });
+            }
+            catch (std::logic_error const &)
+            {
+                hasThrown = true;
+            }
+            MFA_TEST_CHECK(hasThrown == true);
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main()
+{
+    auto jobSystem = JobSystem::Instantiate(JobSystem::InitParams{
+        .threadCount = 4,
+        .reservedThreadCount = 0,
+        .ioThreadCount = 0
+    });
+
+    TestDependencyOrder();
+    TestCycleIsRejected();
+    TestTaskExceptionIsRethrown();
+    TestParallelForCoversRange();
+    TestParallelForRethrows();
+
+    jobSystem.reset();
+    JobSystem::Destroy();
+
+    return Test::Result();
+}
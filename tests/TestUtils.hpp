@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdio>
+
+namespace MFA::Test
+{
+    inline int & FailureCount()
+    {
+        static int failureCount = 0;
+        return failureCount;
+    }
+
+    // Failed checks are reported and counted, The test keeps running so one run shows every failure
+    inline void Check(bool const condition, char const * expression, char const * file, int const line)
+    {
+        if (condition == false)
+        {
+            std::fprintf(stderr, "%s:%d: Check failed: %s\n", file, line, expression);
+            ++FailureCount();
+        }
+    }
+
+    // Return value of main
+    inline int Result()
+    {
+        if (FailureCount() > 0)
+        {
+            std::fprintf(stderr, "%d check(s) failed\n", FailureCount());
+            return 1;
+        }
+        return 0;
+    }
+}
+
+#define MFA_TEST_CHECK(condition)       MFA::Test::Check((condition), #condition, __FILE__, __LINE__)
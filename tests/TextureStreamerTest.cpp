@@ -0,0 +1,213 @@
+#include "TestUtils.hpp"
+
+#include "AssetTexture_Streamer.hpp"
+
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+using namespace MFA;
+using namespace MFA::Asset;
+
+// No job system is instantiated, So every load runs inline inside Update and the results are deterministic.
+// A load still counts as pending until the next Update or Flush applies it, Like it would on the io threads.
+
+namespace
+{
+    // Rgba8 16x16 down to 1x1
+    static constexpr uint8_t MipCount = 5;
+    static constexpr size_t MipSizes[MipCount] {1024, 256, 64, 16, 4};
+    static constexpr size_t TextureBytes = 1024 + 256 + 64 + 16 + 4;
+
+    struct Source
+    {
+        std::shared_ptr<Texture> texture{};
+        // Loads per mip level
+        std::shared_ptr<std::vector<int>> loadCounts = std::make_shared<std::vector<int>>(MipCount, 0);
+        std::shared_ptr<bool> isBroken = std::make_shared<bool>(false);
+
+        [[nodiscard]]
+        TextureStreamer::MipLoader Loader() const
+        {
+            return [loadCounts = loadCounts, isBroken = isBroken](uint8_t const mipLevel)->std::shared_ptr<Blob>
+            {
+                ++(*loadCounts)[mipLevel];
+                return *isBroken ? nullptr : Memory::AllocSize(MipSizes[mipLevel]);
+            };
+        }
+    };
+
+    //-------------------------------------------------------------------------------------------------
+
+    // Only the smallest level is resident, Like a texture that was just opened
+    Source CreateSource()
+    {
+        Source source{};
+        source.texture = std::make_shared<Texture>(Texture::Format::UNCOMPRESSED_UNORM_R8G8B8A8_LINEAR, 1, 1, MipCount);
+        for (uint8_t level = 0; level < MipCount; ++level)
+        {
+            uint32_t const size = 16u >> level;
+            source.texture->SetMipmapDimension(level, Texture::Dimensions{.width = size, .height = size, .depth = 1});
+            source.texture->SetMipmapSize(level, MipSizes[level]);
+        }
+        source.texture->SetMipmapData(MipCount - 1, Memory::AllocSize(MipSizes[MipCount - 1]));
+        return source;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void RunFrames(TextureStreamer & streamer, int const frameCount, std::function<void()> const & request)
+    {
+        for (int i = 0; i < frameCount; ++i)
+        {
+            if (request != nullptr)
+            {
+                request();
+            }
+            streamer.Update();
+            streamer.Flush();
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestPendingLoadStats()
+    {
+        TextureStreamer streamer{TextureStreamer::Params{.budgetBytes = 1024 * 1024, .maxPendingLoads = 1}};
+        auto const a = CreateSource();
+        auto const b = CreateSource();
+        auto const handleA = streamer.Register(a.texture, a.Loader());
+        auto const handleB = streamer.Register(b.texture, b.Loader());
+
+        auto stats = streamer.GetStats();
+        MFA_TEST_CHECK(stats.residentBytes == 8);
+        MFA_TEST_CHECK(stats.pendingLoads == 0 && stats.pendingBytes == 0);
+        MFA_TEST_CHECK(streamer.GetResidentMipLevel(handleA) == MipCount - 1);
+
+        streamer.RequestMipLevel(handleA, 0);
+        streamer.RequestMipLevel(handleB, 0);
+        streamer.Update();
+
+        // One load at a time, The next level of one of the textures
+        stats = streamer.GetStats();
+        MFA_TEST_CHECK(stats.pendingLoads == 1);
+        MFA_TEST_CHECK(stats.pendingBytes == MipSizes[MipCount - 2]);
+        MFA_TEST_CHECK(stats.loads == 0);
+        MFA_TEST_CHECK(stats.residentBytes == 8);
+
+        streamer.Flush();
+        stats = streamer.GetStats();
+        MFA_TEST_CHECK(stats.pendingLoads == 0 && stats.pendingBytes == 0);
+        MFA_TEST_CHECK(stats.loads == 1);
+        MFA_TEST_CHECK(stats.residentBytes == 8 + MipSizes[MipCount - 2]);
+
+        RunFrames(streamer, 2 * MipCount, [&]()->void
+        {
+            streamer.RequestMipLevel(handleA, 0);
+            streamer.RequestMipLevel(handleB, 0);
+        });
+        stats = streamer.GetStats();
+        MFA_TEST_CHECK(streamer.GetResidentMipLevel(handleA) == 0);
+        MFA_TEST_CHECK(streamer.GetResidentMipLevel(handleB) == 0);
+        MFA_TEST_CHECK(stats.residentBytes == 2 * TextureBytes);
+        MFA_TEST_CHECK(stats.loads == 2 * (MipCount - 1));
+        MFA_TEST_CHECK(stats.evictions == 0);
+        MFA_TEST_CHECK(a.texture->GetMipmapBuffer(0) != nullptr);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestEvictionOrderAndReloads()
+    {
+        TextureStreamer streamer{TextureStreamer::Params{.budgetBytes = 1024 * 1024}};
+        auto const a = CreateSource();
+        auto const b = CreateSource();
+        auto const handleA = streamer.Register(a.texture, a.Loader());
+        auto const handleB = streamer.Register(b.texture, b.Loader());
+
+        RunFrames(streamer, MipCount, [&]()->void
+        {
+            streamer.RequestMipLevel(handleA, 0);
+            streamer.RequestMipLevel(handleB, 0);
+        });
+        MFA_TEST_CHECK(streamer.GetStats().residentBytes == 2 * TextureBytes);
+
+        // A is used before B, So A is the least recently used texture
+        RunFrames(streamer, 1, [&]()->void { streamer.RequestMipLevel(handleA, 0); });
+        RunFrames(streamer, 1, [&]()->void { streamer.RequestMipLevel(handleB, 0); });
+
+        // Shrinking the budget by one large level evicts the largest level of A
+        streamer.SetBudget(2 * TextureBytes - MipSizes[0]);
+        RunFrames(streamer, 1, nullptr);
+        MFA_TEST_CHECK(streamer.GetResidentMipLevel(handleA) == 1);
+        MFA_TEST_CHECK(streamer.GetResidentMipLevel(handleB) == 0);
+        MFA_TEST_CHECK(a.texture->GetMipmapBuffer(0) == nullptr);
+        MFA_TEST_CHECK(b.texture->GetMipmapBuffer(0) != nullptr);
+        MFA_TEST_CHECK(streamer.GetStats().evictions == 1);
+        MFA_TEST_CHECK(streamer.GetStats().evictedBytes == MipSizes[0]);
+
+        // The next level of A is still older than anything of B
+        streamer.SetBudget(2 * TextureBytes - MipSizes[0] - MipSizes[1]);
+        RunFrames(streamer, 1, nullptr);
+        MFA_TEST_CHECK(streamer.GetResidentMipLevel(handleA) == 2);
+        MFA_TEST_CHECK(streamer.GetResidentMipLevel(handleB) == 0);
+
+        // A runs out of evictable levels, Its smallest level stays and B has to give up its largest one
+        streamer.SetBudget(2 * TextureBytes - 2 * MipSizes[0] - MipSizes[1]);
+        RunFrames(streamer, 1, nullptr);
+        MFA_TEST_CHECK(streamer.GetResidentMipLevel(handleA) == MipCount - 1);
+        MFA_TEST_CHECK(streamer.GetResidentMipLevel(handleB) == 1);
+        MFA_TEST_CHECK(a.texture->GetMipmapBuffer(MipCount - 1) != nullptr);
+        MFA_TEST_CHECK(streamer.GetStats().evictions == 5);
+        MFA_TEST_CHECK(streamer.GetStats().residentBytes <= streamer.GetStats().budgetBytes);
+
+        // Requesting A again evicts the levels of B that nobody needs and reloads the evicted levels of A,
+        // Until the next level no longer fits the budget
+        RunFrames(streamer, 2 * MipCount, [&]()->void { streamer.RequestMipLevel(handleA, 0); });
+        MFA_TEST_CHECK(streamer.GetResidentMipLevel(handleA) == 1);
+        MFA_TEST_CHECK(streamer.GetResidentMipLevel(handleB) == MipCount - 1);
+        MFA_TEST_CHECK((*a.loadCounts)[1] == 2);
+        MFA_TEST_CHECK((*a.loadCounts)[0] == 1);
+        MFA_TEST_CHECK(streamer.GetStats().residentBytes <= streamer.GetStats().budgetBytes);
+
+        // Levels that are requested this frame are never evicted for each other, Even when the budget is exceeded
+        streamer.SetBudget(0);
+        RunFrames(streamer, 1, [&]()->void { streamer.RequestMipLevel(handleA, 0); });
+        MFA_TEST_CHECK(streamer.GetResidentMipLevel(handleA) == 1);
+
+        streamer.SetBudget(1024 * 1024);
+        RunFrames(streamer, 2 * MipCount, [&]()->void { streamer.RequestMipLevel(handleA, 0); });
+        MFA_TEST_CHECK(streamer.GetResidentMipLevel(handleA) == 0);
+        MFA_TEST_CHECK((*a.loadCounts)[0] == 2);
+        MFA_TEST_CHECK(std::accumulate(b.loadCounts->begin(), b.loadCounts->end(), 0) == MipCount - 1);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestFailedLoadsAreNotRetried()
+    {
+        TextureStreamer streamer{TextureStreamer::Params{}};
+        auto const a = CreateSource();
+        *a.isBroken = true;
+        auto const handle = streamer.Register(a.texture, a.Loader());
+
+        RunFrames(streamer, 4, [&]()->void { streamer.RequestMipLevel(handle, 0); });
+        MFA_TEST_CHECK(streamer.GetStats().failedLoads == 1);
+        MFA_TEST_CHECK(streamer.GetStats().pendingLoads == 0);
+        MFA_TEST_CHECK(streamer.GetResidentMipLevel(handle) == MipCount - 1);
+        MFA_TEST_CHECK((*a.loadCounts)[MipCount - 2] == 1);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main()
+{
+    TestPendingLoadStats();
+    TestEvictionOrderAndReloads();
+    TestFailedLoadsAreNotRetried();
+
+    return Test::Result();
+}
@@ -0,0 +1,163 @@
+#include "TestUtils.hpp"
+
+#include "AssetGLTF_Mesh.hpp"
+#include "Transform.hpp"
+#include "TransformStore.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+using namespace MFA;
+using namespace MFA::Asset::GLTF;
+
+// World matrices of the store through the Transform handles, The children that the handles keep and what a copy of a
+// Transform or of a MeshData shares with the original.
+
+namespace
+{
+    bool IsNear(glm::vec3 const & lhs, glm::vec3 const & rhs)
+    {
+        return glm::all(glm::lessThanEqual(glm::abs(lhs - rhs), glm::vec3{1e-5f}));
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    glm::vec3 WorldPosition(Transform & transform)
+    {
+        return glm::vec3{transform.GlobalTransform()[3]};
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    bool HasChild(Transform const & parent, Transform const * child)
+    {
+        auto const & children = parent.Children();
+        return std::find(children.begin(), children.end(), child) != children.end();
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestDefaultStoreIsShared()
+    {
+        Transform first{};
+        Transform second{};
+        MFA_TEST_CHECK(first.GetStore() == TransformStore::Default());
+        MFA_TEST_CHECK(first.GetStore() == second.GetStore());
+
+        // Sharing the store is what allows parenting transforms that were created without one
+        second.SetParent(&first);
+        first.SetLocalPosition(glm::vec3{1.0f, 0.0f, 0.0f});
+        second.SetLocalPosition(glm::vec3{0.0f, 2.0f, 0.0f});
+        MFA_TEST_CHECK(IsNear(WorldPosition(second), glm::vec3{1.0f, 2.0f, 0.0f}));
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestChildren()
+    {
+        auto const store = std::make_shared<TransformStore>();
+        Transform root{store};
+        Transform other{store};
+        std::vector<Transform> children{};
+        children.emplace_back(store).SetParent(&root);
+        children.emplace_back(store).SetParent(&root);
+        MFA_TEST_CHECK(root.Children().size() == 2);
+
+        // Growing the vector moves the handles, The parent has to follow them
+        for (int i = 0; i < 8; ++i)
+        {
+            children.emplace_back(store);
+        }
+        MFA_TEST_CHECK(root.Children().size() == 2 && HasChild(root, &children[0]) && HasChild(root, &children[1]));
+
+        children[1].SetParent(&other);
+        MFA_TEST_CHECK(root.Children().size() == 1 && HasChild(other, &children[1]));
+        root.RemoveChild(&children[0]);
+        MFA_TEST_CHECK(root.Children().empty() == true && children[0].Parent() == nullptr);
+
+        {
+            Transform temporary{store};
+            temporary.SetParent(&other);
+            MFA_TEST_CHECK(other.Children().size() == 2);
+        }
+        MFA_TEST_CHECK(other.Children().size() == 1);
+
+        // A child cannot become the parent of its parent
+        other.SetParent(&children[1]);
+        MFA_TEST_CHECK(other.Parent() == nullptr && children[1].Children().empty() == true);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestCopyDoesNotAlias()
+    {
+        auto const store = std::make_shared<TransformStore>();
+        Transform parent{store};
+        Transform original{store};
+        Transform child{store};
+        original.SetParent(&parent);
+        child.SetParent(&original);
+        original.SetLocalPosition(glm::vec3{0.0f, 1.0f, 0.0f});
+
+        Transform copy{original};
+        MFA_TEST_CHECK(copy.GetId() != original.GetId());
+        MFA_TEST_CHECK(copy.Parent() == nullptr && copy.Children().empty() == true);
+        MFA_TEST_CHECK(IsNear(copy.GetLocalPosition(), glm::vec3{0.0f, 1.0f, 0.0f}));
+        MFA_TEST_CHECK(parent.Children().size() == 1 && original.Children().size() == 1);
+
+        parent.SetLocalPosition(glm::vec3{5.0f, 0.0f, 0.0f});
+        copy.SetLocalPosition(glm::vec3{0.0f, 3.0f, 0.0f});
+        MFA_TEST_CHECK(IsNear(WorldPosition(copy), glm::vec3{0.0f, 3.0f, 0.0f}));
+        MFA_TEST_CHECK(IsNear(WorldPosition(original), glm::vec3{5.0f, 1.0f, 0.0f}));
+
+        // Assignment copies the values only
+        Transform assigned{store};
+        assigned.SetParent(&parent);
+        assigned = copy;
+        MFA_TEST_CHECK(assigned.Parent() == &parent);
+        MFA_TEST_CHECK(IsNear(WorldPosition(assigned), glm::vec3{5.0f, 3.0f, 0.0f}));
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+    void TestMeshDataCopy()
+    {
+        MeshData original{};
+        auto & subMesh = original.subMeshes.emplace_back();
+        subMesh.primitives.resize(2);
+        subMesh.opaquePrimitives = {&subMesh.primitives[1]};
+        original.nodes.emplace_back(original.transformStore).children = {1};
+        original.nodes.emplace_back(original.transformStore).parent = 0;
+        original.nodes[1].transform.SetParent(&original.nodes[0].transform);
+        original.nodes[1].transform.SetLocalPosition(glm::vec3{0.0f, 1.0f, 0.0f});
+
+        MeshData copy{original};
+        MFA_TEST_CHECK(copy.transformStore != original.transformStore);
+        MFA_TEST_CHECK(copy.nodes.size() == 2 && copy.nodes[1].transform.Parent() == &copy.nodes[0].transform);
+        MFA_TEST_CHECK(copy.nodes[0].transform.GetStore() == copy.transformStore);
+        MFA_TEST_CHECK(copy.subMeshes[0].opaquePrimitives[0] == &copy.subMeshes[0].primitives[1]);
+
+        original.nodes[0].transform.SetLocalPosition(glm::vec3{4.0f, 0.0f, 0.0f});
+        MFA_TEST_CHECK(IsNear(WorldPosition(original.nodes[1].transform), glm::vec3{4.0f, 1.0f, 0.0f}));
+        MFA_TEST_CHECK(IsNear(WorldPosition(copy.nodes[1].transform), glm::vec3{0.0f, 1.0f, 0.0f}));
+
+        MeshData assigned{};
+        assigned = copy;
+        MFA_TEST_CHECK(assigned.nodes.size() == 2 && assigned.nodes[1].transform.Parent() == &assigned.nodes[0].transform);
+        MFA_TEST_CHECK(assigned.transformStore != copy.transformStore);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+
+}
+
+int main()
+{
+    TestDefaultStoreIsShared();
+    TestChildren();
+    TestCopyDoesNotAlias();
+    TestMeshDataCopy();
+
+    return Test::Result();
+}
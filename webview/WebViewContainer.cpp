@@ -15,6 +15,7 @@
 #include "litehtml/render_item.h"
 #include "stb_image.h"
 
+#include <algorithm>
 #include <ranges>
 
 using namespace MFA;
@@ -97,6 +98,39 @@ bool operator==(const litehtml::background_layer &lhs, const litehtml::backgroun
 
 // TODO: For image rendering we have to use set Scissor and viewport.
 
+namespace
+{
+    // Smallest vertex buffer of an arena, Arenas grow in powers of two from here
+    constexpr size_t MinArenaSize = 16 * 1024;
+
+    std::unique_ptr<LocalBufferTracker> CreateArena(size_t const size)
+    {
+        auto const vertexBuffer = RB::CreateVertexBufferGroup(
+            LogicalDevice::GetVkDevice(),
+            LogicalDevice::GetPhysicalDevice(),
+            size,
+            (int)LogicalDevice::GetMaxFramePerFlight()
+        );
+
+        auto const stageBuffer = RB::CreateStageBuffer(
+            LogicalDevice::GetVkDevice(),
+            LogicalDevice::GetPhysicalDevice(),
+            vertexBuffer->bufferSize,
+            vertexBuffer->buffers.size()
+        );
+
+        return std::make_unique<LocalBufferTracker>(vertexBuffer, stageBuffer);
+    }
+
+    DisplayList::Bounds BoxBounds(litehtml::position const & box)
+    {
+        return DisplayList::Bounds{
+            .min = glm::vec2{static_cast<float>(box.x), static_cast<float>(box.y)},
+            .max = glm::vec2{static_cast<float>(box.x + box.width), static_cast<float>(box.y + box.height)}
+        };
+    }
+}
+
 //=========================================================================================
 
 WebViewContainer::WebViewContainer(
@@ -136,16 +170,32 @@ WebViewContainer::~WebViewContainer()
 
 void WebViewContainer::Update()
 {
+    if (_isDirty == false && _dirtyNodes.empty() == false)
+    {
+        // Only the boxes around the changed nodes are built and laid out again, A change that does not fit in place
+        // creates the document again
+        _isDirty = std::ranges::any_of(_dirtyNodes, [this](GumboNode * node)->bool
+        {
+            return _html->update_node(node) == false;
+        });
+        if (_isDirty == false)
+        {
+            _html->render_dirty(_clip.width);
+            RedrawDirty();
+        }
+        _dirtyNodes.clear();
+    }
+
     if (_isDirty == true)
     {
         //SCOPE_Profiler("Invalidate took");
         _isDirty = false;
-        SwitchActiveState();
+        _dirtyNodes.clear();
 
         _html = std::make_shared<litehtml::document>(this);
         _html->update_output(_gumboOutput);
         _html->render(_clip.width, litehtml::render_all);
-        _html->draw(_activeIdx, _clip.x, _clip.y, &_clip);
+        Redraw();
     }
 
     for (auto &state : _states)
@@ -172,48 +222,6 @@ void WebViewContainer::Update()
                 state.imageMap.erase(key);
             }
             invalidKeys.clear();
-
-            for (auto &[key, value] : state.textMap)
-            {
-                // It is not being used anywhere
-                if (value.use_count() == 1)
-                {
-                    invalidKeys.emplace_back(key);
-                }
-            }
-            for (auto const &key : invalidKeys)
-            {
-                state.imageMap.erase(key);
-            }
-            invalidKeys.clear();
-
-            for (auto &[key, value] : state.solidMap)
-            {
-                // It is not being used anywhere
-                if (value.use_count() == 1)
-                {
-                    invalidKeys.emplace_back(key);
-                }
-            }
-            for (auto const &key : invalidKeys)
-            {
-                state.solidMap.erase(key);
-            }
-            invalidKeys.clear();
-
-            for (auto &[key, value] : state.borderMap)
-            {
-                // It is not being used anywhere
-                if (value.use_count() == 1)
-                {
-                    invalidKeys.emplace_back(key);
-                }
-            }
-            for (auto const &key : invalidKeys)
-            {
-                state.borderMap.erase(key);
-            }
-            invalidKeys.clear();
         }
     }
     // _freeData = false;
@@ -225,9 +233,12 @@ void WebViewContainer::Update()
 
 void WebViewContainer::UpdateBuffer(RT::CommandRecordState & recordState)
 {
-    for (auto &bufferCall : _activeState->bufferCalls)
+    for (auto & arena : _activeState->arenas)
     {
-        bufferCall(recordState);
+        if (arena != nullptr)
+        {
+            arena->Update(recordState);
+        }
     }
 }
 
@@ -235,14 +246,53 @@ void WebViewContainer::UpdateBuffer(RT::CommandRecordState & recordState)
 
 void WebViewContainer::DisplayPass(RT::CommandRecordState &recordState)
 {
-    for (auto &drawCall : _activeState->drawCalls)
+    auto const & displayList = _activeState->displayList;
+    for (auto const & batch : displayList.GetBatches())
     {
-        drawCall(recordState);
+        auto const draws = displayList.GetDraws(batch);
+        auto const & arena = *_activeState->arenas[static_cast<size_t>(batch.type)];
+        switch (batch.type)
+        {
+        case DisplayList::PrimitiveType::SolidFill:
+            _solidFillRenderer->Draw(recordState, SolidFillPipeline::PushConstants{.model = _modelMat}, arena, draws);
+            break;
+        case DisplayList::PrimitiveType::Border:
+            _borderRenderer->Draw(recordState, BorderPipeline::PushConstants{.model = _modelMat}, arena, draws);
+            break;
+        case DisplayList::PrimitiveType::Image:
+            _imageRenderer->Draw(
+                recordState,
+                ImagePipeline::PushConstants{.model = _modelMat},
+                *static_cast<ImageRenderer::ImageData const *>(batch.resource),
+                arena,
+                draws
+            );
+            break;
+        case DisplayList::PrimitiveType::Text:
+            static_cast<FontRenderer const *>(batch.resource)->Draw(
+                recordState,
+                TextOverlayPipeline::PushConstants{.model = _modelMat},
+                arena,
+                draws
+            );
+            break;
+        default:
+            MFA_LOG_ERROR("Unhandled primitive type %d", static_cast<int>(batch.type));
+            break;
+        }
     }
 }
 
 //=========================================================================================
 
+DisplayList::Stats const & WebViewContainer::GetDisplayListStats() const
+{
+    MFA_ASSERT(_activeState != nullptr);
+    return _activeState->displayList.GetStats();
+}
+
+//=========================================================================================
+
 litehtml::element::ptr WebViewContainer::create_element(
 	const char* tag_name,
 	const litehtml::string_map& attributes,
@@ -272,12 +322,36 @@ litehtml::uint_ptr WebViewContainer::create_font(
     fm->height = static_cast<int>(fontRenderer->TextHeight((float)size));
     fm->draw_spaces = false;
 
-    _fontList.emplace_back();
-    auto & font = _fontList.back();
-    font.renderer = fontRenderer;
-    font.size = size;
-    font.id = (int)_fontList.size();
-	return font.id;
+    // Every document creates its fonts again, So handles are shared instead of growing the list
+    FontData * font = nullptr;
+    for (auto & fontData : _fontList)
+    {
+        if (fontData.refCount > 0 && fontData.renderer == fontRenderer && fontData.size == size)
+        {
+            font = &fontData;
+            break;
+        }
+    }
+    if (font == nullptr)
+    {
+        auto const findResult = std::ranges::find_if(_fontList, [](FontData const & fontData)->bool
+        {
+            return fontData.refCount <= 0;
+        });
+        if (findResult != _fontList.end())
+        {
+            font = &*findResult;
+        }
+        else
+        {
+            font = &_fontList.emplace_back();
+            font->id = (int)_fontList.size();
+        }
+        font->renderer = fontRenderer;
+        font->size = size;
+    }
+    ++font->refCount;
+	return font->id;
 }
 
 //=========================================================================================
@@ -291,7 +365,25 @@ void WebViewContainer::del_clip()
 
 void WebViewContainer::delete_font(litehtml::uint_ptr hFont)
 {
-	// TODO
+    // The asserts are gone in release, So a bad handle is skipped instead of writing out of the list
+    MFA_ASSERT(hFont > 0 && hFont <= _fontList.size());
+    if (hFont == 0 || hFont > _fontList.size())
+    {
+        MFA_LOG_ERROR("Invalid font handle %zu", static_cast<size_t>(hFont));
+        return;
+    }
+    auto & fontData = _fontList[hFont - 1];
+    MFA_ASSERT(fontData.refCount > 0);
+    if (fontData.refCount <= 0)
+    {
+        MFA_LOG_ERROR("Font %zu is deleted more often than it was created", static_cast<size_t>(hFont));
+        return;
+    }
+    --fontData.refCount;
+    if (fontData.refCount <= 0)
+    {
+        fontData.renderer = nullptr;
+    }
 }
 
 //=========================================================================================
@@ -303,10 +395,6 @@ void WebViewContainer::draw_borders(
 	bool root
 )
 {
-    std::shared_ptr<LocalBufferTracker> bufferTracker = nullptr;
-
-    auto hash = std::hash<litehtml::position>()(draw_pos);
-
     auto const x = static_cast<float>(draw_pos.x);
     auto const y = static_cast<float>(draw_pos.y);
     auto const width = static_cast<float>(draw_pos.width);
@@ -332,78 +420,30 @@ void WebViewContainer::draw_borders(
     auto const topRightRadius = glm::vec2{borders.radius.top_right_x, borders.radius.top_right_y};
     auto const bottomRightRadius = glm::vec2{borders.radius.bottom_right_x, borders.radius.bottom_right_y};
 
-    float leftWidth = borders.left.width;
-    float topWidth = borders.top.width;
-    float rightWidth = borders.right.width;
-    float bottomWidth = borders.bottom.width;
+    BorderPipeline::Instance const instance{
+        .topLeftPos = topLeftPos,
+        .topLeftRadius = topLeftRadius,
+        .topLeftColor = topLeftColor,
 
-    auto const findResult = _activeState->borderMap.find(hash);
-    if (findResult == _activeState->borderMap.end())
-    {
-        bufferTracker = _borderRenderer->AllocateBuffer(
-            topLeftPos,
-            bottomLeftPos,
-            topRightPos,
-            bottomRightPos,
-
-            topLeftColor,
-            bottomLeftColor,
-            topRightColor,
-            bottomRightColor,
-
-            topLeftRadius,
-            bottomLeftRadius,
-            topRightRadius,
-            bottomRightRadius,
-
-            leftWidth,
-            topWidth,
-            rightWidth,
-            bottomWidth
-        );
-        _activeState->borderMap[hash] = bufferTracker;
-    }
-    else
-    {
-        bufferTracker = findResult->second;
-        _borderRenderer->UpdateBuffer(
-            *bufferTracker,
-
-            topLeftPos,
-            bottomLeftPos,
-            topRightPos,
-            bottomRightPos,
-
-            topLeftColor,
-            bottomLeftColor,
-            topRightColor,
-            bottomRightColor,
-
-            topLeftRadius,
-            bottomLeftRadius,
-            topRightRadius,
-            bottomRightRadius,
-
-            leftWidth,
-            topWidth,
-            rightWidth,
-            bottomWidth
-        );
-    }
-    // TODO: Start from here replace all these with secondary command buffer
-	_activeState->drawCalls.emplace_back([this, bufferTracker](RT::CommandRecordState &recordState) -> void
-	{
-	    _borderRenderer->Draw(
-            recordState,
-            BorderPipeline::PushConstants{.model = _modelMat},
-            *bufferTracker
-        );
-	});
+        .bottomLeftPos = bottomLeftPos,
+        .bottomLeftRadius = bottomLeftRadius,
+        .bottomLeftColor = bottomLeftColor,
 
-    _activeState->bufferCalls.emplace_back([this, bufferTracker](RT::CommandRecordState &recordState) -> void
-    {
-        bufferTracker->Update(recordState);
-    });
+        .topRightPos = topRightPos,
+        .topRightRadius = topRightRadius,
+        .topRightColor = topRightColor,
+
+        .bottomRightPos = bottomRightPos,
+        .bottomRightRadius = bottomRightRadius,
+        .bottomRightColor = bottomRightColor,
+
+        .leftWidth = static_cast<float>(borders.left.width),
+        .topWidth = static_cast<float>(borders.top.width),
+        .rightWidth = static_cast<float>(borders.right.width),
+        .bottomWidth = static_cast<float>(borders.bottom.width)
+    };
+
+    _displayListCache.AddInstance(DisplayList::PrimitiveType::Border, nullptr, instance, BoxBounds(draw_pos));
 }
 
 //=========================================================================================
@@ -426,7 +466,6 @@ void WebViewContainer::draw_image(
 	const std::string& base_url
 )
 {
-    auto hash = std::hash<litehtml::background_layer>()(layer);
     auto const imagePath = Path::Get(url.c_str(), _parentAddress.c_str());
     auto [gpuTexture, _] = _requestImage(imagePath.c_str());
 
@@ -450,7 +489,6 @@ void WebViewContainer::draw_image(
     auto const topRightX = (float)layer.border_radius.top_right_x;
     auto const topRightY = (float)layer.border_radius.top_right_y;
     auto const topRightRadius = glm::vec2{topRightX, topRightY};
-    ;
 
     glm::vec2 const bottomLeftPos = topLeftPos + glm::vec2{0.0f, solidHeight};
     auto const bottomLeftX = (float)layer.border_radius.bottom_left_x;
@@ -462,40 +500,33 @@ void WebViewContainer::draw_image(
     auto const bottomRightY = (float)layer.border_radius.bottom_right_y;
     auto const bottomRightRadius = glm::vec2{bottomRightX, bottomRightY};
 
-    std::shared_ptr<ImageRenderer::ImageData> imageData = nullptr;
-    auto const findResult = _activeState->imageMap.find(hash);
-    if (findResult == _activeState->imageMap.end())
-    {
-        imageData = _imageRenderer->AllocateImageData(
-            *gpuTexture,
-            glm::vec3{topLeftPos, 0.0f}, glm::vec3{bottomLeftPos, 0.0f}, glm::vec3{topRightPos, 0.0f}, glm::vec3{bottomRightPos, 0.0f},
-            topLeftRadius, bottomLeftRadius, topRightRadius, bottomRightRadius,
-            ImagePipeline::UV{0.0f, 0.0f}, ImagePipeline::UV{0.0f, 1.0f}, ImagePipeline::UV{1.0f, 0.0f}, ImagePipeline::UV{1.0f, 1.0f}
-        );
-        _activeState->imageMap[hash] = imageData;
-    }
-    else
-    {
-        imageData = findResult->second;
-        _imageRenderer->UpdateImageData(
-            *imageData,
-            *gpuTexture,
-            glm::vec3{topLeftPos, 0.0f}, glm::vec3{bottomLeftPos, 0.0f}, glm::vec3{topRightPos, 0.0f}, glm::vec3{bottomRightPos, 0.0f},
-            topLeftRadius, bottomLeftRadius, topRightRadius, bottomRightRadius,
-            ImagePipeline::UV{0.0f, 0.0f}, ImagePipeline::UV{0.0f, 1.0f}, ImagePipeline::UV{1.0f, 0.0f}, ImagePipeline::UV{1.0f, 1.0f}
-        );
+    // The cache keeps the texture, EmitDisplayList gives every state its own descriptor set for it
+    _cachedTextures.try_emplace(gpuTexture.get(), gpuTexture);
 
-    }
+    ImagePipeline::Instance const instance{
+        .topLeftPos = topLeftPos,
+        .topLeftRadius = topLeftRadius,
+        .topLeftUV = ImagePipeline::UV{0.0f, 0.0f},
 
-    _activeState->drawCalls.emplace_back([this, imageData](RT::CommandRecordState & recordState)->void
-    {
-        _imageRenderer->Draw(recordState, ImagePipeline::PushConstants {.model = _modelMat}, *imageData);
-    });
+        .bottomLeftPos = bottomLeftPos,
+        .bottomLeftRadius = bottomLeftRadius,
+        .bottomLeftUV = ImagePipeline::UV{0.0f, 1.0f},
 
-    _activeState->bufferCalls.emplace_back([this, imageData](RT::CommandRecordState & recordState)->void
-    {
-        imageData->vertexData->Update(recordState);
-    });
+        .topRightPos = topRightPos,
+        .topRightRadius = topRightRadius,
+        .topRightUV = ImagePipeline::UV{1.0f, 0.0f},
+
+        .bottomRightPos = bottomRightPos,
+        .bottomRightRadius = bottomRightRadius,
+        .bottomRightUV = ImagePipeline::UV{1.0f, 1.0f},
+    };
+
+    _displayListCache.AddInstance(
+        DisplayList::PrimitiveType::Image,
+        gpuTexture.get(),
+        instance,
+        BoxBounds(layer.border_box)
+    );
 }
 
 //=========================================================================================
@@ -535,10 +566,6 @@ void WebViewContainer::draw_solid_fill(
 	const litehtml::web_color& color
 )
 {
-    std::shared_ptr<LocalBufferTracker> bufferTracker = nullptr;
-
-    auto hash = std::hash<litehtml::background_layer>()(layer);
-
     auto const borderX = static_cast<float>(layer.border_box.x);
     auto const borderY = static_cast<float>(layer.border_box.y);
 
@@ -569,41 +596,30 @@ void WebViewContainer::draw_solid_fill(
     auto const bottomRightY = (float)layer.border_radius.bottom_right_y;
     auto const bottomRightRadius = glm::vec2{bottomRightX, bottomRightY};
 
-    auto const findResult = _activeState->solidMap.find(hash);
-    if (findResult == _activeState->solidMap.end())
-    {
-        bufferTracker = _solidFillRenderer->AllocateBuffer(
-            topLeftPos, bottomLeftPos, topRightPos, bottomRightPos,
-            topLeftColor, bottomLeftColor, topRightColor, bottomRightColor,
-            topLeftRadius, bottomLeftRadius,
-            topRightRadius, bottomRightRadius
-        );
-        _activeState->solidMap[hash] = bufferTracker;
-    }
-    else
-    {
-        bufferTracker = findResult->second;
-        _solidFillRenderer->UpdateBuffer(
-            *bufferTracker,
-            topLeftPos, bottomLeftPos, topRightPos, bottomRightPos,
-            topLeftColor, bottomLeftColor, topRightColor, bottomRightColor,
-            topLeftRadius, bottomLeftRadius, topRightRadius, bottomRightRadius
-        );
-    }
+    SolidFillPipeline::Instance const instance{
+        .topLeftPos = topLeftPos,
+        .topLeftRadius = topLeftRadius,
+        .topLeftColor = topLeftColor,
 
-	_activeState->drawCalls.emplace_back([this, bufferTracker](RT::CommandRecordState &recordState) -> void
-	{
-	    _solidFillRenderer->Draw(
-            recordState,
-            SolidFillPipeline::PushConstants{.model = _modelMat},
-            *bufferTracker
-        );
-	});
+        .bottomLeftPos = bottomLeftPos,
+        .bottomLeftRadius = bottomLeftRadius,
+        .bottomLeftColor = bottomLeftColor,
 
-    _activeState->bufferCalls.emplace_back([this, bufferTracker](RT::CommandRecordState &recordState) -> void
-    {
-        bufferTracker->Update(recordState);
-    });
+        .topRightPos = topRightPos,
+        .topRightRadius = topRightRadius,
+        .topRightColor = topRightColor,
+
+        .bottomRightPos = bottomRightPos,
+        .bottomRightRadius = bottomRightRadius,
+        .bottomRightColor = bottomRightColor,
+    };
+
+    _displayListCache.AddInstance(
+        DisplayList::PrimitiveType::SolidFill,
+        nullptr,
+        instance,
+        BoxBounds(layer.border_box)
+    );
 }
 
 //=========================================================================================
@@ -616,45 +632,46 @@ void WebViewContainer::draw_text(
 	const litehtml::position& pos
 )
 {
-    auto const hash = std::hash<litehtml::position>()(pos);
     auto & fontData = _fontList[hFont - 1];
 
-    auto const x = static_cast<float>(pos.x);
-    auto const y = static_cast<float>(pos.y);
-
-    FontRenderer::TextParams textParams{};
-    textParams.color = ConvertColor(color);
-    textParams.hTextAlign = FontRenderer::HorizontalTextAlign::Left;
-    textParams.fontSizeInPixels = (float)fontData.size;
-
-    std::shared_ptr<FontRenderer::TextData> textData = nullptr;
-    auto const findResult = _activeState->textMap.find(hash);
-    if (findResult == _activeState->textMap.end())
+    // Only the position and the color differ from the last time this text was drawn
+    auto const & glyphRun = fontData.renderer->GetGlyphRun(
+        std::string_view{text, strlen(text)},
+        (float)fontData.size
+    );
+    if (glyphRun.vertices.empty() == true)
     {
-        textData = fontData.renderer->AllocateTextData(1024);
-        _activeState->textMap[hash] = textData;
+        return;
     }
-    else
+
+    glm::vec2 const offset{static_cast<float>(pos.x), static_cast<float>(pos.y)};
+    glm::vec3 const textColor{ConvertColor(color)};
+
+    auto const vertexCount = static_cast<uint32_t>(glyphRun.vertices.size());
+    _textVertices.resize(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; ++i)
     {
-        textData = findResult->second;
+        auto & vertex = _textVertices[i];
+        vertex.position = glyphRun.vertices[i].position + offset;
+        vertex.uv = glyphRun.vertices[i].uv;
+        vertex.color = textColor;
     }
 
-    fontData.renderer->ResetText(*textData);
-    fontData.renderer->AddText(*textData, text, x, y, textParams);
+    DisplayList::Bounds const bounds{.min = glyphRun.min + offset, .max = glyphRun.max + offset};
 
-    _activeState->drawCalls.emplace_back([this, textData, &fontData](RT::CommandRecordState &recordState) -> void
-	{
-	    fontData.renderer->Draw(
-            recordState,
-            TextOverlayPipeline::PushConstants{ .model = _modelMat },
-            *textData
-        );
-	});
+    _displayListCache.AddVertices(
+        DisplayList::PrimitiveType::Text,
+        fontData.renderer.get(),
+        _textVertices.data(),
+        vertexCount,
+        bounds
+    );
 
-    _activeState->bufferCalls.emplace_back([this, textData](RT::CommandRecordState &recordState) -> void
+    // The font can be deleted while the cache still points to it
+    if (std::ranges::find(_cachedFonts, fontData.renderer) == _cachedFonts.end())
     {
-        textData->vertexData->Update(recordState);
-    });
+        _cachedFonts.emplace_back(fontData.renderer);
+    }
 }
 
 //=========================================================================================
@@ -811,8 +828,12 @@ void WebViewContainer::set_cursor(const char* cursor)
 int WebViewContainer::text_width(const char* text, litehtml::uint_ptr hFont)
 {
     auto & fontData = _fontList[hFont - 1];
-    auto const textWidth = fontData.renderer->TextWidth(std::string_view{text, strlen(text)}, fontData.size);
-    return static_cast<int>(textWidth);
+    // Layout measures the same words that draw_text emits, So both share the glyph run
+    auto const & glyphRun = fontData.renderer->GetGlyphRun(
+        std::string_view{text, strlen(text)},
+        (float)fontData.size
+    );
+    return static_cast<int>(glyphRun.width);
 }
 
 //=========================================================================================
@@ -824,6 +845,20 @@ void WebViewContainer::transform_text(litehtml::string& text, litehtml::text_tra
 
 //=========================================================================================
 
+void WebViewContainer::begin_draw_item(litehtml::uint_ptr hdc, litehtml::uint_ptr key)
+{
+    _displayListCache.BeginItem(key);
+}
+
+//=========================================================================================
+
+void WebViewContainer::end_draw_item(litehtml::uint_ptr hdc)
+{
+    _displayListCache.EndItem();
+}
+
+//=========================================================================================
+
 glm::vec4 WebViewContainer::ConvertColor(litehtml::web_color const& webColor)
 {
 	return glm::vec4
@@ -857,8 +892,126 @@ void WebViewContainer::SwitchActiveState()
         _states.emplace_back();
     }
     _activeState = &_states[_activeIdx];
-    _activeState->drawCalls.clear();
-    _activeState->bufferCalls.clear();
+    _activeState->usedImages.clear();
+    _activeState->usedFonts.clear();
+}
+
+//=========================================================================================
+
+void WebViewContainer::Redraw()
+{
+    _displayListCache.Begin();
+    _cachedTextures.clear();
+    _cachedFonts.clear();
+    _html->draw(0, _clip.x, _clip.y, &_clip);
+    _displayListCache.End();
+    EmitDisplayList();
+}
+
+//=========================================================================================
+
+void WebViewContainer::RedrawDirty()
+{
+    // The draw items of the laid out boxes replace their old primitives, Everything else is replayed as it is
+    _displayListCache.BeginUpdate();
+    bool const isDrawn = _html->draw_dirty(0, &_clip);
+    bool const isUpdated = _displayListCache.EndUpdate();
+    if (isDrawn == false || isUpdated == false)
+    {
+        Redraw();
+        return;
+    }
+    EmitDisplayList();
+}
+
+//=========================================================================================
+
+void WebViewContainer::EmitDisplayList()
+{
+    // The states in flight own their arenas and their image descriptors, So each one gets its own copy of the cache
+    SwitchActiveState();
+
+    _activeState->displayList.Begin();
+    _displayListCache.Replay(
+        _activeState->displayList,
+        [this](DisplayList::PrimitiveType const type, void const * resource)->void const *
+        {
+            if (type == DisplayList::PrimitiveType::Image)
+            {
+                auto const & gpuTexture = _cachedTextures.at(static_cast<RT::GpuTexture const *>(resource));
+                // One descriptor set per texture, So every image with the same texture ends up in one batch
+                auto const hash = std::hash<RT::GpuTexture const *>()(gpuTexture.get());
+                std::shared_ptr<ImageRenderer::ImageData> imageData = nullptr;
+                auto const findResult = _activeState->imageMap.find(hash);
+                if (findResult == _activeState->imageMap.end())
+                {
+                    imageData = _imageRenderer->AllocateImageData(*gpuTexture);
+                    _activeState->imageMap[hash] = imageData;
+                }
+                else
+                {
+                    imageData = findResult->second;
+                    _imageRenderer->UpdateImageData(*imageData, *gpuTexture);
+                }
+                _activeState->usedImages.emplace_back(imageData);
+                return imageData.get();
+            }
+            if (type == DisplayList::PrimitiveType::Text)
+            {
+                // Fonts that the text batches point to, So deleting a font does not free them
+                auto const findResult = std::ranges::find_if(_cachedFonts, [resource](auto const & font)->bool
+                {
+                    return font.get() == resource;
+                });
+                MFA_ASSERT(findResult != _cachedFonts.end());
+                if (findResult != _cachedFonts.end())
+                {
+                    _activeState->usedFonts.emplace_back(*findResult);
+                }
+            }
+            return resource;
+        }
+    );
+    _activeState->displayList.End();
+    UploadDisplayList();
+}
+
+//=========================================================================================
+
+void WebViewContainer::MarkDirty(GumboNode * node)
+{
+    if (std::ranges::find(_dirtyNodes, node) == _dirtyNodes.end())
+    {
+        _dirtyNodes.emplace_back(node);
+    }
+}
+
+//=========================================================================================
+
+void WebViewContainer::UploadDisplayList()
+{
+    auto & displayList = _activeState->displayList;
+    for (size_t i = 0; i < DisplayList::PrimitiveTypeCount; ++i)
+    {
+        auto const & bytes = displayList.GetArena(static_cast<DisplayList::PrimitiveType>(i));
+        if (bytes.empty() == true)
+        {
+            continue;
+        }
+
+        auto & arena = _activeState->arenas[i];
+        if (arena == nullptr || arena->LocalBuffer().bufferSize < bytes.size())
+        {
+            // The state is not in flight anymore when it gets activated, So the old buffer can go right away
+            size_t arenaSize = MinArenaSize;
+            while (arenaSize < bytes.size())
+            {
+                arenaSize *= 2;
+            }
+            arena = CreateArena(arenaSize);
+        }
+        arena->SetData(Alias(bytes.data(), bytes.size()));
+    }
 }
 
 //=========================================================================================
@@ -886,7 +1039,7 @@ void WebViewContainer::SetText(GumboNode *node, char const *text)
                 }
                 // Replace the text by modifying the C string (not ideal)
                 child->v.text.text = strdup(text); // Replace with your own string
-                _isDirty = true;
+                MarkDirty(node);
                 break;
             }
         }
@@ -929,7 +1082,7 @@ void WebViewContainer::AddClass(GumboNode *node, char const *keyword)
         attributes->data = new_data;
         attributes->length += 1;
 
-        _isDirty = true;
+        MarkDirty(node);
     }
     else
     {
@@ -955,7 +1108,7 @@ void WebViewContainer::AddClass(GumboNode *node, char const *keyword)
             free((void *)class_attr->value);  // Free old value
             class_attr->value = strdup(updated.c_str());
 
-            _isDirty = true;
+            MarkDirty(node);
         }
     }
 }
@@ -987,7 +1140,7 @@ void WebViewContainer::RemoveClass(GumboNode *node, char const *keyword)
             free((void *)class_attr->value);  // Free old value
             class_attr->value = strdup(value.c_str());
 
-            _isDirty = true;
+            MarkDirty(node);
         }
     }
 }
@@ -1048,6 +1201,8 @@ void WebViewContainer::OnReload(litehtml::position clip)
         litehtml::document::destroy_output(_gumboOutput);
         _gumboOutput = nullptr;
     }
+    // The nodes belong to the old output
+    _dirtyNodes.clear();
     _htmlBlob = _requestBlob(_htmlAddress.c_str(), false);
     char const *htmlText = _htmlBlob->As<char const>();
     _gumboOutput = litehtml::document::parse_html(htmlText);
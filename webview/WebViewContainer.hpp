@@ -1,6 +1,8 @@
 #pragma once
 
 #include "renderer/CustomFontRenderer.hpp"
+#include "renderer/DisplayList.hpp"
+#include "renderer/DisplayListCache.hpp"
 #include "renderer/ImageRenderer.hpp"
 
 #include <gumbo.h>
@@ -57,6 +59,10 @@ public:
 
 	void DisplayPass(MFA::RT::CommandRecordState& recordState);
 
+    // Counters of the display list that is currently drawn
+    [[nodiscard]]
+    MFA::DisplayList::Stats const & GetDisplayListStats() const;
+
     [[nodiscard]]
     GumboNode * GetElementById(const char *id);
 
@@ -192,6 +198,10 @@ protected:
 
 	void transform_text(litehtml::string& text, litehtml::text_transform tt) override;
 
+	void begin_draw_item(litehtml::uint_ptr hdc, litehtml::uint_ptr key) override;
+
+	void end_draw_item(litehtml::uint_ptr hdc) override;
+
 private:
 
 	[[nodiscard]]
@@ -199,6 +209,20 @@ private:
 
     void SwitchActiveState();
 
+    // Draws the whole document into the display list cache
+    void Redraw();
+
+    // Draws only the boxes that render_dirty laid out again, Falls back to Redraw when the cache has no place for them
+    void RedrawDirty();
+
+    // Replays the display list cache into the display list of a new state
+    void EmitDisplayList();
+
+    void MarkDirty(GumboNode * node);
+
+    // Copies the arenas of the active display list into its vertex buffers
+    void UploadDisplayList();
+
     std::string _htmlAddress{};
     std::shared_ptr<SolidFillRenderer> _solidFillRenderer = nullptr;
     std::shared_ptr<ImageRenderer> _imageRenderer = nullptr;
@@ -212,10 +236,13 @@ private:
 
 	litehtml::position _clip {};
 
+    // Handles are the index plus one, Documents that ask for the same face and size share a handle
     struct FontData
     {
         int id = -1;
         int size = 14;
+        // Slot can be reused by create_font when it drops to zero
+        int refCount = 0;
         std::shared_ptr<FontRenderer> renderer{};
     };
     std::vector<FontData> _fontList{};
@@ -230,6 +257,8 @@ private:
     glm::mat4 _modelMat{};
 
 	bool _isDirty = true;
+    // Nodes whose text or classes changed since the last Update, Updated in place without creating the document again
+    std::vector<GumboNode *> _dirtyNodes{};
     // bool _freeData = false;
 
     template<typename Value>
@@ -237,15 +266,26 @@ private:
 
     struct State
     {
-        std::vector<std::function<void(MFA::RT::CommandRecordState &)>> drawCalls{};
-        std::vector<std::function<void(MFA::RT::CommandRecordState &)>> bufferCalls{};
-        StateMap<FontRenderer::TextData> textMap{};
+        MFA::DisplayList displayList{};
+        // One vertex buffer per primitive type, Grows when the display list does not fit anymore
+        std::array<std::unique_ptr<MFA::LocalBufferTracker>, MFA::DisplayList::PrimitiveTypeCount> arenas{};
+        // Descriptor sets of the images, Keyed by texture
         StateMap<ImageRenderer::ImageData> imageMap{};
-        StateMap<MFA::LocalBufferTracker> solidMap{};
-        StateMap<MFA::LocalBufferTracker> borderMap{};
+        // Images that the display list points to, So the cleanup does not free them
+        std::vector<std::shared_ptr<ImageRenderer::ImageData>> usedImages{};
+        // Fonts that the text batches point to, So deleting a font does not free them
+        std::vector<std::shared_ptr<FontRenderer>> usedFonts{};
         int lifeTime{};
     };
     std::vector<State> _states{};
     int _activeIdx = 0;
     State * _activeState = nullptr;
+
+    std::vector<FontRenderer::Pipeline::Vertex> _textVertices{};
+
+    // Primitives of the page keyed by the draw items of litehtml, Shared by all states
+    MFA::DisplayListCache _displayListCache{};
+    // Textures and fonts that the cache points to, Kept until the next Redraw records the page from scratch
+    std::unordered_map<MFA::RT::GpuTexture const *, std::shared_ptr<MFA::RT::GpuTexture>> _cachedTextures{};
+    std::vector<std::shared_ptr<FontRenderer>> _cachedFonts{};
 };
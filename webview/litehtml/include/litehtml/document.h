@@ -6,6 +6,7 @@
 #include "master_css.h"
 #include "encodings.h"
 typedef struct GumboInternalOutput GumboOutput;
+typedef struct GumboInternalNode GumboNode;
 
 namespace litehtml
 {
@@ -67,6 +68,38 @@ namespace litehtml
 		string								m_culture;
 		// string								m_text;
 		document_mode						m_mode = no_quirks_mode;
+	private:
+		struct box_state
+		{
+			position					pos;
+			margins						box_margins;
+			margins						box_paddings;
+			margins						box_borders;
+			int							first_baseline = 0;
+			int							last_baseline = 0;
+			containing_block_context	cb_context;
+
+			static box_state from(const std::shared_ptr<render_item>& ri);
+		};
+
+		struct dirty_render
+		{
+			// Closest block box of a changed element, Gets new render items
+			element::ptr					el;
+			std::shared_ptr<render_item>	ri;
+			// Box that is laid out on its own, nullptr when the whole tree has to be rendered
+			std::shared_ptr<render_item>	layout_ri;
+			box_state						layout_box;
+			int								depth = 0;
+		};
+
+		std::map<const GumboNode*, element::weak_ptr>	m_node_elements;
+		std::vector<dirty_render>			m_dirty_renders;
+		bool								m_render_dirty = false;
+		// Boxes that render_dirty laid out, draw_dirty draws them again
+		std::vector<std::shared_ptr<render_item>>	m_redraw_items;
+		bool								m_redraw_all = true;
+		bool								m_has_sibling_selectors = false;
 	public:
 		document(document_container* objContainer);
 		virtual ~document();
@@ -114,12 +147,27 @@ namespace litehtml
 		static void destroy_output(GumboOutput *output);
 		void update_output(GumboOutput* gumbo);
 	    void update_styles(const string& master_styles, const string& user_styles);
+		// Re-creates and restyles the elements of a node after its text or attributes changed in the gumbo tree.
+		// Returns false when the change can not be applied in place, The document has to be created again then.
+		bool update_node(GumboNode* node);
+		// Lays out the boxes that update_node changed. Only boxes whose size does not depend on their content are
+		// laid out on their own, Everything else renders the whole tree again.
+		void render_dirty(int max_width);
+		// Draws only the boxes that the last render_dirty laid out, Between begin_draw_item and end_draw_item of their
+		// keys. Returns false when the whole document has to be drawn, After render or for a box that is not an item.
+		bool draw_dirty(uint_ptr hdc, const position* clip);
 
 	private:
 		uint_ptr	add_font(const char* name, int size, const char* weight, const char* style, const char* decoration, font_metrics* fm);
 
 		void apply_changes();
+		void create_render_tree();
 		void create_node(void* gnode, elements_list& elements, bool parseTextNode);
+		void add_dirty_render(const element::ptr& el, const element::ptr& old_el);
+		std::shared_ptr<render_item> rebuild_render_item(const element::ptr& el, const std::shared_ptr<render_item>& old_ri);
+		bool render_subtree(const std::shared_ptr<render_item>& ri, const box_state& old_box);
+		bool is_attached(const element::ptr& el) const;
+		bool is_attached(const std::shared_ptr<render_item>& ri) const;
 		bool update_media_lists(const media_features& features);
 		void fix_tables_layout();
 		void fix_table_children(const std::shared_ptr<render_item>& el_ptr, style_display disp, const char* disp_str);
@@ -69,6 +69,10 @@ namespace litehtml
 		virtual void				get_language(litehtml::string& language, litehtml::string& culture) const = 0;
 		virtual litehtml::string	resolve_color(const litehtml::string& /*color*/) const { return litehtml::string(); }
 		virtual void				split_text(const char* text, const std::function<void(const char*)>& on_word, const std::function<void(const char*)>& on_space);
+		// Brackets what a block box in normal flow draws in one pass. The key stays the same when render_dirty builds
+		// the box again, So a container can keep the primitives of every key and replace only the ones of draw_dirty.
+		virtual void				begin_draw_item(litehtml::uint_ptr /*hdc*/, litehtml::uint_ptr /*key*/) {}
+		virtual void				end_draw_item(litehtml::uint_ptr /*hdc*/) {}
 
 	protected:
 		virtual ~document_container() = default;
@@ -25,7 +25,12 @@ namespace litehtml
         margins						                m_borders;
         position					                m_pos;
         bool                                        m_skip;
+        containing_block_context                    m_cb_context;
         std::vector<std::shared_ptr<render_item>>   m_positioned;
+        // Identifies the box in begin_draw_item, And the offset that the parent passed on the last draw
+        uint_ptr                                    m_draw_key;
+        int                                         m_draw_x;
+        int                                         m_draw_y;
 
 		containing_block_context calculate_containing_block_context(const containing_block_context& cb_context);
 		void calc_cb_length(const css_length& len, int percent_base, containing_block_context::typed_int& out_value) const;
@@ -59,6 +64,14 @@ namespace litehtml
             m_skip = val;
         }
 
+		/**
+		 * Containing block of the last render() call. Used to render the item again without its parent.
+		 */
+		const containing_block_context& cb_context() const
+		{
+			return m_cb_context;
+		}
+
         int right() const
         {
             return left() + width();
@@ -416,6 +429,32 @@ namespace litehtml
 		virtual void clear_inline_boxes() {};
         void draw_stacking_context( uint_ptr hdc, int x, int y, const position* clip, bool with_positioned );
         virtual void draw_children( uint_ptr hdc, int x, int y, const position* clip, draw_flag flag, int zindex );
+        /**
+         * Block box in normal flow. It draws the same primitives in the block, floats and inlines passes wherever
+         * the passes start, So each pass of it is one item of the container.
+         */
+        bool is_draw_item() const
+        {
+            return !src_el()->is_inline() && src_el()->css().get_float() == float_none && !src_el()->is_positioned();
+        }
+        uint_ptr draw_key(draw_flag flag) const
+        {
+            return (m_draw_key << 3) | flag;
+        }
+        /**
+         * Takes the draw key and offset of the box that this one replaces
+         */
+        void replace_draw_item(const render_item& old_ri)
+        {
+            m_draw_key = old_ri.m_draw_key;
+            m_draw_x = old_ri.m_draw_x;
+            m_draw_y = old_ri.m_draw_y;
+        }
+        /**
+         * Draws the items of the box again at the offset of the last draw. The parents are not drawn, So their clip
+         * is not set.
+         */
+        void draw_item(uint_ptr hdc, const position* clip);
         virtual int get_draw_vertical_offset() { return 0; }
         virtual std::shared_ptr<element> get_child_by_point(int x, int y, int client_x, int client_y, draw_flag flag, int zindex);
         std::shared_ptr<element> get_element_by_point(int x, int y, int client_x, int client_y);
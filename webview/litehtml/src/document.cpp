@@ -275,6 +275,7 @@ void document::update_output(GumboOutput *output) {
 
   // Create litehtml::elements.
   elements_list root_elements;
+  this->m_node_elements.clear();
   this->create_node(output->root, root_elements, true);
   if (!root_elements.empty())
   {
@@ -342,21 +343,420 @@ void document::apply_changes()
     // Initialize element::m_css
     this->m_root->compute_styles();
 
-    // Create rendering tree
-    this->m_root_render = this->m_root->create_render_item(nullptr);
+    // A changed class can restyle the siblings of an element through these, update_node only restyles the element
+    this->m_has_sibling_selectors = false;
+    for (const auto* sheet : {&this->m_master_css, &this->m_styles, &this->m_user_css})
+    {
+      for (const auto& sel : sheet->selectors())
+      {
+        for (auto part = sel; part; part = part->m_left)
+        {
+          if (part->m_left && (part->m_combinator == combinator_adjacent_sibling || part->m_combinator == combinator_general_sibling))
+          {
+            this->m_has_sibling_selectors = true;
+          }
+        }
+      }
+    }
+
+    this->create_render_tree();
+  }
+}
+
+void document::create_render_tree()
+{
+  this->m_dirty_renders.clear();
+  this->m_render_dirty = false;
+  this->m_tabular_elements.clear();
+
+  // Create rendering tree
+  this->m_root_render = this->m_root->create_render_item(nullptr);
+
+  // Now the m_tabular_elements is filled with tabular elements.
+  // We have to check the tabular elements for missing table elements
+  // and create the anonymous boxes in visual table layout
+  this->fix_tables_layout();
+
+  // Finally initialize elements
+  // init() returns pointer to the render_init element because it can change its type
+  if(this->m_root_render)
+  {
+    this->m_root_render = this->m_root_render->init();
+  }
+}
+
+// The parent keeps its render item for the element that el replaced, The new one has to take the same place
+static bool is_rebuild_root(const element::ptr& el, const std::shared_ptr<render_item>& ri)
+{
+  const auto display = el->css().get_display();
+  if (display != display_block && display != display_flex)
+  {
+    return false;
+  }
+  return ri->src_el()->css().get_display() == display;
+}
+
+static bool is_layout_root(const element::ptr& el, const std::shared_ptr<render_item>& ri)
+{
+  const auto& css = el->css();
+  if (css.get_display() != display_block && css.get_display() != display_flex)
+  {
+    return false;
+  }
+  if (ri->src_el()->css().get_display() != css.get_display())
+  {
+    return false;
+  }
+  if (css.get_position() != element_position_static && css.get_position() != element_position_relative)
+  {
+    return false;
+  }
+  if (css.get_float() != float_none || !el->is_block_formatting_context())
+  {
+    return false;
+  }
+  if (css.get_width().is_predefined() || css.get_height().is_predefined())
+  {
+    return false;
+  }
+  auto parent = ri->parent();
+  if (parent && (parent->css().get_display() == display_flex || parent->css().get_display() == display_inline_flex))
+  {
+    // A flex item never gets smaller than its content unless it has a minimum size
+    if (css.get_min_width().is_predefined() || css.get_min_height().is_predefined())
+    {
+      return false;
+    }
+    if (css.get_flex_basis().is_predefined() && css.get_flex_basis().predef() != flex_basis_auto)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Positioned boxes are collected by their ancestors, Only a render of the whole tree collects them again
+static bool has_positioned(const std::shared_ptr<render_item>& ri)
+{
+  if (ri->src_el()->css().get_position() != element_position_static)
+  {
+    return true;
+  }
+  for (const auto& child : ri->children())
+  {
+    if (has_positioned(child))
+    {
+      return true;
+    }
+  }
+  return false;
+}
 
-    // Now the m_tabular_elements is filled with tabular elements.
-    // We have to check the tabular elements for missing table elements
-    // and create the anonymous boxes in visual table layout
-    this->fix_tables_layout();
+static bool same_margins(const margins& lhs, const margins& rhs)
+{
+  return lhs.left == rhs.left && lhs.right == rhs.right && lhs.top == rhs.top && lhs.bottom == rhs.bottom;
+}
 
-    // Finally initialize elements
-    // init() returns pointer to the render_init element because it can change its type
-    if(this->m_root_render)
+document::box_state document::box_state::from(const std::shared_ptr<render_item>& ri)
+{
+  box_state ret;
+  ret.pos = ri->pos();
+  ret.box_margins = ri->get_margins();
+  ret.box_paddings = ri->get_paddings();
+  ret.box_borders = ri->get_borders();
+  ret.first_baseline = ri->get_first_baseline();
+  ret.last_baseline = ri->get_last_baseline();
+  ret.cb_context = ri->cb_context();
+  return ret;
+}
+
+bool document::update_node(GumboNode* node)
+{
+  auto found = this->m_node_elements.find(node);
+  if (found == this->m_node_elements.end() || this->m_has_sibling_selectors)
+  {
+    return false;
+  }
+  element::ptr old_el = found->second.lock();
+  element::ptr parent = old_el ? old_el->parent() : nullptr;
+  if (!parent)
+  {
+    return false;
+  }
+  auto child = std::find(parent->m_children.begin(), parent->m_children.end(), old_el);
+  if (child == parent->m_children.end())
+  {
+    return false;
+  }
+
+  elements_list new_elements;
+  this->create_node(node, new_elements, true);
+  if (new_elements.size() != 1)
+  {
+    return false;
+  }
+  element::ptr new_el = new_elements.front();
+  *child = new_el;
+  new_el->parent(parent);
+  old_el->parent(nullptr);
+
+  // Same steps as apply_changes, The new elements inherit from the parent so they have to be in the tree first
+  new_el->apply_stylesheet(this->m_master_css);
+  new_el->parse_attributes();
+  new_el->apply_stylesheet(this->m_styles);
+  new_el->apply_stylesheet(this->m_user_css);
+  new_el->compute_styles();
+
+  this->add_dirty_render(new_el, old_el);
+  return true;
+}
+
+void document::add_dirty_render(const element::ptr& el, const element::ptr& old_el)
+{
+  if (this->m_render_dirty)
+  {
+    return;
+  }
+
+  // old_el can be waiting for its render items itself, The old element still owns them then
+  element::ptr src = old_el;
+  for (auto pending = this->m_dirty_renders.begin(); pending != this->m_dirty_renders.end(); ++pending)
+  {
+    if (pending->el == old_el)
+    {
+      src = pending->ri->src_el();
+      this->m_dirty_renders.erase(pending);
+      break;
+    }
+  }
+  // Nothing to do when an ancestor gets new render items anyway
+  for (auto parent = el->parent(); parent; parent = parent->parent())
+  {
+    for (const auto& pending : this->m_dirty_renders)
+    {
+      if (pending.el == parent)
+      {
+        return;
+      }
+    }
+  }
+
+  // The closest block box gets new render items, Inline content is owned by the box around it
+  dirty_render dirty;
+  element::ptr cur = el;
+  while (!dirty.ri)
+  {
+    if (!cur || cur == this->m_root)
     {
-      this->m_root_render = this->m_root_render->init();
+      this->m_render_dirty = true;
+      return;
     }
+    src->m_renders.remove_if([](const std::weak_ptr<render_item>& ri) { return ri.expired(); });
+    if (src->m_renders.size() == 1)
+    {
+      auto ri = src->m_renders.front().lock();
+      if (ri->parent() && is_rebuild_root(cur, ri))
+      {
+        dirty.el = cur;
+        dirty.ri = ri;
+      }
+    }
+    cur = cur->parent();
+    src = cur;
+  }
+  for (auto parent = dirty.ri->parent(); parent; parent = parent->parent())
+  {
+    dirty.depth++;
+  }
+
+  // Walks up to the first box whose size does not depend on its content. Laying out that box on its own gives the
+  // same result as laying out the whole tree.
+  for (auto ri = dirty.ri; ri->parent(); ri = ri->parent())
+  {
+    if (is_layout_root(ri == dirty.ri ? dirty.el : ri->src_el(), ri))
+    {
+      dirty.layout_ri = ri;
+      dirty.layout_box = box_state::from(ri);
+      break;
+    }
+  }
+  this->m_dirty_renders.push_back(std::move(dirty));
+}
+
+void document::render_dirty(int max_width)
+{
+  bool render_all = false;
+  std::vector<std::tuple<std::shared_ptr<render_item>, box_state>> layouts;
+  if (!this->m_render_dirty)
+  {
+    // Outer boxes first, A box inside one that is built again is skipped
+    std::stable_sort(this->m_dirty_renders.begin(), this->m_dirty_renders.end(),
+      [](const dirty_render& lhs, const dirty_render& rhs) { return lhs.depth < rhs.depth; });
+    for (const auto& dirty : this->m_dirty_renders)
+    {
+      if (!this->is_attached(dirty.el) || !this->is_attached(dirty.ri))
+      {
+        continue;
+      }
+      auto ri = this->rebuild_render_item(dirty.el, dirty.ri);
+      if (!ri)
+      {
+        this->m_render_dirty = true;
+        break;
+      }
+      if (!dirty.layout_ri || has_positioned(dirty.ri) || has_positioned(ri))
+      {
+        render_all = true;
+      }
+      else
+      {
+        layouts.emplace_back(dirty.layout_ri == dirty.ri ? ri : dirty.layout_ri, dirty.layout_box);
+      }
+    }
+  }
+  this->m_dirty_renders.clear();
+
+  if (this->m_render_dirty)
+  {
+    this->create_render_tree();
+    render_all = true;
+  }
+  if (!render_all)
+  {
+    for (const auto& [ri, box] : layouts)
+    {
+      // Skipped when it is inside a box that was built again
+      if (this->is_attached(ri) && !this->render_subtree(ri, box))
+      {
+        render_all = true;
+        break;
+      }
+    }
+  }
+  if (render_all)
+  {
+    this->render(max_width);
+  }
+  else
+  {
+    this->m_redraw_all = false;
+    for (const auto& [ri, box] : layouts)
+    {
+      this->m_redraw_items.push_back(ri);
+    }
+  }
+}
+
+bool document::draw_dirty(uint_ptr hdc, const position* clip)
+{
+  if (this->m_redraw_all)
+  {
+    return false;
+  }
+  std::vector<std::shared_ptr<render_item>> items;
+  for (const auto& ri : this->m_redraw_items)
+  {
+    if (!this->is_attached(ri) || std::find(items.begin(), items.end(), ri) != items.end())
+    {
+      continue;
+    }
+    // Positioned boxes are drawn by their stacking context, Outside the items of the box
+    if (!ri->is_draw_item() || has_positioned(ri))
+    {
+      return false;
+    }
+    items.push_back(ri);
+  }
+  // A box inside another one is drawn with it
+  for (const auto& ri : items)
+  {
+    bool is_nested = false;
+    for (auto parent = ri->parent(); parent && !is_nested; parent = parent->parent())
+    {
+      is_nested = std::find(items.begin(), items.end(), parent) != items.end();
+    }
+    if (!is_nested)
+    {
+      ri->draw_item(hdc, clip);
+    }
+  }
+  this->m_redraw_items.clear();
+  this->m_redraw_all = true;
+  return true;
+}
+
+std::shared_ptr<render_item> document::rebuild_render_item(const element::ptr& el, const std::shared_ptr<render_item>& old_ri)
+{
+  auto parent_ri = old_ri->parent();
+  auto& siblings = parent_ri->children();
+  auto sibling = std::find(siblings.begin(), siblings.end(), old_ri);
+  if (sibling == siblings.end())
+  {
+    return nullptr;
+  }
+
+  this->m_tabular_elements.clear();
+  auto ri = el->create_render_item(parent_ri);
+  if (!ri)
+  {
+    return nullptr;
+  }
+  this->fix_tables_layout();
+  this->m_tabular_elements.clear();
+  ri = ri->init();
+  ri->replace_draw_item(*old_ri);
+
+  *sibling = ri;
+  ri->parent(parent_ri);
+  old_ri->parent(nullptr);
+  return ri;
+}
+
+bool document::render_subtree(const std::shared_ptr<render_item>& ri, const box_state& old_box)
+{
+  ri->render(0, 0, old_box.cb_context, nullptr);
+
+  // Auto margins are resolved by the parent, It did that for the old box already
+  const auto& css_margins = ri->css().get_margins();
+  auto& new_margins = ri->get_margins();
+  if (css_margins.left.is_predefined())   new_margins.left   = old_box.box_margins.left;
+  if (css_margins.right.is_predefined())  new_margins.right  = old_box.box_margins.right;
+  if (css_margins.top.is_predefined())    new_margins.top    = old_box.box_margins.top;
+  if (css_margins.bottom.is_predefined()) new_margins.bottom = old_box.box_margins.bottom;
+
+  // Anything that the parent reads from the box has to stay the same, Otherwise the parent has to be laid out too
+  if (ri->pos().width != old_box.pos.width || ri->pos().height != old_box.pos.height ||
+      !same_margins(new_margins, old_box.box_margins) ||
+      !same_margins(ri->get_paddings(), old_box.box_paddings) ||
+      !same_margins(ri->get_borders(), old_box.box_borders) ||
+      ri->get_first_baseline() != old_box.first_baseline ||
+      ri->get_last_baseline() != old_box.last_baseline)
+  {
+    return false;
+  }
+  ri->pos().x = old_box.pos.x;
+  ri->pos().y = old_box.pos.y;
+  return true;
+}
+
+bool document::is_attached(const element::ptr& el) const
+{
+  element::ptr cur = el;
+  while (auto parent = cur->parent())
+  {
+    cur = parent;
+  }
+  return cur == this->m_root;
+}
+
+bool document::is_attached(const std::shared_ptr<render_item>& ri) const
+{
+  std::shared_ptr<render_item> cur = ri;
+  while (auto parent = cur->parent())
+  {
+    cur = parent;
   }
+  return cur == this->m_root_render;
 }
 
 void document::create_node(void* gnode, elements_list& elements, bool parseTextNode)
@@ -409,6 +809,7 @@ void document::create_node(void* gnode, elements_list& elements, bool parseTextN
 					}
 				);
 			}
+			m_node_elements[node] = ret;
 			elements.push_back(ret);
 		}
 	}
@@ -669,6 +1070,8 @@ uint_ptr document::get_font( const char* name, int size, const char* weight, con
 int document::render( int max_width, render_type rt )
 {
 	int ret = 0;
+	m_redraw_items.clear();
+	m_redraw_all = true;
 	if(m_root && m_root_render)
 	{
 		position client_rc;
@@ -703,6 +1106,8 @@ int document::render( int max_width, render_type rt )
 
 void document::draw( uint_ptr hdc, int x, int y, const position* clip )
 {
+	m_redraw_items.clear();
+	m_redraw_all = true;
 	if(m_root && m_root_render)
 	{
 		m_root->draw(hdc, x, y, clip, m_root_render);
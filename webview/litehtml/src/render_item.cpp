@@ -6,8 +6,14 @@
 
 litehtml::render_item::render_item(std::shared_ptr<element>  _src_el) :
         m_element(std::move(_src_el)),
-        m_skip(false)
+        m_skip(false),
+        m_draw_x(0),
+        m_draw_y(0)
 {
+    // Every box gets its own key, Only replace_draw_item shares one
+    static uint_ptr next_draw_key = 0;
+    m_draw_key = ++next_draw_key;
+
     document::ptr doc = src_el()->get_document();
 	auto fm = css().get_font_metrics();
 
@@ -31,6 +37,7 @@ int litehtml::render_item::render(int x, int y, const containing_block_context&
 {
 	int ret;
 
+	m_cb_context = containing_block_size;
 	calc_outlines(containing_block_size.width);
 
 	m_pos.clear();
@@ -823,6 +830,13 @@ void litehtml::render_item::draw_children(uint_ptr hdc, int x, int y, const posi
 
     for (const auto& el : m_children)
     {
+        const bool is_item = flag != draw_positioned && el->is_draw_item();
+        if (is_item)
+        {
+            el->m_draw_x = pos.x;
+            el->m_draw_y = pos.y;
+            doc->container()->begin_draw_item(hdc, el->draw_key(flag));
+        }
         if (el->is_visible())
         {
             bool process = true;
@@ -896,6 +910,10 @@ void litehtml::render_item::draw_children(uint_ptr hdc, int x, int y, const posi
                 }
             }
         }
+        if (is_item)
+        {
+            doc->container()->end_draw_item(hdc);
+        }
     }
 
     if (src_el()->css().get_overflow() > overflow_visible)
@@ -904,6 +922,25 @@ void litehtml::render_item::draw_children(uint_ptr hdc, int x, int y, const posi
     }
 }
 
+void litehtml::render_item::draw_item(uint_ptr hdc, const position* clip)
+{
+    // Same steps as draw_children takes for a draw item in each pass
+    document::ptr doc = src_el()->get_document();
+    for (draw_flag flag : {draw_block, draw_floats, draw_inlines})
+    {
+        doc->container()->begin_draw_item(hdc, draw_key(flag));
+        if (is_visible())
+        {
+            if (flag == draw_block)
+            {
+                src_el()->draw(hdc, m_draw_x, m_draw_y, clip, shared_from_this());
+            }
+            draw_children(hdc, m_draw_x, m_draw_y, clip, flag, 0);
+        }
+        doc->container()->end_draw_item(hdc);
+    }
+}
+
 std::shared_ptr<litehtml::element>  litehtml::render_item::get_child_by_point(int x, int y, int client_x, int client_y, draw_flag flag, int zindex)
 {
     element::ptr ret = nullptr;
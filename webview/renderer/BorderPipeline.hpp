@@ -17,13 +17,7 @@ namespace MFA
         using Color = glm::vec4;
         using Width = float;
 
-        struct Vertex
-        {
-            Position position{};
-            Radius borderRadius{};
-            Color color{};
-        };
-
+        // The vertex shader reads the position and the radius of a corner as one float4, So they have to stay adjacent
         struct Instance
         {
             Position topLeftPos{};
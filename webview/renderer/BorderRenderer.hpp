@@ -2,6 +2,7 @@
 
 #include "BufferTracker.hpp"
 #include "BorderPipeline.hpp"
+#include "DisplayList.hpp"
 
 namespace MFA
 {
@@ -17,57 +18,12 @@ namespace MFA
 
         explicit BorderRenderer(std::shared_ptr<Pipeline> pipeline);
 
-        [[nodiscard]]
-        std::unique_ptr<LocalBufferTracker> AllocateBuffer(
-            Position const &topLeftPos,
-            Position const &bottomLeftPos,
-            Position const &topRightPos,
-            Position const &bottomRightPos,
-
-            Color const &topLeftColor,
-            Color const &bottomLeftColor,
-            Color const &topRightColor,
-            Color const &bottomRightColor,
-
-            Radius const &topLeftBorderRadius,
-            Radius const &bottomLeftBorderRadius,
-            Radius const &topRightBorderRadius,
-            Radius const &bottomRightBorderRadius,
-
-            Width leftWidth,
-            Width topWidth,
-            Width rightWidth,
-            Width bottomWidth
-        ) const;
-
-        void UpdateBuffer(
-            LocalBufferTracker &bufferTracker,
-            
-            Position const &topLeftPos,
-            Position const &bottomLeftPos,
-            Position const &topRightPos,
-            Position const &bottomRightPos,
-            
-            Color const &topLeftColor,
-            Color const &bottomLeftColor,
-            Color const &topRightColor,
-            Color const &bottomRightColor,
-            
-            Radius const &topLeftBorderRadius,
-            Radius const &bottomLeftBorderRadius,
-            Radius const &topRightBorderRadius,
-            Radius const &bottomRightBorderRadius,
-
-            Width leftWidth,
-            Width topWidth,
-            Width rightWidth,
-            Width bottomWidth
-        ) const;
-
+        // Instances of a display list arena, Binds once for the whole batch and draws every range as one instanced draw
         void Draw(
             RT::CommandRecordState & recordState,
             Pipeline::PushConstants const & pushConstants,
-            LocalBufferTracker const & vertexBuffer
+            LocalBufferTracker const & instanceBuffer,
+            std::span<DisplayList::Draw const> const & draws
         ) const;
 
     private:
@@ -3,6 +3,8 @@
 #include "BedrockFile.hpp"
 #include "LogicalDevice.hpp"
 
+#include <cstring>
+
 namespace MFA
 {
 
@@ -18,76 +20,118 @@ namespace MFA
     {
         auto const buffer = fontData.As<uint8_t>();
 
-        int const glyphHeight = (int)std::ceil(fontHeight);
-        int const glyphWidth = (int)glyphHeight;
-        int const bitmapSize = glyphWidth * glyphHeight * FontNumberOfChars;
-        int const atlasWidth = std::ceil(sqrt(bitmapSize) + 1);
-        int const atlasHeight = atlasWidth;
-
-        // int result = stbtt_InitFont(&_font, buffer, 0);
-        // MFA_ASSERT(result >= 0);
+        stbtt_fontinfo fontInfo{};
+        int const result = stbtt_InitFont(&fontInfo, buffer, stbtt_GetFontOffsetForIndex(buffer, 0));
+        MFA_ASSERT(result != 0);
+        float const scale = stbtt_ScaleForPixelHeight(&fontInfo, fontHeight);
 
-        auto bitmap = Memory::AllocSize(atlasWidth * atlasHeight * sizeof(uint8_t));
+        struct GlyphBitmap
+        {
+            uint8_t * pixels = nullptr;
+            int width = 0;
+            int height = 0;
+        };
+        std::vector<GlyphBitmap> glyphBitmaps(FontNumberOfChars);
         _stbFontData.resize(FontNumberOfChars);
-        // Bake font into the bitmap
-        int const result = stbtt_BakeFontBitmap(
-            buffer,                                     // Font data
-            0,                                          // Offset to the start of the font
-            fontHeight,                                 // Font pixel height
-            bitmap->Ptr(),                              // Bitmap output
-            atlasWidth, atlasHeight,                 // Bitmap dimensions
-            FontFirstChar, FontNumberOfChars,           // ASCII range (inclusive)
-            _stbFontData.data()                         // Output character data
-        );
-        MFA_ASSERT(result >= 0);
-        CreateFontTextureBuffer(atlasWidth, atlasHeight, std::move(bitmap));
-        _descriptorSet = _pipeline->CreateDescriptorSet(*_fontTexture);
 
-        _atlasWidth = (float)atlasWidth;
-        _atlasHeight = (float)atlasHeight;
-    }
+        int texelCount = 0;
+        for (int i = 0; i < FontNumberOfChars; ++i)
+        {
+            auto & glyphBitmap = glyphBitmaps[i];
+            int xOffset = 0;
+            int yOffset = 0;
+            // Is nullptr for empty glyphs like space
+            glyphBitmap.pixels = stbtt_GetCodepointSDF(
+                &fontInfo,
+                scale,
+                FontFirstChar + i,
+                SdfPadding,
+                SdfOnEdgeValue,
+                SdfPixelDistScale,
+                &glyphBitmap.width,
+                &glyphBitmap.height,
+                &xOffset,
+                &yOffset
+            );
+            if (glyphBitmap.pixels == nullptr)
+            {
+                glyphBitmap.width = 0;
+                glyphBitmap.height = 0;
+            }
 
-    //------------------------------------------------------------------------------------------------------------------
+            int advanceWidth = 0;
+            int leftSideBearing = 0;
+            stbtt_GetCodepointHMetrics(&fontInfo, FontFirstChar + i, &advanceWidth, &leftSideBearing);
 
-    std::unique_ptr<CustomFontRenderer::TextData> CustomFontRenderer::AllocateTextData(int maxCharCount)
-    {
-        auto const vertexBuffer = RB::CreateVertexBufferGroup(
-            LogicalDevice::GetVkDevice(),
-            LogicalDevice::GetPhysicalDevice(),
-            maxCharCount * sizeof(Pipeline::Vertex),
-            LogicalDevice::GetMaxFramePerFlight()
-        );
+            auto & charData = _stbFontData[i];
+            charData.xoff = (float)xOffset;
+            charData.yoff = (float)yOffset;
+            charData.xadvance = (float)advanceWidth * scale;
 
-        auto const vertexStageBuffer = RB::CreateStageBuffer(
-            LogicalDevice::GetVkDevice(),
-            LogicalDevice::GetPhysicalDevice(),
-            vertexBuffer->bufferSize,
-            vertexBuffer->buffers.size()
-        );
+            texelCount += (glyphBitmap.width + 1) * (glyphBitmap.height + 1);
+        }
+
+        // Rows from left to right, Same layout that stbtt_BakeFontBitmap uses
+        int const atlasWidth = (int)std::ceil(std::sqrt((float)texelCount) * 1.25f) + 1;
+        int x = 1;
+        int y = 1;
+        int rowHeight = 0;
+        for (int i = 0; i < FontNumberOfChars; ++i)
+        {
+            auto const & glyphBitmap = glyphBitmaps[i];
+            if (x + glyphBitmap.width + 1 >= atlasWidth)
+            {
+                x = 1;
+                y += rowHeight + 1;
+                rowHeight = 0;
+            }
+            auto & charData = _stbFontData[i];
+            charData.x0 = (unsigned short)x;
+            charData.y0 = (unsigned short)y;
+            charData.x1 = (unsigned short)(x + glyphBitmap.width);
+            charData.y1 = (unsigned short)(y + glyphBitmap.height);
+            x += glyphBitmap.width + 1;
+            rowHeight = std::max(rowHeight, glyphBitmap.height);
+        }
+        int const atlasHeight = y + rowHeight + 1;
 
-        std::unique_ptr<TextData> textData = std::make_unique<TextData>(TextData{
-            .letterRange = {},
-            .vertexData = LocalBufferTracker(vertexBuffer, vertexStageBuffer),
-            .maxLetterCount = maxCharCount
-        });
+        auto bitmap = Memory::AllocSize(atlasWidth * atlasHeight * sizeof(uint8_t));
+        std::memset(bitmap->Ptr(), 0, bitmap->Len());
+        for (int i = 0; i < FontNumberOfChars; ++i)
+        {
+            auto const & glyphBitmap = glyphBitmaps[i];
+            auto const & charData = _stbFontData[i];
+            for (int row = 0; row < glyphBitmap.height; ++row)
+            {
+                std::memcpy(
+                    bitmap->Ptr() + (charData.y0 + row) * atlasWidth + charData.x0,
+                    glyphBitmap.pixels + row * glyphBitmap.width,
+                    glyphBitmap.width
+                );
+            }
+            stbtt_FreeSDF(glyphBitmap.pixels, nullptr);
+        }
 
-        return textData;
+        CreateFontTextureBuffer(atlasWidth, atlasHeight, std::move(bitmap));
+        _descriptorSet = _pipeline->CreateDescriptorSet(*_fontTexture);
+
+        _atlasWidth = (float)atlasWidth;
+        _atlasHeight = (float)atlasHeight;
     }
 
     //------------------------------------------------------------------------------------------------------------------
 
-    bool CustomFontRenderer::AddText(
-        TextData &inOutData,
-        std::string_view const &text,
+    bool CustomFontRenderer::WriteText(
+        Pipeline::Vertex * outVertices,
+        int const maxLetterCount,
+        std::string_view const & text,
         float x, float y,
-        TextParams const & params
-    )
+        TextParams const & params,
+        int & outLetterCount
+    ) const
     {
-        int letterRange = inOutData.letterRange.empty() == false ? inOutData.letterRange.back() : 0;
-        int const letterRangeBegin = letterRange;
-
-        auto * mapped = &reinterpret_cast<Pipeline::Vertex*>(inOutData.vertexData->Data())[letterRange * 4];
-        auto * mappedBegin = mapped;
+        auto * mapped = outVertices;
+        int letterCount = 0;
 
         float const scale = params.fontSizeInPixels / _fontHeight;
 
@@ -96,7 +140,7 @@ namespace MFA
         // Generate a uv mapped quad per char in the new text
         for (auto const letter : text)
         {
-            if (letterRange + 1 >= inOutData.maxLetterCount)
+            if (letterCount >= maxLetterCount)
             {
                 success = false;
                 break;
@@ -153,16 +197,15 @@ namespace MFA
 
                 x += charData->xadvance * scale;
 
-                letterRange++;
+                letterCount++;
             }
         }
 
-        mapped = mappedBegin;
-        int const itrCount = std::min<int>(inOutData.maxLetterCount - letterRangeBegin, text.size() * 4);
+        int const itrCount = letterCount * 4;
 
         for (int i = 0; i < itrCount; ++i)
         {
-            mapped[i].position.y += _fontHeight * scale * 0.75f;
+            outVertices[i].position.y += _fontHeight * scale * 0.75f;
         }
 
         auto const width = TextWidth(text, params.fontSizeInPixels);
@@ -171,36 +214,116 @@ namespace MFA
         case HorizontalTextAlign::Right:
             for (int i = 0; i < itrCount; ++i)
             {
-                mappedBegin[i].position.x -= width;
+                outVertices[i].position.x -= width;
             }
             break;
         case HorizontalTextAlign::Center:
             auto const halfWidth = width * 0.5f;
             for (int i = 0; i < itrCount; ++i)
             {
-                mappedBegin[i].position.x -= halfWidth;
+                outVertices[i].position.x -= halfWidth;
             }
             break;
         }
 
-        inOutData.letterRange.emplace_back(letterRange);
+        outLetterCount = letterCount;
 
         return success;
     }
 
     //------------------------------------------------------------------------------------------------------------------
 
-    void CustomFontRenderer::ResetText(TextData &inOutData)
+    CustomFontRenderer::GlyphRun const & CustomFontRenderer::GetGlyphRun(
+        std::string_view const & text,
+        float const fontSizeInPixels
+    )
+    {
+        auto hash = std::hash<std::string_view>()(text);
+        hash ^= std::hash<float>()(fontSizeInPixels) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+
+        auto const isSameRun = [&](GlyphRun const & glyphRun)->bool
+        {
+            return glyphRun.fontSizeInPixels == fontSizeInPixels && glyphRun.text == text;
+        };
+
+        auto const findResult = _glyphRuns.find(hash);
+        if (findResult != _glyphRuns.end() && isSameRun(findResult->second) == true)
+        {
+            return findResult->second;
+        }
+
+        GlyphRun glyphRun{};
+        auto const oldFindResult = _oldGlyphRuns.find(hash);
+        if (oldFindResult != _oldGlyphRuns.end() && isSameRun(oldFindResult->second) == true)
+        {
+            glyphRun = std::move(oldFindResult->second);
+            _oldGlyphRuns.erase(oldFindResult);
+        }
+        else
+        {
+            glyphRun = CreateGlyphRun(text, fontSizeInPixels);
+        }
+
+        if (findResult == _glyphRuns.end() && _glyphRuns.size() >= MaxGlyphRunCount)
+        {
+            _oldGlyphRuns = std::move(_glyphRuns);
+            _glyphRuns.clear();
+        }
+        // A collision replaces the other run
+        auto & cachedRun = _glyphRuns[hash];
+        cachedRun = std::move(glyphRun);
+        return cachedRun;
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    CustomFontRenderer::GlyphRun CustomFontRenderer::CreateGlyphRun(
+        std::string_view const & text,
+        float const fontSizeInPixels
+    ) const
     {
-        inOutData.letterRange.clear();
+        GlyphRun glyphRun{
+            .text = std::string(text),
+            .fontSizeInPixels = fontSizeInPixels,
+            .width = TextWidth(text, fontSizeInPixels)
+        };
+
+        TextParams textParams{};
+        textParams.fontSizeInPixels = fontSizeInPixels;
+
+        glyphRun.vertices.resize(text.size() * 4);
+        int letterCount = 0;
+        WriteText(
+            glyphRun.vertices.data(),
+            static_cast<int>(text.size()),
+            text,
+            0.0f, 0.0f,
+            textParams,
+            letterCount
+        );
+        glyphRun.vertices.resize(letterCount * 4);
+
+        if (glyphRun.vertices.empty() == false)
+        {
+            glyphRun.min = glyphRun.vertices[0].position;
+            glyphRun.max = glyphRun.vertices[0].position;
+            for (auto const & vertex : glyphRun.vertices)
+            {
+                glyphRun.min = glm::min(glyphRun.min, vertex.position);
+                glyphRun.max = glm::max(glyphRun.max, vertex.position);
+            }
+        }
+
+        return glyphRun;
     }
 
     //------------------------------------------------------------------------------------------------------------------
 
     void CustomFontRenderer::Draw(
-        RT::CommandRecordState &recordState,
-        Pipeline::PushConstants const &pushConstants,
-        TextData const &data
+        RT::CommandRecordState & recordState,
+        Pipeline::PushConstants const & pushConstants,
+        LocalBufferTracker const & vertexBuffer,
+        std::span<DisplayList::Draw const> const & draws
     ) const
     {
         _pipeline->BindPipeline(recordState);
@@ -213,19 +336,16 @@ namespace MFA
             _descriptorSet.descriptorSets[0]
         );
 
-        RB::BindVertexBuffer(recordState, *data.vertexData->LocalBuffer().buffers[recordState.frameIndex]);
+        auto const & localBuffers = vertexBuffer.LocalBuffer().buffers;
+        RB::BindVertexBuffer(recordState, *localBuffers[recordState.frameIndex % localBuffers.size()]);
 
-        int previousLetterRange = 0;
-        for (auto const& letterRange : data.letterRange)
+        // One strip per text run
+        for (auto const & draw : draws)
         {
-            int const currentLetterRange = letterRange * 4;
-            vkCmdDraw(recordState.commandBuffer, currentLetterRange - previousLetterRange, 1, previousLetterRange, 0);
-            previousLetterRange = currentLetterRange;
+            vkCmdDraw(recordState.commandBuffer, draw.elementCount, 1, draw.firstElement, 0);
         }
     }
 
-    //------------------------------------------------------------------------------------------------------------------
-
     float CustomFontRenderer::TextWidth(std::string_view const & text, float const fontSizeInPixels) const
     {
         float const scale = fontSizeInPixels / _fontHeight;
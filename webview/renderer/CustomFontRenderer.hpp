@@ -2,10 +2,12 @@
 
 #include "TextOverlayPipeline.hpp"
 #include "BufferTracker.hpp"
+#include "DisplayList.hpp"
 
 #include "stb_truetype.h"
 
-#include <optional>
+#include <string>
+#include <unordered_map>
 
 namespace MFA
 {
@@ -17,21 +19,25 @@ namespace MFA
 
         static constexpr float DefaultFontSize = 14.0f;
 
-        struct TextData
+        // Text of one font size laid out at the origin in white, draw_text only has to move and tint it
+        struct GlyphRun
         {
-            std::vector<int> letterRange{};
-            std::optional<LocalBufferTracker> vertexData = std::nullopt;
-            const int maxLetterCount;
+            std::string text{};
+            float fontSizeInPixels{};
+            std::vector<Pipeline::Vertex> vertices{};
+            float width{};
+            glm::vec2 min{};
+            glm::vec2 max{};
         };
+
         // TODO: We have to pass the command buffer here.
+        // The atlas holds a signed distance field of every glyph at fontHeight, Every other size is drawn from it
         explicit CustomFontRenderer(
             std::shared_ptr<Pipeline> pipeline,
             Alias const & fontData,
             float fontHeight
         );
 
-        std::unique_ptr<TextData> AllocateTextData(int maxCharCount = 1024);
-
         enum class HorizontalTextAlign {Center, Left, Right};
 
         struct TextParams
@@ -41,20 +47,27 @@ namespace MFA
             glm::vec3 color{1.0f, 1.0f, 1.0f};
         };
 
-        bool AddText(
-            TextData & inOutData,
+        // Writes 4 vertices per letter into outVertices, Returns false when the text did not fit in maxLetterCount
+        bool WriteText(
+            Pipeline::Vertex * outVertices,
+            int maxLetterCount,
             std::string_view const & text,
             float x,
             float y,
-            TextParams const & params
-        );
+            TextParams const & params,
+            int & outLetterCount
+        ) const;
 
-        void ResetText(TextData & inOutData);
+        // Cached by size and text, The reference stays valid until the next call
+        [[nodiscard]]
+        GlyphRun const & GetGlyphRun(std::string_view const & text, float fontSizeInPixels);
 
+        // Text runs of a display list arena, Binds the font once for the whole batch
         void Draw(
-            RT::CommandRecordState& recordState,
+            RT::CommandRecordState & recordState,
             Pipeline::PushConstants const & pushConstants,
-            TextData const & data
+            LocalBufferTracker const & vertexBuffer,
+            std::span<DisplayList::Draw const> const & draws
         ) const;
 
         [[nodiscard]]
@@ -67,12 +80,21 @@ namespace MFA
 
         void CreateFontTextureBuffer(uint32_t width, uint32_t height, std::unique_ptr<Blob> bytes);
 
+        [[nodiscard]]
+        GlyphRun CreateGlyphRun(std::string_view const & text, float fontSizeInPixels) const;
+
     public:
 
         static constexpr float WidthModifier = 1.0f;
         static constexpr float HeightModifier = 1.0f;
         static constexpr int FontFirstChar = 32;
         static constexpr int FontNumberOfChars = 224;
+        // Texels of distance around each glyph, Also keeps the glyphs of the atlas from bleeding into each other
+        static constexpr int SdfPadding = 4;
+        static constexpr uint8_t SdfOnEdgeValue = 128;
+        static constexpr float SdfPixelDistScale = static_cast<float>(SdfOnEdgeValue) / static_cast<float>(SdfPadding);
+        // Runs that are not used for this many new runs are dropped
+        static constexpr size_t MaxGlyphRunCount = 4096;
 
     private:
 
@@ -89,5 +111,10 @@ namespace MFA
         float _atlasWidth{};
         float _atlasHeight{};
         float _fontHeight{};
+
+        // Two generations keyed by the hash of size and text, A run moves to the new one when it is used again.
+        // The old generation is dropped once the new one is full.
+        std::unordered_map<size_t, GlyphRun> _glyphRuns{};
+        std::unordered_map<size_t, GlyphRun> _oldGlyphRuns{};
     };
 }
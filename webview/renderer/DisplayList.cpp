@@ -0,0 +1,189 @@
+#include "DisplayList.hpp"
+
+#include "BedrockAssert.hpp"
+
+#include <cstring>
+
+namespace MFA
+{
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    namespace
+    {
+        bool Overlaps(DisplayList::Bounds const & lhs, DisplayList::Bounds const & rhs)
+        {
+            return lhs.min.x < rhs.max.x && rhs.min.x < lhs.max.x &&
+                lhs.min.y < rhs.max.y && rhs.min.y < lhs.max.y;
+        }
+
+        void Merge(DisplayList::Bounds & inOutBounds, DisplayList::Bounds const & bounds)
+        {
+            inOutBounds.min = glm::min(inOutBounds.min, bounds.min);
+            inOutBounds.max = glm::max(inOutBounds.max, bounds.max);
+        }
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    DisplayList::DisplayList() = default;
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    void DisplayList::Begin()
+    {
+        for (auto & arena : _arenas)
+        {
+            arena.bytes.clear();
+            arena.elementCount = 0;
+        }
+        _batches.clear();
+        _draws.clear();
+        _drawBatches.clear();
+        _sortedDraws.clear();
+        _stats = {};
+        _isEnded = false;
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    void DisplayList::End()
+    {
+        MFA_ASSERT(_isEnded == false);
+
+        // Counting sort by batch, Draws inside a batch keep the order of the calls
+        for (auto & batch : _batches)
+        {
+            batch.drawCount = 0;
+        }
+        for (auto const batchIdx : _drawBatches)
+        {
+            ++_batches[batchIdx].drawCount;
+        }
+        uint32_t firstDraw = 0;
+        for (auto & batch : _batches)
+        {
+            batch.firstDraw = firstDraw;
+            firstDraw += batch.drawCount;
+        }
+
+        _sortedDraws.resize(_draws.size());
+        std::vector<uint32_t> nextDraw(_batches.size());
+        for (size_t i = 0; i < _batches.size(); ++i)
+        {
+            nextDraw[i] = _batches[i].firstDraw;
+        }
+        for (size_t i = 0; i < _draws.size(); ++i)
+        {
+            _sortedDraws[nextDraw[_drawBatches[i]]++] = _draws[i];
+        }
+
+        _stats.batchCount = static_cast<uint32_t>(_batches.size());
+        _stats.byteCount = 0;
+        for (auto const & arena : _arenas)
+        {
+            _stats.byteCount += arena.bytes.size();
+        }
+        _isEnded = true;
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    std::vector<uint8_t> const & DisplayList::GetArena(PrimitiveType const type) const
+    {
+        return _arenas[static_cast<size_t>(type)].bytes;
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    std::vector<DisplayList::Batch> const & DisplayList::GetBatches() const noexcept
+    {
+        MFA_ASSERT(_isEnded == true);
+        return _batches;
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    std::span<DisplayList::Draw const> DisplayList::GetDraws(Batch const & batch) const
+    {
+        MFA_ASSERT(_isEnded == true);
+        return std::span<Draw const>{_sortedDraws.data() + batch.firstDraw, batch.drawCount};
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    DisplayList::Stats const & DisplayList::GetStats() const noexcept
+    {
+        return _stats;
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    bool DisplayList::IsEmpty() const noexcept
+    {
+        return _draws.empty();
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    void DisplayList::Add(
+        PrimitiveType const type,
+        void const * resource,
+        void const * elements,
+        uint32_t const stride,
+        uint32_t const elementCount,
+        Bounds const & bounds
+    )
+    {
+        MFA_ASSERT(_isEnded == false);
+        MFA_ASSERT(type != PrimitiveType::Count);
+        if (elementCount == 0)
+        {
+            return;
+        }
+
+        auto & arena = _arenas[static_cast<size_t>(type)];
+        // Every element of an arena has to have the same layout, The renderers index it by element
+        MFA_ASSERT(arena.stride == 0 || arena.stride == stride);
+        arena.stride = stride;
+
+        auto const byteOffset = arena.bytes.size();
+        arena.bytes.resize(byteOffset + static_cast<size_t>(stride) * elementCount);
+        std::memcpy(arena.bytes.data() + byteOffset, elements, static_cast<size_t>(stride) * elementCount);
+
+        _draws.emplace_back(Draw{.firstElement = arena.elementCount, .elementCount = elementCount});
+        _drawBatches.emplace_back(FindBatch(type, resource, bounds));
+        arena.elementCount += elementCount;
+
+        ++_stats.primitiveCount;
+        ++_stats.primitiveCountPerType[static_cast<size_t>(type)];
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    uint32_t DisplayList::FindBatch(PrimitiveType const type, void const * resource, Bounds const & bounds)
+    {
+        auto const batchCount = static_cast<uint32_t>(_batches.size());
+        auto const lastBatch = batchCount > MaxBatchLookBack ? batchCount - MaxBatchLookBack : 0;
+        for (uint32_t i = batchCount; i > lastBatch; --i)
+        {
+            auto & batch = _batches[i - 1];
+            if (batch.type == type && batch.resource == resource)
+            {
+                Merge(batch.bounds, bounds);
+                return i - 1;
+            }
+            // Moving in front of something that it covers would change the result
+            if (Overlaps(batch.bounds, bounds) == true)
+            {
+                break;
+            }
+        }
+
+        _batches.emplace_back(Batch{.type = type, .resource = resource, .bounds = bounds});
+        return batchCount;
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+}
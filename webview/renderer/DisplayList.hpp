@@ -0,0 +1,146 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace MFA
+{
+    // Retained list of the primitives of a page. Every primitive type is packed into its own arena, So the gpu side
+    // needs one vertex buffer per type instead of one per element. Primitives are grouped into batches that share a
+    // pipeline and a resource (Texture or font). A primitive can join an earlier batch as long as it does not overlap
+    // anything that is drawn in between, So the painter's order of overlapping primitives is kept.
+    // Has no gpu dependency, The renderers consume the arenas and the batches.
+    class DisplayList
+    {
+    public:
+
+        enum class PrimitiveType : uint8_t
+        {
+            SolidFill,
+            Border,
+            Image,
+            Text,
+            Count
+        };
+
+        static constexpr size_t PrimitiveTypeCount = static_cast<size_t>(PrimitiveType::Count);
+
+        struct Bounds
+        {
+            glm::vec2 min{};
+            glm::vec2 max{};
+        };
+
+        // Elements of the arena that one draw covers. Elements are instances for the instanced types and vertices for
+        // text.
+        struct Draw
+        {
+            uint32_t firstElement = 0;
+            uint32_t elementCount = 0;
+        };
+
+        struct Batch
+        {
+            PrimitiveType type = PrimitiveType::Count;
+            // Texture or font, nullptr for the types that do not need one
+            void const * resource = nullptr;
+            // Range of GetDraws
+            uint32_t firstDraw = 0;
+            uint32_t drawCount = 0;
+            Bounds bounds{};
+        };
+
+        struct Stats
+        {
+            uint32_t primitiveCount = 0;
+            uint32_t batchCount = 0;
+            // Bytes of all arenas
+            size_t byteCount = 0;
+            std::array<uint32_t, PrimitiveTypeCount> primitiveCountPerType{};
+        };
+
+        // Batches further back are not searched, So a long list of disjoint primitives stays linear
+        static constexpr uint32_t MaxBatchLookBack = 64;
+
+        explicit DisplayList();
+
+        // Clears the list and keeps the capacity of the arenas
+        void Begin();
+
+        // One instance that the vertex shader expands to a quad
+        template<typename Instance>
+        void AddInstance(PrimitiveType const type, void const * resource, Instance const & instance, Bounds const & bounds)
+        {
+            Add(type, resource, &instance, sizeof(Instance), 1, bounds);
+        }
+
+        // Vertices that are drawn as one strip
+        template<typename Vertex>
+        void AddVertices(
+            PrimitiveType const type,
+            void const * resource,
+            Vertex const * vertices,
+            uint32_t const vertexCount,
+            Bounds const & bounds
+        )
+        {
+            Add(type, resource, vertices, sizeof(Vertex), vertexCount, bounds);
+        }
+
+        // Sorts the draws by batch, Has to be called before the batches are read
+        void End();
+
+        [[nodiscard]]
+        std::vector<uint8_t> const & GetArena(PrimitiveType type) const;
+
+        [[nodiscard]]
+        std::vector<Batch> const & GetBatches() const noexcept;
+
+        [[nodiscard]]
+        std::span<Draw const> GetDraws(Batch const & batch) const;
+
+        [[nodiscard]]
+        Stats const & GetStats() const noexcept;
+
+        [[nodiscard]]
+        bool IsEmpty() const noexcept;
+
+    private:
+
+        // Replays the recorded primitives through Add
+        friend class DisplayListCache;
+
+        struct Arena
+        {
+            std::vector<uint8_t> bytes{};
+            uint32_t stride = 0;
+            uint32_t elementCount = 0;
+        };
+
+        void Add(
+            PrimitiveType type,
+            void const * resource,
+            void const * elements,
+            uint32_t stride,
+            uint32_t elementCount,
+            Bounds const & bounds
+        );
+
+        // Index of the batch that the primitive can be appended to, Creates a new one when none fits
+        [[nodiscard]]
+        uint32_t FindBatch(PrimitiveType type, void const * resource, Bounds const & bounds);
+
+        std::array<Arena, PrimitiveTypeCount> _arenas{};
+        std::vector<Batch> _batches{};
+        // In the order of the calls until End, Sorted by batch after it
+        std::vector<Draw> _draws{};
+        std::vector<uint32_t> _drawBatches{};
+        std::vector<Draw> _sortedDraws{};
+        Stats _stats{};
+        bool _isEnded = true;
+    };
+}
@@ -0,0 +1,329 @@
+#include "DisplayListCache.hpp"
+
+#include "BedrockAssert.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace MFA
+{
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    DisplayListCache::DisplayListCache() = default;
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    void DisplayListCache::Begin()
+    {
+        MFA_ASSERT(_isRecording == false);
+
+        _items.clear();
+        _freeItems.clear();
+        _keyItems.clear();
+        for (auto & arena : _arenas)
+        {
+            arena.bytes.clear();
+            arena.stride = 0;
+        }
+        _stats = {};
+
+        _items.emplace_back();
+        _itemStack.clear();
+        _itemStack.emplace_back(RootItem);
+        _isRecording = true;
+        _isUpdating = false;
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    void DisplayListCache::BeginItem(Key const key)
+    {
+        MFA_ASSERT(_isRecording == true);
+
+        if (_isUpdating == true && _itemStack.empty() == true)
+        {
+            auto const findResult = _keyItems.find(key);
+            if (findResult != _keyItems.end())
+            {
+                ClearItem(findResult->second);
+                _itemStack.emplace_back(findResult->second);
+                return;
+            }
+            // Recorded into an item that no one points to, EndItem drops it again
+            _isUpdateValid = false;
+            _itemStack.emplace_back(AllocateItem(key));
+            return;
+        }
+
+        MFA_ASSERT(_itemStack.empty() == false);
+        // A key is drawn once per recording, The later item would hide the first one from updates
+        MFA_ASSERT(_keyItems.contains(key) == false);
+
+        auto const itemIdx = AllocateItem(key);
+        _items[_itemStack.back()].entries.emplace_back(Entry{.item = itemIdx});
+        _keyItems[key] = itemIdx;
+        _itemStack.emplace_back(itemIdx);
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    void DisplayListCache::EndItem()
+    {
+        MFA_ASSERT(_isRecording == true);
+        MFA_ASSERT(_itemStack.empty() == false);
+        MFA_ASSERT(_itemStack.back() != RootItem);
+
+        auto const itemIdx = _itemStack.back();
+        _itemStack.pop_back();
+
+        if (_isUpdating == true && _itemStack.empty() == true)
+        {
+            auto const findResult = _keyItems.find(_items[itemIdx].key);
+            if (findResult == _keyItems.end() || findResult->second != itemIdx)
+            {
+                ClearItem(itemIdx);
+                _freeItems.emplace_back(itemIdx);
+                --_stats.itemCount;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    void DisplayListCache::End()
+    {
+        MFA_ASSERT(_isRecording == true && _isUpdating == false);
+        MFA_ASSERT(_itemStack.size() == 1 && _itemStack.back() == RootItem);
+
+        _itemStack.clear();
+        _isRecording = false;
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    void DisplayListCache::BeginUpdate()
+    {
+        MFA_ASSERT(_isRecording == false);
+        // Begin has to record the page once before it can be updated
+        MFA_ASSERT(_items.empty() == false);
+
+        _itemStack.clear();
+        _isRecording = true;
+        _isUpdating = true;
+        _isUpdateValid = true;
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    bool DisplayListCache::EndUpdate()
+    {
+        MFA_ASSERT(_isRecording == true && _isUpdating == true);
+        MFA_ASSERT(_itemStack.empty() == true);
+
+        _isRecording = false;
+        _isUpdating = false;
+        if (_stats.garbageByteCount > _stats.byteCount)
+        {
+            Compact();
+        }
+        return _isUpdateValid;
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    void DisplayListCache::Replay(DisplayList & displayList, Resolver const & resolver)
+    {
+        MFA_ASSERT(_isRecording == false);
+        if (_items.empty() == true)
+        {
+            return;
+        }
+
+        _resolved.clear();
+        ReplayItem(RootItem, displayList, resolver);
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    DisplayListCache::Stats const & DisplayListCache::GetStats() const noexcept
+    {
+        return _stats;
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    void DisplayListCache::Add(
+        PrimitiveType const type,
+        void const * resource,
+        void const * elements,
+        uint32_t const stride,
+        uint32_t const elementCount,
+        Bounds const & bounds
+    )
+    {
+        MFA_ASSERT(_isRecording == true);
+        MFA_ASSERT(type != PrimitiveType::Count);
+        // An update only replaces items, A primitive outside of them has no place in the recording
+        MFA_ASSERT(_itemStack.empty() == false);
+        if (elementCount == 0 || _itemStack.empty() == true)
+        {
+            return;
+        }
+
+        auto & arena = _arenas[static_cast<size_t>(type)];
+        MFA_ASSERT(arena.stride == 0 || arena.stride == stride);
+        arena.stride = stride;
+
+        auto const byteCount = static_cast<size_t>(stride) * elementCount;
+        auto const byteOffset = arena.bytes.size();
+        arena.bytes.resize(byteOffset + byteCount);
+        std::memcpy(arena.bytes.data() + byteOffset, elements, byteCount);
+
+        _items[_itemStack.back()].entries.emplace_back(Entry{
+            .type = type,
+            .resource = resource,
+            .byteOffset = byteOffset,
+            .elementCount = elementCount,
+            .bounds = bounds
+        });
+
+        ++_stats.primitiveCount;
+        _stats.byteCount += byteCount;
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    uint32_t DisplayListCache::AllocateItem(Key const key)
+    {
+        uint32_t itemIdx = 0;
+        if (_freeItems.empty() == false)
+        {
+            itemIdx = _freeItems.back();
+            _freeItems.pop_back();
+        }
+        else
+        {
+            itemIdx = static_cast<uint32_t>(_items.size());
+            _items.emplace_back();
+        }
+        // Entries keep their capacity for the next item that takes the slot
+        _items[itemIdx].key = key;
+        _items[itemIdx].entries.clear();
+        ++_stats.itemCount;
+        return itemIdx;
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    void DisplayListCache::ClearItem(uint32_t const itemIdx)
+    {
+        for (auto const & entry : _items[itemIdx].entries)
+        {
+            if (entry.type == PrimitiveType::Count)
+            {
+                ClearItem(entry.item);
+                auto const findResult = _keyItems.find(_items[entry.item].key);
+                if (findResult != _keyItems.end() && findResult->second == entry.item)
+                {
+                    _keyItems.erase(findResult);
+                }
+                _freeItems.emplace_back(entry.item);
+                --_stats.itemCount;
+                continue;
+            }
+
+            auto const byteCount = static_cast<size_t>(_arenas[static_cast<size_t>(entry.type)].stride) *
+                entry.elementCount;
+            --_stats.primitiveCount;
+            _stats.byteCount -= byteCount;
+            _stats.garbageByteCount += byteCount;
+        }
+        _items[itemIdx].entries.clear();
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    void DisplayListCache::ReplayItem(uint32_t const itemIdx, DisplayList & displayList, Resolver const & resolver)
+    {
+        for (auto const & entry : _items[itemIdx].entries)
+        {
+            if (entry.type == PrimitiveType::Count)
+            {
+                ReplayItem(entry.item, displayList, resolver);
+                continue;
+            }
+
+            // A page has a handful of textures and fonts, So a linear search beats hashing every primitive
+            void const * resource = nullptr;
+            auto const findResult = std::ranges::find_if(_resolved, [&entry](auto const & resolved)->bool
+            {
+                return std::get<0>(resolved) == entry.type && std::get<1>(resolved) == entry.resource;
+            });
+            if (findResult != _resolved.end())
+            {
+                resource = std::get<2>(*findResult);
+            }
+            else
+            {
+                resource = resolver(entry.type, entry.resource);
+                _resolved.emplace_back(entry.type, entry.resource, resource);
+            }
+
+            auto const & arena = _arenas[static_cast<size_t>(entry.type)];
+            displayList.Add(
+                entry.type,
+                resource,
+                arena.bytes.data() + entry.byteOffset,
+                arena.stride,
+                entry.elementCount,
+                entry.bounds
+            );
+        }
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    void DisplayListCache::Compact()
+    {
+        std::array<Arena, DisplayList::PrimitiveTypeCount> arenas{};
+        for (size_t i = 0; i < DisplayList::PrimitiveTypeCount; ++i)
+        {
+            arenas[i].stride = _arenas[i].stride;
+        }
+        CompactItem(RootItem, arenas);
+        _arenas = std::move(arenas);
+        _stats.garbageByteCount = 0;
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+    void DisplayListCache::CompactItem(
+        uint32_t const itemIdx,
+        std::array<Arena, DisplayList::PrimitiveTypeCount> & arenas
+    )
+    {
+        for (auto & entry : _items[itemIdx].entries)
+        {
+            if (entry.type == PrimitiveType::Count)
+            {
+                CompactItem(entry.item, arenas);
+                continue;
+            }
+
+            auto const & oldBytes = _arenas[static_cast<size_t>(entry.type)].bytes;
+            auto & newArena = arenas[static_cast<size_t>(entry.type)];
+            auto const byteCount = static_cast<size_t>(newArena.stride) * entry.elementCount;
+            auto const byteOffset = newArena.bytes.size();
+            newArena.bytes.insert(
+                newArena.bytes.end(),
+                oldBytes.begin() + static_cast<ptrdiff_t>(entry.byteOffset),
+                oldBytes.begin() + static_cast<ptrdiff_t>(entry.byteOffset + byteCount)
+            );
+            entry.byteOffset = byteOffset;
+        }
+    }
+
+    //------------------------------------------------------------------------------------------------------------------
+
+}
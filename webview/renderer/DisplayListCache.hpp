@@ -0,0 +1,145 @@
+#pragma once
+
+#include "DisplayList.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace MFA
+{
+    // Primitives of a page grouped into keyed items, So a change only records the items that it touched again and the
+    // rest is copied into the next display list as it is. Items nest in the order they were recorded, Replay visits
+    // them depth first, So the display list sees the primitives in the same order as a full recording.
+    // Resources are recorded as the caller knows them (Texture or font) and resolved on Replay, So one recording can
+    // feed display lists whose resources differ.
+    // Has no gpu dependency.
+    class DisplayListCache
+    {
+    public:
+
+        using PrimitiveType = DisplayList::PrimitiveType;
+        using Bounds = DisplayList::Bounds;
+        using Key = uint64_t;
+        // Resource that the display list gets for a recorded resource, Called once per type and resource on Replay
+        using Resolver = std::function<void const *(PrimitiveType type, void const * resource)>;
+
+        struct Stats
+        {
+            uint32_t itemCount = 0;
+            uint32_t primitiveCount = 0;
+            // Bytes of the primitives that the items point to
+            size_t byteCount = 0;
+            // Bytes of replaced primitives that are still in the arenas
+            size_t garbageByteCount = 0;
+        };
+
+        explicit DisplayListCache();
+
+        // Drops every item, The recording until End is the whole page
+        void Begin();
+
+        // Starts an item inside the current one, Everything until EndItem belongs to it
+        void BeginItem(Key key);
+
+        void EndItem();
+
+        template<typename Instance>
+        void AddInstance(PrimitiveType const type, void const * resource, Instance const & instance, Bounds const & bounds)
+        {
+            Add(type, resource, &instance, sizeof(Instance), 1, bounds);
+        }
+
+        template<typename Vertex>
+        void AddVertices(
+            PrimitiveType const type,
+            void const * resource,
+            Vertex const * vertices,
+            uint32_t const vertexCount,
+            Bounds const & bounds
+        )
+        {
+            Add(type, resource, vertices, sizeof(Vertex), vertexCount, bounds);
+        }
+
+        void End();
+
+        // Items that are begun at the top level until EndUpdate replace the recorded items with the same key. Nothing
+        // may be added outside of them.
+        void BeginUpdate();
+
+        // Returns false when one of the keys was not recorded, The cache has to be recorded again with Begin then
+        [[nodiscard]]
+        bool EndUpdate();
+
+        // Adds the primitives of all items to the display list, Between its Begin and End
+        void Replay(DisplayList & displayList, Resolver const & resolver);
+
+        [[nodiscard]]
+        Stats const & GetStats() const noexcept;
+
+    private:
+
+        struct Entry
+        {
+            // Count for a nested item
+            PrimitiveType type = PrimitiveType::Count;
+            uint32_t item = 0;
+            void const * resource = nullptr;
+            size_t byteOffset = 0;
+            uint32_t elementCount = 0;
+            Bounds bounds{};
+        };
+
+        struct Item
+        {
+            Key key = 0;
+            std::vector<Entry> entries{};
+        };
+
+        struct Arena
+        {
+            std::vector<uint8_t> bytes{};
+            uint32_t stride = 0;
+        };
+
+        void Add(
+            PrimitiveType type,
+            void const * resource,
+            void const * elements,
+            uint32_t stride,
+            uint32_t elementCount,
+            Bounds const & bounds
+        );
+
+        [[nodiscard]]
+        uint32_t AllocateItem(Key key);
+
+        // Frees the nested items and turns the primitives into garbage, The item itself stays
+        void ClearItem(uint32_t itemIdx);
+
+        void ReplayItem(uint32_t itemIdx, DisplayList & displayList, Resolver const & resolver);
+
+        // Copies the live primitives into new arenas once the garbage outgrows them
+        void Compact();
+
+        void CompactItem(uint32_t itemIdx, std::array<Arena, DisplayList::PrimitiveTypeCount> & arenas);
+
+        static constexpr uint32_t RootItem = 0;
+
+        std::vector<Item> _items{};
+        std::vector<uint32_t> _freeItems{};
+        std::unordered_map<Key, uint32_t> _keyItems{};
+        std::array<Arena, DisplayList::PrimitiveTypeCount> _arenas{};
+        // Items that are being recorded, Innermost last
+        std::vector<uint32_t> _itemStack{};
+        // Resolved resources of the current Replay
+        std::vector<std::tuple<PrimitiveType, void const *, void const *>> _resolved{};
+        Stats _stats{};
+        bool _isRecording = false;
+        bool _isUpdating = false;
+        bool _isUpdateValid = true;
+    };
+}
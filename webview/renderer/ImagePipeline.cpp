@@ -178,85 +178,76 @@ void ImagePipeline::CreatePipeline()
 
     std::vector<RT::GpuShader const *> shaders{gpuVertexShader.get(), gpuFragmentShader.get()};
 
-	std::vector<VkVertexInputBindingDescription> const bindingDescriptions{
-    VkVertexInputBindingDescription{
-        .binding = 0,
-        .stride = sizeof(Vertex),
-        .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
-    },
-    VkVertexInputBindingDescription{
-        .binding = 1,
-        .stride = sizeof(Instance),
-        .inputRate = VK_VERTEX_INPUT_RATE_INSTANCE,
-    }};
+    // One binding with a record per instance, The vertex shader picks one of the 4 corners by the vertex index
+    std::vector<VkVertexInputBindingDescription> const bindingDescriptions{
+        VkVertexInputBindingDescription {
+            .binding = 0,
+            .stride = sizeof(Instance),
+            .inputRate = VK_VERTEX_INPUT_RATE_INSTANCE,
+        }
+    };
 
     std::vector<VkVertexInputAttributeDescription> inputAttributeDescriptions{};
-    // Position
-    inputAttributeDescriptions.emplace_back(MFA_VERTEX_INPUT_ATTRIBUTE(
-        static_cast<uint32_t>(inputAttributeDescriptions.size()),
-        0,
-        Vertex,
-        position
-    ));
-    // UV
-    inputAttributeDescriptions.emplace_back(MFA_VERTEX_INPUT_ATTRIBUTE(
-        static_cast<uint32_t>(inputAttributeDescriptions.size()),
-        0,
-        Vertex,
-        uv
-    ));
-    // topLeftPos
-    inputAttributeDescriptions.emplace_back(MFA_VERTEX_INPUT_ATTRIBUTE(
-        static_cast<uint32_t>(inputAttributeDescriptions.size()),
-        1,
-        Instance,
-        topLeftPos
-    ));
-    // topLeftRadius
-    inputAttributeDescriptions.emplace_back(MFA_VERTEX_INPUT_ATTRIBUTE(
-        static_cast<uint32_t>(inputAttributeDescriptions.size()),
-        1,
-        Instance,
-        topLeftRadius
-    ));
-    // bottomLeftPos
-    inputAttributeDescriptions.emplace_back(MFA_VERTEX_INPUT_ATTRIBUTE(
-        static_cast<uint32_t>(inputAttributeDescriptions.size()),
-        1,
-        Instance,
-        bottomLeftPos
-    ));
-    // bottomLeftRadius
-    inputAttributeDescriptions.emplace_back(MFA_VERTEX_INPUT_ATTRIBUTE(
-        static_cast<uint32_t>(inputAttributeDescriptions.size()),
-        1,
-        Instance,
-        bottomLeftRadius
-    ));
-    inputAttributeDescriptions.emplace_back(MFA_VERTEX_INPUT_ATTRIBUTE(
-        static_cast<uint32_t>(inputAttributeDescriptions.size()),
-        1,
-        Instance,
-        topRightPos
-    ));
-    inputAttributeDescriptions.emplace_back(MFA_VERTEX_INPUT_ATTRIBUTE(
-        static_cast<uint32_t>(inputAttributeDescriptions.size()),
-        1,
-        Instance,
-        topRightRadius
-    ));
-    inputAttributeDescriptions.emplace_back(MFA_VERTEX_INPUT_ATTRIBUTE(
-        static_cast<uint32_t>(inputAttributeDescriptions.size()),
-        1,
-        Instance,
-        bottomRightPos
-    ));
-    inputAttributeDescriptions.emplace_back(MFA_VERTEX_INPUT_ATTRIBUTE(
-        static_cast<uint32_t>(inputAttributeDescriptions.size()),
-        1,
-        Instance,
-        bottomRightRadius
-    ));
+
+    // topLeftPos and topLeftRadius
+    inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
+        .location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
+        .binding = 0,
+        .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+        .offset = offsetof(Instance, topLeftPos)
+    });
+    // topLeftUV
+    inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
+        .location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
+        .binding = 0,
+        .format = VK_FORMAT_R32G32_SFLOAT,
+        .offset = offsetof(Instance, topLeftUV)
+    });
+
+    // bottomLeftPos and bottomLeftRadius
+    inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
+        .location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
+        .binding = 0,
+        .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+        .offset = offsetof(Instance, bottomLeftPos)
+    });
+    // bottomLeftUV
+    inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
+        .location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
+        .binding = 0,
+        .format = VK_FORMAT_R32G32_SFLOAT,
+        .offset = offsetof(Instance, bottomLeftUV)
+    });
+
+    // topRightPos and topRightRadius
+    inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
+        .location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
+        .binding = 0,
+        .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+        .offset = offsetof(Instance, topRightPos)
+    });
+    // topRightUV
+    inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
+        .location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
+        .binding = 0,
+        .format = VK_FORMAT_R32G32_SFLOAT,
+        .offset = offsetof(Instance, topRightUV)
+    });
+
+    // bottomRightPos and bottomRightRadius
+    inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
+        .location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
+        .binding = 0,
+        .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+        .offset = offsetof(Instance, bottomRightPos)
+    });
+    // bottomRightUV
+    inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
+        .location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
+        .binding = 0,
+        .format = VK_FORMAT_R32G32_SFLOAT,
+        .offset = offsetof(Instance, bottomRightUV)
+    });
 
     RB::CreateGraphicPipelineOptions pipelineOptions{};
     pipelineOptions.useStaticViewportAndScissor = false;
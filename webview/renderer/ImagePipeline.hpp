@@ -15,13 +15,7 @@ namespace MFA
         using Radius = glm::vec2;
         using UV = glm::vec2;
 
-        struct Vertex
-        {
-            Position position{};
-            Radius radius{};
-            UV uv{};
-        };
-
+        // The vertex shader reads the position and the radius of a corner as one float4, So they have to stay adjacent
         struct Instance
         {
             Position topLeftPos{};
@@ -14,100 +14,17 @@ namespace MFA
 
     //------------------------------------------------------------------------------------------------------------------
 
-    std::unique_ptr<ImageRenderer::ImageData> ImageRenderer::AllocateImageData(
-        RT::GpuTexture const & gpuTexture,
-
-        Position const &topLeftPos,
-        Position const &bottomLeftPos,
-        Position const &topRightPos,
-        Position const &bottomRightPos,
-
-        Radius const &topLeftBorderRadius,
-        Radius const &bottomLeftBorderRadius,
-        Radius const &topRightBorderRadius,
-        Radius const &bottomRightBorderRadius,
-
-        UV const &topLeftUV,
-        UV const &bottomLeftUV,
-        UV const &topRightUV,
-        UV const &bottomRightUV
-    ) const
+    std::unique_ptr<ImageRenderer::ImageData> ImageRenderer::AllocateImageData(RT::GpuTexture const & gpuTexture) const
     {
-        Pipeline::Vertex vertexData[4]
-        {
-            Pipeline::Vertex{.position = topLeftPos, .radius = topLeftBorderRadius,.uv = topLeftUV},
-            Pipeline::Vertex{.position = bottomLeftPos, .radius = bottomLeftBorderRadius, .uv = bottomLeftUV},
-            Pipeline::Vertex{.position = topRightPos, .radius = topRightBorderRadius, .uv = topRightUV},
-            Pipeline::Vertex{.position = bottomRightPos, .radius = bottomRightBorderRadius, .uv = bottomRightUV},
-        };
-
-        auto const vertexBuffer = RB::CreateVertexBufferGroup(
-            LogicalDevice::GetVkDevice(),
-            LogicalDevice::GetPhysicalDevice(),
-            sizeof(vertexData),
-            (int)LogicalDevice::GetMaxFramePerFlight()
-        );
-
-        auto const vertexStageBuffer = RB::CreateStageBuffer(
-            LogicalDevice::GetVkDevice(),
-            LogicalDevice::GetPhysicalDevice(),
-            vertexBuffer->bufferSize,
-            vertexBuffer->buffers.size()
-        );
-
-        auto imageData = std::make_unique<ImageData>(ImageData{
-            .vertexData = LocalBufferTracker(vertexBuffer, vertexStageBuffer, Alias(vertexData)),
+        return std::make_unique<ImageData>(ImageData{
             .descriptorSet = _pipeline->CreateDescriptorSet(gpuTexture)
         });
-
-        return imageData;
     }
 
     //------------------------------------------------------------------------------------------------------------------
 
-    void ImageRenderer::UpdateImageData(
-        ImageData &imageData,
-
-        RT::GpuTexture const &gpuTexture,
-
-        Position const &topLeftPos,
-        Position const &bottomLeftPos,
-        Position const &topRightPos,
-        Position const &bottomRightPos,
-
-        Radius const &topLeftBorderRadius,
-        Radius const &bottomLeftBorderRadius,
-        Radius const &topRightBorderRadius,
-        Radius const &bottomRightBorderRadius,
-
-        UV const &topLeftUV,
-        UV const &bottomLeftUV,
-        UV const &topRightUV,
-        UV const &bottomRightUV
-    ) const
+    void ImageRenderer::UpdateImageData(ImageData & imageData, RT::GpuTexture const & gpuTexture) const
     {
-        MFA_ASSERT(imageData.vertexData.has_value() == true);
-        auto * rawData = imageData.vertexData->Data();
-
-        Pipeline::Vertex * vertexData = reinterpret_cast<Pipeline::Vertex *>(rawData);
-
-        vertexData[0].position = topLeftPos;
-        vertexData[0].radius = topLeftBorderRadius;
-        vertexData[0].uv = topLeftUV;
-
-        vertexData[1].position = bottomLeftPos;
-        vertexData[1].radius = bottomLeftBorderRadius;
-        vertexData[1].uv = bottomLeftUV;
-
-        vertexData[2].position = topRightPos;
-        vertexData[2].radius = topRightBorderRadius;
-        vertexData[2].uv = topRightUV;
-
-        vertexData[3].position = bottomRightPos;
-        vertexData[3].radius = bottomRightBorderRadius;
-        vertexData[3].uv = bottomRightUV;
-
-        // TODO: We need to wrap descriptor sets as well to be freeable
         _pipeline->UpdateDescriptorSet(imageData.descriptorSet, gpuTexture);
     }
 
@@ -115,7 +32,6 @@ namespace MFA
 
     void ImageRenderer::FreeImageData(ImageData &imageData)
     {
-        imageData.vertexData.reset();
         _pipeline->FreeDescriptorSet(imageData.descriptorSet);
     }
 
@@ -124,7 +40,9 @@ namespace MFA
     void ImageRenderer::Draw(
         RT::CommandRecordState & recordState,
         Pipeline::PushConstants const & pushConstants,
-        ImageData const & imageData
+        ImageData const & imageData,
+        LocalBufferTracker const & instanceBuffer,
+        std::span<DisplayList::Draw const> const & draws
     ) const
     {
         _pipeline->BindPipeline(recordState);
@@ -133,14 +51,17 @@ namespace MFA
 
         RB::AutoBindDescriptorSet(recordState, RB::UpdateFrequency::PerPipeline, imageData.descriptorSet);
 
-    	auto const &localBuffers = imageData.vertexData->LocalBuffer().buffers;
+        auto const &localBuffers = instanceBuffer.LocalBuffer().buffers;
         auto const &localBuffer = localBuffers[recordState.frameIndex % localBuffers.size()];
-        VkBuffer buffers[2]{localBuffer->buffer, localBuffer->buffer};
-        VkDeviceSize bindingOffsets[2]{0, 0};
+        VkDeviceSize const bindingOffset = 0;
 
-        vkCmdBindVertexBuffers(recordState.commandBuffer, 0, 2, buffers, bindingOffsets);
+        vkCmdBindVertexBuffers(recordState.commandBuffer, 0, 1, &localBuffer->buffer, &bindingOffset);
 
-        vkCmdDraw(recordState.commandBuffer, 4, 1, 0, 0);
+        // The vertex shader picks the corner of the instance by the vertex index
+        for (auto const & draw : draws)
+        {
+            vkCmdDraw(recordState.commandBuffer, 4, draw.elementCount, 0, draw.firstElement);
+        }
     }
 
     //------------------------------------------------------------------------------------------------------------------
@@ -1,10 +1,9 @@
 #pragma once
 
 #include "BufferTracker.hpp"
+#include "DisplayList.hpp"
 #include "ImagePipeline.hpp"
 
-#include <optional>
-
 namespace MFA
 {
     class ImageRenderer
@@ -18,59 +17,26 @@ namespace MFA
 
         struct ImageData
         {
-            std::optional<LocalBufferTracker> vertexData = std::nullopt;
             RT::DescriptorSetGroup descriptorSet;
         };
 
         explicit ImageRenderer(std::shared_ptr<Pipeline> pipeline);
 
+        // Only the descriptor set, The instances of the image live in a display list arena
         [[nodiscard]]
-        std::unique_ptr<ImageData> AllocateImageData(
-            RT::GpuTexture const & gpuTexture,
-
-            Position const &topLeftPos,
-            Position const &bottomLeftPos,
-            Position const &topRightPos,
-            Position const &bottomRightPos,
-
-            Radius const &topLeftBorderRadius,
-            Radius const &bottomLeftBorderRadius,
-            Radius const &topRightBorderRadius,
-            Radius const &bottomRightBorderRadius,
-
-            UV const &topLeftUV,
-            UV const &bottomLeftUV,
-            UV const &topRightUV,
-            UV const &bottomRightUV
-        ) const;
+        std::unique_ptr<ImageData> AllocateImageData(RT::GpuTexture const & gpuTexture) const;
 
-        void UpdateImageData(
-            ImageData &imageData,
-
-            RT::GpuTexture const &gpuTexture,
-
-            Position const &topLeftPos,
-            Position const &bottomLeftPos,
-            Position const &topRightPos,
-            Position const &bottomRightPos,
-
-            Radius const &topLeftBorderRadius,
-            Radius const &bottomLeftBorderRadius,
-            Radius const &topRightBorderRadius,
-            Radius const &bottomRightBorderRadius,
-
-            UV const &topLeftUV,
-            UV const &bottomLeftUV,
-            UV const &topRightUV,
-            UV const &bottomRightUV
-        ) const;
+        void UpdateImageData(ImageData & imageData, RT::GpuTexture const & gpuTexture) const;
 
         void FreeImageData(ImageData &imageData);
 
+        // Instances of a display list arena that all sample the texture of imageData, Every range is one instanced draw
         void Draw(
             RT::CommandRecordState & recordState,
             Pipeline::PushConstants const & pushConstants,
-            ImageData const & imageData
+            ImageData const & imageData,
+            LocalBufferTracker const & instanceBuffer,
+            std::span<DisplayList::Draw const> const & draws
         ) const;
 
     private:
@@ -105,14 +105,10 @@ namespace MFA
 
 		std::vector<RT::GpuShader const*> shaders{ gpuVertexShader.get(), gpuFragmentShader.get() };
 
+		// One binding with a record per instance, The vertex shader picks one of the 4 corners by the vertex index
 		std::vector<VkVertexInputBindingDescription> const bindingDescriptions{
 			VkVertexInputBindingDescription {
 				.binding = 0,
-				.stride = sizeof(Vertex),
-				.inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
-			},
-			VkVertexInputBindingDescription {
-				.binding = 1,
 				.stride = sizeof(Instance),
 				.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE,
 			}
@@ -120,79 +116,64 @@ namespace MFA
 
 		std::vector<VkVertexInputAttributeDescription> inputAttributeDescriptions{};
 
-		// Position
-		inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
-			.location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
-			.binding = 0,
-			.format = VK_FORMAT_R32G32_SFLOAT,
-			.offset = offsetof(Vertex, position),
-		});
-		// Color
+		// topLeftPos and topLeftRadius
 		inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
 			.location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
 			.binding = 0,
 			.format = VK_FORMAT_R32G32B32A32_SFLOAT,
-			.offset = offsetof(Vertex, color),
-		});
-
-		// topLeftPos
-		inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
-			.location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
-			.binding = 1,
-			.format = VK_FORMAT_R32G32_SFLOAT,
 			.offset = offsetof(Instance, topLeftPos)
 		});
-		// topLeftRadius
+		// topLeftColor
 		inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
 			.location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
-			.binding = 1,
-			.format = VK_FORMAT_R32G32_SFLOAT,
-			.offset = offsetof(Instance, topLeftRadius)
+			.binding = 0,
+			.format = VK_FORMAT_R32G32B32A32_SFLOAT,
+			.offset = offsetof(Instance, topLeftColor)
 		});
 
-		// bottomLeftPos
+		// bottomLeftPos and bottomLeftRadius
 		inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
 			.location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
-			.binding = 1,
-			.format = VK_FORMAT_R32G32_SFLOAT,
+			.binding = 0,
+			.format = VK_FORMAT_R32G32B32A32_SFLOAT,
 			.offset = offsetof(Instance, bottomLeftPos)
 		});
-		// bottomLeftRadius
+		// bottomLeftColor
 		inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
 			.location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
-			.binding = 1,
-			.format = VK_FORMAT_R32G32_SFLOAT,
-			.offset = offsetof(Instance, bottomLeftRadius)
+			.binding = 0,
+			.format = VK_FORMAT_R32G32B32A32_SFLOAT,
+			.offset = offsetof(Instance, bottomLeftColor)
 		});
 
-		// topRightPos
+		// topRightPos and topRightRadius
 		inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
 			.location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
-			.binding = 1,
-			.format = VK_FORMAT_R32G32_SFLOAT,
+			.binding = 0,
+			.format = VK_FORMAT_R32G32B32A32_SFLOAT,
 			.offset = offsetof(Instance, topRightPos)
 		});
-		// topRightRadius
+		// topRightColor
 		inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
 			.location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
-			.binding = 1,
-			.format = VK_FORMAT_R32G32_SFLOAT,
-			.offset = offsetof(Instance, topRightRadius)
+			.binding = 0,
+			.format = VK_FORMAT_R32G32B32A32_SFLOAT,
+			.offset = offsetof(Instance, topRightColor)
 		});
 
-		// bottomRightPos
+		// bottomRightPos and bottomRightRadius
 		inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
 			.location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
-			.binding = 1,
-			.format = VK_FORMAT_R32G32_SFLOAT,
+			.binding = 0,
+			.format = VK_FORMAT_R32G32B32A32_SFLOAT,
 			.offset = offsetof(Instance, bottomRightPos)
 		});
-		// bottomRightRadius
+		// bottomRightColor
 		inputAttributeDescriptions.emplace_back(VkVertexInputAttributeDescription{
 			.location = static_cast<uint32_t>(inputAttributeDescriptions.size()),
-			.binding = 1,
-			.format = VK_FORMAT_R32G32_SFLOAT,
-			.offset = offsetof(Instance, bottomRightRadius)
+			.binding = 0,
+			.format = VK_FORMAT_R32G32B32A32_SFLOAT,
+			.offset = offsetof(Instance, bottomRightColor)
 		});
 
 		RB::CreateGraphicPipelineOptions pipelineOptions{};
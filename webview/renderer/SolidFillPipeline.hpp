@@ -16,13 +16,7 @@ namespace MFA
         using Radius = glm::vec2;
         using Color = glm::vec4;
 
-        struct Vertex
-        {
-            Position position{};
-            Radius borderRadius{};
-            Color color{};
-        };
-
+        // The vertex shader reads the position and the radius of a corner as one float4, So they have to stay adjacent
         struct Instance
         {
             Position topLeftPos{};
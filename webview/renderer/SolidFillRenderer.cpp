@@ -11,132 +11,34 @@ MFA::SolidFillRenderer::SolidFillRenderer(std::shared_ptr<SolidFillPipeline> pip
 
 //------------------------------------------------------------------
 
-std::unique_ptr<MFA::LocalBufferTracker> MFA::SolidFillRenderer::AllocateBuffer(
-	Position const& topLeftPos,
-	Position const& bottomLeftPos,
-	Position const& topRightPos,
-	Position const& bottomRightPos,
-	
-	Color const& topLeftColor,
-	Color const& bottomLeftColor,
-	Color const& topRightColor,
-	Color const& bottomRightColor,
-
-	Radius const& topLeftBorderRadius,
-	Radius const& bottomLeftBorderRadius,
-	Radius const& topRightBorderRadius,
-	Radius const& bottomRightBorderRadius
-)
-{
-	Pipeline::Instance data{
-		.topLeftPos = topLeftPos,
-		.topLeftRadius = topLeftBorderRadius,
-		.topLeftColor = topLeftColor,
-
-		.bottomLeftPos = bottomLeftPos,
-		.bottomLeftRadius = bottomLeftBorderRadius,
-		.bottomLeftColor = bottomLeftColor,
-
-		.topRightPos = topRightPos,
-		.topRightRadius = topRightBorderRadius,
-		.topRightColor = topRightColor,
-
-		.bottomRightPos = bottomRightPos,
-		.bottomRightRadius = bottomRightBorderRadius,
-		.bottomRightColor = bottomRightColor,
-	};
-
-	// This should be 1
-	int const bufferCount = 1;
-
-	auto vertexBuffer = RB::CreateBufferGroup(
-		LogicalDevice::GetVkDevice(),
-		LogicalDevice::GetPhysicalDevice(),
-		sizeof(Pipeline::Instance), 
-		bufferCount,
-		VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, 
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
-	);
-
-	auto stageBuffer = RB::CreateStageBuffer(
-		LogicalDevice::GetVkDevice(),
-		LogicalDevice::GetPhysicalDevice(),
-		sizeof(Pipeline::Instance), 
-		bufferCount
-	);
-
-	auto bufferTracker = std::make_unique<LocalBufferTracker>(vertexBuffer, stageBuffer);
-	bufferTracker->SetData(Alias(data));
-
-	return bufferTracker;
-}
-
-//------------------------------------------------------------------
-
-void MFA::SolidFillRenderer::UpdateBuffer(
-    LocalBufferTracker &bufferTracker,
-    Position const &topLeftPos,
-    Position const &bottomLeftPos,
-    Position const &topRightPos,
-    Position const &bottomRightPos,
-    Color const &topLeftColor,
-    Color const &bottomLeftColor,
-    Color const &topRightColor,
-    Color const &bottomRightColor,
-    Radius const &topLeftBorderRadius,
-    Radius const &bottomLeftBorderRadius,
-    Radius const &topRightBorderRadius,
-    Radius const &bottomRightBorderRadius
-)
-{
-    Pipeline::Instance data{
-        .topLeftPos = topLeftPos,
-        .topLeftRadius = topLeftBorderRadius,
-        .topLeftColor = topLeftColor,
-
-        .bottomLeftPos = bottomLeftPos,
-        .bottomLeftRadius = bottomLeftBorderRadius,
-        .bottomLeftColor = bottomLeftColor,
-
-        .topRightPos = topRightPos,
-        .topRightRadius = topRightBorderRadius,
-        .topRightColor = topRightColor,
-
-        .bottomRightPos = bottomRightPos,
-        .bottomRightRadius = bottomRightBorderRadius,
-        .bottomRightColor = bottomRightColor,
-    };
-
-    bufferTracker.SetData(Alias(data));
-}
-
-//------------------------------------------------------------------
-
 void MFA::SolidFillRenderer::Draw(
-    RT::CommandRecordState& recordState,
+    RT::CommandRecordState & recordState,
     Pipeline::PushConstants const & pushConstants,
-    LocalBufferTracker const& vertexBuffer
+    LocalBufferTracker const & instanceBuffer,
+    std::span<DisplayList::Draw const> const & draws
 ) const
 {
-    // Note: We could have achieve the same thing with viewport and scissor and a fixed vertex buffer.
-	_pipeline->BindPipeline(recordState);
+    _pipeline->BindPipeline(recordState);
 
     _pipeline->SetPushConstant(recordState, pushConstants);
 
-	auto const & localBuffers = vertexBuffer.LocalBuffer().buffers;
-	auto const & localBuffer = localBuffers[recordState.frameIndex % localBuffers.size()];
-	VkBuffer buffers[2]{ localBuffer->buffer, localBuffer->buffer };
-	VkDeviceSize bindingOffsets[2]{ 0,0 };
-
-	vkCmdBindVertexBuffers(
-		recordState.commandBuffer,
-		0,
-		2,
-		buffers,
-		bindingOffsets
-	);
-
-	vkCmdDraw(recordState.commandBuffer, 4, 1, 0, 0);
+    auto const & localBuffers = instanceBuffer.LocalBuffer().buffers;
+    auto const & localBuffer = localBuffers[recordState.frameIndex % localBuffers.size()];
+    VkDeviceSize const bindingOffset = 0;
+
+    vkCmdBindVertexBuffers(
+        recordState.commandBuffer,
+        0,
+        1,
+        &localBuffer->buffer,
+        &bindingOffset
+    );
+
+    // The vertex shader picks the corner of the instance by the vertex index
+    for (auto const & draw : draws)
+    {
+        vkCmdDraw(recordState.commandBuffer, 4, draw.elementCount, 0, draw.firstElement);
+    }
 }
 
 //------------------------------------------------------------------
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "BufferTracker.hpp"
+#include "DisplayList.hpp"
 #include "SolidFillPipeline.hpp"
 
 namespace MFA
@@ -16,46 +17,12 @@ namespace MFA
 
 		explicit SolidFillRenderer(std::shared_ptr<Pipeline> pipeline);
 
-		static std::unique_ptr<LocalBufferTracker> AllocateBuffer(
-			Position const & topLeftPos,
-			Position const & bottomLeftPos,
-			Position const & topRightPos,
-			Position const & bottomRightPos,
-			
-			Color const & topLeftColor,
-			Color const & bottomLeftColor,
-			Color const & topRightColor,
-			Color const & bottomRightColor,
-
-			Radius const & topLeftBorderRadius,
-			Radius const & bottomLeftBorderRadius,
-			Radius const & topRightBorderRadius,
-			Radius const & bottomRightBorderRadius
-		);
-
-        static void UpdateBuffer(
-            LocalBufferTracker & bufferTracker,
-
-            Position const &topLeftPos,
-            Position const &bottomLeftPos,
-            Position const &topRightPos,
-            Position const &bottomRightPos,
-
-            Color const &topLeftColor,
-            Color const &bottomLeftColor,
-            Color const &topRightColor,
-            Color const &bottomRightColor,
-
-            Radius const &topLeftBorderRadius,
-            Radius const &bottomLeftBorderRadius,
-            Radius const &topRightBorderRadius,
-            Radius const &bottomRightBorderRadius
-        );
-
-		void Draw(
+        // Instances of a display list arena, Binds once for the whole batch and draws every range as one instanced draw
+        void Draw(
             RT::CommandRecordState & recordState,
             Pipeline::PushConstants const & pushConstants,
-            LocalBufferTracker const & vertexBuffer
+            LocalBufferTracker const & instanceBuffer,
+            std::span<DisplayList::Draw const> const & draws
         ) const;
 
 	private: